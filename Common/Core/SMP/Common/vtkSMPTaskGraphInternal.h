@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTaskGraphInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef vtkSMPTaskGraphInternal_h
+#define vtkSMPTaskGraphInternal_h
+
+#include "vtkSystemIncludes.h"
+
+#include <atomic>     // For std::atomic
+#include <functional> // For std::function
+#include <memory>     // For std::unique_ptr
+#include <vector>     // For std::vector
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+VTK_ABI_NAMESPACE_BEGIN
+
+//--------------------------------------------------------------------------------
+// Backend independent description of a vtkSMPTaskGraph. Tasks are stored in
+// spawn order and may only depend on previously spawned tasks, so the spawn
+// order is always a valid topological order of the graph.
+struct vtkSMPTaskGraphStorage
+{
+  struct Task
+  {
+    std::function<void()> Work;
+    std::vector<vtkIdType> Successors;
+    vtkIdType NumberOfPredecessors = 0;
+  };
+
+  std::vector<Task> Tasks;
+};
+
+//--------------------------------------------------------------------------------
+// Runtime state shared by the threaded backends while a graph is executed.
+// Each task owns a counter of unfinished predecessors; the thread finishing
+// the last predecessor of a task is the one making it ready.
+class vtkSMPTaskGraphExecution
+{
+public:
+  explicit vtkSMPTaskGraphExecution(vtkSMPTaskGraphStorage& graph)
+    : Graph(graph)
+    , Pending(new std::atomic<vtkIdType>[graph.Tasks.size()])
+    , Remaining(static_cast<vtkIdType>(graph.Tasks.size()))
+  {
+    for (std::size_t i = 0; i < graph.Tasks.size(); ++i)
+    {
+      this->Pending[i] = graph.Tasks[i].NumberOfPredecessors;
+    }
+  }
+
+  // Call f on every task without predecessors.
+  template <typename Functor>
+  void ForEachRoot(Functor&& f)
+  {
+    const vtkIdType numberOfTasks = static_cast<vtkIdType>(this->Graph.Tasks.size());
+    for (vtkIdType id = 0; id < numberOfTasks; ++id)
+    {
+      if (this->Graph.Tasks[id].NumberOfPredecessors == 0)
+      {
+        f(id);
+      }
+    }
+  }
+
+  // Execute a ready task, then call ready() on each successor whose last
+  // pending dependency was this task.
+  template <typename ReadyFunctor>
+  void Run(vtkIdType id, ReadyFunctor&& ready)
+  {
+    vtkSMPTaskGraphStorage::Task& task = this->Graph.Tasks[id];
+    if (task.Work)
+    {
+      task.Work();
+    }
+    for (vtkIdType successor : task.Successors)
+    {
+      if (this->Pending[successor].fetch_sub(1) == 1)
+      {
+        ready(successor);
+      }
+    }
+    // Decremented last so that IsDone() cannot be true while successors are
+    // being made ready.
+    this->Remaining.fetch_sub(1);
+  }
+
+  bool IsDone() const { return this->Remaining.load() == 0; }
+
+private:
+  vtkSMPTaskGraphStorage& Graph;
+  std::unique_ptr<std::atomic<vtkIdType>[]> Pending;
+  std::atomic<vtkIdType> Remaining;
+};
+
+VTK_ABI_NAMESPACE_END
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
+/* VTK-HeaderTest-Exclude: vtkSMPTaskGraphInternal.h */
@@ -247,6 +247,26 @@ bool vtkSMPToolsAPI::GetSingleThread()
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkSMPToolsAPI::RunTaskGraph(vtkSMPTaskGraphStorage& graph)
+{
+  switch (this->ActivatedBackend)
+  {
+    case BackendType::Sequential:
+      this->SequentialBackend->RunTaskGraph(graph);
+      break;
+    case BackendType::STDThread:
+      this->STDThreadBackend->RunTaskGraph(graph);
+      break;
+    case BackendType::TBB:
+      this->TBBBackend->RunTaskGraph(graph);
+      break;
+    case BackendType::OpenMP:
+      this->OpenMPBackend->RunTaskGraph(graph);
+      break;
+  }
+}
+
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
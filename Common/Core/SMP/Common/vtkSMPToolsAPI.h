@@ -228,6 +228,75 @@ public:
     }
   }
 
+  //--------------------------------------------------------------------------------
+  template <typename RandomAccessIterator, typename Compare>
+  void StableSort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        this->SequentialBackend->StableSort(begin, end, comp);
+        break;
+      case BackendType::STDThread:
+        this->STDThreadBackend->StableSort(begin, end, comp);
+        break;
+      case BackendType::TBB:
+        this->TBBBackend->StableSort(begin, end, comp);
+        break;
+      case BackendType::OpenMP:
+        this->OpenMPBackend->StableSort(begin, end, comp);
+        break;
+    }
+  }
+
+  //--------------------------------------------------------------------------------
+  template <typename KeyT, typename ValueT>
+  void RadixSort(KeyT* keysBegin, KeyT* keysEnd, ValueT* values)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        this->SequentialBackend->RadixSort(keysBegin, keysEnd, values);
+        break;
+      case BackendType::STDThread:
+        this->STDThreadBackend->RadixSort(keysBegin, keysEnd, values);
+        break;
+      case BackendType::TBB:
+        this->TBBBackend->RadixSort(keysBegin, keysEnd, values);
+        break;
+      case BackendType::OpenMP:
+        this->OpenMPBackend->RadixSort(keysBegin, keysEnd, values);
+        break;
+    }
+  }
+
+  //--------------------------------------------------------------------------------
+  template <typename InputIt, typename OutputIt, typename SegmentFlags, typename T,
+    typename BinaryOp, typename UnaryOp>
+  T Scan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, SegmentFlags flags, T init,
+    BinaryOp op, UnaryOp transform, bool inclusive)
+  {
+    switch (this->ActivatedBackend)
+    {
+      case BackendType::Sequential:
+        return this->SequentialBackend->Scan(
+          inBegin, inEnd, outBegin, flags, init, op, transform, inclusive);
+      case BackendType::STDThread:
+        return this->STDThreadBackend->Scan(
+          inBegin, inEnd, outBegin, flags, init, op, transform, inclusive);
+      case BackendType::TBB:
+        return this->TBBBackend->Scan(
+          inBegin, inEnd, outBegin, flags, init, op, transform, inclusive);
+      case BackendType::OpenMP:
+        return this->OpenMPBackend->Scan(
+          inBegin, inEnd, outBegin, flags, init, op, transform, inclusive);
+    }
+    return init;
+  }
+
+  //--------------------------------------------------------------------------------
+  void RunTaskGraph(vtkSMPTaskGraphStorage& graph);
+
   // disable copying
   vtkSMPToolsAPI(vtkSMPToolsAPI const&) = delete;
   void operator=(vtkSMPToolsAPI const&) = delete;
@@ -36,6 +36,8 @@ namespace detail
 namespace smp
 {
 VTK_ABI_NAMESPACE_BEGIN
+struct vtkSMPTaskGraphStorage;
+
 enum class BackendType
 {
   Sequential = VTK_SMP_BACKEND_SEQUENTIAL,
@@ -101,6 +103,23 @@ public:
   template <typename RandomAccessIterator, typename Compare>
   void Sort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp);
 
+  //--------------------------------------------------------------------------------
+  template <typename RandomAccessIterator, typename Compare>
+  void StableSort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp);
+
+  //--------------------------------------------------------------------------------
+  template <typename KeyT, typename ValueT>
+  void RadixSort(KeyT* keysBegin, KeyT* keysEnd, ValueT* values);
+
+  //--------------------------------------------------------------------------------
+  template <typename InputIt, typename OutputIt, typename SegmentFlags, typename T,
+    typename BinaryOp, typename UnaryOp>
+  T Scan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, SegmentFlags flags, T init,
+    BinaryOp op, UnaryOp transform, bool inclusive);
+
+  //--------------------------------------------------------------------------------
+  void RunTaskGraph(vtkSMPTaskGraphStorage& graph);
+
   //--------------------------------------------------------------------------------
   vtkSMPToolsImpl()
     : NestedActivated(true)
@@ -16,7 +16,10 @@
 #ifndef vtkSMPToolsInternal_h
 #define vtkSMPToolsInternal_h
 
-#include <iterator> // For std::advance
+#include <algorithm> // For std::min
+#include <iterator>  // For std::advance
+#include <utility>   // For std::forward
+#include <vector>    // For std::vector
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 namespace vtk
@@ -102,6 +105,220 @@ public:
   T operator()(T vtkNotUsed(inValue)) { return Value; }
 };
 
+//--------------------------------------------------------------------------------
+// Segment flags of a scan. The non segmented scans use NoScanSegments, for
+// which no element ever starts a new segment.
+struct NoScanSegments
+{
+  struct Iterator
+  {
+    bool operator*() const { return false; }
+    Iterator& operator++() { return *this; }
+  };
+
+  Iterator At(vtkIdType) const { return Iterator(); }
+};
+
+template <typename FlagIt>
+struct ScanSegments
+{
+  FlagIt Begin;
+
+  explicit ScanSegments(FlagIt begin)
+    : Begin(begin)
+  {
+  }
+
+  FlagIt At(vtkIdType index) const
+  {
+    FlagIt it(this->Begin);
+    std::advance(it, index);
+    return it;
+  }
+};
+
+//--------------------------------------------------------------------------------
+// Transformation applied to the input of the scans without transform.
+struct ScanIdentity
+{
+  template <typename T>
+  T&& operator()(T&& value) const
+  {
+    return std::forward<T>(value);
+  }
+};
+
+//--------------------------------------------------------------------------------
+// Serial scan of `size` elements starting from the accumulated value `carry`.
+// The accumulated value is reset to `init` at the beginning of each segment.
+// The input of an element is read before its output is written so that the
+// scan can be done in place. Returns the value accumulated after the last
+// element.
+template <typename InputIt, typename OutputIt, typename FlagIt, typename T, typename BinaryOp,
+  typename UnaryOp>
+T SequentialScan(InputIt in, vtkIdType size, OutputIt out, FlagIt flag, T carry, const T& init,
+  BinaryOp& op, UnaryOp& transform, bool inclusive)
+{
+  for (vtkIdType i = 0; i < size; ++i, ++in, ++out, ++flag)
+  {
+    if (*flag)
+    {
+      carry = init;
+    }
+    if (inclusive)
+    {
+      carry = op(carry, transform(*in));
+      *out = carry;
+    }
+    else
+    {
+      T value = transform(*in);
+      *out = carry;
+      carry = op(carry, value);
+    }
+  }
+  return carry;
+}
+
+//--------------------------------------------------------------------------------
+// Two pass chunked scan: the first pass reduces each chunk independently, the
+// (few) chunk reductions are then combined serially into the value carried
+// into each chunk, and the second pass scans each chunk from its carry. The
+// binary operation must be associative.
+template <typename InputIt, typename OutputIt, typename SegmentFlags, typename T,
+  typename BinaryOp, typename UnaryOp>
+class ScanCall
+{
+  InputIt In;
+  OutputIt Out;
+  SegmentFlags Flags;
+  const T& Init;
+  BinaryOp& Op;
+  UnaryOp& Transform;
+  bool Inclusive;
+  vtkIdType Size;
+  vtkIdType NumberOfChunks;
+  bool ScanPass = false;
+  std::vector<T> Partials;
+  std::vector<unsigned char> HasSegment;
+  std::vector<T> Carries;
+
+  vtkIdType ChunkBegin(vtkIdType chunk) const { return chunk * this->Size / this->NumberOfChunks; }
+
+  void ReduceChunk(vtkIdType chunk)
+  {
+    const vtkIdType begin = this->ChunkBegin(chunk);
+    const vtkIdType end = this->ChunkBegin(chunk + 1);
+    InputIt in(this->In);
+    std::advance(in, begin);
+    auto flag = this->Flags.At(begin);
+    // Only the elements after the last segment start matter to the next chunk
+    T partial = this->Transform(*in);
+    bool hasSegment = *flag;
+    ++in;
+    ++flag;
+    for (vtkIdType i = begin + 1; i < end; ++i, ++in, ++flag)
+    {
+      if (*flag)
+      {
+        partial = this->Transform(*in);
+        hasSegment = true;
+      }
+      else
+      {
+        partial = this->Op(partial, this->Transform(*in));
+      }
+    }
+    this->Partials[chunk] = partial;
+    this->HasSegment[chunk] = hasSegment;
+  }
+
+  void ScanChunk(vtkIdType chunk)
+  {
+    const vtkIdType begin = this->ChunkBegin(chunk);
+    InputIt in(this->In);
+    std::advance(in, begin);
+    OutputIt out(this->Out);
+    std::advance(out, begin);
+    SequentialScan(in, this->ChunkBegin(chunk + 1) - begin, out, this->Flags.At(begin),
+      this->Carries[chunk], this->Init, this->Op, this->Transform, this->Inclusive);
+  }
+
+public:
+  ScanCall(InputIt in, OutputIt out, SegmentFlags flags, const T& init, BinaryOp& op,
+    UnaryOp& transform, bool inclusive, vtkIdType size, vtkIdType numberOfChunks)
+    : In(in)
+    , Out(out)
+    , Flags(flags)
+    , Init(init)
+    , Op(op)
+    , Transform(transform)
+    , Inclusive(inclusive)
+    , Size(size)
+    , NumberOfChunks(numberOfChunks)
+    , Partials(numberOfChunks, init)
+    , HasSegment(numberOfChunks, 0)
+    , Carries(numberOfChunks + 1, init)
+  {
+  }
+
+  void Execute(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      if (this->ScanPass)
+      {
+        this->ScanChunk(chunk);
+      }
+      else
+      {
+        this->ReduceChunk(chunk);
+      }
+    }
+  }
+
+  // Combine the chunk reductions, then switch to the scan pass.
+  void ComputeCarries()
+  {
+    for (vtkIdType chunk = 0; chunk < this->NumberOfChunks; ++chunk)
+    {
+      this->Carries[chunk + 1] = this->HasSegment[chunk]
+        ? this->Op(this->Init, this->Partials[chunk])
+        : this->Op(this->Carries[chunk], this->Partials[chunk]);
+    }
+    this->ScanPass = true;
+  }
+
+  const T& GetTotal() const { return this->Carries[this->NumberOfChunks]; }
+};
+
+//--------------------------------------------------------------------------------
+// Scan using the For() of the given backend. Small inputs are scanned
+// serially as splitting them is not worth the overhead.
+template <typename Backend, typename InputIt, typename OutputIt, typename SegmentFlags, typename T,
+  typename BinaryOp, typename UnaryOp>
+T ParallelScan(Backend& backend, int numberOfThreads, InputIt inBegin, InputIt inEnd,
+  OutputIt outBegin, SegmentFlags flags, const T& init, BinaryOp& op, UnaryOp& transform,
+  bool inclusive)
+{
+  const vtkIdType minimumChunkSize = 1024;
+  const vtkIdType size = std::distance(inBegin, inEnd);
+  const vtkIdType numberOfChunks =
+    std::min(static_cast<vtkIdType>(numberOfThreads) * 4, size / minimumChunkSize);
+  if (numberOfChunks <= 1)
+  {
+    return SequentialScan(
+      inBegin, size, outBegin, flags.At(0), init, init, op, transform, inclusive);
+  }
+
+  ScanCall<InputIt, OutputIt, SegmentFlags, T, BinaryOp, UnaryOp> scan(
+    inBegin, outBegin, flags, init, op, transform, inclusive, size, numberOfChunks);
+  backend.For(0, numberOfChunks, 1, scan);
+  scan.ComputeCarries();
+  backend.For(0, numberOfChunks, 1, scan);
+  return scan.GetTotal();
+}
+
 VTK_ABI_NAMESPACE_END
 
 } // namespace smp
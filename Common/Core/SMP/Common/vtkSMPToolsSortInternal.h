@@ -0,0 +1,521 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsSortInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef vtkSMPToolsSortInternal_h
+#define vtkSMPToolsSortInternal_h
+
+#include "vtkSystemIncludes.h"
+
+#include <algorithm>   // For std::sort, std::stable_sort, std::merge
+#include <array>       // For std::array
+#include <cstdint>     // For std::uint32_t, std::uint64_t
+#include <cstring>     // For std::memcpy
+#include <iterator>    // For std::iterator_traits, std::make_move_iterator
+#include <limits>      // For std::numeric_limits
+#include <type_traits> // For std::make_unsigned
+#include <utility>     // For std::move
+#include <vector>      // For std::vector
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+VTK_ABI_NAMESPACE_BEGIN
+
+//--------------------------------------------------------------------------------
+// Parallel merge sort. The range is split in one run per thread and the runs
+// are sorted independently. Runs are then merged pairwise until a single one
+// remains, each merge being split in pieces at positions found by binary
+// search so that all the threads keep working during the last rounds.
+// Elements ping-pong between the range and a buffer of the same size.
+// Equivalent elements are always taken from the left run first, so the result
+// is stable when the runs are sorted with std::stable_sort.
+template <typename RandomAccessIterator, typename Compare>
+class MergeSortCall
+{
+  using ValueType = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+  struct MergeTask
+  {
+    vtkIdType LeftBegin;
+    vtkIdType LeftEnd;
+    vtkIdType RightBegin;
+    vtkIdType RightEnd;
+    vtkIdType Output;
+  };
+
+  enum class Pass
+  {
+    SortRuns,
+    Merge,
+    CopyBack
+  };
+
+  RandomAccessIterator Begin;
+  Compare& Comp;
+  bool Stable;
+  vtkIdType Size;
+  Pass CurrentPass = Pass::SortRuns;
+  bool InBuffer = false;
+  std::vector<ValueType> Buffer;
+  std::vector<vtkIdType> Runs;
+  std::vector<MergeTask> Tasks;
+
+  template <typename SourceIt, typename DestinationIt>
+  void Merge(SourceIt source, DestinationIt destination, const MergeTask& task)
+  {
+    std::merge(std::make_move_iterator(source + task.LeftBegin),
+      std::make_move_iterator(source + task.LeftEnd),
+      std::make_move_iterator(source + task.RightBegin),
+      std::make_move_iterator(source + task.RightEnd), destination + task.Output, this->Comp);
+  }
+
+  template <typename SourceIt>
+  vtkIdType Split(SourceIt source, vtkIdType left, vtkIdType rightBegin, vtkIdType rightEnd)
+  {
+    // Right elements ordered strictly before the left split element go first.
+    return std::lower_bound(source + rightBegin, source + rightEnd, source[left], this->Comp) -
+      source;
+  }
+
+public:
+  MergeSortCall(RandomAccessIterator begin, vtkIdType size, Compare& comp, bool stable,
+    vtkIdType numberOfRuns)
+    : Begin(begin)
+    , Comp(comp)
+    , Stable(stable)
+    , Size(size)
+    , Buffer(begin, begin + size)
+    , Runs(numberOfRuns + 1)
+  {
+    for (vtkIdType run = 0; run <= numberOfRuns; ++run)
+    {
+      this->Runs[run] = run * size / numberOfRuns;
+    }
+  }
+
+  vtkIdType GetNumberOfRuns() const { return static_cast<vtkIdType>(this->Runs.size()) - 1; }
+
+  vtkIdType GetNumberOfTasks() const { return static_cast<vtkIdType>(this->Tasks.size()); }
+
+  // Prepare one round of merges, each pair of runs being split in pieces so
+  // that about numberOfPieces tasks are available. A run without partner is
+  // simply moved to the other side.
+  void PrepareMerge(vtkIdType numberOfPieces)
+  {
+    const vtkIdType numberOfRuns = this->GetNumberOfRuns();
+    const vtkIdType numberOfPairs = (numberOfRuns + 1) / 2;
+    const vtkIdType piecesPerPair = std::max<vtkIdType>(1, numberOfPieces / numberOfPairs);
+    std::vector<vtkIdType> mergedRuns;
+    this->Tasks.clear();
+    for (vtkIdType run = 0; run < numberOfRuns; run += 2)
+    {
+      const vtkIdType leftBegin = this->Runs[run];
+      const vtkIdType rightBegin = this->Runs[run + 1];
+      const vtkIdType rightEnd = run + 2 <= numberOfRuns ? this->Runs[run + 2] : rightBegin;
+      mergedRuns.push_back(leftBegin);
+      vtkIdType previousLeft = leftBegin;
+      vtkIdType previousRight = rightBegin;
+      for (vtkIdType piece = 1; piece <= piecesPerPair; ++piece)
+      {
+        const vtkIdType left = leftBegin + (rightBegin - leftBegin) * piece / piecesPerPair;
+        vtkIdType right = rightEnd;
+        if (piece < piecesPerPair && left < rightBegin)
+        {
+          right = this->InBuffer ? this->Split(this->Buffer.begin(), left, rightBegin, rightEnd)
+                                 : this->Split(this->Begin, left, rightBegin, rightEnd);
+        }
+        if (left > previousLeft || right > previousRight)
+        {
+          this->Tasks.push_back(MergeTask{ previousLeft, left, previousRight, right,
+            previousLeft + (previousRight - rightBegin) });
+        }
+        previousLeft = left;
+        previousRight = right;
+      }
+    }
+    mergedRuns.push_back(this->Size);
+    this->Runs = std::move(mergedRuns);
+    this->CurrentPass = Pass::Merge;
+  }
+
+  // To be called once all the tasks of a round of merges are done.
+  void FinishMerge() { this->InBuffer = !this->InBuffer; }
+
+  // Prepare moving the elements back from the buffer in numberOfChunks tasks.
+  // Returns false when the sorted elements are already in the range.
+  bool PrepareCopyBack(vtkIdType numberOfChunks)
+  {
+    if (!this->InBuffer)
+    {
+      return false;
+    }
+    this->Tasks.clear();
+    for (vtkIdType chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      const vtkIdType begin = chunk * this->Size / numberOfChunks;
+      const vtkIdType end = (chunk + 1) * this->Size / numberOfChunks;
+      this->Tasks.push_back(MergeTask{ begin, end, end, end, begin });
+    }
+    this->CurrentPass = Pass::CopyBack;
+    return true;
+  }
+
+  void Execute(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType index = begin; index < end; ++index)
+    {
+      switch (this->CurrentPass)
+      {
+        case Pass::SortRuns:
+          if (this->Stable)
+          {
+            std::stable_sort(this->Begin + this->Runs[index], this->Begin + this->Runs[index + 1],
+              this->Comp);
+          }
+          else
+          {
+            std::sort(this->Begin + this->Runs[index], this->Begin + this->Runs[index + 1],
+              this->Comp);
+          }
+          break;
+        case Pass::Merge:
+          if (this->InBuffer)
+          {
+            this->Merge(this->Buffer.begin(), this->Begin, this->Tasks[index]);
+          }
+          else
+          {
+            this->Merge(this->Begin, this->Buffer.begin(), this->Tasks[index]);
+          }
+          break;
+        case Pass::CopyBack:
+          std::move(this->Buffer.begin() + this->Tasks[index].LeftBegin,
+            this->Buffer.begin() + this->Tasks[index].LeftEnd,
+            this->Begin + this->Tasks[index].Output);
+          break;
+      }
+    }
+  }
+};
+
+//--------------------------------------------------------------------------------
+template <typename Backend, typename RandomAccessIterator, typename Compare>
+void ParallelMergeSort(Backend& backend, int numberOfThreads, RandomAccessIterator begin,
+  RandomAccessIterator end, Compare& comp, bool stable)
+{
+  const vtkIdType minimumRunSize = 4096;
+  const vtkIdType size = std::distance(begin, end);
+  const vtkIdType numberOfRuns =
+    std::min(static_cast<vtkIdType>(numberOfThreads), size / minimumRunSize);
+  if (numberOfRuns <= 1)
+  {
+    if (stable)
+    {
+      std::stable_sort(begin, end, comp);
+    }
+    else
+    {
+      std::sort(begin, end, comp);
+    }
+    return;
+  }
+
+  MergeSortCall<RandomAccessIterator, Compare> sort(begin, size, comp, stable, numberOfRuns);
+  backend.For(0, numberOfRuns, 1, sort);
+  while (sort.GetNumberOfRuns() > 1)
+  {
+    sort.PrepareMerge(numberOfThreads * 2);
+    backend.For(0, sort.GetNumberOfTasks(), 1, sort);
+    sort.FinishMerge();
+  }
+  if (sort.PrepareCopyBack(numberOfThreads))
+  {
+    backend.For(0, numberOfThreads, 1, sort);
+  }
+}
+
+//--------------------------------------------------------------------------------
+// Mapping of arithmetic keys to unsigned integers with the same ordering, used
+// by the radix sort. Signed integers get their sign bit flipped. Floating point
+// values get all their bits flipped when negative and only their sign bit
+// otherwise. Negative zero sorts before positive zero and NaNs are sorted
+// after +inf or before -inf depending on their sign bit.
+template <typename T, typename Enable = void>
+struct RadixKey;
+
+template <typename T>
+struct RadixKey<T,
+  typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+{
+  using UIntType = typename std::make_unsigned<T>::type;
+  static constexpr UIntType Mask = std::is_signed<T>::value
+    ? static_cast<UIntType>(UIntType(1) << (sizeof(T) * 8 - 1))
+    : UIntType(0);
+
+  static UIntType Encode(T value) { return static_cast<UIntType>(value) ^ Mask; }
+  static T Decode(UIntType key) { return static_cast<T>(key ^ Mask); }
+};
+
+template <typename T, typename UInt>
+struct RadixFloatKey
+{
+  using UIntType = UInt;
+  static constexpr UIntType SignBit = UIntType(1) << (sizeof(UIntType) * 8 - 1);
+
+  static UIntType Encode(T value)
+  {
+    UIntType bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    return (bits & SignBit) ? ~bits : (bits | SignBit);
+  }
+  static T Decode(UIntType key)
+  {
+    const UIntType bits = (key & SignBit) ? (key ^ SignBit) : ~key;
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+  }
+};
+
+template <>
+struct RadixKey<float> : public RadixFloatKey<float, std::uint32_t>
+{
+};
+
+template <>
+struct RadixKey<double> : public RadixFloatKey<double, std::uint64_t>
+{
+};
+
+//--------------------------------------------------------------------------------
+// Parallel least significant digit radix sort on 8 bit digits. Keys are first
+// encoded so that their unsigned integer ordering matches the key ordering,
+// digits having the same value for all the keys are skipped, and each
+// remaining digit goes through a histogram and a scatter pass. Each chunk
+// scatters its elements in order, so the sort is stable and values attached to
+// the keys follow them.
+template <typename KeyT, typename ValueT>
+class RadixSortCall
+{
+  using Traits = RadixKey<KeyT>;
+  using UIntType = typename Traits::UIntType;
+  static constexpr int NumberOfBuckets = 256;
+  static constexpr int NumberOfDigits = static_cast<int>(sizeof(UIntType));
+  using Histogram = std::array<vtkIdType, NumberOfBuckets>;
+
+  enum class Pass
+  {
+    Encode,
+    Count,
+    Scatter,
+    Decode
+  };
+
+  KeyT* Keys;
+  ValueT* Values;
+  vtkIdType Size;
+  vtkIdType NumberOfChunks;
+  Pass CurrentPass = Pass::Encode;
+  int Shift = 0;
+  std::vector<UIntType> EncodedKeys[2];
+  std::vector<ValueT> ValueBuffer;
+  ValueT* ValuesIn[2];
+  int Source = 0;
+  std::vector<Histogram> Histograms;
+  std::vector<UIntType> ChunkAnd;
+  std::vector<UIntType> ChunkOr;
+
+  vtkIdType ChunkBegin(vtkIdType chunk) const { return chunk * this->Size / this->NumberOfChunks; }
+
+public:
+  RadixSortCall(KeyT* keys, ValueT* values, vtkIdType size, vtkIdType numberOfChunks)
+    : Keys(keys)
+    , Values(values)
+    , Size(size)
+    , NumberOfChunks(numberOfChunks)
+    , Histograms(numberOfChunks)
+    , ChunkAnd(numberOfChunks, static_cast<UIntType>(~UIntType(0)))
+    , ChunkOr(numberOfChunks, UIntType(0))
+  {
+    this->EncodedKeys[0].resize(size);
+    this->EncodedKeys[1].resize(size);
+    if (values)
+    {
+      this->ValueBuffer.resize(size);
+    }
+    this->ValuesIn[0] = values;
+    this->ValuesIn[1] = values ? this->ValueBuffer.data() : nullptr;
+  }
+
+  // Returns a bit mask of the key bits which are not the same for all the
+  // keys. Only valid once the encoding pass is done.
+  UIntType GetVaryingBits() const
+  {
+    UIntType allAnd = static_cast<UIntType>(~UIntType(0));
+    UIntType allOr = UIntType(0);
+    for (vtkIdType chunk = 0; chunk < this->NumberOfChunks; ++chunk)
+    {
+      allAnd &= this->ChunkAnd[chunk];
+      allOr |= this->ChunkOr[chunk];
+    }
+    return allAnd ^ allOr;
+  }
+
+  static int GetNumberOfDigits() { return NumberOfDigits; }
+
+  void PrepareCount(int digit)
+  {
+    this->Shift = digit * 8;
+    this->CurrentPass = Pass::Count;
+  }
+
+  // Turn the per chunk histograms into per chunk write offsets, ordered by
+  // digit first and chunk second.
+  void PrepareScatter()
+  {
+    vtkIdType offset = 0;
+    for (int bucket = 0; bucket < NumberOfBuckets; ++bucket)
+    {
+      for (vtkIdType chunk = 0; chunk < this->NumberOfChunks; ++chunk)
+      {
+        const vtkIdType count = this->Histograms[chunk][bucket];
+        this->Histograms[chunk][bucket] = offset;
+        offset += count;
+      }
+    }
+    this->CurrentPass = Pass::Scatter;
+  }
+
+  void FinishScatter() { this->Source = 1 - this->Source; }
+
+  void PrepareDecode() { this->CurrentPass = Pass::Decode; }
+
+  void Execute(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
+    {
+      const vtkIdType first = this->ChunkBegin(chunk);
+      const vtkIdType last = this->ChunkBegin(chunk + 1);
+      UIntType* source = this->EncodedKeys[this->Source].data();
+      switch (this->CurrentPass)
+      {
+        case Pass::Encode:
+        {
+          UIntType chunkAnd = static_cast<UIntType>(~UIntType(0));
+          UIntType chunkOr = UIntType(0);
+          for (vtkIdType i = first; i < last; ++i)
+          {
+            const UIntType key = Traits::Encode(this->Keys[i]);
+            source[i] = key;
+            chunkAnd &= key;
+            chunkOr |= key;
+          }
+          this->ChunkAnd[chunk] = chunkAnd;
+          this->ChunkOr[chunk] = chunkOr;
+          break;
+        }
+        case Pass::Count:
+        {
+          Histogram& histogram = this->Histograms[chunk];
+          histogram.fill(0);
+          for (vtkIdType i = first; i < last; ++i)
+          {
+            ++histogram[(source[i] >> this->Shift) & 0xff];
+          }
+          break;
+        }
+        case Pass::Scatter:
+        {
+          Histogram& offsets = this->Histograms[chunk];
+          UIntType* destination = this->EncodedKeys[1 - this->Source].data();
+          const ValueT* valuesIn = this->ValuesIn[this->Source];
+          ValueT* valuesOut = this->ValuesIn[1 - this->Source];
+          for (vtkIdType i = first; i < last; ++i)
+          {
+            const vtkIdType position = offsets[(source[i] >> this->Shift) & 0xff]++;
+            destination[position] = source[i];
+            if (valuesIn)
+            {
+              valuesOut[position] = valuesIn[i];
+            }
+          }
+          break;
+        }
+        case Pass::Decode:
+        {
+          for (vtkIdType i = first; i < last; ++i)
+          {
+            this->Keys[i] = Traits::Decode(source[i]);
+          }
+          if (this->Values && this->Source == 1)
+          {
+            std::copy(this->ValueBuffer.begin() + first, this->ValueBuffer.begin() + last,
+              this->Values + first);
+          }
+          break;
+        }
+      }
+    }
+  }
+};
+
+//--------------------------------------------------------------------------------
+// Sort keys in ascending order, permuting values (when not null) along. The
+// sort is stable.
+template <typename Backend, typename KeyT, typename ValueT>
+void ParallelRadixSort(
+  Backend& backend, int numberOfThreads, KeyT* keysBegin, KeyT* keysEnd, ValueT* values)
+{
+  const vtkIdType minimumChunkSize = 16384;
+  const vtkIdType size = keysEnd - keysBegin;
+  if (size < 2)
+  {
+    return;
+  }
+  const vtkIdType numberOfChunks = std::max<vtkIdType>(
+    1, std::min(static_cast<vtkIdType>(numberOfThreads), size / minimumChunkSize));
+
+  using SortCall = RadixSortCall<KeyT, ValueT>;
+  SortCall sort(keysBegin, values, size, numberOfChunks);
+  backend.For(0, numberOfChunks, 1, sort);
+  const auto varyingBits = sort.GetVaryingBits();
+  for (int digit = 0; digit < SortCall::GetNumberOfDigits(); ++digit)
+  {
+    if (((varyingBits >> (digit * 8)) & 0xff) == 0)
+    {
+      continue;
+    }
+    sort.PrepareCount(digit);
+    backend.For(0, numberOfChunks, 1, sort);
+    sort.PrepareScatter();
+    backend.For(0, numberOfChunks, 1, sort);
+    sort.FinishScatter();
+  }
+  sort.PrepareDecode();
+  backend.For(0, numberOfChunks, 1, sort);
+}
+
+VTK_ABI_NAMESPACE_END
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
+/* VTK-HeaderTest-Exclude: vtkSMPToolsSortInternal.h */
@@ -14,6 +14,7 @@
 =========================================================================*/
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
+#include "SMP/Common/vtkSMPTaskGraphInternal.h"
 #include "SMP/OpenMP/vtkSMPToolsImpl.txx"
 
 #include <cstdlib> // For std::getenv()
@@ -30,6 +31,18 @@ VTK_ABI_NAMESPACE_BEGIN
 static int specifiedNumThreads = 0;
 static std::stack<int> threadIdStack;
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Spawn an OpenMP task executing a ready task of the graph. Its successors
+// are spawned in turn by the thread finishing their last dependency.
+void SpawnTaskGraphTask(vtkSMPTaskGraphExecution* execution, vtkIdType id)
+{
+#pragma omp task firstprivate(execution, id)
+  execution->Run(id, [execution](vtkIdType ready) { SpawnTaskGraphTask(execution, ready); });
+}
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 template <>
 void vtkSMPToolsImpl<BackendType::OpenMP>::Initialize(int numThreads)
@@ -108,6 +121,42 @@ void vtkSMPToolsImplForOpenMP(vtkIdType first, vtkIdType last, vtkIdType grain,
   threadIdStack.pop();
 }
 
+//------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::OpenMP>::RunTaskGraph(vtkSMPTaskGraphStorage& graph)
+{
+  if (!this->NestedActivated && this->IsParallel)
+  {
+    for (auto& task : graph.Tasks)
+    {
+      if (task.Work)
+      {
+        task.Work();
+      }
+    }
+    return;
+  }
+
+  bool fromParallelCode = this->IsParallel.exchange(true);
+
+  vtkSMPTaskGraphExecution execution(graph);
+  vtkSMPTaskGraphExecution* executionPtr = &execution;
+  omp_set_nested(this->NestedActivated);
+
+  threadIdStack.emplace(omp_get_thread_num());
+
+  // Every task bound to the parallel region is done at its implicit barrier.
+#pragma omp parallel
+#pragma omp single
+  execution.ForEachRoot([executionPtr](vtkIdType root) { SpawnTaskGraphTask(executionPtr, root); });
+
+  threadIdStack.pop();
+
+  // See vtkSMPToolsImpl<BackendType::OpenMP>::For for this atomic contortion.
+  bool trueFlag = true;
+  this->IsParallel.compare_exchange_weak(trueFlag, fromParallelCode);
+}
+
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
@@ -16,11 +16,13 @@
 #ifndef OpenMPvtkSMPToolsImpl_txx
 #define OpenMPvtkSMPToolsImpl_txx
 
-#include <algorithm> // For std::sort
+#include <algorithm>  // For std::sort
+#include <functional> // For std::less
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
-#include "SMP/Common/vtkSMPToolsInternal.h" // For common vtk smp class
-#include "vtkCommonCoreModule.h"            // For export macro
+#include "SMP/Common/vtkSMPToolsInternal.h"     // For common vtk smp class
+#include "SMP/Common/vtkSMPToolsSortInternal.h" // For parallel sorts
+#include "vtkCommonCoreModule.h"                // For export macro
 
 namespace vtk
 {
@@ -127,7 +129,9 @@ template <typename RandomAccessIterator>
 void vtkSMPToolsImpl<BackendType::OpenMP>::Sort(
   RandomAccessIterator begin, RandomAccessIterator end)
 {
-  std::sort(begin, end);
+  using ValueType = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  std::less<ValueType> comp;
+  ParallelMergeSort(*this, GetNumberOfThreadsOpenMP(), begin, end, comp, false);
 }
 
 //--------------------------------------------------------------------------------
@@ -136,7 +140,36 @@ template <typename RandomAccessIterator, typename Compare>
 void vtkSMPToolsImpl<BackendType::OpenMP>::Sort(
   RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
 {
-  std::sort(begin, end, comp);
+  ParallelMergeSort(*this, GetNumberOfThreadsOpenMP(), begin, end, comp, false);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator, typename Compare>
+void vtkSMPToolsImpl<BackendType::OpenMP>::StableSort(
+  RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+{
+  ParallelMergeSort(*this, GetNumberOfThreadsOpenMP(), begin, end, comp, true);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename KeyT, typename ValueT>
+void vtkSMPToolsImpl<BackendType::OpenMP>::RadixSort(
+  KeyT* keysBegin, KeyT* keysEnd, ValueT* values)
+{
+  ParallelRadixSort(*this, GetNumberOfThreadsOpenMP(), keysBegin, keysEnd, values);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename SegmentFlags, typename T, typename BinaryOp,
+  typename UnaryOp>
+T vtkSMPToolsImpl<BackendType::OpenMP>::Scan(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+  SegmentFlags flags, T init, BinaryOp op, UnaryOp transform, bool inclusive)
+{
+  return ParallelScan(*this, GetNumberOfThreadsOpenMP(), inBegin, inEnd, outBegin, flags, init, op,
+    transform, inclusive);
 }
 
 //--------------------------------------------------------------------------------
@@ -151,6 +184,10 @@ int vtkSMPToolsImpl<BackendType::OpenMP>::GetEstimatedNumberOfThreads();
 template <>
 bool vtkSMPToolsImpl<BackendType::OpenMP>::GetSingleThread();
 
+//--------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::OpenMP>::RunTaskGraph(vtkSMPTaskGraphStorage&);
+
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
@@ -15,7 +15,17 @@
 
 #include "SMP/STDThread/vtkSMPThreadPool.h"
 
+#include <atomic>   // For std::atomic
+#include <cstring>  // For std::strcmp
 #include <iostream>
+#include <string>   // For std::string
+
+#if defined(__linux__)
+#include <fstream> // For std::ifstream
+#include <pthread.h>
+#include <sched.h>
+#include <sstream> // For std::istringstream
+#endif
 
 namespace vtk
 {
@@ -25,12 +35,115 @@ namespace smp
 {
 VTK_ABI_NAMESPACE_BEGIN
 
+namespace
+{
+std::atomic<vtkSMPThreadPool::Affinity> affinityPolicy(vtkSMPThreadPool::Affinity::None);
+
+//------------------------------------------------------------------------------
+// Cores this process may run on, grouped by NUMA node. When the NUMA topology
+// cannot be read, all the allowed cores are put in a single node.
+using NUMATopology = std::vector<std::vector<int>>;
+
+#if defined(__linux__)
+//------------------------------------------------------------------------------
+// Parse a sysfs cpu list such as "0-3,8-11".
+std::vector<int> ParseCPUList(const std::string& list)
+{
+  std::vector<int> cpus;
+  std::istringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ','))
+  {
+    const std::size_t dash = range.find('-');
+    try
+    {
+      const int first = std::stoi(range.substr(0, dash));
+      const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu)
+      {
+        cpus.push_back(cpu);
+      }
+    }
+    catch (...)
+    {
+      // Ignore malformed ranges, e.g. the trailing newline.
+    }
+  }
+  return cpus;
+}
+#endif
+
+//------------------------------------------------------------------------------
+NUMATopology DiscoverTopology()
+{
+  NUMATopology nodes;
+#if defined(__linux__)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+  {
+    return nodes;
+  }
+
+  // Node ids may not be contiguous, look at a reasonable number of them.
+  for (int node = 0; node < 1024; ++node)
+  {
+    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    if (!file)
+    {
+      continue;
+    }
+    std::string list;
+    std::getline(file, list);
+    std::vector<int> cpus;
+    for (int cpu : ParseCPUList(list))
+    {
+      if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+      {
+        cpus.push_back(cpu);
+      }
+    }
+    if (!cpus.empty())
+    {
+      nodes.push_back(std::move(cpus));
+    }
+  }
+
+  if (nodes.empty())
+  {
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      if (CPU_ISSET(cpu, &allowed))
+      {
+        cpus.push_back(cpu);
+      }
+    }
+    if (!cpus.empty())
+    {
+      nodes.push_back(std::move(cpus));
+    }
+  }
+#endif
+  return nodes;
+}
+
+//------------------------------------------------------------------------------
+const NUMATopology& GetTopology()
+{
+  static const NUMATopology topology = DiscoverTopology();
+  return topology;
+}
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
 vtkSMPThreadPool::vtkSMPThreadPool(int threadNumber)
 {
   this->Threads.reserve(threadNumber);
   for (int i = 0; i < threadNumber; ++i)
   {
     this->Threads.emplace_back(std::bind(&vtkSMPThreadPool::ThreadJob, this));
+    vtkSMPThreadPool::ApplyAffinity(this->Threads.back(), i, threadNumber);
   }
 }
 
@@ -85,6 +198,123 @@ std::vector<std::thread>* vtk::detail::smp::vtkSMPThreadPool::GetThreads()
 {
   return &(this->Threads);
 }
+
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::SetAffinity(Affinity affinity)
+{
+  affinityPolicy = affinity;
+}
+
+//------------------------------------------------------------------------------
+bool vtkSMPThreadPool::SetAffinity(const char* affinity)
+{
+  if (!affinity)
+  {
+    return false;
+  }
+  if (std::strcmp(affinity, "none") == 0)
+  {
+    vtkSMPThreadPool::SetAffinity(Affinity::None);
+  }
+  else if (std::strcmp(affinity, "compact") == 0)
+  {
+    vtkSMPThreadPool::SetAffinity(Affinity::Compact);
+  }
+  else if (std::strcmp(affinity, "scatter") == 0)
+  {
+    vtkSMPThreadPool::SetAffinity(Affinity::Scatter);
+  }
+  else if (std::strcmp(affinity, "numa") == 0)
+  {
+    vtkSMPThreadPool::SetAffinity(Affinity::NUMANode);
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+vtkSMPThreadPool::Affinity vtkSMPThreadPool::GetAffinity()
+{
+  return affinityPolicy;
+}
+
+//------------------------------------------------------------------------------
+int vtkSMPThreadPool::GetNumberOfNUMANodes()
+{
+  const std::size_t numberOfNodes = GetTopology().size();
+  return numberOfNodes > 0 ? static_cast<int>(numberOfNodes) : 1;
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPThreadPool::ApplyAffinity(std::thread& thread, int index, int numberOfThreads)
+{
+  const Affinity affinity = affinityPolicy;
+  if (affinity == Affinity::None || numberOfThreads <= 0)
+  {
+    return;
+  }
+#if defined(__linux__)
+  const NUMATopology& nodes = GetTopology();
+  if (nodes.empty())
+  {
+    return;
+  }
+  const int numberOfNodes = static_cast<int>(nodes.size());
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  switch (affinity)
+  {
+    case Affinity::Compact:
+    {
+      // Fill the cores of each node before moving to the next one.
+      std::size_t numberOfCores = 0;
+      for (const auto& node : nodes)
+      {
+        numberOfCores += node.size();
+      }
+      std::size_t core = static_cast<std::size_t>(index) % numberOfCores;
+      for (const auto& node : nodes)
+      {
+        if (core < node.size())
+        {
+          CPU_SET(node[core], &cpus);
+          break;
+        }
+        core -= node.size();
+      }
+      break;
+    }
+    case Affinity::Scatter:
+    {
+      // Round-robin over the nodes, then over the cores of each node.
+      const auto& node = nodes[index % numberOfNodes];
+      CPU_SET(node[(index / numberOfNodes) % node.size()], &cpus);
+      break;
+    }
+    case Affinity::NUMANode:
+    {
+      // Contiguous groups of threads share the cores of a node.
+      const auto& node =
+        nodes[static_cast<long long>(index) * numberOfNodes / numberOfThreads % numberOfNodes];
+      for (int cpu : node)
+      {
+        CPU_SET(cpu, &cpus);
+      }
+      break;
+    }
+    default:
+      return;
+  }
+  pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+#else
+  (void)thread;
+  (void)index;
+#endif
+}
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
@@ -20,6 +20,17 @@
 // The DoJob() method is used attributes the job to a free thread, if all
 // threads are working, the job is kept in a queue. Note that vtkSMPThreadPool
 // destructor joins threads and finish the jobs in the queue.
+//
+// Threads can be pinned to cores according to an affinity policy, set with
+// SetAffinity() or with the VTK_SMP_THREAD_AFFINITY environment variable:
+// - "none" (default): threads are not pinned,
+// - "compact": thread i is pinned to the ith core, filling NUMA nodes one
+//   after the other,
+// - "scatter": threads are pinned to cores distributed round-robin across
+//   NUMA nodes,
+// - "numa": threads are split in contiguous groups, one per NUMA node, each
+//   thread being allowed to run on any core of its node.
+// Pinning is only supported on Linux, the policy is ignored elsewhere.
 
 #ifndef vtkSMPThreadPool_h
 #define vtkSMPThreadPool_h
@@ -32,6 +43,7 @@
 #include <mutex>              // For std::mutex
 #include <queue>              // For std::queue
 #include <thread>             // For std::thread
+#include <vector>             // For std::vector
 
 namespace vtk
 {
@@ -44,12 +56,35 @@ VTK_ABI_NAMESPACE_BEGIN
 class VTKCOMMONCORE_EXPORT vtkSMPThreadPool
 {
 public:
+  enum class Affinity
+  {
+    None,
+    Compact,
+    Scatter,
+    NUMANode
+  };
+
   explicit vtkSMPThreadPool(int ThreadNumber);
 
   void Join();
   void DoJob(std::function<void(void)> job);
   std::vector<std::thread>* GetThreads();
 
+  // Set/Get the affinity policy used to pin the threads of the pools created
+  // afterwards. SetAffinity() with a string accepts "none", "compact",
+  // "scatter" and "numa" and returns false if the name is unknown.
+  static void SetAffinity(Affinity affinity);
+  static bool SetAffinity(const char* affinity);
+  static Affinity GetAffinity();
+
+  // Pin the thread running as the index-th of numberOfThreads threads
+  // according to the current affinity policy. Does nothing when the policy
+  // is None.
+  static void ApplyAffinity(std::thread& thread, int index, int numberOfThreads);
+
+  // Number of NUMA nodes containing cores this process is allowed to use.
+  static int GetNumberOfNUMANodes();
+
 private:
   void ThreadJob();
 
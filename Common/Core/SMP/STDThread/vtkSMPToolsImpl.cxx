@@ -14,11 +14,17 @@
 =========================================================================*/
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
+#include "SMP/Common/vtkSMPTaskGraphInternal.h"
 #include "SMP/STDThread/vtkSMPToolsImpl.txx"
 
-#include <cstdlib> // For std::getenv()
-#include <stack>   // For std::stack
-#include <thread>  // For std::thread::hardware_concurrency()
+#include <condition_variable> // For std::condition_variable
+#include <cstdlib>            // For std::getenv()
+#include <deque>              // For std::deque
+#include <iostream>           // For std::cerr
+#include <mutex>              // For std::mutex
+#include <stack>              // For std::stack
+#include <thread>             // For std::thread::hardware_concurrency()
+#include <vector>             // For std::vector
 
 namespace vtk
 {
@@ -31,10 +37,150 @@ static int specifiedNumThreads = 0;
 static std::stack<std::thread::id> threadIdStack;
 static std::mutex threadIdStackLock;
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Double ended queue of ready tasks owned by one worker. The owner pushes and
+// pops at the back (LIFO, so a continuation runs on the thread whose caches
+// hold its inputs) while idle workers steal the oldest tasks at the front.
+class TaskGraphWorkerQueue
+{
+public:
+  void Push(vtkIdType task)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Tasks.push_back(task);
+  }
+
+  bool Pop(vtkIdType& task)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->Tasks.empty())
+    {
+      return false;
+    }
+    task = this->Tasks.back();
+    this->Tasks.pop_back();
+    return true;
+  }
+
+  bool Steal(vtkIdType& task)
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->Tasks.empty())
+    {
+      return false;
+    }
+    task = this->Tasks.front();
+    this->Tasks.pop_front();
+    return true;
+  }
+
+private:
+  std::mutex Mutex;
+  std::deque<vtkIdType> Tasks;
+};
+
+//------------------------------------------------------------------------------
+// Lets idle workers sleep until tasks are made ready or the graph is done.
+// Every notification bumps an epoch, so that a worker which found no task
+// after reading the epoch cannot miss a task pushed in the meantime.
+class TaskGraphWakeup
+{
+public:
+  unsigned long long GetEpoch()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    return this->Epoch;
+  }
+
+  void Notify()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    ++this->Epoch;
+    if (this->NumberOfSleepers > 0)
+    {
+      this->Condition.notify_all();
+    }
+  }
+
+  void Wait(unsigned long long epoch, const vtkSMPTaskGraphExecution& execution)
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    ++this->NumberOfSleepers;
+    this->Condition.wait(lock, [&]() { return this->Epoch != epoch || execution.IsDone(); });
+    --this->NumberOfSleepers;
+  }
+
+private:
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  unsigned long long Epoch = 0;
+  int NumberOfSleepers = 0;
+};
+
+// Number of times an idle worker looks for a task again before sleeping.
+constexpr int TaskGraphWorkerSpins = 64;
+
+//------------------------------------------------------------------------------
+void RunTaskGraphWorker(vtkSMPTaskGraphExecution& execution,
+  std::vector<TaskGraphWorkerQueue>& queues, TaskGraphWakeup& wakeup, int index)
+{
+  const int numberOfQueues = static_cast<int>(queues.size());
+  TaskGraphWorkerQueue& local = queues[index];
+  bool pushed = false;
+  auto pushLocal = [&local, &pushed](vtkIdType ready) {
+    local.Push(ready);
+    pushed = true;
+  };
+
+  vtkIdType task;
+  int spins = 0;
+  while (!execution.IsDone())
+  {
+    const unsigned long long epoch = wakeup.GetEpoch();
+    bool found = local.Pop(task);
+    for (int i = 1; !found && i < numberOfQueues; ++i)
+    {
+      found = queues[(index + i) % numberOfQueues].Steal(task);
+    }
+    if (found)
+    {
+      spins = 0;
+      pushed = false;
+      execution.Run(task, pushLocal);
+      if (pushed || execution.IsDone())
+      {
+        wakeup.Notify();
+      }
+    }
+    else if (++spins < TaskGraphWorkerSpins)
+    {
+      std::this_thread::yield();
+    }
+    else
+    {
+      spins = 0;
+      wakeup.Wait(epoch, execution);
+    }
+  }
+}
+} // anonymous namespace
+
 //------------------------------------------------------------------------------
 template <>
 void vtkSMPToolsImpl<BackendType::STDThread>::Initialize(int numThreads)
 {
+  const char* vtkSmpThreadAffinity = std::getenv("VTK_SMP_THREAD_AFFINITY");
+  if (vtkSmpThreadAffinity && !vtkSMPThreadPool::SetAffinity(vtkSmpThreadAffinity))
+  {
+    vtkSMPThreadPool::SetAffinity(vtkSMPThreadPool::Affinity::None);
+    std::cerr << "WARNING: unknown VTK_SMP_THREAD_AFFINITY value \"" << vtkSmpThreadAffinity
+              << "\", the threads are not pinned.\n";
+    std::cerr << "The accepted values are: \"none\", \"compact\", \"scatter\" and \"numa\"."
+              << std::endl;
+  }
+
   const int maxThreads = std::thread::hardware_concurrency();
   if (numThreads == 0)
   {
@@ -97,6 +243,54 @@ bool vtkSMPToolsImpl<BackendType::STDThread>::GetSingleThread()
   return GetSingleThreadSTDThread();
 }
 
+//------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::STDThread>::RunTaskGraph(vtkSMPTaskGraphStorage& graph)
+{
+  const int threadNumber = GetNumberOfThreadsSTDThread();
+  if (threadNumber <= 1 || graph.Tasks.size() <= 1 || (!this->NestedActivated && this->IsParallel))
+  {
+    for (auto& task : graph.Tasks)
+    {
+      if (task.Work)
+      {
+        task.Work();
+      }
+    }
+    return;
+  }
+
+  bool fromParallelCode = this->IsParallel.exchange(true);
+
+  vtkSMPTaskGraphExecution execution(graph);
+  std::vector<TaskGraphWorkerQueue> queues(threadNumber);
+  TaskGraphWakeup wakeup;
+  int nextQueue = 0;
+  execution.ForEachRoot(
+    [&](vtkIdType root) { queues[nextQueue++ % threadNumber].Push(root); });
+
+  // The calling thread is the first worker.
+  PushThreadId(std::this_thread::get_id());
+  std::vector<std::thread> threads;
+  threads.reserve(threadNumber - 1);
+  for (int i = 1; i < threadNumber; ++i)
+  {
+    threads.emplace_back(
+      RunTaskGraphWorker, std::ref(execution), std::ref(queues), std::ref(wakeup), i);
+    vtkSMPThreadPool::ApplyAffinity(threads.back(), i, threadNumber);
+  }
+  RunTaskGraphWorker(execution, queues, wakeup, 0);
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  PopThreadId();
+
+  // See vtkSMPToolsImpl<BackendType::STDThread>::For for this atomic contortion.
+  bool trueFlag = true;
+  this->IsParallel.compare_exchange_weak(trueFlag, fromParallelCode);
+}
+
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
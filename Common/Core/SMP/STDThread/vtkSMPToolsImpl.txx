@@ -17,12 +17,13 @@
 #define STDThreadvtkSMPToolsImpl_txx
 
 #include <algorithm>  // For std::sort
-#include <functional> // For std::bind
+#include <functional> // For std::bind, std::less
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
-#include "SMP/Common/vtkSMPToolsInternal.h" // For common vtk smp class
-#include "SMP/STDThread/vtkSMPThreadPool.h" // For vtkSMPThreadPool
-#include "vtkCommonCoreModule.h"            // For export macro
+#include "SMP/Common/vtkSMPToolsInternal.h"     // For common vtk smp class
+#include "SMP/Common/vtkSMPToolsSortInternal.h" // For parallel sorts
+#include "SMP/STDThread/vtkSMPThreadPool.h"     // For vtkSMPThreadPool
+#include "vtkCommonCoreModule.h"                // For export macro
 
 namespace vtk
 {
@@ -145,7 +146,9 @@ template <typename RandomAccessIterator>
 void vtkSMPToolsImpl<BackendType::STDThread>::Sort(
   RandomAccessIterator begin, RandomAccessIterator end)
 {
-  std::sort(begin, end);
+  using ValueType = typename std::iterator_traits<RandomAccessIterator>::value_type;
+  std::less<ValueType> comp;
+  ParallelMergeSort(*this, GetNumberOfThreadsSTDThread(), begin, end, comp, false);
 }
 
 //--------------------------------------------------------------------------------
@@ -154,7 +157,36 @@ template <typename RandomAccessIterator, typename Compare>
 void vtkSMPToolsImpl<BackendType::STDThread>::Sort(
   RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
 {
-  std::sort(begin, end, comp);
+  ParallelMergeSort(*this, GetNumberOfThreadsSTDThread(), begin, end, comp, false);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator, typename Compare>
+void vtkSMPToolsImpl<BackendType::STDThread>::StableSort(
+  RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+{
+  ParallelMergeSort(*this, GetNumberOfThreadsSTDThread(), begin, end, comp, true);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename KeyT, typename ValueT>
+void vtkSMPToolsImpl<BackendType::STDThread>::RadixSort(
+  KeyT* keysBegin, KeyT* keysEnd, ValueT* values)
+{
+  ParallelRadixSort(*this, GetNumberOfThreadsSTDThread(), keysBegin, keysEnd, values);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename SegmentFlags, typename T, typename BinaryOp,
+  typename UnaryOp>
+T vtkSMPToolsImpl<BackendType::STDThread>::Scan(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+  SegmentFlags flags, T init, BinaryOp op, UnaryOp transform, bool inclusive)
+{
+  return ParallelScan(*this, GetNumberOfThreadsSTDThread(), inBegin, inEnd, outBegin, flags, init,
+    op, transform, inclusive);
 }
 
 //--------------------------------------------------------------------------------
@@ -169,6 +201,10 @@ int vtkSMPToolsImpl<BackendType::STDThread>::GetEstimatedNumberOfThreads();
 template <>
 bool vtkSMPToolsImpl<BackendType::STDThread>::GetSingleThread();
 
+//--------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::STDThread>::RunTaskGraph(vtkSMPTaskGraphStorage&);
+
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
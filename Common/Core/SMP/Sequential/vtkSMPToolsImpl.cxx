@@ -14,6 +14,7 @@
 =========================================================================*/
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
+#include "SMP/Common/vtkSMPTaskGraphInternal.h"
 #include "SMP/Sequential/vtkSMPToolsImpl.txx"
 
 namespace vtk
@@ -44,6 +45,21 @@ bool vtkSMPToolsImpl<BackendType::Sequential>::GetSingleThread()
   return true;
 }
 
+//------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::Sequential>::RunTaskGraph(vtkSMPTaskGraphStorage& graph)
+{
+  // Tasks only depend on previously spawned tasks: spawn order is a valid
+  // execution order.
+  for (auto& task : graph.Tasks)
+  {
+    if (task.Work)
+    {
+      task.Work();
+    }
+  }
+}
+
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
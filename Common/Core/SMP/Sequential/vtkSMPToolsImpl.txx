@@ -19,7 +19,8 @@
 #include <algorithm> // For std::sort, std::transform, std::fill
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
-#include "SMP/Common/vtkSMPToolsInternal.h" // For common vtk smp class
+#include "SMP/Common/vtkSMPToolsInternal.h"     // For common vtk smp class
+#include "SMP/Common/vtkSMPToolsSortInternal.h" // For parallel sorts
 
 namespace vtk
 {
@@ -105,6 +106,35 @@ void vtkSMPToolsImpl<BackendType::Sequential>::Sort(
   std::sort(begin, end, comp);
 }
 
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator, typename Compare>
+void vtkSMPToolsImpl<BackendType::Sequential>::StableSort(
+  RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+{
+  std::stable_sort(begin, end, comp);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename KeyT, typename ValueT>
+void vtkSMPToolsImpl<BackendType::Sequential>::RadixSort(
+  KeyT* keysBegin, KeyT* keysEnd, ValueT* values)
+{
+  ParallelRadixSort(*this, 1, keysBegin, keysEnd, values);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename SegmentFlags, typename T, typename BinaryOp,
+  typename UnaryOp>
+T vtkSMPToolsImpl<BackendType::Sequential>::Scan(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+  SegmentFlags flags, T init, BinaryOp op, UnaryOp transform, bool inclusive)
+{
+  return SequentialScan(inBegin, std::distance(inBegin, inEnd), outBegin, flags.At(0), init, init,
+    op, transform, inclusive);
+}
+
 //--------------------------------------------------------------------------------
 template <>
 void vtkSMPToolsImpl<BackendType::Sequential>::Initialize(int);
@@ -117,6 +147,10 @@ int vtkSMPToolsImpl<BackendType::Sequential>::GetEstimatedNumberOfThreads();
 template <>
 bool vtkSMPToolsImpl<BackendType::Sequential>::GetSingleThread();
 
+//--------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::Sequential>::RunTaskGraph(vtkSMPTaskGraphStorage&);
+
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
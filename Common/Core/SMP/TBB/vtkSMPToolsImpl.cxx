@@ -14,6 +14,7 @@
 =========================================================================*/
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
+#include "SMP/Common/vtkSMPTaskGraphInternal.h"
 #include "SMP/TBB/vtkSMPToolsImpl.txx"
 
 #include <cstdlib> // For std::getenv()
@@ -26,6 +27,7 @@
 #endif
 
 #include <tbb/task_arena.h> // For tbb:task_arena
+#include <tbb/task_group.h> // For tbb:task_group
 
 #ifdef _MSC_VER
 #pragma pop_macro("__TBB_NO_IMPLICIT_LINKAGE")
@@ -115,6 +117,54 @@ void vtkSMPToolsImplForTBB(vtkIdType first, vtkIdType last, vtkIdType grain,
   threadIdStackLock.unlock();
 }
 
+//------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::TBB>::RunTaskGraph(vtkSMPTaskGraphStorage& graph)
+{
+  if (!this->NestedActivated && this->IsParallel)
+  {
+    for (auto& task : graph.Tasks)
+    {
+      if (task.Work)
+      {
+        task.Work();
+      }
+    }
+    return;
+  }
+
+  bool fromParallelCode = this->IsParallel.exchange(true);
+
+  vtkSMPTaskGraphExecution execution(graph);
+  auto runGraph = [&execution]() {
+    tbb::task_group group;
+    std::function<void(vtkIdType)> spawn = [&](vtkIdType id) {
+      group.run([&spawn, &execution, id]() { execution.Run(id, spawn); });
+    };
+    execution.ForEachRoot(spawn);
+    group.wait();
+  };
+
+  threadIdStackLock.lock();
+  threadIdStack.emplace(tbb::this_task_arena::current_thread_index());
+  threadIdStackLock.unlock();
+  if (taskArena.is_active())
+  {
+    taskArena.execute(runGraph);
+  }
+  else
+  {
+    runGraph();
+  }
+  threadIdStackLock.lock();
+  threadIdStack.pop();
+  threadIdStackLock.unlock();
+
+  // See vtkSMPToolsImpl<BackendType::TBB>::For for this atomic contortion.
+  bool trueFlag = true;
+  this->IsParallel.compare_exchange_weak(trueFlag, fromParallelCode);
+}
+
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
@@ -17,8 +17,9 @@
 #define TBBvtkSMPToolsImpl_txx
 
 #include "SMP/Common/vtkSMPToolsImpl.h"
-#include "SMP/Common/vtkSMPToolsInternal.h" // For common vtk smp class
-#include "vtkCommonCoreModule.h"            // For export macro
+#include "SMP/Common/vtkSMPToolsInternal.h"     // For common vtk smp class
+#include "SMP/Common/vtkSMPToolsSortInternal.h" // For parallel sorts
+#include "vtkCommonCoreModule.h"                // For export macro
 
 #ifdef _MSC_VER
 #pragma push_macro("__TBB_NO_IMPLICIT_LINKAGE")
@@ -190,6 +191,35 @@ void vtkSMPToolsImpl<BackendType::TBB>::Sort(
   tbb::parallel_sort(begin, end, comp);
 }
 
+//--------------------------------------------------------------------------------
+template <>
+template <typename RandomAccessIterator, typename Compare>
+void vtkSMPToolsImpl<BackendType::TBB>::StableSort(
+  RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+{
+  ParallelMergeSort(*this, this->GetEstimatedNumberOfThreads(), begin, end, comp, true);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename KeyT, typename ValueT>
+void vtkSMPToolsImpl<BackendType::TBB>::RadixSort(
+  KeyT* keysBegin, KeyT* keysEnd, ValueT* values)
+{
+  ParallelRadixSort(*this, this->GetEstimatedNumberOfThreads(), keysBegin, keysEnd, values);
+}
+
+//--------------------------------------------------------------------------------
+template <>
+template <typename InputIt, typename OutputIt, typename SegmentFlags, typename T, typename BinaryOp,
+  typename UnaryOp>
+T vtkSMPToolsImpl<BackendType::TBB>::Scan(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+  SegmentFlags flags, T init, BinaryOp op, UnaryOp transform, bool inclusive)
+{
+  return ParallelScan(*this, this->GetEstimatedNumberOfThreads(), inBegin, inEnd, outBegin, flags,
+    init, op, transform, inclusive);
+}
+
 //--------------------------------------------------------------------------------
 template <>
 void vtkSMPToolsImpl<BackendType::TBB>::Initialize(int);
@@ -202,6 +232,10 @@ int vtkSMPToolsImpl<BackendType::TBB>::GetEstimatedNumberOfThreads();
 template <>
 bool vtkSMPToolsImpl<BackendType::TBB>::GetSingleThread();
 
+//--------------------------------------------------------------------------------
+template <>
+void vtkSMPToolsImpl<BackendType::TBB>::RunTaskGraph(vtkSMPTaskGraphStorage&);
+
 VTK_ABI_NAMESPACE_END
 } // namespace smp
 } // namespace detail
@@ -0,0 +1,128 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBufferAllocationPolicy.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkFloatArray.h"
+#include "vtkNew.h"
+#include "vtkSOADataArrayTemplate.h"
+
+#include <cstdint>
+
+namespace
+{
+bool CheckArray(vtkFloatArray* array, vtkIdType numberOfValues, int policy)
+{
+  if (array->GetAllocationPolicy() != policy)
+  {
+    std::cerr << "Wrong allocation policy " << array->GetAllocationPolicy() << ", expected "
+              << policy << std::endl;
+    return false;
+  }
+  if (policy != vtkObjectBase::BUFFER_DEFAULT_ALLOCATION &&
+    reinterpret_cast<std::uintptr_t>(array->GetPointer(0)) % 64 != 0)
+  {
+    std::cerr << "Buffer of policy " << policy << " is not aligned" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+  {
+    if (array->GetValue(i) != static_cast<float>(i))
+    {
+      std::cerr << "Wrong value " << array->GetValue(i) << " at " << i << " with policy " << policy
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestPolicy(int policy)
+{
+  vtkObjectBase::SetBufferAllocationPolicy(policy);
+  // Large enough to use huge pages.
+  const vtkIdType numberOfValues = 1 << 20;
+  vtkNew<vtkFloatArray> array;
+  array->SetNumberOfValues(numberOfValues);
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+  {
+    array->SetValue(i, static_cast<float>(i));
+  }
+  if (!CheckArray(array, numberOfValues, policy))
+  {
+    return false;
+  }
+
+  // Growing keeps the values and the policy.
+  array->InsertNextValue(static_cast<float>(numberOfValues));
+  array->Resize(numberOfValues + 100);
+  if (!CheckArray(array, numberOfValues + 1, policy))
+  {
+    return false;
+  }
+
+  // Arrays grown from empty use the policy too.
+  vtkNew<vtkFloatArray> inserted;
+  inserted->InsertNextValue(0.0f);
+  vtkNew<vtkFloatArray> insertedTuple;
+  insertedTuple->SetNumberOfComponents(2);
+  const float tuple[2] = { 0.0f, 1.0f };
+  insertedTuple->InsertNextTuple(tuple);
+  vtkNew<vtkFloatArray> resized;
+  resized->Resize(numberOfValues);
+  resized->SetNumberOfValues(numberOfValues);
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+  {
+    resized->SetValue(i, static_cast<float>(i));
+  }
+  if (!CheckArray(inserted, 1, policy) || !CheckArray(insertedTuple, 2, policy) ||
+    !CheckArray(resized, numberOfValues, policy))
+  {
+    return false;
+  }
+
+  // Changing the policy of an array moves its values.
+  for (int other = vtkObjectBase::BUFFER_DEFAULT_ALLOCATION;
+       other <= vtkObjectBase::BUFFER_HUGE_PAGES; ++other)
+  {
+    if (!array->SetAllocationPolicy(other) || !CheckArray(array, numberOfValues + 1, other))
+    {
+      return false;
+    }
+  }
+
+  // Small arrays and SOA arrays use the policy too.
+  vtkNew<vtkFloatArray> small;
+  small->SetNumberOfValues(3);
+  vtkNew<vtkSOADataArrayTemplate<double>> soa;
+  soa->SetNumberOfComponents(3);
+  soa->SetNumberOfTuples(1000);
+  soa->FillValue(1.0);
+  soa->InsertNextTuple3(2.0, 3.0, 4.0);
+  return small->GetAllocationPolicy() == policy && soa->GetValue(3002) == 4.0;
+}
+}
+
+int TestBufferAllocationPolicy(int, char*[])
+{
+  int status = EXIT_SUCCESS;
+  for (int policy = vtkObjectBase::BUFFER_DEFAULT_ALLOCATION;
+       policy <= vtkObjectBase::BUFFER_HUGE_PAGES; ++policy)
+  {
+    if (!TestPolicy(policy))
+    {
+      status = EXIT_FAILURE;
+    }
+  }
+  vtkObjectBase::SetBufferAllocationPolicy(vtkObjectBase::BUFFER_DEFAULT_ALLOCATION);
+  return status;
+}
@@ -1,6 +1,8 @@
 #include "vtkDoubleArray.h"
 #include "vtkIntArray.h"
+#include "vtkMath.h"
 #include "vtkMathUtilities.h"
+#include "vtkObjectFactory.h"
 
 // Define this to run benchmarking tests on some vtkDataArray methods:
 #undef BENCHMARK
@@ -26,6 +28,27 @@ void benchmark();
 } // End TestDataArrayPrivate namespace
 #endif // BENCHMARK
 
+// A double array computing its component ranges its own way.
+class vtkUnitRangeArray : public vtkDoubleArray
+{
+public:
+  static vtkUnitRangeArray* New();
+  vtkTypeMacro(vtkUnitRangeArray, vtkDoubleArray);
+
+protected:
+  using vtkDoubleArray::ComputeScalarRange;
+  bool ComputeScalarRange(double* ranges) override
+  {
+    for (int i = 0; i < this->GetNumberOfComponents(); ++i)
+    {
+      ranges[2 * i] = -1.0;
+      ranges[2 * i + 1] = 1.0;
+    }
+    return true;
+  }
+};
+vtkStandardNewMacro(vtkUnitRangeArray);
+
 int TestDataArray(int, char*[])
 {
 #ifdef BENCHMARK
@@ -208,6 +231,70 @@ int TestDataArray(int, char*[])
   }
   cout << endl;
   farray->Delete();
+
+  // Cached ranges updated by ModifiedTuples():
+  farray = vtkDoubleArray::New();
+  farray->SetNumberOfComponents(2);
+  const vtkIdType numTuples = 100000;
+  farray->SetNumberOfTuples(numTuples);
+  for (vtkIdType id = 0; id < numTuples; ++id)
+  {
+    farray->SetTuple2(id, id, -id);
+  }
+  farray->GetRange(range, 0);
+  farray->GetFiniteRange(range, 1);
+  struct
+  {
+    const char* What;
+    vtkIdType Id;
+    double Value;
+    double Range[2];
+    double FiniteRange[2];
+  } updates[] = {
+    { "expanding", 5000, -10.0, { -10.0, numTuples - 1.0 }, { -(numTuples - 1.0), 0.0 } },
+    { "shrinking", 5000, 5000.0, { 0.0, numTuples - 1.0 }, { -(numTuples - 1.0), 5000.0 } },
+    { "appending", numTuples, 1e6, { 0.0, 1e6 }, { -(numTuples - 1.0), 1e6 } },
+    { "infinite", 0, vtkMath::Inf(), { 1.0, vtkMath::Inf() }, { -(numTuples - 1.0), 1e6 } },
+  };
+  for (const auto& update : updates)
+  {
+    farray->InsertTuple2(update.Id, update.Value, update.Value);
+    farray->ModifiedTuples(update.Id, update.Id + 1);
+    double finiteRange[2];
+    farray->GetRange(range, 0);
+    farray->GetFiniteRange(finiteRange, 1);
+    if (range[0] != update.Range[0] || range[1] != update.Range[1] ||
+      finiteRange[0] != update.FiniteRange[0] || finiteRange[1] != update.FiniteRange[1])
+    {
+      cerr << "Wrong ranges after " << update.What << " update: " << range[0] << "-" << range[1]
+           << " and " << finiteRange[0] << "-" << finiteRange[1] << std::endl;
+      farray->Delete();
+      return 1;
+    }
+  }
+  farray->Delete();
+
+  // Overridden range computations are not bypassed:
+  vtkUnitRangeArray* unitArray = vtkUnitRangeArray::New();
+  unitArray->SetNumberOfTuples(numTuples);
+  for (vtkIdType id = 0; id < numTuples; ++id)
+  {
+    unitArray->SetValue(id, id);
+  }
+  for (int modified = 0; modified < 2; ++modified)
+  {
+    unitArray->GetRange(range, 0);
+    if (range[0] != -1.0 || range[1] != 1.0)
+    {
+      cerr << "Overridden ComputeScalarRange() was bypassed: " << range[0] << "-" << range[1]
+           << std::endl;
+      unitArray->Delete();
+      return 1;
+    }
+    unitArray->SetValue(0, -10.0);
+    unitArray->ModifiedTuples(0, 1);
+  }
+  unitArray->Delete();
   return 0;
 }
 
@@ -0,0 +1,241 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMemoryArena.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCommand.h"
+#include "vtkIdList.h"
+#include "vtkMemoryArena.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+#include "vtkTestErrorObserver.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace
+{
+#define CHECK(condition)                                                                           \
+  do                                                                                               \
+  {                                                                                                \
+    if (!(condition))                                                                              \
+    {                                                                                              \
+      std::cerr << "Failed check line " << __LINE__ << ": " #condition << std::endl;               \
+      return false;                                                                                \
+    }                                                                                              \
+  } while (false)
+
+bool TestArena()
+{
+  vtkMemoryArena arena(4096);
+  CHECK(arena.GetCapacity() == 0);
+
+  // Allocations are aligned and do not overlap.
+  char* a = arena.Allocate<char>(3);
+  double* b = arena.Allocate<double>(10);
+  void* c = arena.Allocate(100, 64);
+  CHECK(reinterpret_cast<std::uintptr_t>(b) % alignof(double) == 0);
+  CHECK(reinterpret_cast<std::uintptr_t>(c) % 64 == 0);
+  CHECK(a + 3 <= reinterpret_cast<char*>(b));
+  CHECK(reinterpret_cast<char*>(b + 10) <= static_cast<char*>(c));
+  CHECK(arena.GetCapacity() == 4096);
+
+  // Rewinding to a mark reuses the memory allocated after it.
+  vtkMemoryArena::Mark mark = arena.GetMark();
+  const vtkTypeUInt64 generation = arena.GetGeneration();
+  void* d = arena.Allocate(1000);
+  arena.Rewind(mark);
+  CHECK(arena.GetGeneration() == generation + 1);
+  CHECK(arena.Allocate(1000) == d);
+
+  // Large allocations get their own chunk, kept after a rewind.
+  mark = arena.GetMark();
+  vtkIdType* large = arena.Allocate<vtkIdType>(100000);
+  CHECK(large != nullptr);
+  large[99999] = 1;
+  const size_t capacity = arena.GetCapacity();
+  CHECK(capacity > 100000 * sizeof(vtkIdType));
+  arena.Rewind(mark);
+  arena.Allocate<vtkIdType>(100000);
+  CHECK(arena.GetCapacity() == capacity);
+
+  // Squeeze frees the chunks that are not used.
+  arena.Rewind();
+  arena.Squeeze();
+  CHECK(arena.GetCapacity() == 0);
+  CHECK(arena.Allocate(10) != nullptr);
+
+  // Scopes rewind the arena when they end.
+  mark = arena.GetMark();
+  {
+    vtkMemoryArena::Scope scope(&arena);
+    arena.Allocate(2000);
+  }
+  CHECK(arena.GetMark().Chunk == mark.Chunk && arena.GetMark().Offset == mark.Offset);
+
+  // Only rewinds below a mark release the memory allocated before it.
+  arena.Allocate(100);
+  const vtkMemoryArena::Mark end = arena.GetMark();
+  const vtkTypeUInt64 endGeneration = arena.GetGeneration();
+  CHECK(!arena.WasRewoundBelow(end, endGeneration));
+  {
+    vtkMemoryArena::Scope outer(&arena);
+    arena.Allocate(100);
+    {
+      vtkMemoryArena::Scope inner(&arena);
+      arena.Allocate(100);
+    }
+  }
+  CHECK(arena.GetGeneration() == endGeneration + 2);
+  CHECK(!arena.WasRewoundBelow(end, endGeneration));
+  arena.Rewind(mark);
+  CHECK(arena.WasRewoundBelow(end, endGeneration));
+  CHECK(!arena.WasRewoundBelow(end, arena.GetGeneration()));
+  return true;
+}
+
+bool TestIdList()
+{
+  vtkMemoryArena arena;
+  vtkNew<vtkIdList> ids;
+  ids->InsertNextId(7);
+  ids->InsertNextId(8);
+
+  // Setting an arena moves the ids.
+  ids->SetArena(&arena);
+  CHECK(ids->GetArena() == &arena);
+  CHECK(ids->GetNumberOfIds() == 2 && ids->GetId(0) == 7 && ids->GetId(1) == 8);
+  CHECK(arena.GetCapacity() > 0);
+
+  // Growing the list allocates from the arena.
+  vtkMemoryArena::Mark mark = arena.GetMark();
+  for (vtkIdType i = 0; i < 1000; ++i)
+  {
+    ids->InsertNextId(i);
+  }
+  CHECK(ids->GetNumberOfIds() == 1002 && ids->GetId(1001) == 999);
+  CHECK(arena.GetMark().Offset != mark.Offset || arena.GetMark().Chunk != mark.Chunk);
+
+  // After a rewind, the list forgets its ids and allocates them again.
+  arena.Rewind();
+  ids->Reset();
+  CHECK(ids->GetNumberOfIds() == 0);
+  ids->SetNumberOfIds(3);
+  ids->SetId(2, 5);
+  CHECK(ids->GetId(2) == 5);
+
+  // Released ids are copied out of the arena.
+  vtkIdType* released = ids->Release();
+  CHECK(released[2] == 5);
+  delete[] released;
+
+  // Back to the heap.
+  ids->InsertNextId(4);
+  ids->SetArena(nullptr);
+  arena.Rewind();
+  ids->Reset();
+  ids->InsertNextId(6);
+  CHECK(ids->GetNumberOfIds() == 1 && ids->GetId(0) == 6);
+  return true;
+}
+
+bool TestNestedScopes()
+{
+  vtkMemoryArena arena;
+  vtkMemoryArena::Scope outer(&arena);
+  vtkNew<vtkIdList> ids;
+  ids->SetArena(&arena);
+  for (vtkIdType i = 0; i < 10; ++i)
+  {
+    ids->InsertNextId(i);
+  }
+
+  // A nested scope does not release the ids allocated before it.
+  {
+    vtkMemoryArena::Scope inner(&arena);
+    vtkNew<vtkIdList> temporary;
+    temporary->SetArena(&arena);
+    temporary->SetNumberOfIds(100);
+  }
+  for (vtkIdType i = 10; i < 1000; ++i)
+  {
+    ids->InsertNextId(i);
+  }
+  CHECK(ids->GetNumberOfIds() == 1000);
+  for (vtkIdType i = 0; i < 1000; ++i)
+  {
+    CHECK(ids->GetId(i) == i);
+  }
+
+  // Ids grown inside a nested scope are released by it, growing them is an
+  // error rather than silently dropping them.
+  vtkNew<vtkIdList> grown;
+  grown->SetArena(&arena);
+  grown->InsertNextId(1);
+  {
+    vtkMemoryArena::Scope inner(&arena);
+    for (vtkIdType i = 0; i < 100; ++i)
+    {
+      grown->InsertNextId(i);
+    }
+  }
+  vtkNew<vtkTest::ErrorObserver> observer;
+  grown->AddObserver(vtkCommand::ErrorEvent, observer);
+  CHECK(grown->Resize(1000) == nullptr);
+  CHECK(observer->CheckErrorMessage("Cannot resize ids released by a rewind of the arena") == 0);
+
+  // Refilling them is fine.
+  grown->Reset();
+  grown->InsertNextId(2);
+  CHECK(grown->GetNumberOfIds() == 1 && grown->GetId(0) == 2);
+  return true;
+}
+
+bool TestThreadLocal()
+{
+  std::atomic<vtkIdType> sum(0);
+  vtkSMPTools::For(0, 10000, [&](vtkIdType begin, vtkIdType end) {
+    vtkMemoryArena::Scope scope;
+    vtkNew<vtkIdList> ids;
+    ids->SetArena(scope.GetArena());
+    vtkIdType local = 0;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      ids->Reset();
+      for (vtkIdType j = 0; j < i % 17; ++j)
+      {
+        ids->InsertNextId(j);
+      }
+      for (vtkIdType id : *ids)
+      {
+        local += id;
+      }
+    }
+    sum += local;
+  });
+  vtkIdType expected = 0;
+  for (vtkIdType i = 0; i < 10000; ++i)
+  {
+    const vtkIdType n = i % 17;
+    expected += n * (n - 1) / 2;
+  }
+  CHECK(sum == expected);
+  return true;
+}
+#undef CHECK
+}
+
+int TestMemoryArena(int, char*[])
+{
+  return TestArena() && TestIdList() && TestNestedScopes() && TestThreadLocal() ? EXIT_SUCCESS
+                                                                                : EXIT_FAILURE;
+}
@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMemoryMappedArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDoubleArray.h"
+#include "vtkMemoryMappedFile.h"
+#include "vtkNew.h"
+
+#include "vtksys/FStream.hxx"
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+// Values are stored after a header so that they do not start on a page.
+const int HeaderSize = 16;
+const vtkIdType NumberOfValues = 3000;
+
+double ExpectedValue(vtkIdType i)
+{
+  return 0.5 * i - 7.0;
+}
+
+bool CheckValues(vtkDoubleArray* array, vtkIdType numberOfValues, const char* what)
+{
+  if (array->GetNumberOfValues() != numberOfValues)
+  {
+    std::cerr << what << ": expected " << numberOfValues << " values, got "
+              << array->GetNumberOfValues() << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < numberOfValues; ++i)
+  {
+    if (array->GetValue(i) != ExpectedValue(i))
+    {
+      std::cerr << what << ": wrong value " << array->GetValue(i) << " at " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestMemoryMappedArray(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cout << "Usage: " << argv[0] << " outputFilename" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!vtkMemoryMappedFile::IsSupported())
+  {
+    std::cout << "File mapping is not supported on this platform." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  const char* fileName = argv[1];
+
+  {
+    std::vector<double> values(NumberOfValues);
+    for (vtkIdType i = 0; i < NumberOfValues; ++i)
+    {
+      values[i] = ExpectedValue(i);
+    }
+    vtksys::ofstream out(fileName, std::ios::out | std::ios::binary);
+    std::vector<char> header(HeaderSize, 'h');
+    out.write(header.data(), HeaderSize);
+    out.write(reinterpret_cast<const char*>(values.data()), NumberOfValues * sizeof(double));
+  }
+
+  int status = EXIT_SUCCESS;
+
+  // Read-only mapping of all the values.
+  vtkNew<vtkDoubleArray> readOnly;
+  readOnly->SetNumberOfComponents(3);
+  if (!readOnly->MapFile(fileName, HeaderSize, NumberOfValues, vtkMemoryMappedFile::READ_ONLY) ||
+    !readOnly->IsMapped())
+  {
+    std::cerr << "Cannot map " << fileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!CheckValues(readOnly, NumberOfValues, "read-only") ||
+    readOnly->GetNumberOfTuples() != NumberOfValues / 3)
+  {
+    status = EXIT_FAILURE;
+  }
+  double range[2];
+  readOnly->GetRange(range, 0);
+  if (range[0] != ExpectedValue(0) || range[1] != ExpectedValue(NumberOfValues - 3))
+  {
+    std::cerr << "Wrong range [" << range[0] << ", " << range[1] << "]" << std::endl;
+    status = EXIT_FAILURE;
+  }
+
+  // Copy-on-write mapping of a part of the values: changes stay private.
+  vtkNew<vtkDoubleArray> copyOnWrite;
+  if (!copyOnWrite->MapFile(
+        fileName, HeaderSize, NumberOfValues - 1, vtkMemoryMappedFile::COPY_ON_WRITE))
+  {
+    std::cerr << "Cannot map " << fileName << " copy-on-write" << std::endl;
+    return EXIT_FAILURE;
+  }
+  copyOnWrite->SetValue(10, -1.0);
+  if (copyOnWrite->GetValue(10) != -1.0 || readOnly->GetValue(10) != ExpectedValue(10))
+  {
+    std::cerr << "Copy-on-write mapping changed the file" << std::endl;
+    status = EXIT_FAILURE;
+  }
+
+  // Growing a mapped array copies its values to allocated memory.
+  copyOnWrite->InsertNextValue(ExpectedValue(NumberOfValues - 1));
+  copyOnWrite->SetValue(10, ExpectedValue(10));
+  if (copyOnWrite->IsMapped() || !CheckValues(copyOnWrite, NumberOfValues, "resized"))
+  {
+    status = EXIT_FAILURE;
+  }
+
+  // Mapping past the end of the file fails and leaves the array untouched.
+  if (readOnly->MapFile(fileName, HeaderSize, NumberOfValues + 1, vtkMemoryMappedFile::READ_ONLY) ||
+    !CheckValues(readOnly, NumberOfValues, "failed mapping"))
+  {
+    std::cerr << "Mapping past the end of the file should fail" << std::endl;
+    status = EXIT_FAILURE;
+  }
+
+  // Values not aligned in the file are not mapped.
+  if (readOnly->MapFile(fileName, HeaderSize + 4, 10, vtkMemoryMappedFile::READ_ONLY) ||
+    !CheckValues(readOnly, NumberOfValues, "misaligned mapping"))
+  {
+    std::cerr << "Mapping misaligned values should fail" << std::endl;
+    status = EXIT_FAILURE;
+  }
+
+  // The mapping survives the removal of the file.
+  std::remove(fileName);
+  if (!CheckValues(readOnly, NumberOfValues, "removed file"))
+  {
+    status = EXIT_FAILURE;
+  }
+  readOnly->Initialize();
+  if (readOnly->IsMapped())
+  {
+    std::cerr << "Initialize should release the mapping" << std::endl;
+    status = EXIT_FAILURE;
+  }
+
+  return status;
+}
@@ -13,17 +13,30 @@
 
 =========================================================================*/
 #include "vtkDataArrayRange.h"
+#include "vtkFloatArray.h"
 #include "vtkNew.h"
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMP.h"
+#include "vtkSMPTaskGraph.h"
 #include "vtkSMPThreadLocal.h"
 #include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
+#include "vtksys/SystemTools.hxx"
+#if VTK_SMP_ENABLE_STDTHREAD
+#include "SMP/STDThread/vtkSMPThreadPool.h"
+#endif
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdlib>
 #include <deque>
 #include <functional>
 #include <numeric>
 #include <set>
+#include <sstream>
+#include <string>
+#include <utility>
 #include <vector>
 
 static const int Target = 10000;
@@ -491,6 +504,318 @@ int doTestSMP()
       return EXIT_FAILURE;
     }
   }
+
+  // Test scans on inputs large enough to be split between threads
+  const vtkIdType scanSize = 100003;
+  std::vector<vtkIdType> scanInput(scanSize);
+  std::vector<unsigned char> scanFlags(scanSize);
+  for (vtkIdType i = 0; i < scanSize; ++i)
+  {
+    scanInput[i] = i % 7;
+    scanFlags[i] = (i % 1000 == 17) ? 1 : 0;
+  }
+  std::vector<vtkIdType> scanExpected(scanSize);
+  std::vector<vtkIdType> scanOutput(scanSize);
+
+  vtkIdType scanTotal = 5;
+  for (vtkIdType i = 0; i < scanSize; ++i)
+  {
+    scanExpected[i] = scanTotal;
+    scanTotal += scanInput[i];
+  }
+  if (vtkSMPTools::ExclusiveScan(scanInput.begin(), scanInput.end(), scanOutput.begin(),
+        vtkIdType(5)) != scanTotal ||
+    scanOutput != scanExpected)
+  {
+    cerr << "Error: Invalid output for vtkSMPTools::ExclusiveScan!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  std::partial_sum(scanInput.begin(), scanInput.end(), scanExpected.begin());
+  scanOutput = scanInput;
+  if (vtkSMPTools::InclusiveScan(scanOutput.begin(), scanOutput.end(), scanOutput.begin()) !=
+      scanExpected.back() ||
+    scanOutput != scanExpected)
+  {
+    cerr << "Error: Invalid output for in place vtkSMPTools::InclusiveScan!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  scanTotal = 0;
+  for (vtkIdType i = 0; i < scanSize; ++i)
+  {
+    scanExpected[i] = scanInput[i] > 3 ? scanTotal++ : scanTotal;
+  }
+  if (vtkSMPTools::TransformExclusiveScan(scanInput.begin(), scanInput.end(), scanOutput.begin(),
+        vtkIdType(0), std::plus<vtkIdType>(),
+        [](vtkIdType value) -> vtkIdType { return value > 3 ? 1 : 0; }) != scanTotal ||
+    scanOutput != scanExpected)
+  {
+    cerr << "Error: Invalid output for vtkSMPTools::TransformExclusiveScan!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  for (const bool inclusive : { false, true })
+  {
+    scanTotal = 0;
+    for (vtkIdType i = 0; i < scanSize; ++i)
+    {
+      scanTotal = scanFlags[i] ? 0 : scanTotal;
+      scanExpected[i] = inclusive ? scanTotal + scanInput[i] : scanTotal;
+      scanTotal += scanInput[i];
+    }
+    const vtkIdType segmentTotal = inclusive
+      ? vtkSMPTools::SegmentedInclusiveScan(
+          scanInput.begin(), scanInput.end(), scanFlags.begin(), scanOutput.begin())
+      : vtkSMPTools::SegmentedExclusiveScan(scanInput.begin(), scanInput.end(), scanFlags.begin(),
+          scanOutput.begin(), vtkIdType(0));
+    if (segmentTotal != scanTotal || scanOutput != scanExpected)
+    {
+      cerr << "Error: Invalid output for vtkSMPTools segmented scan (inclusive: " << inclusive
+           << ")!" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Test reductions
+  if (vtkSMPTools::Reduce(scanInput.begin(), scanInput.end(), vtkIdType(3)) !=
+    std::accumulate(scanInput.begin(), scanInput.end(), vtkIdType(3)))
+  {
+    cerr << "Error: Invalid output for vtkSMPTools::Reduce!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  using MinMax = std::array<vtkIdType, 2>;
+  const MinMax minMax = vtkSMPTools::Reduce(0, scanSize, MinMax{ VTK_ID_MAX, VTK_ID_MIN },
+    [&](vtkIdType begin, vtkIdType end, MinMax& range) {
+      for (; begin < end; ++begin)
+      {
+        range[0] = std::min(range[0], scanInput[begin] - begin);
+        range[1] = std::max(range[1], scanInput[begin] - begin);
+      }
+    },
+    [](const MinMax& range0, const MinMax& range1) {
+      return MinMax{ std::min(range0[0], range1[0]), std::max(range0[1], range1[1]) };
+    });
+  if (minMax[0] != scanInput[scanSize - 1] - (scanSize - 1) || minMax[1] != 0)
+  {
+    cerr << "Error: Invalid output for vtkSMPTools::Reduce with a combiner!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Floating point sums must not depend on the number of threads
+  auto harmonicSum = [&]() {
+    return vtkSMPTools::TransformReduce(scanInput.begin(), scanInput.end(), 0.0,
+      std::plus<double>(), [](vtkIdType value) { return 1.0 / (value + 0.1); });
+  };
+  double harmonicSums[2];
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 1 }, [&]() { harmonicSums[0] = harmonicSum(); });
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 3 }, [&]() { harmonicSums[1] = harmonicSum(); });
+  if (harmonicSums[0] != harmonicSums[1] || harmonicSums[0] != harmonicSum())
+  {
+    cerr << "Error: vtkSMPTools::TransformReduce is not deterministic!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Test first touch allocation of data arrays
+  vtkObjectBase::SetFirstTouchAllocation(true);
+  vtkNew<vtkFloatArray> touchedArray;
+  touchedArray->SetNumberOfValues(1 << 20);
+  vtkObjectBase::SetFirstTouchAllocation(false);
+  auto touchedRange = vtk::DataArrayValueRange<1>(touchedArray);
+  vtkSMPTools::Fill(touchedRange.begin(), touchedRange.end(), 3.f);
+  if (std::count(touchedRange.begin(), touchedRange.end(), 3.f) != touchedRange.size())
+  {
+    cerr << "Error: Invalid array content with first touch allocation!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Growing an array touches its new values only
+  vtkObjectBase::SetFirstTouchAllocation(true);
+  vtkNew<vtkFloatArray> grownArray;
+  grownArray->SetNumberOfValues(1 << 10);
+  auto grownRange = vtk::DataArrayValueRange<1>(grownArray);
+  std::iota(grownRange.begin(), grownRange.end(), 0.f);
+  grownArray->Resize(1 << 21);
+  vtkObjectBase::SetFirstTouchAllocation(false);
+  for (vtkIdType i = 0; i < (1 << 10); ++i)
+  {
+    if (grownArray->GetValue(i) != static_cast<float>(i))
+    {
+      cerr << "Error: Invalid grown array content with first touch allocation!" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+#if VTK_SMP_ENABLE_STDTHREAD
+  // Test the thread affinity policies of the STDThread backend
+  if (std::string(vtkSMPTools::GetBackend()) == "STDThread")
+  {
+    using vtk::detail::smp::vtkSMPThreadPool;
+    const std::pair<const char*, vtkSMPThreadPool::Affinity> affinities[] = {
+      { "compact", vtkSMPThreadPool::Affinity::Compact },
+      { "scatter", vtkSMPThreadPool::Affinity::Scatter },
+      { "numa", vtkSMPThreadPool::Affinity::NUMANode },
+      { "none", vtkSMPThreadPool::Affinity::None },
+    };
+    std::ostringstream affinityWarnings;
+    std::streambuf* cerrBuffer = std::cerr.rdbuf(affinityWarnings.rdbuf());
+    bool affinityValid = true;
+    for (const auto& affinity : affinities)
+    {
+      vtksys::SystemTools::PutEnv(std::string("VTK_SMP_THREAD_AFFINITY=") + affinity.first);
+      vtkSMPTools::Initialize();
+      ARangeFunctor pinnedFunctor;
+      vtkSMPTools::For(0, Target, pinnedFunctor);
+      affinityValid &= vtkSMPThreadPool::GetAffinity() == affinity.second;
+      int pinnedTotal = 0;
+      for (int count : pinnedFunctor.Counter)
+      {
+        pinnedTotal += count;
+      }
+      affinityValid &= pinnedTotal == Target;
+    }
+    const bool validAffinitiesWarned = !affinityWarnings.str().empty();
+
+    // An unknown value warns and leaves the threads unpinned
+    vtksys::SystemTools::PutEnv("VTK_SMP_THREAD_AFFINITY=compact");
+    vtkSMPTools::Initialize();
+    vtksys::SystemTools::PutEnv("VTK_SMP_THREAD_AFFINITY=diagonal");
+    vtkSMPTools::Initialize();
+    std::cerr.rdbuf(cerrBuffer);
+    vtksys::SystemTools::UnPutEnv("VTK_SMP_THREAD_AFFINITY");
+    vtkSMPTools::Initialize();
+
+    if (!affinityValid || validAffinitiesWarned)
+    {
+      cerr << "Error: Invalid thread affinity policy!" << endl;
+      return EXIT_FAILURE;
+    }
+    if (affinityWarnings.str().find("VTK_SMP_THREAD_AFFINITY value \"diagonal\"") ==
+        std::string::npos ||
+      vtkSMPThreadPool::GetAffinity() != vtkSMPThreadPool::Affinity::None)
+    {
+      cerr << "Error: Unknown thread affinity policy did not warn!" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+#endif
+
+  // Test parallel sorts against the standard library
+  const vtkIdType sortSize = 100000;
+  using SortPair = std::pair<int, vtkIdType>;
+  std::vector<SortPair> sortPairs(sortSize);
+  std::vector<int> sortInts(sortSize);
+  std::vector<float> sortFloats(sortSize);
+  for (vtkIdType i = 0; i < sortSize; ++i)
+  {
+    const int value = static_cast<int>((i * 7919) % 10007) - 5000;
+    sortPairs[i] = SortPair(value % 100, i);
+    sortInts[i] = value * 1000;
+    sortFloats[i] = value * 0.25f;
+  }
+  auto firstLess = [](const SortPair& a, const SortPair& b) { return a.first < b.first; };
+  std::vector<SortPair> expectedPairs = sortPairs;
+  std::stable_sort(expectedPairs.begin(), expectedPairs.end(), firstLess);
+
+  std::vector<SortPair> stablePairs = sortPairs;
+  vtkSMPTools::StableSort(stablePairs.begin(), stablePairs.end(), firstLess);
+  if (stablePairs != expectedPairs)
+  {
+    cerr << "Error: Invalid output for vtkSMPTools::StableSort!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<int> sortedInts = sortInts;
+  vtkSMPTools::Sort(sortedInts.begin(), sortedInts.end(), std::greater<int>());
+  std::vector<int> expectedInts = sortInts;
+  std::sort(expectedInts.begin(), expectedInts.end(), std::greater<int>());
+  if (sortedInts != expectedInts)
+  {
+    cerr << "Error: Invalid output for vtkSMPTools::Sort!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  sortedInts = sortInts;
+  vtkSMPTools::RadixSort(sortedInts.data(), sortedInts.data() + sortSize);
+  std::reverse(expectedInts.begin(), expectedInts.end());
+  if (sortedInts != expectedInts)
+  {
+    cerr << "Error: Invalid output for vtkSMPTools::RadixSort on integers!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Key/value radix sort must be stable
+  std::vector<float> sortedFloats = sortFloats;
+  std::vector<vtkIdType> sortIds(sortSize);
+  std::iota(sortIds.begin(), sortIds.end(), 0);
+  vtkSMPTools::RadixSort(sortedFloats.data(), sortedFloats.data() + sortSize, sortIds.data());
+  for (vtkIdType i = 0; i < sortSize; ++i)
+  {
+    if (sortedFloats[i] != sortFloats[sortIds[i]] ||
+      (i > 0 && sortedFloats[i] < sortedFloats[i - 1]))
+    {
+      cerr << "Error: Invalid output for vtkSMPTools::RadixSort on floats!" << endl;
+      return EXIT_FAILURE;
+    }
+    if (i > 0 && sortedFloats[i] == sortedFloats[i - 1] && sortIds[i] < sortIds[i - 1])
+    {
+      cerr << "Error: vtkSMPTools::RadixSort is not stable!" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Test task graph: count -> prefix sum -> fill, with an independent task
+  const vtkIdType graphSize = 1000;
+  std::vector<vtkIdType> graphCounts(graphSize);
+  std::vector<vtkIdType> graphOffsets(graphSize + 1);
+  std::vector<vtkIdType> graphOutput;
+  std::atomic<int> graphIndependent(0);
+  vtkSMPTaskGraph graph;
+  auto countTask = graph.SpawnFor(0, graphSize, 10, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      graphCounts[i] = i % 3;
+    }
+  });
+  auto offsetTask = graph.Then(countTask, [&]() {
+    graphOffsets[0] = 0;
+    for (vtkIdType i = 0; i < graphSize; ++i)
+    {
+      graphOffsets[i + 1] = graphOffsets[i] + graphCounts[i];
+    }
+    graphOutput.resize(graphOffsets[graphSize]);
+  });
+  auto independentTask = graph.Spawn([&]() { graphIndependent++; });
+  auto fillTask = graph.SpawnFor(0, graphSize, 0,
+    [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        std::fill(graphOutput.begin() + graphOffsets[i], graphOutput.begin() + graphOffsets[i + 1],
+          i + graphIndependent);
+      }
+    },
+    { offsetTask, independentTask });
+  graph.Then(fillTask, [&]() { graphIndependent++; });
+  graph.Wait();
+
+  if (graph.GetNumberOfTasks() != 0 || graphIndependent != 2 ||
+    graphOutput.size() != static_cast<std::size_t>(graphOffsets[graphSize]))
+  {
+    cerr << "Error: vtkSMPTaskGraph did not execute every task!" << endl;
+    return EXIT_FAILURE;
+  }
+  for (vtkIdType i = 0; i < graphSize; ++i)
+  {
+    for (vtkIdType j = graphOffsets[i]; j < graphOffsets[i + 1]; ++j)
+    {
+      if (graphOutput[j] != i + 1)
+      {
+        cerr << "Error: vtkSMPTaskGraph did not respect task dependencies!" << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
   return EXIT_SUCCESS;
 }
 
@@ -40,6 +40,10 @@
 // The export macro below makes no sense, but is necessary for older compilers
 // when we export instantiations of this class from vtkCommonCore.
 VTK_ABI_NAMESPACE_BEGIN
+class vtkConcurrentIdAllocator;
+template <typename ValueT>
+class vtkConcurrentAppendStorage;
+
 template <class ValueTypeT>
 class VTKCOMMONCORE_EXPORT vtkAOSDataArrayTemplate
   : public vtkGenericDataArray<vtkAOSDataArrayTemplate<ValueTypeT>, ValueTypeT>
@@ -191,6 +195,78 @@ public:
    **/
   void SetArrayFreeFunction(void (*callback)(void*)) override;
 
+  /**
+   * Use numberOfValues values stored in the file fileName starting at byte
+   * offset as the array data, mapped in memory instead of being read: pages
+   * of the file are only loaded when accessed. mode is one of
+   * vtkMemoryMappedFile::MappingMode, READ_ONLY mappings must not be written
+   * to while COPY_ON_WRITE mappings can be modified without altering the file.
+   * The values must be stored with the native byte order. Resizing the array
+   * copies the data to regular memory. The mapped values are released by
+   * unmapping them: a free function set with SetArrayFreeFunction() is
+   * reset and never called on them. Returns false, leaving the array
+   * unchanged, when the file region cannot be mapped or when offset is not
+   * a multiple of the alignment of T.
+   */
+  bool MapFile(const char* fileName, vtkTypeInt64 offset, vtkIdType numberOfValues, int mode);
+
+  /**
+   * Return true if the array data is a file region mapped with MapFile().
+   */
+  bool IsMapped() const { return this->Buffer->IsMapped(); }
+
+  ///@{
+  /**
+   * Set/Get the policy used to allocate the array memory, one of
+   * vtkObjectBase::BufferAllocationPolicies. It defaults to
+   * vtkObjectBase::GetBufferAllocationPolicy() when the array is created.
+   * Changing it moves the current values to memory allocated with the new
+   * policy. Returns false when the policy cannot be used, see
+   * vtkBuffer::SetAllocationPolicy().
+   */
+  bool SetAllocationPolicy(int policy) { return this->Buffer->SetAllocationPolicy(policy); }
+  int GetAllocationPolicy() const { return this->Buffer->GetAllocationPolicy(); }
+  ///@}
+
+  /**
+   * Start the concurrent append mode, in which ConcurrentInsertNextTuple()
+   * and ConcurrentSetTuple() may be called from many threads at once, for
+   * instance from a vtkSMPTools::For() functor. The appended tuples are
+   * numbered with the provisional ids of `ids`, which must be initialized by
+   * the caller; when nullptr, the array uses its own allocator starting at its
+   * number of tuples. The array must not be otherwise modified nor read until
+   * EndConcurrentAppend().
+   */
+  void BeginConcurrentAppend(vtkConcurrentIdAllocator* ids = nullptr);
+
+  /**
+   * Append a tuple in concurrent append mode and return its provisional id.
+   * Thread safe and lock free.
+   */
+  vtkIdType ConcurrentInsertNextTuple(const ValueType* tuple);
+
+  /**
+   * Set the tuple of provisional id `id` in concurrent append mode, for an
+   * array sharing the allocator of another container, such as the cell data
+   * of a vtkCellArray appended concurrently. `id` must have been handed out to
+   * the calling thread, the ids may be set in any order. The tuples of the ids
+   * which are not set are zero. Thread safe and lock free.
+   */
+  void ConcurrentSetTuple(vtkIdType id, const ValueType* tuple);
+
+  /**
+   * Leave the concurrent append mode: finalize the allocator and move the
+   * appended tuples to their final ids, given by
+   * vtkConcurrentIdAllocator::GetFinalId(). Must be called once all the
+   * threads are done.
+   */
+  void EndConcurrentAppend();
+
+  /**
+   * Return the allocator of the current or last concurrent append, or nullptr.
+   */
+  vtkConcurrentIdAllocator* GetConcurrentAppendIds() const;
+
   // Overridden for optimized implementations:
   void SetTuple(vtkIdType tupleIdx, const float* tuple) override;
   void SetTuple(vtkIdType tupleIdx, const double* tuple) override;
@@ -288,6 +364,8 @@ protected:
   bool ReallocateTuples(vtkIdType numTuples);
 
   vtkBuffer<ValueType>* Buffer;
+  vtkConcurrentAppendStorage<ValueType>* ConcurrentAppend;
+  vtkConcurrentIdAllocator* ConcurrentAppendIds;
 
 private:
   vtkAOSDataArrayTemplate(const vtkAOSDataArrayTemplate&) = delete;
@@ -320,7 +398,11 @@ VTK_ABI_NAMESPACE_END
   T* WritePointer(vtkIdType id, vtkIdType number);                                                 \
   T* GetPointer(vtkIdType id);                                                                     \
   void SetArray(VTK_ZEROCOPY T* array, vtkIdType size, int save);                                  \
-  void SetArray(VTK_ZEROCOPY T* array, vtkIdType size, int save, int deleteMethod)
+  void SetArray(VTK_ZEROCOPY T* array, vtkIdType size, int save, int deleteMethod);                \
+  bool MapFile(const char* fileName, vtkTypeInt64 offset, vtkIdType numberOfValues, int mode);     \
+  bool IsMapped() const;                                                                           \
+  bool SetAllocationPolicy(int policy);                                                            \
+  int GetAllocationPolicy() const
 
 #endif // header guard
 
@@ -334,6 +416,7 @@ VTK_ABI_NAMESPACE_END
   {                                                                                                \
   VTK_ABI_NAMESPACE_BEGIN                                                                          \
   VTK_INSTANTIATE_VALUERANGE_ARRAYTYPE(vtkAOSDataArrayTemplate<T>, double);                        \
+  VTK_INSTANTIATE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkAOSDataArrayTemplate<T>);                         \
   VTK_ABI_NAMESPACE_END                                                                            \
   }                                                                                                \
   VTK_ABI_NAMESPACE_BEGIN                                                                          \
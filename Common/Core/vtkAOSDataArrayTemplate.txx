@@ -24,6 +24,10 @@
 #include "vtkAOSDataArrayTemplate.h"
 
 #include "vtkArrayIteratorTemplate.h"
+#include "vtkConcurrentAppendStorage.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 VTK_ABI_NAMESPACE_BEGIN
@@ -58,6 +62,8 @@ template <class ValueTypeT>
 vtkAOSDataArrayTemplate<ValueTypeT>::vtkAOSDataArrayTemplate()
 {
   this->Buffer = vtkBuffer<ValueType>::New();
+  this->ConcurrentAppend = nullptr;
+  this->ConcurrentAppendIds = nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -65,6 +71,11 @@ template <class ValueTypeT>
 vtkAOSDataArrayTemplate<ValueTypeT>::~vtkAOSDataArrayTemplate()
 {
   this->Buffer->Delete();
+  delete this->ConcurrentAppend;
+  if (this->ConcurrentAppendIds)
+  {
+    this->ConcurrentAppendIds->UnRegister(this);
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -126,6 +137,127 @@ void vtkAOSDataArrayTemplate<ValueType>::SetArrayFreeFunction(void (*callback)(v
   this->Buffer->SetFreeFunction(false, callback);
 }
 
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+bool vtkAOSDataArrayTemplate<ValueTypeT>::MapFile(
+  const char* fileName, vtkTypeInt64 offset, vtkIdType numberOfValues, int mode)
+{
+  if (numberOfValues < 0 || !this->Buffer->MapFile(fileName, offset, numberOfValues, mode))
+  {
+    return false;
+  }
+  this->Size = numberOfValues;
+  this->MaxId = this->Size - 1;
+  this->DataChanged();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+void vtkAOSDataArrayTemplate<ValueTypeT>::BeginConcurrentAppend(vtkConcurrentIdAllocator* ids)
+{
+  if (this->ConcurrentAppendIds)
+  {
+    this->ConcurrentAppendIds->UnRegister(this);
+  }
+  if (ids)
+  {
+    ids->Register(this);
+  }
+  else
+  {
+    ids = vtkConcurrentIdAllocator::New();
+    ids->Initialize(this->GetNumberOfTuples());
+  }
+  this->ConcurrentAppendIds = ids;
+  delete this->ConcurrentAppend;
+  this->ConcurrentAppend = new vtkConcurrentAppendStorage<ValueType>(ids);
+}
+
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+vtkIdType vtkAOSDataArrayTemplate<ValueTypeT>::ConcurrentInsertNextTuple(const ValueType* tuple)
+{
+  const vtkIdType id = this->ConcurrentAppendIds->NewId();
+  this->ConcurrentSetTuple(id, tuple);
+  return id;
+}
+
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+void vtkAOSDataArrayTemplate<ValueTypeT>::ConcurrentSetTuple(vtkIdType id, const ValueType* tuple)
+{
+  using Chunk = typename vtkConcurrentAppendStorage<ValueType>::Chunk;
+  Chunk& chunk = this->ConcurrentAppend->GetChunk(id);
+  const size_t numComps = static_cast<size_t>(this->NumberOfComponents);
+  const size_t begin =
+    static_cast<size_t>(this->ConcurrentAppendIds->GetChunkOffset(id)) * numComps;
+  if (chunk.Values.size() < begin + numComps)
+  {
+    if (chunk.Values.empty())
+    {
+      chunk.Values.reserve(this->ConcurrentAppendIds->GetChunkSize() * numComps);
+    }
+    chunk.Values.resize(begin + numComps);
+  }
+  std::copy(tuple, tuple + numComps, chunk.Values.begin() + begin);
+}
+
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+void vtkAOSDataArrayTemplate<ValueTypeT>::EndConcurrentAppend()
+{
+  if (!this->ConcurrentAppend)
+  {
+    return;
+  }
+  using Chunk = typename vtkConcurrentAppendStorage<ValueType>::Chunk;
+  vtkConcurrentIdAllocator* ids = this->ConcurrentAppendIds;
+  ids->Finalize();
+  // SetNumberOfTuples() alone would drop the existing tuples when growing,
+  // and Resize() would leave extra capacity when growing.
+  const vtkIdType numTuples = ids->GetNumberOfIds();
+  if (!this->ReallocateTuples(numTuples))
+  {
+    vtkErrorMacro("Unable to allocate " << numTuples * this->NumberOfComponents
+                                        << " elements of size " << sizeof(ValueType) << " bytes.");
+    return;
+  }
+  this->SetNumberOfTuples(numTuples);
+
+  // Each chunk is copied to its final place at once. The tuples of the ids
+  // which were not set, taken by other containers sharing the allocator, are
+  // zero.
+  std::vector<Chunk*> chunks = this->ConcurrentAppend->GetChunks();
+  const vtkIdType numComps = this->NumberOfComponents;
+  ValueType* data = this->Buffer->GetBuffer();
+  vtkSMPTools::For(0, static_cast<vtkIdType>(chunks.size()), [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      ValueType* first = data + ids->GetChunkFinalId(i) * numComps;
+      ValueType* last = first + ids->GetChunkNumberOfIds(i) * numComps;
+      if (const Chunk* chunk = chunks[i])
+      {
+        const vtkIdType numValues =
+          std::min<vtkIdType>(static_cast<vtkIdType>(chunk->Values.size()), last - first);
+        first = std::copy(chunk->Values.begin(), chunk->Values.begin() + numValues, first);
+      }
+      std::fill(first, last, ValueType());
+    }
+  });
+
+  delete this->ConcurrentAppend;
+  this->ConcurrentAppend = nullptr;
+  this->DataChanged();
+}
+
+//-----------------------------------------------------------------------------
+template <class ValueTypeT>
+vtkConcurrentIdAllocator* vtkAOSDataArrayTemplate<ValueTypeT>::GetConcurrentAppendIds() const
+{
+  return this->ConcurrentAppendIds;
+}
+
 //-----------------------------------------------------------------------------
 template <class ValueTypeT>
 void vtkAOSDataArrayTemplate<ValueTypeT>::SetTuple(vtkIdType tupleIdx, const float* tuple)
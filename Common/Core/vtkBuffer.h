@@ -20,11 +20,25 @@
  * vtkBuffer makes it easier to keep data pointers in vtkDataArray subclasses.
  * This is an internal class and not intended for direct use expect when writing
  * new types of vtkDataArray subclasses.
+ *
+ * When vtkObjectBase::SetFirstTouchAllocation() is on, large buffers are
+ * touched in parallel right after being allocated so that their pages are
+ * placed on the NUMA nodes of the threads processing them.
+ *
+ * Buffers are allocated with the allocation policy of
+ * vtkObjectBase::GetBufferAllocationPolicy() when the vtkBuffer is created,
+ * unless it lives in the extended memory space. SetAllocationPolicy() changes
+ * it afterwards.
+ *
+ * The buffer can also be a region of a file mapped in memory with MapFile(),
+ * see vtkMemoryMappedFile. Reallocating a mapped buffer copies its content
+ * to memory allocated with the malloc function.
  */
 
 #ifndef vtkBuffer_h
 #define vtkBuffer_h
 
+#include "vtkMemoryMappedFile.h" // For MapFile()
 #include "vtkObject.h"
 #include "vtkObjectFactory.h" // New() implementation
 
@@ -88,14 +102,49 @@ public:
    */
   bool Reallocate(vtkIdType newsize);
 
+  /**
+   * Use @a size elements of the file @a fileName starting at byte @a offset
+   * as the buffer, mapped in memory with @a mode (one of
+   * vtkMemoryMappedFile::MappingMode) instead of being read. The old buffer is
+   * released. The mapped elements are released by unmapping them, so a free
+   * function set with SetFreeFunction() is replaced by the one matching the
+   * malloc function, used for the buffers allocated afterwards. Returns
+   * false, leaving the buffer unchanged, when the file region cannot be
+   * mapped or when @a offset is not aligned for ScalarType, the mapped values
+   * being aligned like their position in the file.
+   */
+  bool MapFile(const char* fileName, vtkTypeInt64 offset, vtkIdType size, int mode);
+
+  /**
+   * Return true if the buffer is a file region mapped with MapFile().
+   */
+  bool IsMapped() const { return this->Mapped; }
+
+  /**
+   * Set the policy, one of vtkObjectBase::BufferAllocationPolicies, used to
+   * allocate the buffer. The current content is moved to a buffer allocated
+   * with the new policy, unless it is not owned by this object or mapped
+   * from a file. Returns false when the policy cannot be used: the buffer
+   * lives in the extended memory space, or the new buffer cannot be
+   * allocated.
+   */
+  bool SetAllocationPolicy(int policy);
+  int GetAllocationPolicy() const { return this->AllocationPolicy; }
+
 protected:
   vtkBuffer()
     : Pointer(nullptr)
     , Size(0)
+    , Mapped(false)
+    , AllocationPolicy(vtkObjectBase::BUFFER_DEFAULT_ALLOCATION)
   {
     this->SetMallocFunction(vtkObjectBase::GetCurrentMallocFunction());
     this->SetReallocFunction(vtkObjectBase::GetCurrentReallocFunction());
     this->SetFreeFunction(false, vtkObjectBase::GetCurrentFreeFunction());
+    if (!vtkObjectBase::GetUsingMemkind())
+    {
+      this->SetAllocationPolicy(vtkObjectBase::GetBufferAllocationPolicy());
+    }
   }
 
   ~vtkBuffer() override { this->SetBuffer(nullptr, 0); }
@@ -105,8 +154,14 @@ protected:
   vtkMallocingFunction MallocFunction;
   vtkReallocingFunction ReallocFunction;
   vtkFreeingFunction DeleteFunction;
+  bool Mapped;
+  int AllocationPolicy;
 
 private:
+  // Set DeleteFunction to the function releasing the memory obtained from
+  // MallocFunction, when it is known.
+  void ResetFreeFunction();
+
   vtkBuffer(const vtkBuffer&) = delete;
   void operator=(const vtkBuffer&) = delete;
 };
@@ -130,7 +185,12 @@ void vtkBuffer<ScalarT>::SetBuffer(typename vtkBuffer<ScalarT>::ScalarType* arra
 {
   if (this->Pointer != array)
   {
-    if (this->DeleteFunction)
+    if (this->Mapped)
+    {
+      vtkMemoryMappedFile::Unmap(this->Pointer);
+      this->Mapped = false;
+    }
+    else if (this->DeleteFunction)
     {
       this->DeleteFunction(this->Pointer);
     }
@@ -184,11 +244,17 @@ bool vtkBuffer<ScalarT>::Allocate(vtkIdType size)
     }
     if (newArray)
     {
+      vtkObjectBase::FirstTouch(newArray, size * sizeof(ScalarType));
       this->SetBuffer(newArray, size);
       if (!this->MallocFunction)
       {
         this->DeleteFunction = free;
       }
+      else if (this->MallocFunction ==
+        vtkObjectBase::GetBufferMallocFunction(this->AllocationPolicy))
+      {
+        this->DeleteFunction = vtkObjectBase::GetBufferFreeFunction(this->AllocationPolicy);
+      }
       return true;
     }
     return false;
@@ -200,12 +266,15 @@ bool vtkBuffer<ScalarT>::Allocate(vtkIdType size)
 template <typename ScalarT>
 bool vtkBuffer<ScalarT>::Reallocate(vtkIdType newsize)
 {
-  if (newsize == 0)
+  if (newsize == 0 || !this->Pointer)
   {
-    return this->Allocate(0);
+    // Nothing to preserve: allocate with the malloc function of the policy
+    // rather than realloc(), so that arrays grown from empty get its
+    // alignment and pages.
+    return this->Allocate(newsize);
   }
 
-  if (this->Pointer && this->DeleteFunction != free)
+  if (this->Mapped || this->DeleteFunction != free)
   {
     ScalarType* newArray;
     bool forceFreeFunction = false;
@@ -231,6 +300,7 @@ bool vtkBuffer<ScalarT>::Reallocate(vtkIdType newsize)
     {
       return false;
     }
+    vtkObjectBase::FirstTouch(newArray, newsize * sizeof(ScalarType));
     std::copy(this->Pointer, this->Pointer + (std::min)(this->Size, newsize), newArray);
     // now save the new array and release the old one too.
     this->SetBuffer(newArray, newsize);
@@ -238,6 +308,11 @@ bool vtkBuffer<ScalarT>::Reallocate(vtkIdType newsize)
     {
       this->DeleteFunction = free;
     }
+    else if (this->MallocFunction ==
+      vtkObjectBase::GetBufferMallocFunction(this->AllocationPolicy))
+    {
+      this->DeleteFunction = vtkObjectBase::GetBufferFreeFunction(this->AllocationPolicy);
+    }
   }
   else
   {
@@ -257,12 +332,90 @@ bool vtkBuffer<ScalarT>::Reallocate(vtkIdType newsize)
     {
       return false;
     }
+    if (newsize > this->Size)
+    {
+      // Pages kept by realloc keep their placement, the grown part is new.
+      vtkObjectBase::FirstTouch(newArray + this->Size, (newsize - this->Size) * sizeof(ScalarType));
+    }
     this->Pointer = newArray;
     this->Size = newsize;
   }
   return true;
 }
 
+//------------------------------------------------------------------------------
+template <typename ScalarT>
+bool vtkBuffer<ScalarT>::MapFile(
+  const char* fileName, vtkTypeInt64 offset, vtkIdType size, int mode)
+{
+  if (size == 0)
+  {
+    return this->Allocate(0);
+  }
+  if (offset % alignof(ScalarType) != 0)
+  {
+    return false;
+  }
+  void* mapped = vtkMemoryMappedFile::Map(fileName, offset, size * sizeof(ScalarType), mode);
+  if (!mapped)
+  {
+    return false;
+  }
+  this->SetBuffer(static_cast<ScalarType*>(mapped), size);
+  this->Mapped = true;
+  this->ResetFreeFunction();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+template <typename ScalarT>
+void vtkBuffer<ScalarT>::ResetFreeFunction()
+{
+  if (!this->MallocFunction || this->MallocFunction == malloc)
+  {
+    this->DeleteFunction = free;
+  }
+  else if (this->MallocFunction == vtkObjectBase::GetBufferMallocFunction(this->AllocationPolicy))
+  {
+    this->DeleteFunction = vtkObjectBase::GetBufferFreeFunction(this->AllocationPolicy);
+  }
+  else if (this->MallocFunction == vtkObjectBase::GetCurrentMallocFunction())
+  {
+    this->DeleteFunction = vtkObjectBase::GetCurrentFreeFunction();
+  }
+}
+
+//------------------------------------------------------------------------------
+template <typename ScalarT>
+bool vtkBuffer<ScalarT>::SetAllocationPolicy(int policy)
+{
+  if (policy == this->AllocationPolicy)
+  {
+    return true;
+  }
+  if (this->GetIsInMemkind())
+  {
+    return false;
+  }
+  vtkMallocingFunction mallocFunction = vtkObjectBase::GetBufferMallocFunction(policy);
+  if (this->Pointer && this->Size > 0 && this->DeleteFunction && !this->Mapped)
+  {
+    ScalarType* newArray =
+      static_cast<ScalarType*>(mallocFunction(this->Size * sizeof(ScalarType)));
+    if (!newArray)
+    {
+      return false;
+    }
+    std::copy(this->Pointer, this->Pointer + this->Size, newArray);
+    this->SetBuffer(newArray, this->Size);
+    this->DeleteFunction = vtkObjectBase::GetBufferFreeFunction(policy);
+  }
+  this->AllocationPolicy = policy;
+  this->MallocFunction = mallocFunction;
+  this->ReallocFunction = realloc;
+  return true;
+}
+
 VTK_ABI_NAMESPACE_END
 #endif
 // VTK-HeaderTest-Exclude: vtkBuffer.h
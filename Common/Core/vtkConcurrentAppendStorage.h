@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConcurrentAppendStorage.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConcurrentAppendStorage
+ * @brief   per-thread storage of concurrently appended entries.
+ *
+ * vtkConcurrentAppendStorage keeps the values of the entries appended
+ * concurrently to a container until they are compacted into it. The values
+ * are grouped by chunk of the vtkConcurrentIdAllocator numbering the entries,
+ * each chunk being stored by the thread owning it, so that appending only
+ * touches memory local to the calling thread.
+ *
+ * Once the allocator is finalized, GetChunks() lists the chunks by index; the
+ * first entry of a chunk goes at vtkConcurrentIdAllocator::GetChunkFinalId().
+ * A chunk has no entry in the storage when all its ids went to the other
+ * containers sharing the allocator.
+ */
+
+#ifndef vtkConcurrentAppendStorage_h
+#define vtkConcurrentAppendStorage_h
+
+#include "vtkConcurrentIdAllocator.h" // For vtkConcurrentIdAllocator
+#include "vtkSMPThreadLocal.h"        // For vtkSMPThreadLocal
+#include "vtkSmartPointer.h"          // For vtkSmartPointer
+
+#include <unordered_map> // For std::unordered_map
+#include <vector>        // For std::vector
+
+VTK_ABI_NAMESPACE_BEGIN
+template <typename ValueT>
+class vtkConcurrentAppendStorage
+{
+public:
+  struct Chunk
+  {
+    // Index of the chunk in the allocator.
+    vtkIdType Index = -1;
+    // Values of the entries of the chunk.
+    std::vector<ValueT> Values;
+    // End of the values of each entry, for entries of varying size.
+    std::vector<vtkIdType> Ends;
+  };
+
+  explicit vtkConcurrentAppendStorage(vtkConcurrentIdAllocator* ids)
+    : Ids(ids)
+  {
+  }
+
+  vtkConcurrentIdAllocator* GetIds() const { return this->Ids; }
+
+  /**
+   * Return the chunk holding the entry of provisional id `id` for the calling
+   * thread. The ids of a chunk must all be stored by the thread which got
+   * them from the allocator, in any order.
+   */
+  Chunk& GetChunk(vtkIdType id)
+  {
+    ThreadChunks& local = this->Chunks.Local();
+    const vtkIdType index = this->Ids->GetChunk(id);
+    if (!local.Chunks.empty() && local.Chunks.back().Index == index)
+    {
+      return local.Chunks.back();
+    }
+    // Going back to an earlier chunk of the thread must not start it over.
+    auto inserted = local.Positions.emplace(index, local.Chunks.size());
+    if (inserted.second)
+    {
+      local.Chunks.emplace_back();
+      local.Chunks.back().Index = index;
+    }
+    return local.Chunks[inserted.first->second];
+  }
+
+  /**
+   * Return the chunks of all the threads by index, one per chunk of the
+   * finalized allocator, with nullptr for the chunks without entries here.
+   */
+  std::vector<Chunk*> GetChunks()
+  {
+    std::vector<Chunk*> result(this->Ids->GetNumberOfChunks(), nullptr);
+    for (ThreadChunks& local : this->Chunks)
+    {
+      for (Chunk& chunk : local.Chunks)
+      {
+        if (chunk.Index < static_cast<vtkIdType>(result.size()))
+        {
+          result[chunk.Index] = &chunk;
+        }
+      }
+    }
+    return result;
+  }
+
+private:
+  struct ThreadChunks
+  {
+    std::vector<Chunk> Chunks;
+    // Position in Chunks of each chunk index.
+    std::unordered_map<vtkIdType, size_t> Positions;
+  };
+
+  vtkSmartPointer<vtkConcurrentIdAllocator> Ids;
+  vtkSMPThreadLocal<ThreadChunks> Chunks;
+};
+
+VTK_ABI_NAMESPACE_END
+#endif
+// VTK-HeaderTest-Exclude: vtkConcurrentAppendStorage.h
@@ -0,0 +1,120 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConcurrentIdAllocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkConcurrentIdAllocator.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocal.h"
+
+#include <algorithm> // For std::max
+#include <atomic>    // For std::atomic
+
+VTK_ABI_NAMESPACE_BEGIN
+struct vtkConcurrentIdAllocator::vtkInternals
+{
+  // The chunk a thread takes its ids from.
+  struct Cursor
+  {
+    vtkIdType Chunk = -1;
+    vtkIdType Next = 0;
+    vtkIdType End = 0;
+  };
+
+  std::atomic<vtkIdType> NextChunk{ 0 };
+  vtkSMPThreadLocal<Cursor> Cursors;
+};
+
+vtkStandardNewMacro(vtkConcurrentIdAllocator);
+
+//------------------------------------------------------------------------------
+vtkConcurrentIdAllocator::vtkConcurrentIdAllocator()
+  : Internals(new vtkInternals)
+  , Start(0)
+  , ChunkSize(1024)
+  , NumberOfIds(0)
+  , Finalized(false)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkConcurrentIdAllocator::~vtkConcurrentIdAllocator() = default;
+
+//------------------------------------------------------------------------------
+void vtkConcurrentIdAllocator::Initialize(vtkIdType start, vtkIdType chunkSize)
+{
+  // Thread local storage cannot be cleared, start over with new one.
+  this->Internals.reset(new vtkInternals);
+  this->Start = std::max<vtkIdType>(start, 0);
+  this->ChunkSize = std::max<vtkIdType>(chunkSize, 1);
+  this->NumberOfIds = this->Start;
+  this->Finalized = false;
+  this->ChunkSizes.clear();
+  this->ChunkFinalIds.clear();
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkConcurrentIdAllocator::NewId()
+{
+  vtkInternals::Cursor& cursor = this->Internals->Cursors.Local();
+  if (cursor.Next == cursor.End)
+  {
+    cursor.Chunk = this->Internals->NextChunk++;
+    cursor.Next = this->Start + cursor.Chunk * this->ChunkSize;
+    cursor.End = cursor.Next + this->ChunkSize;
+  }
+  return cursor.Next++;
+}
+
+//------------------------------------------------------------------------------
+void vtkConcurrentIdAllocator::Finalize()
+{
+  if (this->Finalized)
+  {
+    return;
+  }
+  this->Finalized = true;
+
+  // All chunks are full, except the current chunk of each thread.
+  const vtkIdType numberOfChunks = this->Internals->NextChunk;
+  this->ChunkSizes.assign(numberOfChunks, this->ChunkSize);
+  for (const vtkInternals::Cursor& cursor : this->Internals->Cursors)
+  {
+    if (cursor.Chunk >= 0)
+    {
+      this->ChunkSizes[cursor.Chunk] = cursor.Next - (cursor.End - this->ChunkSize);
+    }
+  }
+
+  this->ChunkFinalIds.resize(numberOfChunks);
+  vtkIdType finalId = this->Start;
+  for (vtkIdType chunk = 0; chunk < numberOfChunks; ++chunk)
+  {
+    this->ChunkFinalIds[chunk] = finalId;
+    finalId += this->ChunkSizes[chunk];
+  }
+  this->NumberOfIds = finalId;
+}
+
+//------------------------------------------------------------------------------
+void vtkConcurrentIdAllocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Start: " << this->Start << "\n";
+  os << indent << "ChunkSize: " << this->ChunkSize << "\n";
+  os << indent << "Finalized: " << (this->Finalized ? "true" : "false") << "\n";
+  os << indent << "NumberOfIds: " << this->NumberOfIds << "\n";
+  os << indent << "NumberOfChunks: " << this->ChunkSizes.size() << "\n";
+}
+VTK_ABI_NAMESPACE_END
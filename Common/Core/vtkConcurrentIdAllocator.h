@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConcurrentIdAllocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConcurrentIdAllocator
+ * @brief   hand out ids to many threads without locking.
+ *
+ * vtkConcurrentIdAllocator numbers the entries appended concurrently to a
+ * container, such as the points or the cells generated by a vtkSMPTools::For()
+ * functor. Each thread reserves chunks of consecutive ids with a single atomic
+ * operation, and takes the ids of its current chunk without synchronization.
+ *
+ * The ids returned by NewId() are provisional: the last chunk of each thread
+ * is usually not full, leaving holes in the id range. Once all the threads are
+ * done, Finalize() compacts the ids, and GetFinalId() returns the final id of
+ * a provisional one in constant time. Several containers may share an
+ * allocator, for instance a vtkCellArray and its cell data arrays, so that
+ * the entries appended with the same provisional id end at the same final id.
+ *
+ * @sa
+ * vtkAOSDataArrayTemplate::BeginConcurrentAppend()
+ * vtkPoints::BeginConcurrentAppend() vtkCellArray::BeginConcurrentAppend()
+ */
+
+#ifndef vtkConcurrentIdAllocator_h
+#define vtkConcurrentIdAllocator_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkObject.h"
+
+#include <memory> // For std::unique_ptr
+#include <vector> // For std::vector
+
+VTK_ABI_NAMESPACE_BEGIN
+class VTKCOMMONCORE_EXPORT vtkConcurrentIdAllocator : public vtkObject
+{
+public:
+  static vtkConcurrentIdAllocator* New();
+  vtkTypeMacro(vtkConcurrentIdAllocator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /**
+   * Forget all the ids and start handing out ids from start, usually the
+   * number of entries of the containers before the append, in chunks of
+   * chunkSize ids. Ids lower than start are left unchanged by the compaction.
+   */
+  void Initialize(vtkIdType start = 0, vtkIdType chunkSize = 1024);
+
+  /**
+   * Return a new provisional id. Thread safe and lock free.
+   */
+  vtkIdType NewId();
+
+  /**
+   * Compact the ids handed out by NewId(). Must be called once all the
+   * threads are done, calling it again does nothing until Initialize().
+   */
+  void Finalize();
+
+  /**
+   * Return true when Finalize() was called since the last Initialize().
+   */
+  bool IsFinalized() const { return this->Finalized; }
+
+  /**
+   * Return start plus the number of ids handed out, that is the size of the
+   * containers after the append. Only valid once finalized.
+   */
+  vtkIdType GetNumberOfIds() const { return this->NumberOfIds; }
+
+  /**
+   * Return the final id of a provisional id, or -1 if it was not handed out.
+   * Only valid once finalized.
+   */
+  vtkIdType GetFinalId(vtkIdType id) const
+  {
+    if (id < this->Start)
+    {
+      return id;
+    }
+    const vtkIdType chunk = (id - this->Start) / this->ChunkSize;
+    const vtkIdType offset = (id - this->Start) % this->ChunkSize;
+    if (chunk >= static_cast<vtkIdType>(this->ChunkSizes.size()) ||
+      offset >= this->ChunkSizes[chunk])
+    {
+      return -1;
+    }
+    return this->ChunkFinalIds[chunk] + offset;
+  }
+
+  ///@{
+  /**
+   * Chunk layout of the provisional ids, for the containers.
+   */
+  vtkIdType GetStart() const { return this->Start; }
+  vtkIdType GetChunkSize() const { return this->ChunkSize; }
+  vtkIdType GetChunk(vtkIdType id) const { return (id - this->Start) / this->ChunkSize; }
+  vtkIdType GetChunkOffset(vtkIdType id) const { return (id - this->Start) % this->ChunkSize; }
+  ///@}
+
+  ///@{
+  /**
+   * Return the number of chunks, the number of ids handed out in a chunk and
+   * the final id of its first id. Only valid once finalized.
+   */
+  vtkIdType GetNumberOfChunks() const { return static_cast<vtkIdType>(this->ChunkSizes.size()); }
+  vtkIdType GetChunkNumberOfIds(vtkIdType chunk) const { return this->ChunkSizes[chunk]; }
+  vtkIdType GetChunkFinalId(vtkIdType chunk) const { return this->ChunkFinalIds[chunk]; }
+  ///@}
+
+protected:
+  vtkConcurrentIdAllocator();
+  ~vtkConcurrentIdAllocator() override;
+
+private:
+  vtkConcurrentIdAllocator(const vtkConcurrentIdAllocator&) = delete;
+  void operator=(const vtkConcurrentIdAllocator&) = delete;
+
+  struct vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+  vtkIdType Start;
+  vtkIdType ChunkSize;
+  vtkIdType NumberOfIds;
+  bool Finalized;
+  std::vector<vtkIdType> ChunkSizes;
+  std::vector<vtkIdType> ChunkFinalIds;
+};
+
+VTK_ABI_NAMESPACE_END
+#endif
@@ -48,6 +48,7 @@
 #include "vtkUnsignedShortArray.h"
 
 #include <algorithm> // for min(), max()
+#include <vector>    // for std::vector
 
 namespace
 {
@@ -433,10 +434,237 @@ bool hasValidKey(InfoType info, KeyType key, ComponentKeyType ckey, double range
   return false;
 }
 
+// Store the ranges of all the components under the given per component key.
+void setComponentRanges(vtkInformation* info, vtkInformationInformationVectorKey* key,
+  vtkInformationDoubleVectorKey* ckey, const double* ranges, int numComps)
+{
+  vtkInformationVector* infoVec = vtkInformationVector::New();
+  info->Set(key, infoVec);
+
+  infoVec->SetNumberOfInformationObjects(numComps);
+  for (int i = 0; i < numComps; ++i)
+  {
+    infoVec->GetInformationObject(i)->Set(ckey, ranges + (i * 2), 2);
+  }
+  infoVec->FastDelete();
+}
+
+// Wrap DoComputeScalarRangeBlocks for vtkArrayDispatch:
+struct ScalarRangeBlocksDispatchWrapper
+{
+  vtkIdType BlockSize;
+  vtkIdType BeginBlock;
+  vtkIdType EndBlock;
+  double* Ranges;
+  bool Finite;
+
+  template <typename ArrayT>
+  void operator()(ArrayT* array)
+  {
+    if (this->Finite)
+    {
+      vtkDataArrayPrivate::DoComputeScalarRangeBlocks(array, this->BlockSize, this->BeginBlock,
+        this->EndBlock, this->Ranges, vtkDataArrayPrivate::FiniteValues());
+    }
+    else
+    {
+      vtkDataArrayPrivate::DoComputeScalarRangeBlocks(array, this->BlockSize, this->BeginBlock,
+        this->EndBlock, this->Ranges, vtkDataArrayPrivate::AllValues());
+    }
+  }
+};
+
 } // end anon namespace
 
 VTK_ABI_NAMESPACE_BEGIN
 
+//------------------------------------------------------------------------------
+// Component ranges of consecutive blocks of tuples, recorded when the cached
+// component ranges are computed so that ModifiedTuples() only rescans the
+// blocks containing modified tuples. Index 0 holds the ranges of all values,
+// index 1 the finite ranges.
+class vtkDataArray::vtkInternalRangeBlocks
+{
+public:
+  // Compute the blocks of the whole array and the resulting component ranges.
+  // Returns false when the array is empty or is not one of the AOS/SOA arrays.
+  bool Compute(vtkDataArray* array, bool finite, double* ranges)
+  {
+    Blocks& blocks = this->Values[finite];
+    blocks = Blocks();
+    const vtkIdType numTuples = array->GetNumberOfTuples();
+    const int arrayType = array->GetArrayType();
+    if (numTuples == 0 ||
+      (arrayType != vtkAbstractArray::AoSDataArrayTemplate &&
+        arrayType != vtkAbstractArray::SoADataArrayTemplate &&
+        arrayType != vtkAbstractArray::ScaleSoADataArrayTemplate))
+    {
+      return false;
+    }
+    // Same blocking as vtkSMPTools::Reduce.
+    blocks.BlockSize = std::max<vtkIdType>(512, (numTuples + 2047) / 2048);
+    blocks.NumberOfComponents = array->GetNumberOfComponents();
+    if (!this->ComputeBlocks(array, blocks, finite, 0, numTuples))
+    {
+      blocks = Blocks();
+      return false;
+    }
+    blocks.Valid = true;
+    this->Combine(blocks, 0, blocks.GetNumberOfBlocks(), true);
+    std::copy(blocks.Combined.begin(), blocks.Combined.end(), ranges);
+    return true;
+  }
+
+  // Rescan the blocks containing [beginTuple, endTuple) and the tuples
+  // appended since the last update, then update the component ranges.
+  // Returns false when the blocks cannot be updated.
+  bool Update(
+    vtkDataArray* array, bool finite, vtkIdType beginTuple, vtkIdType endTuple, double* ranges)
+  {
+    Blocks& blocks = this->Values[finite];
+    const vtkIdType numTuples = array->GetNumberOfTuples();
+    if (!blocks.Valid || blocks.NumberOfComponents != array->GetNumberOfComponents() ||
+      numTuples < blocks.NumberOfTuples)
+    {
+      blocks = Blocks();
+      return false;
+    }
+
+    // Tuple spans to rescan, merged when they overlap.
+    beginTuple = std::max<vtkIdType>(beginTuple, 0);
+    endTuple = std::min(endTuple, numTuples);
+    vtkIdType spans[2][2] = { { beginTuple, endTuple }, { blocks.NumberOfTuples, numTuples } };
+    if (spans[0][0] < spans[0][1] && spans[1][0] < spans[1][1] && spans[0][1] >= spans[1][0])
+    {
+      spans[1][0] = std::min(spans[0][0], spans[1][0]);
+      spans[0][1] = spans[0][0];
+    }
+
+    // Save the ranges of the blocks to rescan before any of them is, the
+    // blocks appended since the last update having no previous range.
+    const int numComps = blocks.NumberOfComponents;
+    const vtkIdType numPreviousBlocks = blocks.GetNumberOfBlocks();
+    std::vector<double> previous[2];
+    for (int i = 0; i < 2; ++i)
+    {
+      const vtkIdType beginBlock = spans[i][0] / blocks.BlockSize;
+      const vtkIdType endBlock =
+        std::min((spans[i][1] + blocks.BlockSize - 1) / blocks.BlockSize, numPreviousBlocks);
+      if (spans[i][0] < spans[i][1] && beginBlock < endBlock)
+      {
+        previous[i].assign(blocks.Ranges.begin() + 2 * numComps * beginBlock,
+          blocks.Ranges.begin() + 2 * numComps * endBlock);
+      }
+    }
+
+    bool expandOnly = true;
+    for (int i = 0; i < 2; ++i)
+    {
+      if (spans[i][0] >= spans[i][1])
+      {
+        continue;
+      }
+      const vtkIdType beginBlock = spans[i][0] / blocks.BlockSize;
+      const vtkIdType endBlock = (spans[i][1] + blocks.BlockSize - 1) / blocks.BlockSize;
+      if (!this->ComputeBlocks(array, blocks, finite, spans[i][0], spans[i][1]))
+      {
+        blocks = Blocks();
+        return false;
+      }
+      // When every rescanned block still covers its previous range, the
+      // component ranges can only grow and are updated incrementally.
+      const double* updated = blocks.Ranges.data() + 2 * numComps * beginBlock;
+      for (std::size_t j = 0; expandOnly && j < previous[i].size(); j += 2)
+      {
+        expandOnly = updated[j] <= previous[i][j] && updated[j + 1] >= previous[i][j + 1];
+      }
+      if (expandOnly)
+      {
+        this->Combine(blocks, beginBlock, endBlock, false);
+      }
+    }
+    if (!expandOnly)
+    {
+      this->Combine(blocks, 0, blocks.GetNumberOfBlocks(), true);
+    }
+    std::copy(blocks.Combined.begin(), blocks.Combined.end(), ranges);
+    return true;
+  }
+
+  void Clear()
+  {
+    this->Clear(false);
+    this->Clear(true);
+  }
+
+  void Clear(bool finite) { this->Values[finite] = Blocks(); }
+
+  bool IsEmpty() const { return !this->Values[0].Valid && !this->Values[1].Valid; }
+
+  // Set by ComputeCachedScalarRange() while the base ComputeScalarRange() and
+  // ComputeFiniteScalarRange() may record the blocks.
+  bool Recording = false;
+
+private:
+  struct Blocks
+  {
+    bool Valid = false;
+    vtkIdType NumberOfTuples = 0;
+    vtkIdType BlockSize = 0;
+    int NumberOfComponents = 0;
+    std::vector<double> Ranges;
+    std::vector<double> Combined;
+
+    vtkIdType GetNumberOfBlocks() const
+    {
+      return (this->NumberOfTuples + this->BlockSize - 1) / this->BlockSize;
+    }
+  };
+
+  bool ComputeBlocks(
+    vtkDataArray* array, Blocks& blocks, bool finite, vtkIdType beginTuple, vtkIdType endTuple)
+  {
+    blocks.NumberOfTuples = array->GetNumberOfTuples();
+    const vtkIdType numBlocks = blocks.GetNumberOfBlocks();
+    blocks.Ranges.resize(2 * blocks.NumberOfComponents * numBlocks);
+    ScalarRangeBlocksDispatchWrapper worker{ blocks.BlockSize, beginTuple / blocks.BlockSize,
+      std::min(numBlocks, endTuple / blocks.BlockSize + (endTuple % blocks.BlockSize != 0)),
+      blocks.Ranges.data(), finite };
+    if (!vtkArrayDispatch::Dispatch::Execute(array, worker))
+    {
+      worker(array);
+    }
+    return true;
+  }
+
+  // Combine the ranges of the blocks [beginBlock, endBlock) into the
+  // component ranges, starting from empty ranges when reset is true.
+  void Combine(Blocks& blocks, vtkIdType beginBlock, vtkIdType endBlock, bool reset)
+  {
+    const int numComps = blocks.NumberOfComponents;
+    if (reset)
+    {
+      blocks.Combined.resize(2 * numComps);
+      for (int i = 0; i < numComps; ++i)
+      {
+        blocks.Combined[2 * i] = vtkTypeTraits<double>::Max();
+        blocks.Combined[2 * i + 1] = vtkTypeTraits<double>::Min();
+      }
+    }
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      const double* range = blocks.Ranges.data() + 2 * numComps * block;
+      for (int i = 0; i < 2 * numComps; i += 2)
+      {
+        blocks.Combined[i] = std::min(blocks.Combined[i], range[i]);
+        blocks.Combined[i + 1] = std::max(blocks.Combined[i + 1], range[i + 1]);
+      }
+    }
+  }
+
+  Blocks Values[2];
+};
+
 vtkInformationKeyRestrictedMacro(vtkDataArray, COMPONENT_RANGE, DoubleVector, 2);
 vtkInformationKeyRestrictedMacro(vtkDataArray, L2_NORM_RANGE, DoubleVector, 2);
 vtkInformationKeyRestrictedMacro(vtkDataArray, L2_NORM_FINITE_RANGE, DoubleVector, 2);
@@ -451,6 +679,7 @@ vtkDataArray::vtkDataArray()
   this->Range[1] = 0;
   this->FiniteRange[0] = 0;
   this->FiniteRange[1] = 0;
+  this->RangeBlocks = nullptr;
 }
 
 //------------------------------------------------------------------------------
@@ -461,6 +690,7 @@ vtkDataArray::~vtkDataArray()
     this->LookupTable->Delete();
   }
   this->SetName(nullptr);
+  delete this->RangeBlocks;
 }
 
 //------------------------------------------------------------------------------
@@ -1642,19 +1872,12 @@ void vtkDataArray::ComputeFiniteRange(
     if (!hasValidKey(info, PER_FINITE_COMPONENT(), rkey, range, comp))
     {
       double* allCompRanges = new double[this->NumberOfComponents * 2];
-      const bool computed = this->ComputeFiniteScalarRange(allCompRanges);
+      const bool computed = this->ComputeCachedScalarRange(allCompRanges, true);
       if (computed)
       {
         // construct the keys and add them to the info object
-        vtkInformationVector* infoVec = vtkInformationVector::New();
-        info->Set(PER_FINITE_COMPONENT(), infoVec);
-
-        infoVec->SetNumberOfInformationObjects(this->NumberOfComponents);
-        for (int i = 0; i < this->NumberOfComponents; ++i)
-        {
-          infoVec->GetInformationObject(i)->Set(rkey, allCompRanges + (i * 2), 2);
-        }
-        infoVec->FastDelete();
+        setComponentRanges(
+          info, PER_FINITE_COMPONENT(), rkey, allCompRanges, this->NumberOfComponents);
 
         // update the range passed in since we have a valid range.
         range[0] = allCompRanges[comp * 2];
@@ -1721,19 +1944,11 @@ void vtkDataArray::ComputeRange(
     if (!hasValidKey(info, PER_COMPONENT(), rkey, range, comp))
     {
       double* allCompRanges = new double[this->NumberOfComponents * 2];
-      const bool computed = this->ComputeScalarRange(allCompRanges);
+      const bool computed = this->ComputeCachedScalarRange(allCompRanges, false);
       if (computed)
       {
         // construct the keys and add them to the info object
-        vtkInformationVector* infoVec = vtkInformationVector::New();
-        info->Set(PER_COMPONENT(), infoVec);
-
-        infoVec->SetNumberOfInformationObjects(this->NumberOfComponents);
-        for (int i = 0; i < this->NumberOfComponents; ++i)
-        {
-          infoVec->GetInformationObject(i)->Set(rkey, allCompRanges + (i * 2), 2);
-        }
-        infoVec->FastDelete();
+        setComponentRanges(info, PER_COMPONENT(), rkey, allCompRanges, this->NumberOfComponents);
 
         // update the range passed in since we have a valid range.
         range[0] = allCompRanges[comp * 2];
@@ -1755,8 +1970,82 @@ void vtkDataArray::Modified()
     info->Remove(L2_NORM_RANGE());
     info->Remove(L2_NORM_FINITE_RANGE());
   }
+  delete this->RangeBlocks;
+  this->RangeBlocks = nullptr;
   this->Superclass::Modified();
 }
+
+//------------------------------------------------------------------------------
+bool vtkDataArray::ComputeCachedScalarRange(double* ranges, bool finite)
+{
+  // Let the base ComputeScalarRange() or ComputeFiniteScalarRange() record the
+  // ranges of blocks of tuples on the way so that ModifiedTuples() can update
+  // the cached ranges. Overrides of these methods compute the range their way.
+  if (!this->RangeBlocks)
+  {
+    this->RangeBlocks = new vtkInternalRangeBlocks;
+  }
+  this->RangeBlocks->Clear(finite);
+  this->RangeBlocks->Recording = true;
+  const bool computed =
+    finite ? this->ComputeFiniteScalarRange(ranges) : this->ComputeScalarRange(ranges);
+  this->RangeBlocks->Recording = false;
+  if (this->RangeBlocks->IsEmpty())
+  {
+    delete this->RangeBlocks;
+    this->RangeBlocks = nullptr;
+  }
+  return computed;
+}
+
+//------------------------------------------------------------------------------
+void vtkDataArray::ModifiedTuples(vtkIdType beginTuple, vtkIdType endTuple)
+{
+  if (!this->RangeBlocks || !this->HasInformation())
+  {
+    this->Modified();
+    return;
+  }
+
+  // Update the cached component ranges from the recorded blocks, Modified()
+  // then discards every cached range and the updated ones are stored back.
+  vtkInformation* info = this->GetInformation();
+  vtkInformationInformationVectorKey* keys[2] = { PER_COMPONENT(), PER_FINITE_COMPONENT() };
+  std::vector<double> ranges[2];
+  for (int finite = 0; finite < 2; ++finite)
+  {
+    ranges[finite].resize(2 * this->NumberOfComponents);
+    if (!info->Has(keys[finite]) ||
+      !this->RangeBlocks->Update(this, finite != 0, beginTuple, endTuple, ranges[finite].data()))
+    {
+      ranges[finite].clear();
+    }
+  }
+
+  vtkInternalRangeBlocks* blocks = this->RangeBlocks;
+  this->RangeBlocks = nullptr;
+  this->Modified();
+  this->RangeBlocks = blocks;
+
+  for (int finite = 0; finite < 2; ++finite)
+  {
+    if (ranges[finite].empty())
+    {
+      // Not cached or not updated, recompute on next request.
+      this->RangeBlocks->Clear(finite != 0);
+    }
+    else
+    {
+      setComponentRanges(
+        info, keys[finite], COMPONENT_RANGE(), ranges[finite].data(), this->NumberOfComponents);
+    }
+  }
+  if (this->RangeBlocks->IsEmpty())
+  {
+    delete this->RangeBlocks;
+    this->RangeBlocks = nullptr;
+  }
+}
 VTK_ABI_NAMESPACE_END
 
 namespace
@@ -1873,6 +2162,11 @@ bool vtkDataArray::ComputeScalarRange(double* ranges)
 bool vtkDataArray::ComputeScalarRange(
   double* ranges, const unsigned char* ghosts, unsigned char ghostsToSkip)
 {
+  if (!ghosts && this->RangeBlocks && this->RangeBlocks->Recording &&
+    this->RangeBlocks->Compute(this, false, ranges))
+  {
+    return true;
+  }
   ScalarRangeDispatchWrapper worker(ranges, ghosts, ghostsToSkip);
   if (!vtkArrayDispatch::Dispatch::Execute(this, worker))
   {
@@ -1909,6 +2203,11 @@ bool vtkDataArray::ComputeFiniteScalarRange(double* ranges)
 bool vtkDataArray::ComputeFiniteScalarRange(
   double* ranges, const unsigned char* ghosts, unsigned char ghostsToSkip)
 {
+  if (!ghosts && this->RangeBlocks && this->RangeBlocks->Recording &&
+    this->RangeBlocks->Compute(this, true, ranges))
+  {
+    return true;
+  }
   FiniteScalarRangeDispatchWrapper worker(ranges, ghosts, ghostsToSkip);
   if (!vtkArrayDispatch::Dispatch::Execute(this, worker))
   {
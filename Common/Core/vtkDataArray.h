@@ -403,6 +403,23 @@ public:
    */
   void GetRange(double range[2]) { this->GetRange(range, 0); }
 
+  /**
+   * Notify the array that only the tuples in [beginTuple, endTuple) were
+   * modified, e.g. with SetTuple(), or appended, e.g. with InsertNextTuple().
+   * Like Modified(), this updates the modification time, but the component
+   * ranges cached by GetRange() and GetFiniteRange() are updated by rescanning
+   * only the blocks of tuples containing the modified ones instead of being
+   * discarded, and remain exact. Tuples appended since the ranges were cached
+   * are always rescanned. Cached magnitude ranges are discarded.
+   *
+   * The ranges of the blocks, a few thousand values per component, are kept
+   * from the computation of the cached ranges until the next Modified(). This
+   * is equivalent to Modified() when the array shrank or its number of
+   * components changed, and for arrays overriding ComputeScalarRange() or
+   * ComputeFiniteScalarRange().
+   */
+  void ModifiedTuples(vtkIdType beginTuple, vtkIdType endTuple);
+
   ///@{
   /**
    * The range of the data array values for the given component will be
@@ -683,6 +700,14 @@ protected:
 private:
   double* GetTupleN(vtkIdType i, int n);
 
+  // Compute the component ranges to cache, recording the ranges of blocks of
+  // tuples used by ModifiedTuples() unless ComputeScalarRange() or
+  // ComputeFiniteScalarRange() is overridden.
+  bool ComputeCachedScalarRange(double* ranges, bool finite);
+
+  class vtkInternalRangeBlocks;
+  vtkInternalRangeBlocks* RangeBlocks;
+
 private:
   vtkDataArray(const vtkDataArray&) = delete;
   void operator=(const vtkDataArray&) = delete;
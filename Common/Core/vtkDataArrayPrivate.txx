@@ -17,18 +17,22 @@
 
 #ifndef VTK_GDA_TEMPLATE_EXTERN
 
+#include "vtkAOSDataArrayTemplate.h"
 #include "vtkAssume.h"
 #include "vtkDataArray.h"
 #include "vtkDataArrayRange.h"
 #include "vtkMathUtilities.h"
-#include "vtkSMPThreadLocal.h"
 #include "vtkSMPTools.h"
+#include "vtkSOADataArrayTemplate.h"
 #include "vtkTypeTraits.h"
 
 #include <algorithm>
 #include <array>
 #include <cassert> // for assert()
+#include <cmath>
+#include <cstddef> // for std::nullptr_t
 #include <limits>
+#include <type_traits>
 #include <vector>
 
 namespace vtkDataArrayPrivate
@@ -102,44 +106,186 @@ bool isinf(T x)
   // Select the correct partially specialized type.
   return has_infinity<T, std::numeric_limits<T>::has_infinity>::isinf(x);
 }
+
+// Branch free test for values which are neither infinite nor NaN, so that it
+// can be used in vectorized loops.
+template <typename T>
+bool isfinite(T x, std::true_type)
+{
+  return std::abs(x) <= std::numeric_limits<T>::max();
+}
+
+template <typename T>
+bool isfinite(T, std::false_type)
+{
+  return true;
+}
+
+template <typename T>
+bool isfinite(T x)
+{
+  return isfinite(x, typename std::is_floating_point<T>::type());
+}
+
+//----------------------------------------------------------------------------
+// Accumulate the component ranges of numTuples contiguous tuples of NumComps
+// values into range (min0, max0, min1, max1...). The values are processed in
+// blocks of TuplesPerBlock tuples, each value of a block having its own
+// accumulators, which removes the dependency between consecutive updates and
+// lets the compiler turn the inner loop into SIMD compares and blends for the
+// instruction set the library is compiled for. Comparisons with NaN are false
+// so NaN never updates the range, and when Finite is true infinite values are
+// skipped too.
+template <int NumComps, bool Finite, typename T>
+void MinAndMaxKernel(const T* values, vtkIdType numTuples, T* range)
+{
+  constexpr int TuplesPerBlock = 16;
+  constexpr int BlockSize = NumComps * TuplesPerBlock;
+  T mins[BlockSize];
+  T maxs[BlockSize];
+  for (int i = 0; i < BlockSize; ++i)
+  {
+    mins[i] = range[2 * (i % NumComps)];
+    maxs[i] = range[2 * (i % NumComps) + 1];
+  }
+  const vtkIdType numBlocks = numTuples / TuplesPerBlock;
+  for (vtkIdType block = 0; block < numBlocks; ++block, values += BlockSize)
+  {
+    for (int i = 0; i < BlockSize; ++i)
+    {
+      const T value = values[i];
+      const bool valid = !Finite || detail::isfinite(value);
+      mins[i] = (valid && value < mins[i]) ? value : mins[i];
+      maxs[i] = (valid && value > maxs[i]) ? value : maxs[i];
+    }
+  }
+  const int remainder = static_cast<int>(numTuples - numBlocks * TuplesPerBlock) * NumComps;
+  for (int i = 0; i < remainder; ++i)
+  {
+    const T value = values[i];
+    const bool valid = !Finite || detail::isfinite(value);
+    mins[i] = (valid && value < mins[i]) ? value : mins[i];
+    maxs[i] = (valid && value > maxs[i]) ? value : maxs[i];
+  }
+  for (int i = 0; i < BlockSize; ++i)
+  {
+    T& rangeMin = range[2 * (i % NumComps)];
+    T& rangeMax = range[2 * (i % NumComps) + 1];
+    rangeMin = mins[i] < rangeMin ? mins[i] : rangeMin;
+    rangeMax = maxs[i] > rangeMax ? maxs[i] : rangeMax;
+  }
+}
+
+// Use the contiguous kernel on the tuples [begin, end) when the memory layout
+// of the array allows it. Returns false otherwise. AsContiguous() selects the
+// overload from the array type, including for subclasses such as
+// vtkFloatArray.
+template <typename T>
+vtkAOSDataArrayTemplate<T>* AsContiguous(vtkAOSDataArrayTemplate<T>* array)
+{
+  return array;
+}
+
+template <typename T>
+vtkSOADataArrayTemplate<T>* AsContiguous(vtkSOADataArrayTemplate<T>* array)
+{
+  return array;
+}
+
+inline std::nullptr_t AsContiguous(const void*)
+{
+  return nullptr;
+}
+
+template <int NumComps, bool Finite, typename RangeT>
+bool ContiguousMinAndMax(std::nullptr_t, vtkIdType, vtkIdType, RangeT&)
+{
+  return false;
+}
+
+template <int NumComps, bool Finite, typename T, typename RangeT>
+bool ContiguousMinAndMax(
+  vtkAOSDataArrayTemplate<T>* array, vtkIdType begin, vtkIdType end, RangeT& range)
+{
+  MinAndMaxKernel<NumComps, Finite>(
+    array->GetPointer(begin * NumComps), end - begin, range.data());
+  return true;
+}
+
+template <int NumComps, bool Finite, typename T, typename RangeT>
+bool ContiguousMinAndMax(
+  vtkSOADataArrayTemplate<T>* array, vtkIdType begin, vtkIdType end, RangeT& range)
+{
+  if (!array->HasComponentArrays())
+  {
+    return false;
+  }
+  for (int comp = 0; comp < NumComps; ++comp)
+  {
+    T componentRange[2] = { range[2 * comp], range[2 * comp + 1] };
+    MinAndMaxKernel<1, Finite>(
+      array->GetComponentArrayPointer(comp) + begin, end - begin, componentRange);
+    range[2 * comp] = componentRange[0];
+    range[2 * comp + 1] = componentRange[1];
+  }
+  return true;
+}
 }
 
 template <typename APIType, int NumComps>
 class MinAndMax
 {
 protected:
-  APIType ReducedRange[2 * NumComps];
-  vtkSMPThreadLocal<std::array<APIType, 2 * NumComps>> TLRange;
+  using RangeType = std::array<APIType, 2 * NumComps>;
+  RangeType ReducedRange;
 
-public:
-  MinAndMax()
+  static RangeType Identity()
   {
+    RangeType range;
     for (int i = 0, j = 0; i < NumComps; ++i, j += 2)
     {
-      this->ReducedRange[j] = vtkTypeTraits<APIType>::Max();
-      this->ReducedRange[j + 1] = vtkTypeTraits<APIType>::Min();
+      range[j] = vtkTypeTraits<APIType>::Max();
+      range[j + 1] = vtkTypeTraits<APIType>::Min();
     }
+    return range;
   }
-  void Initialize()
+  static RangeType Combine(const RangeType& range0, const RangeType& range1)
   {
-    auto& range = this->TLRange.Local();
+    RangeType range;
     for (int i = 0, j = 0; i < NumComps; ++i, j += 2)
     {
-      range[j] = vtkTypeTraits<APIType>::Max();
-      range[j + 1] = vtkTypeTraits<APIType>::Min();
+      range[j] = detail::min(range0[j], range1[j]);
+      range[j + 1] = detail::max(range0[j + 1], range1[j + 1]);
     }
+    return range;
   }
-  void Reduce()
+  // Reduce the ranges of [0, numTuples) accumulated by the functor.
+  template <typename Functor>
+  void Compute(vtkIdType numTuples, const Functor& functor)
   {
-    for (auto itr = this->TLRange.begin(); itr != this->TLRange.end(); ++itr)
-    {
-      auto& range = *itr;
-      for (int i = 0, j = 0; i < NumComps; ++i, j += 2)
+    this->ReducedRange =
+      vtkSMPTools::Reduce(vtkIdType(0), numTuples, Identity(), functor, &MinAndMax::Combine);
+  }
+  // Compute the ranges of the blocks [beginBlock, endBlock) of blockSize
+  // tuples, the ranges of block b being written at ranges + 2 * NumComps * b.
+  template <typename Functor>
+  static void ComputeBlocks(vtkIdType numTuples, vtkIdType blockSize, vtkIdType beginBlock,
+    vtkIdType endBlock, double* ranges, const Functor& functor)
+  {
+    vtkSMPTools::For(beginBlock, endBlock, 1, [&](vtkIdType first, vtkIdType last) {
+      for (vtkIdType block = first; block < last; ++block)
       {
-        this->ReducedRange[j] = detail::min(this->ReducedRange[j], range[j]);
-        this->ReducedRange[j + 1] = detail::max(this->ReducedRange[j + 1], range[j + 1]);
+        RangeType range = Identity();
+        functor(block * blockSize, std::min((block + 1) * blockSize, numTuples), range);
+        std::copy(range.begin(), range.end(), ranges + 2 * NumComps * block);
       }
-    }
+    });
+  }
+
+public:
+  MinAndMax()
+    : ReducedRange(Identity())
+  {
   }
   template <typename T>
   void CopyRanges(T* ranges)
@@ -169,13 +315,21 @@ public:
     , GhostsToSkip(ghostsToSkip)
   {
   }
-  // Help vtkSMPTools find Initialize() and Reduce()
-  void Initialize() { MinAndMaxT::Initialize(); }
-  void Reduce() { MinAndMaxT::Reduce(); }
-  void operator()(vtkIdType begin, vtkIdType end)
+  void Compute(vtkIdType numTuples) { MinAndMaxT::Compute(numTuples, *this); }
+  void ComputeBlocks(vtkIdType blockSize, vtkIdType beginBlock, vtkIdType endBlock, double* ranges)
   {
+    MinAndMaxT::ComputeBlocks(
+      this->Array->GetNumberOfTuples(), blockSize, beginBlock, endBlock, ranges, *this);
+  }
+  void operator()(vtkIdType begin, vtkIdType end, typename MinAndMaxT::RangeType& range) const
+  {
+    if (!this->Ghosts &&
+      detail::ContiguousMinAndMax<NumComps, false>(
+        detail::AsContiguous(this->Array), begin, end, range))
+    {
+      return;
+    }
     const auto tuples = vtk::DataArrayTupleRange<NumComps>(this->Array, begin, end);
-    auto& range = MinAndMaxT::TLRange.Local();
     const unsigned char* ghostIt = this->Ghosts ? this->Ghosts + begin : nullptr;
     for (const auto tuple : tuples)
     {
@@ -210,13 +364,21 @@ public:
     , GhostsToSkip(ghostsToSkip)
   {
   }
-  // Help vtkSMPTools find Initialize() and Reduce()
-  void Initialize() { MinAndMaxT::Initialize(); }
-  void Reduce() { MinAndMaxT::Reduce(); }
-  void operator()(vtkIdType begin, vtkIdType end)
+  void Compute(vtkIdType numTuples) { MinAndMaxT::Compute(numTuples, *this); }
+  void ComputeBlocks(vtkIdType blockSize, vtkIdType beginBlock, vtkIdType endBlock, double* ranges)
   {
+    MinAndMaxT::ComputeBlocks(
+      this->Array->GetNumberOfTuples(), blockSize, beginBlock, endBlock, ranges, *this);
+  }
+  void operator()(vtkIdType begin, vtkIdType end, typename MinAndMaxT::RangeType& range) const
+  {
+    if (!this->Ghosts &&
+      detail::ContiguousMinAndMax<NumComps, true>(
+        detail::AsContiguous(this->Array), begin, end, range))
+    {
+      return;
+    }
     const auto tuples = vtk::DataArrayTupleRange<NumComps>(this->Array, begin, end);
-    auto& range = MinAndMaxT::TLRange.Local();
     const unsigned char* ghostIt = this->Ghosts ? this->Ghosts + begin : nullptr;
     for (const auto tuple : tuples)
     {
@@ -255,9 +417,7 @@ public:
     , GhostsToSkip(ghostsToSkip)
   {
   }
-  // Help vtkSMPTools find Initialize() and Reduce()
-  void Initialize() { MinAndMaxT::Initialize(); }
-  void Reduce() { MinAndMaxT::Reduce(); }
+  void Compute(vtkIdType numTuples) { MinAndMaxT::Compute(numTuples, *this); }
   template <typename T>
   void CopyRanges(T* ranges)
   {
@@ -267,10 +427,9 @@ public:
     ranges[0] = std::sqrt(ranges[0]);
     ranges[1] = std::sqrt(ranges[1]);
   }
-  void operator()(vtkIdType begin, vtkIdType end)
+  void operator()(vtkIdType begin, vtkIdType end, typename MinAndMaxT::RangeType& range) const
   {
     const auto tuples = vtk::DataArrayTupleRange(this->Array, begin, end);
-    auto& range = MinAndMaxT::TLRange.Local();
     const unsigned char* ghostIt = this->Ghosts ? this->Ghosts + begin : nullptr;
     for (const auto tuple : tuples)
     {
@@ -307,9 +466,7 @@ public:
     , GhostsToSkip(ghostsToSkip)
   {
   }
-  // Help vtkSMPTools find Initialize() and Reduce()
-  void Initialize() { MinAndMaxT::Initialize(); }
-  void Reduce() { MinAndMaxT::Reduce(); }
+  void Compute(vtkIdType numTuples) { MinAndMaxT::Compute(numTuples, *this); }
   template <typename T>
   void CopyRanges(T* ranges)
   {
@@ -319,10 +476,9 @@ public:
     ranges[0] = std::sqrt(ranges[0]);
     ranges[1] = std::sqrt(ranges[1]);
   }
-  void operator()(vtkIdType begin, vtkIdType end)
+  void operator()(vtkIdType begin, vtkIdType end, typename MinAndMaxT::RangeType& range) const
   {
     const auto tuples = vtk::DataArrayTupleRange(this->Array, begin, end);
-    auto& range = MinAndMaxT::TLRange.Local();
     const unsigned char* ghostIt = this->Ghosts ? this->Ghosts + begin : nullptr;
     for (const auto tuple : tuples)
     {
@@ -353,7 +509,7 @@ struct ComputeScalarRange
     unsigned char ghostsToSkip)
   {
     AllValuesMinAndMax<NumComps, ArrayT> minmax(array, ghosts, ghostsToSkip);
-    vtkSMPTools::For(0, array->GetNumberOfTuples(), minmax);
+    minmax.Compute(array->GetNumberOfTuples());
     minmax.CopyRanges(ranges);
     return true;
   }
@@ -362,23 +518,68 @@ struct ComputeScalarRange
     unsigned char ghostsToSkip)
   {
     FiniteMinAndMax<NumComps, ArrayT> minmax(array, ghosts, ghostsToSkip);
-    vtkSMPTools::For(0, array->GetNumberOfTuples(), minmax);
+    minmax.Compute(array->GetNumberOfTuples());
     minmax.CopyRanges(ranges);
     return true;
   }
+  template <class ArrayT>
+  void operator()(ArrayT* array, vtkIdType blockSize, vtkIdType beginBlock, vtkIdType endBlock,
+    double* ranges, AllValues)
+  {
+    AllValuesMinAndMax<NumComps, ArrayT> minmax(array, nullptr, 0);
+    minmax.ComputeBlocks(blockSize, beginBlock, endBlock, ranges);
+  }
+  template <class ArrayT>
+  void operator()(ArrayT* array, vtkIdType blockSize, vtkIdType beginBlock, vtkIdType endBlock,
+    double* ranges, FiniteValues)
+  {
+    FiniteMinAndMax<NumComps, ArrayT> minmax(array, nullptr, 0);
+    minmax.ComputeBlocks(blockSize, beginBlock, endBlock, ranges);
+  }
 };
 
 template <typename ArrayT, typename APIType>
 class GenericMinAndMax
 {
 protected:
+  using RangeType = std::vector<APIType>;
   ArrayT* Array;
   vtkIdType NumComps;
-  vtkSMPThreadLocal<std::vector<APIType>> TLRange;
-  std::vector<APIType> ReducedRange;
+  RangeType ReducedRange;
   const unsigned char* Ghosts;
   unsigned char GhostsToSkip;
 
+  // Reduce the ranges of [0, numTuples) accumulated by the functor.
+  template <typename Functor>
+  void Compute(vtkIdType numTuples, const Functor& functor)
+  {
+    this->ReducedRange = vtkSMPTools::Reduce(vtkIdType(0), numTuples, this->ReducedRange, functor,
+      [](const RangeType& range0, const RangeType& range1) {
+        RangeType range(range0.size());
+        for (size_t j = 0; j < range.size(); j += 2)
+        {
+          range[j] = detail::min(range0[j], range1[j]);
+          range[j + 1] = detail::max(range0[j + 1], range1[j + 1]);
+        }
+        return range;
+      });
+  }
+  // Compute the ranges of the blocks [beginBlock, endBlock) of blockSize
+  // tuples, the ranges of block b being written at ranges + 2 * NumComps * b.
+  template <typename Functor>
+  void ComputeBlocks(vtkIdType numTuples, vtkIdType blockSize, vtkIdType beginBlock,
+    vtkIdType endBlock, double* ranges, const Functor& functor)
+  {
+    vtkSMPTools::For(beginBlock, endBlock, 1, [&](vtkIdType first, vtkIdType last) {
+      for (vtkIdType block = first; block < last; ++block)
+      {
+        RangeType range = this->ReducedRange;
+        functor(block * blockSize, std::min((block + 1) * blockSize, numTuples), range);
+        std::copy(range.begin(), range.end(), ranges + 2 * this->NumComps * block);
+      }
+    });
+  }
+
 public:
   GenericMinAndMax(ArrayT* array, const unsigned char* ghosts, unsigned char ghostsToSkip)
     : Array(array)
@@ -393,28 +594,6 @@ public:
       this->ReducedRange[j + 1] = vtkTypeTraits<APIType>::Min();
     }
   }
-  void Initialize()
-  {
-    auto& range = this->TLRange.Local();
-    range.resize(2 * this->NumComps);
-    for (int i = 0, j = 0; i < this->NumComps; ++i, j += 2)
-    {
-      range[j] = vtkTypeTraits<APIType>::Max();
-      range[j + 1] = vtkTypeTraits<APIType>::Min();
-    }
-  }
-  void Reduce()
-  {
-    for (auto itr = this->TLRange.begin(); itr != this->TLRange.end(); ++itr)
-    {
-      auto& range = *itr;
-      for (int i = 0, j = 0; i < this->NumComps; ++i, j += 2)
-      {
-        this->ReducedRange[j] = detail::min(this->ReducedRange[j], range[j]);
-        this->ReducedRange[j + 1] = detail::max(this->ReducedRange[j + 1], range[j + 1]);
-      }
-    }
-  }
   template <typename T>
   void CopyRanges(T* ranges)
   {
@@ -437,13 +616,15 @@ public:
     : MinAndMaxT(array, ghosts, ghostsToSkip)
   {
   }
-  // Help vtkSMPTools find Initialize() and Reduce()
-  void Initialize() { MinAndMaxT::Initialize(); }
-  void Reduce() { MinAndMaxT::Reduce(); }
-  void operator()(vtkIdType begin, vtkIdType end)
+  void Compute(vtkIdType numTuples) { MinAndMaxT::Compute(numTuples, *this); }
+  void ComputeBlocks(vtkIdType blockSize, vtkIdType beginBlock, vtkIdType endBlock, double* ranges)
+  {
+    MinAndMaxT::ComputeBlocks(
+      this->Array->GetNumberOfTuples(), blockSize, beginBlock, endBlock, ranges, *this);
+  }
+  void operator()(vtkIdType begin, vtkIdType end, typename MinAndMaxT::RangeType& range) const
   {
     const auto tuples = vtk::DataArrayTupleRange(this->Array, begin, end);
-    auto& range = MinAndMaxT::TLRange.Local();
     const unsigned char* ghostIt = this->Ghosts ? this->Ghosts + begin : nullptr;
     for (const auto tuple : tuples)
     {
@@ -473,13 +654,15 @@ public:
     : MinAndMaxT(array, ghosts, ghostsToSkip)
   {
   }
-  // Help vtkSMPTools find Initialize() and Reduce()
-  void Initialize() { MinAndMaxT::Initialize(); }
-  void Reduce() { MinAndMaxT::Reduce(); }
-  void operator()(vtkIdType begin, vtkIdType end)
+  void Compute(vtkIdType numTuples) { MinAndMaxT::Compute(numTuples, *this); }
+  void ComputeBlocks(vtkIdType blockSize, vtkIdType beginBlock, vtkIdType endBlock, double* ranges)
+  {
+    MinAndMaxT::ComputeBlocks(
+      this->Array->GetNumberOfTuples(), blockSize, beginBlock, endBlock, ranges, *this);
+  }
+  void operator()(vtkIdType begin, vtkIdType end, typename MinAndMaxT::RangeType& range) const
   {
     const auto tuples = vtk::DataArrayTupleRange(this->Array, begin, end);
-    auto& range = MinAndMaxT::TLRange.Local();
     const unsigned char* ghostIt = this->Ghosts ? this->Ghosts + begin : nullptr;
     for (const auto tuple : tuples)
     {
@@ -506,7 +689,7 @@ bool GenericComputeScalarRange(ArrayT* array, RangeValueType* ranges, AllValues,
   const unsigned char* ghosts, unsigned char ghostsToSkip)
 {
   AllValuesGenericMinAndMax<ArrayT> minmax(array, ghosts, ghostsToSkip);
-  vtkSMPTools::For(0, array->GetNumberOfTuples(), minmax);
+  minmax.Compute(array->GetNumberOfTuples());
   minmax.CopyRanges(ranges);
   return true;
 }
@@ -516,11 +699,27 @@ bool GenericComputeScalarRange(ArrayT* array, RangeValueType* ranges, FiniteValu
   const unsigned char* ghosts, unsigned char ghostsToSkip)
 {
   FiniteGenericMinAndMax<ArrayT> minmax(array, ghosts, ghostsToSkip);
-  vtkSMPTools::For(0, array->GetNumberOfTuples(), minmax);
+  minmax.Compute(array->GetNumberOfTuples());
   minmax.CopyRanges(ranges);
   return true;
 }
 
+template <class ArrayT>
+void GenericComputeScalarRangeBlocks(ArrayT* array, vtkIdType blockSize, vtkIdType beginBlock,
+  vtkIdType endBlock, double* ranges, AllValues)
+{
+  AllValuesGenericMinAndMax<ArrayT> minmax(array, nullptr, 0);
+  minmax.ComputeBlocks(blockSize, beginBlock, endBlock, ranges);
+}
+
+template <class ArrayT>
+void GenericComputeScalarRangeBlocks(ArrayT* array, vtkIdType blockSize, vtkIdType beginBlock,
+  vtkIdType endBlock, double* ranges, FiniteValues)
+{
+  FiniteGenericMinAndMax<ArrayT> minmax(array, nullptr, 0);
+  minmax.ComputeBlocks(blockSize, beginBlock, endBlock, ranges);
+}
+
 //----------------------------------------------------------------------------
 template <typename ArrayT, typename RangeValueType, typename ValueType>
 bool DoComputeScalarRange(ArrayT* array, RangeValueType* ranges, ValueType tag,
@@ -585,6 +784,49 @@ bool DoComputeScalarRange(ArrayT* array, RangeValueType* ranges, ValueType tag,
   }
 }
 
+//----------------------------------------------------------------------------
+// Compute the component ranges of the blocks [beginBlock, endBlock) of
+// blockSize tuples, the last block being possibly smaller. The ranges of
+// block b are written at ranges + 2 * numComps * b. Ghosts are not supported.
+template <typename ArrayT, typename ValueType>
+void DoComputeScalarRangeBlocks(ArrayT* array, vtkIdType blockSize, vtkIdType beginBlock,
+  vtkIdType endBlock, double* ranges, ValueType tag)
+{
+  switch (array->GetNumberOfComponents())
+  {
+    case 1:
+      ComputeScalarRange<1>()(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+    case 2:
+      ComputeScalarRange<2>()(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+    case 3:
+      ComputeScalarRange<3>()(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+    case 4:
+      ComputeScalarRange<4>()(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+    case 5:
+      ComputeScalarRange<5>()(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+    case 6:
+      ComputeScalarRange<6>()(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+    case 7:
+      ComputeScalarRange<7>()(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+    case 8:
+      ComputeScalarRange<8>()(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+    case 9:
+      ComputeScalarRange<9>()(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+    default:
+      GenericComputeScalarRangeBlocks(array, blockSize, beginBlock, endBlock, ranges, tag);
+      break;
+  }
+}
+
 //----------------------------------------------------------------------------
 // generic implementation that operates on ValueType.
 template <typename ArrayT, typename RangeValueType>
@@ -605,7 +847,7 @@ bool DoComputeVectorRange(ArrayT* array, RangeValueType range[2], AllValues,
   // give precision errors on large 64-bit ints, but magnitudes aren't usually
   // computed for those.
   MagnitudeAllValuesMinAndMax<ArrayT, double> MinAndMax(array, ghosts, ghostsToSkip);
-  vtkSMPTools::For(0, numTuples, MinAndMax);
+  MinAndMax.Compute(numTuples);
   MinAndMax.CopyRanges(range);
   return true;
 }
@@ -630,7 +872,7 @@ bool DoComputeVectorRange(ArrayT* array, RangeValueType range[2], FiniteValues,
   // give precision errors on large 64-bit ints, but magnitudes aren't usually
   // computed for those.
   MagnitudeFiniteMinAndMax<ArrayT, double> MinAndMax(array, ghosts, ghostsToSkip);
-  vtkSMPTools::For(0, numTuples, MinAndMax);
+  MinAndMax.Compute(numTuples);
   MinAndMax.CopyRanges(range);
   return true;
 }
@@ -27,5 +27,6 @@ namespace vtkDataArrayPrivate
 {
 VTK_ABI_NAMESPACE_BEGIN
 VTK_INSTANTIATE_VALUERANGE_ARRAYTYPE(vtkDataArray, double)
+VTK_INSTANTIATE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkDataArray)
 VTK_ABI_NAMESPACE_END
 } // namespace vtkDataArrayPrivate
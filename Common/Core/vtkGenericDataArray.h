@@ -441,6 +441,8 @@ bool DoComputeVectorRange(
 template <typename A, typename R>
 bool DoComputeVectorRange(
   A*, R[2], FiniteValues, const unsigned char* ghosts, unsigned char ghostsToSkip);
+template <typename A, typename T>
+void DoComputeScalarRangeBlocks(A*, vtkIdType, vtkIdType, vtkIdType, double*, T);
 VTK_ABI_NAMESPACE_END
 } // namespace vtkDataArrayPrivate
 
@@ -501,6 +503,13 @@ VTK_ABI_NAMESPACE_END
   template VTKCOMMONCORE_EXPORT bool DoComputeVectorRange(ArrayType*, ValueType[2],                \
     vtkDataArrayPrivate::FiniteValues, const unsigned char*, unsigned char);
 
+// Block ranges are only computed in double precision.
+#define VTK_INSTANTIATE_VALUERANGE_BLOCKS_ARRAYTYPE(ArrayType)                                     \
+  template VTKCOMMONCORE_EXPORT void DoComputeScalarRangeBlocks(                                   \
+    ArrayType*, vtkIdType, vtkIdType, vtkIdType, double*, vtkDataArrayPrivate::AllValues);         \
+  template VTKCOMMONCORE_EXPORT void DoComputeScalarRangeBlocks(                                   \
+    ArrayType*, vtkIdType, vtkIdType, vtkIdType, double*, vtkDataArrayPrivate::FiniteValues);
+
 #ifdef VTK_USE_SCALED_SOA_ARRAYS
 
 #define VTK_INSTANTIATE_VALUERANGE_VALUETYPE(ValueType)                                            \
@@ -552,6 +561,8 @@ bool DoComputeVectorRange(
 template <typename A, typename R>
 bool DoComputeVectorRange(
   A*, R[2], FiniteValues, const unsigned char* ghosts, unsigned char ghostsToSkip);
+template <typename A, typename T>
+void DoComputeScalarRangeBlocks(A*, vtkIdType, vtkIdType, vtkIdType, double*, T);
 VTK_ABI_NAMESPACE_END
 } // namespace vtkDataArrayPrivate
 
@@ -565,6 +576,12 @@ VTK_ABI_NAMESPACE_END
   extern template VTKCOMMONCORE_EXPORT bool DoComputeVectorRange(ArrayType*, ValueType[2],         \
     vtkDataArrayPrivate::FiniteValues, const unsigned char*, unsigned char);
 
+#define VTK_DECLARE_VALUERANGE_BLOCKS_ARRAYTYPE(ArrayType)                                         \
+  extern template VTKCOMMONCORE_EXPORT void DoComputeScalarRangeBlocks(                            \
+    ArrayType*, vtkIdType, vtkIdType, vtkIdType, double*, vtkDataArrayPrivate::AllValues);         \
+  extern template VTKCOMMONCORE_EXPORT void DoComputeScalarRangeBlocks(                            \
+    ArrayType*, vtkIdType, vtkIdType, vtkIdType, double*, vtkDataArrayPrivate::FiniteValues);
+
 #ifdef VTK_USE_SCALED_SOA_ARRAYS
 
 #define VTK_DECLARE_VALUERANGE_VALUETYPE(ValueType)                                                \
@@ -572,12 +589,21 @@ VTK_ABI_NAMESPACE_END
   VTK_DECLARE_VALUERANGE_ARRAYTYPE(vtkSOADataArrayTemplate<ValueType>, ValueType)                  \
   VTK_DECLARE_VALUERANGE_ARRAYTYPE(vtkScaledSOADataArrayTemplate<ValueType>, ValueType)
 
+#define VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(ValueType)                                         \
+  VTK_DECLARE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkAOSDataArrayTemplate<ValueType>)                      \
+  VTK_DECLARE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkSOADataArrayTemplate<ValueType>)                      \
+  VTK_DECLARE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkScaledSOADataArrayTemplate<ValueType>)
+
 #else // VTK_USE_SCALED_SOA_ARRAYS
 
 #define VTK_DECLARE_VALUERANGE_VALUETYPE(ValueType)                                                \
   VTK_DECLARE_VALUERANGE_ARRAYTYPE(vtkAOSDataArrayTemplate<ValueType>, ValueType)                  \
   VTK_DECLARE_VALUERANGE_ARRAYTYPE(vtkSOADataArrayTemplate<ValueType>, ValueType)
 
+#define VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(ValueType)                                         \
+  VTK_DECLARE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkAOSDataArrayTemplate<ValueType>)                      \
+  VTK_DECLARE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkSOADataArrayTemplate<ValueType>)
+
 #endif
 
 namespace vtkDataArrayPrivate
@@ -591,6 +617,7 @@ VTK_DECLARE_VALUERANGE_VALUETYPE(unsigned long long)
 
 // This is instantiated in vtkGenericDataArray.cxx
 VTK_DECLARE_VALUERANGE_ARRAYTYPE(vtkDataArray, double)
+VTK_DECLARE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkDataArray)
 
 // These are instantiated in vtkFloatArray.cxx, vtkDoubleArray.cxx, etc
 VTK_DECLARE_VALUERANGE_ARRAYTYPE(vtkAOSDataArrayTemplate<float>, double)
@@ -639,11 +666,28 @@ VTK_DECLARE_VALUERANGE_ARRAYTYPE(vtkScaledSOADataArrayTemplate<long long>, doubl
 VTK_DECLARE_VALUERANGE_ARRAYTYPE(vtkScaledSOADataArrayTemplate<unsigned long long>, double)
 #endif // VTK_USE_SCALED_SOA_ARRAYS
 
+// These are instantiated along with the array templates above
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(float)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(double)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(char)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(signed char)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(unsigned char)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(short)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(unsigned short)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(int)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(unsigned int)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(long)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(unsigned long)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(long long)
+VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE(unsigned long long)
+
 VTK_ABI_NAMESPACE_END
 } // namespace vtkDataArrayPrivate
 
 #undef VTK_DECLARE_VALUERANGE_ARRAYTYPE
 #undef VTK_DECLARE_VALUERANGE_VALUETYPE
+#undef VTK_DECLARE_VALUERANGE_BLOCKS_ARRAYTYPE
+#undef VTK_DECLARE_VALUERANGE_BLOCKS_VALUETYPE
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -13,6 +13,7 @@
 
 =========================================================================*/
 #include "vtkIdList.h"
+#include "vtkMemoryArena.h"
 #include "vtkObjectFactory.h"
 #include "vtkSMPTools.h" //for parallel sort
 
@@ -26,6 +27,11 @@ vtkIdList::vtkIdList()
   this->Size = 0;
   this->Ids = nullptr;
   this->ManageMemory = true;
+  this->Arena = nullptr;
+  this->ArenaGeneration = 0;
+  this->ArenaEndChunk = 0;
+  this->ArenaEndOffset = 0;
+  this->IdsInArena = false;
 }
 
 //------------------------------------------------------------------------------
@@ -40,7 +46,16 @@ vtkIdList::~vtkIdList()
 //------------------------------------------------------------------------------
 vtkIdType* vtkIdList::Release()
 {
+  if (this->DropRewoundIds())
+  {
+    vtkErrorMacro("The ids were released by a rewind of the arena.");
+  }
   auto retval = this->Ids;
+  if (this->IdsInArena)
+  {
+    retval = new vtkIdType[this->Size];
+    std::copy(this->Ids, this->Ids + this->NumberOfIds, retval);
+  }
   this->Ids = nullptr;
   this->Initialize();
   return retval;
@@ -54,9 +69,72 @@ void vtkIdList::InitializeMemory()
     delete[] this->Ids;
   }
   this->ManageMemory = true;
+  this->IdsInArena = false;
   this->Ids = nullptr;
 }
 
+//------------------------------------------------------------------------------
+vtkIdType* vtkIdList::NewIds(vtkIdType sz)
+{
+  if (this->Arena)
+  {
+    vtkIdType* ids = this->Arena->Allocate<vtkIdType>(static_cast<size_t>(sz));
+    const vtkMemoryArena::Mark end = this->Arena->GetMark();
+    this->ArenaGeneration = this->Arena->GetGeneration();
+    this->ArenaEndChunk = end.Chunk;
+    this->ArenaEndOffset = end.Offset;
+    return ids;
+  }
+  return new vtkIdType[sz];
+}
+
+//------------------------------------------------------------------------------
+bool vtkIdList::DropRewoundIds()
+{
+  if (!this->IdsInArena)
+  {
+    return false;
+  }
+  if (!this->Arena->WasRewoundBelow(
+        vtkMemoryArena::Mark{ this->ArenaEndChunk, this->ArenaEndOffset }, this->ArenaGeneration))
+  {
+    // Later checks only need to look at the rewinds to come.
+    this->ArenaGeneration = this->Arena->GetGeneration();
+    return false;
+  }
+  const bool hadIds = this->NumberOfIds > 0;
+  this->Ids = nullptr;
+  this->Size = 0;
+  this->NumberOfIds = 0;
+  this->IdsInArena = false;
+  this->ManageMemory = true;
+  return hadIds;
+}
+
+//------------------------------------------------------------------------------
+void vtkIdList::SetArena(vtkMemoryArena* arena)
+{
+  if (arena == this->Arena)
+  {
+    return;
+  }
+  this->DropRewoundIds();
+  vtkIdType* ids = this->Ids;
+  const bool manageMemory = this->ManageMemory;
+  this->Arena = arena;
+  if (ids)
+  {
+    this->Ids = this->NewIds(this->Size);
+    std::copy(ids, ids + this->NumberOfIds, this->Ids);
+    if (manageMemory)
+    {
+      delete[] ids;
+    }
+  }
+  this->ManageMemory = this->Arena == nullptr;
+  this->IdsInArena = ids && this->Arena;
+}
+
 //------------------------------------------------------------------------------
 void vtkIdList::Initialize()
 {
@@ -68,17 +146,20 @@ void vtkIdList::Initialize()
 //------------------------------------------------------------------------------
 bool vtkIdList::AllocateInternal(vtkIdType sz, vtkIdType numberOfIds)
 {
+  this->DropRewoundIds();
   if (sz > this->Size)
   {
     this->InitializeMemory();
     this->Size = (sz > 0 ? sz : 1);
-    this->Ids = new vtkIdType[this->Size];
+    this->Ids = this->NewIds(this->Size);
     if (this->Ids == nullptr)
     {
       vtkErrorMacro("Could not allocate memory for " << this->Size << " ids.");
       this->NumberOfIds = 0;
       return false;
     }
+    this->ManageMemory = this->Arena == nullptr;
+    this->IdsInArena = this->Arena != nullptr;
   }
   this->NumberOfIds = numberOfIds;
   return true;
@@ -146,6 +227,7 @@ void vtkIdList::SetArray(vtkIdType* array, vtkIdType size, bool save)
     }
   }
   this->ManageMemory = save;
+  this->IdsInArena = false;
   this->Ids = array;
   this->NumberOfIds = size;
   this->Size = size;
@@ -193,6 +275,11 @@ vtkIdType* vtkIdList::Resize(const vtkIdType sz)
   vtkIdType* newIds;
   vtkIdType newSize;
 
+  if (this->DropRewoundIds())
+  {
+    vtkErrorMacro("Cannot resize ids released by a rewind of the arena.");
+    return nullptr;
+  }
   if (sz > this->Size)
   {
     newSize = this->Size + sz;
@@ -212,7 +299,7 @@ vtkIdType* vtkIdList::Resize(const vtkIdType sz)
     return nullptr;
   }
 
-  if ((newIds = new vtkIdType[newSize]) == nullptr)
+  if ((newIds = this->NewIds(newSize)) == nullptr)
   {
     vtkErrorMacro(<< "Cannot allocate memory\n");
     return nullptr;
@@ -232,7 +319,8 @@ vtkIdType* vtkIdList::Resize(const vtkIdType sz)
       delete[] this->Ids;
     }
   }
-  this->ManageMemory = true;
+  this->ManageMemory = this->Arena == nullptr;
+  this->IdsInArena = this->Arena != nullptr;
 
   this->Size = newSize;
   this->Ids = newIds;
@@ -315,5 +403,6 @@ void vtkIdList::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "Number of Ids: " << this->NumberOfIds << "\n";
+  os << indent << "Arena: " << this->Arena << "\n";
 }
 VTK_ABI_NAMESPACE_END
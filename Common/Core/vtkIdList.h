@@ -19,6 +19,9 @@
  * vtkIdList is used to represent and pass data id's between
  * objects. vtkIdList may represent any type of integer id, but
  * usually represents point and cell ids.
+ *
+ * Short-lived lists of hot loops can draw their memory from a
+ * vtkMemoryArena instead of the heap, see SetArena().
  */
 
 #ifndef vtkIdList_h
@@ -28,6 +31,8 @@
 #include "vtkObject.h"
 
 VTK_ABI_NAMESPACE_BEGIN
+class vtkMemoryArena;
+
 class VTKCOMMONCORE_EXPORT vtkIdList : public vtkObject
 {
 public:
@@ -143,7 +148,31 @@ public:
   /**
    * Reset to an empty state but retain previously allocated memory.
    */
-  void Reset() { this->NumberOfIds = 0; }
+  void Reset()
+  {
+    this->NumberOfIds = 0;
+    if (this->IdsInArena)
+    {
+      this->DropRewoundIds();
+    }
+  }
+
+  ///@{
+  /**
+   * Set/Get the arena the memory of the list is allocated from, or nullptr
+   * (the default) to allocate it on the heap. The current ids are moved to
+   * memory allocated from the new arena.
+   *
+   * Memory allocated from an arena is released when the arena is rewound
+   * below it (see vtkMemoryArena::Rewind()), typically at the end of the
+   * vtkMemoryArena::Scope the list was filled in. The list then forgets its
+   * ids on the next call to Reset(), Allocate() or SetNumberOfIds(), which
+   * refill it. Growing a list whose ids were released, with Resize() or the
+   * insertion methods, is an error.
+   */
+  void SetArena(vtkMemoryArena* arena);
+  vtkMemoryArena* GetArena() const { return this->Arena; }
+  ///@}
 
   /**
    * Free any unused memory.
@@ -183,7 +212,7 @@ public:
    * This releases the ownership of the internal vtkIdType array and returns the
    * pointer to it. The caller is responsible of calling `delete []` on the
    * returned value. This vtkIdList will be set to initialized state after this
-   * call.
+   * call. Ids allocated from an arena are copied to a new array first.
    */
   vtkIdType* Release();
 #endif
@@ -209,11 +238,27 @@ protected:
    * Release memory.
    */
   void InitializeMemory();
+  /**
+   * Allocate memory for sz ids from the arena or the heap.
+   */
+  vtkIdType* NewIds(vtkIdType sz);
+  /**
+   * Forget the ids allocated from the arena if it was rewound below them
+   * since. Returns true if they were forgotten.
+   */
+  bool DropRewoundIds();
 
   vtkIdType NumberOfIds;
   vtkIdType Size;
   vtkIdType* Ids;
   bool ManageMemory;
+  vtkMemoryArena* Arena;
+  // Generation of the arena and end of the ids in it, see
+  // vtkMemoryArena::WasRewoundBelow().
+  vtkTypeUInt64 ArenaGeneration;
+  size_t ArenaEndChunk;
+  size_t ArenaEndOffset;
+  bool IdsInArena;
 
 private:
   vtkIdList(const vtkIdList&) = delete;
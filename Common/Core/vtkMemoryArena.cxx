@@ -0,0 +1,148 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryArena.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMemoryArena.h"
+
+#include "vtkSetGet.h" // For VTK_THREAD_LOCAL
+
+#include <algorithm> // For std::max, std::upper_bound
+#include <cstdint>   // For uintptr_t
+#include <cstdlib>   // For malloc, free
+
+VTK_ABI_NAMESPACE_BEGIN
+//------------------------------------------------------------------------------
+vtkMemoryArena::vtkMemoryArena(size_t chunkSize)
+  : ChunkSize(std::max(chunkSize, static_cast<size_t>(1024)))
+  , CurrentChunk(0)
+  , CurrentOffset(0)
+  , Generation(0)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkMemoryArena::~vtkMemoryArena()
+{
+  for (const Chunk& chunk : this->Chunks)
+  {
+    free(chunk.Data);
+  }
+}
+
+//------------------------------------------------------------------------------
+void* vtkMemoryArena::Allocate(size_t size, size_t alignment)
+{
+  while (true)
+  {
+    if (this->CurrentChunk < this->Chunks.size())
+    {
+      const Chunk& chunk = this->Chunks[this->CurrentChunk];
+      const uintptr_t base = reinterpret_cast<uintptr_t>(chunk.Data);
+      const uintptr_t aligned = (base + this->CurrentOffset + alignment - 1) & ~(alignment - 1);
+      const size_t end = static_cast<size_t>(aligned - base) + size;
+      if (end <= chunk.Size)
+      {
+        this->CurrentOffset = end;
+        return reinterpret_cast<void*>(aligned);
+      }
+      // Move to the next chunk, if it is large enough to be of use.
+      const size_t next = this->CurrentChunk + 1;
+      if (next < this->Chunks.size() && this->Chunks[next].Size >= size + alignment)
+      {
+        this->CurrentChunk = next;
+        this->CurrentOffset = 0;
+        continue;
+      }
+    }
+
+    // Insert a new chunk after the current one.
+    const size_t chunkSize = std::max(this->ChunkSize, size + alignment);
+    char* data = static_cast<char*>(malloc(chunkSize));
+    if (!data)
+    {
+      return nullptr;
+    }
+    const size_t position =
+      this->CurrentChunk < this->Chunks.size() ? this->CurrentChunk + 1 : this->Chunks.size();
+    this->Chunks.insert(this->Chunks.begin() + position, Chunk{ data, chunkSize });
+    this->CurrentChunk = position;
+    this->CurrentOffset = 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryArena::Rewind(const Mark& mark)
+{
+  this->CurrentChunk = mark.Chunk;
+  this->CurrentOffset = mark.Offset;
+  ++this->Generation;
+  // The rewinds to later marks released less memory than this one.
+  while (!this->Rewinds.empty() && !vtkMemoryArena::IsBefore(this->Rewinds.back().Position, mark))
+  {
+    this->Rewinds.pop_back();
+  }
+  this->Rewinds.push_back(RewindRecord{ this->Generation, mark });
+}
+
+//------------------------------------------------------------------------------
+bool vtkMemoryArena::WasRewoundBelow(const Mark& mark, vtkTypeUInt64 generation) const
+{
+  if (generation == this->Generation)
+  {
+    return false;
+  }
+  // The first rewind since the generation is the lowest one since then.
+  auto rewind = std::upper_bound(this->Rewinds.begin(), this->Rewinds.end(), generation,
+    [](vtkTypeUInt64 value, const RewindRecord& record) { return value < record.Generation; });
+  return rewind != this->Rewinds.end() && vtkMemoryArena::IsBefore(rewind->Position, mark);
+}
+
+//------------------------------------------------------------------------------
+size_t vtkMemoryArena::GetCapacity() const
+{
+  size_t capacity = 0;
+  for (const Chunk& chunk : this->Chunks)
+  {
+    capacity += chunk.Size;
+  }
+  return capacity;
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryArena::Squeeze()
+{
+  // The current chunk is unused when nothing was allocated in it.
+  const size_t firstUnused = this->CurrentOffset == 0 ? this->CurrentChunk : this->CurrentChunk + 1;
+  for (size_t i = firstUnused; i < this->Chunks.size(); ++i)
+  {
+    free(this->Chunks[i].Data);
+  }
+  if (firstUnused < this->Chunks.size())
+  {
+    this->Chunks.erase(this->Chunks.begin() + firstUnused, this->Chunks.end());
+  }
+  if (this->CurrentChunk >= this->Chunks.size())
+  {
+    // Allocations resume on a new chunk appended after the last one.
+    this->CurrentChunk = this->Chunks.empty() ? 0 : this->Chunks.size() - 1;
+    this->CurrentOffset = this->Chunks.empty() ? 0 : this->Chunks.back().Size;
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkMemoryArena* vtkMemoryArena::GetThreadLocalArena()
+{
+  static VTK_THREAD_LOCAL vtkMemoryArena arena;
+  return &arena;
+}
+VTK_ABI_NAMESPACE_END
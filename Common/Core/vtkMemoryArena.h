@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryArena.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkMemoryArena
+ * @brief   bump allocator for short-lived temporaries.
+ *
+ * vtkMemoryArena hands out memory by bumping a pointer in large chunks, and
+ * releases everything allocated since a mark at once by rewinding to it.
+ * Chunks are kept for reuse, so that once warmed up, allocating from an arena
+ * neither calls the system allocator nor contends with other threads. It is
+ * meant for the temporaries of hot loops, typically released at the end of
+ * each chunk of a vtkSMPTools::For():
+ *
+ * \code
+ * vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+ *   vtkMemoryArena::Scope scope; // rewinds the thread-local arena on exit
+ *   vtkNew<vtkIdList> ids;
+ *   ids->SetArena(scope.GetArena());
+ *   ...
+ * });
+ * \endcode
+ *
+ * An arena is not thread safe: each thread uses its own, for instance the one
+ * returned by GetThreadLocalArena(). Memory is only released by rewinding,
+ * objects allocated in the arena are not destroyed.
+ *
+ * Every rewind increments the generation of the arena, and
+ * WasRewoundBelow() lets users of the arena such as vtkIdList detect that
+ * the memory they got from it was released since, and may have been given
+ * to somebody else. Rewinding a nested Scope does not release the memory
+ * allocated before it.
+ *
+ * @sa
+ * vtkIdList::SetArena() vtkGenericCell::SetArena()
+ */
+
+#ifndef vtkMemoryArena_h
+#define vtkMemoryArena_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkType.h"             // For vtkTypeUInt64
+
+#include <cstddef> // For size_t
+#include <vector>  // For std::vector
+
+VTK_ABI_NAMESPACE_BEGIN
+class VTKCOMMONCORE_EXPORT vtkMemoryArena
+{
+public:
+  /**
+   * Create an arena allocating chunks of at least `chunkSize` bytes.
+   */
+  explicit vtkMemoryArena(size_t chunkSize = 65536);
+  ~vtkMemoryArena();
+
+  /**
+   * Allocate `size` bytes aligned on `alignment`, a power of two. The memory
+   * is valid until the arena is rewound to a mark taken before this call.
+   * Never returns nullptr, except when the system allocator fails.
+   */
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /**
+   * Allocate uninitialized storage for `count` values of type T.
+   */
+  template <typename T>
+  T* Allocate(size_t count)
+  {
+    return static_cast<T*>(this->Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  /**
+   * A position in the arena, to rewind to.
+   */
+  struct Mark
+  {
+    size_t Chunk;
+    size_t Offset;
+  };
+
+  /**
+   * Return the current position of the arena.
+   */
+  Mark GetMark() const { return Mark{ this->CurrentChunk, this->CurrentOffset }; }
+
+  ///@{
+  /**
+   * Release all the memory allocated since `mark`, or all the memory of the
+   * arena. Chunks are kept for later allocations.
+   */
+  void Rewind(const Mark& mark);
+  void Rewind() { this->Rewind(Mark{ 0, 0 }); }
+  ///@}
+
+  /**
+   * Return true when `a` is before `b` in the arena.
+   */
+  static bool IsBefore(const Mark& a, const Mark& b)
+  {
+    return a.Chunk < b.Chunk || (a.Chunk == b.Chunk && a.Offset < b.Offset);
+  }
+
+  /**
+   * Return the number of times the arena was rewound.
+   */
+  vtkTypeUInt64 GetGeneration() const { return this->Generation; }
+
+  /**
+   * Return true if the arena was rewound before `mark` since it was at
+   * generation `generation`, that is if memory allocated before `mark` at
+   * that time may have been released.
+   */
+  bool WasRewoundBelow(const Mark& mark, vtkTypeUInt64 generation) const;
+
+  /**
+   * Return the number of bytes of the chunks of the arena.
+   */
+  size_t GetCapacity() const;
+
+  /**
+   * Free the chunks that are not in use.
+   */
+  void Squeeze();
+
+  /**
+   * Return the arena of the calling thread.
+   */
+  static vtkMemoryArena* GetThreadLocalArena();
+
+  /**
+   * Rewind an arena, by default the thread-local one, to its position at
+   * construction when going out of scope.
+   */
+  class VTKCOMMONCORE_EXPORT Scope
+  {
+  public:
+    explicit Scope(vtkMemoryArena* arena = vtkMemoryArena::GetThreadLocalArena())
+      : Arena(arena)
+      , Start(arena->GetMark())
+    {
+    }
+    ~Scope() { this->Arena->Rewind(this->Start); }
+    vtkMemoryArena* GetArena() const { return this->Arena; }
+
+  private:
+    Scope(const Scope&) = delete;
+    void operator=(const Scope&) = delete;
+
+    vtkMemoryArena* Arena;
+    Mark Start;
+  };
+
+private:
+  vtkMemoryArena(const vtkMemoryArena&) = delete;
+  void operator=(const vtkMemoryArena&) = delete;
+
+  struct Chunk
+  {
+    char* Data;
+    size_t Size;
+  };
+
+  // The rewinds which may have released memory allocated before the later
+  // ones: their marks increase with their generations.
+  struct RewindRecord
+  {
+    vtkTypeUInt64 Generation;
+    Mark Position;
+  };
+
+  std::vector<Chunk> Chunks;
+  std::vector<RewindRecord> Rewinds;
+  size_t ChunkSize;
+  size_t CurrentChunk;
+  size_t CurrentOffset;
+  vtkTypeUInt64 Generation;
+};
+
+VTK_ABI_NAMESPACE_END
+#endif
+// VTK-HeaderTest-Exclude: vtkMemoryArena.h
@@ -0,0 +1,197 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMemoryMappedFile.h"
+
+#if defined(_WIN32)
+#define VTK_MEMORY_MAPPED_FILE_WIN32
+#include "vtkWindows.h"
+#include <vtksys/Encoding.hxx>
+#elif defined(__unix__) || defined(__APPLE__)
+#define VTK_MEMORY_MAPPED_FILE_POSIX
+#include <fcntl.h>    // For open
+#include <sys/mman.h> // For mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For close, sysconf
+#endif
+
+#include <map>   // For std::map
+#include <mutex> // For std::mutex
+
+namespace
+{
+// The mapping backing a region returned by Map(): the mapped view starts on
+// an allocation boundary before the requested offset.
+struct MappedRegion
+{
+  void* Base;
+  size_t Length;
+};
+
+std::mutex& GetRegionsMutex()
+{
+  static std::mutex regionsMutex;
+  return regionsMutex;
+}
+
+std::map<const void*, MappedRegion>& GetRegions()
+{
+  static std::map<const void*, MappedRegion> regions;
+  return regions;
+}
+
+#if defined(VTK_MEMORY_MAPPED_FILE_WIN32)
+//------------------------------------------------------------------------------
+void* MapRegion(const char* fileName, vtkTypeInt64 offset, size_t length, int mode,
+  MappedRegion& region)
+{
+  HANDLE file = CreateFileW(vtksys::Encoding::ToWide(fileName).c_str(), GENERIC_READ,
+    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return nullptr;
+  }
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) ||
+    fileSize.QuadPart < offset + static_cast<vtkTypeInt64>(length))
+  {
+    CloseHandle(file);
+    return nullptr;
+  }
+  const bool copyOnWrite = mode == vtkMemoryMappedFile::COPY_ON_WRITE;
+  HANDLE mapping = CreateFileMappingW(
+    file, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping)
+  {
+    return nullptr;
+  }
+
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  const vtkTypeInt64 base = offset - offset % info.dwAllocationGranularity;
+  region.Length = static_cast<size_t>(offset - base) + length;
+  region.Base = MapViewOfFile(mapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ,
+    static_cast<DWORD>(base >> 32), static_cast<DWORD>(base & 0xFFFFFFFF), region.Length);
+  // The view keeps a reference to the mapping object.
+  CloseHandle(mapping);
+  if (!region.Base)
+  {
+    return nullptr;
+  }
+  return static_cast<char*>(region.Base) + (offset - base);
+}
+
+//------------------------------------------------------------------------------
+void UnmapRegion(const MappedRegion& region)
+{
+  UnmapViewOfFile(region.Base);
+}
+
+#elif defined(VTK_MEMORY_MAPPED_FILE_POSIX)
+//------------------------------------------------------------------------------
+void* MapRegion(const char* fileName, vtkTypeInt64 offset, size_t length, int mode,
+  MappedRegion& region)
+{
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 ||
+    static_cast<vtkTypeInt64>(fileStat.st_size) < offset + static_cast<vtkTypeInt64>(length))
+  {
+    close(fd);
+    return nullptr;
+  }
+  const bool copyOnWrite = mode == vtkMemoryMappedFile::COPY_ON_WRITE;
+  const vtkTypeInt64 base = offset - offset % sysconf(_SC_PAGESIZE);
+  region.Length = static_cast<size_t>(offset - base) + length;
+  region.Base = mmap(nullptr, region.Length, copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ,
+    copyOnWrite ? MAP_PRIVATE : MAP_SHARED, fd, static_cast<off_t>(base));
+  // The mapping keeps a reference to the file.
+  close(fd);
+  if (region.Base == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  return static_cast<char*>(region.Base) + (offset - base);
+}
+
+//------------------------------------------------------------------------------
+void UnmapRegion(const MappedRegion& region)
+{
+  munmap(region.Base, region.Length);
+}
+
+#else
+//------------------------------------------------------------------------------
+void* MapRegion(const char*, vtkTypeInt64, size_t, int, MappedRegion&)
+{
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+void UnmapRegion(const MappedRegion&) {}
+#endif
+}
+
+VTK_ABI_NAMESPACE_BEGIN
+//------------------------------------------------------------------------------
+void* vtkMemoryMappedFile::Map(const char* fileName, vtkTypeInt64 offset, size_t length, int mode)
+{
+  if (!fileName || offset < 0 || length == 0)
+  {
+    return nullptr;
+  }
+  MappedRegion region;
+  void* address = MapRegion(fileName, offset, length, mode, region);
+  if (address)
+  {
+    std::lock_guard<std::mutex> lock(GetRegionsMutex());
+    GetRegions()[address] = region;
+  }
+  return address;
+}
+
+//------------------------------------------------------------------------------
+void vtkMemoryMappedFile::Unmap(void* address)
+{
+  MappedRegion region;
+  {
+    std::lock_guard<std::mutex> lock(GetRegionsMutex());
+    auto& regions = GetRegions();
+    auto it = regions.find(address);
+    if (it == regions.end())
+    {
+      return;
+    }
+    region = it->second;
+    regions.erase(it);
+  }
+  UnmapRegion(region);
+}
+
+//------------------------------------------------------------------------------
+bool vtkMemoryMappedFile::IsSupported()
+{
+#if defined(VTK_MEMORY_MAPPED_FILE_WIN32) || defined(VTK_MEMORY_MAPPED_FILE_POSIX)
+  return true;
+#else
+  return false;
+#endif
+}
+VTK_ABI_NAMESPACE_END
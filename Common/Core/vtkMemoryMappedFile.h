@@ -0,0 +1,81 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryMappedFile.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkMemoryMappedFile
+ * @brief   map regions of files in memory for vtkBuffer.
+ *
+ * vtkMemoryMappedFile maps a region of a file in the address space of the
+ * process (mmap on POSIX systems, MapViewOfFile on Windows) so that data
+ * arrays can use the file content as their storage without reading it: pages
+ * are loaded on demand when they are accessed and can be dropped by the
+ * operating system under memory pressure.
+ *
+ * A region is mapped either read-only, writing to it being an access
+ * violation, or copy-on-write, modified pages being private to the process
+ * and never written back to the file. The file can be closed or removed once
+ * mapped, but the content of the mapping is undefined if the file is
+ * truncated or modified by another process.
+ *
+ * Map() returns the address of the first mapped byte, and Unmap() releases
+ * the region given this same address, which makes Unmap() usable as the free
+ * function of an array (see vtkAbstractArray::SetArrayFreeFunction()).
+ *
+ * @sa
+ * vtkBuffer vtkAOSDataArrayTemplate
+ */
+
+#ifndef vtkMemoryMappedFile_h
+#define vtkMemoryMappedFile_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkType.h"             // For vtkTypeInt64
+
+#include <cstddef> // For size_t
+
+VTK_ABI_NAMESPACE_BEGIN
+class VTKCOMMONCORE_EXPORT vtkMemoryMappedFile
+{
+public:
+  enum MappingMode
+  {
+    READ_ONLY = 0,
+    COPY_ON_WRITE = 1
+  };
+
+  /**
+   * Map `length` bytes of `fileName` starting at byte `offset`, which does
+   * not need to be aligned on pages. Returns the address of the byte at
+   * `offset`, or nullptr when the file cannot be opened, is too short or
+   * cannot be mapped. Pages being aligned, the address is aligned like
+   * `offset`: callers mapping typed values must check that `offset` is
+   * aligned for their type.
+   */
+  static void* Map(const char* fileName, vtkTypeInt64 offset, size_t length, int mode);
+
+  /**
+   * Release the region mapped at `address` by Map(). Does nothing for
+   * addresses which were not returned by Map().
+   */
+  static void Unmap(void* address);
+
+  /**
+   * Return true when file mapping is supported on this platform.
+   */
+  static bool IsSupported();
+};
+
+VTK_ABI_NAMESPACE_END
+#endif
+// VTK-HeaderTest-Exclude: vtkMemoryMappedFile.h
@@ -17,11 +17,22 @@
 #include "vtkDebug.h"
 #include "vtkDebugLeaks.h"
 #include "vtkGarbageCollector.h"
+#include "vtkSMPTools.h"
 #include "vtkWeakPointerBase.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <sstream>
 
+#if defined(_WIN32)
+#include <malloc.h> // For _aligned_malloc
+#else
+#include <sys/mman.h> // For mmap, madvise
+#include <unistd.h>   // For sysconf
+#endif
+
 #ifdef VTK_USE_MEMKIND
 #include <memkind.h>
 VTK_ABI_NAMESPACE_BEGIN
@@ -380,6 +391,112 @@ VTK_THREAD_LOCAL vtkMallocingFunction CurrentMallocFunction = malloc;
 VTK_THREAD_LOCAL vtkReallocingFunction CurrentReallocFunction = realloc;
 VTK_THREAD_LOCAL vtkFreeingFunction CurrentFreeFunction = free;
 VTK_THREAD_LOCAL vtkFreeingFunction AlternateFreeFunction = vtkCustomFree;
+std::atomic<bool> FirstTouchAllocation(false);
+std::atomic<int> BufferAllocationPolicy(vtkObjectBase::BUFFER_DEFAULT_ALLOCATION);
+
+// Buffers allocated with a policy start with a header, padded to the
+// alignment, recording how to release them.
+constexpr size_t BufferAlignment = 64;
+constexpr size_t HugePageSize = 2 << 20;
+struct BufferHeader
+{
+  void* Base;
+  size_t Length;
+  bool Mapped;
+};
+static_assert(sizeof(BufferHeader) <= BufferAlignment, "Buffer header too large.");
+
+//------------------------------------------------------------------------------
+void* FinishBuffer(void* base, size_t length, bool mapped)
+{
+  if (!base)
+  {
+    return nullptr;
+  }
+  char* buffer = static_cast<char*>(base) + BufferAlignment;
+  BufferHeader* header = reinterpret_cast<BufferHeader*>(buffer) - 1;
+  header->Base = base;
+  header->Length = length;
+  header->Mapped = mapped;
+  return buffer;
+}
+
+//------------------------------------------------------------------------------
+void* AlignedAllocate(size_t size, size_t alignment)
+{
+#if defined(_WIN32)
+  return _aligned_malloc(size, alignment);
+#else
+  void* base = nullptr;
+  return posix_memalign(&base, alignment, size) == 0 ? base : nullptr;
+#endif
+}
+
+//------------------------------------------------------------------------------
+void* AlignedBufferMalloc(size_t size)
+{
+  const size_t length = size + BufferAlignment;
+  return FinishBuffer(AlignedAllocate(length, BufferAlignment), length, false);
+}
+
+//------------------------------------------------------------------------------
+void* TransparentHugePagesBufferMalloc(size_t size)
+{
+#if defined(MADV_HUGEPAGE)
+  if (size >= HugePageSize)
+  {
+    const size_t length = (size + BufferAlignment + HugePageSize - 1) / HugePageSize * HugePageSize;
+    void* base = AlignedAllocate(length, HugePageSize);
+    if (base)
+    {
+      // This is only advice: the buffer is still valid if refused.
+      madvise(base, length, MADV_HUGEPAGE);
+    }
+    return FinishBuffer(base, length, false);
+  }
+#endif
+  return AlignedBufferMalloc(size);
+}
+
+//------------------------------------------------------------------------------
+void* HugePagesBufferMalloc(size_t size)
+{
+#if defined(MAP_HUGETLB)
+  if (size >= HugePageSize)
+  {
+    const size_t length = (size + BufferAlignment + HugePageSize - 1) / HugePageSize * HugePageSize;
+    void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (base != MAP_FAILED)
+    {
+      return FinishBuffer(base, length, true);
+    }
+  }
+#endif
+  return TransparentHugePagesBufferMalloc(size);
+}
+
+//------------------------------------------------------------------------------
+void BufferFree(void* buffer)
+{
+  if (!buffer)
+  {
+    return;
+  }
+  const BufferHeader* header = static_cast<const BufferHeader*>(buffer) - 1;
+#if defined(_WIN32)
+  _aligned_free(header->Base);
+#else
+  if (header->Mapped)
+  {
+    munmap(header->Base, header->Length);
+  }
+  else
+  {
+    free(header->Base);
+  }
+#endif
+}
 }
 
 VTK_ABI_NAMESPACE_BEGIN
@@ -480,6 +597,94 @@ vtkFreeingFunction vtkObjectBase::GetAlternateFreeFunction()
   return AlternateFreeFunction;
 }
 
+//------------------------------------------------------------------------------
+void vtkObjectBase::SetFirstTouchAllocation(bool b)
+{
+  FirstTouchAllocation = b;
+}
+
+//------------------------------------------------------------------------------
+bool vtkObjectBase::GetFirstTouchAllocation()
+{
+  return FirstTouchAllocation;
+}
+
+//------------------------------------------------------------------------------
+void vtkObjectBase::SetBufferAllocationPolicy(int policy)
+{
+  BufferAllocationPolicy = std::max(static_cast<int>(BUFFER_DEFAULT_ALLOCATION),
+    std::min(policy, static_cast<int>(BUFFER_HUGE_PAGES)));
+}
+
+//------------------------------------------------------------------------------
+int vtkObjectBase::GetBufferAllocationPolicy()
+{
+  return BufferAllocationPolicy;
+}
+
+//------------------------------------------------------------------------------
+vtkMallocingFunction vtkObjectBase::GetBufferMallocFunction(int policy)
+{
+  switch (policy)
+  {
+    case BUFFER_ALIGNED_ALLOCATION:
+      return AlignedBufferMalloc;
+    case BUFFER_TRANSPARENT_HUGE_PAGES:
+      return TransparentHugePagesBufferMalloc;
+    case BUFFER_HUGE_PAGES:
+      return HugePagesBufferMalloc;
+    default:
+      return malloc;
+  }
+}
+
+//------------------------------------------------------------------------------
+vtkFreeingFunction vtkObjectBase::GetBufferFreeFunction(int policy)
+{
+  switch (policy)
+  {
+    case BUFFER_ALIGNED_ALLOCATION:
+    case BUFFER_TRANSPARENT_HUGE_PAGES:
+    case BUFFER_HUGE_PAGES:
+      return BufferFree;
+    default:
+      return free;
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkObjectBase::FirstTouch(void* buffer, size_t size)
+{
+  // Small buffers are served from memory already touched by the allocator,
+  // and are not worth a parallel loop.
+  static constexpr size_t minimumSize = 1 << 20;
+  if (!FirstTouchAllocation || !buffer || size < minimumSize)
+  {
+    return;
+  }
+
+#if defined(_WIN32)
+  static const size_t pageSize = 4096;
+#else
+  static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+
+  // Write one byte in each page spanned by the buffer. The buffer is not
+  // initialized yet, so its content does not matter.
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(buffer);
+  const uintptr_t end = begin + size;
+  const uintptr_t firstPage = begin - begin % pageSize;
+  const vtkIdType numberOfPages =
+    static_cast<vtkIdType>((end - firstPage + pageSize - 1) / pageSize);
+  vtkSMPTools::For(0, numberOfPages, [=](vtkIdType page, vtkIdType endPage) {
+    for (; page < endPage; ++page)
+    {
+      const uintptr_t pageBegin = firstPage + static_cast<uintptr_t>(page) * pageSize;
+      *reinterpret_cast<volatile char*>(std::max(pageBegin, begin)) = 0;
+    }
+  });
+}
+
 //------------------------------------------------------------------------------
 bool vtkObjectBase::GetIsInMemkind() const
 {
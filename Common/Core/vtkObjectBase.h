@@ -276,6 +276,58 @@ public:
    */
   bool GetIsInMemkind() const;
 
+  ///@{
+  /**
+   * A global state flag that controls whether the buffers allocated by
+   * vtkBuffer (hence by vtkAOSDataArrayTemplate and vtkSOADataArrayTemplate)
+   * are first touched in parallel with vtkSMPTools. On NUMA systems, memory
+   * pages are placed on the node of the thread first writing them: touching
+   * large buffers in parallel spreads them over the nodes of the threads that
+   * later process them, instead of placing them all on the node of the
+   * allocating thread. This works best with pinned threads, e.g. using the
+   * VTK_SMP_THREAD_AFFINITY environment variable with the STDThread backend.
+   * Off by default.
+   */
+  static void SetFirstTouchAllocation(bool);
+  static bool GetFirstTouchAllocation();
+  ///@}
+
+  /**
+   * Allocation policies of the buffers of data arrays.
+   * - BUFFER_DEFAULT_ALLOCATION: the malloc function, with its default
+   *   alignment.
+   * - BUFFER_ALIGNED_ALLOCATION: 64 bytes aligned buffers, the size of a cache
+   *   line and of the widest SIMD registers.
+   * - BUFFER_TRANSPARENT_HUGE_PAGES: aligned buffers, large buffers being
+   *   aligned on 2 MB and advised to use transparent huge pages (Linux only,
+   *   other systems use aligned buffers), which reduces TLB misses when
+   *   traversing multi GB arrays.
+   * - BUFFER_HUGE_PAGES: large buffers are mapped with explicit 2 MB pages
+   *   (Linux only, needs pages reserved in /proc/sys/vm/nr_hugepages),
+   *   falling back to transparent huge pages when none is available.
+   */
+  enum BufferAllocationPolicies
+  {
+    BUFFER_DEFAULT_ALLOCATION = 0,
+    BUFFER_ALIGNED_ALLOCATION,
+    BUFFER_TRANSPARENT_HUGE_PAGES,
+    BUFFER_HUGE_PAGES
+  };
+
+  ///@{
+  /**
+   * A global state flag that controls the allocation policy of the buffers
+   * of the vtkAOSDataArrayTemplate and vtkSOADataArrayTemplate arrays
+   * created afterwards (see BufferAllocationPolicies). The policy of an
+   * existing vtkAOSDataArrayTemplate can be changed with its
+   * SetAllocationPolicy() method.
+   * Buffers allocated in the extended memory space (see GetUsingMemkind())
+   * ignore it. Default is BUFFER_DEFAULT_ALLOCATION.
+   */
+  static void SetBufferAllocationPolicy(int);
+  static int GetBufferAllocationPolicy();
+  ///@}
+
 protected:
   vtkObjectBase();
   virtual ~vtkObjectBase();
@@ -300,6 +352,13 @@ protected:
   static vtkFreeingFunction GetCurrentFreeFunction();
   // Call this to unconditionally call memkind_free
   static vtkFreeingFunction GetAlternateFreeFunction();
+  // Call this to touch the memory pages of a newly allocated buffer of size
+  // bytes in parallel, if FirstTouchAllocation is on and the buffer is large.
+  static void FirstTouch(void* buffer, size_t size);
+  // Call this to get the functions allocating and freeing buffers with the
+  // given BufferAllocationPolicies value.
+  static vtkMallocingFunction GetBufferMallocFunction(int policy);
+  static vtkFreeingFunction GetBufferFreeFunction(int policy);
 
   virtual void ObjectFinalize();
 
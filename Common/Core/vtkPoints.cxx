@@ -15,6 +15,7 @@
 #include "vtkPoints.h"
 
 #include "vtkArrayDispatch.h"
+#include "vtkConcurrentIdAllocator.h"
 #include "vtkDataArray.h"
 #include "vtkDataArrayRange.h"
 #include "vtkFloatArray.h"
@@ -126,7 +127,12 @@ void vtkPoints::ComputeBounds()
 {
   if (this->GetMTime() > this->ComputeTime)
   {
-    this->Data->ComputeScalarRange(this->Bounds);
+    // Go through the cached component ranges of the data array so that
+    // ranges updated by ModifiedPoints() are reused.
+    for (int i = 0; i < 3; ++i)
+    {
+      this->Data->GetRange(this->Bounds + 2 * i, i);
+    }
     this->ComputeTime.Modified();
   }
 }
@@ -182,6 +188,79 @@ void vtkPoints::Modified()
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkPoints::ModifiedPoints(vtkIdType beginPoint, vtkIdType endPoint)
+{
+  this->Superclass::Modified();
+  if (this->Data)
+  {
+    this->Data->ModifiedTuples(beginPoint, endPoint);
+  }
+}
+
+//------------------------------------------------------------------------------
+bool vtkPoints::BeginConcurrentAppend(vtkConcurrentIdAllocator* ids)
+{
+  if (auto floats = vtkAOSDataArrayTemplate<float>::FastDownCast(this->Data))
+  {
+    floats->BeginConcurrentAppend(ids);
+    return true;
+  }
+  if (auto doubles = vtkAOSDataArrayTemplate<double>::FastDownCast(this->Data))
+  {
+    doubles->BeginConcurrentAppend(ids);
+    return true;
+  }
+  vtkErrorMacro("Cannot append concurrently to points of type " << this->Data->GetClassName());
+  return false;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkPoints::ConcurrentInsertNextPoint(const double x[3])
+{
+  // The type of the array was checked by BeginConcurrentAppend().
+  if (this->Data->GetDataType() == VTK_FLOAT)
+  {
+    const float p[3] = { static_cast<float>(x[0]), static_cast<float>(x[1]),
+      static_cast<float>(x[2]) };
+    return static_cast<vtkAOSDataArrayTemplate<float>*>(this->Data)->ConcurrentInsertNextTuple(p);
+  }
+  return static_cast<vtkAOSDataArrayTemplate<double>*>(this->Data)->ConcurrentInsertNextTuple(x);
+}
+
+//------------------------------------------------------------------------------
+void vtkPoints::EndConcurrentAppend()
+{
+  vtkConcurrentIdAllocator* ids = this->GetConcurrentAppendIds();
+  if (!ids)
+  {
+    return;
+  }
+  if (this->Data->GetDataType() == VTK_FLOAT)
+  {
+    static_cast<vtkAOSDataArrayTemplate<float>*>(this->Data)->EndConcurrentAppend();
+  }
+  else
+  {
+    static_cast<vtkAOSDataArrayTemplate<double>*>(this->Data)->EndConcurrentAppend();
+  }
+  this->ModifiedPoints(ids->GetStart(), ids->GetNumberOfIds());
+}
+
+//------------------------------------------------------------------------------
+vtkConcurrentIdAllocator* vtkPoints::GetConcurrentAppendIds()
+{
+  if (auto floats = vtkAOSDataArrayTemplate<float>::FastDownCast(this->Data))
+  {
+    return floats->GetConcurrentAppendIds();
+  }
+  if (auto doubles = vtkAOSDataArrayTemplate<double>::FastDownCast(this->Data))
+  {
+    return doubles->GetConcurrentAppendIds();
+  }
+  return nullptr;
+}
+
 //------------------------------------------------------------------------------
 int vtkPoints::GetDataType() const
 {
@@ -29,6 +29,7 @@
 #include "vtkDataArray.h" // Needed for inline methods
 
 VTK_ABI_NAMESPACE_BEGIN
+class vtkConcurrentIdAllocator;
 class vtkIdList;
 
 class VTKCOMMONCORE_EXPORT vtkPoints : public vtkObject
@@ -207,6 +208,28 @@ public:
   vtkIdType InsertNextPoint(const double x[3]) { return this->Data->InsertNextTuple(x); }
   vtkIdType InsertNextPoint(double x, double y, double z);
 
+  ///@{
+  /**
+   * Append points from many threads at once, see
+   * vtkAOSDataArrayTemplate::BeginConcurrentAppend(). Only points stored in a
+   * vtkFloatArray or a vtkDoubleArray can be appended concurrently,
+   * BeginConcurrentAppend() returns false otherwise.
+   * ConcurrentInsertNextPoint() is thread safe and returns the provisional id
+   * of the point, EndConcurrentAppend() moves the points to their final ids,
+   * given by vtkConcurrentIdAllocator::GetFinalId() of
+   * GetConcurrentAppendIds().
+   */
+  bool BeginConcurrentAppend(vtkConcurrentIdAllocator* ids = nullptr);
+  vtkIdType ConcurrentInsertNextPoint(const double x[3]);
+  vtkIdType ConcurrentInsertNextPoint(double x, double y, double z)
+  {
+    const double p[3] = { x, y, z };
+    return this->ConcurrentInsertNextPoint(p);
+  }
+  void EndConcurrentAppend();
+  vtkConcurrentIdAllocator* GetConcurrentAppendIds();
+  ///@}
+
   /**
    * Specify the number of points for this object to hold. Does an
    * allocation as well as setting the MaxId ivar. Used in conjunction with
@@ -252,6 +275,14 @@ public:
    */
   void Modified() override;
 
+  /**
+   * Update the modification time for this object when only the points in
+   * [beginPoint, endPoint) were changed (with SetPoint() for instance) or
+   * points were appended. The cached bounds are then updated by rescanning
+   * only the modified blocks of points, see vtkDataArray::ModifiedTuples().
+   */
+  void ModifiedPoints(vtkIdType beginPoint, vtkIdType endPoint);
+
 protected:
   vtkPoints(int dataType = VTK_FLOAT);
   ~vtkPoints() override;
@@ -129,14 +129,19 @@ set(vtk_smp_common_dir SMP/Common)
 list(APPEND vtk_smp_sources
   "${vtk_smp_common_dir}/vtkSMPToolsAPI.cxx")
 list(APPEND vtk_smp_nowrap_headers
+  "${vtk_smp_common_dir}/vtkSMPTaskGraphInternal.h"
   "${vtk_smp_common_dir}/vtkSMPThreadLocalAPI.h"
   "${vtk_smp_common_dir}/vtkSMPThreadLocalImplAbstract.h"
   "${vtk_smp_common_dir}/vtkSMPToolsAPI.h"
   "${vtk_smp_common_dir}/vtkSMPToolsImpl.h"
-  "${vtk_smp_common_dir}/vtkSMPToolsInternal.h")
+  "${vtk_smp_common_dir}/vtkSMPToolsInternal.h"
+  "${vtk_smp_common_dir}/vtkSMPToolsSortInternal.h")
 
 list(APPEND vtk_smp_sources
+  vtkSMPTaskGraph.cxx
   vtkSMPTools.cxx)
+list(APPEND vtk_smp_nowrap_headers
+  vtkSMPTaskGraph.h)
 list(APPEND vtk_smp_headers
   vtkSMPTools.h
   vtkSMPThreadLocal.h
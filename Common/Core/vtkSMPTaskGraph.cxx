@@ -0,0 +1,81 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTaskGraph.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSMPTaskGraph.h"
+
+#include "SMP/Common/vtkSMPTaskGraphInternal.h"
+#include "SMP/Common/vtkSMPToolsAPI.h"
+#include "vtkSetGet.h" // For vtkGenericWarningMacro
+
+VTK_ABI_NAMESPACE_BEGIN
+
+//------------------------------------------------------------------------------
+vtkSMPTaskGraph::vtkSMPTaskGraph()
+  : Storage(new vtk::detail::smp::vtkSMPTaskGraphStorage)
+{
+}
+
+//------------------------------------------------------------------------------
+vtkSMPTaskGraph::~vtkSMPTaskGraph() = default;
+
+//------------------------------------------------------------------------------
+vtkSMPTaskGraph::TaskId vtkSMPTaskGraph::AddTask(
+  std::function<void()>&& work, const TaskId* dependencies, std::size_t size)
+{
+  auto& tasks = this->Storage->Tasks;
+  const TaskId id = static_cast<TaskId>(tasks.size());
+  tasks.emplace_back();
+  tasks.back().Work = std::move(work);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    const TaskId dependency = dependencies[i];
+    if (dependency < 0 || dependency >= id)
+    {
+      vtkGenericWarningMacro("Ignoring dependency on task "
+        << dependency << " which was not spawned before task " << id);
+      continue;
+    }
+    tasks[dependency].Successors.push_back(id);
+    tasks.back().NumberOfPredecessors++;
+  }
+  return id;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkSMPTaskGraph::GetDefaultGrain(vtkIdType size) const
+{
+  auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+  const vtkIdType estimateGrain = size / (SMPToolsAPI.GetEstimatedNumberOfThreads() * 4);
+  return estimateGrain > 0 ? estimateGrain : 1;
+}
+
+//------------------------------------------------------------------------------
+void vtkSMPTaskGraph::Wait()
+{
+  if (this->Storage->Tasks.empty())
+  {
+    return;
+  }
+  auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+  SMPToolsAPI.RunTaskGraph(*this->Storage);
+  this->Storage->Tasks.clear();
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkSMPTaskGraph::GetNumberOfTasks() const
+{
+  return static_cast<vtkIdType>(this->Storage->Tasks.size());
+}
+
+VTK_ABI_NAMESPACE_END
@@ -0,0 +1,213 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTaskGraph.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkSMPTaskGraph
+ * @brief   A graph of dependent tasks executed by the vtkSMPTools backend.
+ *
+ * vtkSMPTaskGraph lets algorithms made of several dependent passes (e.g.
+ * count, prefix sum, then fill) describe their work as tasks linked by
+ * dependencies, instead of issuing one vtkSMPTools::For (and hence one
+ * fork-join barrier) per pass. A task is started as soon as all the tasks
+ * it depends on are done, so independent work belonging to different passes
+ * can overlap and threads do not idle at each barrier.
+ *
+ * Tasks are spawned with Spawn(), continuations of a single task with
+ * Then(), and several tasks can be joined with WhenAll(). SpawnFor() splits
+ * a range into chunks, one task per chunk, and returns the task joining
+ * them. Nothing is executed until Wait() is called: it runs every task
+ * spawned since the previous Wait() with the vtkSMPTools backend in use and
+ * returns when they are all done.
+ *
+ * A task can only depend on tasks spawned before it, which guarantees the
+ * graph is acyclic. Objects captured by the tasks must outlive Wait().
+ *
+ * Usage example:
+ * \code
+ * vtkSMPTaskGraph graph;
+ * auto count = graph.SpawnFor(0, numCells, 0, [&](vtkIdType begin, vtkIdType end) {
+ *   // count output per cell
+ * });
+ * auto offsets = graph.Then(count, [&]() {
+ *   // prefix sum of the counts
+ * });
+ * auto other = graph.Spawn([&]() {
+ *   // work independent of the counting pass
+ * });
+ * graph.Spawn([&]() {
+ *   // fill the output
+ * }, { offsets, other });
+ * graph.Wait();
+ * \endcode
+ *
+ * Each backend uses its own scheduling: Sequential runs tasks in spawn
+ * order, STDThread uses per-thread work-stealing queues, TBB uses a
+ * tbb::task_group and OpenMP uses OpenMP tasks. As with vtkSMPTools::For,
+ * a graph executed from a parallel scope runs sequentially unless nested
+ * parallelism is enabled.
+ *
+ * @sa
+ * vtkSMPTools
+ */
+
+#ifndef vtkSMPTaskGraph_h
+#define vtkSMPTaskGraph_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkSystemIncludes.h"
+
+#include <algorithm>        // For std::min
+#include <functional>       // For std::function
+#include <initializer_list> // For std::initializer_list
+#include <memory>           // For std::unique_ptr
+#include <type_traits>      // For std::decay
+#include <utility>          // For std::forward
+#include <vector>           // For std::vector
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+VTK_ABI_NAMESPACE_BEGIN
+struct vtkSMPTaskGraphStorage;
+VTK_ABI_NAMESPACE_END
+} // namespace smp
+} // namespace detail
+} // namespace vtk
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+VTK_ABI_NAMESPACE_BEGIN
+class VTKCOMMONCORE_EXPORT vtkSMPTaskGraph
+{
+public:
+  /**
+   * Identifier of a task inside the graph, returned by the spawning methods
+   * and used to express dependencies.
+   */
+  using TaskId = vtkIdType;
+
+  vtkSMPTaskGraph();
+  ~vtkSMPTaskGraph();
+
+  ///@{
+  /**
+   * Spawn a task executing `f()`, optionally after the given tasks are done.
+   * Returns the identifier of the new task.
+   */
+  template <typename Functor>
+  TaskId Spawn(Functor&& f)
+  {
+    return this->AddTask(std::function<void()>(std::forward<Functor>(f)), nullptr, 0);
+  }
+  template <typename Functor>
+  TaskId Spawn(Functor&& f, std::initializer_list<TaskId> dependencies)
+  {
+    return this->AddTask(std::function<void()>(std::forward<Functor>(f)), dependencies.begin(),
+      dependencies.size());
+  }
+  template <typename Functor>
+  TaskId Spawn(Functor&& f, const std::vector<TaskId>& dependencies)
+  {
+    return this->AddTask(std::function<void()>(std::forward<Functor>(f)), dependencies.data(),
+      dependencies.size());
+  }
+  ///@}
+
+  /**
+   * Spawn a continuation: a task executing `f()` once `predecessor` is done.
+   */
+  template <typename Functor>
+  TaskId Then(TaskId predecessor, Functor&& f)
+  {
+    return this->AddTask(std::function<void()>(std::forward<Functor>(f)), &predecessor, 1);
+  }
+
+  ///@{
+  /**
+   * Spawn an empty task completing once all the given tasks are done. This
+   * is how a group of tasks is waited on from inside the graph.
+   */
+  TaskId WhenAll(std::initializer_list<TaskId> tasks)
+  {
+    return this->AddTask(std::function<void()>(), tasks.begin(), tasks.size());
+  }
+  TaskId WhenAll(const std::vector<TaskId>& tasks)
+  {
+    return this->AddTask(std::function<void()>(), tasks.data(), tasks.size());
+  }
+  ///@}
+
+  ///@{
+  /**
+   * Split [first, last) in chunks of `grain` elements and spawn one task per
+   * chunk calling `f(begin, end)`, each one starting once the given
+   * dependencies are done. A copy of the functor is shared by all the chunks.
+   * When grain is not positive, a value giving a few chunks per thread is
+   * used. Returns the identifier of a task completing once all the chunks are
+   * done.
+   */
+  template <typename Functor>
+  TaskId SpawnFor(vtkIdType first, vtkIdType last, vtkIdType grain, Functor&& f)
+  {
+    return this->SpawnFor(first, last, grain, std::forward<Functor>(f), std::vector<TaskId>());
+  }
+  template <typename Functor>
+  TaskId SpawnFor(vtkIdType first, vtkIdType last, vtkIdType grain, Functor&& f,
+    const std::vector<TaskId>& dependencies)
+  {
+    using FunctorType = typename std::decay<Functor>::type;
+    std::shared_ptr<FunctorType> functor = std::make_shared<FunctorType>(std::forward<Functor>(f));
+    if (grain <= 0)
+    {
+      grain = this->GetDefaultGrain(last - first);
+    }
+    std::vector<TaskId> chunks;
+    for (vtkIdType begin = first; begin < last; begin += grain)
+    {
+      const vtkIdType end = std::min(begin + grain, last);
+      chunks.push_back(this->AddTask(
+        [functor, begin, end]() { (*functor)(begin, end); }, dependencies.data(),
+        dependencies.size()));
+    }
+    return chunks.empty() ? this->WhenAll(dependencies) : this->WhenAll(chunks);
+  }
+  ///@}
+
+  /**
+   * Execute all the tasks spawned since the last call to Wait() and block
+   * until they are done. The graph is empty afterwards and can be reused.
+   */
+  void Wait();
+
+  /**
+   * Number of tasks spawned and not yet executed.
+   */
+  vtkIdType GetNumberOfTasks() const;
+
+  vtkSMPTaskGraph(const vtkSMPTaskGraph&) = delete;
+  void operator=(const vtkSMPTaskGraph&) = delete;
+
+private:
+  TaskId AddTask(std::function<void()>&& work, const TaskId* dependencies, std::size_t size);
+  vtkIdType GetDefaultGrain(vtkIdType size) const;
+
+  std::unique_ptr<vtk::detail::smp::vtkSMPTaskGraphStorage> Storage;
+};
+
+VTK_ABI_NAMESPACE_END
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPTaskGraph.h
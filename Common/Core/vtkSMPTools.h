@@ -36,8 +36,11 @@
 #include "SMP/Common/vtkSMPToolsAPI.h"
 #include "vtkSMPThreadLocal.h" // For Initialized
 
+#include <algorithm>   // For std::min, std::max
 #include <functional>  // For std::function
+#include <iterator>    // For std::iterator_traits
 #include <type_traits> // For std:::enable_if
+#include <vector>      // For std::vector
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 namespace vtk
@@ -217,6 +220,60 @@ public:
   typedef vtkSMPTools_RangeFunctor<Iterator, Functor const, init> type;
 };
 
+//--------------------------------------------------------------------------------
+// Deterministic reduction of [first, last). The range is split in blocks whose
+// size only depends on the size of the range, each block is reduced from the
+// identity, then the partial results are combined in block order. Hence the
+// result does not depend on the number of threads nor on the backend.
+template <typename T, typename RangeReduce>
+class vtkSMPTools_ReduceInternal
+{
+public:
+  vtkSMPTools_ReduceInternal(
+    vtkIdType first, vtkIdType last, const T& identity, RangeReduce& reduce)
+    : First(first)
+    , Last(last)
+    , Identity(identity)
+    , Reduce(reduce)
+  {
+    // Blocks of at least 512 elements, and at most 2048 of them.
+    const vtkIdType size = last > first ? last - first : 0;
+    this->BlockSize = std::max<vtkIdType>(512, (size + 2047) / 2048);
+    this->Partials.resize((size + this->BlockSize - 1) / this->BlockSize, identity);
+  }
+
+  vtkIdType GetNumberOfBlocks() const { return static_cast<vtkIdType>(this->Partials.size()); }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      const vtkIdType begin = this->First + block * this->BlockSize;
+      const vtkIdType end = std::min(begin + this->BlockSize, this->Last);
+      this->Reduce(begin, end, this->Partials[block]);
+    }
+  }
+
+  template <typename CombineOp>
+  T Combine(CombineOp& combine) const
+  {
+    T result = this->Identity;
+    for (const T& partial : this->Partials)
+    {
+      result = combine(result, partial);
+    }
+    return result;
+  }
+
+private:
+  vtkIdType First;
+  vtkIdType Last;
+  vtkIdType BlockSize;
+  const T& Identity;
+  RangeReduce& Reduce;
+  std::vector<T> Partials;
+};
+
 template <typename T>
 using resolvedNotInt = typename std::enable_if<!std::is_integral<T>::value, void>::type;
 VTK_ABI_NAMESPACE_END
@@ -411,6 +468,13 @@ public:
    * Note: If VTK_SMP_MAX_THREADS env variable is defined the SMPTools will try
    * to use it to set the maximum number of threads. Initialize() doesn't
    * need to be called.
+   *
+   * Note: With the STDThread backend, the VTK_SMP_THREAD_AFFINITY env
+   * variable pins the threads to cores: "compact" fills the NUMA nodes one
+   * after the other, "scatter" distributes threads round-robin across the
+   * nodes, "numa" binds contiguous groups of threads to the cores of one node
+   * and "none" (the default) does not pin threads. It is read by Initialize(),
+   * which warns about unknown values and leaves the threads unpinned.
    */
   static void Initialize(int numThreads = 0);
 
@@ -581,8 +645,10 @@ public:
 
   /**
    * A convenience method for sorting data. It is a drop in replacement for
-   * std::sort(). Under the hood different methods are used. For example,
-   * tbb::parallel_sort is used in TBB.
+   * std::sort(). Under the hood different methods are used: a parallel merge
+   * sort with STDThread and OpenMP, tbb::parallel_sort with TBB and std::sort
+   * with Sequential. The merge sort copies the range into a buffer of the same
+   * size before sorting, serially, so the elements must be copy constructible.
    */
   template <typename RandomAccessIterator>
   static void Sort(RandomAccessIterator begin, RandomAccessIterator end)
@@ -593,9 +659,10 @@ public:
 
   /**
    * A convenience method for sorting data. It is a drop in replacement for
-   * std::sort(). Under the hood different methods are used. For example,
-   * tbb::parallel_sort is used in TBB. This version of Sort() takes a
-   * comparison class.
+   * std::sort(). Under the hood different methods are used: a parallel merge
+   * sort with STDThread and OpenMP, tbb::parallel_sort with TBB and std::sort
+   * with Sequential. This version of Sort() takes a comparison class. The
+   * elements must be copy constructible, see above.
    */
   template <typename RandomAccessIterator, typename Compare>
   static void Sort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
@@ -603,6 +670,301 @@ public:
     auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
     SMPToolsAPI.Sort(begin, end, comp);
   }
+
+  ///@{
+  /**
+   * A convenience method for sorting data while preserving the relative order
+   * of equivalent elements. It is a drop in replacement for std::stable_sort().
+   * Except with the Sequential backend, the range is split in one run per
+   * thread, runs are sorted concurrently and then merged in parallel. A buffer
+   * of the size of the range is allocated and initialized with a serial copy
+   * of the range, so the elements must be copy constructible.
+   */
+  template <typename RandomAccessIterator>
+  static void StableSort(RandomAccessIterator begin, RandomAccessIterator end)
+  {
+    using ValueType = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    vtkSMPTools::StableSort(begin, end, std::less<ValueType>());
+  }
+  template <typename RandomAccessIterator, typename Compare>
+  static void StableSort(RandomAccessIterator begin, RandomAccessIterator end, Compare comp)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    SMPToolsAPI.StableSort(begin, end, comp);
+  }
+  ///@}
+
+  ///@{
+  /**
+   * Sort a contiguous array of integral or floating point keys in ascending
+   * order with a parallel least significant digit radix sort. When `values`
+   * is given, it must hold as many elements as there are keys and is permuted
+   * along with the keys, which makes it possible to compute sorting
+   * permutations. The sort is stable.
+   *
+   * The cost is linear in the number of keys, with one pass over the data per
+   * byte of the key type that is not the same for all the keys, so it is
+   * usually much faster than a comparison sort on large arrays. Negative zero
+   * is ordered before positive zero, and NaN values are moved to the ends of
+   * the array. Two temporary buffers of the size of the keys (and one of the
+   * size of the values) are allocated.
+   *
+   * There is no descending variant: reversing the sorted keys gives a
+   * descending order in which equal keys, hence their values, appear in the
+   * reverse of their original order.
+   *
+   * Usage example:
+   * \code
+   * std::vector<float> keys = ...;
+   * std::vector<vtkIdType> ids(keys.size());
+   * std::iota(ids.begin(), ids.end(), 0);
+   * vtkSMPTools::RadixSort(keys.data(), keys.data() + keys.size(), ids.data());
+   * \endcode
+   */
+  template <typename KeyT>
+  static void RadixSort(KeyT* keysBegin, KeyT* keysEnd)
+  {
+    vtkSMPTools::RadixSort(keysBegin, keysEnd, static_cast<KeyT*>(nullptr));
+  }
+  template <typename KeyT, typename ValueT>
+  static void RadixSort(KeyT* keysBegin, KeyT* keysEnd, ValueT* values)
+  {
+    static_assert(std::is_arithmetic<KeyT>::value && !std::is_same<KeyT, bool>::value &&
+        !std::is_same<KeyT, long double>::value,
+      "RadixSort requires integral or floating point keys.");
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    SMPToolsAPI.RadixSort(keysBegin, keysEnd, values);
+  }
+  ///@}
+
+  /**
+   * A parallel reduction of the range [first, last) with typed partial
+   * results. The range is split in blocks, `reduce(begin, end, partial)`
+   * accumulates the elements of [begin, end) into `partial` (initialized to
+   * `identity`) and the partial results are merged with
+   * `combine(partial0, partial1)`, which must be associative and return the
+   * merged value. `identity` must be neutral for `combine`.
+   *
+   * The blocks only depend on the size of the range and the partial results
+   * are always combined in the same order, so the result is bit-reproducible
+   * whatever the number of threads and the backend, including for floating
+   * point sums. This replaces the vtkSMPThreadLocal + Reduce() pattern, whose
+   * result depends on how the work was scheduled.
+   *
+   * `reduce` is called concurrently and must not modify shared state.
+   *
+   * Usage example:
+   * \code
+   * using Bounds = std::array<double, 2>;
+   * Bounds range = vtkSMPTools::Reduce(0, numValues, Bounds{ VTK_DOUBLE_MAX, VTK_DOUBLE_MIN },
+   *   [&](vtkIdType begin, vtkIdType end, Bounds& r) {
+   *     for (; begin < end; ++begin)
+   *     {
+   *       r[0] = std::min(r[0], values[begin]);
+   *       r[1] = std::max(r[1], values[begin]);
+   *     }
+   *   },
+   *   [](const Bounds& r0, const Bounds& r1) {
+   *     return Bounds{ std::min(r0[0], r1[0]), std::max(r0[1], r1[1]) };
+   *   });
+   * \endcode
+   */
+  template <typename T, typename RangeReduce, typename Combine>
+  static T Reduce(
+    vtkIdType first, vtkIdType last, const T& identity, RangeReduce&& reduce, Combine combine)
+  {
+    using ReduceT = typename std::remove_reference<RangeReduce>::type;
+    vtk::detail::smp::vtkSMPTools_ReduceInternal<T, ReduceT> reducer(
+      first, last, identity, reduce);
+    vtkSMPTools::For(0, reducer.GetNumberOfBlocks(), 1, reducer);
+    return reducer.Combine(combine);
+  }
+
+  ///@{
+  /**
+   * A parallel reduction of a range of values. It is a drop in replacement
+   * for std::reduce() and std::transform_reduce(): `transform` is applied to
+   * each value and the results are combined with `init` using the binary
+   * operation (addition by default), which must be associative.
+   *
+   * As for the Reduce() overload above, the values are always combined in the
+   * same order whatever the number of threads, so the result is
+   * bit-reproducible.
+   *
+   * Usage example:
+   * \code
+   * auto values = vtk::DataArrayValueRange<1>(array);
+   * double sumOfSquares = vtkSMPTools::TransformReduce(values.cbegin(), values.cend(), 0.0,
+   *   std::plus<double>(), [](double x) { return x * x; });
+   * \endcode
+   */
+  template <typename Iterator, typename T>
+  static T Reduce(Iterator begin, Iterator end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init, std::plus<T>());
+  }
+
+  template <typename Iterator, typename T, typename BinaryOp>
+  static T Reduce(Iterator begin, Iterator end, T init, BinaryOp op)
+  {
+    return vtkSMPTools::TransformReduce(
+      begin, end, init, op, vtk::detail::smp::ScanIdentity());
+  }
+
+  template <typename Iterator, typename T, typename BinaryOp, typename UnaryOp>
+  static T TransformReduce(Iterator begin, Iterator end, T init, BinaryOp op, UnaryOp transform)
+  {
+    // Each block is reduced from its first value, init is only used once.
+    auto reduce = [&](vtkIdType first, vtkIdType last, T& partial) {
+      Iterator it = begin;
+      std::advance(it, first);
+      partial = transform(*it);
+      for (++first, ++it; first < last; ++first, ++it)
+      {
+        partial = op(partial, transform(*it));
+      }
+    };
+    return vtkSMPTools::Reduce(vtkIdType(0), static_cast<vtkIdType>(std::distance(begin, end)),
+      init, reduce, op);
+  }
+  ///@}
+
+  ///@{
+  /**
+   * A parallel exclusive prefix scan. It is a drop in replacement for
+   * std::exclusive_scan(): the ith output value is `init` combined with the
+   * input values preceding i. The binary operation (addition by default)
+   * must be associative. The input and output ranges can be the same, in
+   * which case the scan is done in place.
+   *
+   * Contrary to std::exclusive_scan(), the combination of `init` with all the
+   * input values is returned. This is typically the total size to allocate
+   * once per-cell (or per-thread) counts have been turned into offsets.
+   *
+   * Usage example:
+   * \code
+   * // counts has numCells values, offsets numCells + 1
+   * offsets[numCells] =
+   *   vtkSMPTools::ExclusiveScan(counts.begin(), counts.end(), offsets.begin(), vtkIdType(0));
+   * \endcode
+   */
+  template <typename InputIt, typename OutputIt, typename T>
+  static T ExclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init)
+  {
+    return vtkSMPTools::ExclusiveScan(inBegin, inEnd, outBegin, init, std::plus<T>());
+  }
+
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static T ExclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init, BinaryOp op)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    return SMPToolsAPI.Scan(inBegin, inEnd, outBegin, vtk::detail::smp::NoScanSegments(), init,
+      op, vtk::detail::smp::ScanIdentity(), false);
+  }
+  ///@}
+
+  ///@{
+  /**
+   * A parallel inclusive prefix scan. It is a drop in replacement for
+   * std::inclusive_scan(): the ith output value is `init` combined with the
+   * input values up to and including i. The binary operation (addition by
+   * default) must be associative and `init` (value initialized by default)
+   * should be its identity. The input and output ranges can be the same.
+   * Returns the last output value, i.e. the combination of all the inputs.
+   */
+  template <typename InputIt, typename OutputIt>
+  static typename std::iterator_traits<OutputIt>::value_type InclusiveScan(
+    InputIt inBegin, InputIt inEnd, OutputIt outBegin)
+  {
+    using T = typename std::iterator_traits<OutputIt>::value_type;
+    return vtkSMPTools::InclusiveScan(inBegin, inEnd, outBegin, std::plus<T>(), T());
+  }
+
+  template <typename InputIt, typename OutputIt, typename BinaryOp, typename T>
+  static T InclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, BinaryOp op, T init)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    return SMPToolsAPI.Scan(inBegin, inEnd, outBegin, vtk::detail::smp::NoScanSegments(), init,
+      op, vtk::detail::smp::ScanIdentity(), true);
+  }
+  ///@}
+
+  /**
+   * A parallel exclusive prefix scan of transformed input values. It is a
+   * drop in replacement for std::transform_exclusive_scan(): `transform` is
+   * applied to each input value before it is combined. As for
+   * ExclusiveScan(), the scan can be done in place and the combination of
+   * `init` with all the transformed values is returned.
+   *
+   * Usage example:
+   * \code
+   * // Map kept points (flagged with a positive value) to output ids
+   * vtkIdType numKeptPts = vtkSMPTools::TransformExclusiveScan(map.begin(), map.end(),
+   *   map.begin(), vtkIdType(0), std::plus<vtkIdType>(),
+   *   [](vtkIdType flag) -> vtkIdType { return flag > 0 ? 1 : 0; });
+   * \endcode
+   */
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp, typename UnaryOp>
+  static T TransformExclusiveScan(InputIt inBegin, InputIt inEnd, OutputIt outBegin, T init,
+    BinaryOp op, UnaryOp transform)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    return SMPToolsAPI.Scan(inBegin, inEnd, outBegin, vtk::detail::smp::NoScanSegments(), init,
+      op, transform, false);
+  }
+
+  ///@{
+  /**
+   * Parallel segmented prefix scans. The input is split in independent
+   * segments: each input value whose flag (in the range starting at
+   * `flagsBegin`) is non zero starts a new segment, and each segment is
+   * scanned as by ExclusiveScan() or InclusiveScan() starting from `init`.
+   * Returns the value accumulated over the last segment.
+   *
+   * Usage example:
+   * \code
+   * // Number each point within its own bin, bins being flagged by their first point
+   * vtkSMPTools::SegmentedExclusiveScan(
+   *   ones.begin(), ones.end(), binStarts.begin(), localIds.begin(), vtkIdType(0));
+   * \endcode
+   */
+  template <typename InputIt, typename FlagIt, typename OutputIt, typename T>
+  static T SegmentedExclusiveScan(
+    InputIt inBegin, InputIt inEnd, FlagIt flagsBegin, OutputIt outBegin, T init)
+  {
+    return vtkSMPTools::SegmentedExclusiveScan(
+      inBegin, inEnd, flagsBegin, outBegin, init, std::plus<T>());
+  }
+
+  template <typename InputIt, typename FlagIt, typename OutputIt, typename T, typename BinaryOp>
+  static T SegmentedExclusiveScan(
+    InputIt inBegin, InputIt inEnd, FlagIt flagsBegin, OutputIt outBegin, T init, BinaryOp op)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    return SMPToolsAPI.Scan(inBegin, inEnd, outBegin,
+      vtk::detail::smp::ScanSegments<FlagIt>(flagsBegin), init, op,
+      vtk::detail::smp::ScanIdentity(), false);
+  }
+
+  template <typename InputIt, typename FlagIt, typename OutputIt>
+  static typename std::iterator_traits<OutputIt>::value_type SegmentedInclusiveScan(
+    InputIt inBegin, InputIt inEnd, FlagIt flagsBegin, OutputIt outBegin)
+  {
+    using T = typename std::iterator_traits<OutputIt>::value_type;
+    return vtkSMPTools::SegmentedInclusiveScan(
+      inBegin, inEnd, flagsBegin, outBegin, std::plus<T>(), T());
+  }
+
+  template <typename InputIt, typename FlagIt, typename OutputIt, typename BinaryOp, typename T>
+  static T SegmentedInclusiveScan(
+    InputIt inBegin, InputIt inEnd, FlagIt flagsBegin, OutputIt outBegin, BinaryOp op, T init)
+  {
+    auto& SMPToolsAPI = vtk::detail::smp::vtkSMPToolsAPI::GetInstance();
+    return SMPToolsAPI.Scan(inBegin, inEnd, outBegin,
+      vtk::detail::smp::ScanSegments<FlagIt>(flagsBegin), init, op,
+      vtk::detail::smp::ScanIdentity(), true);
+  }
+  ///@}
 };
 
 VTK_ABI_NAMESPACE_END
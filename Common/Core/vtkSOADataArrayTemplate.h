@@ -197,6 +197,13 @@ public:
    */
   ValueType* GetComponentArrayPointer(int comp);
 
+  /**
+   * Return true if the values are stored in one contiguous block of memory
+   * per component, i.e. if GetComponentArrayPointer() can be used. This is
+   * no longer the case once GetVoidPointer() has been called.
+   */
+  bool HasComponentArrays() const { return this->StorageType == StorageTypeEnum::SOA; }
+
   /**
    * Use of this method is discouraged, it creates a deep copy of the data into
    * a contiguous AoS-ordered buffer and prints a warning.
@@ -308,6 +315,7 @@ VTK_ABI_NAMESPACE_END
   {                                                                                                \
   VTK_ABI_NAMESPACE_BEGIN                                                                          \
   VTK_INSTANTIATE_VALUERANGE_ARRAYTYPE(vtkSOADataArrayTemplate<T>, double);                        \
+  VTK_INSTANTIATE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkSOADataArrayTemplate<T>);                         \
   VTK_ABI_NAMESPACE_END                                                                            \
   }                                                                                                \
   VTK_ABI_NAMESPACE_BEGIN                                                                          \
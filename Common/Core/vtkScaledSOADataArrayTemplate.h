@@ -306,6 +306,7 @@ VTK_ABI_NAMESPACE_END
   {                                                                                                \
   VTK_ABI_NAMESPACE_BEGIN                                                                          \
   VTK_INSTANTIATE_VALUERANGE_ARRAYTYPE(vtkScaledSOADataArrayTemplate<T>, double);                  \
+  VTK_INSTANTIATE_VALUERANGE_BLOCKS_ARRAYTYPE(vtkScaledSOADataArrayTemplate<T>);                   \
   VTK_ABI_NAMESPACE_END                                                                            \
   }                                                                                                \
   VTK_ABI_NAMESPACE_BEGIN                                                                          \
@@ -33,9 +33,62 @@
 #include "vtkStringArray.h"
 #include "vtkVariant.h"
 #include "vtkVariantArray.h"
-#include <functional> //std::greater
+#include <algorithm>   //std::reverse
+#include <functional>  //std::greater
+#include <type_traits> //std::is_arithmetic
+#include <vector>      //std::vector
 
 //------------------------------------------------------------------------------
+namespace
+{
+
+//------------------------------------------------------------------------------
+// Reverse an array in parallel, used to produce descending orders from the
+// ascending radix sort.
+template <typename T>
+void ReverseArray(T* data, vtkIdType num)
+{
+  vtkSMPTools::For(0, num / 2, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      std::swap(data[i], data[num - 1 - i]);
+    }
+  });
+}
+
+//------------------------------------------------------------------------------
+// Arithmetic keys are sorted with a radix sort, other keys (strings) with a
+// comparison sort.
+template <typename T>
+void SortKeys(T* data, vtkIdType num, int dir, std::true_type)
+{
+  vtkSMPTools::RadixSort(data, data + num);
+  if (dir != 0)
+  {
+    ReverseArray(data, num);
+  }
+}
+
+template <typename T>
+void SortKeys(T* data, vtkIdType num, int dir, std::false_type)
+{
+  if (dir == 0)
+  {
+    vtkSMPTools::Sort(data, data + num);
+  }
+  else
+  {
+    vtkSMPTools::Sort(data, data + num, std::greater<T>());
+  }
+}
+
+template <typename T>
+void SortKeys(T* data, vtkIdType num, int dir)
+{
+  SortKeys(data, num, dir, typename std::is_arithmetic<T>::type());
+}
+
+} // anonymous namespace
 
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkSortDataArray);
@@ -55,14 +108,7 @@ void vtkSortDataArray::Sort(vtkIdList* keys, int dir)
   }
   vtkIdType* data = keys->GetPointer(0);
   vtkIdType numKeys = keys->GetNumberOfIds();
-  if (dir == 0)
-  {
-    vtkSMPTools::Sort(data, data + numKeys);
-  }
-  else
-  {
-    vtkSMPTools::Sort(data, data + numKeys, std::greater<vtkIdType>());
-  }
+  SortKeys(data, numKeys, dir);
 }
 
 //------------------------------------------------------------------------------
@@ -82,21 +128,9 @@ void vtkSortDataArray::Sort(vtkAbstractArray* keys, int dir)
   void* data = keys->GetVoidPointer(0);
   vtkIdType numKeys = keys->GetNumberOfTuples();
 
-  if (dir == 0)
-  {
-    switch (keys->GetDataType())
-    {
-      vtkExtendedTemplateMacro(
-        vtkSMPTools::Sort(static_cast<VTK_TT*>(data), static_cast<VTK_TT*>(data) + numKeys));
-    }
-  }
-  else
+  switch (keys->GetDataType())
   {
-    switch (keys->GetDataType())
-    {
-      vtkExtendedTemplateMacro(vtkSMPTools::Sort(
-        static_cast<VTK_TT*>(data), static_cast<VTK_TT*>(data) + numKeys, std::greater<VTK_TT>()));
-    }
+    vtkExtendedTemplateMacro(SortKeys(static_cast<VTK_TT*>(data), numKeys, dir));
   }
 }
 VTK_ABI_NAMESPACE_END
@@ -142,6 +176,42 @@ struct TupleComp
   }
 };
 
+//------------------------------------------------------------------------------
+// Sort the indices based on the k-th component of the tuples they refer to.
+// Arithmetic keys are gathered in a temporary array which is radix sorted
+// along with the indices; other keys use a comparison sort of the indices.
+template <typename T>
+void SortIndices(T* array, vtkIdType numKeys, int numComp, int k, vtkIdType* idx, std::true_type)
+{
+  std::vector<T> keys(numKeys);
+  vtkSMPTools::For(0, numKeys, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      keys[i] = array[idx[i] * numComp + k];
+    }
+  });
+  vtkSMPTools::RadixSort(keys.data(), keys.data() + numKeys, idx);
+}
+
+template <typename T>
+void SortIndices(T* array, vtkIdType numKeys, int numComp, int k, vtkIdType* idx, std::false_type)
+{
+  if (numComp == 1)
+  {
+    vtkSMPTools::Sort(idx, idx + numKeys, KeyComp<T>(array));
+  }
+  else
+  {
+    vtkSMPTools::Sort(idx, idx + numKeys, TupleComp<T>(array, numComp, k));
+  }
+}
+
+template <typename T>
+void SortIndices(T* array, vtkIdType numKeys, int numComp, int k, vtkIdType* idx)
+{
+  SortIndices(array, numKeys, numComp, k, idx, typename std::is_arithmetic<T>::type());
+}
+
 //------------------------------------------------------------------------------
 // Given a set of indices (after sorting), copy the data from a pre-sorted
 // array to a final, post-sorted array, Implementation note: the direction of
@@ -154,21 +224,23 @@ void Shuffle1Tuples(vtkIdType* idx, vtkIdType sze, vtkAbstractArray* arrayIn, T*
 {
   T* postSort = new T[sze];
 
-  if (dir == 0) // ascending
-  {
-    for (vtkIdType i = 0; i < sze; ++i)
+  vtkSMPTools::For(0, sze, [&](vtkIdType begin, vtkIdType end) {
+    if (dir == 0) // ascending
     {
-      postSort[i] = preSort[idx[i]];
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        postSort[i] = preSort[idx[i]];
+      }
     }
-  }
-  else
-  {
-    vtkIdType end = sze - 1;
-    for (vtkIdType i = 0; i < sze; ++i)
+    else
     {
-      postSort[i] = preSort[idx[end - i]];
+      const vtkIdType last = sze - 1;
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        postSort[i] = preSort[idx[last - i]];
+      }
     }
-  }
+  });
 
   arrayIn->SetVoidArray(postSort, sze, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
 }
@@ -183,29 +255,17 @@ void ShuffleTuples(
 {
   T* postSort = new T[sze * numComp];
 
-  int k;
-  vtkIdType i;
-  if (dir == 0) // ascending
-  {
-    for (i = 0; i < sze; ++i)
-    {
-      for (k = 0; k < numComp; ++k)
-      {
-        postSort[i * numComp + k] = preSort[idx[i] * numComp + k];
-      }
-    }
-  }
-  else
-  {
-    vtkIdType end = sze - 1;
-    for (i = 0; i < sze; ++i)
+  vtkSMPTools::For(0, sze, [&](vtkIdType begin, vtkIdType end) {
+    const vtkIdType last = sze - 1;
+    for (vtkIdType i = begin; i < end; ++i)
     {
-      for (k = 0; k < numComp; ++k)
+      const vtkIdType source = (dir == 0 ? idx[i] : idx[last - i]);
+      for (int k = 0; k < numComp; ++k)
       {
-        postSort[i * numComp + k] = preSort[idx[end - i] * numComp + k];
+        postSort[i * numComp + k] = preSort[source * numComp + k];
       }
     }
-  }
+  });
 
   arrayIn->SetVoidArray(postSort, sze * numComp, 0, vtkAbstractArray::VTK_DATA_ARRAY_DELETE);
 }
@@ -218,10 +278,12 @@ VTK_ABI_NAMESPACE_BEGIN
 vtkIdType* vtkSortDataArray::InitializeSortIndices(vtkIdType num)
 {
   vtkIdType* idx = new vtkIdType[num];
-  for (vtkIdType i = 0; i < num; ++i)
-  {
-    idx[i] = i;
-  }
+  vtkSMPTools::For(0, num, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      idx[i] = i;
+    }
+  });
   return idx;
 }
 
@@ -239,8 +301,7 @@ void vtkSortDataArray::GenerateSort1Indices(
   {
     switch (dataType)
     {
-      vtkExtendedTemplateMacro(
-        vtkSMPTools::Sort(idx, idx + numKeys, KeyComp<VTK_TT>(static_cast<VTK_TT*>(dataIn))));
+      vtkExtendedTemplateMacro(SortIndices(static_cast<VTK_TT*>(dataIn), numKeys, 1, 0, idx));
     }
   }
 }
@@ -265,8 +326,8 @@ void vtkSortDataArray::GenerateSortIndices(
   {
     switch (dataType)
     {
-      vtkExtendedTemplateMacro(vtkSMPTools::Sort(
-        idx, idx + numKeys, TupleComp<VTK_TT>(static_cast<VTK_TT*>(dataIn), numComp, k)));
+      vtkExtendedTemplateMacro(
+        SortIndices(static_cast<VTK_TT*>(dataIn), numKeys, numComp, k, idx));
     }
   }
 }
@@ -324,21 +385,13 @@ void vtkSortDataArray::ShuffleIdList(
 {
   vtkIdType* postSort = new vtkIdType[sze];
 
-  if (dir == 0) // ascending
-  {
-    for (vtkIdType i = 0; i < sze; ++i)
+  vtkSMPTools::For(0, sze, [&](vtkIdType begin, vtkIdType end) {
+    const vtkIdType last = sze - 1;
+    for (vtkIdType i = begin; i < end; ++i)
     {
-      postSort[i] = preSort[idx[i]];
+      postSort[i] = preSort[idx[dir == 0 ? i : last - i]];
     }
-  }
-  else
-  {
-    vtkIdType end = sze - 1;
-    for (vtkIdType i = 0; i < sze; ++i)
-    {
-      postSort[i] = preSort[idx[end - i]];
-    }
-  }
+  });
 
   arrayIn->SetArray(postSort, sze);
 }
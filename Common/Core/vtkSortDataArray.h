@@ -122,7 +122,10 @@ public:
    * Sorts the given key/value pairs based on the keys (the keys are expected
    * to be 1-tuples, values may have number of components >= 1).
    * Obviously, the two arrays must be of equal size. Sorts in either
-   * ascending (dir=0) or descending (dir=1) order.
+   * ascending (dir=0) or descending (dir=1) order. With arithmetic keys, the
+   * ascending sort is stable, and the descending order is the reverse of the
+   * ascending one: the values of equal keys end up in the reverse of their
+   * original order. The order of equal string or variant keys is unspecified.
    */
   static void Sort(vtkAbstractArray* keys, vtkAbstractArray* values, int dir);
   static void Sort(vtkAbstractArray* keys, vtkIdList* values, int dir);
@@ -16,13 +16,20 @@
 #include "vtkGenericCell.h"
 #include "vtkPointData.h"
 
+#include "vtkCellArray.h"
 #include "vtkCellTreeLocator.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
 #include "vtkNew.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSphereSource.h"
 
 #include "vtkDebugLeaks.h"
 
+#include <algorithm>
+
 int TestWithCachedCellBoundsParameter(int cachedCellBounds)
 {
   // kuhnan's sample code used to test
@@ -98,9 +105,76 @@ int TestWithCachedCellBoundsParameter(int cachedCellBounds)
   return EXIT_SUCCESS;
 }
 
+// Build the locator with numberOfThreads threads and return the bounds of
+// its leaves.
+void BuildLeaves(vtkCellTreeLocator* locator, int numberOfThreads, vtkPolyData* leaves)
+{
+  vtkSMPTools::LocalScope(
+    vtkSMPTools::Config{ numberOfThreads }, [&]() { locator->ForceBuildLocator(); });
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkIntArray> levels;
+  leaves->SetPoints(points);
+  leaves->SetLines(lines);
+  leaves->GetPointData()->AddArray(levels);
+  locator->GenerateRepresentation(-1, leaves);
+}
+
+int TestThreadedBuild()
+{
+  // Large enough for the top of the tree to be split in parallel
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(400);
+  sphere->SetPhiResolution(400);
+  sphere->Update();
+
+  vtkNew<vtkCellTreeLocator> locator;
+  locator->SetDataSet(sphere->GetOutput());
+  vtkNew<vtkPolyData> serialLeaves;
+  BuildLeaves(locator, 1, serialLeaves);
+  vtkNew<vtkIdList> serialCells;
+  double bbox[6] = { -0.3, 0.1, 0.2, 0.6, 0.0, 1.0 };
+  locator->FindCellsWithinBounds(bbox, serialCells);
+
+  vtkNew<vtkPolyData> threadedLeaves;
+  BuildLeaves(locator, 4, threadedLeaves);
+  vtkNew<vtkIdList> threadedCells;
+  locator->FindCellsWithinBounds(bbox, threadedCells);
+
+  // The trees must be identical
+  vtkPoints* serialPoints = serialLeaves->GetPoints();
+  vtkPoints* threadedPoints = threadedLeaves->GetPoints();
+  if (serialPoints->GetNumberOfPoints() != threadedPoints->GetNumberOfPoints())
+  {
+    std::cerr << "The threaded build has " << threadedPoints->GetNumberOfPoints() / 8
+              << " leaves instead of " << serialPoints->GetNumberOfPoints() / 8 << std::endl;
+    return EXIT_FAILURE;
+  }
+  double x[3], y[3];
+  for (vtkIdType i = 0; i < serialPoints->GetNumberOfPoints(); ++i)
+  {
+    serialPoints->GetPoint(i, x);
+    threadedPoints->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      std::cerr << "The leaf " << i / 8 << " of the threaded build differs" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (serialCells->GetNumberOfIds() == 0 ||
+    serialCells->GetNumberOfIds() != threadedCells->GetNumberOfIds() ||
+    !std::equal(serialCells->begin(), serialCells->end(), threadedCells->begin()))
+  {
+    std::cerr << "FindCellsWithinBounds differs after the threaded build" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
 int CellTreeLocator(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
   int retVal = TestWithCachedCellBoundsParameter(0);
   retVal += TestWithCachedCellBoundsParameter(1);
+  retVal += TestThreadedBuild();
   return retVal;
 }
@@ -0,0 +1,320 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the queries of vtkBVHCellLocator with brute force searches over
+// all the cells of a triangle soup mixing very small and large triangles,
+// and with vtkStaticCellLocator on an image.
+
+#include "vtkBVHCellLocator.h"
+#include "vtkBox.h"
+#include "vtkBoundingBox.h"
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticCellLocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+// Triangles with sizes ranging over four orders of magnitude, some of them
+// lying in axis-aligned planes.
+void GenerateTriangles(vtkIdType numTris, vtkPolyData* polyData)
+{
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> position(-1.0, 1.0);
+  std::uniform_real_distribution<double> exponent(-4.0, 0.0);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkCellArray> tris;
+  for (vtkIdType triId = 0; triId < numTris; ++triId)
+  {
+    const double center[3] = { position(gen), position(gen), position(gen) };
+    const double size = std::pow(10.0, exponent(gen));
+    vtkIdType ptIds[3];
+    for (int i = 0; i < 3; ++i)
+    {
+      double x[3] = { center[0] + size * position(gen), center[1] + size * position(gen),
+        center[2] + size * position(gen) };
+      if (triId % 10 == 0)
+      {
+        x[2] = center[2];
+      }
+      ptIds[i] = points->InsertNextPoint(x);
+    }
+    tris->InsertNextCell(3, ptIds);
+  }
+  polyData->SetPoints(points);
+  polyData->SetPolys(tris);
+}
+
+struct Hit
+{
+  vtkIdType CellId = -1;
+  double T = VTK_DOUBLE_MAX;
+  double X[3] = { 0.0, 0.0, 0.0 };
+};
+
+// The closest intersection over all the cells, ties resolved with the
+// smallest cell id.
+Hit BruteForceIntersectWithLine(vtkDataSet* ds, const double p1[3], const double p2[3], double tol)
+{
+  vtkNew<vtkGenericCell> cell;
+  const double dir[3] = { p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] };
+  double bounds[6], xBox[3], tBox, t, x[3], pcoords[3];
+  int subId;
+  Hit hit;
+  for (vtkIdType cellId = 0; cellId < ds->GetNumberOfCells(); ++cellId)
+  {
+    ds->GetCellBounds(cellId, bounds);
+    if (!vtkBox::IntersectBox(bounds, p1, dir, xBox, tBox, tol))
+    {
+      continue;
+    }
+    ds->GetCell(cellId, cell);
+    if (cell->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId) &&
+      (t < hit.T || (t == hit.T && cellId < hit.CellId)))
+    {
+      hit.CellId = cellId;
+      hit.T = t;
+      std::copy_n(x, 3, hit.X);
+    }
+  }
+  return hit;
+}
+
+bool TestIntersectWithLine(vtkPolyData* polyData, vtkBVHCellLocator* locator)
+{
+  const vtkIdType numLines = 500;
+  const double tol = 1e-8;
+  std::mt19937 gen(2);
+  std::uniform_real_distribution<double> position(-1.5, 1.5);
+  vtkNew<vtkPoints> p1s;
+  p1s->SetDataTypeToDouble();
+  vtkNew<vtkPoints> p2s;
+  p2s->SetDataTypeToDouble();
+  for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
+  {
+    p1s->InsertNextPoint(position(gen), position(gen), position(gen));
+    p2s->InsertNextPoint(position(gen), position(gen), position(gen));
+  }
+
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkDoubleArray> tValues;
+  vtkNew<vtkPoints> xPoints;
+  xPoints->SetDataTypeToDouble();
+  locator->IntersectWithLines(p1s, p2s, tol, cellIds, tValues, xPoints);
+
+  vtkNew<vtkGenericCell> cell;
+  vtkNew<vtkIdList> allCellIds;
+  double p1[3], p2[3], t, x[3], xBatch[3], pcoords[3];
+  int subId;
+  vtkIdType cellId, numHits = 0;
+  for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
+  {
+    p1s->GetPoint(lineId, p1);
+    p2s->GetPoint(lineId, p2);
+    const Hit expected = BruteForceIntersectWithLine(polyData, p1, p2, tol);
+    if (!locator->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId, cell))
+    {
+      cellId = -1;
+    }
+    if (cellId != expected.CellId || (cellId >= 0 && (t != expected.T || x[0] != expected.X[0])))
+    {
+      std::cerr << "IntersectWithLine differs for line " << lineId << ": " << cellId
+                << " instead of " << expected.CellId << std::endl;
+      return false;
+    }
+    xPoints->GetPoint(lineId, xBatch);
+    if (cellIds->GetId(lineId) != cellId ||
+      (cellId >= 0 &&
+        (tValues->GetValue(lineId) != t || xBatch[0] != x[0] || xBatch[1] != x[1] ||
+          xBatch[2] != x[2])))
+    {
+      std::cerr << "IntersectWithLines differs for line " << lineId << ": "
+                << cellIds->GetId(lineId) << " instead of " << cellId << std::endl;
+      return false;
+    }
+    numHits += (cellId >= 0 ? 1 : 0);
+
+    // All the intersections, sorted by t then cell id
+    locator->IntersectWithLine(p1, p2, tol, nullptr, allCellIds, cell);
+    if (allCellIds->GetNumberOfIds() > 0 && allCellIds->GetId(0) != cellId)
+    {
+      std::cerr << "IntersectWithLine returned " << allCellIds->GetId(0)
+                << " as first intersection of line " << lineId << " instead of " << cellId
+                << std::endl;
+      return false;
+    }
+    if ((allCellIds->GetNumberOfIds() > 0) != (cellId >= 0))
+    {
+      std::cerr << "IntersectWithLine returned " << allCellIds->GetNumberOfIds()
+                << " intersections for line " << lineId << std::endl;
+      return false;
+    }
+  }
+  if (numHits == 0 || numHits == numLines)
+  {
+    std::cerr << "IntersectWithLine hit " << numHits << " lines" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestFindClosestPoint(vtkPolyData* polyData, vtkBVHCellLocator* locator)
+{
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> position(-1.5, 1.5);
+  vtkNew<vtkGenericCell> cell;
+  std::vector<double> weights(3);
+  double x[3], closestPoint[3], dist2, pcoords[3], point[3], cellDist2;
+  int subId;
+  vtkIdType cellId;
+  for (int i = 0; i < 200; ++i)
+  {
+    x[0] = position(gen);
+    x[1] = position(gen);
+    x[2] = position(gen);
+    locator->FindClosestPoint(x, closestPoint, cell, cellId, subId, dist2);
+    double expected = VTK_DOUBLE_MAX;
+    for (vtkIdType id = 0; id < polyData->GetNumberOfCells(); ++id)
+    {
+      polyData->GetCell(id, cell);
+      if (cell->EvaluatePosition(x, point, subId, pcoords, cellDist2, weights.data()) != -1)
+      {
+        expected = std::min(expected, cellDist2);
+      }
+    }
+    if (dist2 != expected || vtkMath::Distance2BetweenPoints(x, closestPoint) > 1.0001 * dist2)
+    {
+      std::cerr << "FindClosestPoint returned a squared distance of " << dist2 << " instead of "
+                << expected << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TestFindCellsWithinBounds(vtkPolyData* polyData, vtkBVHCellLocator* locator)
+{
+  double bbox[6] = { -0.3, 0.2, -0.1, 0.4, 0.0, 0.25 };
+  vtkNew<vtkIdList> cells;
+  locator->FindCellsWithinBounds(bbox, cells);
+  std::vector<vtkIdType> found(cells->begin(), cells->end());
+  std::sort(found.begin(), found.end());
+
+  vtkBoundingBox testBox(bbox);
+  std::vector<vtkIdType> expected;
+  double bounds[6];
+  for (vtkIdType cellId = 0; cellId < polyData->GetNumberOfCells(); ++cellId)
+  {
+    polyData->GetCellBounds(cellId, bounds);
+    if (testBox.Intersects(vtkBoundingBox(bounds)))
+    {
+      expected.push_back(cellId);
+    }
+  }
+  if (found != expected || expected.empty())
+  {
+    std::cerr << "FindCellsWithinBounds found " << found.size() << " cells instead of "
+              << expected.size() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestFindCell()
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(21, 21, 21);
+  image->SetSpacing(0.1, 0.1, 0.1);
+  vtkNew<vtkBVHCellLocator> locator;
+  locator->SetDataSet(image);
+  locator->BuildLocator();
+  vtkNew<vtkStaticCellLocator> staticLocator;
+  staticLocator->SetDataSet(image);
+  staticLocator->BuildLocator();
+
+  std::mt19937 gen(4);
+  std::uniform_real_distribution<double> position(-0.5, 2.5);
+  double x[3];
+  for (int i = 0; i < 1000; ++i)
+  {
+    x[0] = position(gen);
+    x[1] = position(gen);
+    x[2] = position(gen);
+    const vtkIdType cellId = locator->FindCell(x);
+    const vtkIdType expected = staticLocator->FindCell(x);
+    if (cellId != expected)
+    {
+      std::cerr << "FindCell returned " << cellId << " instead of " << expected << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestBVHCellLocator(int, char*[])
+{
+  vtkNew<vtkPolyData> polyData;
+  GenerateTriangles(20000, polyData);
+
+  vtkNew<vtkBVHCellLocator> locator;
+  locator->SetDataSet(polyData);
+  locator->BuildLocator();
+  // The leaves hold at most NumberOfCellsPerNode (4) cells
+  if (locator->GetNumberOfNodes() < 2 * (polyData->GetNumberOfCells() / 4) - 1)
+  {
+    std::cerr << "The tree has only " << locator->GetNumberOfNodes() << " nodes" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool success = TestIntersectWithLine(polyData, locator);
+  success &= TestFindClosestPoint(polyData, locator);
+  success &= TestFindCellsWithinBounds(polyData, locator);
+  success &= TestFindCell();
+
+  // A shallow copy shares the tree
+  vtkNew<vtkBVHCellLocator> copy;
+  copy->ShallowCopy(locator);
+  if (copy->GetNumberOfNodes() != locator->GetNumberOfNodes())
+  {
+    std::cerr << "The shallow copy has " << copy->GetNumberOfNodes() << " nodes" << std::endl;
+    return EXIT_FAILURE;
+  }
+  success &= TestIntersectWithLine(polyData, copy);
+
+  // Representation of the leaves
+  vtkNew<vtkPolyData> representation;
+  locator->GenerateRepresentation(-1, representation);
+  if (representation->GetNumberOfPolys() < 6)
+  {
+    std::cerr << "The representation has " << representation->GetNumberOfPolys() << " faces"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,189 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConcurrentAppend.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellArray.h"
+#include "vtkConcurrentIdAllocator.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+
+#include <vector>
+
+namespace
+{
+#define CHECK(condition)                                                                           \
+  do                                                                                               \
+  {                                                                                                \
+    if (!(condition))                                                                              \
+    {                                                                                              \
+      std::cerr << "Failed check line " << __LINE__ << ": " #condition << std::endl;               \
+      return false;                                                                                \
+    }                                                                                              \
+  } while (false)
+
+const vtkIdType NumberOfValues = 100000;
+
+bool TestArray()
+{
+  vtkNew<vtkIntArray> array;
+  array->SetNumberOfComponents(2);
+  array->InsertNextTuple2(-1, -1);
+
+  array->BeginConcurrentAppend();
+  vtkSMPTools::For(0, NumberOfValues, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const int tuple[2] = { static_cast<int>(i), static_cast<int>(2 * i) };
+      array->ConcurrentInsertNextTuple(tuple);
+    }
+  });
+  array->EndConcurrentAppend();
+
+  // Every tuple is appended once, after the existing one, without extra
+  // capacity.
+  CHECK(array->GetNumberOfTuples() == NumberOfValues + 1);
+  CHECK(array->GetSize() == 2 * (NumberOfValues + 1));
+  CHECK(array->GetValue(0) == -1 && array->GetValue(1) == -1);
+  std::vector<bool> found(NumberOfValues, false);
+  for (vtkIdType t = 1; t <= NumberOfValues; ++t)
+  {
+    const int value = array->GetTypedComponent(t, 0);
+    CHECK(value >= 0 && value < NumberOfValues && !found[value]);
+    CHECK(array->GetTypedComponent(t, 1) == 2 * value);
+    found[value] = true;
+  }
+  return true;
+}
+
+// Generate a line per value, from (i, 0, 0) to (i, 1, 0), with i as cell data.
+bool TestCells(bool use32BitStorage)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->InsertNextPoint(-1.0, 0.0, 0.0);
+  points->InsertNextPoint(-1.0, 1.0, 0.0);
+  vtkNew<vtkCellArray> lines;
+  if (use32BitStorage)
+  {
+    lines->Use32BitStorage();
+  }
+  lines->InsertNextCell({ 0, 1 });
+  vtkNew<vtkIntArray> scalars;
+  scalars->InsertNextValue(-1);
+
+  // The cells and their scalars share the allocator, to stay in sync.
+  vtkNew<vtkConcurrentIdAllocator> cellIds;
+  cellIds->Initialize(lines->GetNumberOfCells(), 100);
+  CHECK(points->BeginConcurrentAppend());
+  lines->BeginConcurrentAppend(cellIds);
+  scalars->BeginConcurrentAppend(cellIds);
+  vtkSMPTools::For(0, NumberOfValues, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType line[2] = { points->ConcurrentInsertNextPoint(i, 0.0, 0.0),
+        points->ConcurrentInsertNextPoint(i, 1.0, 0.0) };
+      const vtkIdType cellId = lines->ConcurrentInsertNextCell(2, line);
+      const int value = static_cast<int>(i);
+      scalars->ConcurrentSetTuple(cellId, &value);
+    }
+  });
+  points->EndConcurrentAppend();
+  lines->EndConcurrentAppend(points->GetConcurrentAppendIds());
+  scalars->EndConcurrentAppend();
+
+  CHECK(points->GetNumberOfPoints() == 2 * NumberOfValues + 2);
+  CHECK(lines->GetNumberOfCells() == NumberOfValues + 1);
+  CHECK(lines->GetNumberOfConnectivityIds() == 2 * NumberOfValues + 2);
+  CHECK(scalars->GetNumberOfValues() == NumberOfValues + 1);
+  CHECK(points->GetBounds()[0] == -1.0 && points->GetBounds()[1] == NumberOfValues - 1);
+
+  std::vector<bool> found(NumberOfValues + 1, false);
+  vtkIdType npts;
+  const vtkIdType* pts;
+  for (vtkIdType c = 0; c <= NumberOfValues; ++c)
+  {
+    lines->GetCellAtId(c, npts, pts);
+    CHECK(npts == 2);
+    const int value = scalars->GetValue(c);
+    CHECK(value >= -1 && value < NumberOfValues && !found[value + 1]);
+    found[value + 1] = true;
+    double p0[3], p1[3];
+    points->GetPoint(pts[0], p0);
+    points->GetPoint(pts[1], p1);
+    CHECK(p0[0] == value && p0[1] == 0.0 && p1[0] == value && p1[1] == 1.0);
+  }
+  return true;
+}
+
+// Set the tuples of ids spanning several chunks in reverse order, and leave
+// some ids to another cell array sharing the allocator.
+bool TestOutOfOrder()
+{
+  vtkNew<vtkConcurrentIdAllocator> ids;
+  ids->Initialize(0, 4);
+  vtkNew<vtkIntArray> array;
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  array->BeginConcurrentAppend(ids);
+  verts->BeginConcurrentAppend(ids);
+  lines->BeginConcurrentAppend(ids);
+  std::vector<vtkIdType> lineIds;
+  for (vtkIdType i = 0; i < 10; ++i)
+  {
+    const vtkIdType pts[2] = { i, i + 1 };
+    if (i % 3 == 0)
+    {
+      verts->ConcurrentInsertNextCell(1, pts);
+    }
+    else
+    {
+      lineIds.push_back(lines->ConcurrentInsertNextCell(2, pts));
+    }
+  }
+  for (auto id = lineIds.rbegin(); id != lineIds.rend(); ++id)
+  {
+    const int value = static_cast<int>(*id) + 1;
+    array->ConcurrentSetTuple(*id, &value);
+  }
+  array->EndConcurrentAppend();
+  verts->EndConcurrentAppend();
+  lines->EndConcurrentAppend();
+
+  // Every cell array has a cell per id, empty for the ids of the other one,
+  // and the tuples of the ids which were not set are zero.
+  CHECK(array->GetNumberOfValues() == 10);
+  CHECK(verts->GetNumberOfCells() == 10 && verts->GetNumberOfConnectivityIds() == 4);
+  CHECK(lines->GetNumberOfCells() == 10 && lines->GetNumberOfConnectivityIds() == 12);
+  for (vtkIdType i = 0; i < 10; ++i)
+  {
+    const bool isVert = i % 3 == 0;
+    CHECK(array->GetValue(i) == (isVert ? 0 : i + 1));
+    CHECK(verts->GetCellSize(i) == (isVert ? 1 : 0));
+    CHECK(lines->GetCellSize(i) == (isVert ? 0 : 2));
+    vtkIdType npts;
+    const vtkIdType* pts;
+    (isVert ? verts.Get() : lines.Get())->GetCellAtId(i, npts, pts);
+    CHECK(pts[0] == i && (isVert || pts[1] == i + 1));
+  }
+  return true;
+}
+#undef CHECK
+}
+
+int TestConcurrentAppend(int, char*[])
+{
+  const bool success = TestArray() && TestCells(false) && TestCells(true) && TestOutOfOrder();
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,316 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLocatorsRefit.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Deform a mesh and check that the locators refit with RefitSearchStructure
+// answer the queries like freshly built ones, and that they are rebuilt when
+// the deformation degrades them too much.
+
+#include "vtkBVHCellLocator.h"
+#include "vtkCellTreeLocator.h"
+#include "vtkCellType.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+constexpr int Resolution = 16;
+
+// A unit cube of hexahedra
+void GenerateGrid(vtkUnstructuredGrid* grid)
+{
+  const int n = Resolution + 1;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        points->InsertNextPoint(
+          static_cast<double>(i) / Resolution, static_cast<double>(j) / Resolution,
+          static_cast<double>(k) / Resolution);
+      }
+    }
+  }
+  grid->SetPoints(points);
+  grid->Allocate(Resolution * Resolution * Resolution);
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        const vtkIdType p = i + n * (j + n * k);
+        const vtkIdType ptIds[8] = { p, p + 1, p + n + 1, p + n, p + n * n, p + n * n + 1,
+          p + n * n + n + 1, p + n * n + n };
+        grid->InsertNextCell(VTK_HEXAHEDRON, 8, ptIds);
+      }
+    }
+  }
+}
+
+// Displace the points of the grid, keeping its boundary in place
+void Deform(vtkUnstructuredGrid* grid, double amplitude)
+{
+  vtkPoints* points = grid->GetPoints();
+  double x[3];
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+  {
+    points->GetPoint(ptId, x);
+    const double d =
+      64.0 * amplitude * x[0] * (1.0 - x[0]) * x[1] * (1.0 - x[1]) * x[2] * (1.0 - x[2]);
+    points->SetPoint(ptId, x[0] + d, x[1] + 0.5 * d, x[2] - d);
+  }
+  points->Modified();
+}
+
+// Exchange the coordinates of the points, which turns the cells into
+// overlapping slivers spanning the whole grid
+void Shuffle(vtkUnstructuredGrid* grid)
+{
+  vtkPoints* points = grid->GetPoints();
+  std::vector<vtkIdType> order(points->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+  {
+    order[ptId] = ptId;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(1));
+  vtkNew<vtkPoints> shuffled;
+  shuffled->SetDataTypeToDouble();
+  shuffled->SetNumberOfPoints(points->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+  {
+    shuffled->SetPoint(ptId, points->GetPoint(order[ptId]));
+  }
+  points->DeepCopy(shuffled);
+  points->Modified();
+}
+
+std::vector<vtkIdType> Sorted(vtkIdList* ids)
+{
+  std::vector<vtkIdType> sorted(ids->begin(), ids->end());
+  std::sort(sorted.begin(), sorted.end());
+  return sorted;
+}
+
+// Compare the queries of a refit locator with those of a locator built from scratch
+bool CompareCellLocators(vtkUnstructuredGrid* grid, vtkAbstractCellLocator* locator,
+  vtkAbstractCellLocator* reference)
+{
+  reference->SetDataSet(grid);
+  reference->BuildLocator();
+
+  std::mt19937 gen(2);
+  std::uniform_real_distribution<double> position(-0.1, 1.1);
+  vtkNew<vtkGenericCell> cell;
+  double x[3], pcoords[3], weights[8], closestPoint[3], dist2;
+  int subId;
+  for (int i = 0; i < 1000; ++i)
+  {
+    x[0] = position(gen);
+    x[1] = position(gen);
+    x[2] = position(gen);
+    const vtkIdType cellId = locator->FindCell(x, 0.0, cell, subId, pcoords, weights);
+    const vtkIdType expected = reference->FindCell(x);
+    // Points on the faces of the cells may be found in either cell
+    bool found = (cellId < 0) == (expected < 0);
+    if (found && cellId >= 0)
+    {
+      grid->GetCell(cellId, cell);
+      found = cell->EvaluatePosition(x, closestPoint, subId, pcoords, dist2, weights) == 1;
+    }
+    if (!found)
+    {
+      std::cerr << locator->GetClassName() << "::FindCell returned " << cellId << " instead of "
+                << expected << std::endl;
+      return false;
+    }
+  }
+
+  double bbox[6] = { 0.2, 0.45, 0.3, 0.6, 0.4, 0.55 };
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkIdList> expectedIds;
+  locator->FindCellsWithinBounds(bbox, cellIds);
+  reference->FindCellsWithinBounds(bbox, expectedIds);
+  if (Sorted(cellIds) != Sorted(expectedIds) || cellIds->GetNumberOfIds() == 0)
+  {
+    std::cerr << locator->GetClassName() << "::FindCellsWithinBounds found "
+              << cellIds->GetNumberOfIds() << " cells instead of "
+              << expectedIds->GetNumberOfIds() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestCellLocator(vtkAbstractCellLocator* locator, vtkAbstractCellLocator* reference)
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  GenerateGrid(grid);
+  locator->SetDataSet(grid);
+  locator->RefitSearchStructureOn();
+  locator->BuildLocator();
+  if (locator->GetRefitted())
+  {
+    std::cerr << locator->GetClassName() << " refit on first build" << std::endl;
+    return false;
+  }
+
+  // Small deformations are refit
+  for (int step = 0; step < 3; ++step)
+  {
+    Deform(grid, 0.01);
+    locator->BuildLocator();
+    if (!locator->GetRefitted())
+    {
+      std::cerr << locator->GetClassName() << " was rebuilt at step " << step << std::endl;
+      return false;
+    }
+    if (!CompareCellLocators(grid, locator, reference))
+    {
+      return false;
+    }
+  }
+
+  // A shallow copy keeps the tree of the refit locator
+  auto copy = vtkSmartPointer<vtkAbstractCellLocator>::Take(
+    vtkAbstractCellLocator::SafeDownCast(locator->NewInstance()));
+  copy->ShallowCopy(locator);
+  copy->RefitSearchStructureOn();
+  if (!CompareCellLocators(grid, copy, reference))
+  {
+    return false;
+  }
+
+  // Shuffled points degrade the locator, which is rebuilt
+  Shuffle(grid);
+  locator->BuildLocator();
+  if (locator->GetRefitted())
+  {
+    std::cerr << locator->GetClassName() << " was refit after shuffling the points" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestPointLocator()
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  GenerateGrid(grid);
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(grid);
+  locator->RefitSearchStructureOn();
+  locator->BuildLocator();
+
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> position(-0.1, 1.1);
+  vtkNew<vtkIdList> ptIds;
+  double x[3], p[3];
+  for (int step = 0; step < 3; ++step)
+  {
+    Deform(grid, 0.05);
+    locator->BuildLocator();
+    if (!locator->GetRefitted())
+    {
+      std::cerr << "vtkStaticPointLocator was rebuilt at step " << step << std::endl;
+      return false;
+    }
+    for (int i = 0; i < 200; ++i)
+    {
+      x[0] = position(gen);
+      x[1] = position(gen);
+      x[2] = position(gen);
+      const double radius = 0.1;
+      std::vector<vtkIdType> expected;
+      double minDist2 = VTK_DOUBLE_MAX;
+      for (vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ++ptId)
+      {
+        grid->GetPoint(ptId, p);
+        const double dist2 = vtkMath::Distance2BetweenPoints(x, p);
+        minDist2 = std::min(minDist2, dist2);
+        if (dist2 <= radius * radius)
+        {
+          expected.push_back(ptId);
+        }
+      }
+      grid->GetPoint(locator->FindClosestPoint(x), p);
+      if (vtkMath::Distance2BetweenPoints(x, p) != minDist2)
+      {
+        std::cerr << "vtkStaticPointLocator::FindClosestPoint returned a point at a squared "
+                  << "distance of " << vtkMath::Distance2BetweenPoints(x, p) << " instead of "
+                  << minDist2 << std::endl;
+        return false;
+      }
+      locator->FindPointsWithinRadius(radius, x, ptIds);
+      if (Sorted(ptIds) != expected)
+      {
+        std::cerr << "vtkStaticPointLocator::FindPointsWithinRadius found "
+                  << ptIds->GetNumberOfIds() << " points instead of " << expected.size()
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+
+  // Points leaving the bounds of the buckets require a rebuild
+  vtkPoints* points = grid->GetPoints();
+  points->SetPoint(0, -1.0, -1.0, -1.0);
+  points->Modified();
+  locator->BuildLocator();
+  if (locator->GetRefitted())
+  {
+    std::cerr << "vtkStaticPointLocator was refit with a point out of its bounds" << std::endl;
+    return false;
+  }
+  if (locator->FindClosestPoint(-0.9, -0.9, -0.9) != 0)
+  {
+    std::cerr << "vtkStaticPointLocator did not find the moved point" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestLocatorsRefit(int, char*[])
+{
+  bool success = TestPointLocator();
+  {
+    vtkNew<vtkStaticCellLocator> locator;
+    vtkNew<vtkStaticCellLocator> reference;
+    success &= TestCellLocator(locator, reference);
+  }
+  {
+    vtkNew<vtkCellTreeLocator> locator;
+    vtkNew<vtkCellTreeLocator> reference;
+    success &= TestCellLocator(locator, reference);
+  }
+  {
+    vtkNew<vtkBVHCellLocator> locator;
+    vtkNew<vtkBVHCellLocator> reference;
+    success &= TestCellLocator(locator, reference);
+  }
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
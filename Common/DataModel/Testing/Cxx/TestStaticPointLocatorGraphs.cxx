@@ -0,0 +1,207 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStaticPointLocatorGraphs.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the k-nearest neighbor and radius graphs of vtkStaticPointLocator
+// with brute force searches and with the queries of a single point, on a
+// point cloud mixing uniform and clustered points, and duplicated points.
+
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticPointLocator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+void GeneratePoints(vtkIdType numPts, vtkPolyData* polyData)
+{
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::normal_distribution<double> cluster(0.5, 0.02);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    if (ptId % 10 == 9)
+    {
+      points->SetPoint(ptId, points->GetPoint(ptId - 9));
+    }
+    else if (ptId % 2 == 0)
+    {
+      points->SetPoint(ptId, uniform(gen), uniform(gen), uniform(gen));
+    }
+    else
+    {
+      points->SetPoint(ptId, cluster(gen), cluster(gen), cluster(gen));
+    }
+  }
+  polyData->SetPoints(points);
+}
+
+bool TestClosestNPointsGraph(vtkPolyData* polyData, vtkStaticPointLocator* locator, int N)
+{
+  vtkNew<vtkIdTypeArray> offsets;
+  vtkNew<vtkIdTypeArray> neighbors;
+  locator->FindClosestNPointsGraph(N, offsets, neighbors);
+  const vtkIdType numPts = polyData->GetNumberOfPoints();
+  const vtkIdType numNeighbors = std::min<vtkIdType>(N, numPts);
+  if (offsets->GetNumberOfValues() != numPts + 1 ||
+    neighbors->GetNumberOfValues() != numPts * numNeighbors)
+  {
+    std::cerr << "FindClosestNPointsGraph returned " << neighbors->GetNumberOfValues()
+              << " neighbors for " << offsets->GetNumberOfValues() - 1 << " points" << std::endl;
+    return false;
+  }
+
+  // The neighbors of some points are those of a brute force search
+  double x[3];
+  std::vector<std::pair<double, vtkIdType>> distances(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ptId += 97)
+  {
+    polyData->GetPoint(ptId, x);
+    for (vtkIdType id = 0; id < numPts; ++id)
+    {
+      distances[id] =
+        std::make_pair(vtkMath::Distance2BetweenPoints(x, polyData->GetPoint(id)), id);
+    }
+    std::partial_sort(distances.begin(), distances.begin() + numNeighbors, distances.end());
+    for (vtkIdType i = 0; i < numNeighbors; ++i)
+    {
+      const vtkIdType neighbor = neighbors->GetValue(offsets->GetValue(ptId) + i);
+      if (neighbor != distances[i].second)
+      {
+        std::cerr << "FindClosestNPointsGraph returned " << neighbor << " as neighbor " << i
+                  << " of point " << ptId << " instead of " << distances[i].second << std::endl;
+        return false;
+      }
+    }
+  }
+
+  // The farthest neighbor of each point is as far as the one of FindClosestNPoints()
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    polyData->GetPoint(ptId, x);
+    locator->FindClosestNPoints(N, x, ptIds);
+    const vtkIdType last = neighbors->GetValue(offsets->GetValue(ptId + 1) - 1);
+    if (ptIds->GetNumberOfIds() != numNeighbors ||
+      vtkMath::Distance2BetweenPoints(x, polyData->GetPoint(last)) !=
+        vtkMath::Distance2BetweenPoints(x, polyData->GetPoint(ptIds->GetId(numNeighbors - 1))))
+    {
+      std::cerr << "FindClosestNPointsGraph differs from FindClosestNPoints for point " << ptId
+                << std::endl;
+      return false;
+    }
+  }
+
+  // A range of points gives the same neighbors
+  vtkNew<vtkIdTypeArray> rangeOffsets;
+  vtkNew<vtkIdTypeArray> rangeNeighbors;
+  const vtkIdType beginId = numPts / 3, endId = numPts / 2;
+  locator->FindClosestNPointsGraph(N, rangeOffsets, rangeNeighbors, beginId, endId);
+  if (rangeOffsets->GetNumberOfValues() != endId - beginId + 1 ||
+    !std::equal(rangeNeighbors->GetPointer(0),
+      rangeNeighbors->GetPointer(0) + rangeNeighbors->GetNumberOfValues(),
+      neighbors->GetPointer(offsets->GetValue(beginId))))
+  {
+    std::cerr << "FindClosestNPointsGraph differs on the range [" << beginId << ", " << endId
+              << ")" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestPointsWithinRadiusGraph(vtkPolyData* polyData, vtkStaticPointLocator* locator, double R)
+{
+  vtkNew<vtkIdTypeArray> offsets;
+  vtkNew<vtkIdTypeArray> neighbors;
+  locator->FindPointsWithinRadiusGraph(R, offsets, neighbors);
+  const vtkIdType numPts = polyData->GetNumberOfPoints();
+  if (offsets->GetNumberOfValues() != numPts + 1 ||
+    offsets->GetValue(numPts) != neighbors->GetNumberOfValues())
+  {
+    std::cerr << "FindPointsWithinRadiusGraph returned " << neighbors->GetNumberOfValues()
+              << " neighbors for " << offsets->GetNumberOfValues() - 1 << " points" << std::endl;
+    return false;
+  }
+
+  // The neighbors of each point are those of FindPointsWithinRadius()
+  vtkNew<vtkIdList> ptIds;
+  double x[3];
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    polyData->GetPoint(ptId, x);
+    locator->FindPointsWithinRadius(R, x, ptIds);
+    const vtkIdType* begin = neighbors->GetPointer(offsets->GetValue(ptId));
+    const vtkIdType* end = neighbors->GetPointer(0) + offsets->GetValue(ptId + 1);
+    if (end - begin != ptIds->GetNumberOfIds() || !std::equal(begin, end, ptIds->begin()))
+    {
+      std::cerr << "FindPointsWithinRadiusGraph returned " << end - begin
+                << " neighbors for point " << ptId << " instead of " << ptIds->GetNumberOfIds()
+                << std::endl;
+      return false;
+    }
+  }
+
+  // A range of points gives the same neighbors
+  vtkNew<vtkIdTypeArray> rangeOffsets;
+  vtkNew<vtkIdTypeArray> rangeNeighbors;
+  const vtkIdType beginId = numPts / 4, endId = numPts / 3;
+  locator->FindPointsWithinRadiusGraph(R, rangeOffsets, rangeNeighbors, beginId, endId);
+  if (rangeOffsets->GetNumberOfValues() != endId - beginId + 1 ||
+    rangeNeighbors->GetNumberOfValues() !=
+      offsets->GetValue(endId) - offsets->GetValue(beginId) ||
+    !std::equal(rangeNeighbors->GetPointer(0),
+      rangeNeighbors->GetPointer(0) + rangeNeighbors->GetNumberOfValues(),
+      neighbors->GetPointer(offsets->GetValue(beginId))))
+  {
+    std::cerr << "FindPointsWithinRadiusGraph differs on the range [" << beginId << ", " << endId
+              << ")" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestStaticPointLocatorGraphs(int, char*[])
+{
+  vtkNew<vtkPolyData> polyData;
+  GeneratePoints(20000, polyData);
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(polyData);
+  locator->BuildLocator();
+
+  bool success = TestClosestNPointsGraph(polyData, locator, 1);
+  success &= TestClosestNPointsGraph(polyData, locator, 25);
+  success &= TestPointsWithinRadiusGraph(polyData, locator, 0.005);
+  success &= TestPointsWithinRadiusGraph(polyData, locator, 0.1);
+
+  // More neighbors than points
+  vtkNew<vtkPolyData> fewPoints;
+  GeneratePoints(20, fewPoints);
+  vtkNew<vtkStaticPointLocator> fewLocator;
+  fewLocator->SetDataSet(fewPoints);
+  success &= TestClosestNPointsGraph(fewPoints, fewLocator, 30);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -18,18 +18,163 @@
 #include "vtkCellArray.h"
 #include "vtkDataArrayRange.h"
 #include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkMath.h"
+#include "vtkMemoryArena.h"
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
-//------------------------------------------------------------------------------
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
 VTK_ABI_NAMESPACE_BEGIN
+namespace
+{
+// Spread the 21 low bits of an integer coordinate to every third bit.
+inline uint64_t SpreadBits(uint64_t v)
+{
+  v &= 0x1fffff;
+  v = (v | (v << 32)) & 0x1f00000000ffffULL;
+  v = (v | (v << 16)) & 0x1f0000ff0000ffULL;
+  v = (v | (v << 8)) & 0x100f00f00f00f00fULL;
+  v = (v | (v << 4)) & 0x10c30c30c30c30c3ULL;
+  v = (v | (v << 2)) & 0x1249249249249249ULL;
+  return v;
+}
+
+// Default batched FindCells(), calling the thread safe FindCell() of the
+// locator in the order of the queries.
+struct FindCellsWorker
+{
+  vtkAbstractCellLocator* Locator;
+  vtkPoints* Points;
+  double Tol2;
+  const vtkIdType* Order;
+  vtkIdList* CellIds;
+  vtkDoubleArray* PCoords;
+  int MaxCellSize;
+  vtkSMPThreadLocalObject<vtkGenericCell> TLCell;
+  vtkSMPThreadLocal<std::vector<double>> TLWeights;
+
+  FindCellsWorker(vtkAbstractCellLocator* locator, vtkPoints* points, double tol2,
+    const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+    : Locator(locator)
+    , Points(points)
+    , Tol2(tol2)
+    , Order(order)
+    , CellIds(cellIds)
+    , PCoords(pcoords)
+    , MaxCellSize(locator->GetDataSet()->GetMaxCellSize())
+  {
+  }
+
+  void Initialize() { this->TLWeights.Local().resize(this->MaxCellSize); }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    // Point ids of the cells come from the arena of the thread, rewound after each chunk.
+    vtkMemoryArena::Scope scope;
+    vtkGenericCell* cell = this->TLCell.Local();
+    cell->SetArena(scope.GetArena());
+    double* weights = this->TLWeights.Local().data();
+    double x[3], pcoords[3];
+    int subId;
+    for (; begin < end; ++begin)
+    {
+      const vtkIdType ptId = this->Order[begin];
+      this->Points->GetPoint(ptId, x);
+      const vtkIdType cellId =
+        this->Locator->FindCell(x, this->Tol2, cell, subId, pcoords, weights);
+      this->CellIds->SetId(ptId, cellId);
+      if (this->PCoords)
+      {
+        if (cellId < 0)
+        {
+          pcoords[0] = pcoords[1] = pcoords[2] = 0.0;
+        }
+        this->PCoords->SetTypedTuple(ptId, pcoords);
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+
+// Default batched IntersectWithLines(), calling the thread safe
+// IntersectWithLine() of the locator in the order of the queries.
+struct IntersectWithLinesWorker
+{
+  vtkAbstractCellLocator* Locator;
+  vtkPoints* P1;
+  vtkPoints* P2;
+  double Tol;
+  const vtkIdType* Order;
+  vtkIdList* CellIds;
+  vtkDoubleArray* T;
+  vtkPoints* X;
+  vtkSMPThreadLocalObject<vtkGenericCell> TLCell;
+
+  IntersectWithLinesWorker(vtkAbstractCellLocator* locator, vtkPoints* p1, vtkPoints* p2,
+    double tol, const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+    : Locator(locator)
+    , P1(p1)
+    , P2(p2)
+    , Tol(tol)
+    , Order(order)
+    , CellIds(cellIds)
+    , T(t)
+    , X(x)
+  {
+  }
+
+  void Initialize() {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkMemoryArena::Scope scope;
+    vtkGenericCell* cell = this->TLCell.Local();
+    cell->SetArena(scope.GetArena());
+    double p1[3], p2[3], t, x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    for (; begin < end; ++begin)
+    {
+      const vtkIdType lineId = this->Order[begin];
+      this->P1->GetPoint(lineId, p1);
+      this->P2->GetPoint(lineId, p2);
+      if (!this->Locator->IntersectWithLine(
+            p1, p2, this->Tol, t, x, pcoords, subId, cellId, cell) ||
+        cellId < 0)
+      {
+        cellId = -1;
+        t = x[0] = x[1] = x[2] = 0.0;
+      }
+      this->CellIds->SetId(lineId, cellId);
+      if (this->T)
+      {
+        this->T->SetValue(lineId, t);
+      }
+      if (this->X)
+      {
+        this->X->SetPoint(lineId, x);
+      }
+    }
+  }
+
+  void Reduce() {}
+};
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
 vtkAbstractCellLocator::vtkAbstractCellLocator()
 {
   this->CacheCellBounds = 1;
@@ -270,6 +415,106 @@ vtkIdType vtkAbstractCellLocator::FindCell(
   return returnVal;
 }
 
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::FindCells(
+  vtkPoints* points, double tol2, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+{
+  const vtkIdType numPts = points->GetNumberOfPoints();
+  vtkAbstractCellLocator::InitializeQueryOutputs(numPts, cellIds, pcoords, 3, nullptr);
+  if (numPts < 1 || !this->DataSet)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    return;
+  }
+  this->BuildLocator();
+
+  std::vector<vtkIdType> order;
+  vtkAbstractCellLocator::ComputeQueryOrder(points, order);
+  FindCellsWorker worker(this, points, tol2, order.data(), cellIds, pcoords);
+  vtkSMPTools::For(0, numPts, worker);
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::IntersectWithLines(
+  vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  const vtkIdType numLines = p1->GetNumberOfPoints();
+  if (p2->GetNumberOfPoints() != numLines)
+  {
+    vtkErrorMacro(<< "The end points of the lines differ in number");
+    cellIds->Reset();
+    return;
+  }
+  vtkAbstractCellLocator::InitializeQueryOutputs(numLines, cellIds, t, 1, x);
+  if (numLines < 1 || !this->DataSet)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    return;
+  }
+  this->BuildLocator();
+
+  std::vector<vtkIdType> order;
+  vtkAbstractCellLocator::ComputeQueryOrder(p1, order);
+  IntersectWithLinesWorker worker(this, p1, p2, tol, order.data(), cellIds, t, x);
+  vtkSMPTools::For(0, numLines, worker);
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::ComputeQueryOrder(vtkPoints* points, std::vector<vtkIdType>& order)
+{
+  const vtkIdType numPts = points->GetNumberOfPoints();
+  double bounds[6], scale[3];
+  points->GetBounds(bounds);
+  for (int i = 0; i < 3; ++i)
+  {
+    const double length = bounds[2 * i + 1] - bounds[2 * i];
+    scale[i] = (length > 0.0 ? 2097151.0 / length : 0.0);
+  }
+
+  // Sort the point ids by the Morton codes of the points quantized on 21 bits
+  // per axis. Ties keep the ids in increasing order.
+  std::vector<std::pair<uint64_t, vtkIdType>> keys(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    uint64_t ijk[3];
+    for (; begin < end; ++begin)
+    {
+      points->GetPoint(begin, x);
+      for (int i = 0; i < 3; ++i)
+      {
+        const double q = (x[i] - bounds[2 * i]) * scale[i];
+        ijk[i] = static_cast<uint64_t>(q < 0.0 ? 0.0 : (q > 2097151.0 ? 2097151.0 : q));
+      }
+      keys[begin].first = SpreadBits(ijk[0]) | (SpreadBits(ijk[1]) << 1) |
+        (SpreadBits(ijk[2]) << 2);
+      keys[begin].second = begin;
+    }
+  });
+  vtkSMPTools::Sort(keys.begin(), keys.end());
+
+  order.resize(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    order[i] = keys[i].second;
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkAbstractCellLocator::InitializeQueryOutputs(vtkIdType numberOfQueries,
+  vtkIdList* cellIds, vtkDoubleArray* values, int numberOfComponents, vtkPoints* points)
+{
+  cellIds->SetNumberOfIds(numberOfQueries);
+  if (values)
+  {
+    values->SetNumberOfComponents(numberOfComponents);
+    values->SetNumberOfTuples(numberOfQueries);
+  }
+  if (points)
+  {
+    points->SetNumberOfPoints(numberOfQueries);
+  }
+}
+
 //------------------------------------------------------------------------------
 bool vtkAbstractCellLocator::InsideCellBounds(double x[3], vtkIdType cell_ID)
 {
@@ -47,6 +47,7 @@
 
 VTK_ABI_NAMESPACE_BEGIN
 class vtkCellArray;
+class vtkDoubleArray;
 class vtkGenericCell;
 class vtkIdList;
 class vtkPoints;
@@ -317,6 +318,46 @@ public:
     double pcoords[3], double* weights);
   ///@}
 
+  /**
+   * Find the cells containing a batch of points. cellIds is resized to the
+   * number of points, and receives for each point the id of the cell that
+   * FindCell(x, tol2, cell, subId, pcoords, weights) returns, or -1 if no
+   * cell is found. If pcoords is not nullptr, it receives the 3 parametric
+   * coordinates of each point in its cell (0 if no cell is found).
+   *
+   * The locator is built if needed, then the points are processed in
+   * parallel with vtkSMPTools, in a spatially coherent order (sorted along a
+   * Z-order curve) so that consecutive queries visit the same parts of the
+   * search structure. The default implementation calls the thread safe
+   * FindCell; vtkStaticCellLocator, vtkCellTreeLocator and
+   * vtkModifiedBSPTree traverse their search structures directly.
+   *
+   * THIS FUNCTION IS NOT THREAD SAFE.
+   */
+  virtual void FindCells(
+    vtkPoints* points, double tol2, vtkIdList* cellIds, vtkDoubleArray* pcoords = nullptr);
+
+  /**
+   * Intersect a batch of finite lines, from the points of p1 to the points
+   * with the same ids in p2, with the cells. cellIds is resized to the number
+   * of lines, and receives for each line the id of the first intersected cell
+   * that IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId, cell)
+   * returns, or -1 if the line intersects no cell. If t or x are not nullptr,
+   * they receive the parametric coordinate along the line and the position
+   * of the intersection (0 if the line intersects no cell).
+   *
+   * The locator is built if needed, then the lines are processed in parallel
+   * with vtkSMPTools, sorted along a Z-order curve of their first points. The
+   * default implementation calls the thread safe IntersectWithLine;
+   * vtkStaticCellLocator, vtkCellTreeLocator and vtkModifiedBSPTree
+   * traverse their search structures directly, and reuse the per thread
+   * buffers of visited cells from one line to the next.
+   *
+   * THIS FUNCTION IS NOT THREAD SAFE.
+   */
+  virtual void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds,
+    vtkDoubleArray* t = nullptr, vtkPoints* x = nullptr);
+
   /**
    * Quickly test if a point is inside the bounds of a particular cell.
    * Some locators cache cell bounds and this function can make use
@@ -371,6 +412,20 @@ protected:
    */
   void GetCellBounds(vtkIdType cellId, double*& cellBoundsPtr);
 
+  /**
+   * Compute the order in which the batched queries process the given points:
+   * the ids of the points sorted along a Z-order curve over their bounds, so
+   * that consecutive queries are spatially close.
+   */
+  static void ComputeQueryOrder(vtkPoints* points, std::vector<vtkIdType>& order);
+
+  /**
+   * Resize the outputs of the batched queries, see FindCells and
+   * IntersectWithLines.
+   */
+  static void InitializeQueryOutputs(vtkIdType numberOfQueries, vtkIdList* cellIds,
+    vtkDoubleArray* values, int numberOfComponents, vtkPoints* points);
+
   /**
    * This array is resized so that it can fit points from the cell hosting the most in the input
    * data set. Resizing is done in `UpdateInternalWeights`.
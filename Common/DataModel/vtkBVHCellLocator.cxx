@@ -0,0 +1,1556 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBVHCellLocator.h"
+
+#include "vtkBoundingBox.h"
+#include "vtkBox.h"
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkMemoryArena.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+VTK_ABI_NAMESPACE_BEGIN
+vtkStandardNewMacro(vtkBVHCellLocator);
+
+//------------------------------------------------------------------------------
+// Perform locator operations like FindCell. Uses templated subclasses
+// to reduce memory and enhance speed.
+struct vtkBVHTree
+{
+  // The surface area cost of the leaves when the tree was built, negative
+  // until first needed
+  double BuildCost = -1.0;
+
+  virtual ~vtkBVHTree() = default;
+
+  virtual vtkIdType GetNumberOfNodes() = 0;
+  virtual vtkIdType GetNumberOfCells() = 0;
+  virtual vtkIdType FindCell(
+    const double x[3], vtkGenericCell* cell, int& subId, double pcoords[3], double* weights) = 0;
+  virtual int IntersectWithLine(const double p1[3], const double p2[3], double tol, double& t,
+    double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell) = 0;
+  virtual int IntersectWithLine(const double p1[3], const double p2[3], double tol,
+    vtkPoints* points, vtkIdList* cellIds, vtkGenericCell* cell) = 0;
+  virtual vtkIdType FindClosestPointWithinRadius(const double x[3], double radius,
+    double closestPoint[3], vtkGenericCell* cell, vtkIdType& cellId, int& subId, double& dist2,
+    int& inside) = 0;
+  virtual void FindCellsWithinBounds(const double bbox[6], vtkIdList* cells) = 0;
+  virtual void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol,
+    const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x) = 0;
+  virtual void GenerateRepresentation(int level, vtkPolyData* pd) = 0;
+
+  // Return a tree sharing the nodes of this one, see ShallowCopy().
+  virtual vtkBVHTree* ShallowCopy(const double* cellBounds) = 0;
+
+  // Refit the tree to new cell bounds, see vtkLocator::RefitSearchStructure.
+  virtual bool Refit(const double* cellBounds, double costThreshold) = 0;
+};
+VTK_ABI_NAMESPACE_END
+
+namespace
+{
+VTK_ABI_NAMESPACE_BEGIN
+// The number of lines traversing the tree together in IntersectWithLines().
+// The boxes are tested against all the lines of a packet in fixed size loops,
+// which the compiler can vectorize.
+constexpr int PacketSize = 8;
+
+//------------------------------------------------------------------------------
+// A node of the tree. The bounds are stored in single precision, rounded
+// outward so that they enclose the bounds of the cells of the node. The two
+// children of an interior node are stored next to each other.
+template <typename T>
+struct BVHNode
+{
+  float Bounds[6];
+  T Index; // Offset of the cells of a leaf, or index of the first child
+  T Count; // Number of cells of a leaf, 0 for an interior node
+
+  bool IsLeaf() const { return this->Count > 0; }
+
+  void SetBounds(const double bounds[6])
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      float lo = static_cast<float>(bounds[2 * i]);
+      float hi = static_cast<float>(bounds[2 * i + 1]);
+      this->Bounds[2 * i] = (lo > bounds[2 * i] ? std::nextafter(lo, -FLT_MAX) : lo);
+      this->Bounds[2 * i + 1] = (hi < bounds[2 * i + 1] ? std::nextafter(hi, FLT_MAX) : hi);
+    }
+  }
+};
+static_assert(sizeof(BVHNode<int>) == 32, "The nodes of the tree should take 32 bytes");
+
+//------------------------------------------------------------------------------
+// Helpers on double precision bounds.
+void InitializeBounds(double bounds[6])
+{
+  bounds[0] = bounds[2] = bounds[4] = VTK_DOUBLE_MAX;
+  bounds[1] = bounds[3] = bounds[5] = -VTK_DOUBLE_MAX;
+}
+
+void AddBounds(double bounds[6], const double other[6])
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    bounds[2 * i] = std::min(bounds[2 * i], other[2 * i]);
+    bounds[2 * i + 1] = std::max(bounds[2 * i + 1], other[2 * i + 1]);
+  }
+}
+
+// Half of the surface area of the bounds, the measure used by the heuristic.
+double HalfArea(const double bounds[6])
+{
+  if (bounds[0] > bounds[1])
+  {
+    return 0.0;
+  }
+  const double dx = bounds[1] - bounds[0];
+  const double dy = bounds[3] - bounds[2];
+  const double dz = bounds[5] - bounds[4];
+  return dx * dy + dy * dz + dz * dx;
+}
+
+template <typename TBounds>
+double Distance2ToBounds(const double x[3], const TBounds bounds[6])
+{
+  double dist2 = 0.0;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double delta = x[i] < bounds[2 * i]
+      ? bounds[2 * i] - x[i]
+      : (x[i] > bounds[2 * i + 1] ? x[i] - bounds[2 * i + 1] : 0.0);
+    dist2 += delta * delta;
+  }
+  return dist2;
+}
+
+template <typename TBounds>
+bool InsideBounds(const double x[3], const TBounds bounds[6])
+{
+  return bounds[0] <= x[0] && x[0] <= bounds[1] && bounds[2] <= x[1] && x[1] <= bounds[3] &&
+    bounds[4] <= x[2] && x[2] <= bounds[5];
+}
+
+//------------------------------------------------------------------------------
+// Line traversal. A line p1 + t * (p2 - p1), t in [0, 1], is tested against
+// the boxes with the slab method, using the inverse of its direction. Null
+// direction components are inverted to VTK_DOUBLE_MAX rather than infinity,
+// so that a line lying on a slab bound does not produce NaNs.
+void InitializeLine(const double p1[3], const double p2[3], double dir[3], double invDir[3])
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    dir[i] = p2[i] - p1[i];
+    invDir[i] = (dir[i] != 0.0 ? 1.0 / dir[i] : VTK_DOUBLE_MAX);
+  }
+}
+
+// vtkBox::IntersectBox(), used on the cells, pads flat bounds by the
+// tolerance and accepts points within the tolerance of the bounds: padding
+// the nodes by twice the tolerance keeps them conservative.
+double GetPadding(double tol)
+{
+  return 2.0 * (tol > 0.0 ? tol : FLT_EPSILON);
+}
+
+bool IntersectBounds(const float bounds[6], const double origin[3], const double invDir[3],
+  double pad, double& tEntry)
+{
+  double t0 = 0.0, t1 = 1.0;
+  for (int i = 0; i < 3; ++i)
+  {
+    const double a = (bounds[2 * i] - pad - origin[i]) * invDir[i];
+    const double b = (bounds[2 * i + 1] + pad - origin[i]) * invDir[i];
+    t0 = std::max(t0, std::min(a, b));
+    t1 = std::min(t1, std::max(a, b));
+  }
+  tEntry = t0;
+  return t0 <= t1;
+}
+
+// The lines of a packet, with the components of their origins and inverse
+// directions stored contiguously for the box tests.
+struct LinePacket
+{
+  int Size;
+  double P1[PacketSize][3];
+  double P2[PacketSize][3];
+  double Dir[PacketSize][3];
+  double Origin[3][PacketSize];
+  double InvDir[3][PacketSize];
+  double TBest[PacketSize];
+
+  void Initialize(vtkPoints* p1, vtkPoints* p2, const vtkIdType* lineIds, int size)
+  {
+    this->Size = size;
+    double invDir[3];
+    for (int l = 0; l < PacketSize; ++l)
+    {
+      if (l < size)
+      {
+        p1->GetPoint(lineIds[l], this->P1[l]);
+        p2->GetPoint(lineIds[l], this->P2[l]);
+        InitializeLine(this->P1[l], this->P2[l], this->Dir[l], invDir);
+        this->TBest[l] = VTK_DOUBLE_MAX;
+      }
+      else
+      {
+        // Unused lanes never hit a box
+        std::fill_n(this->P1[l], 3, 0.0);
+        std::fill_n(invDir, 3, 0.0);
+        this->TBest[l] = -1.0;
+      }
+      for (int i = 0; i < 3; ++i)
+      {
+        this->Origin[i][l] = this->P1[l][i];
+        this->InvDir[i][l] = invDir[i];
+      }
+    }
+  }
+
+  // Return the mask of the lines among active which hit the box before
+  // their current closest intersection.
+  unsigned int IntersectBounds(
+    const float bounds[6], double pad, unsigned int active, double tEntry[PacketSize]) const
+  {
+    double t0[PacketSize], t1[PacketSize];
+    for (int l = 0; l < PacketSize; ++l)
+    {
+      t0[l] = 0.0;
+      t1[l] = 1.0;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      const double lo = bounds[2 * i] - pad;
+      const double hi = bounds[2 * i + 1] + pad;
+      for (int l = 0; l < PacketSize; ++l)
+      {
+        const double a = (lo - this->Origin[i][l]) * this->InvDir[i][l];
+        const double b = (hi - this->Origin[i][l]) * this->InvDir[i][l];
+        const double tNear = a < b ? a : b;
+        const double tFar = a < b ? b : a;
+        t0[l] = tNear > t0[l] ? tNear : t0[l];
+        t1[l] = tFar < t1[l] ? tFar : t1[l];
+      }
+    }
+    unsigned int mask = 0;
+    for (int l = 0; l < PacketSize; ++l)
+    {
+      tEntry[l] = t0[l];
+      mask |= static_cast<unsigned int>(t0[l] <= t1[l] && t0[l] <= this->TBest[l]) << l;
+    }
+    return mask & active;
+  }
+};
+
+// The closest intersection of a line found so far.
+struct LineHit
+{
+  double T = VTK_DOUBLE_MAX;
+  double X[3];
+  double PCoords[3];
+  int SubId = -1;
+  vtkIdType CellId = -1;
+};
+
+// An intersection of IntersectWithLine() returning all the cells.
+struct LineIntersection
+{
+  vtkIdType CellId;
+  double X[3];
+  double T;
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+struct BVHTree : public vtkBVHTree
+{
+  using TNode = BVHNode<T>;
+
+  struct NodeEntry
+  {
+    T Node;
+    double TEntry;
+  };
+
+  struct PacketEntry
+  {
+    T Node;
+    unsigned int Mask;
+    double TEntry[PacketSize];
+  };
+
+  vtkDataSet* DataSet;
+  const double* CellBounds; // Cached by the locator
+  int MaxCellSize;
+
+  // The nodes and the cell ids referenced by the leaves, shared by the
+  // shallow copies of the locator.
+  std::shared_ptr<std::vector<TNode>> NodesSharedPtr;
+  std::shared_ptr<std::vector<T>> CellIdsSharedPtr;
+  const TNode* Nodes = nullptr;
+  const T* CellIds = nullptr;
+
+  BVHTree(vtkDataSet* dataSet, const double* cellBounds)
+    : DataSet(dataSet)
+    , CellBounds(cellBounds)
+    , MaxCellSize(dataSet->GetMaxCellSize())
+  {
+  }
+
+  void Build(T numCells, int numberOfBins, int numberOfCellsPerNode);
+
+  vtkIdType GetNumberOfNodes() override
+  {
+    return static_cast<vtkIdType>(this->NodesSharedPtr->size());
+  }
+  vtkIdType GetNumberOfCells() override
+  {
+    return static_cast<vtkIdType>(this->CellIdsSharedPtr->size());
+  }
+  vtkIdType FindCell(const double x[3], vtkGenericCell* cell, int& subId, double pcoords[3],
+    double* weights) override;
+  int IntersectWithLine(const double p1[3], const double p2[3], double tol, double& t, double x[3],
+    double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell) override;
+  int IntersectWithLine(const double p1[3], const double p2[3], double tol, vtkPoints* points,
+    vtkIdList* cellIds, vtkGenericCell* cell) override;
+  vtkIdType FindClosestPointWithinRadius(const double x[3], double radius, double closestPoint[3],
+    vtkGenericCell* cell, vtkIdType& cellId, int& subId, double& dist2, int& inside) override;
+  void FindCellsWithinBounds(const double bbox[6], vtkIdList* cells) override;
+  void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, const vtkIdType* order,
+    vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x) override;
+  void GenerateRepresentation(int level, vtkPolyData* pd) override;
+
+  vtkBVHTree* ShallowCopy(const double* cellBounds) override
+  {
+    auto tree = new BVHTree<T>(this->DataSet, cellBounds);
+    tree->NodesSharedPtr = this->NodesSharedPtr; // this is important
+    tree->CellIdsSharedPtr = this->CellIdsSharedPtr;
+    tree->Nodes = this->Nodes;
+    tree->CellIds = this->CellIds;
+    tree->BuildCost = this->BuildCost;
+    return tree;
+  }
+
+  bool Refit(const double* cellBounds, double costThreshold) override;
+
+  // The sum over the leaves of their number of cells times the surface area
+  // of their bounds, relative to the surface area of the root
+  double ComputeCost() const;
+
+  // Intersect a line with a cell, keeping the closest intersection. Ties are
+  // resolved with the smallest cell id, so that the result does not depend on
+  // the traversal order.
+  void IntersectCell(T cellId, const double p1[3], const double p2[3], const double dir[3],
+    double tol, vtkGenericCell* cell, LineHit& hit)
+  {
+    const double* cellBounds = this->CellBounds + 6 * static_cast<vtkIdType>(cellId);
+    double tHitCell, xHitCell[3], t, x[3], pcoords[3];
+    int subId;
+    if (!vtkBox::IntersectBox(cellBounds, p1, dir, xHitCell, tHitCell, tol) || tHitCell > hit.T)
+    {
+      return;
+    }
+    this->DataSet->GetCell(cellId, cell);
+    if (cell->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId) &&
+      (t < hit.T || (t == hit.T && cellId < hit.CellId)))
+    {
+      hit.T = t;
+      std::copy_n(x, 3, hit.X);
+      std::copy_n(pcoords, 3, hit.PCoords);
+      hit.SubId = subId;
+      hit.CellId = cellId;
+    }
+  }
+
+  // Traverse the tree with a packet of lines, and return their closest
+  // intersections in hits.
+  void IntersectWithPacket(LinePacket& packet, double tol, vtkGenericCell* cell,
+    std::vector<PacketEntry>& stack, LineHit hits[PacketSize]);
+};
+
+//------------------------------------------------------------------------------
+// Build the tree with the binned surface area heuristic: a node is split
+// along the axis and the bin boundary minimizing the surface areas of the
+// children weighted by their numbers of cells, the cells being binned by the
+// centers of their bounds. The nodes larger than SubtreeSize are split first,
+// binning their cells in parallel. The subtrees below them are then built
+// concurrently, each in its own array, and appended to the tree. The splits
+// only depend on the cells of the nodes, so the tree does not depend on the
+// number of threads.
+template <typename T>
+struct BVHBuilder
+{
+  using TNode = BVHNode<T>;
+
+  struct Task
+  {
+    T Node;
+    T Begin;
+    T End;
+  };
+
+  // The bins of the three axes. Bin b of axis i is at i * NumberOfBins + b.
+  struct Bins
+  {
+    std::vector<double> Bounds;
+    std::vector<T> Counts;
+
+    void Initialize(int numBins)
+    {
+      this->Bounds.resize(18 * numBins);
+      this->Counts.assign(3 * numBins, 0);
+      for (int b = 0; b < 3 * numBins; ++b)
+      {
+        InitializeBounds(&this->Bounds[6 * b]);
+      }
+    }
+  };
+
+  const double* CellBounds;
+  T* CellIds;
+  int NumberOfBins;
+  T NumberOfCellsPerNode;
+  T SubtreeSize;
+
+  // Twice the center of the bounds of a cell along an axis
+  double GetCenter(T cellId, int axis) const
+  {
+    const double* bounds = this->CellBounds + 6 * static_cast<vtkIdType>(cellId);
+    return bounds[2 * axis] + bounds[2 * axis + 1];
+  }
+
+  int GetBin(T cellId, int axis, const double centerBounds[6], const double scale[3]) const
+  {
+    const int bin =
+      static_cast<int>((this->GetCenter(cellId, axis) - centerBounds[2 * axis]) * scale[axis]);
+    return bin < 0 ? 0 : (bin >= this->NumberOfBins ? this->NumberOfBins - 1 : bin);
+  }
+
+  // Compute the bounds of the cells [begin, end) and of their centers.
+  void ComputeBounds(T begin, T end, double bounds[6], double centerBounds[6], bool parallel)
+  {
+    auto computeBounds = [this](T first, T last, double* bds, double* centerBds) {
+      for (; first < last; ++first)
+      {
+        const T cellId = this->CellIds[first];
+        AddBounds(bds, this->CellBounds + 6 * static_cast<vtkIdType>(cellId));
+        for (int i = 0; i < 3; ++i)
+        {
+          const double center = this->GetCenter(cellId, i);
+          centerBds[2 * i] = std::min(centerBds[2 * i], center);
+          centerBds[2 * i + 1] = std::max(centerBds[2 * i + 1], center);
+        }
+      }
+    };
+
+    InitializeBounds(bounds);
+    InitializeBounds(centerBounds);
+    if (!parallel)
+    {
+      computeBounds(begin, end, bounds, centerBounds);
+      return;
+    }
+    std::array<double, 12> exemplar;
+    InitializeBounds(exemplar.data());
+    InitializeBounds(exemplar.data() + 6);
+    vtkSMPThreadLocal<std::array<double, 12>> tlBounds(exemplar);
+    vtkSMPTools::For(begin, end, [&](T first, T last) {
+      std::array<double, 12>& bds = tlBounds.Local();
+      computeBounds(first, last, bds.data(), bds.data() + 6);
+    });
+    for (auto& bds : tlBounds)
+    {
+      AddBounds(bounds, bds.data());
+      AddBounds(centerBounds, bds.data() + 6);
+    }
+  }
+
+  // Accumulate the cells [begin, end) in the bins of the three axes.
+  void FillBins(
+    T begin, T end, const double centerBounds[6], const double scale[3], Bins& bins, bool parallel)
+  {
+    auto fillBins = [this, centerBounds, scale](T first, T last, Bins& local) {
+      for (; first < last; ++first)
+      {
+        const T cellId = this->CellIds[first];
+        const double* cellBounds = this->CellBounds + 6 * static_cast<vtkIdType>(cellId);
+        for (int i = 0; i < 3; ++i)
+        {
+          if (scale[i] > 0.0)
+          {
+            const int b = i * this->NumberOfBins + this->GetBin(cellId, i, centerBounds, scale);
+            AddBounds(&local.Bounds[6 * b], cellBounds);
+            ++local.Counts[b];
+          }
+        }
+      }
+    };
+
+    bins.Initialize(this->NumberOfBins);
+    if (!parallel)
+    {
+      fillBins(begin, end, bins);
+      return;
+    }
+    vtkSMPThreadLocal<Bins> tlBins(bins);
+    vtkSMPTools::For(begin, end, [&](T first, T last) { fillBins(first, last, tlBins.Local()); });
+    for (auto& local : tlBins)
+    {
+      for (int b = 0; b < 3 * this->NumberOfBins; ++b)
+      {
+        AddBounds(&bins.Bounds[6 * b], &local.Bounds[6 * b]);
+        bins.Counts[b] += local.Counts[b];
+      }
+    }
+  }
+
+  // Compute the bounds of the node made of the cells [begin, end), and split
+  // it. Return the end of the cells of the first child, or end if the node
+  // is a leaf.
+  T Split(T begin, T end, double bounds[6], bool parallel)
+  {
+    double centerBounds[6];
+    this->ComputeBounds(begin, end, bounds, centerBounds, parallel);
+    if (end - begin <= this->NumberOfCellsPerNode)
+    {
+      return end;
+    }
+
+    // Bin the cells along the axes where their centers are spread
+    const int numBins = this->NumberOfBins;
+    double scale[3];
+    for (int i = 0; i < 3; ++i)
+    {
+      const double length = centerBounds[2 * i + 1] - centerBounds[2 * i];
+      scale[i] = (length > 0.0 ? numBins / length : 0.0);
+      if (!std::isfinite(scale[i]))
+      {
+        scale[i] = 0.0;
+      }
+    }
+    Bins bins;
+    this->FillBins(begin, end, centerBounds, scale, bins, parallel);
+
+    // Sweep the bins to find the split of least cost
+    int bestAxis = -1, bestBin = -1;
+    double bestCost = VTK_DOUBLE_MAX;
+    std::vector<double> rightAreas(numBins);
+    std::vector<T> rightCounts(numBins);
+    for (int i = 0; i < 3; ++i)
+    {
+      if (scale[i] <= 0.0)
+      {
+        continue;
+      }
+      const double* binBounds = &bins.Bounds[6 * i * numBins];
+      const T* binCounts = &bins.Counts[i * numBins];
+      double accumulated[6];
+      InitializeBounds(accumulated);
+      T count = 0;
+      for (int b = numBins - 1; b > 0; --b)
+      {
+        AddBounds(accumulated, binBounds + 6 * b);
+        count += binCounts[b];
+        rightAreas[b] = HalfArea(accumulated);
+        rightCounts[b] = count;
+      }
+      InitializeBounds(accumulated);
+      count = 0;
+      for (int b = 0; b < numBins - 1; ++b)
+      {
+        AddBounds(accumulated, binBounds + 6 * b);
+        count += binCounts[b];
+        if (count == 0 || rightCounts[b + 1] == 0)
+        {
+          continue;
+        }
+        const double cost = HalfArea(accumulated) * static_cast<double>(count) +
+          rightAreas[b + 1] * static_cast<double>(rightCounts[b + 1]);
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bestAxis = i;
+          bestBin = b;
+        }
+      }
+    }
+
+    // Cells with coincident centers cannot be binned: split them in halves.
+    if (bestAxis < 0)
+    {
+      return begin + (end - begin) / 2;
+    }
+    T* middle = std::partition(this->CellIds + begin, this->CellIds + end,
+      [&](T cellId) { return this->GetBin(cellId, bestAxis, centerBounds, scale) <= bestBin; });
+    return static_cast<T>(middle - this->CellIds);
+  }
+
+  // Process the tasks of the stack, adding the nodes to nodes. When deferred
+  // is provided, the nodes of at most SubtreeSize cells are moved to it
+  // instead of being split.
+  void Build(std::vector<TNode>& nodes, std::vector<Task>& stack, std::vector<Task>* deferred)
+  {
+    double bounds[6];
+    while (!stack.empty())
+    {
+      const Task task = stack.back();
+      stack.pop_back();
+      if (deferred && task.End - task.Begin <= this->SubtreeSize)
+      {
+        deferred->push_back(task);
+        continue;
+      }
+      const T middle = this->Split(task.Begin, task.End, bounds, deferred != nullptr);
+      TNode& node = nodes[task.Node];
+      node.SetBounds(bounds);
+      if (middle == task.End)
+      {
+        node.Index = task.Begin;
+        node.Count = task.End - task.Begin;
+        continue;
+      }
+      const T left = static_cast<T>(nodes.size());
+      node.Index = left;
+      node.Count = 0;
+      nodes.resize(nodes.size() + 2);
+      stack.push_back(Task{ static_cast<T>(left + 1), middle, task.End });
+      stack.push_back(Task{ left, task.Begin, middle });
+    }
+  }
+
+  void operator()(std::vector<TNode>& nodes, T numCells)
+  {
+    // Split the top of the tree
+    nodes.resize(1);
+    std::vector<Task> stack{ Task{ 0, 0, numCells } };
+    std::vector<Task> subtrees;
+    this->Build(nodes, stack, &subtrees);
+
+    // Build the subtrees concurrently. The root of each subtree is the first
+    // node of its array.
+    const vtkIdType numSubtrees = static_cast<vtkIdType>(subtrees.size());
+    std::vector<std::vector<TNode>> subtreeNodes(numSubtrees);
+    vtkSMPTools::For(0, numSubtrees, 1, [&](vtkIdType begin, vtkIdType end) {
+      std::vector<Task> subtreeStack;
+      for (; begin < end; ++begin)
+      {
+        subtreeNodes[begin].resize(1);
+        subtreeStack.push_back(Task{ 0, subtrees[begin].Begin, subtrees[begin].End });
+        this->Build(subtreeNodes[begin], subtreeStack, nullptr);
+      }
+    });
+
+    // Append the subtrees to the tree, the roots replacing the deferred nodes
+    std::vector<T> offsets(numSubtrees + 1);
+    offsets[0] = static_cast<T>(nodes.size());
+    for (vtkIdType i = 0; i < numSubtrees; ++i)
+    {
+      offsets[i + 1] = offsets[i] + static_cast<T>(subtreeNodes[i].size() - 1);
+    }
+    nodes.resize(offsets[numSubtrees]);
+    vtkSMPTools::For(0, numSubtrees, [&](vtkIdType begin, vtkIdType end) {
+      for (; begin < end; ++begin)
+      {
+        const std::vector<TNode>& local = subtreeNodes[begin];
+        for (size_t i = 0; i < local.size(); ++i)
+        {
+          TNode node = local[i];
+          if (!node.IsLeaf())
+          {
+            node.Index += offsets[begin] - 1;
+          }
+          nodes[i == 0 ? subtrees[begin].Node : offsets[begin] + static_cast<T>(i) - 1] = node;
+        }
+      }
+    });
+  }
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+void BVHTree<T>::Build(T numCells, int numberOfBins, int numberOfCellsPerNode)
+{
+  this->CellIdsSharedPtr = std::make_shared<std::vector<T>>(numCells);
+  this->NodesSharedPtr = std::make_shared<std::vector<TNode>>();
+  std::vector<T>& cellIds = *this->CellIdsSharedPtr;
+  vtkSMPTools::For(0, numCells, [&](T begin, T end) {
+    std::iota(cellIds.begin() + begin, cellIds.begin() + end, begin);
+  });
+
+  BVHBuilder<T> builder;
+  builder.CellBounds = this->CellBounds;
+  builder.CellIds = cellIds.data();
+  builder.NumberOfBins = numberOfBins;
+  builder.NumberOfCellsPerNode = static_cast<T>(numberOfCellsPerNode);
+  builder.SubtreeSize = std::max<T>(
+    4096, numCells / static_cast<T>(8 * vtkSMPTools::GetEstimatedNumberOfThreads()));
+  builder(*this->NodesSharedPtr, numCells);
+
+  this->Nodes = this->NodesSharedPtr->data();
+  this->CellIds = cellIds.data();
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+double BVHTree<T>::ComputeCost() const
+{
+  auto halfArea = [](const float bounds[6]) {
+    const double bds[6] = { bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5] };
+    return HalfArea(bds);
+  };
+  double cost = 0.0;
+  for (vtkIdType i = 0; i < static_cast<vtkIdType>(this->NodesSharedPtr->size()); ++i)
+  {
+    if (this->Nodes[i].IsLeaf())
+    {
+      cost += this->Nodes[i].Count * halfArea(this->Nodes[i].Bounds);
+    }
+  }
+  const double rootArea = halfArea(this->Nodes[0].Bounds);
+  return rootArea > 0.0 ? cost / rootArea : cost;
+}
+
+//------------------------------------------------------------------------------
+// Refit the tree after the points of the dataset moved: the topology of the
+// tree is kept, and the bounds of the nodes are recomputed bottom-up from the
+// new cell bounds. The nodes are copied, since they may be shared with the
+// shallow copies of the locator.
+template <typename T>
+bool BVHTree<T>::Refit(const double* cellBounds, double costThreshold)
+{
+  if (this->BuildCost < 0.0)
+  {
+    this->BuildCost = this->ComputeCost();
+  }
+  this->CellBounds = cellBounds;
+
+  auto nodesSharedPtr = std::make_shared<std::vector<TNode>>(*this->NodesSharedPtr);
+  TNode* nodes = nodesSharedPtr->data();
+  const auto numNodes = static_cast<vtkIdType>(nodesSharedPtr->size());
+  vtkSMPTools::For(0, numNodes, [&](vtkIdType begin, vtkIdType end) {
+    double bounds[6];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      TNode& node = nodes[i];
+      if (!node.IsLeaf())
+      {
+        continue;
+      }
+      InitializeBounds(bounds);
+      for (T j = node.Index; j < node.Index + node.Count; ++j)
+      {
+        AddBounds(bounds, cellBounds + 6 * static_cast<vtkIdType>(this->CellIds[j]));
+      }
+      node.SetBounds(bounds);
+    }
+  });
+
+  // The children are stored after their parent. The bounds of the leaves
+  // being rounded outward, those of the interior nodes are exact unions.
+  for (vtkIdType i = numNodes - 1; i >= 0; --i)
+  {
+    TNode& node = nodes[i];
+    if (node.IsLeaf())
+    {
+      continue;
+    }
+    const TNode& left = nodes[node.Index];
+    const TNode& right = nodes[node.Index + 1];
+    for (int j = 0; j < 3; ++j)
+    {
+      node.Bounds[2 * j] = std::min(left.Bounds[2 * j], right.Bounds[2 * j]);
+      node.Bounds[2 * j + 1] = std::max(left.Bounds[2 * j + 1], right.Bounds[2 * j + 1]);
+    }
+  }
+  this->NodesSharedPtr = nodesSharedPtr;
+  this->Nodes = nodes;
+
+  return this->ComputeCost() <= costThreshold * this->BuildCost;
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+vtkIdType BVHTree<T>::FindCell(
+  const double x[3], vtkGenericCell* cell, int& subId, double pcoords[3], double* weights)
+{
+  if (!InsideBounds(x, this->Nodes[0].Bounds))
+  {
+    return -1;
+  }
+
+  double dist2;
+  std::vector<T> stack{ 0 };
+  while (!stack.empty())
+  {
+    const TNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (node.IsLeaf())
+    {
+      for (T i = node.Index; i < node.Index + node.Count; ++i)
+      {
+        const T cellId = this->CellIds[i];
+        if (InsideBounds(x, this->CellBounds + 6 * static_cast<vtkIdType>(cellId)))
+        {
+          this->DataSet->GetCell(cellId, cell);
+          if (cell->EvaluatePosition(x, nullptr, subId, pcoords, dist2, weights) == 1)
+          {
+            return cellId;
+          }
+        }
+      }
+    }
+    else
+    {
+      for (T child = node.Index + 1; child >= node.Index; --child)
+      {
+        if (InsideBounds(x, this->Nodes[child].Bounds))
+        {
+          stack.push_back(child);
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+// The tree is traversed front to back, skipping the nodes entered after the
+// closest intersection found so far.
+template <typename T>
+int BVHTree<T>::IntersectWithLine(const double p1[3], const double p2[3], double tol, double& t,
+  double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell)
+{
+  double dir[3], invDir[3], tEntry;
+  InitializeLine(p1, p2, dir, invDir);
+  const double pad = GetPadding(tol);
+  LineHit hit;
+  cellId = -1;
+
+  if (!IntersectBounds(this->Nodes[0].Bounds, p1, invDir, pad, tEntry))
+  {
+    return 0; // No intersections possible, line is outside the locator
+  }
+  std::vector<NodeEntry> stack;
+  stack.reserve(64);
+  stack.push_back(NodeEntry{ 0, tEntry });
+  while (!stack.empty())
+  {
+    const NodeEntry entry = stack.back();
+    stack.pop_back();
+    if (entry.TEntry > hit.T)
+    {
+      continue;
+    }
+    const TNode& node = this->Nodes[entry.Node];
+    if (node.IsLeaf())
+    {
+      for (T i = node.Index; i < node.Index + node.Count; ++i)
+      {
+        this->IntersectCell(this->CellIds[i], p1, p2, dir, tol, cell, hit);
+      }
+      continue;
+    }
+    double tLeft, tRight;
+    const T left = node.Index, right = node.Index + 1;
+    const bool hitLeft =
+      IntersectBounds(this->Nodes[left].Bounds, p1, invDir, pad, tLeft) && tLeft <= hit.T;
+    const bool hitRight =
+      IntersectBounds(this->Nodes[right].Bounds, p1, invDir, pad, tRight) && tRight <= hit.T;
+    // Push the farthest child first, so that the nearest is processed first
+    if (hitLeft && hitRight)
+    {
+      if (tLeft <= tRight)
+      {
+        stack.push_back(NodeEntry{ right, tRight });
+        stack.push_back(NodeEntry{ left, tLeft });
+      }
+      else
+      {
+        stack.push_back(NodeEntry{ left, tLeft });
+        stack.push_back(NodeEntry{ right, tRight });
+      }
+    }
+    else if (hitLeft)
+    {
+      stack.push_back(NodeEntry{ left, tLeft });
+    }
+    else if (hitRight)
+    {
+      stack.push_back(NodeEntry{ right, tRight });
+    }
+  }
+
+  // If a cell has been intersected, recover the information and return.
+  if (hit.CellId < 0)
+  {
+    return 0;
+  }
+  this->DataSet->GetCell(hit.CellId, cell);
+  t = hit.T;
+  std::copy_n(hit.X, 3, x);
+  std::copy_n(hit.PCoords, 3, pcoords);
+  subId = hit.SubId;
+  cellId = hit.CellId;
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+// Same traversal as IntersectWithLine(), for all the lines of the packet at
+// once: a node is visited when at least one of the lines hits it before its
+// closest intersection, and the cells of the leaves are only tested against
+// these lines.
+template <typename T>
+void BVHTree<T>::IntersectWithPacket(LinePacket& packet, double tol, vtkGenericCell* cell,
+  std::vector<PacketEntry>& stack, LineHit hits[PacketSize])
+{
+  const double pad = GetPadding(tol);
+  const unsigned int active = (1u << packet.Size) - 1;
+  for (int l = 0; l < PacketSize; ++l)
+  {
+    hits[l] = LineHit();
+  }
+
+  stack.clear();
+  PacketEntry entry;
+  entry.Node = 0;
+  entry.Mask = packet.IntersectBounds(this->Nodes[0].Bounds, pad, active, entry.TEntry);
+  if (entry.Mask)
+  {
+    stack.push_back(entry);
+  }
+  PacketEntry children[2];
+  while (!stack.empty())
+  {
+    entry = stack.back();
+    stack.pop_back();
+    unsigned int mask = entry.Mask;
+    for (int l = 0; l < packet.Size; ++l)
+    {
+      if (entry.TEntry[l] > packet.TBest[l])
+      {
+        mask &= ~(1u << l);
+      }
+    }
+    if (!mask)
+    {
+      continue;
+    }
+    const TNode& node = this->Nodes[entry.Node];
+    if (node.IsLeaf())
+    {
+      for (T i = node.Index; i < node.Index + node.Count; ++i)
+      {
+        for (int l = 0; l < packet.Size; ++l)
+        {
+          if (mask & (1u << l))
+          {
+            this->IntersectCell(
+              this->CellIds[i], packet.P1[l], packet.P2[l], packet.Dir[l], tol, cell, hits[l]);
+            packet.TBest[l] = hits[l].T;
+          }
+        }
+      }
+      continue;
+    }
+    // Visit first the child the lines enter first
+    double tNear[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX };
+    for (int c = 0; c < 2; ++c)
+    {
+      children[c].Node = node.Index + c;
+      children[c].Mask =
+        packet.IntersectBounds(this->Nodes[children[c].Node].Bounds, pad, mask, children[c].TEntry);
+      for (int l = 0; l < packet.Size; ++l)
+      {
+        if (children[c].Mask & (1u << l))
+        {
+          tNear[c] = std::min(tNear[c], children[c].TEntry[l]);
+        }
+      }
+    }
+    const int first = (tNear[0] <= tNear[1] ? 0 : 1);
+    if (children[1 - first].Mask)
+    {
+      stack.push_back(children[1 - first]);
+    }
+    if (children[first].Mask)
+    {
+      stack.push_back(children[first]);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// The ordered lines are grouped in packets of spatially close lines, which
+// are processed in parallel.
+template <typename T>
+void BVHTree<T>::IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol,
+  const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  const vtkIdType numLines = cellIds->GetNumberOfIds();
+  const vtkIdType numPackets = (numLines + PacketSize - 1) / PacketSize;
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPThreadLocal<std::vector<PacketEntry>> tlStack;
+  vtkSMPTools::For(0, numPackets, [&](vtkIdType begin, vtkIdType end) {
+    // Cell point ids are bump-allocated from the thread arena for the chunk.
+    vtkMemoryArena::Scope scope;
+    vtkGenericCell* cell = tlCell.Local();
+    cell->SetArena(scope.GetArena());
+    std::vector<PacketEntry>& stack = tlStack.Local();
+    LinePacket packet;
+    LineHit hits[PacketSize];
+    const double miss[3] = { 0.0, 0.0, 0.0 };
+    for (; begin < end; ++begin)
+    {
+      const vtkIdType* lineIds = order + begin * PacketSize;
+      packet.Initialize(p1, p2, lineIds,
+        static_cast<int>(std::min<vtkIdType>(PacketSize, numLines - begin * PacketSize)));
+      this->IntersectWithPacket(packet, tol, cell, stack, hits);
+      for (int l = 0; l < packet.Size; ++l)
+      {
+        const bool found = hits[l].CellId >= 0;
+        cellIds->SetId(lineIds[l], hits[l].CellId);
+        if (t)
+        {
+          t->SetValue(lineIds[l], found ? hits[l].T : 0.0);
+        }
+        if (x)
+        {
+          x->SetPoint(lineIds[l], found ? hits[l].X : miss);
+        }
+      }
+    }
+  });
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+int BVHTree<T>::IntersectWithLine(const double p1[3], const double p2[3], double tol,
+  vtkPoints* points, vtkIdList* cellIds, vtkGenericCell* cell)
+{
+  // Initialize the list of points/cells
+  if (points)
+  {
+    points->Reset();
+  }
+  if (cellIds)
+  {
+    cellIds->Reset();
+  }
+  double dir[3], invDir[3], tEntry;
+  InitializeLine(p1, p2, dir, invDir);
+  const double pad = GetPadding(tol);
+  if (!IntersectBounds(this->Nodes[0].Bounds, p1, invDir, pad, tEntry))
+  {
+    return 0; // No intersections possible, line is outside the locator
+  }
+
+  // Each cell belongs to a single leaf, so it is tested only once
+  std::vector<LineIntersection> intersections;
+  double tHitCell, xHitCell[3], t, x[3], pcoords[3];
+  int subId;
+  std::vector<T> stack{ 0 };
+  while (!stack.empty())
+  {
+    const TNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (!node.IsLeaf())
+    {
+      for (T child = node.Index; child <= node.Index + 1; ++child)
+      {
+        if (IntersectBounds(this->Nodes[child].Bounds, p1, invDir, pad, tEntry))
+        {
+          stack.push_back(child);
+        }
+      }
+      continue;
+    }
+    for (T i = node.Index; i < node.Index + node.Count; ++i)
+    {
+      const T cellId = this->CellIds[i];
+      const double* cellBounds = this->CellBounds + 6 * static_cast<vtkIdType>(cellId);
+      if (!vtkBox::IntersectBox(cellBounds, p1, dir, xHitCell, tHitCell, tol))
+      {
+        continue;
+      }
+      if (!cell)
+      {
+        intersections.push_back(
+          LineIntersection{ cellId, { xHitCell[0], xHitCell[1], xHitCell[2] }, tHitCell });
+        continue;
+      }
+      this->DataSet->GetCell(cellId, cell);
+      if (cell->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId))
+      {
+        intersections.push_back(LineIntersection{ cellId, { x[0], x[1], x[2] }, t });
+      }
+    }
+  }
+
+  // if we had intersections, sort them by increasing t
+  if (intersections.empty())
+  {
+    return 0;
+  }
+  std::sort(intersections.begin(), intersections.end(),
+    [](const LineIntersection& a, const LineIntersection& b) {
+      return a.T < b.T || (a.T == b.T && a.CellId < b.CellId);
+    });
+  const vtkIdType numIntersections = static_cast<vtkIdType>(intersections.size());
+  if (points)
+  {
+    points->SetNumberOfPoints(numIntersections);
+    for (vtkIdType i = 0; i < numIntersections; ++i)
+    {
+      points->SetPoint(i, intersections[i].X);
+    }
+  }
+  if (cellIds)
+  {
+    cellIds->SetNumberOfIds(numIntersections);
+    for (vtkIdType i = 0; i < numIntersections; ++i)
+    {
+      cellIds->SetId(i, intersections[i].CellId);
+    }
+  }
+  return 1;
+}
+
+//------------------------------------------------------------------------------
+// The nodes are processed by increasing distance to the point, until they
+// are further away than the closest point found so far.
+template <typename T>
+vtkIdType BVHTree<T>::FindClosestPointWithinRadius(const double x[3], double radius,
+  double closestPoint[3], vtkGenericCell* cell, vtkIdType& closestCellId, int& closestSubId,
+  double& minDist2, int& inside)
+{
+  std::vector<double> weights(this->MaxCellSize);
+  double pcoords[3], point[3], dist2;
+  int subId, stat;
+  vtkIdType retVal = 0;
+
+  using NodeDistance = std::pair<double, T>;
+  std::priority_queue<NodeDistance, std::vector<NodeDistance>, std::greater<NodeDistance>> queue;
+  queue.push(std::make_pair(Distance2ToBounds(x, this->Nodes[0].Bounds), 0));
+
+  // minimum squared distance to the closest point
+  minDist2 = radius * radius;
+  while (!queue.empty())
+  {
+    // stop if bounding box is further away than current closest point
+    if (queue.top().first > minDist2)
+    {
+      break;
+    }
+    const TNode& node = this->Nodes[queue.top().second];
+    queue.pop();
+
+    if (!node.IsLeaf())
+    {
+      for (T child = node.Index; child <= node.Index + 1; ++child)
+      {
+        const double childDist2 = Distance2ToBounds(x, this->Nodes[child].Bounds);
+        if (childDist2 <= minDist2)
+        {
+          queue.push(std::make_pair(childDist2, child));
+        }
+      }
+      continue;
+    }
+    for (T i = node.Index; i < node.Index + node.Count; ++i)
+    {
+      const T cellId = this->CellIds[i];
+      // compute distance to cell only if distance to bounding box smaller than minDist2
+      if (Distance2ToBounds(x, this->CellBounds + 6 * static_cast<vtkIdType>(cellId)) < minDist2)
+      {
+        this->DataSet->GetCell(cellId, cell);
+        // stat==(-1) is numerical error; stat==0 means outside; stat=1 means inside.
+        stat = cell->EvaluatePosition(x, point, subId, pcoords, dist2, weights.data());
+        if (stat != -1 && dist2 < minDist2)
+        {
+          retVal = 1;
+          inside = stat;
+          minDist2 = dist2;
+          closestCellId = cellId;
+          closestSubId = subId;
+          std::copy_n(point, 3, closestPoint);
+        }
+      }
+    }
+  }
+  return retVal;
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+void BVHTree<T>::FindCellsWithinBounds(const double bbox[6], vtkIdList* cells)
+{
+  // Initialize the list of cells
+  if (!cells)
+  {
+    return;
+  }
+  cells->Reset();
+
+  vtkBoundingBox testBox(bbox);
+  auto overlaps = [bbox](const float bounds[6]) {
+    return bounds[0] <= bbox[1] && bbox[0] <= bounds[1] && bounds[2] <= bbox[3] &&
+      bbox[2] <= bounds[3] && bounds[4] <= bbox[5] && bbox[4] <= bounds[5];
+  };
+  if (!overlaps(this->Nodes[0].Bounds))
+  {
+    return;
+  }
+  std::vector<T> stack{ 0 };
+  while (!stack.empty())
+  {
+    const TNode& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (!node.IsLeaf())
+    {
+      for (T child = node.Index + 1; child >= node.Index; --child)
+      {
+        if (overlaps(this->Nodes[child].Bounds))
+        {
+          stack.push_back(child);
+        }
+      }
+      continue;
+    }
+    for (T i = node.Index; i < node.Index + node.Count; ++i)
+    {
+      const T cellId = this->CellIds[i];
+      vtkBoundingBox cellBox(this->CellBounds + 6 * static_cast<vtkIdType>(cellId));
+      if (testBox.Intersects(cellBox))
+      {
+        cells->InsertNextId(cellId);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// Add the six faces of a box to the polydata.
+void AddBox(vtkPoints* points, vtkCellArray* polys, const float bounds[6])
+{
+  vtkIdType ptIds[8];
+  for (int i = 0; i < 8; ++i)
+  {
+    ptIds[i] = points->InsertNextPoint(
+      bounds[i & 1], bounds[2 + ((i >> 1) & 1)], bounds[4 + ((i >> 2) & 1)]);
+  }
+  static const int faces[6][4] = { { 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 1, 5, 4 },
+    { 2, 6, 7, 3 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 } };
+  for (int f = 0; f < 6; ++f)
+  {
+    const vtkIdType face[4] = { ptIds[faces[f][0]], ptIds[faces[f][1]], ptIds[faces[f][2]],
+      ptIds[faces[f][3]] };
+    polys->InsertNextCell(4, face);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Produce the boxes of the nodes at the given depth, or of the leaves if the
+// level is -1.
+template <typename T>
+void BVHTree<T>::GenerateRepresentation(int level, vtkPolyData* pd)
+{
+  vtkNew<vtkPoints> pts;
+  pts->SetDataTypeToFloat();
+  vtkNew<vtkCellArray> polys;
+
+  std::vector<std::pair<T, int>> stack{ std::make_pair(0, 0) };
+  while (!stack.empty())
+  {
+    const TNode& node = this->Nodes[stack.back().first];
+    const int depth = stack.back().second;
+    stack.pop_back();
+    if (depth == level || (level == -1 && node.IsLeaf()))
+    {
+      AddBox(pts, polys, node.Bounds);
+    }
+    else if (!node.IsLeaf())
+    {
+      stack.push_back(std::make_pair(static_cast<T>(node.Index + 1), depth + 1));
+      stack.push_back(std::make_pair(node.Index, depth + 1));
+    }
+  }
+  pd->SetPoints(pts);
+  pd->SetPolys(polys);
+}
+VTK_ABI_NAMESPACE_END
+} // anonymous namespace
+
+VTK_ABI_NAMESPACE_BEGIN
+//------------------------------------------------------------------------------
+vtkBVHCellLocator::vtkBVHCellLocator()
+{
+  this->NumberOfCellsPerNode = 4;
+  this->NumberOfBins = 16;
+  this->CacheCellBounds = 1; // always cached
+  this->Tree = nullptr;
+}
+
+//------------------------------------------------------------------------------
+vtkBVHCellLocator::~vtkBVHCellLocator()
+{
+  this->FreeSearchStructure();
+  this->FreeCellBounds();
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::FreeSearchStructure()
+{
+  delete this->Tree;
+  this->Tree = nullptr;
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::BuildLocator()
+{
+  // don't rebuild if build time is newer than modified and dataset modified time
+  if (this->Tree && this->BuildTime > this->MTime && this->BuildTime > this->DataSet->GetMTime())
+  {
+    return;
+  }
+  // don't rebuild if UseExistingSearchStructure is ON and a search structure already exists
+  if (this->Tree && this->UseExistingSearchStructure)
+  {
+    this->BuildTime.Modified();
+    vtkDebugMacro(<< "BuildLocator exited - UseExistingSearchStructure");
+    return;
+  }
+  // refit instead of rebuilding if RefitSearchStructure is ON and a search structure exists
+  if (this->Tree && this->RefitSearchStructure && this->RefitLocatorInternal())
+  {
+    this->Refitted = true;
+    this->BuildTime.Modified();
+    vtkDebugMacro(<< "BuildLocator exited - RefitSearchStructure");
+    return;
+  }
+  this->BuildLocatorInternal();
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::ForceBuildLocator()
+{
+  this->BuildLocatorInternal();
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::BuildLocatorInternal()
+{
+  vtkDebugMacro(<< "Building BVH cell locator");
+  this->Refitted = false;
+  vtkIdType numCells;
+  if (!this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1)
+  {
+    vtkErrorMacro(<< "No cells to build");
+    return;
+  }
+  this->FreeSearchStructure();
+
+  // The cell bounds are always cached, the tree being built from them
+  this->CacheCellBounds = 1;
+  this->ComputeCellBounds();
+
+  // Depending on problem size, different types are used.
+  if (numCells >= VTK_INT_MAX)
+  {
+    this->LargeIds = true;
+    auto tree = new BVHTree<vtkIdType>(this->DataSet, this->CellBounds);
+    tree->Build(numCells, this->NumberOfBins, this->NumberOfCellsPerNode);
+    this->Tree = tree;
+  }
+  else
+  {
+    this->LargeIds = false;
+    auto tree = new BVHTree<int>(this->DataSet, this->CellBounds);
+    tree->Build(static_cast<int>(numCells), this->NumberOfBins, this->NumberOfCellsPerNode);
+    this->Tree = tree;
+  }
+  this->BuildTime.Modified();
+}
+
+//------------------------------------------------------------------------------
+// Keep the tree, and only update the bounds of its nodes.
+bool vtkBVHCellLocator::RefitLocatorInternal()
+{
+  if (this->DataSet->GetNumberOfCells() != this->Tree->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkDebugMacro(<< "Refitting BVH cell locator");
+  this->CacheCellBounds = 1;
+  this->ComputeCellBounds();
+  return this->Tree->Refit(this->CellBounds, this->RefitCostThreshold);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::GetNumberOfNodes()
+{
+  return this->Tree ? this->Tree->GetNumberOfNodes() : 0;
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::FindCell(
+  double x[3], double, vtkGenericCell* cell, int& subId, double pcoords[3], double* weights)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return -1;
+  }
+  return this->Tree->FindCell(x, cell, subId, pcoords, weights);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::FindClosestPointWithinRadius(double x[3], double radius,
+  double closestPoint[3], vtkGenericCell* cell, vtkIdType& cellId, int& subId, double& dist2,
+  int& inside)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return 0;
+  }
+  return this->Tree->FindClosestPointWithinRadius(
+    x, radius, closestPoint, cell, cellId, subId, dist2, inside);
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::FindCellsWithinBounds(double* bbox, vtkIdList* cells)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return;
+  }
+  this->Tree->FindCellsWithinBounds(bbox, cells);
+}
+
+//------------------------------------------------------------------------------
+int vtkBVHCellLocator::IntersectWithLine(const double p1[3], const double p2[3], double tol,
+  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return 0;
+  }
+  return this->Tree->IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId, cell);
+}
+
+//------------------------------------------------------------------------------
+int vtkBVHCellLocator::IntersectWithLine(const double p1[3], const double p2[3], double tol,
+  vtkPoints* points, vtkIdList* cellIds, vtkGenericCell* cell)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return 0;
+  }
+  return this->Tree->IntersectWithLine(p1, p2, tol, points, cellIds, cell);
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::IntersectWithLines(
+  vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  const vtkIdType numLines = p1->GetNumberOfPoints();
+  if (p2->GetNumberOfPoints() != numLines)
+  {
+    vtkErrorMacro(<< "The end points of the lines differ in number");
+    cellIds->Reset();
+    return;
+  }
+  vtkAbstractCellLocator::InitializeQueryOutputs(numLines, cellIds, t, 1, x);
+  this->BuildLocator();
+  if (numLines < 1 || !this->Tree)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    return;
+  }
+  std::vector<vtkIdType> order;
+  vtkAbstractCellLocator::ComputeQueryOrder(p1, order);
+  this->Tree->IntersectWithLines(p1, p2, tol, order.data(), cellIds, t, x);
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::GenerateRepresentation(int level, vtkPolyData* pd)
+{
+  this->BuildLocator();
+  if (!this->Tree)
+  {
+    return;
+  }
+  this->Tree->GenerateRepresentation(level, pd);
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::ShallowCopy(vtkAbstractCellLocator* locator)
+{
+  vtkBVHCellLocator* cellLocator = vtkBVHCellLocator::SafeDownCast(locator);
+  if (!cellLocator)
+  {
+    vtkErrorMacro("Cannot cast " << locator->GetClassName() << " to vtkBVHCellLocator.");
+    return;
+  }
+  // we only copy what's actually used by vtkBVHCellLocator
+
+  // vtkLocator parameters
+  this->SetDataSet(cellLocator->GetDataSet());
+  this->SetUseExistingSearchStructure(cellLocator->GetUseExistingSearchStructure());
+
+  // vtkAbstractCellLocator parameters
+  this->SetNumberOfCellsPerNode(cellLocator->GetNumberOfCellsPerNode());
+  this->CacheCellBounds = cellLocator->CacheCellBounds;
+  this->CellBoundsSharedPtr = cellLocator->CellBoundsSharedPtr; // This is important
+  this->CellBounds = this->CellBoundsSharedPtr.get() ? this->CellBoundsSharedPtr->data() : nullptr;
+
+  // vtkBVHCellLocator parameters
+  this->NumberOfBins = cellLocator->NumberOfBins;
+  this->LargeIds = cellLocator->LargeIds;
+  this->FreeSearchStructure();
+  this->Tree = cellLocator->Tree ? cellLocator->Tree->ShallowCopy(this->CellBounds) : nullptr;
+}
+
+//------------------------------------------------------------------------------
+void vtkBVHCellLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Number Of Bins: " << this->NumberOfBins << "\n";
+  os << indent << "Number Of Nodes: " << this->GetNumberOfNodes() << "\n";
+  os << indent << "Large IDs: " << this->LargeIds << "\n";
+}
+VTK_ABI_NAMESPACE_END
@@ -0,0 +1,207 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBVHCellLocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkBVHCellLocator
+ * @brief   cell locator based on a bounding volume hierarchy
+ *
+ * vtkBVHCellLocator is a type of vtkAbstractCellLocator that organizes the
+ * cells in a bounding volume hierarchy (BVH): a binary tree of axis-aligned
+ * boxes where each cell is referenced by exactly one leaf. The tree is split
+ * with the surface area heuristic (SAH), evaluated over a fixed number of
+ * bins along each axis, so that the boxes adapt to cells of very different
+ * sizes, as found in CAD meshes. This makes it well suited to ray queries
+ * (IntersectWithLine), for which uniform subdivisions such as vtkCellLocator
+ * and vtkStaticCellLocator degrade.
+ *
+ * The tree is built in parallel (via vtkSMPTools): the large nodes at the top
+ * of the tree are binned in parallel, and the subtrees below them are built
+ * concurrently. The resulting tree does not depend on the number of threads.
+ * The nodes are stored compactly in a single array, with single precision
+ * bounds rounded outward (32 bytes per node unless large ids are used).
+ * IntersectWithLines() traverses the tree with packets of spatially coherent
+ * lines, testing the boxes against all the lines of a packet at once. When
+ * only the point coordinates change (e.g., a deforming mesh), the tree can be
+ * refit instead of rebuilt (see RefitSearchStructure): its topology is kept,
+ * and the bounds of the nodes are recomputed from the new cell bounds.
+ *
+ * vtkBVHCellLocator utilizes the following parent class parameters:
+ * - NumberOfCellsPerNode        (default 4)
+ * - UseExistingSearchStructure  (default false)
+ * - RefitSearchStructure        (default false)
+ *
+ * vtkBVHCellLocator does NOT utilize the following parameters:
+ * - CacheCellBounds             (always cached)
+ * - Automatic
+ * - Level
+ * - MaxLevel
+ * - Tolerance
+ * - RetainCellLists
+ *
+ * @warning
+ * This class is templated. It may run slower than serial execution if the code
+ * is not optimized during compilation. Build in Release or ReleaseWithDebugInfo.
+ *
+ * @sa
+ * vtkAbstractCellLocator vtkCellLocator vtkStaticCellLocator vtkCellTreeLocator
+ * vtkModifiedBSPTree vtkOBBTree
+ */
+
+#ifndef vtkBVHCellLocator_h
+#define vtkBVHCellLocator_h
+
+#include "vtkAbstractCellLocator.h"
+#include "vtkCommonDataModelModule.h" // For export macro
+
+// Forward declarations for PIMPL
+VTK_ABI_NAMESPACE_BEGIN
+struct vtkBVHTree;
+
+class VTKCOMMONDATAMODEL_EXPORT vtkBVHCellLocator : public vtkAbstractCellLocator
+{
+public:
+  ///@{
+  /**
+   * Standard methods to instantiate, print and obtain type-related information.
+   */
+  static vtkBVHCellLocator* New();
+  vtkTypeMacro(vtkBVHCellLocator, vtkAbstractCellLocator);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+  ///@}
+
+  ///@{
+  /**
+   * Set/Get the number of bins along each axis used to evaluate the surface
+   * area heuristic when splitting a node. More bins give better splits at a
+   * higher build cost. Default is 16.
+   */
+  vtkSetClampMacro(NumberOfBins, int, 2, 256);
+  vtkGetMacro(NumberOfBins, int);
+  ///@}
+
+  /**
+   * Inform the user as to whether large ids are being used. This flag only
+   * has meaning after the locator has been built. Large ids are used when the
+   * number of cells is >= VTK_INT_MAX. Note that LargeIds are only available
+   * on 64-bit architectures.
+   */
+  bool GetLargeIds() { return this->LargeIds; }
+
+  /**
+   * Return the number of nodes of the tree. This only has meaning after the
+   * locator has been built.
+   */
+  vtkIdType GetNumberOfNodes();
+
+  // Re-use any superclass signatures that we don't override.
+  using vtkAbstractCellLocator::FindCell;
+  using vtkAbstractCellLocator::FindClosestPoint;
+  using vtkAbstractCellLocator::FindClosestPointWithinRadius;
+  using vtkAbstractCellLocator::IntersectWithLine;
+
+  /**
+   * Return intersection point (if any) AND the cell which was intersected by
+   * the finite line. The cell is returned as a cell id and as a generic cell.
+   * When several cells are hit at the same closest t, the one with the
+   * smallest id is returned.
+   *
+   * For other IntersectWithLine signatures, see vtkAbstractCellLocator.
+   */
+  int IntersectWithLine(const double a0[3], const double a1[3], double tol, double& t, double x[3],
+    double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell) override;
+
+  /**
+   * Take the passed line segment and intersect it with the data set.
+   * The return value of the function is 0 if no intersections were found.
+   * For each intersection with the bounds of a cell or with a cell (if a cell is provided),
+   * the points and cellIds have the relevant information added sorted by t.
+   * If points or cellIds are nullptr pointers, then no information is generated for that list.
+   *
+   * For other IntersectWithLine signatures, see vtkAbstractCellLocator.
+   */
+  int IntersectWithLine(const double p1[3], const double p2[3], const double tol, vtkPoints* points,
+    vtkIdList* cellIds, vtkGenericCell* cell) override;
+
+  /**
+   * Return the closest point within a specified radius and the cell which is
+   * closest to the point x. The closest point is somewhere on a cell, it
+   * need not be one of the vertices of the cell. This method returns 1 if a
+   * point is found within the specified radius. If there are no cells within
+   * the specified radius, the method returns 0 and the values of
+   * closestPoint, cellId, subId, and dist2 are undefined. If a closest point
+   * is found, inside returns the return value of the EvaluatePosition call to
+   * the closest cell; inside(=1) or outside(=0).
+   */
+  vtkIdType FindClosestPointWithinRadius(double x[3], double radius, double closestPoint[3],
+    vtkGenericCell* cell, vtkIdType& cellId, int& subId, double& dist2, int& inside) override;
+
+  /**
+   * Return a list of unique cell ids inside of a given bounding box. The
+   * user must provide the vtkIdList to populate.
+   */
+  void FindCellsWithinBounds(double* bbox, vtkIdList* cells) override;
+
+  /**
+   * Find the cell containing a given point. returns -1 if no cell found
+   * the cell parameters are copied into the supplied variables, a cell must
+   * be provided to store the information.
+   *
+   * For other FindCell signatures, see vtkAbstractCellLocator.
+   */
+  vtkIdType FindCell(double x[3], double vtkNotUsed(tol2), vtkGenericCell* cell, int& subId,
+    double pcoords[3], double* weights) override;
+
+  /**
+   * Batched IntersectWithLine(). The lines are sorted in a spatially coherent
+   * order and grouped in packets, each traversing the tree once for all of
+   * its lines. The results are those of IntersectWithLine(). See
+   * vtkAbstractCellLocator.
+   */
+  void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds,
+    vtkDoubleArray* t = nullptr, vtkPoints* x = nullptr) override;
+
+  ///@{
+  /**
+   * Satisfy vtkLocator abstract interface.
+   */
+  void GenerateRepresentation(int level, vtkPolyData* pd) override;
+  void FreeSearchStructure() override;
+  void BuildLocator() override;
+  void ForceBuildLocator() override;
+  ///@}
+
+  /**
+   * Shallow copy of a vtkBVHCellLocator.
+   */
+  void ShallowCopy(vtkAbstractCellLocator* locator) override;
+
+protected:
+  vtkBVHCellLocator();
+  ~vtkBVHCellLocator() override;
+
+  void BuildLocatorInternal() override;
+  bool RefitLocatorInternal() override;
+
+  int NumberOfBins;
+  bool LargeIds = false;
+
+  vtkBVHTree* Tree; // PIMPLd templated tree
+
+private:
+  vtkBVHCellLocator(const vtkBVHCellLocator&) = delete;
+  void operator=(const vtkBVHCellLocator&) = delete;
+};
+
+VTK_ABI_NAMESPACE_END
+#endif
@@ -19,9 +19,9 @@
 #include "vtkMathUtilities.h"
 #include "vtkPlane.h"
 #include "vtkPoints.h"
-#include "vtkSMPThreadLocal.h"
 #include "vtkSMPTools.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
@@ -781,46 +781,31 @@ struct BaseBoundsFunctor
 template <typename TPointsArray>
 struct ThreadedBaseBoundsFunctor : public BaseBoundsFunctor<TPointsArray>
 {
-  vtkSMPThreadLocal<std::array<double, 6>> LocalBounds;
+  using BoundsType = std::array<double, 6>;
 
   ThreadedBaseBoundsFunctor(TPointsArray* pts, double* bds)
     : BaseBoundsFunctor<TPointsArray>(pts, bds)
   {
   }
   ~ThreadedBaseBoundsFunctor() override = default;
-  virtual void Initialize()
+
+  // Accumulate the bounds of [begin, end) in localBds.
+  virtual void operator()(vtkIdType begin, vtkIdType end, BoundsType& localBds) const = 0;
+
+  static BoundsType Combine(const BoundsType& bds0, const BoundsType& bds1)
   {
-    std::array<double, 6>& localBds = this->LocalBounds.Local();
-    localBds[0] = localBds[2] = localBds[4] = VTK_DOUBLE_MAX;
-    localBds[1] = localBds[3] = localBds[5] = VTK_DOUBLE_MIN;
+    return BoundsType{ std::min(bds0[0], bds1[0]), std::max(bds0[1], bds1[1]),
+      std::min(bds0[2], bds1[2]), std::max(bds0[3], bds1[3]), std::min(bds0[4], bds1[4]),
+      std::max(bds0[5], bds1[5]) };
   }
-  virtual void operator()(vtkIdType begin, vtkIdType end) = 0;
-  virtual void Reduce()
-  {
-    // Composite bounds from all threads
-    double xmin = VTK_DOUBLE_MAX;
-    double ymin = VTK_DOUBLE_MAX;
-    double zmin = VTK_DOUBLE_MAX;
-    double xmax = VTK_DOUBLE_MIN;
-    double ymax = VTK_DOUBLE_MIN;
-    double zmax = VTK_DOUBLE_MIN;
 
-    for (const auto& localBds : this->LocalBounds)
-    {
-      xmin = std::min(xmin, localBds[0]);
-      ymin = std::min(ymin, localBds[2]);
-      zmin = std::min(zmin, localBds[4]);
-      xmax = std::max(xmax, localBds[1]);
-      ymax = std::max(ymax, localBds[3]);
-      zmax = std::max(zmax, localBds[5]);
-    }
-
-    this->Bounds[0] = xmin;
-    this->Bounds[1] = xmax;
-    this->Bounds[2] = ymin;
-    this->Bounds[3] = ymax;
-    this->Bounds[4] = zmin;
-    this->Bounds[5] = zmax;
+  void Execute(vtkIdType numberOfPoints)
+  {
+    const BoundsType initBds{ VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN,
+      VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    const BoundsType bds =
+      vtkSMPTools::Reduce(vtkIdType(0), numberOfPoints, initBds, *this, &Combine);
+    std::copy(bds.begin(), bds.end(), this->Bounds);
   }
 };
 
@@ -891,11 +876,9 @@ struct ThreadedBoundsFunctor : public ThreadedBaseBoundsFunctor<TPointsArray>
   }
   ~ThreadedBoundsFunctor() override = default;
 
-  void Initialize() override { this->ThreadedBaseBoundsFunctor<TPointsArray>::Initialize(); }
-
-  void operator()(vtkIdType beginPtId, vtkIdType endPtId) override
+  void operator()(vtkIdType beginPtId, vtkIdType endPtId,
+    typename ThreadedBaseBoundsFunctor<TPointsArray>::BoundsType& localBds) const override
   {
-    std::array<double, 6>& localBds = this->LocalBounds.Local();
     const auto points = vtk::DataArrayTupleRange<3>(this->PointsArray, beginPtId, endPtId);
 
     for (const auto point : points)
@@ -912,8 +895,6 @@ struct ThreadedBoundsFunctor : public ThreadedBaseBoundsFunctor<TPointsArray>
       localBds[5] = std::max(localBds[5], z);
     }
   }
-
-  void Reduce() override { this->ThreadedBaseBoundsFunctor<TPointsArray>::Reduce(); }
 };
 
 // ---------------------------------------------------------------------------
@@ -979,11 +960,9 @@ struct ThreadedBoundsPointUsesFunctor : public ThreadedBaseBoundsFunctor<TPoints
   }
   ~ThreadedBoundsPointUsesFunctor() override = default;
 
-  void Initialize() override { this->ThreadedBaseBoundsFunctor<TPointsArray>::Initialize(); }
-
-  void operator()(vtkIdType beginPtId, vtkIdType endPtId) override
+  void operator()(vtkIdType beginPtId, vtkIdType endPtId,
+    typename ThreadedBaseBoundsFunctor<TPointsArray>::BoundsType& localBds) const override
   {
-    std::array<double, 6>& localBds = this->LocalBounds.Local();
     const auto points = vtk::DataArrayTupleRange<3>(this->PointsArray, beginPtId, endPtId);
     const TUsed* used = static_cast<const TUsed*>(this->PointUses + beginPtId);
 
@@ -1005,8 +984,6 @@ struct ThreadedBoundsPointUsesFunctor : public ThreadedBaseBoundsFunctor<TPoints
       ++used;
     }
   }
-
-  void Reduce() override { this->ThreadedBaseBoundsFunctor<TPointsArray>::Reduce(); }
 };
 
 // ---------------------------------------------------------------------------
@@ -1082,14 +1059,11 @@ struct ThreadedBoundsPointIdsFunctor : public ThreadedBaseBoundsFunctor<TPointsA
   }
   ~ThreadedBoundsPointIdsFunctor() override = default;
 
-  void Initialize() override { this->ThreadedBaseBoundsFunctor<TPointsArray>::Initialize(); }
-
-  void operator()(vtkIdType beginPtId, vtkIdType endPtId) override
+  void operator()(vtkIdType beginPtId, vtkIdType endPtId,
+    typename ThreadedBaseBoundsFunctor<TPointsArray>::BoundsType& localBds) const override
   {
-    std::array<double, 6>& localBds = this->LocalBounds.Local();
     const auto points = vtk::DataArrayTupleRange<3>(this->PointsArray);
-    // Reduce bounds with the rest of the ids:
-    for (vtkIdType i = beginPtId + 1; i < endPtId; ++i)
+    for (vtkIdType i = beginPtId; i < endPtId; ++i)
     {
       const auto point = points[this->PointIds[i]];
       // Explicitly reusing a local will improve performance when virtual
@@ -1106,8 +1080,6 @@ struct ThreadedBoundsPointIdsFunctor : public ThreadedBaseBoundsFunctor<TPointsA
       localBds[5] = std::max(localBds[5], z);
     }
   }
-
-  void Reduce() override { this->ThreadedBaseBoundsFunctor<TPointsArray>::Reduce(); }
 };
 
 // ---------------------------------------------------------------------------
@@ -1128,7 +1100,7 @@ struct BoundsWorker
     else
     {
       ThreadedBoundsFunctor<TPointsArray> threadedBds(pts, bds);
-      vtkSMPTools::For(0, numPts, threadedBds);
+      threadedBds.Execute(numPts);
     }
   }
 };
@@ -1151,7 +1123,7 @@ struct BoundsPointUsesWorker
     else
     {
       ThreadedBoundsPointUsesFunctor<TPointsArray, TUsed> threadedBds(pts, ptUses, bds);
-      vtkSMPTools::For(0, numPts, threadedBds);
+      threadedBds.Execute(numPts);
     }
   }
 };
@@ -1172,7 +1144,7 @@ struct BoundsPointIdsWorker
     else
     {
       ThreadedBoundsPointIdsFunctor<TPointsArray, TId> threadedBds(pts, ptIds, bds);
-      vtkSMPTools::For(0, numberOfPointsIds, threadedBds);
+      threadedBds.Execute(numberOfPointsIds);
     }
   }
 };
@@ -17,6 +17,8 @@
 
 #include "vtkArrayDispatch.h"
 #include "vtkCellArrayIterator.h"
+#include "vtkConcurrentAppendStorage.h"
+#include "vtkConcurrentIdAllocator.h"
 #include "vtkDataArrayRange.h"
 #include "vtkIdTypeArray.h"
 #include "vtkIntArray.h"
@@ -343,6 +345,45 @@ struct ResizeExactImpl
   }
 };
 
+struct ConcurrentAppendImpl
+{
+  using Chunk = vtkConcurrentAppendStorage<vtkIdType>::Chunk;
+
+  template <typename CellStateT>
+  void operator()(CellStateT& cells, const std::vector<Chunk*>& chunks,
+    const std::vector<vtkIdType>& connectivityStarts, vtkConcurrentIdAllocator* ids,
+    vtkConcurrentIdAllocator* pointIds) const
+  {
+    using ValueType = typename CellStateT::ValueType;
+    ValueType* offsets = cells.GetOffsets()->GetPointer(0);
+    ValueType* connectivity = cells.GetConnectivity()->GetPointer(0);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(chunks.size()), [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        // The ids of the chunk taken by the containers sharing the allocator
+        // are empty cells.
+        const Chunk* chunk = chunks[i];
+        const vtkIdType numEnds = chunk ? static_cast<vtkIdType>(chunk->Ends.size()) : 0;
+        const vtkIdType numValues = numEnds > 0 ? chunk->Ends[numEnds - 1] : 0;
+        const vtkIdType firstCell = ids->GetChunkFinalId(i);
+        const vtkIdType numCells = ids->GetChunkNumberOfIds(i);
+        const vtkIdType start = connectivityStarts[i];
+        for (vtkIdType cell = 0; cell < numCells; ++cell)
+        {
+          const vtkIdType cellEnd = cell < numEnds ? chunk->Ends[cell] : numValues;
+          offsets[firstCell + cell + 1] = static_cast<ValueType>(start + cellEnd);
+        }
+        for (vtkIdType j = 0; j < numValues; ++j)
+        {
+          const vtkIdType ptId = chunk->Values[j];
+          connectivity[start + j] =
+            static_cast<ValueType>(pointIds ? pointIds->GetFinalId(ptId) : ptId);
+        }
+      }
+    });
+  }
+};
+
 struct FindMaxCell // SMP functor
 {
   vtkCellArray* CellArray;
@@ -535,7 +576,10 @@ struct AppendImpl
 
 VTK_ABI_NAMESPACE_BEGIN
 vtkCellArray::vtkCellArray() = default;
-vtkCellArray::~vtkCellArray() = default;
+vtkCellArray::~vtkCellArray()
+{
+  delete this->ConcurrentAppend;
+}
 vtkStandardNewMacro(vtkCellArray);
 
 //=================== Begin Legacy Methods ===================================
@@ -1095,6 +1139,82 @@ bool vtkCellArray::ResizeExact(vtkIdType numCells, vtkIdType connectivitySize)
   return this->Visit(ResizeExactImpl{}, numCells, connectivitySize);
 }
 
+//------------------------------------------------------------------------------
+void vtkCellArray::BeginConcurrentAppend(vtkConcurrentIdAllocator* ids)
+{
+  if (ids)
+  {
+    this->ConcurrentAppendIds = ids;
+  }
+  else
+  {
+    this->ConcurrentAppendIds = vtkSmartPointer<vtkConcurrentIdAllocator>::New();
+    this->ConcurrentAppendIds->Initialize(this->GetNumberOfCells());
+  }
+  delete this->ConcurrentAppend;
+  this->ConcurrentAppend = new vtkConcurrentAppendStorage<vtkIdType>(this->ConcurrentAppendIds);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkCellArray::ConcurrentInsertNextCell(vtkIdType npts, const vtkIdType* pts)
+{
+  // Ids are handed out in order, so the cell goes at the end of its chunk,
+  // after empty cells for the ids taken by the containers sharing the
+  // allocator.
+  const vtkIdType cellId = this->ConcurrentAppendIds->NewId();
+  auto& chunk = this->ConcurrentAppend->GetChunk(cellId);
+  if (chunk.Ends.empty())
+  {
+    chunk.Ends.reserve(this->ConcurrentAppendIds->GetChunkSize());
+  }
+  chunk.Ends.resize(this->ConcurrentAppendIds->GetChunkOffset(cellId),
+    static_cast<vtkIdType>(chunk.Values.size()));
+  chunk.Values.insert(chunk.Values.end(), pts, pts + npts);
+  chunk.Ends.push_back(static_cast<vtkIdType>(chunk.Values.size()));
+  return cellId;
+}
+
+//------------------------------------------------------------------------------
+void vtkCellArray::EndConcurrentAppend(vtkConcurrentIdAllocator* pointIds)
+{
+  if (!this->ConcurrentAppend)
+  {
+    return;
+  }
+  vtkConcurrentIdAllocator* ids = this->ConcurrentAppendIds;
+  ids->Finalize();
+  if (pointIds)
+  {
+    pointIds->Finalize();
+  }
+
+  // The connectivity of the chunks is laid out in the order of their ids.
+  auto chunks = this->ConcurrentAppend->GetChunks();
+  std::vector<vtkIdType> connectivityStarts(chunks.size());
+  vtkIdType connectivitySize = this->GetNumberOfConnectivityIds();
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    connectivityStarts[i] = connectivitySize;
+    if (chunks[i] && !chunks[i]->Ends.empty())
+    {
+      connectivitySize += chunks[i]->Ends.back();
+    }
+  }
+
+  this->ResizeExact(ids->GetNumberOfIds(), connectivitySize);
+  this->Visit(ConcurrentAppendImpl{}, chunks, connectivityStarts, ids, pointIds);
+
+  delete this->ConcurrentAppend;
+  this->ConcurrentAppend = nullptr;
+  this->Modified();
+}
+
+//------------------------------------------------------------------------------
+vtkConcurrentIdAllocator* vtkCellArray::GetConcurrentAppendIds() const
+{
+  return this->ConcurrentAppendIds;
+}
+
 //------------------------------------------------------------------------------
 // Returns the size of the largest cell. The size is the number of points
 // defining the cell.
@@ -176,7 +176,10 @@
 
 VTK_ABI_NAMESPACE_BEGIN
 class vtkCellArrayIterator;
+class vtkConcurrentIdAllocator;
 class vtkIdTypeArray;
+template <typename ValueT>
+class vtkConcurrentAppendStorage;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkCellArray : public vtkObject
 {
@@ -680,6 +683,43 @@ public:
    */
   void UpdateCellCount(int npts);
 
+  /**
+   * Start the concurrent append mode, in which ConcurrentInsertNextCell() may
+   * be called from many threads at once, for instance to generate cells in a
+   * single pass of a vtkSMPTools::For(). The appended cells are numbered with
+   * the provisional ids of `ids`, which must be initialized by the caller with
+   * the number of cells; when nullptr, the cell array uses its own allocator.
+   * Sharing the allocator with the cell data arrays, filled with
+   * vtkAOSDataArrayTemplate::ConcurrentSetTuple(), keeps them in the order of
+   * the cells. The allocator may also be shared with other cell arrays, the
+   * ids taken by the others being empty cells. The cell array must not be
+   * otherwise modified nor read until EndConcurrentAppend().
+   */
+  void BeginConcurrentAppend(vtkConcurrentIdAllocator* ids = nullptr);
+
+  /**
+   * Append a cell in concurrent append mode and return its provisional id.
+   * Thread safe and lock free.
+   */
+  vtkIdType ConcurrentInsertNextCell(vtkIdType npts, const vtkIdType* pts)
+    VTK_SIZEHINT(pts, npts);
+
+  /**
+   * Leave the concurrent append mode: finalize the allocator and move the
+   * appended cells to their final ids, given by
+   * vtkConcurrentIdAllocator::GetFinalId(). When the points were appended
+   * concurrently too, pass their allocator, for instance
+   * vtkPoints::GetConcurrentAppendIds(), to replace the provisional point ids
+   * of the cells by the final ones. Must be called once all the threads are
+   * done.
+   */
+  void EndConcurrentAppend(vtkConcurrentIdAllocator* pointIds = nullptr);
+
+  /**
+   * Return the allocator of the current or last concurrent append, or nullptr.
+   */
+  vtkConcurrentIdAllocator* GetConcurrentAppendIds() const;
+
   /**
    * Get/Set the current cellId for traversal.
    *
@@ -1342,6 +1382,9 @@ protected:
 
   vtkNew<vtkIdTypeArray> LegacyData; // For GetData().
 
+  vtkConcurrentAppendStorage<vtkIdType>* ConcurrentAppend = nullptr;
+  vtkSmartPointer<vtkConcurrentIdAllocator> ConcurrentAppendIds;
+
 private:
   vtkCellArray(const vtkCellArray&) = delete;
   void operator=(const vtkCellArray&) = delete;
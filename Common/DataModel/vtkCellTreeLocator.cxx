@@ -20,10 +20,16 @@
 #include "vtkBoundingBox.h"
 #include "vtkBox.h"
 #include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkMemoryArena.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #include <algorithm>
 #include <array>
@@ -57,6 +63,9 @@ struct vtkCellTree
 {
   double DataBBox[6]; // This store the bounding values of the dataset
   vtkCellTreeLocator* Locator;
+  // The surface area cost of the leaves when the tree was built, negative
+  // until first needed
+  double BuildCost = -1.0;
   vtkDataSet* DataSet;
 
   vtkCellTree(vtkCellTreeLocator* locator)
@@ -76,6 +85,11 @@ struct vtkCellTree
   virtual int IntersectWithLine(const double p1[3], const double p2[3], double tol,
     vtkPoints* points, vtkIdList* cellIds, vtkGenericCell* cell) = 0;
   virtual void GenerateRepresentation(int level, vtkPolyData* pd) = 0;
+  virtual void FindCells(vtkPoints* points, const vtkIdType* order, vtkIdList* cellIds,
+    vtkDoubleArray* pcoords) = 0;
+  virtual void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol,
+    const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x) = 0;
+  virtual bool Refit(double costThreshold) = 0;
 
   // Utility methods
   static int getDominantAxis(const double dir[3])
@@ -224,6 +238,22 @@ struct CellTree : public vtkCellTree
   int IntersectWithLine(const double p1[3], const double p2[3], double tol, vtkPoints* points,
     vtkIdList* cellIds, vtkGenericCell* cell) override;
   void GenerateRepresentation(int level, vtkPolyData* pd) override;
+  void FindCells(vtkPoints* points, const vtkIdType* order, vtkIdList* cellIds,
+    vtkDoubleArray* pcoords) override;
+  void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, const vtkIdType* order,
+    vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x) override;
+  bool Refit(double costThreshold) override;
+
+  // The sum over the leaves of their number of cells times the surface area
+  // of their box, relative to the surface area of the bounds of the dataset
+  double ComputeCost();
+
+  // IntersectWithLine() with the array of visited cells provided by the
+  // caller, so that a batch of lines reuses it. The array is allocated on
+  // first use, and must be cleared between the lines.
+  int IntersectWithLine(const double p1[3], const double p2[3], double tol, double& t, double x[3],
+    double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell,
+    std::vector<bool>& cellHasBeenVisited);
 };
 
 //------------------------------------------------------------------------------
@@ -304,6 +334,11 @@ struct CellPointTraversal
 //------------------------------------------------------------------------------
 // This class builds the CellTree according to the algorithm given in the paper.
 // This class is derived from the avtCellLocatorBIH class in VisIT.
+// The nodes larger than SubtreeSize are split first, one at a time, binning,
+// partitioning and bounding their cells in parallel. The subtrees below them
+// are then built concurrently, each in its own array of nodes. Every split
+// only depends on the cells of its node, and Reduce() orders the nodes
+// breadth first, so the tree does not depend on the number of threads.
 template <typename T>
 struct CellTreeBuilder
 {
@@ -333,6 +368,19 @@ private:
         this->Max = max;
       }
     }
+
+    inline void Merge(const Bucket& bucket)
+    {
+      this->Cnt += bucket.Cnt;
+      if (bucket.Min < this->Min)
+      {
+        this->Min = bucket.Min;
+      }
+      if (bucket.Max > this->Max)
+      {
+        this->Max = bucket.Max;
+      }
+    }
   };
 
   struct CellInfo
@@ -366,7 +414,7 @@ private:
     {
     }
 
-    inline bool operator()(const CellInfo& pc)
+    inline bool operator()(const CellInfo& pc) const
     {
       return pc.Min[this->D] + pc.Max[this->D] < this->P;
     }
@@ -388,16 +436,21 @@ private:
 
   using TCellTree = CellTree<T>;
   using TCellTreeNode = typename TCellTree::TCellTreeNode;
+  using SplitStackType = std::stack<SplitInfo>;
+
+  // The number of cells processed by each task of the parallel partition
+  static constexpr vtkIdType PartitionChunkSize = 65536;
 
   vtkCellTreeLocator* Locator;
   TCellTree& Tree;
   vtkDataSet* DataSet;
   int NumberOfBuckets;
   int NumberOfNodesPerLeaf;
+  T SubtreeSize;
 
   std::vector<CellInfo> CellsInfo;
   std::vector<CellTreeNode<T>> Nodes;
-  std::stack<SplitInfo> SplitStack;
+  SplitStackType SplitStack;
 
   struct BucketsType : public std::array<std::vector<Bucket>, 3>
   {
@@ -451,26 +504,38 @@ private:
   }
 
   // -------------------------------------------------------------------------
-  void Split(T index, double min[3], double max[3], BucketsType& buckets)
+  // FindMinMax() of a large range of cells.
+  void FindMinMaxParallel(const CellInfo* begin, const CellInfo* end, double* min, double* max)
   {
-    const T& start = this->Nodes[index].Start();
-    const T& size = this->Nodes[index].Size();
-
-    if (size < this->NumberOfNodesPerLeaf)
+    const std::array<double, 6> exemplar = { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX,
+      -VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+    vtkSMPThreadLocal<std::array<double, 6>> tlMinMax(exemplar);
+    vtkSMPTools::For(0, end - begin, [&](vtkIdType first, vtkIdType last) {
+      std::array<double, 6>& minMax = tlMinMax.Local();
+      double localMin[3], localMax[3];
+      this->FindMinMax(begin + first, begin + last, localMin, localMax);
+      for (uint8_t d = 0; d < 3; ++d)
+      {
+        minMax[d] = std::min(minMax[d], localMin[d]);
+        minMax[d + 3] = std::max(minMax[d + 3], localMax[d]);
+      }
+    });
+    std::copy_n(exemplar.data(), 3, min);
+    std::copy_n(exemplar.data() + 3, 3, max);
+    for (const auto& minMax : tlMinMax)
     {
-      return;
+      for (uint8_t d = 0; d < 3; ++d)
+      {
+        min[d] = std::min(min[d], minMax[d]);
+        max[d] = std::max(max[d], minMax[d + 3]);
+      }
     }
+  }
 
-    CellInfo* begin = &(this->CellsInfo[start]);
-    CellInfo* end = this->CellsInfo.data() + start + size;
-    CellInfo* mid = begin;
-
-    const double ext[3] = { max[0] - min[0], max[1] - min[1], max[2] - min[2] };
-    const double iext[3] = { this->NumberOfBuckets / ext[0], this->NumberOfBuckets / ext[1],
-      this->NumberOfBuckets / ext[2] };
-
-    buckets.Reset();
-
+  // -------------------------------------------------------------------------
+  void FillBuckets(const CellInfo* begin, const CellInfo* end, const double min[3],
+    const double iext[3], BucketsType& buckets)
+  {
     double cen;
     int ind;
 
@@ -494,6 +559,168 @@ private:
         buckets[d][ind].Add(pc->Min[d], pc->Max[d]);
       }
     }
+  }
+
+  // -------------------------------------------------------------------------
+  // FillBuckets() of a large range of cells. The buckets only hold counts and
+  // extrema, so merging the buckets of the threads gives the serial result.
+  void FillBucketsParallel(const CellInfo* begin, const CellInfo* end, const double min[3],
+    const double iext[3], BucketsType& buckets)
+  {
+    vtkSMPThreadLocal<BucketsType> tlBuckets(BucketsType(this->NumberOfBuckets));
+    vtkSMPTools::For(0, end - begin, [&](vtkIdType first, vtkIdType last) {
+      this->FillBuckets(begin + first, begin + last, min, iext, tlBuckets.Local());
+    });
+    for (const auto& localBuckets : tlBuckets)
+    {
+      for (uint8_t d = 0; d < 3; ++d)
+      {
+        for (int n = 0; n < this->NumberOfBuckets; ++n)
+        {
+          buckets[d][n].Merge(localBuckets[d][n]);
+        }
+      }
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // Move the cells satisfying pred before the others, with the same swaps
+  // as std::partition: the first cell out of place from the beginning is
+  // swapped with the first one out of place from the end, and so on.
+  template <typename TPredicate>
+  static CellInfo* Partition(CellInfo* begin, CellInfo* end, TPredicate pred)
+  {
+    while (true)
+    {
+      while (begin != end && pred(*begin))
+      {
+        ++begin;
+      }
+      if (begin == end)
+      {
+        return begin;
+      }
+      --end;
+      while (begin != end && !pred(*end))
+      {
+        --end;
+      }
+      if (begin == end)
+      {
+        return begin;
+      }
+      std::swap(*begin, *end);
+      ++begin;
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  template <typename TPredicate>
+  struct NotPredicate
+  {
+    TPredicate Pred;
+    inline bool operator()(const CellInfo& pc) const { return !this->Pred(pc); }
+  };
+
+  // -------------------------------------------------------------------------
+  // Return the number of cells of [first, last) satisfying pred and, if
+  // positions is not null, gather their positions in increasing order.
+  template <typename TPredicate>
+  static vtkIdType GatherPositions(
+    const CellInfo* first, const CellInfo* last, TPredicate pred, std::vector<vtkIdType>* positions)
+  {
+    const vtkIdType numCells = last - first;
+    const vtkIdType numChunks = (numCells + PartitionChunkSize - 1) / PartitionChunkSize;
+    std::vector<vtkIdType> offsets(numChunks + 1, 0);
+    vtkSMPTools::For(0, numChunks, [&](vtkIdType chunk, vtkIdType endChunk) {
+      for (; chunk < endChunk; ++chunk)
+      {
+        const vtkIdType chunkEnd = std::min(numCells, (chunk + 1) * PartitionChunkSize);
+        offsets[chunk + 1] = static_cast<vtkIdType>(
+          std::count_if(first + chunk * PartitionChunkSize, first + chunkEnd, pred));
+      }
+    });
+    for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+    {
+      offsets[chunk + 1] += offsets[chunk];
+    }
+    if (!positions)
+    {
+      return offsets[numChunks];
+    }
+    positions->resize(offsets[numChunks]);
+    vtkSMPTools::For(0, numChunks, [&](vtkIdType chunk, vtkIdType endChunk) {
+      for (; chunk < endChunk; ++chunk)
+      {
+        const vtkIdType chunkEnd = std::min(numCells, (chunk + 1) * PartitionChunkSize);
+        vtkIdType offset = offsets[chunk];
+        for (vtkIdType i = chunk * PartitionChunkSize; i < chunkEnd; ++i)
+        {
+          if (pred(first[i]))
+          {
+            (*positions)[offset++] = i;
+          }
+        }
+      }
+    });
+    return offsets[numChunks];
+  }
+
+  // -------------------------------------------------------------------------
+  // Partition() of a large range of cells, giving the same result: the
+  // cells out of place on each side of the final middle are gathered in
+  // order, and the i-th one from the beginning swapped with the i-th one
+  // from the end.
+  template <typename TPredicate>
+  static CellInfo* PartitionParallel(CellInfo* begin, CellInfo* end, TPredicate pred)
+  {
+    CellInfo* mid = begin + GatherPositions(begin, end, pred, nullptr);
+
+    std::vector<vtkIdType> leftPositions, rightPositions;
+    GatherPositions(begin, mid, NotPredicate<TPredicate>{ pred }, &leftPositions);
+    GatherPositions(mid, end, pred, &rightPositions);
+
+    const vtkIdType numSwaps = static_cast<vtkIdType>(leftPositions.size());
+    vtkSMPTools::For(0, numSwaps, [&](vtkIdType first, vtkIdType last) {
+      for (; first < last; ++first)
+      {
+        std::swap(begin[leftPositions[first]], mid[rightPositions[numSwaps - 1 - first]]);
+      }
+    });
+    return mid;
+  }
+
+  // -------------------------------------------------------------------------
+  // Split the node at index of nodes, and push its children on splitStack.
+  // The cells of the node are processed in parallel if parallel is true.
+  void Split(T index, double min[3], double max[3], BucketsType& buckets,
+    std::vector<TCellTreeNode>& nodes, SplitStackType& splitStack, bool parallel)
+  {
+    const T start = nodes[index].Start();
+    const T size = nodes[index].Size();
+
+    if (size < this->NumberOfNodesPerLeaf)
+    {
+      return;
+    }
+
+    CellInfo* begin = &(this->CellsInfo[start]);
+    CellInfo* end = this->CellsInfo.data() + start + size;
+    CellInfo* mid = begin;
+
+    const double ext[3] = { max[0] - min[0], max[1] - min[1], max[2] - min[2] };
+    const double iext[3] = { this->NumberOfBuckets / ext[0], this->NumberOfBuckets / ext[1],
+      this->NumberOfBuckets / ext[2] };
+
+    buckets.Reset();
+    if (parallel)
+    {
+      this->FillBucketsParallel(begin, end, min, iext, buckets);
+    }
+    else
+    {
+      this->FillBuckets(begin, end, min, iext, buckets);
+    }
 
     double cost = VTK_DOUBLE_MAX;
     double plane = VTK_DOUBLE_MIN; // bad value in case it doesn't get setx
@@ -550,7 +777,8 @@ private:
 
     if (cost != VTK_DOUBLE_MAX)
     {
-      mid = std::partition(begin, end, LeftPredicate(dim, plane));
+      mid = parallel ? PartitionParallel(begin, end, LeftPredicate(dim, plane))
+                     : Partition(begin, end, LeftPredicate(dim, plane));
     }
 
     // fallback
@@ -564,8 +792,16 @@ private:
 
     double lMin[3], lMax[3], rMin[3], rMax[3];
 
-    this->FindMinMax(begin, mid, lMin, lMax);
-    this->FindMinMax(mid, end, rMin, rMax);
+    if (parallel)
+    {
+      this->FindMinMaxParallel(begin, mid, lMin, lMax);
+      this->FindMinMaxParallel(mid, end, rMin, rMax);
+    }
+    else
+    {
+      this->FindMinMax(begin, mid, lMin, lMax);
+      this->FindMinMax(mid, end, rMin, rMax);
+    }
 
     double clip[2] = { lMax[dim], rMin[dim] };
 
@@ -573,11 +809,11 @@ private:
     child[0].MakeLeaf(begin - this->CellsInfo.data(), mid - begin);
     child[1].MakeLeaf(mid - this->CellsInfo.data(), end - mid);
 
-    this->Nodes[index].MakeNode(static_cast<T>(this->Nodes.size()), dim, clip);
-    this->Nodes.insert(this->Nodes.end(), child, child + 2);
+    nodes[index].MakeNode(static_cast<T>(nodes.size()), dim, clip);
+    nodes.insert(nodes.end(), child, child + 2);
 
-    this->SplitStack.emplace(this->Nodes[index].GetRightChildIndex(), rMin, rMax);
-    this->SplitStack.emplace(this->Nodes[index].GetLeftChildIndex(), lMin, lMax);
+    splitStack.emplace(nodes[index].GetRightChildIndex(), rMin, rMax);
+    splitStack.emplace(nodes[index].GetLeftChildIndex(), lMin, lMax);
   }
 
 public:
@@ -592,35 +828,30 @@ public:
     const auto numberOfCells = static_cast<T>(this->DataSet->GetNumberOfCells());
     this->CellsInfo.resize(static_cast<size_t>(numberOfCells));
 
-    double min[3] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX };
-    double max[3] = {
-      -VTK_DOUBLE_MAX,
-      -VTK_DOUBLE_MAX,
-      -VTK_DOUBLE_MAX,
-    };
-
-    double cellBounds[6], *cellBoundsPtr;
-    cellBoundsPtr = cellBounds;
-    for (T i = 0; i < numberOfCells; ++i)
-    {
-      this->CellsInfo[i].Ind = i;
-      this->Locator->GetCellBounds(i, cellBoundsPtr);
-
-      for (uint8_t d = 0; d < 3; ++d)
+    // Gather the cell bounds. The bounds of the first cell are fetched first
+    // to cause the non-thread safe initialization due to side effects from
+    // GetCellBounds() (see vtkAbstractCellLocator::StoreCellBounds()).
+    auto gatherBounds = [this](T begin, T end) {
+      double cellBounds[6], *cellBoundsPtr;
+      for (T i = begin; i < end; ++i)
       {
-        this->CellsInfo[i].Min[d] = cellBoundsPtr[2 * d + 0];
-        this->CellsInfo[i].Max[d] = cellBoundsPtr[2 * d + 1];
+        cellBoundsPtr = cellBounds;
+        this->CellsInfo[i].Ind = i;
+        this->Locator->GetCellBounds(i, cellBoundsPtr);
 
-        if (this->CellsInfo[i].Min[d] < min[d])
-        {
-          min[d] = this->CellsInfo[i].Min[d];
-        }
-        if (this->CellsInfo[i].Max[d] > max[d])
+        for (uint8_t d = 0; d < 3; ++d)
         {
-          max[d] = this->CellsInfo[i].Max[d];
+          this->CellsInfo[i].Min[d] = cellBoundsPtr[2 * d + 0];
+          this->CellsInfo[i].Max[d] = cellBoundsPtr[2 * d + 1];
         }
       }
-    }
+    };
+    gatherBounds(0, 1);
+    vtkSMPTools::For(1, numberOfCells, gatherBounds);
+
+    double min[3], max[3];
+    this->FindMinMaxParallel(
+      this->CellsInfo.data(), this->CellsInfo.data() + numberOfCells, min, max);
 
     this->Tree.DataBBox[0] = min[0];
     this->Tree.DataBBox[1] = max[0];
@@ -640,16 +871,78 @@ public:
   {
     auto& buckets = this->Buckets;
     buckets = BucketsType(this->NumberOfBuckets);
+
+    // Enough subtrees to balance the load between the threads, large enough
+    // to amortize the scheduling. Serially, the whole tree is a subtree.
+    const auto numberOfCells = static_cast<T>(this->CellsInfo.size());
+    const int numberOfThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+    this->SubtreeSize = numberOfThreads > 1
+      ? std::max<T>(numberOfCells / (8 * numberOfThreads), static_cast<T>(PartitionChunkSize))
+      : numberOfCells;
   }
 
   void operator()()
   {
-    auto& buckets = this->Buckets;
+    // Split the large nodes at the top of the tree, and defer the others.
+    std::vector<SplitInfo> subtrees;
     while (!this->SplitStack.empty())
     {
       auto splitInfo = std::move(this->SplitStack.top());
       this->SplitStack.pop();
-      this->Split(splitInfo.Index, splitInfo.Min, splitInfo.Max, buckets);
+      if (this->Nodes[splitInfo.Index].Size() <= this->SubtreeSize)
+      {
+        subtrees.push_back(std::move(splitInfo));
+        continue;
+      }
+      this->Split(splitInfo.Index, splitInfo.Min, splitInfo.Max, this->Buckets, this->Nodes,
+        this->SplitStack, true);
+    }
+
+    // Build the subtrees concurrently. Each subtree starts with a copy of its
+    // root, and its cells are a range of CellsInfo of its own.
+    std::vector<std::vector<TCellTreeNode>> subtreeNodes(subtrees.size());
+    vtkSMPThreadLocal<BucketsType> tlBuckets(this->Buckets);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(subtrees.size()), 1,
+      [&](vtkIdType subtree, vtkIdType endSubtree) {
+        BucketsType& buckets = tlBuckets.Local();
+        for (; subtree < endSubtree; ++subtree)
+        {
+          std::vector<TCellTreeNode>& nodes = subtreeNodes[subtree];
+          nodes.push_back(this->Nodes[subtrees[subtree].Index]);
+          SplitStackType splitStack;
+          splitStack.emplace(0, subtrees[subtree].Min, subtrees[subtree].Max);
+          while (!splitStack.empty())
+          {
+            auto splitInfo = std::move(splitStack.top());
+            splitStack.pop();
+            this->Split(
+              splitInfo.Index, splitInfo.Min, splitInfo.Max, buckets, nodes, splitStack, false);
+          }
+        }
+      });
+
+    // Append the subtrees to the tree, replacing their roots.
+    for (size_t subtree = 0; subtree < subtrees.size(); ++subtree)
+    {
+      const std::vector<TCellTreeNode>& nodes = subtreeNodes[subtree];
+      // The node i > 0 of the subtree is the node i + offset of the tree
+      const T offset = static_cast<T>(this->Nodes.size()) - 1;
+      for (size_t i = 0; i < nodes.size(); ++i)
+      {
+        TCellTreeNode node = nodes[i];
+        if (node.IsNode())
+        {
+          node.SetChildren(node.GetLeftChildIndex() + offset);
+        }
+        if (i == 0)
+        {
+          this->Nodes[subtrees[subtree].Index] = node;
+        }
+        else
+        {
+          this->Nodes.push_back(node);
+        }
+      }
     }
   }
 
@@ -671,12 +964,14 @@ public:
       ni->SetChildren(nn - this->Tree.Nodes.begin() - 2);
     }
 
-    const auto numberOfCells = static_cast<size_t>(this->DataSet->GetNumberOfCells());
+    const auto numberOfCells = static_cast<vtkIdType>(this->CellsInfo.size());
     this->Tree.Leaves.resize(numberOfCells);
-    for (size_t i = 0; i < numberOfCells; ++i)
-    {
-      this->Tree.Leaves[i] = this->CellsInfo[i].Ind;
-    }
+    vtkSMPTools::For(0, numberOfCells, [this](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        this->Tree.Leaves[i] = this->CellsInfo[i].Ind;
+      }
+    });
     this->CellsInfo.clear();
   }
 };
@@ -720,6 +1015,18 @@ vtkIdType CellTree<T>::FindCell(
 template <typename T>
 int CellTree<T>::IntersectWithLine(const double p1[3], const double p2[3], double tol, double& t,
   double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell)
+{
+  // The intersection query array is allocated locally to ensure thread safety.
+  std::vector<bool> cellHasBeenVisited;
+  return this->IntersectWithLine(
+    p1, p2, tol, t, x, pcoords, subId, cellId, cell, cellHasBeenVisited);
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+int CellTree<T>::IntersectWithLine(const double p1[3], const double p2[3], double tol, double& t,
+  double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell,
+  std::vector<bool>& cellHasBeenVisited)
 {
   TCellTreeNode *node, *nearNode, *farNode;
   double tmin, tmax, tDist, tHitCell, tBest = VTK_DOUBLE_MAX, xBest[3], pCoordsBest[3];
@@ -738,9 +1045,11 @@ int CellTree<T>::IntersectWithLine(const double p1[3], const double p2[3], doubl
     return 0; // No intersections possible, line is outside the locator
   }
 
-  // Initialize intersection query array if necessary. This is done
-  // locally to ensure thread safety.
-  std::vector<bool> cellHasBeenVisited(this->DataSet->GetNumberOfCells(), false);
+  // Initialize intersection query array if necessary.
+  if (cellHasBeenVisited.empty())
+  {
+    cellHasBeenVisited.resize(this->DataSet->GetNumberOfCells(), false);
+  }
 
   // Ok, setup a stack and various params
   TreeNodeStack ns;
@@ -1105,6 +1414,99 @@ void SplitNodeBox(CellTreeNode<T>* n, vtkBoundingBox& b, vtkBoundingBox& l, vtkB
   r = rr;
 }
 
+//------------------------------------------------------------------------------
+inline double HalfArea(const vtkBoundingBox& box)
+{
+  double lengths[3];
+  box.GetLengths(lengths);
+  for (int d = 0; d < 3; ++d)
+  {
+    lengths[d] = std::max(lengths[d], 0.0);
+  }
+  return lengths[0] * lengths[1] + lengths[1] * lengths[2] + lengths[2] * lengths[0];
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+double CellTree<T>::ComputeCost()
+{
+  // The nodes are stored breadth first, so the parents precede their children
+  std::vector<vtkBoundingBox> boxes(this->Nodes.size());
+  boxes[0].SetBounds(this->DataBBox);
+  const double rootArea = HalfArea(boxes[0]);
+  double cost = 0.0;
+  for (size_t i = 0; i < this->Nodes.size(); ++i)
+  {
+    TCellTreeNode* n = &this->Nodes[i];
+    if (n->IsLeaf())
+    {
+      cost += n->Size() * (rootArea > 0.0 ? HalfArea(boxes[i]) / rootArea : 1.0);
+    }
+    else
+    {
+      SplitNodeBox(n, boxes[i], boxes[n->GetLeftChildIndex()], boxes[n->GetRightChildIndex()]);
+    }
+  }
+  return cost;
+}
+
+//------------------------------------------------------------------------------
+// Refit the tree after the points of the dataset moved: the topology of the
+// tree and the assignment of the cells to the leaves are kept, and the split
+// planes of the nodes are recomputed bottom-up from the new cell bounds.
+template <typename T>
+bool CellTree<T>::Refit(double costThreshold)
+{
+  if (this->BuildCost < 0.0)
+  {
+    this->BuildCost = this->ComputeCost();
+  }
+
+  // The bounds of the leaves. The bounds of the first cell are fetched first
+  // to cause the non-thread safe initialization due to side effects from
+  // GetCellBounds() (see vtkAbstractCellLocator::StoreCellBounds()).
+  const auto numberOfNodes = static_cast<vtkIdType>(this->Nodes.size());
+  std::vector<vtkBoundingBox> boxes(numberOfNodes);
+  double cellBounds[6], *cellBoundsPtr = cellBounds;
+  this->Locator->GetCellBounds(0, cellBoundsPtr);
+  vtkSMPTools::For(0, numberOfNodes, [&](vtkIdType begin, vtkIdType end) {
+    double bounds[6], *boundsPtr;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const TCellTreeNode& n = this->Nodes[i];
+      if (!n.IsLeaf())
+      {
+        continue;
+      }
+      for (T j = n.Start(); j < n.Start() + n.Size(); ++j)
+      {
+        boundsPtr = bounds;
+        this->Locator->GetCellBounds(this->Leaves[j], boundsPtr);
+        boxes[i].AddBounds(boundsPtr);
+      }
+    }
+  });
+
+  // Propagate the bounds up the tree, updating the split planes
+  for (vtkIdType i = numberOfNodes - 1; i >= 0; --i)
+  {
+    TCellTreeNode& n = this->Nodes[i];
+    if (n.IsLeaf())
+    {
+      continue;
+    }
+    const vtkBoundingBox& left = boxes[n.GetLeftChildIndex()];
+    const vtkBoundingBox& right = boxes[n.GetRightChildIndex()];
+    n.LeftMax = left.GetMaxPoint()[n.GetDimension()];
+    n.RightMin = right.GetMinPoint()[n.GetDimension()];
+    boxes[i] = left;
+    boxes[i].AddBox(right);
+  }
+  boxes[0].GetBounds(this->DataBBox);
+
+  return this->ComputeCost() <= costThreshold * this->BuildCost;
+}
+
 //------------------------------------------------------------------------------
 void AddBox(vtkPolyData* pd, double* bounds, int level)
 {
@@ -1287,6 +1689,83 @@ void CellTree<T>::FindCellsWithinBounds(double* bbox, vtkIdList* cells)
     }
   }
 }
+
+//------------------------------------------------------------------------------
+// The batched queries process the ordered queries in parallel, so that each
+// thread traverses neighboring branches of the tree.
+template <typename T>
+void CellTree<T>::FindCells(
+  vtkPoints* points, const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+{
+  const int maxCellSize = this->DataSet->GetMaxCellSize();
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPThreadLocal<std::vector<double>> tlWeights;
+  vtkSMPTools::For(0, points->GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end) {
+    // The point ids of the cells live in the thread arena until the chunk ends.
+    vtkMemoryArena::Scope scope;
+    vtkGenericCell* cell = tlCell.Local();
+    cell->SetArena(scope.GetArena());
+    std::vector<double>& weights = tlWeights.Local();
+    weights.resize(maxCellSize);
+    double x[3], pc[3];
+    int subId;
+    for (; begin < end; ++begin)
+    {
+      const vtkIdType ptId = order[begin];
+      points->GetPoint(ptId, x);
+      const vtkIdType cellId = this->FindCell(x, cell, subId, pc, weights.data());
+      cellIds->SetId(ptId, cellId);
+      if (pcoords)
+      {
+        if (cellId < 0)
+        {
+          pc[0] = pc[1] = pc[2] = 0.0;
+        }
+        pcoords->SetTypedTuple(ptId, pc);
+      }
+    }
+  });
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+void CellTree<T>::IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol,
+  const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPThreadLocal<std::vector<bool>> tlCellHasBeenVisited;
+  vtkSMPTools::For(0, cellIds->GetNumberOfIds(), [&](vtkIdType begin, vtkIdType end) {
+    vtkMemoryArena::Scope scope;
+    vtkGenericCell* cell = tlCell.Local();
+    cell->SetArena(scope.GetArena());
+    std::vector<bool>& cellHasBeenVisited = tlCellHasBeenVisited.Local();
+    double a0[3], a1[3], tHit, xHit[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    for (; begin < end; ++begin)
+    {
+      const vtkIdType lineId = order[begin];
+      p1->GetPoint(lineId, a0);
+      p2->GetPoint(lineId, a1);
+      if (!this->IntersectWithLine(a0, a1, tol, tHit, xHit, pcoords, subId, cellId, cell,
+            cellHasBeenVisited))
+      {
+        cellId = -1;
+        tHit = xHit[0] = xHit[1] = xHit[2] = 0.0;
+      }
+      std::fill(cellHasBeenVisited.begin(), cellHasBeenVisited.end(), false);
+      cellIds->SetId(lineId, cellId);
+      if (t)
+      {
+        t->SetValue(lineId, tHit);
+      }
+      if (x)
+      {
+        x->SetPoint(lineId, xHit);
+      }
+    }
+  });
+}
 VTK_ABI_NAMESPACE_END
 } // namespace
 
@@ -1331,6 +1810,14 @@ void vtkCellTreeLocator::BuildLocator()
     vtkDebugMacro(<< "BuildLocator exited - UseExistingSearchStructure");
     return;
   }
+  // refit instead of rebuilding if RefitSearchStructure is ON and a search structure exists
+  if (this->Tree && this->RefitSearchStructure && this->RefitLocatorInternal())
+  {
+    this->Refitted = true;
+    this->BuildTime.Modified();
+    vtkDebugMacro(<< "BuildLocator exited - RefitSearchStructure");
+    return;
+  }
   this->BuildLocatorInternal();
 }
 
@@ -1344,6 +1831,7 @@ void vtkCellTreeLocator::ForceBuildLocator()
 void vtkCellTreeLocator::BuildLocatorInternal()
 {
   using namespace detail;
+  this->Refitted = false;
   vtkIdType numCells;
   if (!this->DataSet || (numCells = this->DataSet->GetNumberOfCells() < 1))
   {
@@ -1379,6 +1867,22 @@ void vtkCellTreeLocator::BuildLocatorInternal()
   this->BuildTime.Modified();
 }
 
+//------------------------------------------------------------------------------
+// Keep the tree, and only update its split planes.
+bool vtkCellTreeLocator::RefitLocatorInternal()
+{
+  const vtkIdType numCells = this->DataSet->GetNumberOfCells();
+  if (numCells < 1 || numCells != static_cast<vtkIdType>(this->LargeIds
+        ? static_cast<detail::CellTree<vtkIdType>*>(this->Tree)->Leaves.size()
+        : static_cast<detail::CellTree<int>*>(this->Tree)->Leaves.size()))
+  {
+    return false;
+  }
+  vtkDebugMacro(<< "Refitting cell tree locator");
+  this->ComputeCellBounds();
+  return this->Tree->Refit(this->RefitCostThreshold);
+}
+
 //------------------------------------------------------------------------------
 vtkIdType vtkCellTreeLocator::FindCell(
   double pos[3], double, vtkGenericCell* cell, int& subId, double pcoords[3], double* weights)
@@ -1426,6 +1930,46 @@ int vtkCellTreeLocator::IntersectWithLine(const double p1[3], const double p2[3]
   return this->Tree->IntersectWithLine(p1, p2, tol, points, cellIds, cell);
 }
 
+//------------------------------------------------------------------------------
+void vtkCellTreeLocator::FindCells(
+  vtkPoints* points, double, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+{
+  const vtkIdType numPts = points->GetNumberOfPoints();
+  vtkAbstractCellLocator::InitializeQueryOutputs(numPts, cellIds, pcoords, 3, nullptr);
+  this->BuildLocator();
+  if (numPts < 1 || !this->Tree)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    return;
+  }
+  std::vector<vtkIdType> order;
+  vtkAbstractCellLocator::ComputeQueryOrder(points, order);
+  this->Tree->FindCells(points, order.data(), cellIds, pcoords);
+}
+
+//------------------------------------------------------------------------------
+void vtkCellTreeLocator::IntersectWithLines(
+  vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  const vtkIdType numLines = p1->GetNumberOfPoints();
+  if (p2->GetNumberOfPoints() != numLines)
+  {
+    vtkErrorMacro(<< "The end points of the lines differ in number");
+    cellIds->Reset();
+    return;
+  }
+  vtkAbstractCellLocator::InitializeQueryOutputs(numLines, cellIds, t, 1, x);
+  this->BuildLocator();
+  if (numLines < 1 || !this->Tree)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    return;
+  }
+  std::vector<vtkIdType> order;
+  vtkAbstractCellLocator::ComputeQueryOrder(p1, order);
+  this->Tree->IntersectWithLines(p1, p2, tol, order.data(), cellIds, t, x);
+}
+
 //------------------------------------------------------------------------------
 void vtkCellTreeLocator::GenerateRepresentation(int level, vtkPolyData* pd)
 {
@@ -1471,6 +2015,7 @@ void vtkCellTreeLocator::ShallowCopy(vtkAbstractCellLocator* locator)
     tree->Leaves = cellLocatorTree->Leaves;
     tree->Nodes = cellLocatorTree->Nodes;
     std::copy_n(cellLocatorTree->DataBBox, 6, tree->DataBBox);
+    tree->BuildCost = cellLocatorTree->BuildCost;
     this->Tree = tree;
   }
   else
@@ -1482,6 +2027,7 @@ void vtkCellTreeLocator::ShallowCopy(vtkAbstractCellLocator* locator)
     tree->Leaves = cellLocatorTree->Leaves;
     tree->Nodes = cellLocatorTree->Nodes;
     std::copy_n(cellLocatorTree->DataBBox, 6, tree->DataBBox);
+    tree->BuildCost = cellLocatorTree->BuildCost;
     this->Tree = tree;
   }
 }
@@ -25,10 +25,18 @@
  * Some methods in building and traversing the cell tree in this class were derived
  * from avtCellLocatorBIH class in the VisIT Visualization Tool.
  *
+ * The tree is built in parallel (via vtkSMPTools): the cells of the large nodes
+ * at the top of the tree are processed in parallel, and the subtrees below them
+ * are built concurrently. The resulting tree does not depend on the number of
+ * threads. When only the point coordinates change (e.g., a deforming mesh), the
+ * tree can be refit instead of rebuilt (see RefitSearchStructure): its topology
+ * is kept, and the split planes are recomputed from the new cell bounds.
+ *
  * vtkCellTreeLocator utilizes the following parent class parameters:
  * - NumberOfCellsPerNode        (default 8)
  * - CacheCellBounds             (default true)
  * - UseExistingSearchStructure  (default false)
+ * - RefitSearchStructure        (default false)
  *
  * vtkCellTreeLocator does NOT utilize the following parameters:
  * - Automatic
@@ -160,6 +168,17 @@ public:
   vtkIdType FindCell(double pos[3], double vtkNotUsed(tol2), vtkGenericCell* cell, int& subId,
     double pcoords[3], double* weights) override;
 
+  ///@{
+  /**
+   * Batched FindCell() and IntersectWithLine(), traversing the tree directly
+   * in a spatially coherent order. See vtkAbstractCellLocator.
+   */
+  void FindCells(vtkPoints* points, double tol2, vtkIdList* cellIds,
+    vtkDoubleArray* pcoords = nullptr) override;
+  void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds,
+    vtkDoubleArray* t = nullptr, vtkPoints* x = nullptr) override;
+  ///@}
+
   ///@{
   /**
    * Satisfy vtkLocator abstract interface.
@@ -183,6 +202,7 @@ protected:
   ~vtkCellTreeLocator() override;
 
   void BuildLocatorInternal() override;
+  bool RefitLocatorInternal() override;
 
   int NumberOfBuckets;
   bool LargeIds = false;
@@ -447,7 +447,21 @@ void vtkGenericCell::SetCellType(int cellType)
     this->PointIds->UnRegister(this);
     this->PointIds = this->Cell->PointIds;
     this->PointIds->Register(this);
+    this->PointIds->SetArena(this->Arena);
   }
+  if (this->Arena)
+  {
+    this->RefillPointIds();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Cells of fixed size are filled in place with SetId(), so their point ids
+// must be allocated again when the arena was rewound below them. The points
+// of the cell, which are not in the arena, keep the size.
+void vtkGenericCell::RefillPointIds()
+{
+  this->PointIds->SetNumberOfIds(this->Points->GetNumberOfPoints());
 }
 
 //------------------------------------------------------------------------------
@@ -485,6 +499,14 @@ void vtkGenericCell::SetPoints(vtkPoints* points)
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkGenericCell::SetArena(vtkMemoryArena* arena)
+{
+  this->Arena = arena;
+  this->PointIds->SetArena(arena);
+  this->RefillPointIds();
+}
+
 //------------------------------------------------------------------------------
 void vtkGenericCell::SetPointIds(vtkIdList* pointIds)
 {
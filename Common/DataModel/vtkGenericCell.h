@@ -34,6 +34,8 @@
 #include "vtkCommonDataModelModule.h" // For export macro
 
 VTK_ABI_NAMESPACE_BEGIN
+class vtkMemoryArena;
+
 class VTKCOMMONDATAMODEL_EXPORT vtkGenericCell : public vtkCell
 {
 public:
@@ -57,6 +59,19 @@ public:
    */
   void SetPointIds(vtkIdList* pointIds);
 
+  ///@{
+  /**
+   * Set/Get the arena the point ids of the cells represented by this generic
+   * cell are allocated from, or nullptr (the default) to allocate them on the
+   * heap. See vtkIdList::SetArena() for the lifetime of the ids: the point
+   * ids are allocated again when the type of the cell is set, which GetCell()
+   * and similar methods do before filling them, so a thread-local generic
+   * cell can use an arena rewound after each chunk of cells it processes.
+   */
+  void SetArena(vtkMemoryArena* arena);
+  vtkMemoryArena* GetArena() const { return this->Arena; }
+  ///@}
+
   ///@{
   /**
    * See the vtkCell API for descriptions of these methods.
@@ -180,8 +195,11 @@ protected:
 
   vtkCell* Cell;
   vtkCell* CellStore[VTK_NUMBER_OF_CELL_TYPES];
+  vtkMemoryArena* Arena = nullptr;
 
 private:
+  void RefillPointIds();
+
   vtkGenericCell(const vtkGenericCell&) = delete;
   void operator=(const vtkGenericCell&) = delete;
 };
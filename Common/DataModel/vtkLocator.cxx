@@ -30,6 +30,9 @@ vtkLocator::vtkLocator()
   this->MaxLevel = 8;
   this->Level = 8;
   this->UseExistingSearchStructure = 0;
+  this->RefitSearchStructure = 0;
+  this->RefitCostThreshold = 1.5;
+  this->Refitted = false;
 }
 
 //------------------------------------------------------------------------------
@@ -81,6 +84,8 @@ void vtkLocator::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "MaxLevel: " << this->MaxLevel << "\n";
   os << indent << "Level: " << this->Level << "\n";
   os << indent << "UseExistingSearchStructure: " << this->UseExistingSearchStructure << "\n";
+  os << indent << "RefitSearchStructure: " << this->RefitSearchStructure << "\n";
+  os << indent << "RefitCostThreshold: " << this->RefitCostThreshold << "\n";
 }
 
 //------------------------------------------------------------------------------
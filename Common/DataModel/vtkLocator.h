@@ -143,6 +143,47 @@ public:
   vtkBooleanMacro(UseExistingSearchStructure, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Get/Set RefitSearchStructure, which when enabled makes BuildLocator() assume that
+   * only the point coordinates of the dataset changed since the last build (e.g., a
+   * deforming mesh). Instead of being rebuilt, the search structure is then refit to
+   * the new coordinates: its tree or its bins are kept, and only the bounds and the
+   * points or cells which moved are updated, which is much faster. The search
+   * structure is still rebuilt if the number of points (point locators) or cells (cell
+   * locators) changed, or if the refit structure degraded too much (see
+   * RefitCostThreshold). Changes of the locator parameters only take effect at the
+   * next full build, see ForceBuildLocator().
+   *
+   * Only some locators support refitting, such as vtkStaticPointLocator,
+   * vtkStaticCellLocator, vtkCellTreeLocator and vtkBVHCellLocator. The others
+   * ignore this flag.
+   *
+   * Default is off.
+   */
+  vtkSetMacro(RefitSearchStructure, vtkTypeBool);
+  vtkGetMacro(RefitSearchStructure, vtkTypeBool);
+  vtkBooleanMacro(RefitSearchStructure, vtkTypeBool);
+  ///@}
+
+  ///@{
+  /**
+   * Get/Set the degradation of a refit search structure which triggers a full
+   * rebuild, as the ratio of its estimated query cost to the cost of the search
+   * structure when it was last built. Each locator defines its own cost, e.g., the
+   * average number of entities in the non-empty bins of a uniform binning, or the
+   * surface area heuristic of a tree. Default is 1.5.
+   */
+  vtkSetClampMacro(RefitCostThreshold, double, 1.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(RefitCostThreshold, double);
+  ///@}
+
+  /**
+   * Return whether the search structure was refit, rather than built, by the
+   * last call to BuildLocator(). See RefitSearchStructure.
+   */
+  vtkGetMacro(Refitted, bool);
+
   /**
    * Cause the locator to rebuild itself if it or its input dataset has
    * changed.
@@ -203,8 +244,20 @@ protected:
    */
   virtual void BuildLocatorInternal(){};
 
+  /**
+   * Refit the search structure to the current point coordinates of the dataset, see
+   * RefitSearchStructure. Return false if the search structure cannot be refit, or
+   * degraded too much, in which case it must be rebuilt.
+   *
+   * This function is not pure virtual to maintain backwards compatibility.
+   */
+  virtual bool RefitLocatorInternal() { return false; }
+
   vtkDataSet* DataSet;
   vtkTypeBool UseExistingSearchStructure;
+  vtkTypeBool RefitSearchStructure;
+  double RefitCostThreshold;
+  bool Refitted;
   vtkTypeBool Automatic; // boolean controls automatic subdivision (or uses user spec.)
   double Tolerance;      // for performing merging
   int MaxLevel;
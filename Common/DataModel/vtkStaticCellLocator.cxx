@@ -24,13 +24,17 @@
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkMath.h"
+#include "vtkMemoryArena.h"
 #include "vtkMergePoints.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
 
+#include <algorithm>
 #include <array>
 #include <queue>
 #include <vector>
@@ -259,6 +263,10 @@ struct vtkCellProcessor
   vtkIdType xD, xyD;
   size_t MaxCellSize;
 
+  // The average number of fragments in the non-empty bins when the locator
+  // was built, negative until first needed
+  double BuildCost = -1.0;
+
   vtkCellProcessor() = default;
 
   vtkCellProcessor(vtkCellBinner* cb)
@@ -296,6 +304,13 @@ struct vtkCellProcessor
   virtual vtkIdType FindClosestPointWithinRadius(const double x[3], double radius,
     double closestPoint[3], vtkGenericCell* cell, vtkIdType& cellId, int& subId, double& dist2,
     int& inside) = 0;
+  virtual void FindCells(vtkPoints* points, const vtkIdType* order, vtkIdList* cellIds,
+    vtkDoubleArray* pcoords) = 0;
+  virtual void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol,
+    const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x) = 0;
+
+  // Refit the locator after the points of the dataset moved
+  virtual bool Refit(double costThreshold) = 0;
 
   // Convenience for computing
   virtual int IsEmpty(vtkIdType binId) = 0;
@@ -375,10 +390,22 @@ struct CellProcessor : public vtkCellProcessor
   bool InsideCellBounds(const double x[3], vtkIdType cellId) override;
   vtkIdType FindClosestPointWithinRadius(const double x[3], double radius, double closestPoint[3],
     vtkGenericCell* cell, vtkIdType& cellId, int& subId, double& dist2, int& inside) override;
+  void FindCells(vtkPoints* points, const vtkIdType* order, vtkIdList* cellIds,
+    vtkDoubleArray* pcoords) override;
+  void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, const vtkIdType* order,
+    vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x) override;
+
+  // IntersectWithLine() with the array of visited cells provided by the
+  // caller, so that a batch of lines reuses it. The array is allocated on
+  // first use, and must be cleared between the lines.
+  int IntersectWithLine(const double p1[3], const double p2[3], double tol, double& t, double x[3],
+    double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell,
+    std::vector<bool>& cellHasBeenVisited);
   int IsEmpty(vtkIdType binId) override
   {
     return (this->GetNumberOfIds(static_cast<T>(binId)) > 0 ? 0 : 1);
   }
+  bool Refit(double costThreshold) override;
 
   // This functor is used to perform the final cell binning
   void Initialize() {}
@@ -1146,6 +1173,18 @@ vtkIdType CellProcessor<T>::FindClosestPointWithinRadius(const double x[3], doub
 template <typename T>
 int CellProcessor<T>::IntersectWithLine(const double p1[3], const double p2[3], double tol,
   double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell)
+{
+  // The intersection query array is allocated locally to ensure thread safety.
+  std::vector<bool> cellHasBeenVisited;
+  return this->IntersectWithLine(
+    p1, p2, tol, t, x, pcoords, subId, cellId, cell, cellHasBeenVisited);
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+int CellProcessor<T>::IntersectWithLine(const double p1[3], const double p2[3], double tol,
+  double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell,
+  std::vector<bool>& cellHasBeenVisited)
 {
   double* bounds = this->Binner->Bounds;
   int* ndivs = this->Binner->Divisions;
@@ -1171,9 +1210,11 @@ int CellProcessor<T>::IntersectWithLine(const double p1[3], const double p2[3],
     return 0; // No intersections possible, line is outside the locator
   }
 
-  // Initialize intersection query array if necessary. This is done
-  // locally to ensure thread safety.
-  std::vector<bool> cellHasBeenVisited(this->NumCells, false);
+  // Initialize intersection query array if necessary.
+  if (cellHasBeenVisited.empty())
+  {
+    cellHasBeenVisited.resize(this->NumCells, false);
+  }
 
   // Get the i-j-k point of intersection and bin index. This is
   // clamped to the boundary of the locator.
@@ -1321,6 +1362,82 @@ int CellProcessor<T>::IntersectWithLine(const double p1[3], const double p2[3],
   return 0;
 }
 
+//------------------------------------------------------------------------------
+// The batched queries process the ordered queries in parallel, so that each
+// thread traverses neighboring bins.
+template <typename T>
+void CellProcessor<T>::FindCells(
+  vtkPoints* points, const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+{
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPThreadLocal<std::vector<double>> tlWeights;
+  vtkSMPTools::For(0, points->GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end) {
+    // The cells fetched by a chunk draw their point ids from the thread arena.
+    vtkMemoryArena::Scope scope;
+    vtkGenericCell* cell = tlCell.Local();
+    cell->SetArena(scope.GetArena());
+    std::vector<double>& weights = tlWeights.Local();
+    weights.resize(this->MaxCellSize);
+    double x[3], pc[3];
+    int subId;
+    for (; begin < end; ++begin)
+    {
+      const vtkIdType ptId = order[begin];
+      points->GetPoint(ptId, x);
+      const vtkIdType cellId = this->FindCell(x, cell, subId, pc, weights.data());
+      cellIds->SetId(ptId, cellId);
+      if (pcoords)
+      {
+        if (cellId < 0)
+        {
+          pc[0] = pc[1] = pc[2] = 0.0;
+        }
+        pcoords->SetTypedTuple(ptId, pc);
+      }
+    }
+  });
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+void CellProcessor<T>::IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol,
+  const vtkIdType* order, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPThreadLocal<std::vector<bool>> tlCellHasBeenVisited;
+  vtkSMPTools::For(0, cellIds->GetNumberOfIds(), [&](vtkIdType begin, vtkIdType end) {
+    vtkMemoryArena::Scope scope;
+    vtkGenericCell* cell = tlCell.Local();
+    cell->SetArena(scope.GetArena());
+    std::vector<bool>& cellHasBeenVisited = tlCellHasBeenVisited.Local();
+    double a0[3], a1[3], tHit, xHit[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    for (; begin < end; ++begin)
+    {
+      const vtkIdType lineId = order[begin];
+      p1->GetPoint(lineId, a0);
+      p2->GetPoint(lineId, a1);
+      if (!this->IntersectWithLine(a0, a1, tol, tHit, xHit, pcoords, subId, cellId, cell,
+            cellHasBeenVisited))
+      {
+        cellId = -1;
+        tHit = xHit[0] = xHit[1] = xHit[2] = 0.0;
+      }
+      std::fill(cellHasBeenVisited.begin(), cellHasBeenVisited.end(), false);
+      cellIds->SetId(lineId, cellId);
+      if (t)
+      {
+        t->SetValue(lineId, tHit);
+      }
+      if (x)
+      {
+        x->SetPoint(lineId, xHit);
+      }
+    }
+  });
+}
+
 //------------------------------------------------------------------------------
 template <typename T>
 bool CellProcessor<T>::InsideCellBounds(const double x[3], vtkIdType cellId)
@@ -1329,6 +1446,183 @@ bool CellProcessor<T>::InsideCellBounds(const double x[3], vtkIdType cellId)
 }
 } // anonymous namespace
 
+//------------------------------------------------------------------------------
+// Refit the locator after the points of the dataset moved, keeping the bins:
+// the cell bounds are recomputed, and the cells overlapping other bins than
+// before are removed from their old bins and appended to their new ones. The
+// shared map, offsets and cell bounds of the shallow copies are not modified.
+// The cells must remain within the bounds of the bins.
+template <typename T>
+bool CellProcessor<T>::Refit(double costThreshold)
+{
+  vtkCellBinner* binner = this->Binner;
+  const vtkIdType numCells = this->NumCells;
+  if (this->BuildCost < 0.0)
+  {
+    vtkSMPThreadLocal<vtkIdType> tlNumNonEmptyBins(0);
+    vtkSMPTools::For(0, this->NumBins, [&](vtkIdType binId, vtkIdType endBinId) {
+      vtkIdType& numNonEmptyBins = tlNumNonEmptyBins.Local();
+      for (; binId < endBinId; ++binId)
+      {
+        numNonEmptyBins += (this->GetNumberOfIds(binId) > 0 ? 1 : 0);
+      }
+    });
+    vtkIdType numNonEmptyBins = 0;
+    for (vtkIdType localNumNonEmptyBins : tlNumNonEmptyBins)
+    {
+      numNonEmptyBins += localNumNonEmptyBins;
+    }
+    this->BuildCost =
+      static_cast<double>(this->NumFragments) / std::max<vtkIdType>(numNonEmptyBins, 1);
+  }
+
+  // Compute the new cell bounds, and the fragments of the cells whose range
+  // of bins changed. The bounds of the first cell are computed first to
+  // cause the non-thread safe initialization of GetCellBounds().
+  auto cellBoundsSharedPtr = std::make_shared<std::vector<double>>(numCells * 6);
+  double* cellBounds = cellBoundsSharedPtr->data();
+  this->DataSet->GetCellBounds(0, cellBounds);
+  std::vector<unsigned char> moved(numCells);
+  vtkSMPThreadLocal<vtkBoundingBox> tlBounds;
+  vtkSMPThreadLocal<std::vector<CellFragments<T>>> tlAdded;
+  auto getBinRange = [binner](const double* bds, int ijkMin[3], int ijkMax[3]) {
+    const double xmin[3] = { bds[0], bds[2], bds[4] };
+    const double xmax[3] = { bds[1], bds[3], bds[5] };
+    binner->GetBinIndices(xmin, ijkMin);
+    binner->GetBinIndices(xmax, ijkMax);
+  };
+  vtkSMPTools::For(0, numCells, [&](vtkIdType cellId, vtkIdType endCellId) {
+    vtkBoundingBox& bbox = tlBounds.Local();
+    std::vector<CellFragments<T>>& added = tlAdded.Local();
+    int oldMin[3], oldMax[3], ijkMin[3], ijkMax[3];
+    for (; cellId < endCellId; ++cellId)
+    {
+      double* bds = cellBounds + 6 * cellId;
+      if (cellId > 0)
+      {
+        this->DataSet->GetCellBounds(cellId, bds);
+      }
+      bbox.AddBounds(bds);
+      getBinRange(this->CellBounds + 6 * cellId, oldMin, oldMax);
+      getBinRange(bds, ijkMin, ijkMax);
+      if (std::equal(oldMin, oldMin + 3, ijkMin) && std::equal(oldMax, oldMax + 3, ijkMax))
+      {
+        continue;
+      }
+      moved[cellId] = 1;
+      for (int k = ijkMin[2]; k <= ijkMax[2]; ++k)
+      {
+        for (int j = ijkMin[1]; j <= ijkMax[1]; ++j)
+        {
+          for (int i = ijkMin[0]; i <= ijkMax[0]; ++i)
+          {
+            CellFragments<T> fragment;
+            fragment.CellId = static_cast<T>(cellId);
+            fragment.BinId = static_cast<T>(i + j * this->xD + k * this->xyD);
+            added.push_back(fragment);
+          }
+        }
+      }
+    }
+  });
+  vtkBoundingBox bbox;
+  for (const auto& localBounds : tlBounds)
+  {
+    bbox.AddBox(localBounds);
+  }
+  vtkBoundingBox binsBox(binner->Bounds);
+  if (!bbox.IsValid() || !binsBox.Contains(bbox))
+  {
+    return false;
+  }
+  binner->CellBoundsSharedPtr = cellBoundsSharedPtr;
+  binner->CellBounds = this->CellBounds = cellBounds;
+
+  std::vector<CellFragments<T>> added;
+  for (const auto& localAdded : tlAdded)
+  {
+    added.insert(added.end(), localAdded.begin(), localAdded.end());
+  }
+  if (added.empty())
+  {
+    return true;
+  }
+  vtkSMPTools::Sort(
+    added.begin(), added.end(), [](const CellFragments<T>& f0, const CellFragments<T>& f1) {
+      return f0.BinId < f1.BinId || (f0.BinId == f1.BinId && f0.CellId < f1.CellId);
+    });
+
+  // The first added fragment of a bin
+  auto firstAdded = [&added](vtkIdType binId) {
+    return std::lower_bound(added.begin(), added.end(), binId,
+      [](const CellFragments<T>& fragment, vtkIdType b) { return fragment.BinId < b; });
+  };
+
+  // Count the fragments of each bin, and compute the new offsets
+  std::vector<T> counts(this->NumBins);
+  vtkSMPTools::For(0, this->NumBins, [&](vtkIdType binId, vtkIdType endBinId) {
+    auto fragment = firstAdded(binId);
+    for (; binId < endBinId; ++binId)
+    {
+      T count = 0;
+      for (T i = this->Offsets[binId]; i < this->Offsets[binId + 1]; ++i)
+      {
+        count += (moved[this->Map[i].CellId] ? 0 : 1);
+      }
+      for (; fragment != added.end() && fragment->BinId == binId; ++fragment)
+      {
+        ++count;
+      }
+      counts[binId] = count;
+    }
+  });
+  auto offsetsSharedPtr = std::make_shared<std::vector<T>>(this->NumBins + 1);
+  T* offsets = offsetsSharedPtr->data();
+  T numFragments = 0;
+  vtkIdType numNonEmptyBins = 0;
+  for (vtkIdType binId = 0; binId < this->NumBins; ++binId)
+  {
+    offsets[binId] = numFragments;
+    numFragments += counts[binId];
+    numNonEmptyBins += (counts[binId] > 0 ? 1 : 0);
+  }
+  offsets[this->NumBins] = numFragments;
+
+  // Fill the bins with their remaining fragments, then the added ones
+  auto mapSharedPtr = std::make_shared<std::vector<CellFragments<T>>>(numFragments + 1);
+  CellFragments<T>* map = mapSharedPtr->data();
+  map[numFragments].BinId = static_cast<T>(this->NumBins);
+  vtkSMPTools::For(0, this->NumBins, [&](vtkIdType binId, vtkIdType endBinId) {
+    auto fragment = firstAdded(binId);
+    for (; binId < endBinId; ++binId)
+    {
+      CellFragments<T>* t = map + offsets[binId];
+      for (T i = this->Offsets[binId]; i < this->Offsets[binId + 1]; ++i)
+      {
+        if (!moved[this->Map[i].CellId])
+        {
+          *t++ = this->Map[i];
+        }
+      }
+      for (; fragment != added.end() && fragment->BinId == binId; ++fragment)
+      {
+        *t++ = *fragment;
+      }
+    }
+  });
+
+  binner->NumFragments = this->NumFragments = numFragments;
+  this->NumBatches =
+    static_cast<int>(std::ceil(static_cast<double>(this->NumFragments) / this->BatchSize));
+  this->MapSharedPtr = mapSharedPtr;
+  this->Map = map;
+  this->OffsetsShardPtr = offsetsSharedPtr;
+  this->Offsets = offsets;
+
+  const double cost = static_cast<double>(numFragments) / std::max<vtkIdType>(numNonEmptyBins, 1);
+  return cost <= costThreshold * this->BuildCost;
+}
+
 //------------------------------------------------------------------------------
 // Here is the VTK class proper.
 
@@ -1446,6 +1740,46 @@ int vtkStaticCellLocator::IntersectWithLine(const double p1[3], const double p2[
   return this->Processor->IntersectWithLine(p1, p2, tol, points, cellIds, cell);
 }
 
+//------------------------------------------------------------------------------
+void vtkStaticCellLocator::FindCells(
+  vtkPoints* points, double, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+{
+  const vtkIdType numPts = points->GetNumberOfPoints();
+  vtkAbstractCellLocator::InitializeQueryOutputs(numPts, cellIds, pcoords, 3, nullptr);
+  this->BuildLocator();
+  if (numPts < 1 || !this->Processor)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    return;
+  }
+  std::vector<vtkIdType> order;
+  vtkAbstractCellLocator::ComputeQueryOrder(points, order);
+  this->Processor->FindCells(points, order.data(), cellIds, pcoords);
+}
+
+//------------------------------------------------------------------------------
+void vtkStaticCellLocator::IntersectWithLines(
+  vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  const vtkIdType numLines = p1->GetNumberOfPoints();
+  if (p2->GetNumberOfPoints() != numLines)
+  {
+    vtkErrorMacro(<< "The end points of the lines differ in number");
+    cellIds->Reset();
+    return;
+  }
+  vtkAbstractCellLocator::InitializeQueryOutputs(numLines, cellIds, t, 1, x);
+  this->BuildLocator();
+  if (numLines < 1 || !this->Processor)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    return;
+  }
+  std::vector<vtkIdType> order;
+  vtkAbstractCellLocator::ComputeQueryOrder(p1, order);
+  this->Processor->IntersectWithLines(p1, p2, tol, order.data(), cellIds, t, x);
+}
+
 //------------------------------------------------------------------------------
 bool vtkStaticCellLocator::InsideCellBounds(double x[3], vtkIdType cellId)
 {
@@ -1467,6 +1801,14 @@ void vtkStaticCellLocator::BuildLocator()
     vtkDebugMacro(<< "BuildLocator exited - UseExistingSearchStructure");
     return;
   }
+  // refit instead of rebuilding if RefitSearchStructure is ON and a search structure exists
+  if (this->Binner && this->RefitSearchStructure && this->RefitLocatorInternal())
+  {
+    this->Refitted = true;
+    this->BuildTime.Modified();
+    vtkDebugMacro(<< "BuildLocator exited - RefitSearchStructure");
+    return;
+  }
   this->BuildLocatorInternal();
 }
 
@@ -1480,6 +1822,7 @@ void vtkStaticCellLocator::ForceBuildLocator()
 void vtkStaticCellLocator::BuildLocatorInternal()
 {
   vtkDebugMacro(<< "Building static cell locator");
+  this->Refitted = false;
   vtkIdType numCells;
   if (!this->DataSet || (numCells = this->DataSet->GetNumberOfCells()) < 1)
   {
@@ -1557,6 +1900,18 @@ void vtkStaticCellLocator::BuildLocatorInternal()
   this->BuildTime.Modified();
 }
 
+//------------------------------------------------------------------------------
+// Re-bin the cells which moved, keeping the bins.
+bool vtkStaticCellLocator::RefitLocatorInternal()
+{
+  if (!this->Processor || this->DataSet->GetNumberOfCells() != this->Binner->NumCells)
+  {
+    return false;
+  }
+  vtkDebugMacro(<< "Refitting static cell locator");
+  return this->Processor->Refit(this->RefitCostThreshold);
+}
+
 //------------------------------------------------------------------------------
 // Produce a polygonal representation of the locator. Each bin which contains
 // a potential cell candidate contributes to the representation. Note that
@@ -1777,6 +2132,7 @@ void vtkStaticCellLocator::ShallowCopy(vtkAbstractCellLocator* locator)
     processor->NumBins = this->Binner->NumBins;
     processor->BatchSize = cellLocatorProcessor->BatchSize;
     processor->NumBatches = cellLocatorProcessor->NumBatches;
+    processor->BuildCost = cellLocatorProcessor->BuildCost;
     processor->xD = this->Binner->xD;
     processor->xyD = this->Binner->xyD;
     processor->MaxCellSize = cellLocatorProcessor->MaxCellSize;
@@ -1800,6 +2156,7 @@ void vtkStaticCellLocator::ShallowCopy(vtkAbstractCellLocator* locator)
     processor->NumBins = this->Binner->NumBins;
     processor->BatchSize = cellLocatorProcessor->BatchSize;
     processor->NumBatches = cellLocatorProcessor->NumBatches;
+    processor->BuildCost = cellLocatorProcessor->BuildCost;
     processor->xD = this->Binner->xD;
     processor->xyD = this->Binner->xyD;
     processor->MaxCellSize = cellLocatorProcessor->MaxCellSize;
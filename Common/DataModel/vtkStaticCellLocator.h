@@ -23,13 +23,17 @@
  *
  * vtkStaticCellLocator is an accelerated version of vtkCellLocator. It is
  * threaded (via vtkSMPTools), and supports one-time static construction
- * (i.e., incremental cell insertion is not supported).
+ * (i.e., incremental cell insertion is not supported). When only the point
+ * coordinates change (e.g., a deforming mesh), the locator can be refit
+ * instead of rebuilt (see RefitSearchStructure): the bins are kept, and only
+ * the cells overlapping other bins than before are re-binned.
  *
  * @warning
  * vtkStaticCellLocator utilizes the following parent class parameters:
  * - Automatic                   (default true)
  * - NumberOfCellsPerNode        (default 10)
  * - UseExistingSearchStructure  (default false)
+ * - RefitSearchStructure        (default false)
  *
  * vtkStaticCellLocator does NOT utilize the following parameters:
  * - CacheCellBounds             (always cached)
@@ -242,6 +246,17 @@ public:
   vtkIdType FindCell(double x[3], double vtkNotUsed(tol2), vtkGenericCell* GenCell, int& subId,
     double pcoords[3], double* weights) override;
 
+  ///@{
+  /**
+   * Batched FindCell() and IntersectWithLine(), traversing the bins directly
+   * in a spatially coherent order. See vtkAbstractCellLocator.
+   */
+  void FindCells(vtkPoints* points, double tol2, vtkIdList* cellIds,
+    vtkDoubleArray* pcoords = nullptr) override;
+  void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds,
+    vtkDoubleArray* t = nullptr, vtkPoints* x = nullptr) override;
+  ///@}
+
   /**
    * Quickly test if a point is inside the bounds of a particular cell.
    * This function should be used ONLY after the locator is built.
@@ -268,6 +283,7 @@ protected:
   ~vtkStaticCellLocator() override;
 
   void BuildLocatorInternal() override;
+  bool RefitLocatorInternal() override;
 
   double Bounds[6]; // Bounding box of the whole dataset
   int Divisions[3]; // Number of sub-divisions in x-y-z directions
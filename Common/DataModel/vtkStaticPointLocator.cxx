@@ -19,6 +19,7 @@
 #include "vtkCellArray.h"
 #include "vtkDataArray.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIntArray.h"
 #include "vtkLine.h"
 #include "vtkMath.h"
@@ -30,6 +31,8 @@
 #include "vtkSMPTools.h"
 #include "vtkStructuredData.h"
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 VTK_ABI_NAMESPACE_BEGIN
@@ -58,6 +61,14 @@ vtkStandardNewMacro(vtkStaticPointLocator);
 // in vtkPointLocator and vtkStaticPointLocator and causing weird faults.
 struct NeighborBuckets;
 
+// A point gathered, with its coordinates, to be compared with a group of
+// nearby points
+struct NeighborCandidate
+{
+  double X[3];
+  vtkIdType PtId;
+};
+
 //------------------------------------------------------------------------------
 // The bucketed points, including the sorted map. This is just a PIMPLd
 // wrapper around the classes that do the real work.
@@ -110,9 +121,14 @@ struct vtkBucketList
     this->xyD = this->Divisions[0] * this->Divisions[1];
   }
 
+  // The average number of points in the non-empty buckets when the locator
+  // was built, negative until first needed
+  double BuildCost = -1.0;
+
   // Virtuals for templated subclasses
   virtual ~vtkBucketList() = default;
   virtual void BuildLocator() = 0;
+  virtual bool Refit(double costThreshold) = 0;
 
   // place points in appropriate buckets
   void GetBucketNeighbors(
@@ -492,6 +508,10 @@ struct BucketList : public vtkBucketList
     double radius, const double x[3], double inputDataLength, double& dist2);
   void FindClosestNPoints(int N, const double x[3], vtkIdList* result);
   void FindPointsWithinRadius(double R, const double x[3], vtkIdList* result);
+  void FindClosestNPointsGraph(int N, vtkIdType beginId, vtkIdType endId,
+    vtkIdTypeArray* offsets, vtkIdTypeArray* neighbors);
+  void FindPointsWithinRadiusGraph(double R, vtkIdType beginId, vtkIdType endId,
+    vtkIdTypeArray* offsets, vtkIdTypeArray* neighbors);
   int IntersectWithLine(double a0[3], double a1[3], double tol, double& t, double lineX[3],
     double ptX[3], vtkIdType& ptId);
   void MergePoints(double tol, vtkIdType* pointMap, int orderingMode);
@@ -501,6 +521,12 @@ struct BucketList : public vtkBucketList
   // Internal methods
   void GetOverlappingBuckets(
     NeighborBuckets* buckets, const double x[3], const int ijk[3], double dist, int level);
+  const LocatorTuple<TIds>* GetPointsByBucket(
+    vtkIdType beginId, vtkIdType endId, std::vector<LocatorTuple<TIds>>& tuples);
+  template <typename TFunctor>
+  void ForEachBucketGroup(const LocatorTuple<TIds>* tuples, vtkIdType numTuples, TFunctor& f);
+  void GetCandidates(const LocatorTuple<TIds>* begin, const LocatorTuple<TIds>* end, double dist,
+    const int* ijkMin, const int* ijkMax, std::vector<NeighborCandidate>& candidates);
   void GetOverlappingBuckets(NeighborBuckets* buckets, const double x[3], double dist,
     int prevMinLevel[3], int prevMaxLevel[3]);
 
@@ -510,17 +536,19 @@ struct BucketList : public vtkBucketList
   {
     BucketList<T>* BList;
     vtkDataSet* DataSet;
+    LocatorTuple<T>* Map;
 
-    MapDataSet(BucketList<T>* blist, vtkDataSet* ds)
+    MapDataSet(BucketList<T>* blist, vtkDataSet* ds, LocatorTuple<T>* map)
       : BList(blist)
       , DataSet(ds)
+      , Map(map)
     {
     }
 
     void operator()(vtkIdType ptId, vtkIdType end)
     {
       double p[3];
-      LocatorTuple<T>* t = this->BList->Map + ptId;
+      LocatorTuple<T>* t = this->Map + ptId;
 
       for (; ptId < end; ++ptId, ++t)
       {
@@ -537,10 +565,12 @@ struct BucketList : public vtkBucketList
   {
     BucketList<T>* BList;
     const TPts* Points;
+    LocatorTuple<T>* Map;
 
-    MapPointsArray(BucketList<T>* blist, const TPts* pts)
+    MapPointsArray(BucketList<T>* blist, const TPts* pts, LocatorTuple<T>* map)
       : BList(blist)
       , Points(pts)
+      , Map(map)
     {
     }
 
@@ -548,7 +578,7 @@ struct BucketList : public vtkBucketList
     {
       double p[3];
       const TPts* x = this->Points + 3 * ptId;
-      LocatorTuple<T>* t = this->BList->Map + ptId;
+      LocatorTuple<T>* t = this->Map + ptId;
 
       for (; ptId < end; ++ptId, x += 3, ++t)
       {
@@ -998,11 +1028,9 @@ struct BucketList : public vtkBucketList
     void Reduce() {}
   }; // MergePointsWithData
 
-  // Build the map and other structures to support locator operations
-  void BuildLocator() override
+  // Assign each point to its bucket: map[ptId] is (ptId, bucket).
+  void MapPoints(LocatorTuple<TIds>* map)
   {
-    // Place each point in a bucket
-    //
     vtkPointSet* ps = vtkPointSet::SafeDownCast(this->DataSet);
     if (ps)
     { // map points array: explicit points representation of float or double
@@ -1010,20 +1038,28 @@ struct BucketList : public vtkBucketList
       void* pts = ps->GetPoints()->GetVoidPointer(0);
       if (dataType == VTK_FLOAT)
       {
-        MapPointsArray<TIds, float> mapper(this, static_cast<float*>(pts));
+        MapPointsArray<TIds, float> mapper(this, static_cast<float*>(pts), map);
         vtkSMPTools::For(0, this->NumPts, mapper);
       }
       else if (dataType == VTK_DOUBLE)
       {
-        MapPointsArray<TIds, double> mapper(this, static_cast<double*>(pts));
+        MapPointsArray<TIds, double> mapper(this, static_cast<double*>(pts), map);
         vtkSMPTools::For(0, this->NumPts, mapper);
       }
     }
     else // if (!mapped)
     {    // map dataset points: non-float points or implicit points representation
-      MapDataSet<TIds> mapper(this, this->DataSet);
+      MapDataSet<TIds> mapper(this, this->DataSet, map);
       vtkSMPTools::For(0, this->NumPts, mapper);
     }
+  }
+
+  // Build the map and other structures to support locator operations
+  void BuildLocator() override
+  {
+    // Place each point in a bucket
+    //
+    this->MapPoints(this->Map);
 
     // Now group the points into contiguous runs within buckets (recall that
     // sorting is occurring based on bin/bucket id).
@@ -1037,6 +1073,152 @@ struct BucketList : public vtkBucketList
     MapOffsets<TIds> offMapper(this);
     vtkSMPTools::For(0, numBatches, offMapper);
   }
+
+  // Return the number of buckets containing points.
+  vtkIdType GetNumberOfNonEmptyBuckets()
+  {
+    vtkSMPThreadLocal<vtkIdType> tlCount(0);
+    vtkSMPTools::For(0, this->NumBuckets, [&](vtkIdType bucket, vtkIdType endBucket) {
+      vtkIdType& count = tlCount.Local();
+      for (; bucket < endBucket; ++bucket)
+      {
+        count += (this->Offsets[bucket + 1] > this->Offsets[bucket] ? 1 : 0);
+      }
+    });
+    vtkIdType count = 0;
+    for (vtkIdType localCount : tlCount)
+    {
+      count += localCount;
+    }
+    return count;
+  }
+
+  // Refit the locator after the points moved, keeping the buckets: the
+  // points which moved to another bucket are removed from their old bucket
+  // and merged into their new one. The points of each bucket remain sorted
+  // by id, so the result is the one of BuildLocator() with these buckets.
+  // The points must remain within the bounds of the buckets.
+  bool Refit(double costThreshold) override
+  {
+    const double* bounds = this->DataSet->GetBounds();
+    for (int i = 0; i < 3; ++i)
+    {
+      if (bounds[2 * i] < this->Bounds[2 * i] || bounds[2 * i + 1] > this->Bounds[2 * i + 1])
+      {
+        return false;
+      }
+    }
+    if (this->BuildCost < 0.0)
+    {
+      this->BuildCost = static_cast<double>(this->NumPts) /
+        std::max<vtkIdType>(this->GetNumberOfNonEmptyBuckets(), 1);
+    }
+
+    // The new bucket of each point, and the points which moved to another
+    // bucket sorted by bucket and id.
+    std::vector<LocatorTuple<TIds>> pointBuckets(this->NumPts);
+    this->MapPoints(pointBuckets.data());
+    vtkSMPThreadLocal<std::vector<LocatorTuple<TIds>>> tlMoved;
+    vtkSMPTools::For(0, this->NumPts, [&](vtkIdType i, vtkIdType end) {
+      std::vector<LocatorTuple<TIds>>& moved = tlMoved.Local();
+      for (; i < end; ++i)
+      {
+        const LocatorTuple<TIds>& pointBucket = pointBuckets[this->Map[i].PtId];
+        if (pointBucket.Bucket != this->Map[i].Bucket)
+        {
+          moved.push_back(pointBucket);
+        }
+      }
+    });
+    std::vector<LocatorTuple<TIds>> moved;
+    for (const auto& localMoved : tlMoved)
+    {
+      moved.insert(moved.end(), localMoved.begin(), localMoved.end());
+    }
+    if (moved.empty())
+    {
+      return true;
+    }
+    vtkSMPTools::Sort(moved.begin(), moved.end());
+
+    // The first moved point of a bucket
+    auto firstMoved = [&moved](vtkIdType bucket) {
+      return std::lower_bound(moved.begin(), moved.end(), bucket,
+        [](const LocatorTuple<TIds>& tuple, vtkIdType b) { return tuple.Bucket < b; });
+    };
+
+    // Count the points of each bucket, and compute the new offsets
+    std::vector<TIds> counts(this->NumBuckets);
+    vtkSMPTools::For(0, this->NumBuckets, [&](vtkIdType bucket, vtkIdType endBucket) {
+      auto added = firstMoved(bucket);
+      for (; bucket < endBucket; ++bucket)
+      {
+        TIds count = 0;
+        for (TIds i = this->Offsets[bucket]; i < this->Offsets[bucket + 1]; ++i)
+        {
+          count += (pointBuckets[this->Map[i].PtId].Bucket == bucket ? 1 : 0);
+        }
+        for (; added != moved.end() && added->Bucket == bucket; ++added)
+        {
+          ++count;
+        }
+        counts[bucket] = count;
+      }
+    });
+    TIds* offsets = new TIds[this->NumBuckets + 1];
+    TIds offset = 0;
+    vtkIdType numNonEmptyBuckets = 0;
+    for (vtkIdType bucket = 0; bucket < this->NumBuckets; ++bucket)
+    {
+      offsets[bucket] = offset;
+      offset += counts[bucket];
+      numNonEmptyBuckets += (counts[bucket] > 0 ? 1 : 0);
+    }
+    offsets[this->NumBuckets] = this->NumPts;
+
+    // Merge the points remaining in each bucket with the ones added to it
+    LocatorTuple<TIds>* map = new LocatorTuple<TIds>[this->NumPts + 1];
+    map[this->NumPts].Bucket = this->NumBuckets;
+    vtkSMPTools::For(0, this->NumBuckets, [&](vtkIdType bucket, vtkIdType endBucket) {
+      auto added = firstMoved(bucket);
+      for (; bucket < endBucket; ++bucket)
+      {
+        LocatorTuple<TIds>* t = map + offsets[bucket];
+        TIds i = this->Offsets[bucket];
+        const TIds end = this->Offsets[bucket + 1];
+        while (true)
+        {
+          for (; i < end && pointBuckets[this->Map[i].PtId].Bucket != bucket; ++i)
+          {
+            // skip the points which left the bucket
+          }
+          const bool addedFirst = added != moved.end() && added->Bucket == bucket &&
+            (i == end || added->PtId < this->Map[i].PtId);
+          if (addedFirst)
+          {
+            *t++ = *added++;
+          }
+          else if (i < end)
+          {
+            *t++ = this->Map[i++];
+          }
+          else
+          {
+            break;
+          }
+        }
+      }
+    });
+
+    delete[] this->Map;
+    delete[] this->Offsets;
+    this->Map = map;
+    this->Offsets = offsets;
+
+    const double cost =
+      static_cast<double>(this->NumPts) / std::max<vtkIdType>(numNonEmptyBuckets, 1);
+    return cost <= costThreshold * this->BuildCost;
+  }
 };
 
 //------------------------------------------------------------------------------
@@ -1464,6 +1646,303 @@ void BucketList<TIds>::FindPointsWithinRadius(double R, const double x[3], vtkId
   }         // k-footprint
 }
 
+//------------------------------------------------------------------------------
+// The points of ids in [beginId, endId) sorted by bucket, then by id. This is
+// the map itself when all the points are requested.
+template <typename TIds>
+const LocatorTuple<TIds>* BucketList<TIds>::GetPointsByBucket(
+  vtkIdType beginId, vtkIdType endId, std::vector<LocatorTuple<TIds>>& tuples)
+{
+  if (beginId == 0 && endId == this->NumPts)
+  {
+    return this->Map;
+  }
+  tuples.resize(endId - beginId);
+  vtkSMPTools::For(beginId, endId, [&](vtkIdType ptId, vtkIdType end) {
+    double p[3];
+    for (; ptId < end; ++ptId)
+    {
+      this->DataSet->GetPoint(ptId, p);
+      tuples[ptId - beginId].Bucket = static_cast<TIds>(this->GetBucketIndex(p));
+      tuples[ptId - beginId].PtId = static_cast<TIds>(ptId);
+    }
+  });
+  vtkSMPTools::Sort(tuples.begin(), tuples.end());
+  return tuples.data();
+}
+
+//------------------------------------------------------------------------------
+// Invoke f(begin, end) in parallel on each group of consecutive tuples
+// sharing the same bucket. The ranges processed by the threads are aligned on
+// the groups: a range skips the group started by the previous range, and
+// completes its last group.
+template <typename TIds>
+template <typename TFunctor>
+void BucketList<TIds>::ForEachBucketGroup(
+  const LocatorTuple<TIds>* tuples, vtkIdType numTuples, TFunctor& f)
+{
+  vtkSMPTools::For(0, numTuples, [&](vtkIdType begin, vtkIdType end) {
+    while (begin > 0 && begin < end && tuples[begin].Bucket == tuples[begin - 1].Bucket)
+    {
+      ++begin;
+    }
+    if (begin >= end)
+    {
+      return;
+    }
+    while (end < numTuples && tuples[end].Bucket == tuples[end - 1].Bucket)
+    {
+      ++end;
+    }
+    while (begin < end)
+    {
+      vtkIdType groupEnd = begin + 1;
+      while (groupEnd < end && tuples[groupEnd].Bucket == tuples[begin].Bucket)
+      {
+        ++groupEnd;
+      }
+      f(tuples + begin, tuples + groupEnd);
+      begin = groupEnd;
+    }
+  });
+}
+
+//------------------------------------------------------------------------------
+// Append to candidates the points of the buckets overlapping the bounding
+// box of the points [begin, end) expanded by dist, in the order of
+// FindPointsWithinRadius(). The buckets of indices in [ijkMin, ijkMax], if
+// provided, are skipped. The ijk range of the buckets is returned in
+// ijkMin/ijkMax when they are not provided.
+template <typename TIds>
+void BucketList<TIds>::GetCandidates(const LocatorTuple<TIds>* begin,
+  const LocatorTuple<TIds>* end, double dist, const int* ijkMin, const int* ijkMax,
+  std::vector<NeighborCandidate>& candidates)
+{
+  vtkBoundingBox bbox;
+  double p[3];
+  for (const LocatorTuple<TIds>* t = begin; t < end; ++t)
+  {
+    this->DataSet->GetPoint(t->PtId, p);
+    bbox.AddPoint(p);
+  }
+  bbox.Inflate(dist);
+  int lo[3], hi[3];
+  this->GetBucketIndices(bbox.GetMinPoint(), lo);
+  this->GetBucketIndices(bbox.GetMaxPoint(), hi);
+
+  NeighborCandidate candidate;
+  for (int k = lo[2]; k <= hi[2]; ++k)
+  {
+    for (int j = lo[1]; j <= hi[1]; ++j)
+    {
+      for (int i = lo[0]; i <= hi[0]; ++i)
+      {
+        if (ijkMin && i >= ijkMin[0] && i <= ijkMax[0] && j >= ijkMin[1] && j <= ijkMax[1] &&
+          k >= ijkMin[2] && k <= ijkMax[2])
+        {
+          continue;
+        }
+        const vtkIdType cno = i + j * this->xD + k * this->xyD;
+        const LocatorTuple<TIds>* ids = this->GetIds(cno);
+        for (vtkIdType ii = 0, numIds = this->GetNumberOfIds(cno); ii < numIds; ++ii)
+        {
+          candidate.PtId = ids[ii].PtId;
+          this->DataSet->GetPoint(candidate.PtId, candidate.X);
+          candidates.push_back(candidate);
+        }
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+// The N closest points of each point of [beginId, endId). The points of a
+// bucket are processed together: the smallest block of buckets around their
+// bucket holding at least N points gives an upper bound of the distance to
+// their Nth closest point, and the points of the buckets within this distance
+// are gathered once for all of them.
+template <typename TIds>
+void BucketList<TIds>::FindClosestNPointsGraph(int N, vtkIdType beginId, vtkIdType endId,
+  vtkIdTypeArray* offsets, vtkIdTypeArray* neighbors)
+{
+  const vtkIdType numNeighbors = std::min<vtkIdType>(std::max(N, 0), this->NumPts);
+  const vtkIdType numPts = endId - beginId;
+  offsets->SetNumberOfValues(numPts + 1);
+  neighbors->SetNumberOfValues(numPts * numNeighbors);
+  vtkIdType* offsetsPtr = offsets->GetPointer(0);
+  vtkIdType* neighborsPtr = neighbors->GetPointer(0);
+  vtkSMPTools::For(0, numPts + 1, [&](vtkIdType i, vtkIdType end) {
+    for (; i < end; ++i)
+    {
+      offsetsPtr[i] = i * numNeighbors;
+    }
+  });
+  if (numNeighbors == 0)
+  {
+    return;
+  }
+
+  std::vector<LocatorTuple<TIds>> tuples;
+  const LocatorTuple<TIds>* sorted = this->GetPointsByBucket(beginId, endId, tuples);
+  vtkSMPThreadLocal<std::vector<NeighborCandidate>> tlCandidates;
+  vtkSMPThreadLocal<std::vector<IdTuple>> tlDistances;
+  vtkSMPThreadLocal<std::vector<double>> tlMaxDist2;
+  auto findNeighbors = [&](const LocatorTuple<TIds>* begin, const LocatorTuple<TIds>* end) {
+    std::vector<NeighborCandidate>& candidates = tlCandidates.Local();
+    std::vector<IdTuple>& distances = tlDistances.Local();
+    std::vector<double>& pointMaxDist2 = tlMaxDist2.Local();
+    candidates.clear();
+    pointMaxDist2.resize(end - begin);
+
+    // The block of buckets around the bucket of the points holding at least
+    // numNeighbors points
+    int ijk[3], ijkMin[3], ijkMax[3];
+    const vtkIdType bucket = begin->Bucket;
+    ijk[2] = static_cast<int>(bucket / this->xyD);
+    ijk[1] = static_cast<int>((bucket - ijk[2] * this->xyD) / this->xD);
+    ijk[0] = static_cast<int>(bucket - ijk[2] * this->xyD - ijk[1] * this->xD);
+    vtkIdType count = 0;
+    for (int level = 0; count < numNeighbors; ++level)
+    {
+      for (int d = 0; d < 3; ++d)
+      {
+        ijkMin[d] = std::max(ijk[d] - level, 0);
+        ijkMax[d] = std::min(ijk[d] + level, this->Divisions[d] - 1);
+      }
+      count = 0;
+      for (int k = ijkMin[2]; k <= ijkMax[2]; ++k)
+      {
+        for (int j = ijkMin[1]; j <= ijkMax[1]; ++j)
+        {
+          const vtkIdType cno = j * this->xD + k * this->xyD;
+          count += this->Offsets[cno + ijkMax[0] + 1] - this->Offsets[cno + ijkMin[0]];
+        }
+      }
+    }
+    NeighborCandidate candidate;
+    for (int k = ijkMin[2]; k <= ijkMax[2]; ++k)
+    {
+      for (int j = ijkMin[1]; j <= ijkMax[1]; ++j)
+      {
+        const vtkIdType cno = j * this->xD + k * this->xyD;
+        for (TIds ii = this->Offsets[cno + ijkMin[0]]; ii < this->Offsets[cno + ijkMax[0] + 1];
+             ++ii)
+        {
+          candidate.PtId = this->Map[ii].PtId;
+          this->DataSet->GetPoint(candidate.PtId, candidate.X);
+          candidates.push_back(candidate);
+        }
+      }
+    }
+
+    // The distance from each point to its Nth closest candidate bounds the
+    // distance to its Nth closest point. The largest one bounds the region
+    // holding the closest points of the group.
+    double x[3], dist2, maxDist2 = 0.0;
+    distances.resize(candidates.size());
+    for (const LocatorTuple<TIds>* t = begin; t < end; ++t)
+    {
+      this->DataSet->GetPoint(t->PtId, x);
+      for (size_t c = 0; c < candidates.size(); ++c)
+      {
+        distances[c].Dist2 = vtkMath::Distance2BetweenPoints(x, candidates[c].X);
+      }
+      std::nth_element(distances.begin(), distances.begin() + numNeighbors - 1, distances.end());
+      pointMaxDist2[t - begin] = distances[numNeighbors - 1].Dist2;
+      maxDist2 = std::max(maxDist2, distances[numNeighbors - 1].Dist2);
+    }
+    this->GetCandidates(begin, end, std::sqrt(maxDist2), ijkMin, ijkMax, candidates);
+
+    // The closest candidates within the bound, ties resolved with the
+    // smallest id
+    for (const LocatorTuple<TIds>* t = begin; t < end; ++t)
+    {
+      this->DataSet->GetPoint(t->PtId, x);
+      distances.clear();
+      for (const NeighborCandidate& candidate : candidates)
+      {
+        if ((dist2 = vtkMath::Distance2BetweenPoints(x, candidate.X)) <= pointMaxDist2[t - begin])
+        {
+          distances.push_back(IdTuple{ candidate.PtId, dist2 });
+        }
+      }
+      std::partial_sort(distances.begin(), distances.begin() + numNeighbors, distances.end(),
+        [](const IdTuple& t0, const IdTuple& t1) {
+          return t0.Dist2 < t1.Dist2 || (t0.Dist2 == t1.Dist2 && t0.PtId < t1.PtId);
+        });
+      vtkIdType* ids = neighborsPtr + (t->PtId - beginId) * numNeighbors;
+      for (vtkIdType i = 0; i < numNeighbors; ++i)
+      {
+        ids[i] = distances[i].PtId;
+      }
+    }
+  };
+  this->ForEachBucketGroup(sorted, numPts, findNeighbors);
+}
+
+//------------------------------------------------------------------------------
+// The points within R of each point of [beginId, endId). The points of a
+// bucket are processed together, gathering the points of the buckets within
+// R once for all of them. The neighbors are counted in a first pass, and
+// written in a second one once the offsets are known.
+template <typename TIds>
+void BucketList<TIds>::FindPointsWithinRadiusGraph(double R, vtkIdType beginId, vtkIdType endId,
+  vtkIdTypeArray* offsets, vtkIdTypeArray* neighbors)
+{
+  const vtkIdType numPts = endId - beginId;
+  const double R2 = R * R;
+  offsets->SetNumberOfValues(numPts + 1);
+  vtkIdType* offsetsPtr = offsets->GetPointer(0);
+  vtkIdType* neighborsPtr = nullptr;
+
+  std::vector<LocatorTuple<TIds>> tuples;
+  const LocatorTuple<TIds>* sorted = this->GetPointsByBucket(beginId, endId, tuples);
+  vtkSMPThreadLocal<std::vector<NeighborCandidate>> tlCandidates;
+  bool count = true;
+  auto findNeighbors = [&](const LocatorTuple<TIds>* begin, const LocatorTuple<TIds>* end) {
+    std::vector<NeighborCandidate>& candidates = tlCandidates.Local();
+    candidates.clear();
+    this->GetCandidates(begin, end, R, nullptr, nullptr, candidates);
+    double x[3];
+    for (const LocatorTuple<TIds>* t = begin; t < end; ++t)
+    {
+      this->DataSet->GetPoint(t->PtId, x);
+      const vtkIdType i = t->PtId - beginId;
+      vtkIdType* ids = count ? nullptr : neighborsPtr + offsetsPtr[i];
+      vtkIdType numNeighbors = 0;
+      for (const NeighborCandidate& candidate : candidates)
+      {
+        if (vtkMath::Distance2BetweenPoints(x, candidate.X) <= R2)
+        {
+          if (ids)
+          {
+            ids[numNeighbors] = candidate.PtId;
+          }
+          ++numNeighbors;
+        }
+      }
+      if (count)
+      {
+        offsetsPtr[i] = numNeighbors;
+      }
+    }
+  };
+  this->ForEachBucketGroup(sorted, numPts, findNeighbors);
+
+  vtkIdType offset = 0;
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    const vtkIdType numNeighbors = offsetsPtr[i];
+    offsetsPtr[i] = offset;
+    offset += numNeighbors;
+  }
+  offsetsPtr[numPts] = offset;
+  neighbors->SetNumberOfValues(offset);
+  neighborsPtr = neighbors->GetPointer(0);
+  count = false;
+  this->ForEachBucketGroup(sorted, numPts, findNeighbors);
+}
+
 //------------------------------------------------------------------------------
 // Find the point within tol of the finite line, and closest to the starting
 // point of the line (i.e., min parametric coordinate t).
@@ -1970,6 +2449,14 @@ void vtkStaticPointLocator::BuildLocator()
     vtkDebugMacro(<< "BuildLocator exited - UseExistingSearchStructure");
     return;
   }
+  // refit instead of rebuilding if RefitSearchStructure is ON and a search structure exists
+  if (this->Buckets && this->RefitSearchStructure && this->RefitLocatorInternal())
+  {
+    this->Refitted = true;
+    this->BuildTime.Modified();
+    vtkDebugMacro(<< "BuildLocator exited - RefitSearchStructure");
+    return;
+  }
   this->BuildLocatorInternal();
 }
 
@@ -1992,6 +2479,7 @@ void vtkStaticPointLocator::BuildLocatorInternal()
 
   vtkDebugMacro(<< "Hashing points...");
   this->Level = 1; // only single lowest level - from superclass
+  this->Refitted = false;
 
   if (!this->DataSet || (numPts = this->DataSet->GetNumberOfPoints()) < 1)
   {
@@ -2058,6 +2546,18 @@ void vtkStaticPointLocator::BuildLocatorInternal()
   this->BuildTime.Modified();
 }
 
+//------------------------------------------------------------------------------
+// Re-bucket the points which moved, keeping the buckets.
+bool vtkStaticPointLocator::RefitLocatorInternal()
+{
+  if (this->DataSet->GetNumberOfPoints() != this->Buckets->NumPts)
+  {
+    return false;
+  }
+  vtkDebugMacro(<< "Refitting points...");
+  return this->Buckets->Refit(this->RefitCostThreshold);
+}
+
 //------------------------------------------------------------------------------
 //  Method to form subdivision of space based on the points provided and
 //  subject to the constraints of levels and NumberOfPointsPerBucket.
@@ -2079,6 +2579,7 @@ void vtkStaticPointLocator::BuildLocator(const double* inBounds)
 
   vtkDebugMacro(<< "Hashing points...");
   this->Level = 1; // only single lowest level - from superclass
+  this->Refitted = false;
 
   if (!this->DataSet || (numPts = this->DataSet->GetNumberOfPoints()) < 1)
   {
@@ -2249,6 +2750,58 @@ void vtkStaticPointLocator::FindPointsWithinRadius(double R, const double x[3],
   }
 }
 
+//------------------------------------------------------------------------------
+void vtkStaticPointLocator::FindClosestNPointsGraph(int N, vtkIdTypeArray* offsets,
+  vtkIdTypeArray* neighbors, vtkIdType beginId, vtkIdType endId)
+{
+  this->BuildLocator(); // will subdivide if modified; otherwise returns
+  if (!this->Buckets)
+  {
+    offsets->SetNumberOfValues(0);
+    neighbors->SetNumberOfValues(0);
+    return;
+  }
+  endId = (endId < 0 || endId > this->Buckets->NumPts ? this->Buckets->NumPts : endId);
+  beginId = std::min(std::max<vtkIdType>(beginId, 0), endId);
+
+  if (this->LargeIds)
+  {
+    static_cast<BucketList<vtkIdType>*>(this->Buckets)
+      ->FindClosestNPointsGraph(N, beginId, endId, offsets, neighbors);
+  }
+  else
+  {
+    static_cast<BucketList<int>*>(this->Buckets)
+      ->FindClosestNPointsGraph(N, beginId, endId, offsets, neighbors);
+  }
+}
+
+//------------------------------------------------------------------------------
+void vtkStaticPointLocator::FindPointsWithinRadiusGraph(double R, vtkIdTypeArray* offsets,
+  vtkIdTypeArray* neighbors, vtkIdType beginId, vtkIdType endId)
+{
+  this->BuildLocator(); // will subdivide if modified; otherwise returns
+  if (!this->Buckets)
+  {
+    offsets->SetNumberOfValues(0);
+    neighbors->SetNumberOfValues(0);
+    return;
+  }
+  endId = (endId < 0 || endId > this->Buckets->NumPts ? this->Buckets->NumPts : endId);
+  beginId = std::min(std::max<vtkIdType>(beginId, 0), endId);
+
+  if (this->LargeIds)
+  {
+    static_cast<BucketList<vtkIdType>*>(this->Buckets)
+      ->FindPointsWithinRadiusGraph(R, beginId, endId, offsets, neighbors);
+  }
+  else
+  {
+    static_cast<BucketList<int>*>(this->Buckets)
+      ->FindPointsWithinRadiusGraph(R, beginId, endId, offsets, neighbors);
+  }
+}
+
 //------------------------------------------------------------------------------
 // This method traverses the locator along the defined ray, finding the
 // closest point to a0 when projected onto the line (a0,a1) (i.e., min
@@ -27,6 +27,10 @@
  * threaded (via vtkSMPTools), and supports one-time static construction
  * (i.e., incremental point insertion is not supported). If you need to
  * incrementally insert points, use the vtkPointLocator or its kin to do so.
+ * When only the point coordinates change (e.g., a deforming mesh), the
+ * locator can be refit instead of rebuilt (see RefitSearchStructure): the
+ * buckets are kept, and only the points which moved to another bucket are
+ * re-bucketed.
  *
  * @warning
  * This class is templated. It may run slower than serial execution if the code
@@ -62,6 +66,7 @@
 
 VTK_ABI_NAMESPACE_BEGIN
 class vtkIdList;
+class vtkIdTypeArray;
 struct vtkBucketList;
 class vtkDataArray;
 
@@ -151,6 +156,32 @@ public:
    */
   void FindPointsWithinRadius(double R, const double x[3], vtkIdList* result) override;
 
+  /**
+   * Find the closest N points of each point of the dataset, i.e., the k-nearest
+   * neighbor graph of the points. This is equivalent to calling
+   * FindClosestNPoints() at each point, the point itself being included in its
+   * neighbors, but much faster: the points of a bucket are processed together,
+   * sharing the points gathered around them, and the buckets are processed in
+   * parallel (via vtkSMPTools). The neighbors are returned in compressed sparse
+   * row form: the neighbors of the point beginId+i are
+   * neighbors[offsets[i]] ... neighbors[offsets[i+1]-1], sorted from closest to
+   * farthest, ties being resolved with the smallest point id. Only the points
+   * of ids in [beginId, endId) are processed, endId < 0 meaning all the
+   * points, which lets callers bound the memory used by large point clouds.
+   */
+  void FindClosestNPointsGraph(int N, vtkIdTypeArray* offsets, vtkIdTypeArray* neighbors,
+    vtkIdType beginId = 0, vtkIdType endId = -1);
+
+  /**
+   * Find the points within a radius R of each point of the dataset, i.e., the
+   * radius graph of the points. This is equivalent to calling
+   * FindPointsWithinRadius() at each point, the point itself being included
+   * in its neighbors, and is processed like FindClosestNPointsGraph(). The
+   * neighbors are returned in the same compressed sparse row form.
+   */
+  void FindPointsWithinRadiusGraph(double R, vtkIdTypeArray* offsets, vtkIdTypeArray* neighbors,
+    vtkIdType beginId = 0, vtkIdType endId = -1);
+
   /**
    * Intersect the points contained in the locator with the line defined by
    * (a0,a1). Return the point within the tolerance tol that is closest to a0
@@ -299,6 +330,7 @@ protected:
   ~vtkStaticPointLocator() override;
 
   void BuildLocatorInternal() override;
+  bool RefitLocatorInternal() override;
 
   int NumberOfPointsPerBucket;  // Used with AutomaticOn to control subdivide
   int Divisions[3];             // Number of sub-divisions in x-y-z directions
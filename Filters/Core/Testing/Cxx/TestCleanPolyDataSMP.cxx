@@ -0,0 +1,294 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCleanPolyDataSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the threaded and the serial implementations of vtkCleanPolyData.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCleanPolyData.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Update a serial and a threaded filter, both set up by configure.
+template <typename TFilter, typename TConfigure>
+std::array<vtkSmartPointer<TFilter>, 2> UpdateSerialAndThreaded(TConfigure&& configure)
+{
+  std::array<vtkSmartPointer<TFilter>, 2> filters = { { vtkSmartPointer<TFilter>::New(),
+    vtkSmartPointer<TFilter>::New() } };
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    configure(filter.Get());
+  }
+  filters[1]->EnableSMPOn();
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    filter->Update();
+  }
+  return filters;
+}
+
+bool SameTuples(vtkDataArray* a, vtkIdType aId, vtkDataArray* b, vtkIdType bId)
+{
+  for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+  {
+    if (a->GetComponent(aId, c) != b->GetComponent(bId, c))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+  {
+    if (!SameTuples(a, t, b, t))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compare the cells of two cell arrays, in order.
+bool SameCells(vtkCellArray* a, vtkCellArray* b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> aIds;
+  vtkNew<vtkIdList> bIds;
+  for (vtkIdType c = 0; c < a->GetNumberOfCells(); ++c)
+  {
+    a->GetCellAtId(c, aIds);
+    b->GetCellAtId(c, bIds);
+    if (aIds->GetNumberOfIds() != bIds->GetNumberOfIds() ||
+      !std::equal(aIds->begin(), aIds->end(), bIds->begin()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Named arrays are matched by name, unnamed ones by index.
+bool SameData(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    const char* name = a->GetArrayName(i);
+    vtkDataArray* bArray = name ? b->GetArray(name) : b->GetArray(i);
+    if (!bArray || (!name && b->GetArrayName(i)) || !SameArrays(a->GetArray(i), bArray))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SamePolyData(vtkPolyData* a, vtkPolyData* b)
+{
+  return a->GetNumberOfPoints() == b->GetNumberOfPoints() &&
+    (a->GetNumberOfPoints() == 0 ||
+      SameArrays(a->GetPoints()->GetData(), b->GetPoints()->GetData())) &&
+    SameCells(a->GetVerts(), b->GetVerts()) && SameCells(a->GetLines(), b->GetLines()) &&
+    SameCells(a->GetPolys(), b->GetPolys()) && SameCells(a->GetStrips(), b->GetStrips()) &&
+    SameData(a->GetPointData(), b->GetPointData()) && SameData(a->GetCellData(), b->GetCellData());
+}
+
+std::ostream& ReportDifference(vtkDataSet* expected, vtkDataSet* output)
+{
+  return std::cerr << "Threaded output of " << output->GetNumberOfPoints() << " points and "
+                   << output->GetNumberOfCells() << " cells instead of "
+                   << expected->GetNumberOfPoints() << " and " << expected->GetNumberOfCells()
+                   << " differs";
+}
+
+const int Resolution = 60;
+
+// A triangle soup over a grid, each triangle with its own points, in a
+// shuffled order, with some vertices, lines and strips, and degenerate cells.
+// Points are moved by less than jitter, and have the grid vertex index as
+// global id.
+vtkSmartPointer<vtkPolyData> ConstructSoup(double jitter)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkIdTypeArray> globalIds;
+  globalIds->SetName("GlobalIds");
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  unsigned int seed = 1;
+  auto random = [&seed]() {
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<double>((seed >> 8) & 0xffff) / 65536.0;
+  };
+  auto addPoint = [&](int i, int j) {
+    const vtkIdType id = points->InsertNextPoint(
+      i + jitter * random(), j + jitter * random(), jitter * random());
+    globalIds->InsertNextValue(j * (Resolution + 1) + i);
+    pointScalars->InsertNextValue(id);
+    return id;
+  };
+
+  std::vector<std::vector<vtkIdType>> triangles;
+  for (int j = 0; j < Resolution; ++j)
+  {
+    for (int i = 0; i < Resolution; ++i)
+    {
+      triangles.push_back({ addPoint(i, j), addPoint(i + 1, j), addPoint(i + 1, j + 1) });
+      triangles.push_back({ addPoint(i, j), addPoint(i + 1, j + 1), addPoint(i, j + 1) });
+    }
+  }
+  for (size_t t = triangles.size() - 1; t > 0; --t)
+  {
+    std::swap(triangles[t], triangles[static_cast<size_t>(random() * (t + 1))]);
+  }
+
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  for (size_t t = 0; t < triangles.size(); ++t)
+  {
+    const std::vector<vtkIdType>& tri = triangles[t];
+    switch (t % 16)
+    {
+      case 0:
+        verts->InsertNextCell({ tri[0], tri[1], tri[0] });
+        break;
+      case 1:
+        lines->InsertNextCell({ tri[0], tri[1], tri[2], tri[0] });
+        break;
+      case 2:
+        lines->InsertNextCell({ tri[1], tri[1] });
+        break;
+      case 3:
+        polys->InsertNextCell({ tri[0], tri[1], tri[1] });
+        break;
+      case 4:
+        polys->InsertNextCell({ tri[2], tri[2], tri[2], tri[2] });
+        break;
+      case 5:
+        strips->InsertNextCell({ tri[0], tri[1], tri[2], tri[2] });
+        break;
+      case 6:
+        strips->InsertNextCell({ tri[0], tri[0], tri[1], tri[1] });
+        break;
+      default:
+        polys->InsertNextCell({ tri[0], tri[1], tri[2] });
+    }
+  }
+
+  vtkSmartPointer<vtkPolyData> polyData = vtkSmartPointer<vtkPolyData>::New();
+  polyData->SetPoints(points);
+  polyData->SetVerts(verts);
+  polyData->SetLines(lines);
+  polyData->SetPolys(polys);
+  polyData->SetStrips(strips);
+  polyData->GetPointData()->AddArray(pointScalars);
+  polyData->GetPointData()->AddArray(globalIds);
+
+  // The cell data records the input cell id.
+  vtkNew<vtkIntArray> cellScalars;
+  cellScalars->SetName("CellScalars");
+  for (vtkIdType c = 0; c < polyData->GetNumberOfCells(); ++c)
+  {
+    cellScalars->InsertNextValue(static_cast<int>(c));
+  }
+  polyData->GetCellData()->AddArray(cellScalars);
+  return polyData;
+}
+
+bool TestConfiguration(
+  vtkPolyData* input, bool merging, bool convert, bool globalIds, double tolerance)
+{
+  input->GetPointData()->SetGlobalIds(
+    globalIds ? input->GetPointData()->GetArray("GlobalIds") : nullptr);
+
+  auto filters = UpdateSerialAndThreaded<vtkCleanPolyData>([&](vtkCleanPolyData* clean) {
+    clean->SetInputData(input);
+    clean->SetPointMerging(merging);
+    clean->SetConvertLinesToPoints(convert);
+    clean->SetConvertPolysToLines(convert);
+    clean->SetConvertStripsToPolys(convert);
+    clean->ToleranceIsAbsoluteOn();
+    clean->SetAbsoluteTolerance(tolerance);
+  });
+  vtkPolyData* expected = filters[0]->GetOutput();
+  vtkPolyData* output = filters[1]->GetOutput();
+
+  const bool same = SamePolyData(expected, output);
+  if (!same)
+  {
+    ReportDifference(expected, output)
+      << " with merging " << merging << ", conversion " << convert << ", global ids "
+      << globalIds << " and tolerance " << tolerance << std::endl;
+  }
+  return same;
+}
+}
+
+int TestCleanPolyDataSMP(int, char*[])
+{
+  bool success = true;
+
+  // Exact duplicates.
+  vtkSmartPointer<vtkPolyData> soup = ConstructSoup(0.0);
+  for (bool merging : { true, false })
+  {
+    for (bool convert : { true, false })
+    {
+      for (bool globalIds : { false, true })
+      {
+        success &= TestConfiguration(soup, merging, convert, globalIds, 0.0);
+      }
+    }
+  }
+
+  // Well separated clusters of points, merged the same way by both.
+  vtkSmartPointer<vtkPolyData> jittered = ConstructSoup(1.0e-3);
+  success &= TestConfiguration(jittered, true, true, false, 1.0e-2);
+  success &= TestConfiguration(jittered, true, false, false, 1.0e-2);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
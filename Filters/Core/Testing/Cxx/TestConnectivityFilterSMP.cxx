@@ -0,0 +1,456 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectivityFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the threaded and the serial implementations of
+// vtkConnectivityFilter and vtkPolyDataConnectivityFilter. The output points
+// may be in another order, compare the cells through their points.
+
+#include <vtkAppendPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellType.h>
+#include <vtkConnectivityFilter.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataConnectivityFilter.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <array>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+const int Resolution = 24;
+
+// Update a serial and a threaded filter, both set up by configure.
+template <typename TFilter, typename TConfigure>
+std::array<vtkSmartPointer<TFilter>, 2> UpdateSerialAndThreaded(TConfigure&& configure)
+{
+  std::array<vtkSmartPointer<TFilter>, 2> filters = { { vtkSmartPointer<TFilter>::New(),
+    vtkSmartPointer<TFilter>::New() } };
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    configure(filter.Get());
+  }
+  filters[1]->EnableSMPOn();
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    filter->Update();
+  }
+  return filters;
+}
+
+bool SameTuples(vtkDataArray* a, vtkIdType aId, vtkDataArray* b, vtkIdType bId)
+{
+  for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+  {
+    if (a->GetComponent(aId, c) != b->GetComponent(bId, c))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+  {
+    if (!SameTuples(a, t, b, t))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Named arrays are matched by name, unnamed ones by index.
+bool SameData(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    const char* name = a->GetArrayName(i);
+    vtkDataArray* bArray = name ? b->GetArray(name) : b->GetArray(i);
+    if (!bArray || (!name && b->GetArrayName(i)) || !SameArrays(a->GetArray(i), bArray))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Points of a grid of Resolution^3 cubes, numbered along x first.
+vtkIdType GetGridPointId(int i, int j, int k)
+{
+  return (static_cast<vtkIdType>(k) * (Resolution + 1) + j) * (Resolution + 1) + i;
+}
+
+void InsertGridPoints(vtkPoints* points, double spacing)
+{
+  for (int k = 0; k <= Resolution; ++k)
+  {
+    for (int j = 0; j <= Resolution; ++j)
+    {
+      for (int i = 0; i <= Resolution; ++i)
+      {
+        points->InsertNextPoint(i * spacing, j * spacing, k * spacing);
+      }
+    }
+  }
+}
+
+// The points of cube (i, j, k), in the order of the points of a hexahedron.
+void GetCubePointIds(int i, int j, int k, vtkIdType p[8])
+{
+  p[0] = GetGridPointId(i, j, k);
+  p[1] = GetGridPointId(i + 1, j, k);
+  p[2] = GetGridPointId(i + 1, j + 1, k);
+  p[3] = GetGridPointId(i, j + 1, k);
+  p[4] = GetGridPointId(i, j, k + 1);
+  p[5] = GetGridPointId(i + 1, j, k + 1);
+  p[6] = GetGridPointId(i + 1, j + 1, k + 1);
+  p[7] = GetGridPointId(i, j + 1, k + 1);
+}
+
+// Insert the cube of points p as a hexahedron, five tetrahedra or two wedges.
+void InsertCube(vtkUnstructuredGrid* grid, const vtkIdType p[8], int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+    {
+      const vtkIdType tetras[5][4] = { { p[0], p[1], p[3], p[4] }, { p[1], p[2], p[3], p[6] },
+        { p[1], p[4], p[5], p[6] }, { p[3], p[4], p[6], p[7] }, { p[1], p[3], p[4], p[6] } };
+      for (const vtkIdType* tetra : tetras)
+      {
+        grid->InsertNextCell(VTK_TETRA, 4, tetra);
+      }
+      break;
+    }
+    case VTK_WEDGE:
+    {
+      const vtkIdType wedges[2][6] = { { p[0], p[1], p[3], p[4], p[5], p[7] },
+        { p[1], p[2], p[3], p[5], p[6], p[7] } };
+      for (const vtkIdType* wedge : wedges)
+      {
+        grid->InsertNextCell(VTK_WEDGE, 6, wedge);
+      }
+      break;
+    }
+    default:
+      grid->InsertNextCell(VTK_HEXAHEDRON, 8, p);
+  }
+}
+
+// The "CellIds" array matches the output cells with their input cell.
+void AddCellIds(vtkDataSet* dataSet)
+{
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < dataSet->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(static_cast<int>(cellId));
+  }
+  dataSet->GetCellData()->AddArray(cellIds);
+}
+
+std::ostream& ReportDifference(vtkDataSet* expected, vtkDataSet* output)
+{
+  return std::cerr << "Threaded output of " << output->GetNumberOfPoints() << " points and "
+                   << output->GetNumberOfCells() << " cells instead of "
+                   << expected->GetNumberOfPoints() << " and " << expected->GetNumberOfCells()
+                   << " differs";
+}
+
+double Scalar(const double x[3])
+{
+  return std::sin(0.7 * x[0]) * std::cos(0.5 * x[1]) + 0.1 * x[2];
+}
+
+void AddData(vtkDataSet* dataSet)
+{
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  for (vtkIdType ptId = 0; ptId < dataSet->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    dataSet->GetPoint(ptId, x);
+    pointScalars->InsertNextValue(Scalar(x));
+  }
+  dataSet->GetPointData()->SetScalars(pointScalars);
+  AddCellIds(dataSet);
+}
+
+// A grid of hexahedra, tetrahedra and wedges, fractured by removing some of
+// the cells, with lines and vertices.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid()
+{
+  vtkNew<vtkPoints> points;
+  InsertGridPoints(points, 1.0);
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->Allocate();
+  const int cellTypes[3] = { VTK_HEXAHEDRON, VTK_TETRA, VTK_WEDGE };
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        if (i % 5 == 2 || j % 7 == 3 || (i * 7 + j * 13 + k * 17) % 11 < 3)
+        {
+          continue;
+        }
+        vtkIdType p[8];
+        GetCubePointIds(i, j, k, p);
+        InsertCube(grid, p, cellTypes[(i + j + k) % 3]);
+        if (k == Resolution - 1 && i % 5 == 0)
+        {
+          grid->InsertNextCell(VTK_LINE, 2, p + 4);
+        }
+        if (k == 0 && j % 4 == 0)
+        {
+          grid->InsertNextCell(VTK_VERTEX, 1, p);
+        }
+      }
+    }
+  }
+  AddData(grid);
+  return grid;
+}
+
+vtkSmartPointer<vtkImageData> ConstructImage()
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(Resolution, Resolution, Resolution / 2);
+  image->SetSpacing(0.5, 0.5, 0.5);
+  AddData(image);
+  return image;
+}
+
+// Spheres of several resolutions, some overlapping, with a fan of lines.
+vtkSmartPointer<vtkPolyData> ConstructSurface()
+{
+  vtkNew<vtkAppendPolyData> append;
+  for (int i = 0; i < 12; ++i)
+  {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetCenter(3.0 * (i % 4), 3.0 * (i / 4), i % 3 == 0 ? 0.0 : 1.0);
+    sphere->SetRadius(1.0 + 0.4 * (i % 3));
+    sphere->SetThetaResolution(24 + 4 * i);
+    sphere->SetPhiResolution(16 + 2 * i);
+    append->AddInputConnection(sphere->GetOutputPort());
+  }
+  append->Update();
+  vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+  surface->DeepCopy(append->GetOutput());
+  surface->GetPointData()->Initialize();
+
+  vtkNew<vtkCellArray> lines;
+  for (vtkIdType ptId = 0; ptId + 40 < surface->GetNumberOfPoints(); ptId += 97)
+  {
+    const vtkIdType line[2] = { ptId, ptId + 40 };
+    lines->InsertNextCell(2, line);
+  }
+  surface->SetLines(lines);
+  AddData(surface);
+  return surface;
+}
+
+// The same cells with the same points and point data, the points may be
+// numbered differently.
+bool SameOutput(vtkPointSet* a, vtkPointSet* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+    a->GetNumberOfCells() != b->GetNumberOfCells() ||
+    a->GetPointData()->GetNumberOfArrays() != b->GetPointData()->GetNumberOfArrays() ||
+    !SameData(a->GetCellData(), b->GetCellData()))
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> aIds;
+  vtkNew<vtkIdList> bIds;
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+  {
+    a->GetCellPoints(cellId, aIds);
+    b->GetCellPoints(cellId, bIds);
+    if (a->GetCellType(cellId) != b->GetCellType(cellId) ||
+      aIds->GetNumberOfIds() != bIds->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < aIds->GetNumberOfIds(); ++i)
+    {
+      if (!SameTuples(a->GetPoints()->GetData(), aIds->GetId(i), b->GetPoints()->GetData(),
+            bIds->GetId(i)))
+      {
+        return false;
+      }
+      for (int j = 0; j < a->GetPointData()->GetNumberOfArrays(); ++j)
+      {
+        vtkDataArray* aArray = a->GetPointData()->GetArray(j);
+        vtkDataArray* bArray = b->GetPointData()->GetArray(aArray->GetName());
+        if (!bArray || !SameTuples(aArray, aIds->GetId(i), bArray, bIds->GetId(i)))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+const int ExtractionModes[] = { VTK_EXTRACT_LARGEST_REGION, VTK_EXTRACT_ALL_REGIONS,
+  VTK_EXTRACT_SPECIFIED_REGIONS, VTK_EXTRACT_POINT_SEEDED_REGIONS, VTK_EXTRACT_CELL_SEEDED_REGIONS,
+  VTK_EXTRACT_CLOSEST_POINT_REGION };
+
+template <typename TFilter>
+void Configure(TFilter* filter, vtkDataSet* input, int mode, bool scalarConnectivity)
+{
+  filter->SetInputData(input);
+  filter->SetExtractionMode(mode);
+  filter->SetScalarConnectivity(scalarConnectivity);
+  filter->SetScalarRange(-0.3, 0.5);
+  filter->ColorRegionsOn();
+  filter->AddSpecifiedRegion(0);
+  filter->AddSpecifiedRegion(3);
+  filter->AddSeed(mode == VTK_EXTRACT_POINT_SEEDED_REGIONS ? 250 : 120);
+  filter->AddSeed(mode == VTK_EXTRACT_POINT_SEEDED_REGIONS ? 4000 : 2500);
+  filter->SetClosestPoint(7.3, 4.1, 1.2);
+}
+
+bool TestConnectivityFilter(vtkDataSet* input, const char* name)
+{
+  bool success = true;
+  for (int mode : ExtractionModes)
+  {
+    for (bool scalarConnectivity : { false, true })
+    {
+      for (int assignment :
+        { vtkConnectivityFilter::UNSPECIFIED, vtkConnectivityFilter::CELL_COUNT_DESCENDING })
+      {
+        auto filters = UpdateSerialAndThreaded<vtkConnectivityFilter>(
+          [&](vtkConnectivityFilter* filter) {
+            Configure(filter, input, mode, scalarConnectivity);
+            filter->SetRegionIdAssignmentMode(assignment);
+            // The cell region ids are not initialized for the cells that are
+            // not in the seeded regions.
+            filter->SetColorRegions(mode == VTK_EXTRACT_LARGEST_REGION ||
+              mode == VTK_EXTRACT_ALL_REGIONS || mode == VTK_EXTRACT_SPECIFIED_REGIONS);
+          });
+        vtkConnectivityFilter* serial = filters[0];
+        vtkConnectivityFilter* threaded = filters[1];
+        vtkPointSet* expected = vtkPointSet::SafeDownCast(serial->GetOutput());
+        vtkPointSet* output = vtkPointSet::SafeDownCast(threaded->GetOutput());
+
+        if (expected->GetNumberOfCells() == 0 ||
+          serial->GetNumberOfExtractedRegions() != threaded->GetNumberOfExtractedRegions() ||
+          !SameOutput(expected, output))
+        {
+          ReportDifference(expected, output)
+            << " for the " << name << " with mode " << mode << ", scalar connectivity "
+            << scalarConnectivity << " and assignment " << assignment << ": "
+            << threaded->GetNumberOfExtractedRegions() << " regions instead of "
+            << serial->GetNumberOfExtractedRegions() << std::endl;
+          success = false;
+        }
+      }
+    }
+  }
+  return success;
+}
+
+bool TestPolyDataConnectivityFilter(vtkPolyData* input)
+{
+  bool success = true;
+  for (int mode : ExtractionModes)
+  {
+    for (int scalarConnectivity : { 0, 1, 2 })
+    {
+      auto filters = UpdateSerialAndThreaded<vtkPolyDataConnectivityFilter>(
+        [&](vtkPolyDataConnectivityFilter* filter) {
+          Configure(filter, input, mode, scalarConnectivity > 0);
+          filter->SetFullScalarConnectivity(scalarConnectivity == 2);
+          filter->MarkVisitedPointIdsOn();
+        });
+      vtkPolyDataConnectivityFilter* serial = filters[0];
+      vtkPolyDataConnectivityFilter* threaded = filters[1];
+      vtkPolyData* expected = serial->GetOutput();
+      vtkPolyData* output = threaded->GetOutput();
+
+      vtkIdList* expectedIds = serial->GetVisitedPointIds();
+      vtkIdList* visitedIds = threaded->GetVisitedPointIds();
+      bool same = expected->GetNumberOfCells() > 0 &&
+        serial->GetNumberOfExtractedRegions() == threaded->GetNumberOfExtractedRegions() &&
+        SameOutput(expected, output) &&
+        expectedIds->GetNumberOfIds() == visitedIds->GetNumberOfIds();
+      for (vtkIdType i = 0; same && i < expectedIds->GetNumberOfIds(); ++i)
+      {
+        same = expectedIds->GetId(i) == visitedIds->GetId(i);
+      }
+      for (vtkIdType i = 0; same && i < serial->GetNumberOfExtractedRegions(); ++i)
+      {
+        same =
+          serial->GetRegionSizes()->GetValue(i) == threaded->GetRegionSizes()->GetValue(i);
+      }
+      if (!same)
+      {
+        ReportDifference(expected, output)
+          << " for the surface with mode " << mode << " and scalar connectivity "
+          << scalarConnectivity << ": " << threaded->GetNumberOfExtractedRegions()
+          << " regions instead of " << serial->GetNumberOfExtractedRegions() << std::endl;
+        success = false;
+      }
+    }
+  }
+  return success;
+}
+}
+
+int TestConnectivityFilterSMP(int, char*[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = ConstructGrid();
+  vtkSmartPointer<vtkImageData> image = ConstructImage();
+  vtkSmartPointer<vtkPolyData> surface = ConstructSurface();
+  bool success = true;
+
+  success &= TestConnectivityFilter(grid, "grid");
+  success &= TestConnectivityFilter(image, "image");
+  success &= TestConnectivityFilter(surface, "surface");
+  success &= TestPolyDataConnectivityFilter(surface);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,375 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCutterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the threaded and the serial implementations of vtkCutter.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellType.h>
+#include <vtkCutter.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkIdList.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkNonMergingPointLocator.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphere.h>
+#include <vtkSphereSource.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+namespace
+{
+const int Resolution = 24;
+
+// Update a serial and a threaded filter, both set up by configure.
+template <typename TFilter, typename TConfigure>
+std::array<vtkSmartPointer<TFilter>, 2> UpdateSerialAndThreaded(TConfigure&& configure)
+{
+  std::array<vtkSmartPointer<TFilter>, 2> filters = { { vtkSmartPointer<TFilter>::New(),
+    vtkSmartPointer<TFilter>::New() } };
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    configure(filter.Get());
+  }
+  filters[1]->EnableSMPOn();
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    filter->Update();
+  }
+  return filters;
+}
+
+bool SameTuples(vtkDataArray* a, vtkIdType aId, vtkDataArray* b, vtkIdType bId)
+{
+  for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+  {
+    if (a->GetComponent(aId, c) != b->GetComponent(bId, c))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+  {
+    if (!SameTuples(a, t, b, t))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compare the cells of two cell arrays, in order. With rotate, the point
+// ids of a cell may also start at another of its points.
+bool SameCells(vtkCellArray* a, vtkCellArray* b, bool rotate = false)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> aIds;
+  vtkNew<vtkIdList> bIds;
+  for (vtkIdType c = 0; c < a->GetNumberOfCells(); ++c)
+  {
+    a->GetCellAtId(c, aIds);
+    b->GetCellAtId(c, bIds);
+    if (aIds->GetNumberOfIds() != bIds->GetNumberOfIds())
+    {
+      return false;
+    }
+    if (rotate)
+    {
+      std::rotate(aIds->begin(), std::min_element(aIds->begin(), aIds->end()), aIds->end());
+      std::rotate(bIds->begin(), std::min_element(bIds->begin(), bIds->end()), bIds->end());
+    }
+    if (!std::equal(aIds->begin(), aIds->end(), bIds->begin()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Named arrays are matched by name, unnamed ones by index.
+bool SameData(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    const char* name = a->GetArrayName(i);
+    vtkDataArray* bArray = name ? b->GetArray(name) : b->GetArray(i);
+    if (!bArray || (!name && b->GetArrayName(i)) || !SameArrays(a->GetArray(i), bArray))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// With rotatePolys, the polygons are compared up to a rotation of their
+// points.
+bool SamePolyData(vtkPolyData* a, vtkPolyData* b, bool rotatePolys)
+{
+  return a->GetNumberOfPoints() == b->GetNumberOfPoints() &&
+    (a->GetNumberOfPoints() == 0 ||
+      SameArrays(a->GetPoints()->GetData(), b->GetPoints()->GetData())) &&
+    SameCells(a->GetVerts(), b->GetVerts()) && SameCells(a->GetLines(), b->GetLines()) &&
+    SameCells(a->GetPolys(), b->GetPolys(), rotatePolys) &&
+    SameCells(a->GetStrips(), b->GetStrips()) && SameData(a->GetPointData(), b->GetPointData()) &&
+    SameData(a->GetCellData(), b->GetCellData());
+}
+
+// Points of a grid of Resolution^3 cubes, numbered along x first.
+vtkIdType GetGridPointId(int i, int j, int k)
+{
+  return (static_cast<vtkIdType>(k) * (Resolution + 1) + j) * (Resolution + 1) + i;
+}
+
+void InsertGridPoints(vtkPoints* points, double spacing)
+{
+  for (int k = 0; k <= Resolution; ++k)
+  {
+    for (int j = 0; j <= Resolution; ++j)
+    {
+      for (int i = 0; i <= Resolution; ++i)
+      {
+        points->InsertNextPoint(i * spacing, j * spacing, k * spacing);
+      }
+    }
+  }
+}
+
+// The points of cube (i, j, k), in the order of the points of a hexahedron.
+void GetCubePointIds(int i, int j, int k, vtkIdType p[8])
+{
+  p[0] = GetGridPointId(i, j, k);
+  p[1] = GetGridPointId(i + 1, j, k);
+  p[2] = GetGridPointId(i + 1, j + 1, k);
+  p[3] = GetGridPointId(i, j + 1, k);
+  p[4] = GetGridPointId(i, j, k + 1);
+  p[5] = GetGridPointId(i + 1, j, k + 1);
+  p[6] = GetGridPointId(i + 1, j + 1, k + 1);
+  p[7] = GetGridPointId(i, j + 1, k + 1);
+}
+
+// Insert the cube of points p as a hexahedron, five tetrahedra or two wedges.
+void InsertCube(vtkUnstructuredGrid* grid, const vtkIdType p[8], int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+    {
+      const vtkIdType tetras[5][4] = { { p[0], p[1], p[3], p[4] }, { p[1], p[2], p[3], p[6] },
+        { p[1], p[4], p[5], p[6] }, { p[3], p[4], p[6], p[7] }, { p[1], p[3], p[4], p[6] } };
+      for (const vtkIdType* tetra : tetras)
+      {
+        grid->InsertNextCell(VTK_TETRA, 4, tetra);
+      }
+      break;
+    }
+    case VTK_WEDGE:
+    {
+      const vtkIdType wedges[2][6] = { { p[0], p[1], p[3], p[4], p[5], p[7] },
+        { p[1], p[2], p[3], p[5], p[6], p[7] } };
+      for (const vtkIdType* wedge : wedges)
+      {
+        grid->InsertNextCell(VTK_WEDGE, 6, wedge);
+      }
+      break;
+    }
+    default:
+      grid->InsertNextCell(VTK_HEXAHEDRON, 8, p);
+  }
+}
+
+// The "CellIds" array matches the output cells with their input cell.
+void AddCellIds(vtkDataSet* dataSet)
+{
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < dataSet->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(static_cast<int>(cellId));
+  }
+  dataSet->GetCellData()->AddArray(cellIds);
+}
+
+void AddPointScalars(vtkDataSet* dataSet)
+{
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  for (vtkIdType ptId = 0; ptId < dataSet->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    dataSet->GetPoint(ptId, x);
+    pointScalars->InsertNextValue(x[0] + 2.0 * x[1] + 3.0 * x[2]);
+  }
+  dataSet->GetPointData()->SetScalars(pointScalars);
+}
+
+std::ostream& ReportDifference(vtkDataSet* expected, vtkDataSet* output)
+{
+  return std::cerr << "Threaded output of " << output->GetNumberOfPoints() << " points and "
+                   << output->GetNumberOfCells() << " cells instead of "
+                   << expected->GetNumberOfPoints() << " and " << expected->GetNumberOfCells()
+                   << " differs";
+}
+
+// A grid of hexahedra, tetrahedra and wedges, with quadrilaterals on a face
+// and lines along some edges, carrying point and cell data.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid()
+{
+  vtkNew<vtkPoints> points;
+  InsertGridPoints(points, 1.0 / Resolution);
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->Allocate();
+  const int cellTypes[3] = { VTK_HEXAHEDRON, VTK_TETRA, VTK_WEDGE };
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        vtkIdType p[8];
+        GetCubePointIds(i, j, k, p);
+        InsertCube(grid, p, cellTypes[(i + j + k) % 3]);
+        if (k == 0)
+        {
+          grid->InsertNextCell(VTK_QUAD, 4, p);
+        }
+        if (k == 0 && j == 0)
+        {
+          grid->InsertNextCell(VTK_LINE, 2, p);
+        }
+      }
+    }
+  }
+  AddPointScalars(grid);
+  AddCellIds(grid);
+  return grid;
+}
+
+// A sphere of polygons, with the edges of some of them as polylines.
+vtkSmartPointer<vtkPolyData> ConstructSurface()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetCenter(0.5, 0.5, 0.5);
+  sphere->SetRadius(0.5);
+  sphere->SetThetaResolution(120);
+  sphere->SetPhiResolution(120);
+  sphere->Update();
+  vtkPolyData* polys = sphere->GetOutput();
+
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < polys->GetNumberOfCells(); cellId += 5)
+  {
+    polys->GetCellPoints(cellId, ptIds);
+    ptIds->InsertNextId(ptIds->GetId(0));
+    lines->InsertNextCell(ptIds);
+  }
+
+  vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+  surface->SetPoints(polys->GetPoints());
+  surface->GetPointData()->ShallowCopy(polys->GetPointData());
+  surface->SetLines(lines);
+  surface->SetPolys(polys->GetPolys());
+  AddCellIds(surface);
+  return surface;
+}
+
+bool TestConfiguration(vtkDataSet* input, const char* name, bool generateCutScalars,
+  bool generateTriangles, bool merging)
+{
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(0.37, 0.41, 0.43);
+  sphere->SetRadius(0.0);
+
+  auto filters = UpdateSerialAndThreaded<vtkCutter>([&](vtkCutter* cutter) {
+    cutter->SetInputData(input);
+    cutter->SetCutFunction(sphere);
+    cutter->SetNumberOfContours(3);
+    cutter->SetValue(0, 0.04);
+    cutter->SetValue(1, 0.16);
+    cutter->SetValue(2, 0.25);
+    cutter->SetGenerateCutScalars(generateCutScalars);
+    cutter->SetGenerateTriangles(generateTriangles);
+    if (!merging)
+    {
+      vtkNew<vtkNonMergingPointLocator> locator;
+      cutter->SetLocator(locator);
+    }
+  });
+  vtkPolyData* expected = filters[0]->GetOutput();
+  vtkPolyData* output = filters[1]->GetOutput();
+
+  // Without triangles, the polygons cut from 3D cells may start at another
+  // of their points.
+  const bool same =
+    expected->GetNumberOfPoints() > 0 && SamePolyData(expected, output, !generateTriangles);
+  if (!same)
+  {
+    ReportDifference(expected, output)
+      << " for the " << name << " with cut scalars " << generateCutScalars << ", triangles "
+      << generateTriangles << " and merging " << merging << std::endl;
+  }
+  return same;
+}
+}
+
+int TestCutterSMP(int, char*[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = ConstructGrid();
+  vtkSmartPointer<vtkPolyData> surface = ConstructSurface();
+  bool success = true;
+
+  for (bool generateCutScalars : { false, true })
+  {
+    for (bool generateTriangles : { true, false })
+    {
+      for (bool merging : { true, false })
+      {
+        success &=
+          TestConfiguration(grid, "grid", generateCutScalars, generateTriangles, merging);
+        success &=
+          TestConfiguration(surface, "surface", generateCutScalars, generateTriangles, merging);
+      }
+    }
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,205 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDecimateProSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the threaded and the serial implementations of vtkDecimatePro.
+
+#include <vtkCellArray.h>
+#include <vtkCellArrayIterator.h>
+#include <vtkDecimatePro.h>
+#include <vtkIdTypeArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// The output must only hold valid triangles using all the points, which are
+// input points carrying their point data. With preserved topology, the
+// sphere stays closed: every edge is used by two triangles.
+bool IsValid(vtkPolyData* input, vtkPolyData* output, bool closed)
+{
+  vtkIdTypeArray* ids =
+    vtkArrayDownCast<vtkIdTypeArray>(output->GetPointData()->GetArray("InputIds"));
+  if (!ids || ids->GetNumberOfValues() != output->GetNumberOfPoints() ||
+    output->GetPointData()->GetNumberOfArrays() != 1)
+  {
+    std::cerr << "Invalid point data" << std::endl;
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], y[3];
+    output->GetPoint(ptId, x);
+    input->GetPoint(ids->GetValue(ptId), y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      std::cerr << "Point " << ptId << " does not match its point data" << std::endl;
+      return false;
+    }
+  }
+
+  std::vector<bool> used(output->GetNumberOfPoints(), false);
+  std::map<std::pair<vtkIdType, vtkIdType>, int> edges;
+  auto iter = vtk::TakeSmartPointer(output->GetPolys()->NewIterator());
+  for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
+  {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    iter->GetCurrentCell(npts, pts);
+    if (npts != 3 || pts[0] == pts[1] || pts[1] == pts[2] || pts[2] == pts[0])
+    {
+      std::cerr << "Invalid triangle " << iter->GetCurrentCellId() << std::endl;
+      return false;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      used[pts[i]] = true;
+      const vtkIdType next = pts[(i + 1) % 3];
+      edges[std::make_pair(std::min(pts[i], next), std::max(pts[i], next))]++;
+    }
+  }
+  if (std::find(used.begin(), used.end(), false) != used.end())
+  {
+    std::cerr << "Unused output points" << std::endl;
+    return false;
+  }
+  if (closed)
+  {
+    for (const auto& edge : edges)
+    {
+      if (edge.second != 2)
+      {
+        std::cerr << "Edge used by " << edge.second << " triangles" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The threaded output and inflection points must not depend on the number
+// of threads.
+bool IsIndependentOfThreads(vtkDecimatePro* threaded, vtkDecimatePro* oneThread)
+{
+  vtkPolyData* output = threaded->GetOutput();
+  vtkPolyData* oneThreadOutput = oneThread->GetOutput();
+  if (output->GetNumberOfPoints() != oneThreadOutput->GetNumberOfPoints() ||
+    output->GetNumberOfPolys() != oneThreadOutput->GetNumberOfPolys())
+  {
+    std::cerr << "Output size depends on the number of threads" << std::endl;
+    return false;
+  }
+  vtkDataArray* connectivity = output->GetPolys()->GetConnectivityArray();
+  vtkDataArray* oneThreadConnectivity = oneThreadOutput->GetPolys()->GetConnectivityArray();
+  for (vtkIdType i = 0; i < connectivity->GetNumberOfValues(); ++i)
+  {
+    if (connectivity->GetTuple1(i) != oneThreadConnectivity->GetTuple1(i))
+    {
+      std::cerr << "Triangles depend on the number of threads" << std::endl;
+      return false;
+    }
+  }
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], y[3];
+    output->GetPoint(ptId, x);
+    oneThreadOutput->GetPoint(ptId, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      std::cerr << "Points depend on the number of threads" << std::endl;
+      return false;
+    }
+  }
+
+  const vtkIdType numInflections = threaded->GetNumberOfInflectionPoints();
+  if (numInflections == 0 || numInflections != oneThread->GetNumberOfInflectionPoints() ||
+    !std::equal(threaded->GetInflectionPoints(), threaded->GetInflectionPoints() + numInflections,
+      oneThread->GetInflectionPoints()))
+  {
+    std::cerr << "Inflection points missing or depending on the number of threads" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestDecimation(vtkPolyData* input, bool preserveTopology)
+{
+  vtkNew<vtkDecimatePro> serial;
+  vtkNew<vtkDecimatePro> threaded;
+  vtkNew<vtkDecimatePro> oneThread;
+  for (vtkDecimatePro* decimate : { serial.Get(), threaded.Get(), oneThread.Get() })
+  {
+    decimate->SetInputData(input);
+    decimate->SetTargetReduction(0.9);
+    decimate->SetPreserveTopology(preserveTopology);
+  }
+  threaded->EnableSMPOn();
+  oneThread->EnableSMPOn();
+  serial->Update();
+  threaded->Update();
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 1 }, [&]() { oneThread->Update(); });
+
+  vtkPolyData* serialOutput = serial->GetOutput();
+  vtkPolyData* threadedOutput = threaded->GetOutput();
+  if (!IsValid(input, threadedOutput, preserveTopology) ||
+    !IsIndependentOfThreads(threaded, oneThread))
+  {
+    return false;
+  }
+  // Both reach the target reduction, or stop around the same number of
+  // triangles when preserving the topology.
+  const vtkIdType target = input->GetNumberOfPolys() / 10 + 2;
+  if (threadedOutput->GetNumberOfPolys() > std::max(target, serialOutput->GetNumberOfPolys()))
+  {
+    std::cerr << "Target reduction not achieved with preserve topology " << preserveTopology
+              << ": " << input->GetNumberOfPolys() << " triangles reduced to "
+              << serialOutput->GetNumberOfPolys() << " (serial) and "
+              << threadedOutput->GetNumberOfPolys() << " (threaded)" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestDecimateProSMP(int, char*[])
+{
+  // Enough triangles to be partitioned.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(100);
+  sphere->SetPhiResolution(100);
+  sphere->Update();
+  vtkPolyData* input = sphere->GetOutput();
+
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("InputIds");
+  ids->SetNumberOfValues(input->GetNumberOfPoints());
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    ids->SetValue(ptId, ptId);
+  }
+  input->GetPointData()->Initialize();
+  input->GetPointData()->AddArray(ids);
+
+  return TestDecimation(input, false) && TestDecimation(input, true) ? EXIT_SUCCESS
+                                                                      : EXIT_FAILURE;
+}
@@ -0,0 +1,164 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDelaunay2DSpatialInsertion.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the triangulations of vtkDelaunay2D with the points inserted in
+// input order and in spatial order.
+
+#include <vtkCellArray.h>
+#include <vtkDelaunay2D.h>
+#include <vtkIdList.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTransform.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+// The cells as their type followed by their sorted point ids, sorted, to
+// compare cells output in another order.
+std::vector<std::vector<vtkIdType>> GetSortedCells(vtkDataSet* dataSet)
+{
+  std::vector<std::vector<vtkIdType>> cells(dataSet->GetNumberOfCells());
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < dataSet->GetNumberOfCells(); ++cellId)
+  {
+    dataSet->GetCellPoints(cellId, ptIds);
+    std::vector<vtkIdType>& cell = cells[cellId];
+    cell.assign(ptIds->begin(), ptIds->end());
+    std::sort(cell.begin(), cell.end());
+    cell.insert(cell.begin(), dataSet->GetCellType(cellId));
+  }
+  std::sort(cells.begin(), cells.end());
+  return cells;
+}
+
+const int Resolution = 60;
+
+// A jittered lattice of points in general position, a terrain in scan line
+// order, with a few duplicates.
+vtkSmartPointer<vtkPolyData> ConstructPoints()
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(4321);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int j = 0; j < Resolution; ++j)
+  {
+    for (int i = 0; i < Resolution; ++i)
+    {
+      const double x = i + random->GetRangeValue(-0.4, 0.4);
+      random->Next();
+      const double y = j + random->GetRangeValue(-0.4, 0.4);
+      random->Next();
+      points->InsertNextPoint(x, y, std::sin(0.2 * x) * std::cos(0.3 * y));
+    }
+  }
+  for (vtkIdType ptId = 7; ptId < points->GetNumberOfPoints(); ptId += 301)
+  {
+    points->InsertNextPoint(points->GetPoint(ptId));
+  }
+
+  vtkSmartPointer<vtkPolyData> cloud = vtkSmartPointer<vtkPolyData>::New();
+  cloud->SetPoints(points);
+  return cloud;
+}
+
+// A square hole, ordered clockwise, through points of the lattice.
+vtkSmartPointer<vtkPolyData> ConstructHole(vtkPolyData* cloud)
+{
+  vtkNew<vtkIdList> loop;
+  const int first = 20;
+  const int last = 40;
+  for (int i = first; i < last; ++i)
+  {
+    loop->InsertNextId(first * Resolution + i);
+  }
+  for (int j = first; j < last; ++j)
+  {
+    loop->InsertNextId(j * Resolution + last);
+  }
+  for (int i = last; i > first; --i)
+  {
+    loop->InsertNextId(last * Resolution + i);
+  }
+  for (int j = last; j > first; --j)
+  {
+    loop->InsertNextId(j * Resolution + first);
+  }
+  std::reverse(loop->begin(), loop->end());
+  vtkNew<vtkCellArray> polys;
+  polys->InsertNextCell(loop);
+
+  vtkSmartPointer<vtkPolyData> hole = vtkSmartPointer<vtkPolyData>::New();
+  hole->SetPoints(cloud->GetPoints());
+  hole->SetPolys(polys);
+  return hole;
+}
+
+bool TestConfiguration(vtkPolyData* input, vtkPolyData* source, vtkAbstractTransform* transform,
+  double alpha, const char* name)
+{
+  vtkNew<vtkDelaunay2D> inputOrder;
+  vtkNew<vtkDelaunay2D> spatialOrder;
+  for (vtkDelaunay2D* delaunay : { inputOrder.Get(), spatialOrder.Get() })
+  {
+    delaunay->SetInputData(input);
+    delaunay->SetSourceData(source);
+    delaunay->SetTransform(transform);
+    delaunay->SetAlpha(alpha);
+  }
+  spatialOrder->SpatialPointInsertionOn();
+  inputOrder->Update();
+  spatialOrder->Update();
+  vtkPolyData* expected = inputOrder->GetOutput();
+  vtkPolyData* output = spatialOrder->GetOutput();
+
+  // The cells may be output in another order.
+  const bool same = expected->GetNumberOfPolys() > 0 &&
+    expected->GetNumberOfPoints() == output->GetNumberOfPoints() &&
+    GetSortedCells(expected) == GetSortedCells(output);
+  if (!same)
+  {
+    std::cerr << "Spatial insertion output differs " << name << ": "
+              << output->GetNumberOfPoints() << " points and " << output->GetNumberOfCells()
+              << " cells instead of " << expected->GetNumberOfPoints() << " and "
+              << expected->GetNumberOfCells() << std::endl;
+  }
+  return same;
+}
+}
+
+int TestDelaunay2DSpatialInsertion(int, char*[])
+{
+  vtkSmartPointer<vtkPolyData> cloud = ConstructPoints();
+  vtkSmartPointer<vtkPolyData> hole = ConstructHole(cloud);
+  vtkNew<vtkTransform> transform;
+  transform->RotateZ(30.0);
+  transform->Scale(2.0, 0.5, 1.0);
+  bool success = true;
+
+  success &= TestConfiguration(cloud, nullptr, nullptr, 0.0, "without options");
+  success &= TestConfiguration(cloud, hole, nullptr, 0.0, "with a constraint polygon");
+  success &= TestConfiguration(cloud, nullptr, transform, 0.0, "with a transform");
+  success &= TestConfiguration(cloud, nullptr, nullptr, 0.9, "with alpha");
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
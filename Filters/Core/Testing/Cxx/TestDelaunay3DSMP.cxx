@@ -0,0 +1,205 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDelaunay3DSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the threaded and the serial implementations of vtkDelaunay3D.
+
+#include <vtkDataArray.h>
+#include <vtkDelaunay3D.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+// Update a serial and a threaded filter, both set up by configure.
+template <typename TFilter, typename TConfigure>
+std::array<vtkSmartPointer<TFilter>, 2> UpdateSerialAndThreaded(TConfigure&& configure)
+{
+  std::array<vtkSmartPointer<TFilter>, 2> filters = { { vtkSmartPointer<TFilter>::New(),
+    vtkSmartPointer<TFilter>::New() } };
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    configure(filter.Get());
+  }
+  filters[1]->EnableSMPOn();
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    filter->Update();
+  }
+  return filters;
+}
+
+bool SameTuples(vtkDataArray* a, vtkIdType aId, vtkDataArray* b, vtkIdType bId)
+{
+  for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+  {
+    if (a->GetComponent(aId, c) != b->GetComponent(bId, c))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+  {
+    if (!SameTuples(a, t, b, t))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The cells as their type followed by their sorted point ids, sorted, to
+// compare cells output in another order.
+std::vector<std::vector<vtkIdType>> GetSortedCells(vtkDataSet* dataSet)
+{
+  std::vector<std::vector<vtkIdType>> cells(dataSet->GetNumberOfCells());
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < dataSet->GetNumberOfCells(); ++cellId)
+  {
+    dataSet->GetCellPoints(cellId, ptIds);
+    std::vector<vtkIdType>& cell = cells[cellId];
+    cell.assign(ptIds->begin(), ptIds->end());
+    std::sort(cell.begin(), cell.end());
+    cell.insert(cell.begin(), dataSet->GetCellType(cellId));
+  }
+  std::sort(cells.begin(), cells.end());
+  return cells;
+}
+
+std::ostream& ReportDifference(vtkDataSet* expected, vtkDataSet* output)
+{
+  return std::cerr << "Threaded output of " << output->GetNumberOfPoints() << " points and "
+                   << output->GetNumberOfCells() << " cells instead of "
+                   << expected->GetNumberOfPoints() << " and " << expected->GetNumberOfCells()
+                   << " differs";
+}
+
+const int Resolution = 24;
+
+// A jittered lattice of points in general position, with a few duplicates,
+// carrying point data.
+vtkSmartPointer<vtkPolyData> ConstructPoints()
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1234);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        double x[3] = { double(i), double(j), double(k) };
+        for (int c = 0; c < 3; ++c)
+        {
+          x[c] = (x[c] + random->GetRangeValue(-0.3, 0.3)) / Resolution;
+          random->Next();
+        }
+        points->InsertNextPoint(x);
+        pointScalars->InsertNextValue(x[0] + 2.0 * x[1] + 3.0 * x[2]);
+      }
+    }
+  }
+  for (vtkIdType ptId = 0; ptId < 1000; ptId += 50)
+  {
+    points->InsertNextPoint(points->GetPoint(ptId));
+    pointScalars->InsertNextValue(pointScalars->GetValue(ptId));
+  }
+
+  vtkSmartPointer<vtkPolyData> cloud = vtkSmartPointer<vtkPolyData>::New();
+  cloud->SetPoints(points);
+  cloud->GetPointData()->SetScalars(pointScalars);
+  return cloud;
+}
+
+bool TestConfiguration(
+  vtkPolyData* input, bool boundingTriangulation, double alpha, bool alphaTris)
+{
+  auto filters = UpdateSerialAndThreaded<vtkDelaunay3D>([&](vtkDelaunay3D* delaunay) {
+    delaunay->SetInputData(input);
+    delaunay->SetBoundingTriangulation(boundingTriangulation);
+    delaunay->SetAlpha(alpha);
+    delaunay->SetAlphaTris(alphaTris);
+  });
+  vtkUnstructuredGrid* expected = filters[0]->GetOutput();
+  vtkUnstructuredGrid* output = filters[1]->GetOutput();
+
+  // Duplicate points are not inserted, the serial implementation leaves
+  // their bounding triangulation coordinates uninitialized.
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  bool same = expected->GetNumberOfCells() > 0 &&
+    expected->GetNumberOfPoints() == output->GetNumberOfPoints() &&
+    GetSortedCells(expected) == GetSortedCells(output);
+  for (vtkIdType ptId = 0; same && ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    if (ptId < numPts && input->GetPoints()->GetData() != output->GetPoints()->GetData())
+    {
+      double x[3], y[3];
+      input->GetPoint(ptId, x);
+      output->GetPoint(ptId, y);
+      same = (x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+    }
+  }
+  if (same && !boundingTriangulation)
+  {
+    same = SameArrays(expected->GetPointData()->GetScalars(), output->GetPointData()->GetScalars());
+  }
+  if (!same)
+  {
+    ReportDifference(expected, output)
+      << " with bounding triangulation " << boundingTriangulation << ", alpha " << alpha
+      << " and alpha triangles " << alphaTris << std::endl;
+  }
+  return same;
+}
+}
+
+int TestDelaunay3DSMP(int, char*[])
+{
+  vtkSmartPointer<vtkPolyData> cloud = ConstructPoints();
+  bool success = true;
+
+  success &= TestConfiguration(cloud, false, 0.0, true);
+  success &= TestConfiguration(cloud, true, 0.0, true);
+  success &= TestConfiguration(cloud, true, 0.06, true);
+  // Without bounding triangulation, the alpha triangles on the convex hull
+  // depend on the order of the tetrahedra.
+  success &= TestConfiguration(cloud, false, 0.06, false);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,195 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricClusteringSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the threaded and the serial implementations of vtkQuadricClustering.
+
+#include <vtkCellArray.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkQuadricClustering.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkStripper.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+// Update a serial and a threaded filter, both set up by configure.
+template <typename TFilter, typename TConfigure>
+std::array<vtkSmartPointer<TFilter>, 2> UpdateSerialAndThreaded(TConfigure&& configure)
+{
+  std::array<vtkSmartPointer<TFilter>, 2> filters = { { vtkSmartPointer<TFilter>::New(),
+    vtkSmartPointer<TFilter>::New() } };
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    configure(filter.Get());
+  }
+  filters[1]->EnableSMPOn();
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    filter->Update();
+  }
+  return filters;
+}
+
+bool SamePoints(vtkPoints* a, vtkPoints* b, double tolerance)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints())
+  {
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < a->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], y[3];
+    a->GetPoint(ptId, x);
+    b->GetPoint(ptId, y);
+    for (int i = 0; i < 3; ++i)
+    {
+      if (std::abs(x[i] - y[i]) > tolerance)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Compare the cells of two cell arrays, in order.
+bool SameCells(vtkCellArray* a, vtkCellArray* b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> aIds;
+  vtkNew<vtkIdList> bIds;
+  for (vtkIdType c = 0; c < a->GetNumberOfCells(); ++c)
+  {
+    a->GetCellAtId(c, aIds);
+    b->GetCellAtId(c, bIds);
+    if (aIds->GetNumberOfIds() != bIds->GetNumberOfIds() ||
+      !std::equal(aIds->begin(), aIds->end(), bIds->begin()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::ostream& ReportDifference(vtkDataSet* expected, vtkDataSet* output)
+{
+  return std::cerr << "Threaded output of " << output->GetNumberOfPoints() << " points and "
+                   << output->GetNumberOfCells() << " cells instead of "
+                   << expected->GetNumberOfPoints() << " and " << expected->GetNumberOfCells()
+                   << " differs";
+}
+
+// A sphere made of polygons, with some of its points as vertices, some
+// polylines, and the same sphere as triangle strips.
+vtkSmartPointer<vtkPolyData> ConstructInput()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(100);
+  sphere->SetPhiResolution(100);
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(sphere->GetOutputPort());
+  stripper->Update();
+  vtkPolyData* polys = sphere->GetOutput();
+
+  vtkNew<vtkCellArray> verts;
+  for (vtkIdType ptId = 0; ptId + 1 < polys->GetNumberOfPoints(); ptId += 11)
+  {
+    verts->InsertNextCell({ ptId, ptId + 1 });
+  }
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < polys->GetNumberOfCells(); cellId += 7)
+  {
+    polys->GetCellPoints(cellId, ptIds);
+    ptIds->InsertNextId(ptIds->GetId(0));
+    lines->InsertNextCell(ptIds);
+  }
+
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(polys->GetPoints());
+  input->SetVerts(verts);
+  input->SetLines(lines);
+  input->SetPolys(polys->GetPolys());
+  input->SetStrips(stripper->GetOutput()->GetStrips());
+  return input;
+}
+
+bool TestConfiguration(vtkPolyData* input, int divisions, bool useInputPoints,
+  bool preventDuplicates, bool useInternalTriangles, bool useFeatureEdges)
+{
+  auto filters = UpdateSerialAndThreaded<vtkQuadricClustering>(
+    [&](vtkQuadricClustering* clustering) {
+      clustering->SetInputData(input);
+      clustering->SetNumberOfDivisions(divisions, divisions, divisions);
+      clustering->SetAutoAdjustNumberOfDivisions(divisions < 100);
+      clustering->SetUseInputPoints(useInputPoints);
+      clustering->SetPreventDuplicateCells(preventDuplicates);
+      clustering->SetUseInternalTriangles(useInternalTriangles);
+      clustering->SetUseFeatureEdges(useFeatureEdges);
+    });
+  vtkPolyData* expected = filters[0]->GetOutput();
+  vtkPolyData* output = filters[1]->GetOutput();
+
+  // The points only differ by the rounding of the quadric sums.
+  const bool same = SamePoints(expected->GetPoints(), output->GetPoints(), 1.0e-5) &&
+    SameCells(expected->GetVerts(), output->GetVerts()) &&
+    SameCells(expected->GetLines(), output->GetLines()) &&
+    SameCells(expected->GetPolys(), output->GetPolys()) &&
+    SameCells(expected->GetStrips(), output->GetStrips());
+  if (!same)
+  {
+    ReportDifference(expected, output)
+      << " with " << divisions << " divisions, input points " << useInputPoints
+      << ", duplicate prevention " << preventDuplicates << ", internal triangles "
+      << useInternalTriangles << " and feature edges " << useFeatureEdges << std::endl;
+  }
+  return same;
+}
+}
+
+int TestQuadricClusteringSMP(int, char*[])
+{
+  vtkSmartPointer<vtkPolyData> input = ConstructInput();
+  bool success = true;
+
+  // Dense bins, then hashed bins with a fine grid.
+  for (int divisions : { 30, 120 })
+  {
+    for (bool useInputPoints : { false, true })
+    {
+      for (bool preventDuplicates : { true, false })
+      {
+        for (bool useInternalTriangles : { true, false })
+        {
+          success &= TestConfiguration(
+            input, divisions, useInputPoints, preventDuplicates, useInternalTriangles, false);
+        }
+      }
+    }
+  }
+  success &= TestConfiguration(input, 30, false, true, true, true);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
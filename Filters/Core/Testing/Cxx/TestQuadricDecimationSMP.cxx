@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimationSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the error of the threaded and the serial implementations of
+// vtkQuadricDecimation, measured by the Hausdorff distance to the input.
+
+#include <vtkCellArray.h>
+#include <vtkCellArrayIterator.h>
+#include <vtkGenericCell.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkQuadricDecimation.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkStaticCellLocator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+// Largest distance from the points of a surface to another surface.
+double ComputeDistance(vtkPolyData* from, vtkPolyData* to)
+{
+  vtkNew<vtkStaticCellLocator> locator;
+  locator->SetDataSet(to);
+  locator->BuildLocator();
+  vtkNew<vtkGenericCell> cell;
+  double maxDistance2 = 0.0;
+  for (vtkIdType ptId = 0; ptId < from->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], closest[3], distance2;
+    vtkIdType cellId;
+    int subId;
+    from->GetPoint(ptId, x);
+    locator->FindClosestPoint(x, closest, cell, cellId, subId, distance2);
+    maxDistance2 = std::max(maxDistance2, distance2);
+  }
+  return std::sqrt(maxDistance2);
+}
+
+double ComputeHausdorffDistance(vtkPolyData* a, vtkPolyData* b)
+{
+  return std::max(ComputeDistance(a, b), ComputeDistance(b, a));
+}
+
+// The output must only hold valid triangles, using all the points.
+bool IsValid(vtkPolyData* output)
+{
+  std::vector<bool> used(output->GetNumberOfPoints(), false);
+  auto iter = vtk::TakeSmartPointer(output->GetPolys()->NewIterator());
+  for (iter->GoToFirstCell(); !iter->IsDoneWithTraversal(); iter->GoToNextCell())
+  {
+    vtkIdType npts;
+    const vtkIdType* pts;
+    iter->GetCurrentCell(npts, pts);
+    if (npts != 3 || pts[0] == pts[1] || pts[1] == pts[2] || pts[2] == pts[0])
+    {
+      std::cerr << "Invalid triangle " << iter->GetCurrentCellId() << std::endl;
+      return false;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      used[pts[i]] = true;
+    }
+  }
+  if (std::find(used.begin(), used.end(), false) != used.end())
+  {
+    std::cerr << "Unused output points" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestDecimation(vtkPolyData* input, const char* name)
+{
+  vtkNew<vtkQuadricDecimation> serial;
+  serial->SetInputData(input);
+  serial->SetTargetReduction(0.9);
+  serial->Update();
+
+  vtkNew<vtkQuadricDecimation> threaded;
+  threaded->SetInputData(input);
+  threaded->SetTargetReduction(0.9);
+  threaded->EnableSMPOn();
+  threaded->Update();
+
+  vtkPolyData* serialOutput = serial->GetOutput();
+  vtkPolyData* threadedOutput = threaded->GetOutput();
+  const double serialError = ComputeHausdorffDistance(input, serialOutput);
+  const double threadedError = ComputeHausdorffDistance(input, threadedOutput);
+
+  bool success = IsValid(threadedOutput);
+  if (success &&
+    (threaded->GetActualReduction() < 0.9 ||
+      threadedOutput->GetNumberOfPolys() > serialOutput->GetNumberOfPolys() + 2))
+  {
+    std::cerr << "Target reduction not achieved: " << threaded->GetActualReduction() << std::endl;
+    success = false;
+  }
+  else if (success && threadedError > 1.5 * serialError)
+  {
+    std::cerr << "Threaded decimation error too large" << std::endl;
+    success = false;
+  }
+  if (!success)
+  {
+    std::cerr << name << ": " << input->GetNumberOfPolys() << " triangles reduced to "
+              << serialOutput->GetNumberOfPolys() << " (serial) and "
+              << threadedOutput->GetNumberOfPolys() << " (threaded), Hausdorff distances "
+              << serialError << " and " << threadedError << std::endl;
+  }
+  return success;
+}
+}
+
+int TestQuadricDecimationSMP(int, char*[])
+{
+  // A closed surface.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(120);
+  sphere->SetPhiResolution(120);
+  sphere->Update();
+
+  // A surface with a boundary.
+  vtkNew<vtkSphereSource> wedge;
+  wedge->SetThetaResolution(120);
+  wedge->SetPhiResolution(120);
+  wedge->SetEndTheta(270.0);
+  wedge->Update();
+
+  return TestDecimation(sphere->GetOutput(), "Sphere") &&
+      TestDecimation(wedge->GetOutput(), "Wedge")
+    ? EXIT_SUCCESS
+    : EXIT_FAILURE;
+}
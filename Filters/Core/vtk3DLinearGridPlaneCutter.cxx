@@ -50,7 +50,9 @@
 #include "vtkWedge.h"
 
 #include <algorithm>
+#include <functional>
 #include <numeric>
+#include <vector>
 
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtk3DLinearGridPlaneCutter);
@@ -257,17 +259,21 @@ struct ExtractEdgesBase
   // Composite local thread data
   void Reduce()
   {
-    // Count the number of triangles, and number of threads used.
-    vtkIdType numTris = 0;
-    this->NumThreadsUsed = 0;
-    for (const auto& ld : this->LocalData)
+    // Gather the thread local data, then prefix sum the number of edges
+    // produced by each thread to know where it writes into the output.
+    std::vector<LocalDataType*> localData;
+    for (auto& ld : this->LocalData)
     {
-      numTris += static_cast<vtkIdType>(ld.LocalEdges.size() / 3); // three edges per triangle
-      this->NumThreadsUsed++;
+      localData.push_back(&ld);
     }
+    this->NumThreadsUsed = static_cast<int>(localData.size());
+    std::vector<vtkIdType> edgeOffsets(localData.size());
+    const vtkIdType numEdges = vtkSMPTools::TransformExclusiveScan(localData.begin(),
+      localData.end(), edgeOffsets.begin(), vtkIdType(0), std::plus<vtkIdType>(),
+      [](const LocalDataType* ld) { return static_cast<vtkIdType>(ld->LocalEdges.size()); });
 
     // Allocate space for VTK triangle output.
-    this->NumTris = numTris;
+    this->NumTris = numEdges / 3; // three edges per triangle
     this->Tris->ResizeExact(this->NumTris, 3 * this->NumTris);
 
     // Copy local edges to global edge array. Add in the originating edge id
@@ -280,27 +286,32 @@ struct ExtractEdgesBase
       this->Cells = new IDType[cellSize];
     }
 
-    vtkIdType edgeNum = 0;
-    for (auto& ld : this->LocalData)
-    {
-      vtkIdType cellNum = edgeNum / 3;
-      for (const auto& lc : ld.LocalCells)
-      {
-        this->Cells[cellNum] = lc;
-        cellNum++;
-      }
-      for (const auto& le : ld.LocalEdges)
-      {
-        this->Edges[edgeNum].V0 = le.V0;
-        this->Edges[edgeNum].V1 = le.V1;
-        this->Edges[edgeNum].Data.T = le.Data;
-        this->Edges[edgeNum].Data.EId = edgeNum;
-        edgeNum++;
-      }
-      std::vector<IDType>().swap(ld.LocalCells); // frees memory
-      std::vector<EdgeTupleType>().swap(ld.LocalEdges);
-    } // For all threads
-  }   // Reduce
+    // Each thread's data is copied independently.
+    vtkSMPTools::For(0, static_cast<vtkIdType>(localData.size()), 1,
+      [&](vtkIdType threadId, vtkIdType endThreadId) {
+        for (; threadId < endThreadId; ++threadId)
+        {
+          LocalDataType& ld = *localData[threadId];
+          vtkIdType edgeNum = edgeOffsets[threadId];
+          vtkIdType cellNum = edgeNum / 3;
+          for (const auto& lc : ld.LocalCells)
+          {
+            this->Cells[cellNum] = lc;
+            cellNum++;
+          }
+          for (const auto& le : ld.LocalEdges)
+          {
+            this->Edges[edgeNum].V0 = le.V0;
+            this->Edges[edgeNum].V1 = le.V1;
+            this->Edges[edgeNum].Data.T = le.Data;
+            this->Edges[edgeNum].Data.EId = edgeNum;
+            edgeNum++;
+          }
+          std::vector<IDType>().swap(ld.LocalCells); // frees memory
+          std::vector<EdgeTupleType>().swap(ld.LocalEdges);
+        } // For all threads
+      });
+  } // Reduce
 };    // ExtractEdgesBase
 
 // Traverse all cells and extract intersected edges (without a sphere tree).
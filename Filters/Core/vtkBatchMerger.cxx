@@ -0,0 +1,258 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBatchMerger.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBatchMerger.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataSetAttributesFieldList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <numeric>
+
+//------------------------------------------------------------------------------
+VTK_ABI_NAMESPACE_BEGIN
+void vtkBatchMerger::MergePoints(const std::vector<vtkPoints*>& batchPoints,
+  const std::vector<vtkPointData*>& batchPD, vtkPointData* inPD, bool mergePoints,
+  vtkPoints* outPoints, vtkPointData* outPD)
+{
+  const vtkIdType numBatches = static_cast<vtkIdType>(batchPoints.size());
+  this->PointOffsets.resize(numBatches + 1);
+  for (vtkIdType batch = 0; batch < numBatches; ++batch)
+  {
+    this->PointOffsets[batch] = batchPoints[batch]->GetNumberOfPoints();
+  }
+  const vtkIdType numBatchPts = vtkSMPTools::ExclusiveScan(this->PointOffsets.begin(),
+    this->PointOffsets.end() - 1, this->PointOffsets.begin(), vtkIdType(0));
+  this->PointOffsets[numBatches] = numBatchPts;
+
+  // Gather the points of the batches, as stored.
+  std::vector<double> coordinates(3 * numBatchPts);
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType batch = begin; batch < end; ++batch)
+    {
+      vtkPoints* points = batchPoints[batch];
+      for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+      {
+        points->GetPoint(i, &coordinates[3 * (this->PointOffsets[batch] + i)]);
+      }
+    }
+  });
+
+  // Merge the coincident points into the first of them, and number these in
+  // order.
+  std::vector<vtkIdType> representatives(numBatchPts);
+  std::iota(representatives.begin(), representatives.end(), 0);
+  if (mergePoints)
+  {
+    std::vector<vtkIdType> order(representatives);
+    auto sameCoordinates = [&coordinates](vtkIdType a, vtkIdType b) {
+      return std::equal(&coordinates[3 * a], &coordinates[3 * a] + 3, &coordinates[3 * b]);
+    };
+    vtkSMPTools::Sort(order.begin(), order.end(), [&coordinates](vtkIdType a, vtkIdType b) {
+      const double* x = &coordinates[3 * a];
+      const double* y = &coordinates[3 * b];
+      return std::lexicographical_compare(x, x + 3, y, y + 3) ||
+        (std::equal(x, x + 3, y) && a < b);
+    });
+    vtkSMPTools::For(0, numBatchPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        if (i > 0 && sameCoordinates(order[i - 1], order[i]))
+        {
+          continue;
+        }
+        for (vtkIdType j = i + 1; j < numBatchPts && sameCoordinates(order[i], order[j]); ++j)
+        {
+          representatives[order[j]] = order[i];
+        }
+      }
+    });
+  }
+  std::vector<vtkIdType>& pointMap = this->PointMap;
+  pointMap.resize(numBatchPts);
+  vtkSMPTools::For(0, numBatchPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      pointMap[i] = representatives[i] == i ? 1 : 0;
+    }
+  });
+  const vtkIdType numNewPts =
+    vtkSMPTools::ExclusiveScan(pointMap.begin(), pointMap.end(), pointMap.begin(), vtkIdType(0));
+  std::vector<vtkIdType> sourcePoints(numNewPts);
+  vtkSMPTools::For(0, numBatchPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (representatives[i] == i)
+      {
+        sourcePoints[pointMap[i]] = i;
+      }
+    }
+  });
+  vtkSMPTools::For(0, numBatchPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (representatives[i] != i)
+      {
+        pointMap[i] = pointMap[representatives[i]];
+      }
+    }
+  });
+
+  outPoints->SetNumberOfPoints(numNewPts);
+  vtkSMPTools::For(0, numNewPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      outPoints->SetPoint(ptId, &coordinates[3 * sourcePoints[ptId]]);
+    }
+  });
+
+  // Point data of the representatives.
+  outPD->InterpolateAllocate(inPD, numNewPts);
+  outPD->SetNumberOfTuples(numNewPts);
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType batch = begin; batch < end; ++batch)
+    {
+      vtkPointData* pd = batchPD[batch];
+      const vtkIdType pointOffset = this->PointOffsets[batch];
+      const vtkIdType numPoints = this->PointOffsets[batch + 1] - pointOffset;
+      for (int arrayId = 0; arrayId < outPD->GetNumberOfArrays(); ++arrayId)
+      {
+        vtkAbstractArray* batchArray = pd->GetAbstractArray(arrayId);
+        vtkAbstractArray* outArray = outPD->GetAbstractArray(arrayId);
+        for (vtkIdType i = 0; i < numPoints; ++i)
+        {
+          if (representatives[pointOffset + i] == pointOffset + i)
+          {
+            outArray->SetTuple(pointMap[pointOffset + i], i, batchArray);
+          }
+        }
+      }
+    }
+  });
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkCellArray> vtkBatchMerger::MergeCells(
+  const std::vector<vtkCellArray*>& batchCells,
+  const std::vector<const unsigned char*>& batchTypes) const
+{
+  const vtkIdType numBatches = static_cast<vtkIdType>(batchCells.size());
+  std::vector<vtkIdType> cellOffsets(numBatches + 1);
+  std::vector<vtkIdType> connectivityOffsets(numBatches + 1);
+  for (vtkIdType batch = 0; batch < numBatches; ++batch)
+  {
+    cellOffsets[batch] = batchCells[batch]->GetNumberOfCells();
+    connectivityOffsets[batch] = batchCells[batch]->GetNumberOfConnectivityIds();
+  }
+  const vtkIdType numCells = vtkSMPTools::ExclusiveScan(
+    cellOffsets.begin(), cellOffsets.end() - 1, cellOffsets.begin(), vtkIdType(0));
+  const vtkIdType numIds = vtkSMPTools::ExclusiveScan(connectivityOffsets.begin(),
+    connectivityOffsets.end() - 1, connectivityOffsets.begin(), vtkIdType(0));
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numCells + 1);
+  offsets->SetValue(numCells, numIds);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(numIds);
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType batch = begin; batch < end; ++batch)
+    {
+      vtkCellArray* cells = batchCells[batch];
+      const unsigned char* types = batchTypes.empty() ? nullptr : batchTypes[batch];
+      const vtkIdType firstCell = cellOffsets[batch];
+      const vtkIdType firstId = connectivityOffsets[batch];
+      const vtkIdType* pointMap = this->PointMap.data() + this->PointOffsets[batch];
+      auto iter = vtk::TakeSmartPointer(cells->NewIterator());
+      for (vtkIdType cellId = 0; cellId < cells->GetNumberOfCells(); ++cellId)
+      {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        iter->GetCellAtId(cellId, npts, pts);
+        const vtkIdType offset = firstId + cells->GetOffset(cellId);
+        offsets->SetValue(firstCell + cellId, offset);
+        if (types && types[cellId] == VTK_POLYHEDRON)
+        {
+          // Face stream: (numFaces, numFace0Pts, id0, id1, ..., numFace1Pts, ...)
+          connectivity->SetValue(offset, pts[0]);
+          vtkIdType index = 1;
+          for (vtkIdType face = 0; face < pts[0]; ++face)
+          {
+            const vtkIdType numFacePts = pts[index];
+            connectivity->SetValue(offset + index, numFacePts);
+            for (vtkIdType j = index + 1; j <= index + numFacePts; ++j)
+            {
+              connectivity->SetValue(offset + j, pointMap[pts[j]]);
+            }
+            index += numFacePts + 1;
+          }
+        }
+        else
+        {
+          for (vtkIdType j = 0; j < npts; ++j)
+          {
+            connectivity->SetValue(offset + j, pointMap[pts[j]]);
+          }
+        }
+      }
+    }
+  });
+  vtkSmartPointer<vtkCellArray> newCells = vtkSmartPointer<vtkCellArray>::New();
+  newCells->SetData(offsets, connectivity);
+  return newCells;
+}
+
+//------------------------------------------------------------------------------
+void vtkBatchMerger::CopyCellData(const std::vector<const std::vector<vtkIdType>*>& cellIds,
+  vtkCellData* inCD, vtkCellData* outCD)
+{
+  const vtkIdType numLists = static_cast<vtkIdType>(cellIds.size());
+  std::vector<vtkIdType> listOffsets(numLists + 1);
+  for (vtkIdType list = 0; list < numLists; ++list)
+  {
+    listOffsets[list] = static_cast<vtkIdType>(cellIds[list]->size());
+  }
+  const vtkIdType numCells = vtkSMPTools::ExclusiveScan(
+    listOffsets.begin(), listOffsets.end() - 1, listOffsets.begin(), vtkIdType(0));
+  std::vector<vtkIdType> sourceCells(numCells);
+  vtkSMPTools::For(0, numLists, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType list = begin; list < end; ++list)
+    {
+      std::copy(cellIds[list]->begin(), cellIds[list]->end(),
+        sourceCells.begin() + listOffsets[list]);
+    }
+  });
+
+  vtkDataSetAttributes::FieldList cellList(1);
+  cellList.InitializeFieldList(inCD);
+  cellList.CopyAllocate(outCD, vtkDataSetAttributes::COPYTUPLE, numCells, 0);
+  outCD->SetNumberOfTuples(numCells);
+  cellList.TransformData(
+    0, inCD, outCD, [&](vtkAbstractArray* inArray, vtkAbstractArray* outArray) {
+      vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType cellId = begin; cellId < end; ++cellId)
+        {
+          outArray->SetTuple(cellId, sourceCells[cellId], inArray);
+        }
+      });
+    });
+}
+VTK_ABI_NAMESPACE_END
@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBatchMerger.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkBatchMerger
+ * @brief   A utility class merging the outputs of batches of cells
+ *
+ * This is a utility class used by the threaded implementations of filters
+ * processing batches of consecutive cells concurrently, each batch inserting
+ * its points with its own locator. The points of the batches are merged in
+ * batch order, the coincident points being merged into the first of them, so
+ * the output points are numbered like the serial implementation inserting
+ * them with a vtkMergePoints locator. The cells of the batches are then
+ * concatenated using the merged point ids.
+ * @sa
+ * vtkCutter vtkClipDataSet
+ */
+
+#ifndef vtkBatchMerger_h
+#define vtkBatchMerger_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkSmartPointer.h"      // For return value
+#include "vtkType.h"              // For vtkIdType
+
+#include <vector> // For member variables
+
+VTK_ABI_NAMESPACE_BEGIN
+class vtkCellArray;
+class vtkCellData;
+class vtkPointData;
+class vtkPoints;
+
+class VTKFILTERSCORE_EXPORT vtkBatchMerger
+{
+public:
+  vtkBatchMerger() = default;
+
+  /**
+   * Merge the points of the batches, with their point data, into outPoints
+   * and outPD. The point data of the batches must be interpolate-allocated
+   * from inPD, so that their arrays match the output ones by index. When
+   * mergePoints is false, the points are only concatenated.
+   */
+  void MergePoints(const std::vector<vtkPoints*>& batchPoints,
+    const std::vector<vtkPointData*>& batchPD, vtkPointData* inPD, bool mergePoints,
+    vtkPoints* outPoints, vtkPointData* outPD);
+
+  /**
+   * Concatenate the cells of the batches, whose point ids refer to the points
+   * of their batch, using the merged point ids. When batchTypes is given, it
+   * holds the cell types of each batch, and the face streams of polyhedra
+   * are renumbered.
+   */
+  vtkSmartPointer<vtkCellArray> MergeCells(const std::vector<vtkCellArray*>& batchCells,
+    const std::vector<const unsigned char*>& batchTypes = {}) const;
+
+  /**
+   * Copy into outCD the cell data of the input cells listed by cellIds, the
+   * lists being concatenated in order.
+   */
+  static void CopyCellData(const std::vector<const std::vector<vtkIdType>*>& cellIds,
+    vtkCellData* inCD, vtkCellData* outCD);
+
+private:
+  vtkBatchMerger(const vtkBatchMerger&) = delete;
+  vtkBatchMerger& operator=(const vtkBatchMerger&) = delete;
+
+  // Offsets of the batches in the concatenated points, and output id of each
+  // of these points.
+  std::vector<vtkIdType> PointOffsets;
+  std::vector<vtkIdType> PointMap;
+};
+
+VTK_ABI_NAMESPACE_END
+#endif
+// VTK-HeaderTest-Exclude: vtkBatchMerger.h
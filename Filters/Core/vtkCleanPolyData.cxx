@@ -14,20 +14,32 @@
 =========================================================================*/
 #include "vtkCleanPolyData.h"
 
+#include "vtkArrayListTemplate.h" // For processing attribute data
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkIdTypeArray.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkCleanPolyData);
@@ -48,6 +60,174 @@ bool InsertPointUsingGlobalId(vtkIdType globalId, vtkPoints* newPts,
   ptId = it->second;
   return false;
 }
+
+//------------------------------------------------------------------------------
+// Helpers of the threaded implementation. Points and cells are processed in
+// blocks, first to count what each block produces, then, once the counts are
+// turned into offsets, to fill the output in the order of the serial
+// implementation.
+const vtkIdType CleanBlockSize = 65536;
+
+// Record the first position of each point in the connectivity of the cell
+// arrays, taken one after the other.
+struct MarkFirstUses
+{
+  template <typename CellStateT>
+  void operator()(CellStateT& state, vtkIdType base, std::atomic<vtkIdType>* firstUses) const
+  {
+    const auto* conn = state.GetConnectivity()->GetPointer(0);
+    vtkSMPTools::For(0, state.GetConnectivity()->GetNumberOfValues(),
+      [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          std::atomic<vtkIdType>& first = firstUses[conn[i]];
+          const vtkIdType position = base + i;
+          vtkIdType current = first.load(std::memory_order_relaxed);
+          while (position < current &&
+            !first.compare_exchange_weak(current, position, std::memory_order_relaxed))
+          {
+          }
+        }
+      });
+  }
+};
+
+// Number the points in the order of their first use, starting at rank.
+// Returns the rank following the last point numbered.
+struct RankFirstUses
+{
+  template <typename CellStateT>
+  vtkIdType operator()(CellStateT& state, vtkIdType base,
+    const std::atomic<vtkIdType>* firstUses, vtkIdType rank, vtkIdType* ranks) const
+  {
+    const auto* conn = state.GetConnectivity()->GetPointer(0);
+    const vtkIdType size = state.GetConnectivity()->GetNumberOfValues();
+    const vtkIdType numBlocks = (size + CleanBlockSize - 1) / CleanBlockSize;
+    std::vector<vtkIdType> starts(numBlocks);
+    vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+      for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+        const vtkIdType end = std::min(size, (block + 1) * CleanBlockSize);
+        vtkIdType count = 0;
+        for (vtkIdType i = block * CleanBlockSize; i < end; ++i)
+        {
+          count += firstUses[conn[i]].load(std::memory_order_relaxed) == base + i;
+        }
+        starts[block] = count;
+      }
+    });
+    const vtkIdType next =
+      vtkSMPTools::ExclusiveScan(starts.begin(), starts.end(), starts.begin(), rank);
+    vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+      for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+        const vtkIdType end = std::min(size, (block + 1) * CleanBlockSize);
+        vtkIdType current = starts[block];
+        for (vtkIdType i = block * CleanBlockSize; i < end; ++i)
+        {
+          if (firstUses[conn[i]].load(std::memory_order_relaxed) == base + i)
+          {
+            ranks[conn[i]] = current++;
+          }
+        }
+      }
+    });
+    return next;
+  }
+};
+
+// The kinds of output cells, in the order of the output cell data.
+enum CleanCellKind
+{
+  CLEAN_VERT = 0,
+  CLEAN_LINE,
+  CLEAN_POLY,
+  CLEAN_STRIP,
+  CLEAN_NUMBER_OF_KINDS,
+  CLEAN_REMOVED = CLEAN_NUMBER_OF_KINDS
+};
+
+// Map the points of a cell of the given input kind and return the kind of
+// the output cell, following the rules of the serial implementation.
+struct CleanCell
+{
+  const vtkIdType* PointMap;
+  bool ConvertLinesToPoints;
+  bool ConvertPolysToLines;
+  bool ConvertStripsToPolys;
+
+  int operator()(
+    int kind, vtkIdType npts, const vtkIdType* pts, vtkIdType* newPts, vtkIdType& numNewPts) const
+  {
+    numNewPts = 0;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      const vtkIdType ptId = this->PointMap[pts[i]];
+      // Vertices keep all their points, other cells lose repeated points.
+      if (kind == CLEAN_VERT || i == 0 || ptId != newPts[numNewPts - 1])
+      {
+        newPts[numNewPts++] = ptId;
+      }
+    }
+    switch (kind)
+    {
+      case CLEAN_VERT:
+        return numNewPts > 0 ? CLEAN_VERT : CLEAN_REMOVED;
+      case CLEAN_LINE:
+        if (numNewPts >= 2)
+        {
+          return CLEAN_LINE;
+        }
+        break;
+      case CLEAN_POLY:
+        if (numNewPts > 2 && newPts[0] == newPts[numNewPts - 1])
+        {
+          numNewPts--;
+        }
+        if (numNewPts > 2)
+        {
+          return CLEAN_POLY;
+        }
+        break;
+      default:
+        if (numNewPts > 1 && newPts[0] == newPts[numNewPts - 1])
+        {
+          numNewPts--;
+        }
+        if (numNewPts > 3)
+        {
+          return CLEAN_STRIP;
+        }
+        if (numNewPts == 3 && (npts == 3 || this->ConvertStripsToPolys))
+        {
+          return CLEAN_POLY;
+        }
+        break;
+    }
+    // Degenerate lines, polys and strips.
+    if (numNewPts == 2 && (npts == 2 || this->ConvertPolysToLines))
+    {
+      return CLEAN_LINE;
+    }
+    if (numNewPts == 1 && (npts == 1 || this->ConvertLinesToPoints))
+    {
+      return CLEAN_VERT;
+    }
+    return CLEAN_REMOVED;
+  }
+};
+
+// What a block of input cells produces, or where it goes in the output.
+struct CleanBlock
+{
+  vtkCellArray* Cells;
+  int Kind;
+  vtkIdType FirstCell;   // first cell of the block in its cell array
+  vtkIdType NumberOfCells;
+  vtkIdType FirstCellId; // id of the first cell in the input cell data
+  vtkIdType OutputCells[CLEAN_NUMBER_OF_KINDS];
+  vtkIdType OutputConnectivity[CLEAN_NUMBER_OF_KINDS];
+};
 } // anonymous namespace
 
 //------------------------------------------------------------------------------
@@ -69,6 +249,7 @@ vtkCleanPolyData::vtkCleanPolyData()
   this->Locator = nullptr;
   this->PieceInvariant = 1;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->EnableSMP = false;
 }
 
 //------------------------------------------------------------------------------
@@ -152,6 +333,10 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
     vtkDebugMacro(<< "No data to Operate On!");
     return 1;
   }
+  if (this->EnableSMP)
+  {
+    return this->RequestDataSMP(input, output);
+  }
   vtkIdType* updatedPts = new vtkIdType[input->GetMaxCellSize()];
 
   vtkIdType numNewPts;
@@ -666,6 +851,322 @@ int vtkCleanPolyData::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//------------------------------------------------------------------------------
+int vtkCleanPolyData::RequestDataSMP(vtkPolyData* input, vtkPolyData* output)
+{
+  vtkPoints* inPts = input->GetPoints();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData* inPD = input->GetPointData();
+  vtkCellData* inCD = input->GetCellData();
+  vtkPointData* outPD = output->GetPointData();
+  vtkCellData* outCD = output->GetCellData();
+  vtkCellArray* inCells[CLEAN_NUMBER_OF_KINDS] = { input->GetVerts(), input->GetLines(),
+    input->GetPolys(), input->GetStrips() };
+
+  vtkDebugMacro(<< "Beginning threaded PolyData clean");
+
+  // Number the used points in the order of their first use by the cells, the
+  // order in which the serial implementation inserts them.
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUses(new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      firstUses[ptId].store(VTK_ID_MAX, std::memory_order_relaxed);
+    }
+  });
+  vtkIdType base = 0;
+  for (vtkCellArray* cells : inCells)
+  {
+    cells->Visit(MarkFirstUses{}, base, firstUses.get());
+    base += cells->GetNumberOfConnectivityIds();
+  }
+  std::vector<vtkIdType> pointMap(numPts, -1);
+  vtkIdType numUsedPts = 0;
+  base = 0;
+  for (vtkCellArray* cells : inCells)
+  {
+    numUsedPts = cells->Visit(RankFirstUses{}, base, firstUses.get(), numUsedPts, pointMap.data());
+    base += cells->GetNumberOfConnectivityIds();
+  }
+  firstUses.reset();
+
+  // Gather the used points in that order, operated on.
+  std::vector<vtkIdType> usedIds(numUsedPts);
+  vtkNew<vtkPoints> usedPts;
+  usedPts->SetDataTypeToDouble();
+  usedPts->SetNumberOfPoints(numUsedPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    double x[3], newx[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      const vtkIdType rank = pointMap[ptId];
+      if (rank >= 0)
+      {
+        usedIds[rank] = ptId;
+        inPts->GetPoint(ptId, x);
+        this->OperateOnPoint(x, newx);
+        usedPts->SetPoint(rank, newx);
+      }
+    }
+  });
+  this->UpdateProgress(0.2);
+
+  // Merge the used points: each point is merged to the first used point of
+  // its group, which the serial implementation inserts first.
+  std::vector<vtkIdType> mergeMap(numUsedPts);
+  vtkIdTypeArray* globalIds = vtkIdTypeArray::SafeDownCast(inPD->GetGlobalIds());
+  if (!this->PointMerging)
+  {
+    std::iota(mergeMap.begin(), mergeMap.end(), 0);
+  }
+  else if (globalIds)
+  {
+    // Points are merged when they have the same global id.
+    std::vector<std::pair<vtkIdType, vtkIdType>> sorted(numUsedPts);
+    vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType rank = begin; rank < end; ++rank)
+      {
+        sorted[rank] = std::make_pair(globalIds->GetValue(usedIds[rank]), rank);
+      }
+    });
+    vtkSMPTools::Sort(sorted.begin(), sorted.end());
+    vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        vtkIdType first = i;
+        while (first > 0 && sorted[first - 1].first == sorted[i].first)
+        {
+          --first;
+        }
+        mergeMap[sorted[i].second] = sorted[first].second;
+      }
+    });
+  }
+  else if (numUsedPts > 0)
+  {
+    const double tol = this->ToleranceIsAbsolute ? this->AbsoluteTolerance
+                                                 : this->Tolerance * input->GetLength();
+    vtkNew<vtkPolyData> usedData;
+    usedData->SetPoints(usedPts);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(usedData);
+    locator->BuildLocator();
+    locator->MergePoints(tol, mergeMap.data());
+
+    // The locator does not merge to the lowest id of the group.
+    std::unique_ptr<std::atomic<vtkIdType>[]> firsts(new std::atomic<vtkIdType>[numUsedPts]);
+    vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType rank = begin; rank < end; ++rank)
+      {
+        firsts[rank].store(VTK_ID_MAX, std::memory_order_relaxed);
+      }
+    });
+    vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType rank = begin; rank < end; ++rank)
+      {
+        std::atomic<vtkIdType>& first = firsts[mergeMap[rank]];
+        vtkIdType current = first.load(std::memory_order_relaxed);
+        while (rank < current &&
+          !first.compare_exchange_weak(current, rank, std::memory_order_relaxed))
+        {
+        }
+      }
+    });
+    vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType rank = begin; rank < end; ++rank)
+      {
+        mergeMap[rank] = firsts[mergeMap[rank]].load(std::memory_order_relaxed);
+      }
+    });
+  }
+  this->UpdateProgress(0.4);
+  if (this->CheckAbort())
+  {
+    return 1;
+  }
+
+  // Number the output points, the points merged to themselves.
+  std::vector<vtkIdType> outIds(numUsedPts);
+  vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType rank = begin; rank < end; ++rank)
+    {
+      outIds[rank] = mergeMap[rank] == rank ? 1 : 0;
+    }
+  });
+  const vtkIdType numNewPts =
+    vtkSMPTools::ExclusiveScan(outIds.begin(), outIds.end(), outIds.begin(), vtkIdType(0));
+
+  vtkNew<vtkPoints> newPts;
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    newPts->SetDataType(inPts->GetDataType());
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+  newPts->SetNumberOfPoints(numNewPts);
+  if (!this->PointMerging || globalIds)
+  {
+    outPD->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
+  }
+  outPD->CopyAllocate(inPD, numNewPts);
+  ArrayList pointArrays;
+  pointArrays.AddArrays(numNewPts, inPD, outPD, 0.0, false);
+  vtkSMPTools::For(0, numUsedPts, [&](vtkIdType begin, vtkIdType end) {
+    double x[3];
+    for (vtkIdType rank = begin; rank < end; ++rank)
+    {
+      if (mergeMap[rank] == rank)
+      {
+        usedPts->GetPoint(rank, x);
+        newPts->SetPoint(outIds[rank], x);
+        pointArrays.Copy(usedIds[rank], outIds[rank]);
+      }
+    }
+  });
+
+  // Map the input points to the output points.
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      if (pointMap[ptId] >= 0)
+      {
+        pointMap[ptId] = outIds[mergeMap[pointMap[ptId]]];
+      }
+    }
+  });
+  usedIds = std::vector<vtkIdType>();
+  mergeMap = std::vector<vtkIdType>();
+  outIds = std::vector<vtkIdType>();
+  this->UpdateProgress(0.6);
+
+  // Count the output cells of each kind produced by each block of input
+  // cells. Degenerate cells change kind, but the output cells of a kind
+  // remain in the order of the input cells.
+  std::vector<CleanBlock> blocks;
+  vtkIdType cellId = 0;
+  int maxCellSize = 0;
+  for (int kind = CLEAN_VERT; kind < CLEAN_NUMBER_OF_KINDS; ++kind)
+  {
+    const vtkIdType numCells = inCells[kind]->GetNumberOfCells();
+    for (vtkIdType first = 0; first < numCells; first += CleanBlockSize)
+    {
+      CleanBlock block{ inCells[kind], kind, first, std::min(CleanBlockSize, numCells - first),
+        cellId + first, {}, {} };
+      blocks.push_back(block);
+    }
+    cellId += numCells;
+    if (numCells > 0)
+    {
+      maxCellSize = std::max(maxCellSize, inCells[kind]->GetMaxCellSize());
+    }
+  }
+  const CleanCell clean{ pointMap.data(), this->ConvertLinesToPoints != 0,
+    this->ConvertPolysToLines != 0, this->ConvertStripsToPolys != 0 };
+  vtkSMPTools::For(0, static_cast<vtkIdType>(blocks.size()), [&](vtkIdType begin, vtkIdType end) {
+    std::vector<vtkIdType> newCellPts(maxCellSize);
+    vtkIdType npts, numCellPts;
+    const vtkIdType* pts;
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      CleanBlock& block = blocks[b];
+      auto iter = vtk::TakeSmartPointer(block.Cells->NewIterator());
+      for (vtkIdType c = block.FirstCell; c < block.FirstCell + block.NumberOfCells; ++c)
+      {
+        iter->GetCellAtId(c, npts, pts);
+        const int kind = clean(block.Kind, npts, pts, newCellPts.data(), numCellPts);
+        if (kind != CLEAN_REMOVED)
+        {
+          block.OutputCells[kind]++;
+          block.OutputConnectivity[kind] += numCellPts;
+        }
+      }
+    }
+  });
+
+  // Turn the counts into offsets, the cell data being ordered by kind.
+  vtkIdType numCells[CLEAN_NUMBER_OF_KINDS] = {};
+  vtkIdType connectivitySizes[CLEAN_NUMBER_OF_KINDS] = {};
+  for (CleanBlock& block : blocks)
+  {
+    for (int kind = CLEAN_VERT; kind < CLEAN_NUMBER_OF_KINDS; ++kind)
+    {
+      std::swap(numCells[kind], block.OutputCells[kind]);
+      numCells[kind] += block.OutputCells[kind];
+      std::swap(connectivitySizes[kind], block.OutputConnectivity[kind]);
+      connectivitySizes[kind] += block.OutputConnectivity[kind];
+    }
+  }
+  vtkIdType cellDataStarts[CLEAN_NUMBER_OF_KINDS];
+  vtkIdType numNewCells = 0;
+  vtkSmartPointer<vtkIdTypeArray> offsets[CLEAN_NUMBER_OF_KINDS];
+  vtkSmartPointer<vtkIdTypeArray> connectivity[CLEAN_NUMBER_OF_KINDS];
+  for (int kind = CLEAN_VERT; kind < CLEAN_NUMBER_OF_KINDS; ++kind)
+  {
+    cellDataStarts[kind] = numNewCells;
+    numNewCells += numCells[kind];
+    offsets[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    offsets[kind]->SetNumberOfValues(numCells[kind] + 1);
+    offsets[kind]->SetValue(0, 0);
+    connectivity[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity[kind]->SetNumberOfValues(connectivitySizes[kind]);
+  }
+  outCD->CopyAllOn(vtkDataSetAttributes::COPYTUPLE);
+  outCD->CopyAllocate(inCD, numNewCells);
+  ArrayList cellArrays;
+  cellArrays.AddArrays(numNewCells, inCD, outCD, 0.0, false);
+  this->UpdateProgress(0.8);
+
+  // Produce the output cells.
+  vtkSMPTools::For(0, static_cast<vtkIdType>(blocks.size()), [&](vtkIdType begin, vtkIdType end) {
+    std::vector<vtkIdType> newCellPts(maxCellSize);
+    vtkIdType npts, numCellPts;
+    const vtkIdType* pts;
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      CleanBlock& block = blocks[b];
+      auto iter = vtk::TakeSmartPointer(block.Cells->NewIterator());
+      for (vtkIdType c = 0; c < block.NumberOfCells; ++c)
+      {
+        iter->GetCellAtId(block.FirstCell + c, npts, pts);
+        const int kind = clean(block.Kind, npts, pts, newCellPts.data(), numCellPts);
+        if (kind == CLEAN_REMOVED)
+        {
+          continue;
+        }
+        const vtkIdType newCellId = block.OutputCells[kind]++;
+        vtkIdType& connId = block.OutputConnectivity[kind];
+        std::copy_n(newCellPts.data(), numCellPts, connectivity[kind]->GetPointer(connId));
+        connId += numCellPts;
+        offsets[kind]->SetValue(newCellId + 1, connId);
+        cellArrays.Copy(block.FirstCellId + c, cellDataStarts[kind] + newCellId);
+      }
+    }
+  });
+
+  output->SetPoints(newPts);
+  void (vtkPolyData::*setCells[CLEAN_NUMBER_OF_KINDS])(vtkCellArray*) = { &vtkPolyData::SetVerts,
+    &vtkPolyData::SetLines, &vtkPolyData::SetPolys, &vtkPolyData::SetStrips };
+  for (int kind = CLEAN_VERT; kind < CLEAN_NUMBER_OF_KINDS; ++kind)
+  {
+    if (numCells[kind] > 0 || inCells[kind]->GetNumberOfCells() > 0)
+    {
+      vtkNew<vtkCellArray> cells;
+      cells->SetData(offsets[kind], connectivity[kind]);
+      (output->*setCells[kind])(cells);
+    }
+  }
+
+  vtkDebugMacro(<< "Removed " << numPts - numNewPts << " points and "
+                << input->GetNumberOfCells() - numNewCells << " cells");
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 // Method manages creation of locators. It takes into account the potential
 // change of tolerance (zero to non-zero).
@@ -738,6 +1239,7 @@ void vtkCleanPolyData::PrintSelf(ostream& os, vtkIndent indent)
   }
   os << indent << "PieceInvariant: " << (this->PieceInvariant ? "On\n" : "Off\n");
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "EnableSMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 
 //------------------------------------------------------------------------------
@@ -65,6 +65,17 @@
  * you must add a vtkPolyVertex cell with all of the points to the PolyData
  * (or use a vtkVertexGlyphFilter) before using the vtkCleanPolyData filter.
  *
+ * When EnableSMP is on, a threaded implementation based on vtkSMPTools is
+ * used instead: point merging is done in parallel with a
+ * vtkStaticPointLocator, as in vtkStaticCleanPolyData, and the Locator is not
+ * used. The output is ordered as in the serial implementation: points are
+ * numbered in the order of their first use by the cells, and each merged point
+ * takes the coordinates and the point data of its first used point. With a
+ * zero tolerance or global ids, the output is identical to the serial one.
+ * With a non-zero tolerance, the points within tolerance of several others
+ * may be merged differently. OperateOnPoint() is then called concurrently from
+ * several threads, so subclasses overriding it must be thread safe.
+ *
  * @warning
  * The vtkStaticCleanPolyData filter is similar in operation to
  * vtkCleanPolyData. However, vtkStaticCleanPolyData is non-incremental and
@@ -214,6 +225,20 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded implementation. When on, the Locator is not
+   * used and OperateOnPoint() may be called from several threads at once. The
+   * points and cells keep their serial order, and the output is identical to
+   * the serial one with a zero tolerance or global ids; with a non-zero
+   * tolerance, clusters of nearby points may be merged differently.
+   * Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
 protected:
   vtkCleanPolyData();
   ~vtkCleanPolyData() override;
@@ -222,6 +247,11 @@ protected:
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
   int RequestUpdateExtent(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  /**
+   * Threaded implementation of RequestData(), used when EnableSMP is on.
+   */
+  int RequestDataSMP(vtkPolyData* input, vtkPolyData* output);
+
   vtkTypeBool PointMerging;
   double Tolerance;
   double AbsoluteTolerance;
@@ -233,6 +263,7 @@ protected:
 
   vtkTypeBool PieceInvariant;
   int OutputPointsPrecision;
+  bool EnableSMP;
 
 private:
   vtkCleanPolyData(const vtkCleanPolyData&) = delete;
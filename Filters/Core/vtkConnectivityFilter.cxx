@@ -16,6 +16,7 @@
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkConnectivityFilterInternal.h"
 #include "vtkDataSet.h"
 #include "vtkDemandDrivenPipeline.h"
 #include "vtkFloatArray.h"
@@ -24,10 +25,12 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <map>
@@ -62,6 +65,8 @@ vtkConnectivityFilter::vtkConnectivityFilter()
   this->NewCellScalars = nullptr;
 
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+
+  this->EnableSMP = false;
 }
 
 vtkConnectivityFilter::~vtkConnectivityFilter()
@@ -238,7 +243,11 @@ int vtkConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(request),
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
-  if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+  if (this->EnableSMP)
+  {
+    largestRegionId = this->MarkRegionsSMP(input);
+  }
+  else if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION)
   { // visit all cells marking with region number
@@ -624,6 +633,46 @@ void vtkConnectivityFilter::TraverseAndMark(vtkDataSet* input)
   } // while wave is not empty
 }
 
+//------------------------------------------------------------------------------
+vtkIdType vtkConnectivityFilter::MarkRegionsSMP(vtkDataSet* input)
+{
+  ConnectivityRegions regions(input, this->InScalars, this->ScalarRange, false);
+  this->UpdateProgress(0.3);
+
+  vtkIdType largestRegionId = 0;
+  if (this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS ||
+    this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS)
+  {
+    const bool pointSeeds = this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS;
+    this->RegionSizes->InsertValue(
+      0, regions.LabelSeededRegion(this->Seeds, pointSeeds, this->Visited));
+  }
+  else if (this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION)
+  {
+    vtkNew<vtkIdList> seeds;
+    seeds->InsertNextId(regions.FindClosestPoint(this->ClosestPoint));
+    this->RegionSizes->InsertValue(0, regions.LabelSeededRegion(seeds, true, this->Visited));
+  }
+  else
+  {
+    this->RegionNumber =
+      regions.LabelAllRegions(this->Visited, this->RegionSizes, largestRegionId);
+  }
+  this->UpdateProgress(0.6);
+
+  this->PointNumber = regions.MapPoints(this->Visited, this->PointMap, this->NewScalars);
+  const vtkIdType* visited = this->Visited;
+  vtkIdTypeArray* cellScalars = this->NewCellScalars;
+  vtkSMPTools::For(0, input->GetNumberOfCells(), [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      cellScalars->SetValue(cellId, visited[cellId]);
+    }
+  });
+  this->UpdateProgress(0.9);
+  return largestRegionId;
+}
+
 void vtkConnectivityFilter::OrderRegionIds(
   vtkIdTypeArray* pointRegionIds, vtkIdTypeArray* cellRegionIds)
 {
@@ -782,5 +831,6 @@ void vtkConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   double* range = this->GetScalarRange();
   os << indent << "Scalar Range: (" << range[0] << ", " << range[1] << ")\n";
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "EnableSMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 VTK_ABI_NAMESPACE_END
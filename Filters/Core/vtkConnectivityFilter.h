@@ -50,6 +50,14 @@
  * was processed and has no other significance with respect to the size of
  * or number of cells.
  *
+ * When EnableSMP is on, the regions are labeled using vtkSMPTools: the points
+ * of the connected cells are merged with a lock-free union-find structure
+ * instead of growing each region with a wave of cells. All extraction modes
+ * and scalar connectivity are supported, and the cells get the same region
+ * ids as with the serial implementation, whatever the number of threads.
+ * The output points are ordered like the input points instead of in the
+ * order the regions are traversed.
+ *
  * @sa
  * vtkPolyDataConnectivityFilter
  */
@@ -216,6 +224,19 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded labeling of the regions. All extraction and
+   * region id assignment modes are supported, and the output has the cells,
+   * region ids and region sizes of the serial one whatever the number of
+   * threads, but its points keep the order of the input points rather than
+   * the order in which the regions were traversed. Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
 protected:
   vtkConnectivityFilter();
   ~vtkConnectivityFilter() override;
@@ -244,8 +265,16 @@ protected:
 
   int RegionIdAssignmentMode;
 
+  bool EnableSMP;
+
   void TraverseAndMark(vtkDataSet* input);
 
+  /**
+   * Threaded labeling of the regions, used instead of TraverseAndMark()
+   * when EnableSMP is on. Returns the largest region.
+   */
+  vtkIdType MarkRegionsSMP(vtkDataSet* input);
+
   void OrderRegionIds(vtkIdTypeArray* pointRegionIds, vtkIdTypeArray* cellRegionIds);
 
 private:
@@ -0,0 +1,530 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectivityFilterInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConnectivityFilterInternal
+ * @brief   threaded labeling of connected regions
+ *
+ * vtkConnectivityFilterInternal labels the connected regions of a dataset
+ * with vtkSMPTools, for the threaded implementations of
+ * vtkConnectivityFilter and vtkPolyDataConnectivityFilter. Instead of
+ * growing each region with a wave of cells, the points of the cells that
+ * satisfy the scalar criterion are merged in a lock-free union-find
+ * structure, so that each group of such cells sharing points is identified
+ * by a root point. A region is then made of such a group, and of the cell
+ * that does not satisfy the criterion and that the serial traversal would
+ * have started the region from, if any. Regions are numbered in the order
+ * of their first cell, so that the cells get the same region ids as with
+ * the serial implementation. Output points are numbered in the order of
+ * the input points instead of the order of the traversal.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ *
+ * @sa
+ * vtkConnectivityFilter vtkPolyDataConnectivityFilter
+ */
+
+#ifndef vtkConnectivityFilterInternal_h
+#define vtkConnectivityFilterInternal_h
+
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace
+{ // anonymous namespace
+
+const vtkIdType ConnectivityBlockSize = 65536;
+
+// Lower an atomic value to the given one if it is smaller.
+inline void ConnectivityAtomicMin(std::atomic<vtkIdType>& value, vtkIdType candidate)
+{
+  vtkIdType current = value.load(std::memory_order_relaxed);
+  while (candidate < current &&
+    !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed))
+  {
+  }
+}
+
+// Lock-free union-find over the points. A root is always linked under a
+// smaller root, so that parents are smaller than their children, and the
+// paths are shortened while they are followed.
+class ConnectivityUnionFind
+{
+public:
+  explicit ConnectivityUnionFind(vtkIdType numPts)
+    : Parents(new std::atomic<vtkIdType>[numPts])
+  {
+    std::atomic<vtkIdType>* parents = this->Parents.get();
+    vtkSMPTools::For(0, numPts, [parents](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        parents[ptId].store(ptId, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  vtkIdType Find(vtkIdType ptId)
+  {
+    vtkIdType current = this->Parents[ptId].load(std::memory_order_relaxed);
+    if (current != ptId)
+    {
+      vtkIdType previous = ptId;
+      vtkIdType next;
+      while (current > (next = this->Parents[current].load(std::memory_order_relaxed)))
+      {
+        this->Parents[previous].store(next, std::memory_order_relaxed);
+        previous = current;
+        current = next;
+      }
+    }
+    return current;
+  }
+
+  void Union(vtkIdType ptId0, vtkIdType ptId1)
+  {
+    vtkIdType root0 = this->Find(ptId0);
+    vtkIdType root1 = this->Find(ptId1);
+    while (root0 != root1)
+    {
+      if (root0 < root1)
+      {
+        std::swap(root0, root1);
+      }
+      vtkIdType expected = root0;
+      if (this->Parents[root0].compare_exchange_strong(
+            expected, root1, std::memory_order_relaxed))
+      {
+        return;
+      }
+      // Another thread linked the root first, start again from its new root.
+      root0 = this->Find(expected);
+      root1 = this->Find(root1);
+    }
+  }
+
+private:
+  std::unique_ptr<std::atomic<vtkIdType>[]> Parents;
+};
+
+// Label the connected regions of a dataset. The cells that satisfy the
+// scalar criterion (all cells without scalars) are connected to the cells
+// that share one of their points. The other cells do not propagate regions,
+// as in the serial traversal, where they are only reached as seeds.
+class ConnectivityRegions
+{
+public:
+  ConnectivityRegions(vtkDataSet* mesh, vtkDataArray* scalars, const double scalarRange[2],
+    bool fullScalarConnectivity)
+    : Mesh(mesh)
+    , NumberOfPoints(mesh->GetNumberOfPoints())
+    , NumberOfCells(mesh->GetNumberOfCells())
+    , UnionFind(mesh->GetNumberOfPoints())
+    , CellRoots(mesh->GetNumberOfCells())
+    , Claims(new std::atomic<vtkIdType>[mesh->GetNumberOfPoints()])
+  {
+    // Build the cells, if needed, before accessing them from several threads.
+    vtkNew<vtkIdList> ptIds;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    mesh->GetCellPoints(0, npts, pts, ptIds);
+
+    // Merge the points of the connected cells, then record the root of each
+    // one of these cells, or -1 for the other cells.
+    vtkSMPTools::For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* cellPtIds = this->CellPointIds.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        vtkIdType numCellPts;
+        const vtkIdType* cellPts;
+        this->Mesh->GetCellPoints(cellId, numCellPts, cellPts, cellPtIds);
+        const bool connected = numCellPts > 0 &&
+          (!scalars ||
+            IsScalarConnected(scalars, scalarRange, fullScalarConnectivity, numCellPts, cellPts));
+        for (vtkIdType i = 1; connected && i < numCellPts; ++i)
+        {
+          this->UnionFind.Union(cellPts[0], cellPts[i]);
+        }
+        this->CellRoots[cellId] = connected ? cellPts[0] : -1;
+      }
+    });
+    vtkSMPTools::For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (this->CellRoots[cellId] >= 0)
+        {
+          this->CellRoots[cellId] = this->UnionFind.Find(this->CellRoots[cellId]);
+        }
+      }
+    });
+  }
+
+  /**
+   * Label all cells with the number of their region, like the serial
+   * traversal of all cells: each cell that does not satisfy the scalar
+   * criterion starts a region, together with the groups of connected cells
+   * sharing its points that no smaller cell reached first. Fill the region
+   * sizes and return the number of regions.
+   */
+  vtkIdType LabelAllRegions(
+    vtkIdType* cellRegions, vtkIdTypeArray* regionSizes, vtkIdType& largestRegionId)
+  {
+    // Each group of connected cells is claimed by its smallest cell, or by
+    // the smallest other cell sharing one of its points.
+    this->ResetClaims();
+    vtkSMPTools::For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* cellPtIds = this->CellPointIds.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (this->CellRoots[cellId] >= 0)
+        {
+          ConnectivityAtomicMin(this->Claims[this->CellRoots[cellId]], cellId);
+          continue;
+        }
+        vtkIdType npts;
+        const vtkIdType* pts;
+        this->Mesh->GetCellPoints(cellId, npts, pts, cellPtIds);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          ConnectivityAtomicMin(this->Claims[this->UnionFind.Find(pts[i])], cellId);
+        }
+      }
+    });
+
+    // The first cell of a region is the one it is claimed by, number these
+    // cells in order.
+    auto firstCell = [this](vtkIdType cellId) {
+      const vtkIdType root = this->CellRoots[cellId];
+      return root >= 0 ? this->Claims[root].load(std::memory_order_relaxed) : cellId;
+    };
+    const vtkIdType numBlocks =
+      (this->NumberOfCells + ConnectivityBlockSize - 1) / ConnectivityBlockSize;
+    std::vector<vtkIdType> starts(numBlocks);
+    vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+      for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+        const vtkIdType end = std::min(this->NumberOfCells, (block + 1) * ConnectivityBlockSize);
+        vtkIdType count = 0;
+        for (vtkIdType cellId = block * ConnectivityBlockSize; cellId < end; ++cellId)
+        {
+          count += firstCell(cellId) == cellId;
+        }
+        starts[block] = count;
+      }
+    });
+    const vtkIdType numRegions =
+      vtkSMPTools::ExclusiveScan(starts.begin(), starts.end(), starts.begin(), vtkIdType(0));
+    vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+      for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+        const vtkIdType end = std::min(this->NumberOfCells, (block + 1) * ConnectivityBlockSize);
+        vtkIdType regionId = starts[block];
+        for (vtkIdType cellId = block * ConnectivityBlockSize; cellId < end; ++cellId)
+        {
+          if (firstCell(cellId) == cellId)
+          {
+            cellRegions[cellId] = regionId++;
+          }
+        }
+      }
+    });
+
+    // Label the other cells and count the cells of each region. Consecutive
+    // cells are usually in the same region, count them before adding them.
+    std::unique_ptr<std::atomic<vtkIdType>[]> sizes(new std::atomic<vtkIdType>[numRegions]());
+    vtkSMPTools::For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdType currentRegion = -1;
+      vtkIdType count = 0;
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const vtkIdType first = firstCell(cellId);
+        const vtkIdType regionId = cellRegions[first];
+        if (first != cellId)
+        {
+          cellRegions[cellId] = regionId;
+        }
+        if (regionId != currentRegion)
+        {
+          if (count > 0)
+          {
+            sizes[currentRegion].fetch_add(count, std::memory_order_relaxed);
+          }
+          currentRegion = regionId;
+          count = 0;
+        }
+        ++count;
+      }
+      if (count > 0)
+      {
+        sizes[currentRegion].fetch_add(count, std::memory_order_relaxed);
+      }
+    });
+
+    // The largest region is the first one with the most cells.
+    regionSizes->SetNumberOfValues(numRegions);
+    vtkIdType maxCellsInRegion = 0;
+    largestRegionId = 0;
+    for (vtkIdType regionId = 0; regionId < numRegions; ++regionId)
+    {
+      const vtkIdType size = sizes[regionId].load(std::memory_order_relaxed);
+      regionSizes->SetValue(regionId, size);
+      if (size > maxCellsInRegion)
+      {
+        maxCellsInRegion = size;
+        largestRegionId = regionId;
+      }
+    }
+    return numRegions;
+  }
+
+  /**
+   * Label the cells of the region grown from the seed cells, or from the
+   * cells using the seed points, with 0 and the other cells with -1. Return
+   * the number of cells in the region.
+   */
+  vtkIdType LabelSeededRegion(vtkIdList* seeds, bool pointSeeds, vtkIdType* cellRegions)
+  {
+    const vtkIdType numSeedIds = pointSeeds ? this->NumberOfPoints : this->NumberOfCells;
+    std::vector<unsigned char> isSeed(numSeedIds, 0);
+    for (vtkIdType i = 0; i < seeds->GetNumberOfIds(); ++i)
+    {
+      const vtkIdType seedId = seeds->GetId(i);
+      if (seedId >= 0 && seedId < numSeedIds)
+      {
+        isSeed[seedId] = 1;
+      }
+    }
+
+    // Mark the seed cells, and the groups of connected cells that they
+    // contain or share a point with.
+    this->ResetClaims();
+    vtkSMPTools::For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* cellPtIds = this->CellPointIds.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        vtkIdType npts;
+        const vtkIdType* pts;
+        this->Mesh->GetCellPoints(cellId, npts, pts, cellPtIds);
+        bool seed = !pointSeeds && isSeed[cellId];
+        for (vtkIdType i = 0; !seed && pointSeeds && i < npts; ++i)
+        {
+          seed = isSeed[pts[i]] != 0;
+        }
+        cellRegions[cellId] = seed ? 0 : -1;
+        if (seed && this->CellRoots[cellId] >= 0)
+        {
+          this->Claims[this->CellRoots[cellId]].store(0, std::memory_order_relaxed);
+        }
+        else if (seed)
+        {
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            this->Claims[this->UnionFind.Find(pts[i])].store(0, std::memory_order_relaxed);
+          }
+        }
+      }
+    });
+
+    vtkSMPThreadLocal<vtkIdType> counts(0);
+    vtkSMPTools::For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdType& count = counts.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const vtkIdType root = this->CellRoots[cellId];
+        if (cellRegions[cellId] < 0 && root >= 0 &&
+          this->Claims[root].load(std::memory_order_relaxed) == 0)
+        {
+          cellRegions[cellId] = 0;
+        }
+        count += cellRegions[cellId] == 0;
+      }
+    });
+    vtkIdType numCellsInRegion = 0;
+    for (vtkIdType count : counts)
+    {
+      numCellsInRegion += count;
+    }
+    return numCellsInRegion;
+  }
+
+  /**
+   * Return the point closest to x, the first one in case of a tie.
+   */
+  vtkIdType FindClosestPoint(const double x[3])
+  {
+    struct ClosestPoint
+    {
+      double Distance2 = VTK_DOUBLE_MAX;
+      vtkIdType PointId = 0;
+    };
+    vtkSMPThreadLocal<ClosestPoint> closest;
+    vtkSMPTools::For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      ClosestPoint& local = closest.Local();
+      double p[3];
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Mesh->GetPoint(ptId, p);
+        const double dist2 = vtkMath::Distance2BetweenPoints(p, x);
+        if (dist2 < local.Distance2 || (dist2 == local.Distance2 && ptId < local.PointId))
+        {
+          local.Distance2 = dist2;
+          local.PointId = ptId;
+        }
+      }
+    });
+    ClosestPoint result;
+    for (const ClosestPoint& local : closest)
+    {
+      if (local.Distance2 < result.Distance2 ||
+        (local.Distance2 == result.Distance2 && local.PointId < result.PointId))
+      {
+        result = local;
+      }
+    }
+    return result.PointId;
+  }
+
+  /**
+   * Number the points used by the labeled cells in order, in pointMap, and
+   * set the region of each one to the smallest region of the cells using
+   * it, as the first one visiting the point in the serial traversal. Other
+   * points are mapped to -1. Return the number of points numbered.
+   */
+  vtkIdType MapPoints(
+    const vtkIdType* cellRegions, vtkIdType* pointMap, vtkIdTypeArray* pointRegions)
+  {
+    const vtkIdType unused = VTK_ID_MAX;
+    vtkSMPTools::For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Claims[ptId].store(unused, std::memory_order_relaxed);
+      }
+    });
+    vtkSMPTools::For(0, this->NumberOfCells, [&](vtkIdType begin, vtkIdType end) {
+      vtkIdList* cellPtIds = this->CellPointIds.Local();
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (cellRegions[cellId] < 0)
+        {
+          continue;
+        }
+        vtkIdType npts;
+        const vtkIdType* pts;
+        this->Mesh->GetCellPoints(cellId, npts, pts, cellPtIds);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          ConnectivityAtomicMin(this->Claims[pts[i]], cellRegions[cellId]);
+        }
+      }
+    });
+
+    const vtkIdType numBlocks =
+      (this->NumberOfPoints + ConnectivityBlockSize - 1) / ConnectivityBlockSize;
+    std::vector<vtkIdType> starts(numBlocks);
+    vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+      for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+        const vtkIdType end = std::min(this->NumberOfPoints, (block + 1) * ConnectivityBlockSize);
+        vtkIdType count = 0;
+        for (vtkIdType ptId = block * ConnectivityBlockSize; ptId < end; ++ptId)
+        {
+          count += this->Claims[ptId].load(std::memory_order_relaxed) != unused;
+        }
+        starts[block] = count;
+      }
+    });
+    const vtkIdType numUsedPts =
+      vtkSMPTools::ExclusiveScan(starts.begin(), starts.end(), starts.begin(), vtkIdType(0));
+    vtkSMPTools::For(0, numBlocks, [&](vtkIdType beginBlock, vtkIdType endBlock) {
+      for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+        const vtkIdType end = std::min(this->NumberOfPoints, (block + 1) * ConnectivityBlockSize);
+        vtkIdType newPtId = starts[block];
+        for (vtkIdType ptId = block * ConnectivityBlockSize; ptId < end; ++ptId)
+        {
+          const vtkIdType regionId = this->Claims[ptId].load(std::memory_order_relaxed);
+          if (regionId == unused)
+          {
+            pointMap[ptId] = -1;
+            continue;
+          }
+          pointRegions->SetValue(newPtId, regionId);
+          pointMap[ptId] = newPtId++;
+        }
+      }
+    });
+    return numUsedPts;
+  }
+
+private:
+  // Like the serial implementation, compare the first component of the
+  // scalars in single precision.
+  static bool IsScalarConnected(vtkDataArray* scalars, const double scalarRange[2],
+    bool fullScalarConnectivity, vtkIdType npts, const vtkIdType* pts)
+  {
+    double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      const double s = static_cast<float>(scalars->GetComponent(pts[i], 0));
+      range[0] = std::min(range[0], s);
+      range[1] = std::max(range[1], s);
+    }
+    if (fullScalarConnectivity)
+    {
+      return range[0] >= scalarRange[0] && range[1] <= scalarRange[1];
+    }
+    return range[1] >= scalarRange[0] && range[0] <= scalarRange[1];
+  }
+
+  void ResetClaims()
+  {
+    const vtkIdType numCells = this->NumberOfCells;
+    vtkSMPTools::For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Claims[ptId].store(numCells, std::memory_order_relaxed);
+      }
+    });
+  }
+
+  vtkDataSet* Mesh;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  ConnectivityUnionFind UnionFind;
+  // The root point of each cell satisfying the scalar criterion, -1 otherwise.
+  std::vector<vtkIdType> CellRoots;
+  // Per root point, the first cell of the region of its group of cells.
+  std::unique_ptr<std::atomic<vtkIdType>[]> Claims;
+  vtkSMPThreadLocalObject<vtkIdList> CellPointIds;
+};
+
+} // anonymous namespace
+
+#endif // vtkConnectivityFilterInternal_h
+// VTK-HeaderTest-Exclude: vtkConnectivityFilterInternal.h
@@ -15,6 +15,8 @@
 #include "vtkCutter.h"
 
 #include "vtk3DLinearGridPlaneCutter.h"
+#include "vtkBatchMerger.h"
+#include "vtkBoundingBox.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
@@ -26,11 +28,13 @@
 #include "vtkFloatArray.h"
 #include "vtkGenericCell.h"
 #include "vtkGridSynchronizedTemplates3D.h"
+#include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkImplicitFunction.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMemoryArena.h"
 #include "vtkMergePoints.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
@@ -40,21 +44,56 @@
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridBase.h"
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 VTK_ABI_NAMESPACE_BEGIN
 vtkObjectFactoryNewMacro(vtkCutter);
 vtkCxxSetObjectMacro(vtkCutter, CutFunction, vtkImplicitFunction);
 vtkCxxSetObjectMacro(vtkCutter, Locator, vtkIncrementalPointLocator);
 
+//------------------------------------------------------------------------------
+namespace
+{
+// Number of input cells cut together by DataSetCutterSMP().
+const vtkIdType CellsPerBatch = 1024;
+
+// The output of a batch of cells, cut with its own locator. Verts, lines and
+// polys are indexed by their dimension, and each output cell records the
+// input cell it comes from.
+struct CutterBatch
+{
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkPointData> PointData;
+  vtkSmartPointer<vtkCellArray> Cells[3];
+  std::vector<vtkIdType> CellIds[3];
+};
+
+// Per-thread temporaries of DataSetCutterSMP().
+struct CutterLocal
+{
+  vtkSmartPointer<vtkGenericCell> Cell;
+  vtkSmartPointer<vtkDoubleArray> CellScalars;
+  vtkSmartPointer<vtkIdList> PointIds;
+  vtkSmartPointer<vtkIncrementalPointLocator> Locator;
+  // Empty cell data: the cell data is copied once all the batches are merged.
+  vtkSmartPointer<vtkCellData> InCD;
+  vtkSmartPointer<vtkCellData> OutCD;
+  std::vector<vtkIdType> CutCells;
+};
+}
+
 //------------------------------------------------------------------------------
 // Construct with user-specified implicit function; initial value of 0.0; and
 // generating cut scalars turned off.
@@ -67,6 +106,7 @@ vtkCutter::vtkCutter(vtkImplicitFunction* cf)
   this->Locator = nullptr;
   this->GenerateTriangles = 1;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->EnableSMP = false;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->SynchronizedTemplates3D->SetContainerAlgorithm(this);
@@ -362,6 +402,13 @@ int vtkCutter::RequestData(
     this->PlaneCutter->Update();
     output->ShallowCopy(this->PlaneCutter->GetOutput());
   };
+  // The threaded implementation merges points like vtkMergePoints, or not at all.
+  if (this->EnableSMP && this->Locator == nullptr)
+  {
+    this->CreateDefaultLocator();
+  }
+  const bool useSMP = this->EnableSMP &&
+    (this->Locator->IsA("vtkMergePoints") || this->Locator->IsA("vtkNonMergingPointLocator"));
   if (vtkImageData::SafeDownCast(input) &&
     static_cast<vtkImageData*>(input)->GetDataDimension() == 3)
   {
@@ -373,7 +420,14 @@ int vtkCutter::RequestData(
     {
       if (input->GetDataObjectType() == VTK_UNIFORM_GRID)
       {
-        this->DataSetCutter(input, output);
+        if (useSMP)
+        {
+          this->DataSetCutterSMP(input, output);
+        }
+        else
+        {
+          this->DataSetCutter(input, output);
+        }
       }
       else
       {
@@ -412,6 +466,10 @@ int vtkCutter::RequestData(
     {
       executePlaneCutter();
     }
+    else if (useSMP && vtkUnstructuredGrid::SafeDownCast(input))
+    {
+      this->DataSetCutterSMP(input, output);
+    }
     else
     {
       this->UnstructuredGridCutter(input, output);
@@ -424,11 +482,19 @@ int vtkCutter::RequestData(
     {
       executePlaneCutter();
     }
+    else if (useSMP)
+    {
+      this->DataSetCutterSMP(input, output);
+    }
     else
     {
       this->DataSetCutter(input, output);
     }
   }
+  else if (useSMP)
+  {
+    this->DataSetCutterSMP(input, output);
+  }
   else
   {
     this->DataSetCutter(input, output);
@@ -1037,6 +1103,237 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet* input, vtkPolyData* output)
   output->Squeeze();
 }
 
+//------------------------------------------------------------------------------
+// The cells are visited in the serial order: by dimension then by cell when
+// sorting by value, by contour value then by cell when sorting by cell. This
+// sequence is split in batches of consecutive cells, cut concurrently, each
+// with its own locator. The points of the batches are then merged, keeping
+// the first of the coincident points, and numbered in their order of first
+// insertion, which is the order of the serial implementation.
+void vtkCutter::DataSetCutterSMP(vtkDataSet* input, vtkPolyData* output)
+{
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const int numContours = this->ContourValues->GetNumberOfContours();
+  const double* values = this->ContourValues->GetValues();
+  const bool mergePoints = !this->Locator->IsA("vtkNonMergingPointLocator");
+  vtkCellData* inCD = input->GetCellData();
+  vtkCellData* outCD = output->GetCellData();
+
+  int pointsType = VTK_FLOAT;
+  vtkPointSet* inputPointSet = vtkPointSet::SafeDownCast(input);
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION && inputPointSet)
+  {
+    pointsType = inputPointSet->GetPoints()->GetDataType();
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    pointsType = VTK_DOUBLE;
+  }
+
+  // Evaluate the cut function at each point. Implicit functions are not
+  // required to be thread safe, so this is done serially.
+  vtkNew<vtkDoubleArray> cutScalars;
+  cutScalars->SetNumberOfTuples(numPts);
+  if (inputPointSet)
+  {
+    this->CutFunction->FunctionValue(inputPointSet->GetPoints()->GetData(), cutScalars);
+  }
+  else
+  {
+    for (vtkIdType i = 0; i < numPts; ++i)
+    {
+      double x[3];
+      input->GetPoint(i, x);
+      cutScalars->SetValue(i, this->CutFunction->FunctionValue(x));
+    }
+  }
+
+  // Interpolate data along edge. If generating cut scalars, do necessary setup
+  vtkSmartPointer<vtkPointData> inPD = input->GetPointData();
+  if (this->GenerateCutScalars)
+  {
+    inPD = vtkSmartPointer<vtkPointData>::New();
+    inPD->ShallowCopy(input->GetPointData()); // copies original attributes
+    inPD->SetScalars(cutScalars);
+  }
+
+  unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+  const bool sortByValue = this->SortBy == VTK_SORT_BY_VALUE;
+  const vtkIdType numPasses = sortByValue ? 3 : numContours;
+  const vtkIdType batchesPerPass = (numCells + CellsPerBatch - 1) / CellsPerBatch;
+  const vtkIdType numBatches = numPasses * batchesPerPass;
+  std::vector<CutterBatch> batches(numBatches);
+
+  // Build the cells of the input before threading.
+  if (numCells > 0)
+  {
+    vtkNew<vtkGenericCell> cell;
+    input->GetCell(0, cell);
+  }
+
+  vtkSMPThreadLocal<CutterLocal> threadLocals;
+  vtkIncrementalPointLocator* locator = this->Locator;
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end) {
+    CutterLocal& local = threadLocals.Local();
+    if (!local.Cell)
+    {
+      local.Cell = vtkSmartPointer<vtkGenericCell>::New();
+      local.Cell->SetArena(vtkMemoryArena::GetThreadLocalArena());
+      local.CellScalars = vtkSmartPointer<vtkDoubleArray>::New();
+      local.PointIds = vtkSmartPointer<vtkIdList>::New();
+      local.PointIds->SetArena(vtkMemoryArena::GetThreadLocalArena());
+      local.Locator = vtk::TakeSmartPointer(locator->NewInstance());
+      local.InCD = vtkSmartPointer<vtkCellData>::New();
+      local.OutCD = vtkSmartPointer<vtkCellData>::New();
+    }
+    for (vtkIdType batchId = begin; batchId < end; ++batchId)
+    {
+      // The point ids of the cells of the batch are allocated from the arena
+      // of the thread, and released at once when the batch is done.
+      vtkMemoryArena::Scope scope;
+      const vtkIdType pass = batchId / batchesPerPass;
+      const vtkIdType firstCell = (batchId % batchesPerPass) * CellsPerBatch;
+      const vtkIdType lastCell = std::min(firstCell + CellsPerBatch, numCells);
+      const double* passValues = sortByValue ? values : values + pass;
+      const double* passValuesEnd = sortByValue ? values + numContours : values + pass + 1;
+
+      // Find the cells crossed by a contour value, and their bounds.
+      vtkBoundingBox bounds;
+      local.CutCells.clear();
+      for (vtkIdType cellId = firstCell; cellId < lastCell; ++cellId)
+      {
+        if (sortByValue)
+        {
+          // We skip 0d cells (points), because they cannot be cut.
+          const int cellType = input->GetCellType(cellId);
+          if (cellType >= VTK_NUMBER_OF_CELL_TYPES || cellTypeDimensions[cellType] != pass + 1)
+          {
+            continue;
+          }
+        }
+        input->GetCellPoints(cellId, local.PointIds);
+        const vtkIdType numCellPts = local.PointIds->GetNumberOfIds();
+        if (numCellPts == 0)
+        {
+          continue;
+        }
+        double range[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+        for (vtkIdType i = 0; i < numCellPts; ++i)
+        {
+          const double scalar = cutScalars->GetValue(local.PointIds->GetId(i));
+          range[0] = std::min(range[0], scalar);
+          range[1] = std::max(range[1], scalar);
+        }
+        if (std::none_of(passValues, passValuesEnd,
+              [&range](double value) { return value >= range[0] && value <= range[1]; }))
+        {
+          continue;
+        }
+        local.CutCells.push_back(cellId);
+        for (vtkIdType i = 0; i < numCellPts; ++i)
+        {
+          double x[3];
+          input->GetPoint(local.PointIds->GetId(i), x);
+          bounds.AddPoint(x);
+        }
+      }
+      if (local.CutCells.empty())
+      {
+        continue;
+      }
+
+      CutterBatch& batch = batches[batchId];
+      const vtkIdType estimatedSize =
+        static_cast<vtkIdType>(local.CutCells.size()) * (passValuesEnd - passValues);
+      batch.Points = vtkSmartPointer<vtkPoints>::New();
+      batch.Points->SetDataType(pointsType);
+      batch.Points->Allocate(estimatedSize);
+      batch.PointData = vtkSmartPointer<vtkPointData>::New();
+      batch.PointData->InterpolateAllocate(inPD, estimatedSize);
+      for (int dim = 0; dim < 3; ++dim)
+      {
+        batch.Cells[dim] = vtkSmartPointer<vtkCellArray>::New();
+      }
+      double batchBounds[6];
+      bounds.Inflate();
+      bounds.GetBounds(batchBounds);
+      local.Locator->InitPointInsertion(batch.Points, batchBounds, estimatedSize);
+      vtkContourHelper helper(local.Locator, batch.Cells[0], batch.Cells[1], batch.Cells[2], inPD,
+        local.InCD, batch.PointData, local.OutCD, static_cast<int>(estimatedSize),
+        this->GenerateTriangles != 0);
+
+      for (vtkIdType cellId : local.CutCells)
+      {
+        input->GetCell(cellId, local.Cell);
+        input->SetCellOrderAndRationalWeights(cellId, local.Cell);
+        local.CellScalars->SetNumberOfTuples(local.Cell->GetPointIds()->GetNumberOfIds());
+        cutScalars->GetTuples(local.Cell->GetPointIds(), local.CellScalars);
+        for (const double* value = passValues; value != passValuesEnd; ++value)
+        {
+          helper.Contour(local.Cell, *value, local.CellScalars, cellId);
+        }
+        for (int dim = 0; dim < 3; ++dim)
+        {
+          batch.CellIds[dim].resize(batch.Cells[dim]->GetNumberOfCells(), cellId);
+        }
+      }
+      local.Locator->Initialize();
+    }
+  });
+  this->UpdateProgress(0.8);
+
+  std::vector<CutterBatch*> parts;
+  std::vector<vtkPoints*> partPoints;
+  std::vector<vtkPointData*> partPD;
+  for (CutterBatch& batch : batches)
+  {
+    if (batch.Points)
+    {
+      parts.push_back(&batch);
+      partPoints.push_back(batch.Points);
+      partPD.push_back(batch.PointData);
+    }
+  }
+
+  // Merge the points of the parts, then their cells by dimension, each cell
+  // taking the cell data of the input cell it comes from.
+  vtkBatchMerger merger;
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(pointsType);
+  merger.MergePoints(partPoints, partPD, inPD, mergePoints, newPts, output->GetPointData());
+  output->SetPoints(newPts);
+
+  vtkSmartPointer<vtkCellArray> newCells[3];
+  std::vector<const std::vector<vtkIdType>*> sourceCells;
+  for (int dim = 0; dim < 3; ++dim)
+  {
+    std::vector<vtkCellArray*> partCells;
+    for (CutterBatch* part : parts)
+    {
+      partCells.push_back(part->Cells[dim]);
+      sourceCells.push_back(&part->CellIds[dim]);
+    }
+    newCells[dim] = merger.MergeCells(partCells);
+  }
+  vtkBatchMerger::CopyCellData(sourceCells, inCD, outCD);
+
+  if (newCells[0]->GetNumberOfCells())
+  {
+    output->SetVerts(newCells[0]);
+  }
+  if (newCells[1]->GetNumberOfCells())
+  {
+    output->SetLines(newCells[1]);
+  }
+  if (newCells[2]->GetNumberOfCells())
+  {
+    output->SetPolys(newCells[2]);
+  }
+  output->Squeeze();
+}
+
 //------------------------------------------------------------------------------
 // Specify a spatial locator for merging points. By default,
 // an instance of vtkMergePoints is used.
@@ -1088,5 +1385,6 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Generate Cut Scalars: " << (this->GenerateCutScalars ? "On\n" : "Off\n");
 
   os << indent << "Precision of the output points: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 VTK_ABI_NAMESPACE_END
@@ -42,6 +42,17 @@
  * it's specialized for planes and it's faster because it's multithreaded, and in some
  * cases also algorithmically faster.
  *
+ * When EnableSMP is on, unstructured grids, polygonal data and the other
+ * datasets without a specialized implementation are cut using vtkSMPTools.
+ * The cells are cut in batches, each with its own point locator and output,
+ * and the batches are merged in the order of the cells: coincident points are
+ * merged like vtkMergePoints does, keeping the first of them. The output is
+ * then the same as the serial one, whatever the number of threads, except
+ * that with GenerateTriangles off, the polygons cut from 3D cells may start
+ * at another of their vertices. Cell data follows the order of the output
+ * cells. The threaded implementation is only used with a vtkMergePoints (the
+ * default) or a vtkNonMergingPointLocator.
+ *
  * @sa
  * vtkImplicitFunction vtkClipPolyData vtkPlaneCutter
  */
@@ -225,6 +236,20 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded cutting of unstructured grids, polygonal data
+   * and uniform grids. Both SortBy orders are kept and the output does not
+   * depend on the number of threads; only the first vertex of the polygons
+   * cut from 3D cells may change when GenerateTriangles is off. Other
+   * locators than vtkMergePoints and vtkNonMergingPointLocator fall back to
+   * the serial implementation. Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
 protected:
   vtkCutter(vtkImplicitFunction* cf = nullptr);
   ~vtkCutter() override;
@@ -238,6 +263,13 @@ protected:
     vtkDataSet*, vtkPolyData*, vtkInformation*, vtkInformationVector**, vtkInformationVector*);
   void StructuredGridCutter(vtkDataSet*, vtkPolyData*);
   void RectilinearGridCutter(vtkDataSet*, vtkPolyData*);
+
+  /**
+   * Threaded implementation of DataSetCutter() and UnstructuredGridCutter(),
+   * used when EnableSMP is on.
+   */
+  void DataSetCutterSMP(vtkDataSet* input, vtkPolyData* output);
+
   vtkImplicitFunction* CutFunction;
   vtkTypeBool GenerateTriangles;
 
@@ -252,6 +284,7 @@ protected:
   vtkContourValues* ContourValues;
   vtkTypeBool GenerateCutScalars;
   int OutputPointsPrecision;
+  bool EnableSMP;
 
 private:
   vtkCutter(const vtkCutter&) = delete;
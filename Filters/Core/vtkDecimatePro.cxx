@@ -16,18 +16,30 @@
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDataSetAttributesFieldList.h"
 #include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkLine.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkDecimatePro);
 
@@ -49,6 +61,12 @@ vtkStandardNewMacro(vtkDecimatePro);
 #define VTK_STATE_SPLIT 1
 #define VTK_STATE_SPLIT_ALL 2
 
+#define VTK_MIN_TRIS_PER_PARTITION 2500
+#define VTK_MAX_PARTITIONS 256
+#define VTK_UNUSED_POINT -1
+#define VTK_SHARED_POINT -2
+#define VTK_FROZEN_IDS_NAME "vtkDecimateProFrozenIds"
+
 // Helper functions
 static double ComputeSimpleError(double x[3], double normal[3], double point[3]);
 static double ComputeEdgeError(double x[3], double x1[3], double x2[3]);
@@ -85,6 +103,9 @@ vtkDecimatePro::vtkDecimatePro()
   this->BoundaryVertexDeletion = 1;
   this->InflectionPointRatio = 10.0;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->EnableSMP = false;
+  this->NumberOfFrozenPoints = 0;
+  this->NumberOfPops = 0;
 
   this->Queue = nullptr;
   this->VertexError = nullptr;
@@ -125,6 +146,21 @@ int vtkDecimatePro::RequestData(vtkInformation* vtkNotUsed(request),
   vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
   vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
+  if (!input)
+  {
+    vtkErrorMacro(<< "No input!");
+    return 1;
+  }
+  if (this->EnableSMP)
+  {
+    return this->RequestDataSMP(input, output);
+  }
+  return this->Decimate(input, output);
+}
+
+//------------------------------------------------------------------------------
+int vtkDecimatePro::Decimate(vtkPolyData* input, vtkPolyData* output)
+{
   vtkIdType i, ptId, numPts, numTris, collapseId;
   vtkPoints* inPts;
   vtkPoints* newPts;
@@ -140,11 +176,6 @@ int vtkDecimatePro::RequestData(vtkInformation* vtkNotUsed(request),
   vtkIdType* cells;
   vtkIdList* CollapseTris;
   double max;
-  if (!input)
-  {
-    vtkErrorMacro(<< "No input!");
-    return 1;
-  }
   vtkPointData* outputPD = output->GetPointData();
   vtkPointData* inPD = input->GetPointData();
   vtkPointData* meshPD = nullptr;
@@ -155,6 +186,7 @@ int vtkDecimatePro::RequestData(vtkInformation* vtkNotUsed(request),
   vtkDebugMacro(<< "Executing progressive decimation...");
 
   // Check input
+  this->NumberOfPops = 0;
   this->NumberOfRemainingTris = numTris = input->GetNumberOfPolys();
   if (((numPts = input->GetNumberOfPoints()) < 1 || numTris < 1) && (this->TargetReduction > 0.0))
   {
@@ -355,6 +387,7 @@ int vtkDecimatePro::RequestData(vtkInformation* vtkNotUsed(request),
   }   // while queue not empty and reduction not satisfied
 
   CollapseTris->Delete();
+  this->NumberOfPops = numPops;
 
   totalPts = this->Mesh->GetNumberOfPoints();
   vtkDebugMacro(<< "\n\tReduction " << reduction << " (" << numTris << " to "
@@ -436,6 +469,385 @@ int vtkDecimatePro::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//------------------------------------------------------------------------------
+// Decimate partitions of the mesh concurrently, the points shared by several
+// partitions being frozen, then decimate the merged partitions serially to
+// remove the seams. The partitions only depend on the mesh, so does the output.
+//
+int vtkDecimatePro::RequestDataSMP(vtkPolyData* input, vtkPolyData* output)
+{
+  vtkPoints* inPts = input->GetPoints();
+  vtkCellArray* inPolys = input->GetPolys();
+  vtkPointData* inPD = input->GetPointData();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numTris = input->GetNumberOfPolys();
+  const vtkIdType numPartitions =
+    std::min<vtkIdType>(numTris / VTK_MIN_TRIS_PER_PARTITION, VTK_MAX_PARTITIONS);
+
+  this->InflectionPoints->Initialize();
+
+  // Small meshes and invalid inputs are left to the serial implementation.
+  if (this->TargetReduction <= 0.0 || numPartitions < 2 || inPolys->IsHomogeneous() != 3)
+  {
+    return this->Decimate(input, output);
+  }
+
+  vtkDebugMacro(<< "Executing threaded progressive decimation...");
+
+  // The error is bounded relative to the whole mesh, not to the partitions.
+  const double* bounds = input->GetBounds();
+  double max = 0.0;
+  for (int i = 0; i < 3; i++)
+  {
+    max = std::max(max, bounds[2 * i + 1] - bounds[2 * i]);
+  }
+  double error;
+  if (!this->ErrorIsAbsolute)
+  {
+    error = (this->MaximumError >= VTK_DOUBLE_MAX ? VTK_DOUBLE_MAX : this->MaximumError * max);
+  }
+  else
+  {
+    error = (this->AbsoluteError >= VTK_DOUBLE_MAX ? VTK_DOUBLE_MAX : this->AbsoluteError);
+  }
+  auto newDecimate = [this, error](double targetReduction) {
+    vtkSmartPointer<vtkDecimatePro> decimate = vtkSmartPointer<vtkDecimatePro>::New();
+    decimate->TargetReduction = targetReduction;
+    decimate->FeatureAngle = this->FeatureAngle;
+    decimate->ErrorIsAbsolute = 1;
+    decimate->AbsoluteError = error;
+    decimate->AccumulateError = this->AccumulateError;
+    decimate->SplitAngle = this->SplitAngle;
+    decimate->Splitting = this->Splitting;
+    decimate->PreSplitMesh = this->PreSplitMesh;
+    decimate->BoundaryVertexDeletion = this->BoundaryVertexDeletion;
+    decimate->PreserveTopology = this->PreserveTopology;
+    decimate->Degree = this->Degree;
+    decimate->InflectionPointRatio = this->InflectionPointRatio;
+    decimate->OutputPointsPrecision = this->OutputPointsPrecision;
+    return decimate;
+  };
+
+  // Partition the triangles by the buckets of a locator on their centers.
+  vtkNew<vtkPoints> centers;
+  centers->SetDataTypeToDouble();
+  centers->SetNumberOfPoints(numTris);
+  vtkSMPTools::For(0, numTris, [&](vtkIdType begin, vtkIdType end) {
+    vtkNew<vtkIdList> tempIds;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double x[3], center[3];
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+    {
+      inPolys->GetCellAtId(cellId, npts, pts, tempIds);
+      center[0] = center[1] = center[2] = 0.0;
+      for (int i = 0; i < 3; i++)
+      {
+        inPts->GetPoint(pts[i], x);
+        center[0] += x[0] / 3.0;
+        center[1] += x[1] / 3.0;
+        center[2] += x[2] / 3.0;
+      }
+      centers->SetPoint(cellId, center);
+    }
+  });
+  vtkNew<vtkPolyData> centerSet;
+  centerSet->SetPoints(centers);
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(centerSet);
+
+  // Surfaces leave many buckets empty: refine them until there are enough
+  // partitions.
+  std::vector<vtkIdType> buckets;
+  vtkIdType numPerBucket = numTris / numPartitions;
+  for (int refinement = 0; refinement < 4 && static_cast<vtkIdType>(buckets.size()) < numPartitions;
+       refinement++, numPerBucket /= 2)
+  {
+    locator->SetNumberOfPointsPerBucket(
+      static_cast<int>(std::min<vtkIdType>(numPerBucket, VTK_INT_MAX)));
+    locator->BuildLocator();
+    buckets.clear();
+    for (vtkIdType bucket = 0; bucket < locator->GetNumberOfBuckets(); bucket++)
+    {
+      if (locator->GetNumberOfPointsInBucket(bucket) > 0)
+      {
+        buckets.push_back(bucket);
+      }
+    }
+  }
+  const vtkIdType numParts = static_cast<vtkIdType>(buckets.size());
+  if (numParts < 2)
+  {
+    return this->Decimate(input, output);
+  }
+
+  // A point is owned by the partition using it, or shared and frozen.
+  std::vector<std::vector<vtkIdType>> partTris(numParts);
+  std::unique_ptr<std::atomic<vtkIdType>[]> owners(new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+    {
+      owners[ptId] = VTK_UNUSED_POINT;
+    }
+  });
+  vtkSMPTools::For(0, numParts, 1, [&](vtkIdType begin, vtkIdType end) {
+    vtkNew<vtkIdList> ids;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType part = begin; part < end; part++)
+    {
+      locator->GetBucketIds(buckets[part], ids);
+      partTris[part].assign(ids->begin(), ids->end());
+      std::sort(partTris[part].begin(), partTris[part].end());
+      for (vtkIdType cellId : partTris[part])
+      {
+        inPolys->GetCellAtId(cellId, npts, pts, ids);
+        for (int i = 0; i < 3; i++)
+        {
+          vtkIdType owner = VTK_UNUSED_POINT;
+          if (!owners[pts[i]].compare_exchange_strong(owner, part) && owner != part)
+          {
+            owners[pts[i]] = VTK_SHARED_POINT;
+          }
+        }
+      }
+    }
+  });
+  this->UpdateProgress(0.1);
+  if (this->CheckAbort())
+  {
+    return 1;
+  }
+
+  // Decimate the partitions. Their frozen points are numbered first, and
+  // their input ids are kept in a point data array to merge them back.
+  std::vector<vtkSmartPointer<vtkPolyData>> partOutputs(numParts);
+  std::vector<std::vector<double>> partInflections(numParts);
+  std::vector<vtkIdType> partPops(numParts);
+  vtkSMPTools::For(0, numParts, 1, [&](vtkIdType begin, vtkIdType end) {
+    vtkNew<vtkIdList> tempIds;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double x[3];
+    std::vector<vtkIdType> ptIds;
+    std::vector<vtkIdType> localIds;
+    for (vtkIdType part = begin; part < end; part++)
+    {
+      const std::vector<vtkIdType>& tris = partTris[part];
+      ptIds.clear();
+      for (vtkIdType cellId : tris)
+      {
+        inPolys->GetCellAtId(cellId, npts, pts, tempIds);
+        ptIds.insert(ptIds.end(), pts, pts + 3);
+      }
+      std::sort(ptIds.begin(), ptIds.end());
+      ptIds.erase(std::unique(ptIds.begin(), ptIds.end()), ptIds.end());
+
+      const vtkIdType numPartPts = static_cast<vtkIdType>(ptIds.size());
+      const vtkIdType numFrozen = static_cast<vtkIdType>(std::count_if(ptIds.begin(),
+        ptIds.end(), [&](vtkIdType ptId) { return owners[ptId] == VTK_SHARED_POINT; }));
+      localIds.resize(numPartPts);
+      vtkIdType nextFrozen = 0, nextOwned = numFrozen;
+      for (vtkIdType i = 0; i < numPartPts; i++)
+      {
+        localIds[i] = owners[ptIds[i]] == VTK_SHARED_POINT ? nextFrozen++ : nextOwned++;
+      }
+
+      vtkNew<vtkPolyData> partition;
+      vtkNew<vtkPoints> partPts;
+      partPts->SetDataType(inPts->GetDataType());
+      partPts->SetNumberOfPoints(numPartPts);
+      vtkNew<vtkIdTypeArray> frozenIds;
+      frozenIds->SetName(VTK_FROZEN_IDS_NAME);
+      frozenIds->SetNumberOfValues(numPartPts);
+      vtkPointData* partPD = partition->GetPointData();
+      partPD->CopyAllocate(inPD, numPartPts);
+      for (vtkIdType i = 0; i < numPartPts; i++)
+      {
+        inPts->GetPoint(ptIds[i], x);
+        partPts->SetPoint(localIds[i], x);
+        partPD->CopyData(inPD, ptIds[i], localIds[i]);
+        frozenIds->SetValue(localIds[i], localIds[i] < numFrozen ? ptIds[i] : -1);
+      }
+      partPD->AddArray(frozenIds);
+
+      vtkNew<vtkCellArray> partPolys;
+      partPolys->AllocateExact(static_cast<vtkIdType>(tris.size()), 3 * tris.size());
+      for (vtkIdType cellId : tris)
+      {
+        inPolys->GetCellAtId(cellId, npts, pts, tempIds);
+        vtkIdType tri[3];
+        for (int i = 0; i < 3; i++)
+        {
+          tri[i] = localIds[std::lower_bound(ptIds.begin(), ptIds.end(), pts[i]) - ptIds.begin()];
+        }
+        partPolys->InsertNextCell(3, tri);
+      }
+      partition->SetPoints(partPts);
+      partition->SetPolys(partPolys);
+
+      vtkSmartPointer<vtkDecimatePro> decimate = newDecimate(this->TargetReduction);
+      decimate->NumberOfFrozenPoints = numFrozen;
+      partOutputs[part] = vtkSmartPointer<vtkPolyData>::New();
+      decimate->Decimate(partition, partOutputs[part]);
+      partInflections[part].assign(decimate->GetInflectionPoints(),
+        decimate->GetInflectionPoints() + decimate->GetNumberOfInflectionPoints());
+      partPops[part] = decimate->NumberOfPops;
+    }
+  });
+
+  // The inflection points of the partitions follow each other in partition
+  // order, counting the vertex pops of the previous partitions.
+  vtkIdType numPops = 0;
+  for (vtkIdType part = 0; part < numParts; part++)
+  {
+    for (double inflection : partInflections[part])
+    {
+      this->InflectionPoints->InsertNextValue(numPops + inflection);
+    }
+    numPops += partPops[part];
+  }
+  this->UpdateProgress(0.7);
+  if (this->CheckAbort())
+  {
+    return 1;
+  }
+
+  // Merge the partitions: the frozen points left come first in input order,
+  // written by the first partition using them, then the other points of each
+  // partition.
+  std::vector<vtkIdType> frozenParts(numPts, -1);
+  std::vector<vtkIdType> partOffsets(numParts + 1, 0);
+  std::vector<vtkIdType> triOffsets(numParts + 1, 0);
+  for (vtkIdType part = 0; part < numParts; part++)
+  {
+    vtkIdTypeArray* frozenIds = vtkArrayDownCast<vtkIdTypeArray>(
+      partOutputs[part]->GetPointData()->GetArray(VTK_FROZEN_IDS_NAME));
+    for (vtkIdType i = 0; i < frozenIds->GetNumberOfValues(); i++)
+    {
+      const vtkIdType ptId = frozenIds->GetValue(i);
+      if (ptId < 0)
+      {
+        partOffsets[part + 1]++;
+      }
+      else if (frozenParts[ptId] < 0)
+      {
+        frozenParts[ptId] = part;
+      }
+    }
+    triOffsets[part + 1] = triOffsets[part] + partOutputs[part]->GetNumberOfPolys();
+  }
+  std::vector<vtkIdType> frozenMap(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+    {
+      frozenMap[ptId] = frozenParts[ptId] >= 0 ? 1 : 0;
+    }
+  });
+  partOffsets[0] =
+    vtkSMPTools::ExclusiveScan(frozenMap.begin(), frozenMap.end(), frozenMap.begin(), 0);
+  for (vtkIdType part = 0; part < numParts; part++)
+  {
+    partOffsets[part + 1] += partOffsets[part];
+  }
+  const vtkIdType numMergedPts = partOffsets[numParts];
+  const vtkIdType numMergedTris = triOffsets[numParts];
+
+  vtkNew<vtkPolyData> merged;
+  vtkNew<vtkPoints> mergedPts;
+  mergedPts->SetDataType(partOutputs[0]->GetPoints()->GetDataType());
+  mergedPts->SetNumberOfPoints(numMergedPts);
+  vtkDataSetAttributes::FieldList fieldList(static_cast<int>(numParts));
+  for (vtkIdType part = 0; part < numParts; part++)
+  {
+    fieldList.IntersectFieldList(partOutputs[part]->GetPointData());
+  }
+  vtkPointData* mergedPD = merged->GetPointData();
+  fieldList.CopyAllocate(mergedPD, vtkDataSetAttributes::COPYTUPLE, numMergedPts, 0);
+  mergedPD->SetNumberOfTuples(numMergedPts);
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numMergedTris + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(3 * numMergedTris);
+
+  vtkSMPTools::For(0, numParts, 1, [&](vtkIdType begin, vtkIdType end) {
+    vtkNew<vtkIdList> tempIds;
+    vtkIdType npts;
+    const vtkIdType* pts;
+    double x[3];
+    std::vector<vtkIdType> pointMap;
+    std::vector<vtkIdType> writtenPts;
+    for (vtkIdType part = begin; part < end; part++)
+    {
+      vtkPolyData* partOutput = partOutputs[part];
+      vtkIdTypeArray* frozenIds =
+        vtkArrayDownCast<vtkIdTypeArray>(partOutput->GetPointData()->GetArray(VTK_FROZEN_IDS_NAME));
+      const vtkIdType numPartPts = partOutput->GetNumberOfPoints();
+      pointMap.resize(numPartPts);
+      writtenPts.clear();
+      vtkIdType nextId = partOffsets[part];
+      for (vtkIdType i = 0; i < numPartPts; i++)
+      {
+        const vtkIdType ptId = frozenIds->GetValue(i);
+        pointMap[i] = ptId < 0 ? nextId++ : frozenMap[ptId];
+        if (ptId < 0 || frozenParts[ptId] == part)
+        {
+          partOutput->GetPoint(i, x);
+          mergedPts->SetPoint(pointMap[i], x);
+          writtenPts.push_back(i);
+        }
+      }
+      fieldList.TransformData(static_cast<int>(part), partOutput->GetPointData(), mergedPD,
+        [&](vtkAbstractArray* partArray, vtkAbstractArray* mergedArray) {
+          for (vtkIdType i : writtenPts)
+          {
+            mergedArray->SetTuple(pointMap[i], i, partArray);
+          }
+        });
+
+      vtkCellArray* partPolys = partOutput->GetPolys();
+      vtkIdType triId = triOffsets[part];
+      for (vtkIdType cellId = 0; cellId < partPolys->GetNumberOfCells(); cellId++, triId++)
+      {
+        partPolys->GetCellAtId(cellId, npts, pts, tempIds);
+        offsets->SetValue(triId, 3 * triId);
+        for (int i = 0; i < 3; i++)
+        {
+          connectivity->SetValue(3 * triId + i, pointMap[pts[i]]);
+        }
+      }
+    }
+  });
+  offsets->SetValue(numMergedTris, 3 * numMergedTris);
+  vtkNew<vtkCellArray> mergedPolys;
+  mergedPolys->SetData(offsets, connectivity);
+  merged->SetPoints(mergedPts);
+  merged->SetPolys(mergedPolys);
+
+  // Decimate the seams, and the rest of the mesh if needed, down to the
+  // target reduction.
+  vtkDebugMacro(<< "Partitions reduced from " << numTris << " to " << numMergedTris
+                << " triangles");
+  if (numMergedTris > 0 && numTris - numMergedTris < this->TargetReduction * numTris)
+  {
+    vtkSmartPointer<vtkDecimatePro> decimate =
+      newDecimate(1.0 - (1.0 - this->TargetReduction) * numTris / numMergedTris);
+    decimate->Decimate(merged, output);
+    for (vtkIdType i = 0; i < decimate->GetNumberOfInflectionPoints(); i++)
+    {
+      this->InflectionPoints->InsertNextValue(numPops + decimate->GetInflectionPoints()[i]);
+    }
+  }
+  else
+  {
+    output->CopyStructure(merged);
+    output->GetPointData()->PassData(mergedPD);
+  }
+  output->GetPointData()->RemoveArray(VTK_FROZEN_IDS_NAME);
+
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 // Computes error to edge (distance squared)
 //
@@ -481,7 +893,7 @@ void vtkDecimatePro::SplitMesh()
     this->Mesh->GetPoint(ptId, this->X);
     this->Mesh->GetPointCells(ptId, ncells, cells);
 
-    if (ncells > 0 &&
+    if (ncells > 0 && !this->IsFrozen(ptId) &&
       ((type = this->EvaluateVertex(ptId, ncells, cells, fedges)) == VTK_CORNER_VERTEX ||
         type == VTK_INTERIOR_EDGE_VERTEX || type == VTK_NON_MANIFOLD_VERTEX))
     {
@@ -1208,7 +1620,8 @@ vtkIdType vtkDecimatePro::FindSplit(
 
     case VTK_CRACK_TIP_VERTEX: //-------------------------------------------
       this->V->MaxId--;
-      if (this->IsValidSplit(0))
+      // Sealing the crack deletes the other tip
+      if (this->IsValidSplit(0) && !this->IsFrozen(this->V->Array[this->V->MaxId + 1].id))
       {
         CollapseTris->SetId(0, this->T->Array[0].id);
         pt1 = this->V->Array[1].id;
@@ -1223,6 +1636,10 @@ vtkIdType vtkDecimatePro::FindSplit(
       break;
 
     case VTK_DEGENERATE_VERTEX: //-------------------------------------------
+      if (this->ConnectsFrozenPoints(0))
+      {
+        break;
+      }
       // Collapse to the first edge
       CollapseTris->SetId(0, this->T->Array[0].id);
       pt1 = this->V->Array[1].id;
@@ -1262,6 +1679,11 @@ int vtkDecimatePro::IsValidSplit(int index)
   vtkIdType l1[VTK_MAX_TRIS_PER_VERTEX], l2[VTK_MAX_TRIS_PER_VERTEX];
   vtkIdType n1, n2;
 
+  if (this->ConnectsFrozenPoints(index))
+  {
+    return 0;
+  }
+
   // For a edge collapse to be valid, all edges to that vertex must
   // divide the loop cleanly.
   fedges[0] = index;
@@ -1331,6 +1753,31 @@ int vtkDecimatePro::IsValidSplit(int index)
   return 1;
 }
 
+//------------------------------------------------------------------------------
+// Determine whether collapsing the current vertex to the loop vertex index
+// connects two frozen points, which may already be connected outside of the
+// partition being decimated.
+//
+bool vtkDecimatePro::ConnectsFrozenPoints(int index)
+{
+  if (!this->IsFrozen(this->V->Array[index].id))
+  {
+    return false;
+  }
+  const vtkIdType nverts = this->V->MaxId + 1;
+  const bool closed = (this->T->MaxId == this->V->MaxId);
+  for (vtkIdType j = 0; j < nverts; j++)
+  {
+    const bool adjacent = (j == index || j == index + 1 || j == index - 1 ||
+      (closed && (j - index == nverts - 1 || index - j == nverts - 1)));
+    if (!adjacent && this->IsFrozen(this->V->Array[j].id))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
 //------------------------------------------------------------------------------
 //  Creates two loops from splitting plane provided
 //
@@ -1585,6 +2032,12 @@ void vtkDecimatePro::Insert(vtkIdType ptId, double error)
   vtkIdType fedges[2];
   vtkIdType ncells;
 
+  // Frozen points are never deleted nor split
+  if (this->IsFrozen(ptId))
+  {
+    return;
+  }
+
   // on value of error, we need to compute it or just insert the point
   if (error < -this->Tolerance)
   {
@@ -1728,5 +2181,6 @@ void vtkDecimatePro::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Inflection Points: " << this->GetNumberOfInflectionPoints() << "\n";
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 VTK_ABI_NAMESPACE_END
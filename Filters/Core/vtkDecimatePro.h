@@ -61,6 +61,17 @@
  * is a conservative global error bounds and decimation error, but requires
  * additional memory and time to compute.
  *
+ * When EnableSMP is on, the triangles are partitioned by the buckets of a
+ * vtkStaticPointLocator built on their centers, and the partitions are
+ * decimated concurrently using vtkSMPTools, the vertices used by several
+ * partitions being neither deleted nor split. The partitions are then merged
+ * and a final serial pass decimates the seams, down to the TargetReduction.
+ * The number of partitions only depends on the number of triangles, so the
+ * output does not depend on the number of threads, but differs from the
+ * serial one. The inflection points of the partitions are reported in
+ * partition order, then those of the final pass. Meshes too small to be
+ * partitioned are decimated serially.
+ *
  * @warning
  * To guarantee a given level of reduction, the ivar PreserveTopology must
  * be off; the ivar Splitting is on; the ivar BoundaryVertexDeletion is on;
@@ -286,12 +297,35 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded implementation. When on, meshes of triangles
+   * large enough to be partitioned are decimated by spatial partitions, then
+   * along the seams between them: other vertices are deleted than in the
+   * serial implementation, whatever the number of threads. Other inputs are
+   * decimated serially. Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
 protected:
   vtkDecimatePro();
   ~vtkDecimatePro() override;
 
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  /**
+   * Decimate the input into the output with the serial algorithm.
+   */
+  int Decimate(vtkPolyData* input, vtkPolyData* output);
+
+  /**
+   * Threaded implementation of RequestData(), used when EnableSMP is on.
+   */
+  int RequestDataSMP(vtkPolyData* input, vtkPolyData* output);
+
   double TargetReduction;
   double FeatureAngle;
   double MaximumError;
@@ -307,6 +341,11 @@ protected:
   double InflectionPointRatio;
   vtkDoubleArray* InflectionPoints;
   int OutputPointsPrecision;
+  bool EnableSMP;
+
+  // Points of lower id are neither deleted nor split. Used to freeze the
+  // points shared by the partitions of the threaded implementation.
+  vtkIdType NumberOfFrozenPoints;
 
   // to replace a static object
   vtkIdList* Neighbors;
@@ -401,6 +440,8 @@ private:
   int Pop(double& error);
   double DeleteId(vtkIdType id);
   void Reset();
+  bool IsFrozen(vtkIdType ptId) const { return ptId < this->NumberOfFrozenPoints; }
+  bool ConnectsFrozenPoints(int index);
 
   vtkPriorityQueue* Queue;
   vtkDoubleArray* VertexError;
@@ -421,6 +462,7 @@ private:
   int Split;                       // Controls whether and when vertex splitting occurs
   int VertexDegree;                // Maximum number of triangles that can use a vertex
   vtkIdType NumberOfRemainingTris; // Number of triangles left in the mesh
+  vtkIdType NumberOfPops;          // Number of vertices popped from the queue
   double TheSplitAngle;            // Split angle
   int SplitState;                  // State of the splitting process
   double Error;                    // Maximum allowable surface error
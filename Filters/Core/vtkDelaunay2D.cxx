@@ -19,17 +19,22 @@
 #include "vtkDoubleArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkInsertionRoundsInternal.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <set>
+#include <utility>
 #include <vector>
 
 VTK_ABI_NAMESPACE_BEGIN
@@ -45,6 +50,7 @@ vtkDelaunay2D::vtkDelaunay2D()
   this->BoundingTriangulation = 0;
   this->Offset = 1.0;
   this->RandomPointInsertion = 0;
+  this->SpatialPointInsertion = 0;
   this->Transform = nullptr;
   this->ProjectionPlaneMode = VTK_DELAUNAY_XY_PLANE;
 
@@ -337,6 +343,74 @@ struct GCDTraversal
   // else that is going on.
   vtkIdType GetPointId(vtkIdType idx) { return ((this->Prime * idx + this->Offset) % this->NPts); }
 };
+
+// Position along a Hilbert curve of a point of a 2^26 x 2^26 grid.
+const int HilbertBits = 26;
+uint64_t HilbertKey(unsigned int x, unsigned int y)
+{
+  uint64_t key = 0;
+  for (unsigned int s = 1u << (HilbertBits - 1); s > 0; s >>= 1)
+  {
+    const unsigned int rx = (x & s) ? 1 : 0;
+    const unsigned int ry = (y & s) ? 1 : 0;
+    key += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+    if (ry == 0)
+    {
+      if (rx == 1)
+      {
+        x = ~x;
+        y = ~y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return key;
+}
+
+// The points are inserted in the rounds of a biased randomized insertion
+// order, each sorted along a Hilbert curve traversed alternately backward and
+// forward so that a round starts close to where the previous one ends. The z
+// coordinate is ignored.
+std::vector<vtkIdType> SpatialOrder(const double* points, vtkIdType numPts, const double bounds[6])
+{
+  const InsertionRounds rounds(numPts, 1024);
+  const int numRounds = rounds.GetNumberOfRounds();
+
+  std::vector<std::pair<uint64_t, vtkIdType>> order(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    const double maxCoord = static_cast<double>((1u << HilbertBits) - 1);
+    const uint64_t maxKey = (static_cast<uint64_t>(1) << (2 * HilbertBits)) - 1;
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      const double* x = points + 3 * ptId;
+      unsigned int coords[2];
+      for (int i = 0; i < 2; ++i)
+      {
+        const double length = bounds[2 * i + 1] - bounds[2 * i];
+        coords[i] = static_cast<unsigned int>(
+          length > 0.0 ? maxCoord * (x[i] - bounds[2 * i]) / length : 0.0);
+      }
+      uint64_t key = HilbertKey(coords[0], coords[1]);
+      const int round = rounds.GetRound(key);
+      if ((numRounds - 1 - round) % 2)
+      {
+        key = maxKey - key;
+      }
+      order[ptId].first = (static_cast<uint64_t>(round) << (2 * HilbertBits)) | key;
+      order[ptId].second = ptId;
+    }
+  });
+  vtkSMPTools::Sort(order.begin(), order.end());
+
+  std::vector<vtkIdType> pointIds(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      pointIds[i] = order[i].second;
+    }
+  });
+  return pointIds;
+}
 } // anonymous namespace
 
 //------------------------------------------------------------------------------
@@ -454,16 +528,18 @@ int vtkDelaunay2D::RequestData(vtkInformation* vtkNotUsed(request),
   // Initialize mesh structure.
   //
   vtkNew<vtkPoints> points;
-  // This will copy doubles to doubles if the input is double.
   points->SetDataTypeToDouble();
   points->SetNumberOfPoints(numPoints);
-  if (!this->Transform)
   {
-    points->DeepCopy(inPoints);
-  }
-  else
-  {
-    points->DeepCopy(tPoints);
+    // Copy the (transformed) points in double precision.
+    vtkPoints* projectedPoints = this->Transform ? tPoints.Get() : inPoints;
+    double* coords = static_cast<vtkDoubleArray*>(points->GetData())->GetPointer(0);
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType id = begin; id < end; ++id)
+      {
+        projectedPoints->GetPoint(id, coords + 3 * id);
+      }
+    });
   }
 
   const double* bounds = points->GetBounds();
@@ -475,6 +551,13 @@ int vtkDelaunay2D::RequestData(vtkInformation* vtkNotUsed(request),
   this->BoundingRadius2 = 4 * radius * radius; // use (2*r)**2
   tol *= this->Tolerance;
 
+  std::vector<vtkIdType> spatialOrder;
+  if (this->SpatialPointInsertion)
+  {
+    spatialOrder = SpatialOrder(
+      static_cast<vtkDoubleArray*>(points->GetData())->GetPointer(0), numPoints, bounds);
+  }
+
   // Add the eight bounding points to the end of the points list.
   for (ptId = 0; ptId < 8; ptId++)
   {
@@ -524,17 +607,26 @@ int vtkDelaunay2D::RequestData(vtkInformation* vtkNotUsed(request),
   // neighboring triangles for Delaunay criterion. Triangles that do not
   // satisfy criterion have their edges swapped. This continues recursively
   // until all triangles have been shown to be Delaunay. The points may be
-  // traversed in given order, or pseudo-random order.
+  // traversed in given order, pseudo-random order, or spatial order.
   //
   GCDTraversal gcdIter(numPoints);
-  for (auto idx = 0; idx < numPoints; idx++)
+  vtkIdType lastTri = 0;
+  for (vtkIdType idx = 0; idx < numPoints; idx++)
   {
-    ptId = (this->RandomPointInsertion ? gcdIter.GetPointId(idx) : idx);
+    if (this->SpatialPointInsertion)
+    {
+      ptId = spatialOrder[idx];
+    }
+    else
+    {
+      ptId = (this->RandomPointInsertion ? gcdIter.GetPointId(idx) : idx);
+    }
     this->GetPoint(ptId, x);
     nei[0] = (-1); // where we are coming from...nowhere initially
 
     if ((tri[0] = this->FindTriangle(x, pts, tri[0], tol, nei, neighbors)) >= 0)
     {
+      lastTri = tri[0];
       if (nei[0] < 0) // in triangle
       {
         // delete this triangle; create three new triangles
@@ -621,13 +713,15 @@ int vtkDelaunay2D::RequestData(vtkInformation* vtkNotUsed(request),
 
     else
     {
-      tri[0] = 0; // no triangle found
+      // No triangle found. In spatial order, the next point is close to the
+      // last triangle found.
+      tri[0] = (this->SpatialPointInsertion ? lastTri : 0);
     }
 
-    if (!(ptId % 1000))
+    if (!(idx % 1000))
     {
-      vtkDebugMacro(<< "point #" << ptId);
-      this->UpdateProgress(static_cast<double>(ptId) / numPoints);
+      vtkDebugMacro(<< "point #" << idx);
+      this->UpdateProgress(static_cast<double>(idx) / numPoints);
       if (this->CheckAbort())
       {
         break;
@@ -1651,6 +1745,8 @@ void vtkDelaunay2D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Tolerance: " << this->Tolerance << "\n";
   os << indent << "Offset: " << this->Offset << "\n";
   os << indent << "Random Point Insertion: " << (this->RandomPointInsertion ? "On" : "Off") << "\n";
+  os << indent << "Spatial Point Insertion: " << (this->SpatialPointInsertion ? "On" : "Off")
+     << "\n";
   os << indent << "Bounding Triangulation: " << (this->BoundingTriangulation ? "On\n" : "Off\n");
 }
 VTK_ABI_NAMESPACE_END
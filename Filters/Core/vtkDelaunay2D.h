@@ -70,6 +70,15 @@
  * RandomPointInsertion mode can be set which will insert the points in
  * pseudo-random order.
  *
+ * For large inputs, and in particular for ordered ones such as the scan lines
+ * of terrain surveys, the SpatialPointInsertion mode is much faster. The
+ * points are inserted in rounds of increasing size, each round sorted along a
+ * Hilbert curve, so that each point is located by a short walk from the
+ * previous one. The points are sorted using vtkSMPTools. For points in general
+ * position the triangulation does not depend on the order of insertion; for
+ * degenerate points (see below) it may differ from the one obtained in input
+ * order.
+ *
  * To create constrained meshes, you must define an additional
  * input. This input is an instance of vtkPolyData which contains
  * lines, polylines, and/or polygons that define constrained edges and
@@ -267,6 +276,17 @@ public:
   vtkBooleanMacro(RandomPointInsertion, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Indicate whether to insert the points in a biased randomized order along
+   * a space-filling curve, see the class documentation. This mode takes
+   * precedence over RandomPointInsertion. Default is off.
+   */
+  vtkSetMacro(SpatialPointInsertion, vtkTypeBool);
+  vtkGetMacro(SpatialPointInsertion, vtkTypeBool);
+  vtkBooleanMacro(SpatialPointInsertion, vtkTypeBool);
+  ///@}
+
 protected:
   vtkDelaunay2D();
 
@@ -277,6 +297,7 @@ protected:
   vtkTypeBool BoundingTriangulation;
   double Offset;
   vtkTypeBool RandomPointInsertion;
+  vtkTypeBool SpatialPointInsertion;
 
   // Transform input points (if necessary)
   vtkSmartPointer<vtkAbstractTransform> Transform;
@@ -15,20 +15,34 @@
 
 #include "vtkDelaunay3D.h"
 
+#include "vtkCellArray.h"
 #include "vtkEdgeTable.h"
 #include "vtkExecutive.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkInsertionRoundsInternal.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointLocator.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTetra.h"
 #include "vtkTriangle.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkDelaunay3D);
 
@@ -122,6 +136,914 @@ vtkDelaunayTetra* vtkTetraArray::Resize(vtkIdType sz)
   return this->Array;
 }
 
+//------------------------------------------------------------------------------
+// Threaded point insertion, used when EnableSMP is on. The triangulation is
+// kept in its own structure, where each tetra knows its face neighbors and
+// can be locked by one insertion at a time.
+namespace
+{
+// The faces of a tetra, each listed opposite to one of its points and
+// ordered so that the face and that point form a positive tetra.
+const int TetraFaces[4][3] = { { 1, 3, 2 }, { 0, 2, 3 }, { 0, 3, 1 }, { 0, 1, 2 } };
+
+// Six times the signed volume of the tetra (p0,p1,p2,p3).
+inline double Orientation(const double* p0, const double* p1, const double* p2, const double* p3)
+{
+  const double a[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+  const double b[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+  const double c[3] = { p3[0] - p0[0], p3[1] - p0[1], p3[2] - p0[2] };
+  return a[0] * (b[1] * c[2] - b[2] * c[1]) - a[1] * (b[0] * c[2] - b[2] * c[0]) +
+    a[2] * (b[0] * c[1] - b[1] * c[0]);
+}
+
+// Position along a Hilbert curve of a point of a 2^19 grid, computed with
+// Skilling's transpose algorithm ("Programming the Hilbert curve", 2004).
+const int HilbertBits = 19;
+uint64_t HilbertKey(unsigned int x[3])
+{
+  const unsigned int m = 1u << (HilbertBits - 1);
+  for (unsigned int q = m; q > 1; q >>= 1)
+  {
+    const unsigned int p = q - 1;
+    for (int i = 0; i < 3; ++i)
+    {
+      if (x[i] & q)
+      {
+        x[0] ^= p;
+      }
+      else
+      {
+        const unsigned int t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  x[1] ^= x[0];
+  x[2] ^= x[1];
+  unsigned int t = 0;
+  for (unsigned int q = m; q > 1; q >>= 1)
+  {
+    if (x[2] & q)
+    {
+      t ^= q - 1;
+    }
+  }
+  uint64_t key = 0;
+  for (int b = HilbertBits - 1; b >= 0; --b)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      key = (key << 1) | (((x[i] ^ t) >> b) & 1u);
+    }
+  }
+  return key;
+}
+
+// The tetras are allocated in blocks, each thread taking tetras from its own.
+const int BlockBits = 14;
+const vtkIdType BlockSize = static_cast<vtkIdType>(1) << BlockBits;
+const vtkIdType MaxBlocks = static_cast<vtkIdType>(1) << 18;
+
+// A tetra of the threaded triangulation. The points and neighbors are read
+// without locking while walking towards a point, everything else is only
+// accessed by the insertion locking the tetra.
+struct DelaunaySMPTetra
+{
+  std::atomic<vtkIdType> Points[4];
+  std::atomic<vtkIdType> Neighbors[4]; // across the face opposite to each point
+  std::atomic<int> Owner;              // token of the locking insertion, 0 if none
+  std::atomic<bool> Alive;
+  char Mark; // 1 in the cavity of the locking insertion, 2 next to it
+  double Center[3];
+  double Radius2;
+
+  DelaunaySMPTetra()
+    : Owner(0)
+    , Alive(false)
+    , Mark(0)
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      this->Points[i] = 0;
+      this->Neighbors[i] = -1;
+    }
+  }
+};
+
+// A face of the boundary of a cavity, with the tetra beyond it.
+struct DelaunaySMPFace
+{
+  vtkIdType Points[3];
+  vtkIdType Neighbor;
+  int NeighborFace;
+};
+
+// An edge of the boundary of a cavity, used to connect the new tetras.
+struct DelaunaySMPEdge
+{
+  vtkIdType Points[2];
+  vtkIdType Face;
+  int Side;
+
+  bool operator<(const DelaunaySMPEdge& other) const
+  {
+    return this->Points[0] < other.Points[0] ||
+      (this->Points[0] == other.Points[0] && this->Points[1] < other.Points[1]);
+  }
+};
+
+class DelaunaySMP
+{
+public:
+  enum Status
+  {
+    Inserted,
+    Duplicate,
+    Degenerate,
+    Conflict
+  };
+
+  struct LocalData
+  {
+    int Token = 0;
+    vtkIdType Hint = -1;
+    vtkIdType NextTetra = 0; // unused tetras of the last allocated block
+    vtkIdType EndTetra = 0;
+    std::vector<vtkIdType> FreeTetras;
+    std::vector<vtkIdType> Cavity;
+    std::vector<vtkIdType> Outside;
+    std::vector<DelaunaySMPFace> Faces;
+    std::vector<DelaunaySMPEdge> Edges;
+    std::vector<vtkIdType> NewTetras;
+    std::vector<vtkIdType> Postponed;
+  };
+
+  // Copy the points and create the bounding octahedron, like
+  // vtkDelaunay3D::InitPointInsertion() does.
+  DelaunaySMP(vtkPoints* inPoints, const double center[3], double length, double tolerance,
+    vtkPoints* points)
+    : NumberOfPoints(inPoints->GetNumberOfPoints())
+    , Tolerance2(tolerance * tolerance)
+    , Blocks(MaxBlocks)
+    , NumberOfBlocks(0)
+    , Tokens(0)
+  {
+    const vtkIdType numPts = this->NumberOfPoints;
+    this->Coords.resize(3 * (numPts + 6));
+    double* coords = this->Coords.data();
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        inPoints->GetPoint(ptId, coords + 3 * ptId);
+      }
+    });
+    if (length <= 0.0)
+    {
+      length = 1.0;
+    }
+    double* x = coords + 3 * numPts;
+    for (int i = 0; i < 6; ++i)
+    {
+      x[3 * i] = center[0];
+      x[3 * i + 1] = center[1];
+      x[3 * i + 2] = center[2];
+      x[3 * i + i / 2] += (i % 2 ? length : -length);
+    }
+    points->SetNumberOfPoints(numPts + 6);
+    points->GetData()->InsertTuples(0, numPts, 0, inPoints->GetData());
+    for (int i = 0; i < 6; ++i)
+    {
+      points->SetPoint(numPts + i, x + 3 * i);
+    }
+
+    static const int tetras[4][4] = { { 4, 5, 0, 2 }, { 4, 5, 2, 1 }, { 4, 5, 1, 3 },
+      { 4, 5, 3, 0 } };
+    LocalData& local = this->Locals.Local();
+    vtkIdType tetraIds[4];
+    for (int i = 0; i < 4; ++i)
+    {
+      tetraIds[i] = this->NewTetra(local);
+      vtkIdType pts[4];
+      for (int j = 0; j < 4; ++j)
+      {
+        pts[j] = numPts + tetras[i][j];
+      }
+      if (Orientation(this->Point(pts[0]), this->Point(pts[1]), this->Point(pts[2]),
+            this->Point(pts[3])) < 0.0)
+      {
+        std::swap(pts[0], pts[1]);
+      }
+      this->SetTetra(tetraIds[i], pts);
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+      DelaunaySMPTetra& tetra = this->Tetra(tetraIds[i]);
+      for (int k = 0; k < 4; ++k)
+      {
+        for (int j = 0; j < 4; ++j)
+        {
+          if (j != i && this->HasFace(this->Tetra(tetraIds[j]), tetra, k))
+          {
+            tetra.Neighbors[k] = tetraIds[j];
+          }
+        }
+      }
+      tetra.Owner = 0;
+    }
+    this->StartTetra = local.Hint = tetraIds[0];
+  }
+
+  // Insert all the points, returns false if the triangulation is too large.
+  bool InsertPoints(vtkDelaunay3D* self);
+
+  // Gather the live tetras, without those using the bounding points unless
+  // keepBounding is true. The circumspheres are also gathered if requested.
+  void ExtractTetras(bool keepBounding, vtkCellArray* cells, vtkTetraArray* spheres);
+
+  vtkIdType NumberOfDuplicatePoints = 0;
+  vtkIdType NumberOfDegeneracies = 0;
+
+private:
+  vtkIdType NumberOfPoints;
+  double Tolerance2;
+  std::vector<double> Coords;
+  std::vector<std::unique_ptr<DelaunaySMPTetra[]>> Blocks;
+  std::atomic<vtkIdType> NumberOfBlocks;
+  std::atomic<int> Tokens;
+  vtkIdType StartTetra = -1; // where the walks start when a thread has no hint
+  vtkSMPThreadLocal<LocalData> Locals;
+
+  friend struct DelaunaySMPInsert;
+
+  const double* Point(vtkIdType ptId) const { return this->Coords.data() + 3 * ptId; }
+
+  DelaunaySMPTetra& Tetra(vtkIdType tetraId) const
+  {
+    return this->Blocks[tetraId >> BlockBits][tetraId & (BlockSize - 1)];
+  }
+
+  bool TryLock(vtkIdType tetraId, int token) const
+  {
+    std::atomic<int>& owner = this->Tetra(tetraId).Owner;
+    int current = 0;
+    return owner.compare_exchange_strong(current, token, std::memory_order_acquire) ||
+      current == token;
+  }
+
+  void Unlock(vtkIdType tetraId) const
+  {
+    this->Tetra(tetraId).Owner.store(0, std::memory_order_release);
+  }
+
+  bool HasFace(DelaunaySMPTetra& tetra, DelaunaySMPTetra& other, int face) const
+  {
+    int found = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+      const vtkIdType ptId = other.Points[TetraFaces[face][i]];
+      for (int j = 0; j < 4; ++j)
+      {
+        found += (tetra.Points[j] == ptId);
+      }
+    }
+    return found == 3;
+  }
+
+  // Get a locked, unused tetra: reuse a deleted one or take it from the
+  // current block, allocating a new block when it is exhausted.
+  vtkIdType NewTetra(LocalData& local)
+  {
+    while (!local.FreeTetras.empty())
+    {
+      const vtkIdType tetraId = local.FreeTetras.back();
+      local.FreeTetras.pop_back();
+      if (this->TryLock(tetraId, local.Token))
+      {
+        return tetraId;
+      }
+    }
+    if (local.NextTetra == local.EndTetra)
+    {
+      const vtkIdType block = this->NumberOfBlocks++;
+      if (block >= MaxBlocks)
+      {
+        return -1;
+      }
+      this->Blocks[block].reset(new DelaunaySMPTetra[BlockSize]);
+      local.NextTetra = block << BlockBits;
+      local.EndTetra = local.NextTetra + BlockSize;
+    }
+    const vtkIdType tetraId = local.NextTetra++;
+    this->Tetra(tetraId).Owner = local.Token;
+    return tetraId;
+  }
+
+  void SetTetra(vtkIdType tetraId, const vtkIdType pts[4])
+  {
+    DelaunaySMPTetra& tetra = this->Tetra(tetraId);
+    double x[4][3];
+    for (int i = 0; i < 4; ++i)
+    {
+      tetra.Points[i].store(pts[i], std::memory_order_release);
+      std::copy(this->Point(pts[i]), this->Point(pts[i]) + 3, x[i]);
+    }
+    tetra.Radius2 = vtkTetra::Circumsphere(x[0], x[1], x[2], x[3], tetra.Center);
+    tetra.Alive.store(true, std::memory_order_release);
+  }
+
+  // Signed volume of the tetra formed by a face and x. It is computed with
+  // the face points sorted by id, so that the two tetras sharing a face get
+  // opposite values despite round-off.
+  double FaceOrientation(vtkIdType p0, vtkIdType p1, vtkIdType p2, const double* x) const
+  {
+    double sign = 1.0;
+    if (p0 > p1)
+    {
+      std::swap(p0, p1);
+      sign = -sign;
+    }
+    if (p1 > p2)
+    {
+      std::swap(p1, p2);
+      sign = -sign;
+    }
+    if (p0 > p1)
+    {
+      std::swap(p0, p1);
+      sign = -sign;
+    }
+    return sign * Orientation(this->Point(p0), this->Point(p1), this->Point(p2), x);
+  }
+
+  // Signed volumes of the tetras formed by x and each face, the point is in
+  // the tetra when none is negative.
+  void FaceOrientations(DelaunaySMPTetra& tetra, const double* x, double orientations[4]) const
+  {
+    vtkIdType pts[4];
+    for (int i = 0; i < 4; ++i)
+    {
+      pts[i] = tetra.Points[i].load(std::memory_order_acquire);
+    }
+    for (int k = 0; k < 4; ++k)
+    {
+      const int* face = TetraFaces[k];
+      orientations[k] = this->FaceOrientation(pts[face[0]], pts[face[1]], pts[face[2]], x);
+    }
+  }
+
+  bool Contains(DelaunaySMPTetra& tetra, const double* x) const
+  {
+    double orientations[4];
+    this->FaceOrientations(tetra, x, orientations);
+    return orientations[0] >= 0.0 && orientations[1] >= 0.0 && orientations[2] >= 0.0 &&
+      orientations[3] >= 0.0;
+  }
+
+  // Same criterion as vtkDelaunay3D::InSphere().
+  static bool InSphere(const DelaunaySMPTetra& tetra, const double* x)
+  {
+    const double dist2 = (x[0] - tetra.Center[0]) * (x[0] - tetra.Center[0]) +
+      (x[1] - tetra.Center[1]) * (x[1] - tetra.Center[1]) +
+      (x[2] - tetra.Center[2]) * (x[2] - tetra.Center[2]);
+    return dist2 < (0.9999999999L * tetra.Radius2);
+  }
+
+  // Walk towards the live tetra containing x, crossing the face with the
+  // most negative volume like vtkDelaunay3D::FindTetra(). Without locks, the
+  // walk may see tetras being modified: the result is checked once locked.
+  vtkIdType Walk(const double* x, vtkIdType tetraId) const
+  {
+    for (int step = 0; step < 100000; ++step)
+    {
+      DelaunaySMPTetra& tetra = this->Tetra(tetraId);
+      double orientations[4];
+      this->FaceOrientations(tetra, x, orientations);
+      int neg = -1;
+      double negValue = 0.0;
+      for (int k = 0; k < 4; ++k)
+      {
+        if (orientations[k] < negValue)
+        {
+          negValue = orientations[k];
+          neg = k;
+        }
+      }
+      if (neg < 0)
+      {
+        return tetra.Alive.load(std::memory_order_acquire) ? tetraId : -1;
+      }
+      if ((tetraId = tetra.Neighbors[neg].load(std::memory_order_acquire)) < 0)
+      {
+        return -1;
+      }
+    }
+    return -1;
+  }
+
+  // A live tetra to start the walks from, picked between the parallel
+  // passes. The tetras created by the last insertion are alive, and the hint
+  // of its thread is one of them; the previous start is still alive when no
+  // point was inserted since.
+  vtkIdType LiveTetra()
+  {
+    for (LocalData& local : this->Locals)
+    {
+      if (local.Hint >= 0 && this->Tetra(local.Hint).Alive)
+      {
+        return local.Hint;
+      }
+    }
+    return this->StartTetra;
+  }
+
+  // Unlock the cavity and the tetras around it.
+  void Release(LocalData& local) const
+  {
+    for (vtkIdType tetraId : local.Outside)
+    {
+      this->Tetra(tetraId).Mark = 0;
+      this->Unlock(tetraId);
+    }
+    for (vtkIdType tetraId : local.Cavity)
+    {
+      this->Tetra(tetraId).Mark = 0;
+      this->Unlock(tetraId);
+    }
+  }
+
+  // Lock the tetras of the cavity of a point and their neighbors. The cavity
+  // is grown from the tetras listed after the first cavity ones.
+  bool GrowCavity(const double* x, LocalData& local, size_t first) const
+  {
+    for (size_t i = first; i < local.Cavity.size(); ++i)
+    {
+      const vtkIdType tetraId = local.Cavity[i];
+      DelaunaySMPTetra& tetra = this->Tetra(tetraId);
+      for (int k = 0; k < 4; ++k)
+      {
+        const vtkIdType neiId = tetra.Neighbors[k].load(std::memory_order_acquire);
+        if (neiId < 0)
+        {
+          continue;
+        }
+        if (!this->TryLock(neiId, local.Token))
+        {
+          return false;
+        }
+        DelaunaySMPTetra& nei = this->Tetra(neiId);
+        if (nei.Mark == 0)
+        {
+          nei.Mark = (DelaunaySMP::InSphere(nei, x) ? 1 : 2);
+          (nei.Mark == 1 ? local.Cavity : local.Outside).push_back(neiId);
+        }
+      }
+    }
+    return true;
+  }
+
+  Status Insert(vtkIdType ptId, LocalData& local, bool serial);
+};
+
+//------------------------------------------------------------------------------
+// Insert a point. Returns Conflict, leaving the triangulation unchanged, when
+// a tetra needed is locked by another insertion.
+DelaunaySMP::Status DelaunaySMP::Insert(vtkIdType ptId, LocalData& local, bool serial)
+{
+  const double* x = this->Point(ptId);
+  local.Cavity.clear();
+  local.Outside.clear();
+
+  if (local.Hint < 0 || !this->Tetra(local.Hint).Alive.load(std::memory_order_acquire))
+  {
+    local.Hint = this->StartTetra;
+  }
+  // Like vtkDelaunay3D::FindTetra(), a point the walk cannot locate when
+  // inserting serially is rejected.
+  const vtkIdType tetraId = this->Walk(x, local.Hint);
+  if (tetraId < 0)
+  {
+    return serial ? Degenerate : Conflict;
+  }
+  if (!this->TryLock(tetraId, local.Token))
+  {
+    return Conflict;
+  }
+  DelaunaySMPTetra& tetra = this->Tetra(tetraId);
+  if (!tetra.Alive || !this->Contains(tetra, x))
+  {
+    this->Unlock(tetraId);
+    return serial ? Degenerate : Conflict;
+  }
+  tetra.Mark = 1;
+  local.Cavity.push_back(tetraId);
+
+  // Gather the tetras whose circumsphere contains the point. The faces of
+  // the cavity must all be visible from the point: the tetras beyond the
+  // other faces, which may exist because of round-off, are added to it.
+  size_t first = 0;
+  for (int pass = 0;; ++pass)
+  {
+    if (!this->GrowCavity(x, local, first))
+    {
+      this->Release(local);
+      return Conflict;
+    }
+    first = local.Cavity.size();
+    local.Faces.clear();
+    for (vtkIdType cavityId : local.Cavity)
+    {
+      DelaunaySMPTetra& cavity = this->Tetra(cavityId);
+      for (int k = 0; k < 4; ++k)
+      {
+        DelaunaySMPFace face;
+        face.Neighbor = cavity.Neighbors[k];
+        if (face.Neighbor >= 0 && this->Tetra(face.Neighbor).Mark == 1)
+        {
+          continue;
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+          face.Points[i] = cavity.Points[TetraFaces[k][i]];
+        }
+        face.NeighborFace = 0;
+        if (face.Neighbor >= 0)
+        {
+          DelaunaySMPTetra& nei = this->Tetra(face.Neighbor);
+          while (face.NeighborFace < 3 && nei.Neighbors[face.NeighborFace] != cavityId)
+          {
+            ++face.NeighborFace;
+          }
+          if (this->FaceOrientation(face.Points[0], face.Points[1], face.Points[2], x) <= 0.0)
+          {
+            nei.Mark = 1;
+            local.Outside.erase(
+              std::find(local.Outside.begin(), local.Outside.end(), face.Neighbor));
+            local.Cavity.push_back(face.Neighbor);
+          }
+        }
+        local.Faces.push_back(face);
+      }
+    }
+    if (first == local.Cavity.size())
+    {
+      break;
+    }
+    if (pass == 16)
+    {
+      this->Release(local);
+      return Degenerate;
+    }
+  }
+
+  // The closest inserted point is one of the cavity points.
+  for (vtkIdType cavityId : local.Cavity)
+  {
+    DelaunaySMPTetra& cavity = this->Tetra(cavityId);
+    for (int i = 0; i < 4; ++i)
+    {
+      if (vtkMath::Distance2BetweenPoints(x, this->Point(cavity.Points[i])) <= this->Tolerance2)
+      {
+        this->Release(local);
+        return Duplicate;
+      }
+    }
+  }
+
+  // Each face of the cavity forms a new tetra with the point. The faces
+  // sharing an edge of the cavity boundary form neighbor tetras.
+  const vtkIdType numFaces = static_cast<vtkIdType>(local.Faces.size());
+  local.Edges.clear();
+  for (vtkIdType faceId = 0; faceId < numFaces; ++faceId)
+  {
+    const vtkIdType* pts = local.Faces[faceId].Points;
+    for (int side = 0; side < 3; ++side)
+    {
+      DelaunaySMPEdge edge;
+      edge.Points[0] = std::min(pts[(side + 1) % 3], pts[(side + 2) % 3]);
+      edge.Points[1] = std::max(pts[(side + 1) % 3], pts[(side + 2) % 3]);
+      edge.Face = faceId;
+      edge.Side = side;
+      local.Edges.push_back(edge);
+    }
+  }
+  std::sort(local.Edges.begin(), local.Edges.end());
+  if (local.Edges.size() % 2)
+  {
+    this->Release(local);
+    return Degenerate;
+  }
+  for (size_t i = 0; i < local.Edges.size(); i += 2)
+  {
+    if ((local.Edges[i] < local.Edges[i + 1]) ||
+      (i + 2 < local.Edges.size() && !(local.Edges[i + 1] < local.Edges[i + 2])))
+    {
+      this->Release(local);
+      return Degenerate;
+    }
+  }
+
+  const vtkIdType numCavity = static_cast<vtkIdType>(local.Cavity.size());
+  local.NewTetras.clear();
+  for (vtkIdType faceId = 0; faceId < numFaces; ++faceId)
+  {
+    const vtkIdType newId = (faceId < numCavity ? local.Cavity[faceId] : this->NewTetra(local));
+    if (newId < 0)
+    {
+      for (vtkIdType i = numCavity; i < faceId; ++i)
+      {
+        this->Unlock(local.NewTetras[i]);
+        local.FreeTetras.push_back(local.NewTetras[i]);
+      }
+      this->Release(local);
+      return Degenerate;
+    }
+    local.NewTetras.push_back(newId);
+  }
+
+  // Replace the cavity: write the new tetras before connecting them to the
+  // rest of the triangulation.
+  for (vtkIdType faceId = 0; faceId < numFaces; ++faceId)
+  {
+    const DelaunaySMPFace& face = local.Faces[faceId];
+    const vtkIdType pts[4] = { face.Points[0], face.Points[1], face.Points[2], ptId };
+    this->SetTetra(local.NewTetras[faceId], pts);
+    this->Tetra(local.NewTetras[faceId])
+      .Neighbors[3]
+      .store(face.Neighbor, std::memory_order_release);
+  }
+  for (size_t i = 0; i < local.Edges.size(); i += 2)
+  {
+    const DelaunaySMPEdge& edge0 = local.Edges[i];
+    const DelaunaySMPEdge& edge1 = local.Edges[i + 1];
+    const vtkIdType tetra0 = local.NewTetras[edge0.Face];
+    const vtkIdType tetra1 = local.NewTetras[edge1.Face];
+    this->Tetra(tetra0).Neighbors[edge0.Side].store(tetra1, std::memory_order_release);
+    this->Tetra(tetra1).Neighbors[edge1.Side].store(tetra0, std::memory_order_release);
+  }
+  for (vtkIdType faceId = 0; faceId < numFaces; ++faceId)
+  {
+    const DelaunaySMPFace& face = local.Faces[faceId];
+    if (face.Neighbor >= 0)
+    {
+      this->Tetra(face.Neighbor)
+        .Neighbors[face.NeighborFace]
+        .store(local.NewTetras[faceId], std::memory_order_release);
+    }
+  }
+  for (vtkIdType i = numFaces; i < numCavity; ++i)
+  {
+    this->Tetra(local.Cavity[i]).Alive.store(false, std::memory_order_release);
+    local.FreeTetras.push_back(local.Cavity[i]);
+  }
+  this->Release(local);
+  for (vtkIdType i = numCavity; i < numFaces; ++i)
+  {
+    this->Unlock(local.NewTetras[i]);
+  }
+  local.Hint = local.NewTetras[0];
+
+  return Inserted;
+}
+
+//------------------------------------------------------------------------------
+// Insert a batch of points in parallel, postponing the conflicting ones.
+struct DelaunaySMPInsert
+{
+  DelaunaySMP* Triangulation;
+  const vtkIdType* PointIds;
+  std::atomic<vtkIdType> NumberOfDuplicatePoints;
+  std::atomic<vtkIdType> NumberOfDegeneracies;
+
+  DelaunaySMPInsert(DelaunaySMP* triangulation, const vtkIdType* pointIds)
+    : Triangulation(triangulation)
+    , PointIds(pointIds)
+    , NumberOfDuplicatePoints(0)
+    , NumberOfDegeneracies(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    DelaunaySMP::LocalData& local = this->Triangulation->Locals.Local();
+    local.Token = ++this->Triangulation->Tokens;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (this->PointIds[i] < 0)
+      {
+        continue;
+      }
+      switch (this->Triangulation->Insert(this->PointIds[i], local, false))
+      {
+        case DelaunaySMP::Duplicate:
+          ++this->NumberOfDuplicatePoints;
+          break;
+        case DelaunaySMP::Degenerate:
+          ++this->NumberOfDegeneracies;
+          break;
+        case DelaunaySMP::Conflict:
+          local.Postponed.push_back(this->PointIds[i]);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+};
+
+//------------------------------------------------------------------------------
+// The points are inserted in the rounds of a biased randomized insertion
+// order. Each round is sorted along a Hilbert curve and split among the
+// threads, so that they mostly work in distinct regions. The first round, a
+// few thousand points, is inserted serially.
+bool DelaunaySMP::InsertPoints(vtkDelaunay3D* self)
+{
+  const vtkIdType numPts = this->NumberOfPoints;
+  const InsertionRounds rounds(numPts, 2048);
+  const int numRounds = rounds.GetNumberOfRounds();
+
+  double bounds[6] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN,
+    VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    const double* x = this->Point(ptId);
+    for (int i = 0; i < 3; ++i)
+    {
+      bounds[2 * i] = std::min(bounds[2 * i], x[i]);
+      bounds[2 * i + 1] = std::max(bounds[2 * i + 1], x[i]);
+    }
+  }
+
+  std::vector<std::pair<uint64_t, vtkIdType>> order(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    const double maxCoord = static_cast<double>((1u << HilbertBits) - 1);
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      const double* x = this->Point(ptId);
+      unsigned int coords[3];
+      for (int i = 0; i < 3; ++i)
+      {
+        const double length = bounds[2 * i + 1] - bounds[2 * i];
+        coords[i] = static_cast<unsigned int>(
+          length > 0.0 ? maxCoord * (x[i] - bounds[2 * i]) / length : 0.0);
+      }
+      const uint64_t key = HilbertKey(coords);
+      const int round = rounds.GetRound(key);
+      order[ptId].first = (static_cast<uint64_t>(round) << (3 * HilbertBits)) | key;
+      order[ptId].second = ptId;
+    }
+  });
+  vtkSMPTools::Sort(order.begin(), order.end());
+
+  // Coincident points follow each other, sorted by id: like in serial, only
+  // the first one is inserted.
+  std::vector<vtkIdType> pointIds(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const double* x = this->Point(order[i].second);
+      pointIds[i] = order[i].second;
+      for (vtkIdType j = i - 1; j >= 0 && order[j].first == order[i].first; --j)
+      {
+        const double* y = this->Point(order[j].second);
+        if (x[0] == y[0] && x[1] == y[1] && x[2] == y[2])
+        {
+          pointIds[i] = -1;
+          break;
+        }
+      }
+    }
+  });
+  this->NumberOfDuplicatePoints = std::count(pointIds.begin(), pointIds.end(), -1);
+
+  std::vector<vtkIdType> retry, next;
+  LocalData& mainLocal = this->Locals.Local();
+  vtkIdType begin = 0;
+  for (int round = 0; round < numRounds && begin < numPts; ++round)
+  {
+    const uint64_t endKey = static_cast<uint64_t>(round + 1) << (3 * HilbertBits);
+    const vtkIdType end = std::lower_bound(order.begin() + begin, order.end(),
+                            std::make_pair(endKey, static_cast<vtkIdType>(0))) -
+      order.begin();
+    const vtkIdType* ids = pointIds.data() + begin;
+    vtkIdType numIds = end - begin;
+
+    // Parallel passes, as long as enough points are left
+    for (int pass = 0; round > 0 && pass < 4 && numIds >= 256; ++pass)
+    {
+      this->StartTetra = this->LiveTetra();
+      DelaunaySMPInsert insert(this, ids);
+      vtkSMPTools::For(0, numIds, insert);
+      this->NumberOfDuplicatePoints += insert.NumberOfDuplicatePoints;
+      this->NumberOfDegeneracies += insert.NumberOfDegeneracies;
+      next.clear();
+      for (LocalData& local : this->Locals)
+      {
+        next.insert(next.end(), local.Postponed.begin(), local.Postponed.end());
+        local.Postponed.clear();
+      }
+      std::swap(retry, next);
+      ids = retry.data();
+      numIds = static_cast<vtkIdType>(retry.size());
+    }
+
+    // Serial insertion of what is left
+    mainLocal.Hint = this->StartTetra = this->LiveTetra();
+    mainLocal.Token = ++this->Tokens;
+    for (vtkIdType i = 0; i < numIds; ++i)
+    {
+      if (ids[i] < 0)
+      {
+        continue;
+      }
+      switch (this->Insert(ids[i], mainLocal, true))
+      {
+        case Duplicate:
+          ++this->NumberOfDuplicatePoints;
+          break;
+        case Degenerate:
+          ++this->NumberOfDegeneracies;
+          break;
+        default:
+          break;
+      }
+    }
+
+    begin = end;
+    self->UpdateProgress(static_cast<double>(begin) / numPts);
+    if (self->CheckAbort())
+    {
+      break;
+    }
+  }
+  return this->NumberOfBlocks <= MaxBlocks;
+}
+
+//------------------------------------------------------------------------------
+void DelaunaySMP::ExtractTetras(bool keepBounding, vtkCellArray* cells, vtkTetraArray* spheres)
+{
+  const vtkIdType numBlocks = std::min(this->NumberOfBlocks.load(), MaxBlocks);
+  const vtkIdType numPts = this->NumberOfPoints;
+  auto isKept = [&](const DelaunaySMPTetra& tetra) {
+    return tetra.Alive &&
+      (keepBounding ||
+        (tetra.Points[0] < numPts && tetra.Points[1] < numPts && tetra.Points[2] < numPts &&
+          tetra.Points[3] < numPts));
+  };
+
+  std::vector<vtkIdType> offsets(numBlocks + 1, 0);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType block = begin; block < end; ++block)
+    {
+      const DelaunaySMPTetra* tetras = this->Blocks[block].get();
+      offsets[block] = std::count_if(tetras, tetras + BlockSize, isKept);
+    }
+  });
+  const vtkIdType numTetras =
+    vtkSMPTools::ExclusiveScan(offsets.begin(), offsets.end(), offsets.begin(), vtkIdType(0));
+  if (spheres)
+  {
+    spheres->Resize(numTetras);
+  }
+
+  vtkNew<vtkIdTypeArray> cellOffsets;
+  cellOffsets->SetNumberOfValues(numTetras + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(4 * numTetras);
+  vtkIdType* cellOffset = cellOffsets->GetPointer(0);
+  vtkIdType* conn = connectivity->GetPointer(0);
+  vtkSMPTools::For(0, numBlocks, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType block = begin; block < end; ++block)
+    {
+      const DelaunaySMPTetra* tetras = this->Blocks[block].get();
+      vtkIdType cellId = offsets[block];
+      for (vtkIdType i = 0; i < BlockSize; ++i)
+      {
+        const DelaunaySMPTetra& tetra = tetras[i];
+        if (!isKept(tetra))
+        {
+          continue;
+        }
+        cellOffset[cellId] = 4 * cellId;
+        for (int j = 0; j < 4; ++j)
+        {
+          conn[4 * cellId + j] = tetra.Points[j];
+        }
+        if (spheres)
+        {
+          vtkDelaunayTetra* sphere = spheres->GetTetra(cellId);
+          sphere->r2 = tetra.Radius2;
+          std::copy(tetra.Center, tetra.Center + 3, sphere->center);
+        }
+        ++cellId;
+      }
+    }
+  });
+  cellOffset[numTetras] = 4 * numTetras;
+  cells->SetData(cellOffsets, connectivity);
+}
+} // anonymous namespace
+
 // vtkDelaunay3D methods
 //
 
@@ -139,6 +1061,7 @@ vtkDelaunay3D::vtkDelaunay3D()
   this->BoundingTriangulation = 0;
   this->Offset = 2.5;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->EnableSMP = false;
   this->Locator = nullptr;
   this->TetraArray = nullptr;
   this->References = nullptr;
@@ -491,31 +1414,71 @@ int vtkDelaunay3D::RequestData(vtkInformation* vtkNotUsed(request),
 
   points->Allocate(numPoints + 6);
 
-  Mesh = this->InitPointInsertion(center, this->Offset * tol, numPoints, points);
-
-  // Insert each point into triangulation. Points laying "inside"
-  // of tetra cause tetra to be deleted, leaving a void with bounding
-  // faces. Combination of point and each face is used to form new
-  // tetrahedra.
-  for (ptId = 0; ptId < numPoints; ptId++)
+  vtkSmartPointer<vtkCellArray> outputTetras;
+  if (this->EnableSMP)
   {
-    inPoints->GetPoint(ptId, x);
-
-    this->InsertPoint(Mesh, points, ptId, x, holeTetras);
+    // Threaded insertion, see the class documentation. Without alpha shape
+    // the output tetras are gathered directly, otherwise they are placed in
+    // the mesh for the serial extraction of the alpha shape.
+    DelaunaySMP triangulation(inPoints, center, this->Offset * tol, this->Tolerance * tol, points);
+    if (!triangulation.InsertPoints(this))
+    {
+      vtkErrorMacro("Cannot triangulate; too many tetrahedra");
+      points->Delete();
+      cells->Delete();
+      holeTetras->Delete();
+      return 0;
+    }
+    this->NumberOfDuplicatePoints = static_cast<int>(triangulation.NumberOfDuplicatePoints);
+    this->NumberOfDegeneracies = static_cast<int>(triangulation.NumberOfDegeneracies);
+
+    Mesh = vtkUnstructuredGrid::New();
+    Mesh->EditableOn();
+    Mesh->SetPoints(points);
+    points->Delete();
+    vtkNew<vtkCellArray> tetras;
+    if (this->Alpha > 0.0)
+    {
+      delete this->TetraArray;
+      this->TetraArray = new vtkTetraArray(5 * numPoints, numPoints);
+      triangulation.ExtractTetras(true, tetras, this->TetraArray);
+      Mesh->SetCells(VTK_TETRA, tetras);
+      Mesh->BuildLinks();
+    }
+    else
+    {
+      triangulation.ExtractTetras(this->BoundingTriangulation, tetras, nullptr);
+      outputTetras = tetras;
+    }
+  }
+  else
+  {
+    Mesh = this->InitPointInsertion(center, this->Offset * tol, numPoints, points);
 
-    if (!(ptId % 250))
+    // Insert each point into triangulation. Points laying "inside"
+    // of tetra cause tetra to be deleted, leaving a void with bounding
+    // faces. Combination of point and each face is used to form new
+    // tetrahedra.
+    for (ptId = 0; ptId < numPoints; ptId++)
     {
-      vtkDebugMacro(<< "point #" << ptId);
-      this->UpdateProgress(static_cast<double>(ptId) / numPoints);
-      if (this->CheckAbort())
+      inPoints->GetPoint(ptId, x);
+
+      this->InsertPoint(Mesh, points, ptId, x, holeTetras);
+
+      if (!(ptId % 250))
       {
-        break;
+        vtkDebugMacro(<< "point #" << ptId);
+        this->UpdateProgress(static_cast<double>(ptId) / numPoints);
+        if (this->CheckAbort())
+        {
+          break;
+        }
       }
-    }
 
-  } // for all points
+    } // for all points
 
-  this->EndPointInsertion();
+    this->EndPointInsertion();
+  }
 
   vtkDebugMacro(<< "Triangulated " << numPoints << " points, " << this->NumberOfDuplicatePoints
                 << " of which were duplicates");
@@ -528,7 +1491,10 @@ int vtkDelaunay3D::RequestData(vtkInformation* vtkNotUsed(request),
 
   // Send appropriate portions of triangulation to output
   //
-  output->Allocate(5 * numPoints);
+  if (!outputTetras)
+  {
+    output->Allocate(5 * numPoints);
+  }
   numTetras = Mesh->GetNumberOfCells();
   tetraUse = new char[numTetras];
 
@@ -543,7 +1509,7 @@ int vtkDelaunay3D::RequestData(vtkInformation* vtkNotUsed(request),
 
   // if boundary triangulation not desired, delete tetras connected to
   // boundary points
-  if (!this->BoundingTriangulation)
+  if (!this->BoundingTriangulation && !outputTetras)
   {
     for (ptId = numPoints; ptId < (numPoints + 6); ptId++)
     {
@@ -750,6 +1716,10 @@ int vtkDelaunay3D::RequestData(vtkInformation* vtkNotUsed(request),
     output->GetPointData()->PassData(input->GetPointData());
   }
 
+  if (outputTetras)
+  {
+    output->SetCells(VTK_TETRA, outputTetras);
+  }
   for (i = 0; i < numTetras; i++)
   {
     if (tetraUse[i] == 2)
@@ -1074,6 +2044,7 @@ void vtkDelaunay3D::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "EnableSMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 
 //------------------------------------------------------------------------------
@@ -87,6 +87,24 @@
  * will be found. However, in degenerate cases an enclosing tetrahedron may
  * not be found and the point will be rejected.
  *
+ * When EnableSMP is on, the points are inserted by several threads using
+ * vtkSMPTools. They are first sorted along a Hilbert curve in rounds of
+ * increasing size (a biased randomized insertion order, or BRIO), which
+ * keeps each thread working in its own region of the mesh. Each thread then
+ * walks to the tetrahedron containing its next point and locks the cavity
+ * of tetrahedra violating the Delaunay criterion before replacing it; a point
+ * whose cavity is already locked by another thread is retried later, the last
+ * ones serially. As in serial, a point the walk cannot locate is rejected.
+ * The tetrahedra are output in another order, and may differ from the serial
+ * ones where the triangulation is not unique, e.g. for cospherical points.
+ * Points closer than Tolerance (times the diagonal length of the bounding
+ * box) to an inserted point are discarded; the Locator is not used. The
+ * Alpha, Offset and BoundingTriangulation options are honored; when Alpha is
+ * non-zero, the alpha shape is extracted serially from the threaded
+ * triangulation. Its triangles on the convex hull, when BoundingTriangulation
+ * is off, depend on the order of the tetrahedra and may differ from the
+ * serial ones.
+ *
  * @sa
  * vtkDelaunay2D vtkGaussianSplatter vtkUnstructuredGrid
  */
@@ -264,6 +282,18 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded point insertion. The tetrahedra do not come
+   * in the serial order, the Locator is not used, and without
+   * BoundingTriangulation the alpha triangles on the convex hull may differ
+   * from the serial ones. Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
 protected:
   vtkDelaunay3D();
   ~vtkDelaunay3D() override;
@@ -279,6 +309,7 @@ protected:
   vtkTypeBool BoundingTriangulation;
   double Offset;
   int OutputPointsPrecision;
+  bool EnableSMP;
 
   vtkIncrementalPointLocator* Locator; // help locate points faster
 
@@ -33,6 +33,7 @@
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <cmath>
+#include <vector>
 
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkFlyingEdges3D);
@@ -40,6 +41,19 @@ vtkStandardNewMacro(vtkFlyingEdges3D);
 //------------------------------------------------------------------------------
 namespace
 {
+// Number of output points and triangles generated along a x-row. Prefix
+// summed to obtain where each row writes its output.
+struct RowCounts
+{
+  vtkIdType Points;
+  vtkIdType Tris;
+
+  static RowCounts Sum(const RowCounts& a, const RowCounts& b)
+  {
+    return { a.Points + b.Points, a.Tris + b.Tris };
+  }
+};
+
 // This templated class implements the heart of the algorithm.
 // vtkFlyingEdges3D populates the information in this class and
 // then invokes Contour() to actually initiate execution.
@@ -1353,11 +1367,9 @@ void vtkFlyingEdges3DAlgorithm<T>::Contour(vtkFlyingEdges3D* self, vtkImageData*
 {
   double value, *values = self->GetValues();
   vtkIdType numContours = self->GetNumberOfContours();
-  vtkIdType vidx, row, slice, *eMD, zInc;
-  vtkIdType numOutXPts, numOutYPts, numOutZPts, numOutTris;
-  vtkIdType numXPts = 0, numYPts = 0, numZPts = 0, numTris = 0;
-  vtkIdType startXPts, startYPts, startZPts, startTris;
-  startXPts = startYPts = startZPts = startTris = 0;
+  vtkIdType vidx;
+  RowCounts numOut{ 0, 0 };
+  RowCounts start{ 0, 0 };
 
   // This may be subvolume of the total 3D image. Capture information for
   // subsequent processing.
@@ -1419,42 +1431,37 @@ void vtkFlyingEdges3DAlgorithm<T>::Contour(vtkFlyingEdges3D* self, vtkImageData*
 
     // PASS 3: Now allocate and generate output. First we have to update the
     // edge meta data to partition the output into separate pieces so
-    // independent threads can write without collisions. Once allocation is
-    // complete, the volume is processed on a voxel row by row basis to
-    // produce output points and triangles, and interpolate point attribute
-    // data (as necessary). NOTE: This implementation is serial. It is
-    // possible to use a threaded prefix sum to make it even faster. Since
-    // this pass usually takes a small amount of time, we choose simplicity
-    // over performance.
-    numOutXPts = startXPts;
-    numOutYPts = startYPts;
-    numOutZPts = startZPts;
-    numOutTris = startTris;
-
-    // Count number of points and tris generate along each cell row
-    for (slice = 0; slice < algo.Dims[2]; ++slice)
-    {
-      zInc = slice * algo.Dims[1];
-      for (row = 0; row < algo.Dims[1]; ++row)
+    // independent threads can write without collisions. This is a threaded
+    // prefix sum over the number of points and tris generated along each
+    // x-row. Once allocation is complete, the volume is processed on a voxel
+    // row by row basis to produce output points and triangles, and
+    // interpolate point attribute data (as necessary).
+    std::vector<RowCounts> rowOffsets(algo.NumberOfEdges);
+    vtkSMPTools::For(0, algo.NumberOfEdges, [&](vtkIdType row, vtkIdType endRow) {
+      for (; row < endRow; ++row)
       {
-        eMD = algo.EdgeMetaData + (zInc + row) * 6;
-        numXPts = eMD[0];
-        numYPts = eMD[1];
-        numZPts = eMD[2];
-        numTris = eMD[3];
-        eMD[0] = numOutXPts + numOutYPts + numOutZPts;
+        const vtkIdType* eMD = algo.EdgeMetaData + row * 6;
+        rowOffsets[row] = { eMD[0] + eMD[1] + eMD[2], eMD[3] };
+      }
+    });
+    numOut = vtkSMPTools::ExclusiveScan(
+      rowOffsets.begin(), rowOffsets.end(), rowOffsets.begin(), start, RowCounts::Sum);
+    vtkSMPTools::For(0, algo.NumberOfEdges, [&](vtkIdType row, vtkIdType endRow) {
+      for (; row < endRow; ++row)
+      {
+        vtkIdType* eMD = algo.EdgeMetaData + row * 6;
+        const vtkIdType numXPts = eMD[0];
+        const vtkIdType numYPts = eMD[1];
+        eMD[0] = rowOffsets[row].Points;
         eMD[1] = eMD[0] + numXPts;
         eMD[2] = eMD[1] + numYPts;
-        eMD[3] = numOutTris;
-        numOutXPts += numXPts;
-        numOutYPts += numYPts;
-        numOutZPts += numZPts;
-        numOutTris += numTris;
+        eMD[3] = rowOffsets[row].Tris;
       }
-    }
+    });
+    const vtkIdType numOutTris = numOut.Tris;
 
     // Output can now be allocated.
-    vtkIdType totalPts = numOutXPts + numOutYPts + numOutZPts;
+    vtkIdType totalPts = numOut.Points;
     if (totalPts > 0)
     {
       newPts->GetData()->WriteVoidPointer(0, 3 * totalPts);
@@ -1507,10 +1514,7 @@ void vtkFlyingEdges3DAlgorithm<T>::Contour(vtkFlyingEdges3D* self, vtkImageData*
     } // if anything generated
 
     // Handle multiple contours
-    startXPts = numOutXPts;
-    startYPts = numOutYPts;
-    startZPts = numOutZPts;
-    startTris = numOutTris;
+    start = numOut;
 
     // Process Cell Data: Some applications require the production of cell
     // data. Since this slows the filter, we only perform this operation if
@@ -0,0 +1,88 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkInsertionRoundsInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkInsertionRoundsInternal
+ * @brief   rounds of a biased randomized insertion order
+ *
+ * vtkInsertionRoundsInternal assigns the points inserted by the Delaunay
+ * triangulations to the rounds of a biased randomized insertion order
+ * (Amenta, Choi and Rote, "Incremental constructions con BRIO", 2003): a
+ * point is in the last round with probability 1/2, in the one before with
+ * probability 1/4, and so on, the first round holding the remaining points.
+ * Each round is then sorted along a Hilbert curve, so that a point is
+ * inserted close to the points inserted just before it, while the rounds
+ * keep the insertion order random enough to avoid the worst cases of a
+ * purely spatial order. The round of a point is given by a splitmix64 hash
+ * of its Hilbert key instead of a random number, so that the order does not
+ * depend on the thread count and coincident points are in the same round.
+ *
+ * @warning
+ * This file is meant as a private include file to avoid code duplication. At
+ * this time it is not meant to define a public API (the API is likely to change
+ * in the future). If you write code that depends on this include, be prepared to
+ * change it in the future (without complaint).
+ *
+ * @sa
+ * vtkDelaunay2D vtkDelaunay3D
+ */
+
+#ifndef vtkInsertionRoundsInternal_h
+#define vtkInsertionRoundsInternal_h
+
+#include "vtkType.h"
+
+#include <cstdint>
+
+namespace
+{ // anonymous namespace
+
+class InsertionRounds
+{
+public:
+  // Rounds of numPts points, the first one holding on average between
+  // firstRoundSize and twice as many points.
+  InsertionRounds(vtkIdType numPts, vtkIdType firstRoundSize)
+  {
+    while (this->NumberOfRounds < 32 && (numPts >> this->NumberOfRounds) >= firstRoundSize)
+    {
+      ++this->NumberOfRounds;
+    }
+  }
+
+  int GetNumberOfRounds() const { return this->NumberOfRounds; }
+
+  // Round, in [0, GetNumberOfRounds()), of the point of the given Hilbert key.
+  int GetRound(uint64_t key) const
+  {
+    uint64_t hash = key + 0x9e3779b97f4a7c15ull;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+    int round = this->NumberOfRounds - 1;
+    for (; round > 0 && !(hash & 1u); hash >>= 1)
+    {
+      --round;
+    }
+    return round;
+  }
+
+private:
+  int NumberOfRounds = 1;
+};
+
+} // anonymous namespace
+
+#endif // vtkInsertionRoundsInternal_h
+// VTK-HeaderTest-Exclude: vtkInsertionRoundsInternal.h
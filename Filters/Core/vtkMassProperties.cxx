@@ -20,8 +20,12 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
-#include "vtkSmartPointer.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
 
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkMassProperties);
@@ -50,88 +54,36 @@ vtkMassProperties::vtkMassProperties()
 // Destroy any allocated memory.
 vtkMassProperties::~vtkMassProperties() = default;
 
+namespace
+{
 //------------------------------------------------------------------------------
-// Description:
-// This method measures volume, surface area, and normalized shape index.
-// Currently, the input is a ploydata which consists of triangles.
-int vtkMassProperties::RequestData(vtkInformation* vtkNotUsed(request),
-  vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector))
+// Integrals accumulated over the triangles of the input. They are combined
+// with vtkSMPTools::Reduce so that the result does not depend on the number
+// of threads.
+struct MassIntegrals
 {
-  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
-
-  // call ExecuteData
-  vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
-
-  vtkIdType cellId, numCells, numPts, numIds;
-  double p[3];
-
-  numCells = input->GetNumberOfCells();
-  numPts = input->GetNumberOfPoints();
-  if (numCells < 1 || numPts < 1)
+  double SurfaceArea = 0.0;
+  double MinCellArea = VTK_DOUBLE_MAX;
+  double MaxCellArea = 0.0;
+  double Vol[3] = { 0.0, 0.0, 0.0 };
+  double VolumeProjected = 0.0;
+  // Counts of the maximum unit normal components, and of the ties
+  double Munc[3] = { 0.0, 0.0, 0.0 };
+  double Wxyz = 0.0;
+  double Wxy = 0.0;
+  double Wxz = 0.0;
+  double Wyz = 0.0;
+  // Type of the first cell that is not a triangle, if any
+  int NonTriangleType = -1;
+  bool Unpredicted = false;
+
+  void AddTriangle(const double x[3], const double y[3], const double z[3])
   {
-    vtkErrorMacro(<< "No data to measure...!");
-    return 1;
-  }
-
-  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
-  ptIds->Allocate(VTK_CELL_SIZE);
-
-  // Traverse all cells, obtaining node coordinates.
-  //
-  double vol[3], kxyz[3];
-  double xp[3]; // to compute volumeproj
-  double munc[3], wxyz, wxy, wxz, wyz;
-  double area, surfacearea;
-  double volumeproj;
-  double mincellarea, maxcellarea;
-  double a, b, c, s;
-  double x[3], y[3], z[3];
-  double i[3], j[3], k[3], u[3], absu[3], length;
-  double ii[3], jj[3], kk[3];
-  double xavg, yavg, zavg;
-  vtkIdType idx;
-
-  // Initialize variables ...
-  //
-  surfacearea = 0.0;
-  volumeproj = 0.0;
-  mincellarea = VTK_DOUBLE_MAX;
-  maxcellarea = 0.0;
-  wxyz = 0;
-  wxy = 0.0;
-  wxz = 0.0;
-  wyz = 0.0;
-  for (idx = 0; idx < 3; idx++)
-  {
-    munc[idx] = 0.0;
-    vol[idx] = 0.0;
-    kxyz[idx] = 0.0;
-  }
-
-  for (cellId = 0; cellId < numCells; cellId++)
-  {
-    if (this->CheckAbort())
-    {
-      break;
-    }
-    if (input->GetCellType(cellId) != VTK_TRIANGLE)
-    {
-      vtkWarningMacro(<< "Input data type must be VTK_TRIANGLE not " << input->GetCellType(cellId));
-      continue;
-    }
-    input->GetCellPoints(cellId, ptIds);
-    numIds = ptIds->GetNumberOfIds();
-    assert(numIds == 3);
-
-    // store current vertex (x,y,z) coordinates ...
-    //
-    for (idx = 0; idx < numIds; idx++)
-    {
-      input->GetPoint(ptIds->GetId(idx), p);
-      x[idx] = p[0];
-      y[idx] = p[1];
-      z[idx] = p[2];
-    }
+    double i[3], j[3], k[3], u[3], absu[3], length;
+    double ii[3], jj[3], kk[3];
+    double xp[3]; // to compute volumeproj
+    double a, b, c, s, area;
+    double xavg, yavg, zavg;
 
     // get i j k vectors ...
     //
@@ -173,36 +125,36 @@ int vtkMassProperties::RequestData(vtkInformation* vtkNotUsed(request),
 
     if ((absu[0] > absu[1]) && (absu[0] > absu[2]))
     {
-      munc[0]++;
+      this->Munc[0]++;
     }
     else if ((absu[1] > absu[0]) && (absu[1] > absu[2]))
     {
-      munc[1]++;
+      this->Munc[1]++;
     }
     else if ((absu[2] > absu[0]) && (absu[2] > absu[1]))
     {
-      munc[2]++;
+      this->Munc[2]++;
     }
     else if ((absu[0] == absu[1]) && (absu[0] == absu[2]))
     {
-      wxyz++;
+      this->Wxyz++;
     }
     else if ((absu[0] == absu[1]) && (absu[0] > absu[2]))
     {
-      wxy++;
+      this->Wxy++;
     }
     else if ((absu[0] == absu[2]) && (absu[0] > absu[1]))
     {
-      wxz++;
+      this->Wxz++;
     }
     else if ((absu[1] == absu[2]) && (absu[0] < absu[2]))
     {
-      wyz++;
+      this->Wyz++;
     }
     else
     {
-      vtkErrorMacro(<< "Unpredicted situation...!");
-      return 1;
+      this->Unpredicted = true;
+      return;
     }
 
     // This is reduced to ...
@@ -224,14 +176,14 @@ int vtkMassProperties::RequestData(vtkInformation* vtkNotUsed(request),
     c = sqrt(ii[2] + jj[2] + kk[2]);
     s = 0.5 * (a + b + c);
     area = sqrt(fabs(s * (s - a) * (s - b) * (s - c)));
-    surfacearea += area;
-    if (area < mincellarea)
+    this->SurfaceArea += area;
+    if (area < this->MinCellArea)
     {
-      mincellarea = area;
+      this->MinCellArea = area;
     }
-    if (area > maxcellarea)
+    if (area > this->MaxCellArea)
     {
-      maxcellarea = area;
+      this->MaxCellArea = area;
     }
 
     // volume elements ...
@@ -240,28 +192,140 @@ int vtkMassProperties::RequestData(vtkInformation* vtkNotUsed(request),
     yavg = (y[0] + y[1] + y[2]) / 3.0;
     xavg = (x[0] + x[1] + x[2]) / 3.0;
 
-    vol[2] += (area * u[2] * zavg);
-    vol[1] += (area * u[1] * yavg);
-    vol[0] += (area * u[0] * xavg);
+    this->Vol[2] += (area * u[2] * zavg);
+    this->Vol[1] += (area * u[1] * yavg);
+    this->Vol[0] += (area * u[0] * xavg);
 
     // V  =  (z1+z2+z3)(x1y2-x2y1+x2y3-x3y2+x3y1-x1y3)/6
     // Volume under triangle is projected area of the triangle times
     // the average of the three z values
     vtkMath::Cross(x, y, xp);
-    volumeproj += zavg * (xp[0] + xp[1] + xp[2]) / 2;
+    this->VolumeProjected += zavg * (xp[0] + xp[1] + xp[2]) / 2;
+  }
+
+  static MassIntegrals Combine(const MassIntegrals& m0, const MassIntegrals& m1)
+  {
+    MassIntegrals m;
+    m.SurfaceArea = m0.SurfaceArea + m1.SurfaceArea;
+    m.MinCellArea = std::min(m0.MinCellArea, m1.MinCellArea);
+    m.MaxCellArea = std::max(m0.MaxCellArea, m1.MaxCellArea);
+    for (int idx = 0; idx < 3; idx++)
+    {
+      m.Vol[idx] = m0.Vol[idx] + m1.Vol[idx];
+      m.Munc[idx] = m0.Munc[idx] + m1.Munc[idx];
+    }
+    m.VolumeProjected = m0.VolumeProjected + m1.VolumeProjected;
+    m.Wxyz = m0.Wxyz + m1.Wxyz;
+    m.Wxy = m0.Wxy + m1.Wxy;
+    m.Wxz = m0.Wxz + m1.Wxz;
+    m.Wyz = m0.Wyz + m1.Wyz;
+    m.NonTriangleType = m0.NonTriangleType >= 0 ? m0.NonTriangleType : m1.NonTriangleType;
+    m.Unpredicted = m0.Unpredicted || m1.Unpredicted;
+    return m;
+  }
+};
+} // anonymous namespace
+
+//------------------------------------------------------------------------------
+// Description:
+// This method measures volume, surface area, and normalized shape index.
+// Currently, the input is a ploydata which consists of triangles.
+int vtkMassProperties::RequestData(vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector, vtkInformationVector* vtkNotUsed(outputVector))
+{
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+
+  // call ExecuteData
+  vtkPolyData* input = vtkPolyData::SafeDownCast(inInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  vtkIdType numCells, numPts;
+
+  numCells = input->GetNumberOfCells();
+  numPts = input->GetNumberOfPoints();
+  if (numCells < 1 || numPts < 1)
+  {
+    vtkErrorMacro(<< "No data to measure...!");
+    return 1;
+  }
+
+  // Cells are accessed concurrently, build them beforehand.
+  if (input->NeedToBuildCells())
+  {
+    input->BuildCells();
+  }
+
+  // Traverse all cells, obtaining node coordinates.
+  //
+  vtkPoints* points = input->GetPoints();
+  const MassIntegrals integrals = vtkSMPTools::Reduce(0, numCells, MassIntegrals(),
+    [&](vtkIdType cellId, vtkIdType endCellId, MassIntegrals& local) {
+      vtkNew<vtkIdList> ptIds;
+      vtkIdType numIds;
+      const vtkIdType* pts;
+      double p[3];
+      double x[3], y[3], z[3];
+      bool isFirst = vtkSMPTools::GetSingleThread();
+      for (; cellId < endCellId; cellId++)
+      {
+        if (isFirst)
+        {
+          this->CheckAbort();
+        }
+        if (this->GetAbortOutput())
+        {
+          break;
+        }
+        const int cellType = input->GetCellType(cellId);
+        if (cellType != VTK_TRIANGLE)
+        {
+          if (local.NonTriangleType < 0)
+          {
+            local.NonTriangleType = cellType;
+          }
+          continue;
+        }
+        input->GetCellPoints(cellId, numIds, pts, ptIds);
+        assert(numIds == 3);
+
+        // store current vertex (x,y,z) coordinates ...
+        //
+        for (vtkIdType idx = 0; idx < numIds; idx++)
+        {
+          points->GetPoint(pts[idx], p);
+          x[idx] = p[0];
+          y[idx] = p[1];
+          z[idx] = p[2];
+        }
+        local.AddTriangle(x, y, z);
+      }
+    },
+    MassIntegrals::Combine);
+
+  if (integrals.NonTriangleType >= 0)
+  {
+    vtkWarningMacro(<< "Input data type must be VTK_TRIANGLE not " << integrals.NonTriangleType);
+  }
+  if (integrals.Unpredicted)
+  {
+    vtkErrorMacro(<< "Unpredicted situation...!");
+    return 1;
   }
 
   // Surface Area ...
   //
+  const double surfacearea = integrals.SurfaceArea;
+  const double* munc = integrals.Munc;
+  const double* vol = integrals.Vol;
+  double kxyz[3];
   this->SurfaceArea = surfacearea;
-  this->MinCellArea = mincellarea;
-  this->MaxCellArea = maxcellarea;
+  this->MinCellArea = integrals.MinCellArea;
+  this->MaxCellArea = integrals.MaxCellArea;
 
   // Weighting factors in Discrete Divergence theorem for volume calculation.
   //
-  kxyz[0] = (munc[0] + (wxyz / 3.0) + ((wxy + wxz) / 2.0)) / numCells;
-  kxyz[1] = (munc[1] + (wxyz / 3.0) + ((wxy + wyz) / 2.0)) / numCells;
-  kxyz[2] = (munc[2] + (wxyz / 3.0) + ((wxz + wyz) / 2.0)) / numCells;
+  kxyz[0] = (munc[0] + (integrals.Wxyz / 3.0) + ((integrals.Wxy + integrals.Wxz) / 2.0)) / numCells;
+  kxyz[1] = (munc[1] + (integrals.Wxyz / 3.0) + ((integrals.Wxy + integrals.Wyz) / 2.0)) / numCells;
+  kxyz[2] = (munc[2] + (integrals.Wxyz / 3.0) + ((integrals.Wxz + integrals.Wyz) / 2.0)) / numCells;
   this->VolumeX = vol[0];
   this->VolumeY = vol[1];
   this->VolumeZ = vol[2];
@@ -270,7 +334,7 @@ int vtkMassProperties::RequestData(vtkInformation* vtkNotUsed(request),
   this->Kz = kxyz[2];
   this->Volume = (kxyz[0] * vol[0] + kxyz[1] * vol[1] + kxyz[2] * vol[2]);
   this->Volume = fabs(this->Volume);
-  this->VolumeProjected = volumeproj;
+  this->VolumeProjected = integrals.VolumeProjected;
   this->NormalizedShapeIndex = (sqrt(surfacearea) / std::cbrt(this->Volume)) / 2.199085233;
 
   return 1;
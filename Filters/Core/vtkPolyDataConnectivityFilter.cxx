@@ -17,12 +17,14 @@
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkConnectivityFilterInternal.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
@@ -59,6 +61,8 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->VisitedPointIds = vtkIdList::New();
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+
+  this->EnableSMP = false;
 }
 
 vtkPolyDataConnectivityFilter::~vtkPolyDataConnectivityFilter()
@@ -130,11 +134,14 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
     }
   }
 
-  // Build cell structure
+  // Build cell structure. The threaded implementation does not need links.
   //
   this->Mesh = vtkPolyData::New();
   this->Mesh->CopyStructure(input);
-  this->Mesh->BuildLinks();
+  if (!this->EnableSMP)
+  {
+    this->Mesh->BuildLinks();
+  }
   this->UpdateProgress(0.10);
 
   // Remove all visited point ids
@@ -185,7 +192,11 @@ int vtkPolyDataConnectivityFilter::RequestData(vtkInformation* vtkNotUsed(reques
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
-  if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+  if (this->EnableSMP)
+  {
+    largestRegionId = this->MarkRegionsSMP();
+  }
+  else if (this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
     this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION)
   { // visit all cells marking with region number
@@ -525,6 +536,40 @@ void vtkPolyDataConnectivityFilter::TraverseAndMark()
   } // while wave is not empty
 }
 
+//------------------------------------------------------------------------------
+vtkIdType vtkPolyDataConnectivityFilter::MarkRegionsSMP()
+{
+  ConnectivityRegions regions(
+    this->Mesh, this->InScalars, this->ScalarRange, this->FullScalarConnectivity != 0);
+  this->UpdateProgress(0.3);
+
+  vtkIdType largestRegionId = 0;
+  if (this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS ||
+    this->ExtractionMode == VTK_EXTRACT_CELL_SEEDED_REGIONS)
+  {
+    const bool pointSeeds = this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS;
+    this->RegionSizes->InsertValue(
+      0, regions.LabelSeededRegion(this->Seeds, pointSeeds, this->Visited));
+  }
+  else if (this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION)
+  {
+    vtkNew<vtkIdList> seeds;
+    seeds->InsertNextId(regions.FindClosestPoint(this->ClosestPoint));
+    this->RegionSizes->InsertValue(0, regions.LabelSeededRegion(seeds, true, this->Visited));
+  }
+  else
+  {
+    this->RegionNumber =
+      regions.LabelAllRegions(this->Visited, this->RegionSizes, largestRegionId);
+  }
+  this->UpdateProgress(0.6);
+
+  this->PointNumber = regions.MapPoints(
+    this->Visited, this->PointMap, vtkArrayDownCast<vtkIdTypeArray>(this->NewScalars));
+  this->UpdateProgress(0.9);
+  return largestRegionId;
+}
+
 //------------------------------------------------------------------------------
 int vtkPolyDataConnectivityFilter::IsScalarConnected(vtkIdType cellId)
 {
@@ -668,5 +713,6 @@ void vtkPolyDataConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "EnableSMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 VTK_ABI_NAMESPACE_END
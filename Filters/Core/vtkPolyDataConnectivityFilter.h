@@ -43,6 +43,14 @@
  * This use of ScalarConnectivity is particularly useful for selecting cells
  * for later processing.
  *
+ * When EnableSMP is on, the regions are labeled using vtkSMPTools: the points
+ * of the connected cells are merged with a lock-free union-find structure
+ * instead of growing each region with a wave of cells, so that no cell links
+ * are built. All extraction modes and scalar connectivity are supported, and
+ * the cells get the same regions as with the serial implementation, whatever
+ * the number of threads. The output points are ordered like the input points
+ * instead of in the order the regions are traversed.
+ *
  * @sa
  * vtkConnectivityFilter
  */
@@ -228,6 +236,20 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded labeling of the regions, which does not build
+   * the cell links of the input. All extraction modes, scalar and full scalar
+   * connectivity are supported, and the output has the cells, region sizes
+   * and visited point ids of the serial one whatever the number of threads,
+   * but its points keep the order of the input points rather than the order
+   * in which the regions were traversed. Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
 protected:
   vtkPolyDataConnectivityFilter();
   ~vtkPolyDataConnectivityFilter() override;
@@ -253,6 +275,12 @@ protected:
 
   void TraverseAndMark();
 
+  /**
+   * Threaded labeling of the regions, used instead of TraverseAndMark()
+   * when EnableSMP is on. Returns the largest region.
+   */
+  vtkIdType MarkRegionsSMP();
+
   // used to support algorithm execution
   vtkDataArray* CellScalars;
   vtkIdList* NeighborCellPointIds;
@@ -272,6 +300,7 @@ protected:
 
   vtkTypeBool MarkVisitedPointIds;
   int OutputPointsPrecision;
+  bool EnableSMP;
 
 private:
   vtkPolyDataConnectivityFilter(const vtkPolyDataConnectivityFilter&) = delete;
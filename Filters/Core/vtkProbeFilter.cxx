@@ -23,6 +23,7 @@
 #include "vtkClosestPointStrategy.h"
 #include "vtkFindCellStrategy.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -31,6 +32,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkSMPThreadLocal.h"
 #include "vtkSMPThreadLocalObject.h"
@@ -63,6 +65,52 @@ inline bool IsBlankedCell(vtkUnsignedCharArray* gcells, vtkIdType cellId)
   }
   return false;
 }
+
+// Find the cells containing the points of the input not probed yet with the
+// batched query of the cell locator. cellIds receives the cell of each point,
+// -1 for the points not found or already probed.
+void FindCellsWithLocator(vtkDataSet* input, vtkAbstractCellLocator* locator, double tol2,
+  vtkCharArray* maskArray, std::vector<vtkIdType>& cellIds)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const char* mask = maskArray->GetPointer(0);
+  std::vector<vtkIdType> probeIds;
+  probeIds.reserve(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    if (mask[ptId] == static_cast<char>(0))
+    {
+      probeIds.push_back(ptId);
+    }
+  }
+  cellIds.assign(numPts, -1);
+  if (probeIds.empty())
+  {
+    return;
+  }
+
+  // GetPoint() is thread safe after a first call.
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(static_cast<vtkIdType>(probeIds.size()));
+  double x[3];
+  input->GetPoint(probeIds[0], x);
+  vtkSMPTools::For(0, points->GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end) {
+    double p[3];
+    for (; begin < end; ++begin)
+    {
+      input->GetPoint(probeIds[begin], p);
+      points->SetPoint(begin, p);
+    }
+  });
+
+  vtkNew<vtkIdList> foundIds;
+  locator->FindCells(points, tol2, foundIds);
+  for (size_t i = 0; i < probeIds.size(); ++i)
+  {
+    cellIds[probeIds[i]] = foundIds->GetId(static_cast<vtkIdType>(i));
+  }
+}
 }
 
 //------------------------------------------------------------------------------
@@ -415,6 +463,7 @@ class vtkProbeFilter::ProbeEmptyPointsWorklet
   vtkFindCellStrategy* Strategy;
   vtkUnsignedCharArray* SourceGhostFlags;
   vtkCharArray* MaskArray;
+  const vtkIdType* CellIds;
   double Tol2;
   int MaxCellSize;
 
@@ -438,7 +487,8 @@ class vtkProbeFilter::ProbeEmptyPointsWorklet
 public:
   ProbeEmptyPointsWorklet(vtkProbeFilter* probeFilter, int sourceIndex, vtkDataSet* input,
     vtkDataSet* source, vtkPointData* outputPD, vtkFindCellStrategy* strategy,
-    vtkUnsignedCharArray* sourceGhostFlags, vtkCharArray* maskArray, double tol2, int maxCellSize)
+    vtkUnsignedCharArray* sourceGhostFlags, vtkCharArray* maskArray, const vtkIdType* cellIds,
+    double tol2, int maxCellSize)
     : ProbeFilter(probeFilter)
     , SourceIdx(sourceIndex)
     , Input(input)
@@ -449,6 +499,7 @@ public:
     , Strategy(strategy)
     , SourceGhostFlags(sourceGhostFlags)
     , MaskArray(maskArray)
+    , CellIds(cellIds)
     , Tol2(tol2)
     , MaxCellSize(maxCellSize)
   {
@@ -526,7 +577,7 @@ public:
       this->Input->GetPoint(pointId, x);
 
       foundInCache = false;
-      if (lastCellId != -1)
+      if (lastCellId != -1 && !this->CellIds)
       {
         // check if it's inside cell bounds
         insideCellBounds = lastBBox.ContainsPoint(x);
@@ -543,8 +594,19 @@ public:
       }
       if (!foundInCache)
       {
+        if (this->CellIds)
+        {
+          // the cell has been found by the batched query of the cell locator,
+          // evaluate the point in it again for the interpolation weights
+          lastCellId = this->CellIds[pointId];
+          if (lastCellId != -1)
+          {
+            this->Source->GetCell(lastCellId, currentCell);
+            currentCell->EvaluatePosition(x, nullptr, lastSubId, lastPCoords, dist2, weights);
+          }
+        }
         // strategies are used for subclasses of vtkPointSet
-        if (strategy)
+        else if (strategy)
         {
           if (cellLocatorStrategy)
           {
@@ -754,8 +816,18 @@ void vtkProbeFilter::ProbeEmptyPoints(
     }
   }
 
+  // When a cell locator is used, the cells containing the points not probed
+  // yet are found all at once by its batched, spatially ordered query.
+  std::vector<vtkIdType> cellIds;
+  auto cellLocatorStrategy = vtkCellLocatorStrategy::SafeDownCast(strategy);
+  if (cellLocatorStrategy && cellLocatorStrategy->GetCellLocator())
+  {
+    ::FindCellsWithLocator(
+      input, cellLocatorStrategy->GetCellLocator(), tol2, this->MaskPoints, cellIds);
+  }
+
   ProbeEmptyPointsWorklet worker(this, srcIdx, input, source, outPD, strategy, sourceGhostFlags,
-    this->MaskPoints, tol2, maxCellSize);
+    this->MaskPoints, cellIds.empty() ? nullptr : cellIds.data(), tol2, maxCellSize);
   vtkSMPTools::For(0, input->GetNumberOfPoints(), worker);
 
   this->MaskPoints->Modified();
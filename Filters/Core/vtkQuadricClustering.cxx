@@ -15,19 +15,30 @@
 #include "vtkQuadricClustering.h"
 
 #include "vtkCellArray.h"
+#include "vtkCellArrayIterator.h"
 #include "vtkCellData.h"
 #include "vtkExecutive.h"
 #include "vtkFeatureEdges.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTimerLog.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set> // keep track of inserted triangles
+#include <vector>
 
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkQuadricClustering);
@@ -44,6 +55,198 @@ class vtkQuadricClusteringCellSet
 };
 typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
 
+//------------------------------------------------------------------------------
+namespace
+{
+// Scale applied to the quadrics added to the bins.
+const double QuadricScale = 100000000.0;
+
+// Grids with up to that many bins, or with fewer bins than points per
+// thread, are accumulated in dense per-thread arrays by AppendSMP().
+const vtkIdType MinimumDenseBins = 65536;
+
+// We save nine coefficients of the error functions corresponding to:
+// 0: Px^2
+// 1: PxPy
+// 2: PxPz
+// 3: Px
+// 4: Py^2
+// 5: PyPz
+// 6: Py
+// 7: Pz^2
+// 8: Pz
+// We ignore the constant because it disappears with the derivative.
+
+// The error function of a triangle is the volume (squared) of the
+// tetrahedron formed by the triangle and the point.  We ignore constant
+// factors across all coefficients.
+void ComputeTriangleQuadric(double* pt0, double* pt1, double* pt2, double quadric[9])
+{
+  double quadric4x4[4][4];
+  vtkTriangle::ComputeQuadric(pt0, pt1, pt2, quadric4x4);
+  quadric[0] = quadric4x4[0][0];
+  quadric[1] = quadric4x4[0][1];
+  quadric[2] = quadric4x4[0][2];
+  quadric[3] = quadric4x4[0][3];
+  quadric[4] = quadric4x4[1][1];
+  quadric[5] = quadric4x4[1][2];
+  quadric[6] = quadric4x4[1][3];
+  quadric[7] = quadric4x4[2][2];
+  quadric[8] = quadric4x4[2][3];
+}
+
+// The error function of an edge is the square of the area of the triangle
+// formed by the edge and the point.  We ignore constants across all terms.
+// Returns false for coincident points.
+bool ComputeEdgeQuadric(const double* pt0, const double* pt1, double q[9])
+{
+  double d[3];
+  double m[3]; // The mid point of the segment.(p1 or p2 could be used also).
+
+  // Compute the direction vector of the segment.
+  d[0] = pt1[0] - pt0[0];
+  d[1] = pt1[1] - pt0[1];
+  d[2] = pt1[2] - pt0[2];
+
+  // Compute the length^2 of the line segment.
+  double length2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+
+  if (length2 == 0.0)
+  { // Coincident points.  Avoid divide by zero.
+    return false;
+  }
+
+  // Normalize the direction vector.
+  double tmp = 1.0 / sqrt(length2);
+  d[0] = d[0] * tmp;
+  d[1] = d[1] * tmp;
+  d[2] = d[2] * tmp;
+
+  // Compute the mid point of the segment.
+  m[0] = 0.5 * (pt1[0] + pt0[0]);
+  m[1] = 0.5 * (pt1[1] + pt0[1]);
+  m[2] = 0.5 * (pt1[2] + pt0[2]);
+
+  // Compute dot(m, d);
+  double md = m[0] * d[0] + m[1] * d[1] + m[2] * d[2];
+
+  q[0] = length2 * (1.0 - d[0] * d[0]);
+  q[1] = -length2 * (d[0] * d[1]);
+  q[2] = -length2 * (d[0] * d[2]);
+  q[3] = length2 * (d[0] * md - m[0]);
+  q[4] = length2 * (1.0 - d[1] * d[1]);
+  q[5] = -length2 * (d[1] * d[2]);
+  q[6] = length2 * (d[1] * md - m[1]);
+  q[7] = length2 * (1.0 - d[2] * d[2]);
+  q[8] = length2 * (d[2] * md - m[2]);
+  return true;
+}
+
+// The error function of a vertex is the length (point to vert) squared.
+// We ignore constants across all terms.
+void ComputeVertexQuadric(const double* pt, double q[9])
+{
+  q[0] = 1.0;
+  q[1] = 0.0;
+  q[2] = 0.0;
+  q[3] = -pt[0];
+  q[4] = 1.0;
+  q[5] = 0.0;
+  q[6] = -pt[1];
+  q[7] = 1.0;
+  q[8] = -pt[2];
+}
+
+// Quadric of a bin accumulated by a thread. As in the serial
+// implementation, points supersede segments, which supersede triangles.
+struct BinQuadric
+{
+  unsigned char Dimension = 255;
+  double Quadric[9];
+
+  void Add(unsigned char dimension, const double quadric[9], double scale)
+  {
+    if (dimension < this->Dimension)
+    {
+      this->Dimension = dimension;
+      std::fill(this->Quadric, this->Quadric + 9, 0.0);
+    }
+    if (dimension == this->Dimension)
+    {
+      for (int i = 0; i < 9; ++i)
+      {
+        this->Quadric[i] += quadric[i] * scale;
+      }
+    }
+  }
+
+  void Merge(const BinQuadric& other)
+  {
+    if (other.Dimension <= 2)
+    {
+      this->Add(other.Dimension, other.Quadric, 1.0);
+    }
+  }
+};
+
+// An output line or triangle, with the position of its first corner in the
+// serial order of the input corners.
+struct OutputCell
+{
+  vtkIdType Position;
+  vtkIdType BinIds[3];
+};
+
+// The key identifying duplicate triangles.
+void GetSortedBinIds(const OutputCell& cell, vtkIdType binIds[3])
+{
+  std::copy(cell.BinIds, cell.BinIds + 3, binIds);
+  std::sort(binIds, binIds + 3);
+}
+
+// What each thread accumulates in AppendSMP().
+struct ThreadData
+{
+  std::vector<BinQuadric> DenseBins;
+  std::unordered_map<vtkIdType, BinQuadric> HashedBins;
+  std::vector<OutputCell> Lines;
+  std::vector<OutputCell> Triangles;
+};
+
+// Call functor(data, offset, npts, pts) for each cell in parallel, with the
+// data of the thread and the offset of the cell in the connectivity.
+template <typename Functor>
+void ForEachCell(vtkCellArray* cells, vtkSMPThreadLocal<ThreadData>& threadData, Functor functor)
+{
+  vtkSMPTools::For(0, cells->GetNumberOfCells(), [&](vtkIdType begin, vtkIdType end) {
+    ThreadData& data = threadData.Local();
+    auto iter = vtk::TakeSmartPointer(cells->NewIterator());
+    vtkIdType npts;
+    const vtkIdType* pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      iter->GetCellAtId(cellId, npts, pts);
+      functor(data, cells->GetOffset(cellId), npts, pts);
+    }
+  });
+}
+
+// Concatenate the cells of the threads, sorted in the serial order.
+std::vector<OutputCell> GatherCells(
+  vtkSMPThreadLocal<ThreadData>& threadData, std::vector<OutputCell> ThreadData::*member)
+{
+  std::vector<OutputCell> cells;
+  for (ThreadData& data : threadData)
+  {
+    cells.insert(cells.end(), (data.*member).begin(), (data.*member).end());
+    std::vector<OutputCell>().swap(data.*member);
+  }
+  vtkSMPTools::Sort(cells.begin(), cells.end(),
+    [](const OutputCell& a, const OutputCell& b) { return a.Position < b.Position; });
+  return cells;
+}
+}
+
 //------------------------------------------------------------------------------
 // Construct with default NumberOfDivisions to 50, DivisionSpacing to 1
 // in all (x,y,z) directions. AutoAdjustNumberOfDivisions is set to ON.
@@ -94,6 +297,7 @@ vtkQuadricClustering::vtkQuadricClustering()
 
   this->InCellCount = this->OutCellCount = 0;
   this->CopyCellData = 0;
+  this->EnableSMP = false;
 }
 
 //------------------------------------------------------------------------------
@@ -185,7 +389,14 @@ int vtkQuadricClustering::RequestData(vtkInformation* vtkNotUsed(request),
   this->UpdateProgress(.2);
   this->SliceSize = this->NumberOfDivisions[0] * this->NumberOfDivisions[1];
 
-  this->Append(input);
+  if (this->EnableSMP && !this->CopyCellData)
+  {
+    this->AppendSMP(input);
+  }
+  else
+  {
+    this->Append(input);
+  }
   if (this->UseFeatureEdges)
   { // Adjust bin points that contain boundary edges.
     this->AppendFeatureQuadrics(input, output);
@@ -358,6 +569,350 @@ void vtkQuadricClustering::Append(vtkPolyData* pd)
   }
 }
 
+//------------------------------------------------------------------------------
+// Each thread accumulates the quadrics of its cells in its own bins, which are
+// then reduced in parallel. The position of each input corner in the serial
+// order is three times its offset in the concatenated connectivity of the
+// verts, lines, polys and strips, plus its index in its segment or triangle.
+// The bins are numbered by their first position and the cells sorted by
+// position, which reproduces the output of Append().
+void vtkQuadricClustering::AppendSMP(vtkPolyData* pd)
+{
+  // Check for mis-use of the Append methods.
+  if (this->OutputTriangleArray == nullptr || this->OutputLines == nullptr)
+  {
+    vtkDebugMacro("Missing Array:  Did you call StartAppend?");
+    return;
+  }
+
+  vtkPoints* inputPoints = pd->GetPoints();
+  const vtkIdType numPts = pd->GetNumberOfPoints();
+  const vtkIdType numBins = static_cast<vtkIdType>(this->NumberOfDivisions[0]) *
+    this->NumberOfDivisions[1] * this->NumberOfDivisions[2];
+  const bool dense = numBins <=
+    std::max(MinimumDenseBins, numPts / vtkSMPTools::GetEstimatedNumberOfThreads());
+
+  // Hash each point once.
+  std::vector<vtkIdType> pointBins(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    double pt[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      inputPoints->GetPoint(ptId, pt);
+      pointBins[ptId] = this->HashPoint(pt);
+    }
+  });
+
+  // The first position using each bin.
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUses(new std::atomic<vtkIdType>[numBins]);
+  vtkSMPTools::For(0, numBins, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType binId = begin; binId < end; ++binId)
+    {
+      firstUses[binId].store(VTK_ID_MAX, std::memory_order_relaxed);
+    }
+  });
+  auto useBin = [&firstUses](vtkIdType binId, vtkIdType position) {
+    std::atomic<vtkIdType>& firstUse = firstUses[binId];
+    vtkIdType current = firstUse.load(std::memory_order_relaxed);
+    while (position < current &&
+      !firstUse.compare_exchange_weak(current, position, std::memory_order_relaxed))
+    {
+    }
+  };
+  auto addQuadric = [&](ThreadData& data, vtkIdType binId, unsigned char dimension,
+                      const double quadric[9]) {
+    if (dense)
+    {
+      if (data.DenseBins.empty())
+      {
+        data.DenseBins.resize(numBins);
+      }
+      data.DenseBins[binId].Add(dimension, quadric, QuadricScale);
+    }
+    else
+    {
+      data.HashedBins[binId].Add(dimension, quadric, QuadricScale);
+    }
+  };
+  // Same as AddTriangle().
+  auto addTriangle = [&](ThreadData& data, double* pt0, double* pt1, double* pt2,
+                       const vtkIdType binIds[3], vtkIdType position) {
+    const bool degenerate =
+      binIds[0] == binIds[1] || binIds[0] == binIds[2] || binIds[1] == binIds[2];
+    if (degenerate && !this->UseInternalTriangles)
+    {
+      return;
+    }
+    double quadric[9];
+    ComputeTriangleQuadric(pt0, pt1, pt2, quadric);
+    for (int i = 0; i < 3; ++i)
+    {
+      addQuadric(data, binIds[i], 2, quadric);
+      useBin(binIds[i], position + i);
+    }
+    if (!degenerate)
+    {
+      OutputCell triangle = { position, { binIds[0], binIds[1], binIds[2] } };
+      data.Triangles.push_back(triangle);
+    }
+  };
+
+  vtkSMPThreadLocal<ThreadData> threadData;
+  vtkCellArray* verts = pd->GetVerts();
+  vtkCellArray* lines = pd->GetLines();
+  vtkCellArray* polys = pd->GetPolys();
+  vtkCellArray* strips = pd->GetStrips();
+  vtkIdType base = 0;
+
+  // Same as AddVertices().
+  ForEachCell(verts, threadData,
+    [&](ThreadData& data, vtkIdType offset, vtkIdType npts, const vtkIdType* pts) {
+      double pt[3], quadric[9];
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        inputPoints->GetPoint(pts[j], pt);
+        ComputeVertexQuadric(pt, quadric);
+        addQuadric(data, pointBins[pts[j]], 0, quadric);
+        useBin(pointBins[pts[j]], 3 * (base + offset + j));
+      }
+    });
+  base += verts->GetNumberOfConnectivityIds();
+  this->UpdateProgress(.40);
+
+  // Same as AddEdges().
+  ForEachCell(lines, threadData,
+    [&](ThreadData& data, vtkIdType offset, vtkIdType npts, const vtkIdType* pts) {
+      double pt0[3], pt1[3], quadric[9];
+      if (npts > 0)
+      {
+        inputPoints->GetPoint(pts[0], pt0);
+      }
+      for (vtkIdType j = 1; j < npts; ++j)
+      {
+        inputPoints->GetPoint(pts[j], pt1);
+        if (ComputeEdgeQuadric(pt0, pt1, quadric))
+        {
+          const vtkIdType position = 3 * (base + offset + j);
+          OutputCell line = { position, { pointBins[pts[j - 1]], pointBins[pts[j]], -1 } };
+          for (int i = 0; i < 2; ++i)
+          {
+            addQuadric(data, line.BinIds[i], 1, quadric);
+            useBin(line.BinIds[i], line.Position + i);
+          }
+          if (line.BinIds[0] != line.BinIds[1])
+          {
+            data.Lines.push_back(line);
+          }
+        }
+        std::copy(pt1, pt1 + 3, pt0);
+      }
+    });
+  base += lines->GetNumberOfConnectivityIds();
+  this->UpdateProgress(.60);
+
+  // Same as AddPolygons().
+  ForEachCell(polys, threadData,
+    [&](ThreadData& data, vtkIdType offset, vtkIdType npts, const vtkIdType* pts) {
+      double pt0[3], pt1[3], pt2[3];
+      vtkIdType binIds[3];
+      if (npts > 0)
+      {
+        inputPoints->GetPoint(pts[0], pt0);
+        binIds[0] = pointBins[pts[0]];
+      }
+      for (vtkIdType j = 0; j < npts - 2; ++j)
+      {
+        inputPoints->GetPoint(pts[j + 1], pt1);
+        binIds[1] = pointBins[pts[j + 1]];
+        inputPoints->GetPoint(pts[j + 2], pt2);
+        binIds[2] = pointBins[pts[j + 2]];
+        addTriangle(data, pt0, pt1, pt2, binIds, 3 * (base + offset + j + 2));
+      }
+    });
+  base += polys->GetNumberOfConnectivityIds();
+  this->UpdateProgress(.70);
+
+  // Same as AddStrips().
+  ForEachCell(strips, threadData,
+    [&](ThreadData& data, vtkIdType offset, vtkIdType npts, const vtkIdType* pts) {
+      double stripPts[3][3];
+      vtkIdType binIds[3];
+      int odd = 0;
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        const int corner = j < 2 ? static_cast<int>(j) : 2;
+        inputPoints->GetPoint(pts[j], stripPts[corner]);
+        binIds[corner] = pointBins[pts[j]];
+        if (j >= 2)
+        {
+          addTriangle(
+            data, stripPts[0], stripPts[1], stripPts[2], binIds, 3 * (base + offset + j));
+          std::copy(stripPts[2], stripPts[2] + 3, stripPts[odd]);
+          binIds[odd] = binIds[2];
+          odd = odd ? 0 : 1;
+        }
+      }
+    });
+  this->UpdateProgress(.75);
+
+  // Reduce the bins of the threads into the quadric array.
+  auto mergeBins = [this](vtkIdType binId, BinQuadric& sum) {
+    PointQuadric& bin = this->QuadricArray[binId];
+    if (bin.Dimension <= 2)
+    {
+      sum.Add(bin.Dimension, bin.Quadric, 1.0);
+    }
+    bin.Dimension = sum.Dimension;
+    std::copy(sum.Quadric, sum.Quadric + 9, bin.Quadric);
+  };
+  if (dense)
+  {
+    std::vector<const std::vector<BinQuadric>*> threadBins;
+    for (ThreadData& data : threadData)
+    {
+      if (!data.DenseBins.empty())
+      {
+        threadBins.push_back(&data.DenseBins);
+      }
+    }
+    vtkSMPTools::For(0, numBins, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType binId = begin; binId < end; ++binId)
+      {
+        BinQuadric sum;
+        for (const std::vector<BinQuadric>* bins : threadBins)
+        {
+          sum.Merge((*bins)[binId]);
+        }
+        if (sum.Dimension <= 2)
+        {
+          mergeBins(binId, sum);
+        }
+      }
+    });
+  }
+  else
+  {
+    // Sort the hashed bins of all the threads, and reduce each run of bins.
+    std::vector<std::pair<vtkIdType, BinQuadric>> hashedBins;
+    for (ThreadData& data : threadData)
+    {
+      hashedBins.insert(hashedBins.end(), data.HashedBins.begin(), data.HashedBins.end());
+      std::unordered_map<vtkIdType, BinQuadric>().swap(data.HashedBins);
+    }
+    vtkSMPTools::Sort(hashedBins.begin(), hashedBins.end(),
+      [](const std::pair<vtkIdType, BinQuadric>& a, const std::pair<vtkIdType, BinQuadric>& b) {
+        return a.first < b.first;
+      });
+    const vtkIdType numHashedBins = static_cast<vtkIdType>(hashedBins.size());
+    vtkSMPTools::For(0, numHashedBins, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const vtkIdType binId = hashedBins[i].first;
+        if (i > 0 && hashedBins[i - 1].first == binId)
+        {
+          continue;
+        }
+        BinQuadric sum;
+        for (vtkIdType j = i; j < numHashedBins && hashedBins[j].first == binId; ++j)
+        {
+          sum.Merge(hashedBins[j].second);
+        }
+        mergeBins(binId, sum);
+      }
+    });
+  }
+  for (ThreadData& data : threadData)
+  {
+    std::vector<BinQuadric>().swap(data.DenseBins);
+  }
+  this->UpdateProgress(.80);
+
+  // Number the new bins in the order of their first use.
+  std::vector<vtkIdType> newBins(numBins);
+  vtkSMPTools::For(0, numBins, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType binId = begin; binId < end; ++binId)
+    {
+      newBins[binId] =
+        firstUses[binId] != VTK_ID_MAX && this->QuadricArray[binId].VertexId == -1 ? 1 : 0;
+    }
+  });
+  const vtkIdType numNewBins =
+    vtkSMPTools::ExclusiveScan(newBins.begin(), newBins.end(), newBins.begin(), vtkIdType(0));
+  std::vector<vtkIdType> positions(numNewBins);
+  std::vector<vtkIdType> binIds(numNewBins);
+  vtkSMPTools::For(0, numBins, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType binId = begin; binId < end; ++binId)
+    {
+      if (firstUses[binId] != VTK_ID_MAX && this->QuadricArray[binId].VertexId == -1)
+      {
+        positions[newBins[binId]] = firstUses[binId];
+        binIds[newBins[binId]] = binId;
+      }
+    }
+  });
+  vtkSMPTools::RadixSort(positions.data(), positions.data() + numNewBins, binIds.data());
+  const vtkIdType firstVertexId = this->NumberOfBinsUsed;
+  vtkSMPTools::For(0, numNewBins, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->QuadricArray[binIds[i]].VertexId = firstVertexId + i;
+    }
+  });
+  this->NumberOfBinsUsed += numNewBins;
+
+  // Append the cells in the serial order, keeping the first of the duplicate
+  // triangles.
+  std::vector<OutputCell> outputLines = GatherCells(threadData, &ThreadData::Lines);
+  std::vector<OutputCell> outputTriangles = GatherCells(threadData, &ThreadData::Triangles);
+  if (this->PreventDuplicateCells)
+  {
+    auto sameBins = [](const OutputCell& a, const OutputCell& b) {
+      vtkIdType aBinIds[3], bBinIds[3];
+      GetSortedBinIds(a, aBinIds);
+      GetSortedBinIds(b, bBinIds);
+      return std::equal(aBinIds, aBinIds + 3, bBinIds);
+    };
+    vtkSMPTools::StableSort(outputTriangles.begin(), outputTriangles.end(),
+      [](const OutputCell& a, const OutputCell& b) {
+        vtkIdType aBinIds[3], bBinIds[3];
+        GetSortedBinIds(a, aBinIds);
+        GetSortedBinIds(b, bBinIds);
+        return std::lexicographical_compare(aBinIds, aBinIds + 3, bBinIds, bBinIds + 3);
+      });
+    outputTriangles.erase(std::unique(outputTriangles.begin(), outputTriangles.end(), sameBins),
+      outputTriangles.end());
+    vtkSMPTools::Sort(outputTriangles.begin(), outputTriangles.end(),
+      [](const OutputCell& a, const OutputCell& b) { return a.Position < b.Position; });
+  }
+  auto appendCells = [this](vtkCellArray* cells, const std::vector<OutputCell>& outputCells,
+                       vtkIdType npts) {
+    const vtkIdType numCells = static_cast<vtkIdType>(outputCells.size());
+    vtkNew<vtkIdTypeArray> offsets;
+    offsets->SetNumberOfValues(numCells + 1);
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfValues(npts * numCells);
+    vtkIdType* offsetsPtr = offsets->GetPointer(0);
+    vtkIdType* connectivityPtr = connectivity->GetPointer(0);
+    vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        offsetsPtr[cellId] = npts * cellId;
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          connectivityPtr[npts * cellId + i] =
+            this->QuadricArray[outputCells[cellId].BinIds[i]].VertexId;
+        }
+      }
+    });
+    offsetsPtr[numCells] = npts * numCells;
+    vtkNew<vtkCellArray> newCells;
+    newCells->SetData(offsets, connectivity);
+    cells->Append(newCells);
+  };
+  appendCells(this->OutputLines, outputLines, 2);
+  appendCells(this->OutputTriangleArray, outputTriangles, 3);
+}
+
 //------------------------------------------------------------------------------
 void vtkQuadricClustering::AddPolygons(
   vtkCellArray* polys, vtkPoints* points, int geometryFlag, vtkPolyData* input, vtkPolyData* output)
@@ -474,17 +1029,8 @@ void vtkQuadricClustering::AddTriangle(vtkIdType* binIds, double* pt0, double* p
   }
 
   // Compute the quadric.
-  double quadric[9], quadric4x4[4][4];
-  vtkTriangle::ComputeQuadric(pt0, pt1, pt2, quadric4x4);
-  quadric[0] = quadric4x4[0][0];
-  quadric[1] = quadric4x4[0][1];
-  quadric[2] = quadric4x4[0][2];
-  quadric[3] = quadric4x4[0][3];
-  quadric[4] = quadric4x4[1][1];
-  quadric[5] = quadric4x4[1][2];
-  quadric[6] = quadric4x4[1][3];
-  quadric[7] = quadric4x4[2][2];
-  quadric[8] = quadric4x4[2][3];
+  double quadric[9];
+  ComputeTriangleQuadric(pt0, pt1, pt2, quadric);
 
   // Add the quadric to each of the three corner bins.
   for (int i = 0; i < 3; ++i)
@@ -639,62 +1185,15 @@ void vtkQuadricClustering::AddEdge(vtkIdType* binIds, double* pt0, double* pt1,
   vtkPolyData* input, vtkPolyData* output)
 {
   vtkIdType edgePtIds[2];
-  double length2, tmp;
-  double d[3];
-  double m[3]; // The mid point of the segment.(p1 or p2 could be used also).
-  double md;   // The dot product of m and d.
   double q[9];
 
   // Compute quadric for line segment.
   // Line segment quadric is the area (squared) of the triangle (seg,pt)
-  // Compute the direction vector of the segment.
-  d[0] = pt1[0] - pt0[0];
-  d[1] = pt1[1] - pt0[1];
-  d[2] = pt1[2] - pt0[2];
-
-  // Compute the length^2 of the line segment.
-  length2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
-
-  if (length2 == 0.0)
-  { // Coincident points.  Avoid divide by zero.
+  if (!ComputeEdgeQuadric(pt0, pt1, q))
+  { // Coincident points.
     return;
   }
 
-  // Normalize the direction vector.
-  tmp = 1.0 / sqrt(length2);
-  d[0] = d[0] * tmp;
-  d[1] = d[1] * tmp;
-  d[2] = d[2] * tmp;
-
-  // Compute the mid point of the segment.
-  m[0] = 0.5 * (pt1[0] + pt0[0]);
-  m[1] = 0.5 * (pt1[1] + pt0[1]);
-  m[2] = 0.5 * (pt1[2] + pt0[2]);
-
-  // Compute dot(m, d);
-  md = m[0] * d[0] + m[1] * d[1] + m[2] * d[2];
-
-  // We save nine coefficients of the error function corresponding to:
-  // 0: Px^2
-  // 1: PxPy
-  // 2: PxPz
-  // 3: Px
-  // 4: Py^2
-  // 5: PyPz
-  // 6: Py
-  // 7: Pz^2
-  // 8: Pz
-  // We ignore the constant because it disappears with the derivative.
-  q[0] = length2 * (1.0 - d[0] * d[0]);
-  q[1] = -length2 * (d[0] * d[1]);
-  q[2] = -length2 * (d[0] * d[2]);
-  q[3] = length2 * (d[0] * md - m[0]);
-  q[4] = length2 * (1.0 - d[1] * d[1]);
-  q[5] = -length2 * (d[1] * d[2]);
-  q[6] = length2 * (d[1] * md - m[1]);
-  q[7] = length2 * (1.0 - d[2] * d[2]);
-  q[8] = length2 * (d[2] * md - m[2]);
-
   for (int i = 0; i < 2; ++i)
   {
     // If the current quadric is from triangles (or not initialized), then clear it out.
@@ -792,27 +1291,7 @@ void vtkQuadricClustering::AddVertex(
   double q[9];
 
   // Compute quadric for the vertex.
-
-  // We save nine coefficients of the error function corresponding to:
-  // 0: Px^2
-  // 1: PxPy
-  // 2: PxPz
-  // 3: Px
-  // 4: Py^2
-  // 5: PyPz
-  // 6: Py
-  // 7: Pz^2
-  // 8: Pz
-  // We ignore the constant because it disappears with the derivative.
-  q[0] = 1.0;
-  q[1] = 0.0;
-  q[2] = 0.0;
-  q[3] = -pt[0];
-  q[4] = 1.0;
-  q[5] = 0.0;
-  q[6] = -pt[1];
-  q[7] = 1.0;
-  q[8] = -pt[2];
+  ComputeVertexQuadric(pt, q);
 
   // If the current quadric is from triangles, edges (or not initialized),
   // then clear it out.
@@ -852,7 +1331,7 @@ void vtkQuadricClustering::AddQuadric(vtkIdType binId, double quadric[9])
 
   for (int i = 0; i < 9; i++)
   {
-    q[i] += (quadric[i] * 100000000.0);
+    q[i] += (quadric[i] * QuadricScale);
   }
 }
 
@@ -936,21 +1415,39 @@ void vtkQuadricClustering::EndAppend()
 
   // Compute the representative points for each bin
   outputPoints = vtkPoints::New();
-  for (vtkIdType i = 0; !abortExecute && i < numBuckets; i++)
+  if (this->EnableSMP)
   {
-    if (cstep > step)
+    outputPoints->SetNumberOfPoints(this->NumberOfBinsUsed);
+    vtkSMPTools::For(0, numBuckets, [&](vtkIdType begin, vtkIdType end) {
+      double point[3];
+      for (vtkIdType binId = begin; binId < end; ++binId)
+      {
+        if (this->QuadricArray[binId].VertexId != -1)
+        {
+          this->ComputeRepresentativePoint(this->QuadricArray[binId].Quadric, binId, point);
+          outputPoints->SetPoint(this->QuadricArray[binId].VertexId, point);
+        }
+      }
+    });
+  }
+  else
+  {
+    for (vtkIdType i = 0; !abortExecute && i < numBuckets; i++)
     {
-      cstep = 0;
-      vtkDebugMacro(<< "Finding point in bin #" << i);
-      this->UpdateProgress(0.8 + 0.2 * i / numBuckets);
-      abortExecute = this->CheckAbort();
-    }
-    ++cstep;
+      if (cstep > step)
+      {
+        cstep = 0;
+        vtkDebugMacro(<< "Finding point in bin #" << i);
+        this->UpdateProgress(0.8 + 0.2 * i / numBuckets);
+        abortExecute = this->CheckAbort();
+      }
+      ++cstep;
 
-    if (this->QuadricArray[i].VertexId != -1)
-    {
-      this->ComputeRepresentativePoint(this->QuadricArray[i].Quadric, i, newPt);
-      outputPoints->InsertPoint(this->QuadricArray[i].VertexId, newPt);
+      if (this->QuadricArray[i].VertexId != -1)
+      {
+        this->ComputeRepresentativePoint(this->QuadricArray[i].Quadric, i, newPt);
+        outputPoints->InsertPoint(this->QuadricArray[i].VertexId, newPt);
+      }
     }
   }
 
@@ -1546,5 +2043,6 @@ void vtkQuadricClustering::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Copy Cell Data : " << this->CopyCellData << endl;
 
   os << indent << "Prevent Duplicate Cells : " << (this->PreventDuplicateCells ? "On\n" : "Off\n");
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 VTK_ABI_NAMESPACE_END
@@ -59,6 +59,14 @@
  * manual control, it has the advantage that extremely large data can be
  * processed in pieces and appended to the filter piece-by-piece.
  *
+ * When EnableSMP is on, the filter accumulates the quadrics using vtkSMPTools:
+ * each thread sums the quadrics of its cells in its own bins, dense when the
+ * grid is small enough and hashed otherwise, and the bins are reduced in
+ * parallel. The bins are numbered and the cells output in the same order as
+ * the serial implementation, so that both produce the same output up to the
+ * rounding of the quadric sums. The threaded implementation is only used by
+ * the pipeline, and not when CopyCellData is on.
+ *
  * @warning
  * This filter can drastically affect topology, i.e., topology is not
  * preserved.
@@ -265,6 +273,19 @@ public:
   vtkBooleanMacro(PreventDuplicateCells, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded implementation. The output of RequestData()
+   * has the points and cells of the serial one, in the same order, but the
+   * point coordinates may differ in the last bits since the quadrics are
+   * summed in another order. The quadrics are still summed serially when
+   * CopyCellData is on, and by Append(). Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
 protected:
   vtkQuadricClustering();
   ~vtkQuadricClustering() override;
@@ -352,6 +373,12 @@ protected:
 
   // Unfinished option to handle boundary edges differently.
   void AppendFeatureQuadrics(vtkPolyData* pd, vtkPolyData* output);
+
+  /**
+   * Threaded implementation of Append(), used by RequestData() when
+   * EnableSMP is on.
+   */
+  void AppendSMP(vtkPolyData* piece);
   vtkTypeBool UseFeatureEdges;
   vtkTypeBool UseFeaturePoints;
   vtkTypeBool UseInternalTriangles;
@@ -419,6 +446,8 @@ protected:
   int InCellCount;
   int OutCellCount;
 
+  bool EnableSMP;
+
 private:
   vtkQuadricClustering(const vtkQuadricClustering&) = delete;
   void operator=(const vtkQuadricClustering&) = delete;
@@ -46,18 +46,731 @@
 #include "vtkEdgeTable.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <vector>
+
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Geometric part of the quadric of the plane of a triangle. Returns the
+// weight of the quadric, half the area of the triangle, with the normal n and
+// the offset d of the plane.
+double ComputeTriangleQuadric(const double point0[3], const double point1[3],
+  const double point2[3], bool regularize, double regularizationVariance, double n[3], double& d,
+  double* QEM)
+{
+  double tempP1[3], tempP2[3], triArea2;
+  for (int i = 0; i < 3; i++)
+  {
+    tempP1[i] = point1[i] - point0[i];
+    tempP2[i] = point2[i] - point0[i];
+  }
+  vtkMath::Cross(tempP1, tempP2, n);
+  triArea2 = vtkMath::Normalize(n);
+  // triArea2 = (triArea2 * triArea2 * 0.25);
+  triArea2 = triArea2 * 0.5;
+  // I am unsure whether this should be squared or not??
+  d = -vtkMath::Dot(n, point0);
+  // could possible add in angle weights??
+
+  // set the geometric part of the QEM
+  QEM[0] = n[0] * n[0];
+  QEM[1] = n[0] * n[1];
+  QEM[2] = n[0] * n[2];
+  QEM[3] = d * n[0];
+
+  QEM[4] = n[1] * n[1];
+  QEM[5] = n[1] * n[2];
+  QEM[6] = d * n[1];
+
+  QEM[7] = n[2] * n[2];
+  QEM[8] = d * n[2];
+
+  QEM[9] = d * d;
+  QEM[10] = 1;
+
+  if (regularize)
+  {
+    // Add in some regularizing identity \Sigma_n
+    QEM[0] += regularizationVariance;
+    QEM[4] += regularizationVariance;
+    QEM[7] += regularizationVariance;
+
+    // -\Sigma_n . q
+    QEM[3] -= regularizationVariance * point0[0];
+    QEM[6] -= regularizationVariance * point0[1];
+    QEM[8] -= regularizationVariance * point0[2];
+
+    // q^T \Sigma_n q + n^T \Sigma_q n + Tr(\Sigma_n \Sigma_q)
+    QEM[9] +=
+      regularizationVariance * (vtkMath::Dot(point0, point0) + 1 + 3 * regularizationVariance);
+  }
+  return triArea2;
+}
+
+//------------------------------------------------------------------------------
+// Quadric of the plane orthogonal to the triangle t0, t1, t2 through its
+// boundary edge t1, t2. Returns the weight of the quadric.
+double ComputeBoundaryQuadric(const double t0[3], const double t1[3], const double t2[3],
+  bool weighByLength, double weightFactor, double* QEM)
+{
+  double e0[3], e1[3], n[3], c, w;
+  int j;
+
+  // computing a plane which is orthogonal to line t1, t2 and incident
+  // with it
+  for (j = 0; j < 3; j++)
+  {
+    e0[j] = t2[j] - t1[j];
+  }
+  for (j = 0; j < 3; j++)
+  {
+    e1[j] = t0[j] - t1[j];
+  }
+
+  // compute n so that it is orthogonal to e0 and parallel to the
+  // triangle
+  c = vtkMath::Dot(e0, e1) / (e0[0] * e0[0] + e0[1] * e0[1] + e0[2] * e0[2]);
+  for (j = 0; j < 3; j++)
+  {
+    n[j] = e1[j] - c * e0[j];
+  }
+  vtkMath::Normalize(n);
+
+#if defined(_MSC_VER) && _MSC_VER >= 1929
+  // Visual Studio toolset starting at toolset 14.29.30133, when building in Release mode
+  // incorrectly optimizes away the line
+  //    QEM[9] = d * d;
+  // By making volatile, we are telling the compiler not to optimize out
+  // or reorder operations regarding this variable.
+  volatile
+#endif
+    double d = -vtkMath::Dot(n, t1);
+  // The above line might merit some review: The same quadric gets added to t1 and t2 and one
+  // might prefer adding a quadric calculated using t1 at t1 and using t2 at t2
+  w = vtkMath::Norm(e0);
+
+  if (!weighByLength)
+  {
+    /*
+     * The argument for using area instead of length is based on homogeneity here: The quadric
+     * field is already weighted by triangle area. It makes sense weighting the boundary
+     * constraints by area instead of length. Length technically has zero measure in terms of
+     * units of area. The squared version also seems to give more coherent results at the
+     * boundary.
+     */
+    w *= w;
+  }
+  w *= weightFactor;
+
+  // could possible add in
+  // angle weights??
+  QEM[0] = n[0] * n[0];
+  QEM[1] = n[0] * n[1];
+  QEM[2] = n[0] * n[2];
+  QEM[3] = d * n[0];
+
+  QEM[4] = n[1] * n[1];
+  QEM[5] = n[1] * n[2];
+  QEM[6] = d * n[1];
+
+  QEM[7] = n[2] * n[2];
+  QEM[8] = d * n[2];
+
+  QEM[9] = d * d;
+
+  QEM[10] = 1;
+
+  return w;
+}
+
+//------------------------------------------------------------------------------
+// Optimal position x of the point replacing the edge pt1, pt2 given the sum
+// quad of the quadrics of its end points. Returns the cost of the position.
+double ComputeQuadricCost(const double* quad, const double pt1[3], const double pt2[3], double* x)
+{
+  static const double errorNumber = 1e-10;
+  double temp[3], A[3][3], b[3];
+  double cost = 0.0;
+  const double* index;
+  int i, j;
+  double newPoint[4];
+  double v[3], c, norm, normTemp, temp2[3];
+
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
+
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
+
+  norm = vtkMath::Norm(A[0]);
+  normTemp = vtkMath::Norm(A[1]);
+  norm = norm > normTemp ? norm : normTemp;
+  normTemp = vtkMath::Norm(A[2]);
+  norm = norm > normTemp ? norm : normTemp;
+
+  if (fabs(vtkMath::Determinant3x3(A)) / (norm * norm * norm) > errorNumber)
+  {
+    // it would be better to use the normal of the matrix to test singularity??
+    vtkMath::LinearSolve3x3(A, b, x);
+  }
+  else
+  {
+    // cheapest point along the edge
+    v[0] = pt2[0] - pt1[0];
+    v[1] = pt2[1] - pt1[1];
+    v[2] = pt2[2] - pt1[2];
+
+    // equation for the edge pt1 + c * v
+    // attempt least squares fit for c for A*(pt1 + c * v) = b
+    vtkMath::Multiply3x3(A, v, temp2);
+    if (vtkMath::Dot(temp2, temp2) > errorNumber)
+    {
+      vtkMath::Multiply3x3(A, pt1, temp);
+      for (i = 0; i < 3; i++)
+        temp[i] = b[i] - temp[i];
+      c = vtkMath::Dot(temp2, temp) / vtkMath::Dot(temp2, temp2);
+      for (i = 0; i < 3; i++)
+        x[i] = pt1[i] + c * v[i];
+    }
+    else
+    {
+      // use mid point
+      // might want to change to best of mid and end points??
+      for (i = 0; i < 3; i++)
+      {
+        x[i] = 0.5 * (pt1[i] + pt2[i]);
+      }
+    }
+  }
+
+  newPoint[0] = x[0];
+  newPoint[1] = x[1];
+  newPoint[2] = x[2];
+  newPoint[3] = 1;
+
+  // Compute the cost
+  // x'*quad*x
+  index = quad;
+  for (i = 0; i < 4; i++)
+  {
+    cost += (*index++) * newPoint[i] * newPoint[i];
+    for (j = i + 1; j < 4; j++)
+    {
+      cost += 2.0 * (*index++) * newPoint[i] * newPoint[j];
+    }
+  }
+
+  return cost;
+}
+
+//------------------------------------------------------------------------------
+// Determines if t0 and x are on the same side of the plane defined by t1 and
+// t2, and parallel to the normal of the triangle t0, t1, t2.
+bool IsOnTriangleSide(const double t0[3], const double t1[3], const double t2[3], const double* x)
+{
+  double e0[3], e1[3], n[3], e2[3];
+  double c;
+  int i;
+
+  for (i = 0; i < 3; i++)
+  {
+    e0[i] = t2[i] - t1[i];
+  }
+  for (i = 0; i < 3; i++)
+  {
+    e1[i] = t0[i] - t1[i];
+  }
+
+  // projection of e0 onto e1
+  c = vtkMath::Dot(e0, e1) / (e0[0] * e0[0] + e0[1] * e0[1] + e0[2] * e0[2]);
+  for (i = 0; i < 3; i++)
+  {
+    n[i] = e1[i] - c * e0[i];
+  }
+
+  for (i = 0; i < 3; i++)
+  {
+    e2[i] = x[i] - t1[i];
+  }
+
+  vtkMath::Normalize(n);
+  vtkMath::Normalize(e2);
+  return vtkMath::Dot(n, e2) > 1e-5;
+}
+
+//------------------------------------------------------------------------------
+// Threaded decimation with the geometric error only. The edges are collapsed
+// by rounds: each round computes the cost of all the edges and collapses at
+// once the edges which are cheaper than all the edges they interfere with,
+// that is the edges with an end point in the triangles around their own end
+// points. Such collapses modify disjoint sets of triangles and can be done in
+// parallel. The point kept by a collapse is the end point of lower id.
+struct QuadricDecimationSMP
+{
+  static const int QuadricSize = 11;
+
+  bool Regularize;
+  double RegularizationVariance;
+  bool WeighBoundaryConstraintsByLength;
+  double BoundaryWeightFactor;
+
+  vtkIdType NumberOfPoints = 0;
+  std::vector<double> Points;
+  std::vector<vtkIdType> Triangles;
+  std::vector<unsigned char> Alive;
+  std::vector<double> Quadrics;
+
+  // Triangles using each point, rebuilt each round.
+  std::vector<vtkIdType> StarOffsets;
+  std::vector<vtkIdType> Stars;
+
+  // Edges of the round, (p, q) with p < q, with the position of the point
+  // replacing them and their cost.
+  std::vector<vtkIdType> EdgeOffsets;
+  std::vector<vtkIdType> EdgePoints;
+  std::vector<double> EdgeTargets;
+  std::vector<double> EdgeCosts;
+
+  const double* GetPoint(vtkIdType ptId) const { return this->Points.data() + 3 * ptId; }
+  const vtkIdType* GetTriangle(vtkIdType triId) const { return this->Triangles.data() + 3 * triId; }
+  const vtkIdType* StarBegin(vtkIdType ptId) const
+  {
+    return this->Stars.data() + this->StarOffsets[ptId];
+  }
+  const vtkIdType* StarEnd(vtkIdType ptId) const
+  {
+    return this->Stars.data() + this->StarOffsets[ptId + 1];
+  }
+
+  static bool HasPoint(const vtkIdType* tri, vtkIdType ptId)
+  {
+    return tri[0] == ptId || tri[1] == ptId || tri[2] == ptId;
+  }
+
+  //----------------------------------------------------------------------------
+  // List the living triangles around each point, in increasing id order.
+  void BuildStars()
+  {
+    const vtkIdType numPts = this->NumberOfPoints;
+    const vtkIdType numTris = static_cast<vtkIdType>(this->Alive.size());
+    std::unique_ptr<std::atomic<vtkIdType>[]> cursors(new std::atomic<vtkIdType>[numPts]);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        cursors[ptId] = 0;
+      }
+    });
+    vtkSMPTools::For(0, numTris, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType triId = begin; triId < end; ++triId)
+      {
+        if (this->Alive[triId])
+        {
+          const vtkIdType* tri = this->GetTriangle(triId);
+          for (int i = 0; i < 3; ++i)
+          {
+            ++cursors[tri[i]];
+          }
+        }
+      }
+    });
+
+    this->StarOffsets.resize(numPts + 1);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->StarOffsets[ptId] = cursors[ptId];
+      }
+    });
+    this->StarOffsets[numPts] = vtkSMPTools::ExclusiveScan(this->StarOffsets.begin(),
+      this->StarOffsets.begin() + numPts, this->StarOffsets.begin(), vtkIdType(0));
+    this->Stars.resize(this->StarOffsets[numPts]);
+
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        cursors[ptId] = this->StarOffsets[ptId];
+      }
+    });
+    vtkSMPTools::For(0, numTris, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType triId = begin; triId < end; ++triId)
+      {
+        if (this->Alive[triId])
+        {
+          const vtkIdType* tri = this->GetTriangle(triId);
+          for (int i = 0; i < 3; ++i)
+          {
+            this->Stars[cursors[tri[i]]++] = triId;
+          }
+        }
+      }
+    });
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        std::sort(this->Stars.begin() + this->StarOffsets[ptId],
+          this->Stars.begin() + this->StarOffsets[ptId + 1]);
+      }
+    });
+  }
+
+  //----------------------------------------------------------------------------
+  // Sum the quadrics of the triangles and of the boundary edges around each
+  // point, as InitializeQuadrics() and AddBoundaryConstraints() do.
+  void ComputeQuadrics()
+  {
+    this->Quadrics.resize(this->NumberOfPoints * QuadricSize);
+    vtkSMPTools::For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      double QEM[QuadricSize], n[3], d;
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        double* quadric = this->Quadrics.data() + ptId * QuadricSize;
+        std::fill(quadric, quadric + QuadricSize, 0.0);
+        for (const vtkIdType* triId = this->StarBegin(ptId); triId != this->StarEnd(ptId); ++triId)
+        {
+          const vtkIdType* tri = this->GetTriangle(*triId);
+          const double area = ComputeTriangleQuadric(this->GetPoint(tri[0]),
+            this->GetPoint(tri[1]), this->GetPoint(tri[2]), this->Regularize,
+            this->RegularizationVariance, n, d, QEM);
+          for (int j = 0; j < QuadricSize; ++j)
+          {
+            quadric[j] += QEM[j] * area;
+          }
+        }
+        for (const vtkIdType* triId = this->StarBegin(ptId); triId != this->StarEnd(ptId); ++triId)
+        {
+          const vtkIdType* tri = this->GetTriangle(*triId);
+          for (int i = 0; i < 3; ++i)
+          {
+            const vtkIdType p1 = tri[i];
+            const vtkIdType p2 = tri[(i + 1) % 3];
+            if ((p1 == ptId || p2 == ptId) && this->IsBoundaryEdge(ptId, p1 == ptId ? p2 : p1))
+            {
+              const double w = ComputeBoundaryQuadric(this->GetPoint(tri[(i + 2) % 3]),
+                this->GetPoint(p1), this->GetPoint(p2), this->WeighBoundaryConstraintsByLength,
+                this->BoundaryWeightFactor, QEM);
+              for (int j = 0; j < QuadricSize; ++j)
+              {
+                quadric[j] += QEM[j] * w;
+              }
+            }
+          }
+        }
+      }
+    });
+  }
+
+  //----------------------------------------------------------------------------
+  // An edge is on the boundary when it is used by a single triangle.
+  bool IsBoundaryEdge(vtkIdType p1, vtkIdType p2) const
+  {
+    int numTris = 0;
+    for (const vtkIdType* triId = this->StarBegin(p1); triId != this->StarEnd(p1); ++triId)
+    {
+      numTris += HasPoint(this->GetTriangle(*triId), p2) ? 1 : 0;
+    }
+    return numTris == 1;
+  }
+
+  //----------------------------------------------------------------------------
+  // The points of higher id sharing a triangle with ptId, sorted.
+  void GetUpperNeighbors(vtkIdType ptId, std::vector<vtkIdType>& neighbors) const
+  {
+    neighbors.clear();
+    for (const vtkIdType* triId = this->StarBegin(ptId); triId != this->StarEnd(ptId); ++triId)
+    {
+      const vtkIdType* tri = this->GetTriangle(*triId);
+      for (int i = 0; i < 3; ++i)
+      {
+        if (tri[i] > ptId)
+        {
+          neighbors.push_back(tri[i]);
+        }
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+  }
+
+  //----------------------------------------------------------------------------
+  // Same check as vtkQuadricDecimation::IsGoodPlacement(): moving p1 or p2
+  // to x must not flip the triangles around them.
+  bool IsGoodPlacement(vtkIdType p1, vtkIdType p2, const double* x) const
+  {
+    const vtkIdType ends[2][2] = { { p1, p2 }, { p2, p1 } };
+    for (const auto& end : ends)
+    {
+      for (const vtkIdType* triId = this->StarBegin(end[0]); triId != this->StarEnd(end[0]);
+           ++triId)
+      {
+        const vtkIdType* tri = this->GetTriangle(*triId);
+        if (HasPoint(tri, end[1]))
+        {
+          continue;
+        }
+        const int i = tri[0] == end[0] ? 0 : (tri[1] == end[0] ? 1 : 2);
+        if (!IsOnTriangleSide(this->GetPoint(tri[i]), this->GetPoint(tri[(i + 1) % 3]),
+              this->GetPoint(tri[(i + 2) % 3]), x))
+        {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // List the edges with their cost, VTK_DOUBLE_MAX for a poor placement.
+  void BuildEdges()
+  {
+    const vtkIdType numPts = this->NumberOfPoints;
+    vtkSMPThreadLocal<std::vector<vtkIdType>> localNeighbors;
+    this->EdgeOffsets.resize(numPts + 1);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      std::vector<vtkIdType>& neighbors = localNeighbors.Local();
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->GetUpperNeighbors(ptId, neighbors);
+        this->EdgeOffsets[ptId] = static_cast<vtkIdType>(neighbors.size());
+      }
+    });
+    const vtkIdType numEdges = vtkSMPTools::ExclusiveScan(this->EdgeOffsets.begin(),
+      this->EdgeOffsets.begin() + numPts, this->EdgeOffsets.begin(), vtkIdType(0));
+    this->EdgeOffsets[numPts] = numEdges;
+
+    this->EdgePoints.resize(2 * numEdges);
+    this->EdgeTargets.resize(3 * numEdges);
+    this->EdgeCosts.resize(numEdges);
+    vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+      std::vector<vtkIdType>& neighbors = localNeighbors.Local();
+      double quad[QuadricSize];
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->GetUpperNeighbors(ptId, neighbors);
+        vtkIdType edgeId = this->EdgeOffsets[ptId];
+        for (vtkIdType neighbor : neighbors)
+        {
+          const double* q1 = this->Quadrics.data() + ptId * QuadricSize;
+          const double* q2 = this->Quadrics.data() + neighbor * QuadricSize;
+          for (int j = 0; j < QuadricSize; ++j)
+          {
+            quad[j] = q1[j] + q2[j];
+          }
+          double* x = this->EdgeTargets.data() + 3 * edgeId;
+          double cost =
+            ComputeQuadricCost(quad, this->GetPoint(ptId), this->GetPoint(neighbor), x);
+          if (!this->IsGoodPlacement(ptId, neighbor, x))
+          {
+            cost = VTK_DOUBLE_MAX;
+          }
+          this->EdgePoints[2 * edgeId] = ptId;
+          this->EdgePoints[2 * edgeId + 1] = neighbor;
+          this->EdgeCosts[edgeId] = cost;
+          ++edgeId;
+        }
+      }
+    });
+  }
+
+  //----------------------------------------------------------------------------
+  // Call f on the points of the triangles around the end points of an edge.
+  template <typename F>
+  void ForEachNeighborhoodPoint(vtkIdType edgeId, F&& f) const
+  {
+    for (int e = 0; e < 2; ++e)
+    {
+      const vtkIdType ptId = this->EdgePoints[2 * edgeId + e];
+      for (const vtkIdType* triId = this->StarBegin(ptId); triId != this->StarEnd(ptId); ++triId)
+      {
+        const vtkIdType* tri = this->GetTriangle(*triId);
+        f(tri[0]);
+        f(tri[1]);
+        f(tri[2]);
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Return the edges to collapse in this round, by increasing cost. An edge
+  // is selected when it is the cheapest edge claiming the points of its
+  // neighborhood, so that the neighborhoods of the selected edges do not
+  // contain the end points of other selected edges.
+  std::vector<vtkIdType> SelectEdges() const
+  {
+    const vtkIdType numEdges = static_cast<vtkIdType>(this->EdgeCosts.size());
+    std::vector<vtkIdType> order(numEdges);
+    std::iota(order.begin(), order.end(), vtkIdType(0));
+    const std::vector<double>& costs = this->EdgeCosts;
+    vtkSMPTools::Sort(order.begin(), order.end(), [&costs](vtkIdType a, vtkIdType b) {
+      return costs[a] < costs[b] || (costs[a] == costs[b] && a < b);
+    });
+    const vtkIdType numValid = static_cast<vtkIdType>(
+      std::partition_point(order.begin(), order.end(),
+        [&costs](vtkIdType edgeId) { return costs[edgeId] < VTK_DOUBLE_MAX; }) -
+      order.begin());
+    // Only the cheapest edges compete, so that a round stays close to the
+    // serial order of the collapses.
+    const vtkIdType numCandidates =
+      std::max<vtkIdType>(numValid / 10, std::min<vtkIdType>(numValid, 1));
+
+    std::unique_ptr<std::atomic<vtkIdType>[]> claims(
+      new std::atomic<vtkIdType>[this->NumberOfPoints]);
+    vtkSMPTools::For(0, this->NumberOfPoints, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        claims[ptId] = VTK_ID_MAX;
+      }
+    });
+    vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType rank = begin; rank < end; ++rank)
+      {
+        this->ForEachNeighborhoodPoint(order[rank], [&](vtkIdType ptId) {
+          vtkIdType claim = claims[ptId].load(std::memory_order_relaxed);
+          while (rank < claim && !claims[ptId].compare_exchange_weak(claim, rank))
+          {
+          }
+        });
+      }
+    });
+
+    std::vector<vtkIdType> selected(numCandidates);
+    vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType rank = begin; rank < end; ++rank)
+      {
+        bool owned = true;
+        this->ForEachNeighborhoodPoint(
+          order[rank], [&](vtkIdType ptId) { owned = owned && claims[ptId] == rank; });
+        selected[rank] = owned ? 1 : 0;
+      }
+    });
+    const vtkIdType numSelected = vtkSMPTools::ExclusiveScan(
+      selected.begin(), selected.end(), selected.begin(), vtkIdType(0));
+    std::vector<vtkIdType> edges(numSelected);
+    vtkSMPTools::For(0, numCandidates, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType rank = begin; rank < end; ++rank)
+      {
+        const vtkIdType next = rank + 1 < numCandidates ? selected[rank + 1] : numSelected;
+        if (next != selected[rank])
+        {
+          edges[selected[rank]] = order[rank];
+        }
+      }
+    });
+    return edges;
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of triangles using an edge, deleted by its collapse.
+  vtkIdType GetNumberOfEdgeTriangles(vtkIdType edgeId) const
+  {
+    const vtkIdType p1 = this->EdgePoints[2 * edgeId];
+    const vtkIdType p2 = this->EdgePoints[2 * edgeId + 1];
+    vtkIdType numTris = 0;
+    for (const vtkIdType* triId = this->StarBegin(p1); triId != this->StarEnd(p1); ++triId)
+    {
+      numTris += HasPoint(this->GetTriangle(*triId), p2) ? 1 : 0;
+    }
+    return numTris;
+  }
+
+  //----------------------------------------------------------------------------
+  // Collapse the selected edges, as CollapseEdge() does. Returns the number
+  // of deleted triangles.
+  vtkIdType CollapseEdges(const std::vector<vtkIdType>& edges)
+  {
+    std::atomic<vtkIdType> numDeleted(0);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(edges.size()), [&](vtkIdType begin, vtkIdType end) {
+      vtkIdType numLocalDeleted = 0;
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const vtkIdType edgeId = edges[i];
+        const vtkIdType p1 = this->EdgePoints[2 * edgeId];
+        const vtkIdType p2 = this->EdgePoints[2 * edgeId + 1];
+        std::copy_n(this->EdgeTargets.data() + 3 * edgeId, 3, this->Points.data() + 3 * p1);
+        double* quadric = this->Quadrics.data() + p1 * QuadricSize;
+        const double* removedQuadric = this->Quadrics.data() + p2 * QuadricSize;
+        for (int j = 0; j < QuadricSize; ++j)
+        {
+          quadric[j] += removedQuadric[j];
+        }
+
+        for (const vtkIdType* triId = this->StarBegin(p2); triId != this->StarEnd(p2); ++triId)
+        {
+          vtkIdType* tri = this->Triangles.data() + 3 * *triId;
+          if (HasPoint(tri, p1))
+          {
+            this->Alive[*triId] = 0;
+            ++numLocalDeleted;
+            continue;
+          }
+          std::replace(tri, tri + 3, p2, p1);
+          if (this->IsDuplicate(*triId, p1, p2))
+          {
+            this->Alive[*triId] = 0;
+            ++numLocalDeleted;
+          }
+        }
+      }
+      numDeleted += numLocalDeleted;
+    });
+    return numDeleted;
+  }
+
+  //----------------------------------------------------------------------------
+  // Whether the triangle moved from p2 to p1 already exists around p1, or
+  // around p2 among the triangles moved before it.
+  bool IsDuplicate(vtkIdType triId, vtkIdType p1, vtkIdType p2) const
+  {
+    const vtkIdType* tri = this->GetTriangle(triId);
+    auto isSame = [&](vtkIdType otherId) {
+      const vtkIdType* other = this->GetTriangle(otherId);
+      return this->Alive[otherId] && HasPoint(other, tri[0]) && HasPoint(other, tri[1]) &&
+        HasPoint(other, tri[2]);
+    };
+    for (const vtkIdType* otherId = this->StarBegin(p1); otherId != this->StarEnd(p1); ++otherId)
+    {
+      if (isSame(*otherId))
+      {
+        return true;
+      }
+    }
+    for (const vtkIdType* otherId = this->StarBegin(p2); *otherId != triId; ++otherId)
+    {
+      if (isSame(*otherId))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+}
+
 //------------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
 {
@@ -216,6 +929,11 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
     return 1;
   }
 
+  if (this->EnableSMP && !this->AttributeErrorMetric)
+  {
+    return this->RequestDataSMP(input, output);
+  }
+
   polys = vtkCellArray::New();
   points = vtkPoints::New();
   pointData = vtkPointData::New();
@@ -419,6 +1137,141 @@ int vtkQuadricDecimation::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//------------------------------------------------------------------------------
+int vtkQuadricDecimation::RequestDataSMP(vtkPolyData* input, vtkPolyData* output)
+{
+  QuadricDecimationSMP decimation;
+  decimation.Regularize = this->Regularize;
+  decimation.RegularizationVariance = this->Regularize ? std::pow(this->Regularization, 2) : 0.0;
+  decimation.WeighBoundaryConstraintsByLength = this->WeighBoundaryConstraintsByLength;
+  decimation.BoundaryWeightFactor = this->BoundaryWeightFactor;
+
+  vtkPoints* inPts = input->GetPoints();
+  const vtkIdType numPts = inPts->GetNumberOfPoints();
+  decimation.NumberOfPoints = numPts;
+  decimation.Points.resize(3 * numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      inPts->GetPoint(ptId, decimation.Points.data() + 3 * ptId);
+    }
+  });
+
+  // Only triangles are decimated.
+  vtkCellArray* polys = input->GetPolys();
+  vtkIdType npts;
+  const vtkIdType* pts;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    if (npts == 3)
+    {
+      decimation.Triangles.insert(decimation.Triangles.end(), pts, pts + 3);
+    }
+  }
+  const vtkIdType numTris = static_cast<vtkIdType>(decimation.Triangles.size() / 3);
+  decimation.Alive.assign(numTris, 1);
+  this->UpdateProgress(0.1);
+
+  vtkDebugMacro(<< "Computing Quadrics");
+  decimation.BuildStars();
+  decimation.ComputeQuadrics();
+  this->UpdateProgress(0.2);
+
+  // Collapse edges by rounds until desired reduction is reached
+  this->ActualReduction = 0.0;
+  this->NumberOfEdgeCollapses = 0;
+  vtkIdType numDeletedTris = 0;
+  bool abort = false;
+  while (!abort && numTris > 0 && this->ActualReduction < this->TargetReduction)
+  {
+    decimation.BuildEdges();
+    std::vector<vtkIdType> edges = decimation.SelectEdges();
+
+    // Stop where the serial implementation would, the cheapest edges first.
+    size_t numEdges = 0;
+    for (vtkIdType deleted = numDeletedTris;
+         numEdges < edges.size() && static_cast<double>(deleted) / numTris < this->TargetReduction;
+         ++numEdges)
+    {
+      deleted += decimation.GetNumberOfEdgeTriangles(edges[numEdges]);
+    }
+    edges.resize(numEdges);
+    if (edges.empty())
+    {
+      break;
+    }
+
+    vtkDebugMacro(<< "Collapsing " << edges.size() << " edges");
+    numDeletedTris += decimation.CollapseEdges(edges);
+    this->NumberOfEdgeCollapses += static_cast<int>(edges.size());
+    this->ActualReduction = static_cast<double>(numDeletedTris) / numTris;
+    decimation.BuildStars();
+
+    this->UpdateProgress(0.2 + 0.8 * this->ActualReduction / this->TargetReduction);
+    abort = this->CheckAbort();
+  }
+  vtkDebugMacro(<< "Number Of Edge Collapses: " << this->NumberOfEdgeCollapses);
+
+  // Copy the remaining triangles and the points they use, keeping their order.
+  std::vector<vtkIdType> pointMap(numPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      pointMap[ptId] = decimation.StarOffsets[ptId + 1] > decimation.StarOffsets[ptId] ? 1 : 0;
+    }
+  });
+  const vtkIdType numNewPts =
+    vtkSMPTools::ExclusiveScan(pointMap.begin(), pointMap.end(), pointMap.begin(), vtkIdType(0));
+  std::vector<vtkIdType> triMap(decimation.Alive.begin(), decimation.Alive.end());
+  const vtkIdType numNewTris =
+    vtkSMPTools::ExclusiveScan(triMap.begin(), triMap.end(), triMap.begin(), vtkIdType(0));
+
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(inPts->GetDataType());
+  newPts->SetNumberOfPoints(numNewPts);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      if (decimation.StarOffsets[ptId + 1] > decimation.StarOffsets[ptId])
+      {
+        newPts->SetPoint(pointMap[ptId], decimation.GetPoint(ptId));
+      }
+    }
+  });
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numNewTris + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(3 * numNewTris);
+  vtkSMPTools::For(0, numNewTris + 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType triId = begin; triId < end; ++triId)
+    {
+      offsets->SetValue(triId, 3 * triId);
+    }
+  });
+  vtkSMPTools::For(0, numTris, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType triId = begin; triId < end; ++triId)
+    {
+      if (decimation.Alive[triId])
+      {
+        const vtkIdType* tri = decimation.GetTriangle(triId);
+        for (int i = 0; i < 3; ++i)
+        {
+          connectivity->SetValue(3 * triMap[triId] + i, pointMap[tri[i]]);
+        }
+      }
+    }
+  });
+  vtkNew<vtkCellArray> newPolys;
+  newPolys->SetData(offsets, connectivity);
+
+  output->Reset();
+  output->SetPoints(newPts);
+  output->SetPolys(newPolys);
+
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
 {
@@ -431,7 +1284,7 @@ void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
   const vtkIdType* pts = nullptr;
   double point0[3], point1[3], point2[3];
   double n[3];
-  double tempP1[3], tempP2[3], d, triArea2;
+  double d, triArea2;
   double data[16];
   double *A[4], x[4];
   int index[4];
@@ -466,51 +1319,8 @@ void vtkQuadricDecimation::InitializeQuadrics(vtkIdType numPts)
     input->GetPoint(pts[0], point0);
     input->GetPoint(pts[1], point1);
     input->GetPoint(pts[2], point2);
-    for (i = 0; i < 3; i++)
-    {
-      tempP1[i] = point1[i] - point0[i];
-      tempP2[i] = point2[i] - point0[i];
-    }
-    vtkMath::Cross(tempP1, tempP2, n);
-    triArea2 = vtkMath::Normalize(n);
-    // triArea2 = (triArea2 * triArea2 * 0.25);
-    triArea2 = triArea2 * 0.5;
-    // I am unsure whether this should be squared or not??
-    d = -vtkMath::Dot(n, point0);
-    // could possible add in angle weights??
-
-    // set the geometric part of the QEM
-    QEM[0] = n[0] * n[0];
-    QEM[1] = n[0] * n[1];
-    QEM[2] = n[0] * n[2];
-    QEM[3] = d * n[0];
-
-    QEM[4] = n[1] * n[1];
-    QEM[5] = n[1] * n[2];
-    QEM[6] = d * n[1];
-
-    QEM[7] = n[2] * n[2];
-    QEM[8] = d * n[2];
-
-    QEM[9] = d * d;
-    QEM[10] = 1;
-
-    if (this->Regularize)
-    {
-      // Add in some regularizing identity \Sigma_n
-      QEM[0] += regularizationVariance;
-      QEM[4] += regularizationVariance;
-      QEM[7] += regularizationVariance;
-
-      // -\Sigma_n . q
-      QEM[3] -= regularizationVariance * point0[0];
-      QEM[6] -= regularizationVariance * point0[1];
-      QEM[8] -= regularizationVariance * point0[2];
-
-      // q^T \Sigma_n q + n^T \Sigma_q n + Tr(\Sigma_n \Sigma_q)
-      QEM[9] +=
-        regularizationVariance * (vtkMath::Dot(point0, point0) + 1 + 3 * regularizationVariance);
-    }
+    triArea2 = ComputeTriangleQuadric(
+      point0, point1, point2, this->Regularize, regularizationVariance, n, d, QEM);
 
     if (this->AttributeErrorMetric)
     {
@@ -652,7 +1462,7 @@ void vtkQuadricDecimation::AddBoundaryConstraints()
   vtkIdType npts;
   const vtkIdType* pts;
   double t0[3], t1[3], t2[3];
-  double e0[3], e1[3], n[3], c, w;
+  double w;
   vtkIdList* cellIds = vtkIdList::New();
 
   // allocate local QEM space matrix
@@ -671,70 +1481,8 @@ void vtkQuadricDecimation::AddBoundaryConstraints()
         input->GetPoint(pts[(i + 2) % 3], t0);
         input->GetPoint(pts[i], t1);
         input->GetPoint(pts[(i + 1) % 3], t2);
-
-        // computing a plane which is orthogonal to line t1, t2 and incident
-        // with it
-        for (j = 0; j < 3; j++)
-        {
-          e0[j] = t2[j] - t1[j];
-        }
-        for (j = 0; j < 3; j++)
-        {
-          e1[j] = t0[j] - t1[j];
-        }
-
-        // compute n so that it is orthogonal to e0 and parallel to the
-        // triangle
-        c = vtkMath::Dot(e0, e1) / (e0[0] * e0[0] + e0[1] * e0[1] + e0[2] * e0[2]);
-        for (j = 0; j < 3; j++)
-        {
-          n[j] = e1[j] - c * e0[j];
-        }
-        vtkMath::Normalize(n);
-
-#if defined(_MSC_VER) && _MSC_VER >= 1929
-        // Visual Studio toolset starting at toolset 14.29.30133, when building in Release mode
-        // incorrectly optimizes away the line
-        //    QEM[9] = d * d;
-        // By making volatile, we are telling the compiler not to optimize out
-        // or reorder operations regarding this variable.
-        volatile
-#endif
-          double d = -vtkMath::Dot(n, t1);
-        // The above line might merit some review: The same quadric gets added to t1 and t2 and one
-        // might prefer adding a quadric calculated using t1 at t1 and using t2 at t2
-        w = vtkMath::Norm(e0);
-
-        if (!this->WeighBoundaryConstraintsByLength)
-        {
-          /*
-           * The argument for using area instead of length is based on homogeneity here: The quadric
-           * field is already weighted by triangle area. It makes sense weighting the boundary
-           * constraints by area instead of length. Length technically has zero measure in terms of
-           * units of area. The squared version also seems to give more coherent results at the
-           * boundary.
-           */
-          w *= w;
-        }
-        w *= this->BoundaryWeightFactor;
-
-        // could possible add in
-        // angle weights??
-        QEM[0] = n[0] * n[0];
-        QEM[1] = n[0] * n[1];
-        QEM[2] = n[0] * n[2];
-        QEM[3] = d * n[0];
-
-        QEM[4] = n[1] * n[1];
-        QEM[5] = n[1] * n[2];
-        QEM[6] = d * n[1];
-
-        QEM[7] = n[2] * n[2];
-        QEM[8] = d * n[2];
-
-        QEM[9] = d * d;
-
-        QEM[10] = 1;
+        w = ComputeBoundaryQuadric(
+          t0, t1, t2, this->WeighBoundaryConstraintsByLength, this->BoundaryWeightFactor, QEM);
 
         // need to add orthogonal plane with the other Attributes, but this
         // is not clear??
@@ -896,97 +1644,21 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
 //------------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double* x)
 {
-  static const double errorNumber = 1e-10;
-  double temp[3], A[3][3], b[3];
   vtkIdType pointIds[2];
-  double cost = 0.0;
-  double* index;
-  int i, j;
-  double newPoint[4];
-  double v[3], c, norm, normTemp, temp2[3];
   double pt1[3], pt2[3];
 
   pointIds[0] = this->EndPoint1List->GetId(edgeId);
   pointIds[1] = this->EndPoint2List->GetId(edgeId);
 
-  for (i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
+  for (int i = 0; i < 11 + 4 * this->NumberOfComponents; i++)
   {
     this->TempQuad[i] =
       this->ErrorQuadrics[pointIds[0]].Quadric[i] + this->ErrorQuadrics[pointIds[1]].Quadric[i];
   }
 
-  A[0][0] = this->TempQuad[0];
-  A[0][1] = A[1][0] = this->TempQuad[1];
-  A[0][2] = A[2][0] = this->TempQuad[2];
-  A[1][1] = this->TempQuad[4];
-  A[1][2] = A[2][1] = this->TempQuad[5];
-  A[2][2] = this->TempQuad[7];
-
-  b[0] = -this->TempQuad[3];
-  b[1] = -this->TempQuad[6];
-  b[2] = -this->TempQuad[8];
-
-  norm = vtkMath::Norm(A[0]);
-  normTemp = vtkMath::Norm(A[1]);
-  norm = norm > normTemp ? norm : normTemp;
-  normTemp = vtkMath::Norm(A[2]);
-  norm = norm > normTemp ? norm : normTemp;
-
-  if (fabs(vtkMath::Determinant3x3(A)) / (norm * norm * norm) > errorNumber)
-  {
-    // it would be better to use the normal of the matrix to test singularity??
-    vtkMath::LinearSolve3x3(A, b, x);
-  }
-  else
-  {
-    // cheapest point along the edge
-    this->Mesh->GetPoints()->GetPoint(pointIds[0], pt1);
-    this->Mesh->GetPoints()->GetPoint(pointIds[1], pt2);
-    v[0] = pt2[0] - pt1[0];
-    v[1] = pt2[1] - pt1[1];
-    v[2] = pt2[2] - pt1[2];
-
-    // equation for the edge pt1 + c * v
-    // attempt least squares fit for c for A*(pt1 + c * v) = b
-    vtkMath::Multiply3x3(A, v, temp2);
-    if (vtkMath::Dot(temp2, temp2) > errorNumber)
-    {
-      vtkMath::Multiply3x3(A, pt1, temp);
-      for (i = 0; i < 3; i++)
-        temp[i] = b[i] - temp[i];
-      c = vtkMath::Dot(temp2, temp) / vtkMath::Dot(temp2, temp2);
-      for (i = 0; i < 3; i++)
-        x[i] = pt1[i] + c * v[i];
-    }
-    else
-    {
-      // use mid point
-      // might want to change to best of mid and end points??
-      for (i = 0; i < 3; i++)
-      {
-        x[i] = 0.5 * (pt1[i] + pt2[i]);
-      }
-    }
-  }
-
-  newPoint[0] = x[0];
-  newPoint[1] = x[1];
-  newPoint[2] = x[2];
-  newPoint[3] = 1;
-
-  // Compute the cost
-  // x'*quad*x
-  index = this->TempQuad;
-  for (i = 0; i < 4; i++)
-  {
-    cost += (*index++) * newPoint[i] * newPoint[i];
-    for (j = i + 1; j < 4; j++)
-    {
-      cost += 2.0 * (*index++) * newPoint[i] * newPoint[j];
-    }
-  }
-
-  return cost;
+  this->Mesh->GetPoints()->GetPoint(pointIds[0], pt1);
+  this->Mesh->GetPoints()->GetPoint(pointIds[1], pt2);
+  return ComputeQuadricCost(this->TempQuad, pt1, pt2, x);
 }
 
 //------------------------------------------------------------------------------
@@ -1291,41 +1963,7 @@ int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id)
 int vtkQuadricDecimation::TrianglePlaneCheck(
   const double t0[3], const double t1[3], const double t2[3], const double* x)
 {
-  double e0[3], e1[3], n[3], e2[3];
-  double c;
-  int i;
-
-  for (i = 0; i < 3; i++)
-  {
-    e0[i] = t2[i] - t1[i];
-  }
-  for (i = 0; i < 3; i++)
-  {
-    e1[i] = t0[i] - t1[i];
-  }
-
-  // projection of e0 onto e1
-  c = vtkMath::Dot(e0, e1) / (e0[0] * e0[0] + e0[1] * e0[1] + e0[2] * e0[2]);
-  for (i = 0; i < 3; i++)
-  {
-    n[i] = e1[i] - c * e0[i];
-  }
-
-  for (i = 0; i < 3; i++)
-  {
-    e2[i] = x[i] - t1[i];
-  }
-
-  vtkMath::Normalize(n);
-  vtkMath::Normalize(e2);
-  if (vtkMath::Dot(n, e2) > 1e-5)
-  {
-    return 1;
-  }
-  else
-  {
-    return 0;
-  }
+  return IsOnTriangleSide(t0, t1, t2, x) ? 1 : 0;
 }
 
 int vtkQuadricDecimation::IsGoodPlacement(vtkIdType pt0Id, vtkIdType pt1Id, const double* x)
@@ -1511,5 +2149,6 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Normals Weight: " << this->NormalsWeight << "\n";
   os << indent << "TCoords Weight: " << this->TCoordsWeight << "\n";
   os << indent << "Tensors Weight: " << this->TensorsWeight << "\n";
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 VTK_ABI_NAMESPACE_END
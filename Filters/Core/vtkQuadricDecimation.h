@@ -48,6 +48,16 @@
  * Attributes" is also a good take on the subject especially as it pertains
  * to the error metric applied to attributes.
  *
+ * When EnableSMP is on, a threaded implementation based on vtkSMPTools is
+ * used instead of the priority queue. It collapses the edges by rounds: each
+ * round computes the cost of all the edges in parallel, then collapses at once
+ * the edges, among the cheapest tenth, which are cheaper than all the edges
+ * within their neighborhood.
+ * The global ordering of the collapses is lost, so the output differs from the
+ * serial one, with a similar error. The threaded implementation only uses the
+ * geometric error: it is not used when AttributeErrorMetric is on, and
+ * VolumePreservation has no effect on it.
+ *
  * @par Thanks:
  * Thanks to Bradley Lowekamp of the National Library of Medicine/NIH for
  * contributing this class.
@@ -188,6 +198,19 @@ public:
   vtkGetMacro(TensorsWeight, double);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded implementation. It only applies when
+   * AttributeErrorMetric is off, and ignores VolumePreservation. Since the
+   * edges are collapsed by rounds rather than one at a time, the output
+   * triangles differ from the serial ones, with a similar error, but the
+   * remaining points keep their input order. Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
   ///@{
   /**
    * Get the actual reduction. This value is only valid after the
@@ -202,6 +225,11 @@ protected:
 
   int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
+  /**
+   * Threaded implementation of RequestData(), used when EnableSMP is on.
+   */
+  int RequestDataSMP(vtkPolyData* input, vtkPolyData* output);
+
   /**
    * Do the dirty work of eliminating the edge; return the number of
    * triangles deleted.
@@ -312,6 +340,8 @@ protected:
   vtkTypeBool WeighBoundaryConstraintsByLength = false;
   double BoundaryWeightFactor = 1.0;
 
+  bool EnableSMP = false;
+
   // Contains 4 doubles per point. Length = nPoints * 4
   double* VolumeConstraints;
   int AttributeComponents[6];
@@ -30,6 +30,7 @@
 #include "vtkUnstructuredGrid.h"
 
 #include <algorithm>
+#include <functional>
 #include <vector>
 
 VTK_ABI_NAMESPACE_BEGIN
@@ -579,25 +580,41 @@ vtkIdType vtkStaticCleanUnstructuredGrid::BuildPointMap(
   vtkIdType numPts, vtkIdType* pmap, unsigned char* ptUses, std::vector<vtkIdType>& mergeMap)
 {
   // Count and map points to new points, taking into account
-  // point uses (if requested).
-  vtkIdType id, numNewPts = 0;
-  // Perform a prefix sum to count the number of new points.
-  std::fill_n(pmap, numPts, (-1));
-  for (id = 0; id < numPts; ++id)
-  {
-    if (mergeMap[id] == id && (ptUses == nullptr || ptUses[id] != 0))
+  // point uses (if requested). A point is kept if it is not merged into
+  // another point, and is used (if requested).
+  auto isKept = [&](vtkIdType id) {
+    return mergeMap[id] == id && (ptUses == nullptr || ptUses[id] != 0);
+  };
+  vtkSMPTools::For(0, numPts, [&](vtkIdType id, vtkIdType endId) {
+    for (; id < endId; ++id)
     {
-      pmap[id] = numNewPts++;
+      pmap[id] = isKept(id) ? 1 : 0;
     }
-  }
-  // Now map old merged points to new points
-  for (id = 0; id < numPts; ++id)
-  {
-    if (mergeMap[id] != id)
+  });
+
+  // Perform a prefix sum to count the number of new points.
+  vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(pmap, pmap + numPts, pmap, vtkIdType(0));
+
+  // Now discard unused points, and map old merged points to new points.
+  // Only merged points read the map, and only at kept points, so there is
+  // no race.
+  vtkSMPTools::For(0, numPts, [&](vtkIdType id, vtkIdType endId) {
+    for (; id < endId; ++id)
     {
-      pmap[id] = pmap[mergeMap[id]];
+      const vtkIdType mergedId = mergeMap[id];
+      if (mergedId == id)
+      {
+        if (!isKept(id))
+        {
+          pmap[id] = (-1);
+        }
+      }
+      else
+      {
+        pmap[id] = isKept(mergedId) ? pmap[mergedId] : (-1);
+      }
     }
-  }
+  });
   return numNewPts;
 }
 
@@ -641,15 +658,11 @@ void vtkStaticCleanUnstructuredGrid::AveragePoints(vtkPoints* inPts, vtkPointDat
   vtkSMPTools::For(0, numInPts, count);
 
   // Perform a prefix sum to determine the offsets.
-  vtkIdType ptId, npts;
   std::unique_ptr<vtkIdType> uOffsets(new vtkIdType[numOutPts + 1]); // extra +1 for convenience
   vtkIdType* offsets = uOffsets.get();
-  offsets[0] = 0;
-  for (ptId = 1; ptId <= numOutPts; ++ptId)
-  {
-    npts = counts[ptId - 1];
-    offsets[ptId] = offsets[ptId - 1] + npts;
-  }
+  offsets[numOutPts] = vtkSMPTools::TransformExclusiveScan(counts, counts + numOutPts, offsets,
+    vtkIdType(0), std::plus<vtkIdType>(),
+    [](const std::atomic<vtkIdType>& npts) { return npts.load(std::memory_order_relaxed); });
 
   // Configure the "links" which are, for each output point, lists
   // the input points merged to that output point. The offsets point into
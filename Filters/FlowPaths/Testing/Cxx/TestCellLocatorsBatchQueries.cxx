@@ -0,0 +1,184 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellLocatorsBatchQueries.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the batched queries of the cell locators, FindCells and
+// IntersectWithLines, with the point by point queries.
+
+#include "vtkBVHCellLocator.h"
+#include "vtkCellLocator.h"
+#include "vtkCellTreeLocator.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkModifiedBSPTree.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+void GenerateRandomPoints(vtkIdType npts, vtkPoints* points, double bound, unsigned int seed)
+{
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(npts);
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> dist(-bound, bound);
+  double point[3];
+  for (vtkIdType pointId = 0; pointId < npts; ++pointId)
+  {
+    point[0] = dist(gen);
+    point[1] = dist(gen);
+    point[2] = dist(gen);
+    points->SetPoint(pointId, point);
+  }
+}
+
+bool TestFindCells(vtkAbstractCellLocator* locator, vtkPoints* points)
+{
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkDoubleArray> pcoords;
+  locator->FindCells(points, 0.0, cellIds, pcoords);
+  if (cellIds->GetNumberOfIds() != points->GetNumberOfPoints() ||
+    pcoords->GetNumberOfTuples() != points->GetNumberOfPoints())
+  {
+    std::cerr << locator->GetClassName() << "::FindCells returned "
+              << cellIds->GetNumberOfIds() << " cells for " << points->GetNumberOfPoints()
+              << " points" << std::endl;
+    return false;
+  }
+
+  vtkNew<vtkGenericCell> cell;
+  std::vector<double> weights(8);
+  vtkIdType numFound = 0;
+  double x[3], pc[3];
+  int subId;
+  for (vtkIdType ptId = 0; ptId < points->GetNumberOfPoints(); ++ptId)
+  {
+    points->GetPoint(ptId, x);
+    const vtkIdType cellId = locator->FindCell(x, 0.0, cell, subId, pc, weights.data());
+    const double* batchPCoords = pcoords->GetTuple3(ptId);
+    if (cellId != cellIds->GetId(ptId) ||
+      (cellId >= 0 &&
+        (pc[0] != batchPCoords[0] || pc[1] != batchPCoords[1] || pc[2] != batchPCoords[2])))
+    {
+      std::cerr << locator->GetClassName() << "::FindCells differs for point " << ptId << ": "
+                << cellIds->GetId(ptId) << " instead of " << cellId << std::endl;
+      return false;
+    }
+    numFound += (cellId >= 0 ? 1 : 0);
+  }
+  if (numFound == 0 || numFound == points->GetNumberOfPoints())
+  {
+    std::cerr << locator->GetClassName() << "::FindCells found " << numFound
+              << " points, the test points should be partly outside" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestIntersectWithLines(vtkAbstractCellLocator* locator, vtkPoints* p1, vtkPoints* p2)
+{
+  vtkNew<vtkIdList> cellIds;
+  vtkNew<vtkDoubleArray> tValues;
+  vtkNew<vtkPoints> xPoints;
+  xPoints->SetDataTypeToDouble();
+  const double tol = 1e-8;
+  locator->IntersectWithLines(p1, p2, tol, cellIds, tValues, xPoints);
+  if (cellIds->GetNumberOfIds() != p1->GetNumberOfPoints() ||
+    tValues->GetNumberOfTuples() != p1->GetNumberOfPoints() ||
+    xPoints->GetNumberOfPoints() != p1->GetNumberOfPoints())
+  {
+    std::cerr << locator->GetClassName() << "::IntersectWithLines returned "
+              << cellIds->GetNumberOfIds() << " cells for " << p1->GetNumberOfPoints()
+              << " lines" << std::endl;
+    return false;
+  }
+
+  vtkNew<vtkGenericCell> cell;
+  vtkIdType numHits = 0;
+  double a0[3], a1[3], t, x[3], xBatch[3], pcoords[3];
+  int subId;
+  vtkIdType cellId;
+  for (vtkIdType lineId = 0; lineId < p1->GetNumberOfPoints(); ++lineId)
+  {
+    p1->GetPoint(lineId, a0);
+    p2->GetPoint(lineId, a1);
+    if (!locator->IntersectWithLine(a0, a1, tol, t, x, pcoords, subId, cellId, cell))
+    {
+      cellId = -1;
+    }
+    xPoints->GetPoint(lineId, xBatch);
+    if (cellId != cellIds->GetId(lineId) ||
+      (cellId >= 0 &&
+        (t != tValues->GetValue(lineId) || x[0] != xBatch[0] || x[1] != xBatch[1] ||
+          x[2] != xBatch[2])))
+    {
+      std::cerr << locator->GetClassName() << "::IntersectWithLines differs for line " << lineId
+                << ": " << cellIds->GetId(lineId) << " instead of " << cellId << std::endl;
+      return false;
+    }
+    numHits += (cellId >= 0 ? 1 : 0);
+  }
+  if (numHits == 0 || numHits == p1->GetNumberOfPoints())
+  {
+    std::cerr << locator->GetClassName() << "::IntersectWithLines hit " << numHits
+              << " lines, the test lines should partly miss the cells" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestCellLocatorsBatchQueries(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(-10, 10, -10, 10, -10, 10);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputData(image);
+  tetrahedralize->Update();
+  vtkUnstructuredGrid* grid = tetrahedralize->GetOutput();
+
+  vtkNew<vtkPoints> points;
+  GenerateRandomPoints(20000, points, 12.0, 1);
+  vtkNew<vtkPoints> p1;
+  GenerateRandomPoints(5000, p1, 30.0, 2);
+  vtkNew<vtkPoints> p2;
+  GenerateRandomPoints(5000, p2, 30.0, 3);
+
+  vtkSmartPointer<vtkAbstractCellLocator> locators[] = {
+    vtkSmartPointer<vtkCellLocator>::New(),
+    vtkSmartPointer<vtkStaticCellLocator>::New(),
+    vtkSmartPointer<vtkCellTreeLocator>::New(),
+    vtkSmartPointer<vtkModifiedBSPTree>::New(),
+    vtkSmartPointer<vtkBVHCellLocator>::New(),
+  };
+  bool success = true;
+  for (vtkAbstractCellLocator* locator : locators)
+  {
+    locator->SetDataSet(grid);
+    locator->BuildLocator();
+    success &= TestFindCells(locator, points);
+    success &= TestIntersectWithLines(locator, p1, p2);
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -13,6 +13,7 @@
 
 =========================================================================*/
 
+#include "vtkBVHCellLocator.h"
 #include "vtkCellLocator.h"
 #include "vtkCellTreeLocator.h"
 #include "vtkDataSetTriangleFilter.h"
@@ -162,5 +163,8 @@ int TestCellLocatorsLinearTransform(int vtkNotUsed(argc), char* vtkNotUsed(argv)
   vtkNew<vtkModifiedBSPTree> bsp;
   testPassed &= TestCellLocators(
     dataset, transformedDataset, transformedRandomPoints, bsp, acceptableAccuracyPercentage);
+  vtkNew<vtkBVHCellLocator> bvh;
+  testPassed &= TestCellLocators(
+    dataset, transformedDataset, transformedRandomPoints, bvh, acceptableAccuracyPercentage);
   return testPassed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
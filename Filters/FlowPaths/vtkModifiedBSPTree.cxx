@@ -20,10 +20,13 @@
 #include "vtkAppendPolyData.h"
 #include "vtkBox.h"
 #include "vtkCubeSource.h"
+#include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkIdListCollection.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
 
 #include <algorithm>
@@ -614,6 +617,17 @@ int vtkModifiedBSPTree::IntersectWithLine(const double p1[3], const double p2[3]
   {
     return 0;
   }
+  // The intersection query array is allocated locally to ensure thread safety.
+  std::vector<bool> cellHasBeenVisited;
+  return this->IntersectWithLineInternal(
+    p1, p2, tol, t, x, pcoords, subId, cellId, cell, cellHasBeenVisited);
+}
+
+//------------------------------------------------------------------------------
+int vtkModifiedBSPTree::IntersectWithLineInternal(const double p1[3], const double p2[3],
+  double tol, double& t, double x[3], double pcoords[3], int& subId, vtkIdType& cellId,
+  vtkGenericCell* cell, std::vector<bool>& cellHasBeenVisited)
+{
   BSPNode *node, *Near, *Mid, *Far;
   double tmin, tmax, tDist, tHitCell, tBest = VTK_DOUBLE_MAX, xBest[3], pCoordsBest[3];
   double rayDir[3], x0[3], x1[3], hitCellBoundsPosition[3], cellBounds[6], *cellBoundsPtr;
@@ -629,7 +643,10 @@ int vtkModifiedBSPTree::IntersectWithLine(const double p1[3], const double p2[3]
   {
     return false;
   }
-  std::vector<bool> cellHasBeenVisited(this->DataSet->GetNumberOfCells(), false);
+  if (cellHasBeenVisited.empty())
+  {
+    cellHasBeenVisited.resize(this->DataSet->GetNumberOfCells(), false);
+  }
   // Ok, setup a stack and various params
   nodestack ns;
   // setup our axis optimized ray box edge stuff
@@ -941,6 +958,13 @@ vtkIdType vtkModifiedBSPTree::FindCell(
   {
     return -1;
   }
+  return this->FindCellInternal(x, cell, subId, pcoords, weights);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType vtkModifiedBSPTree::FindCellInternal(
+  double x[3], vtkGenericCell* cell, int& subId, double pcoords[3], double* weights)
+{
   // check if x outside of bounds
   if (!vtkAbstractCellLocator::IsInBounds(this->mRoot->Bounds, x))
   {
@@ -990,6 +1014,104 @@ vtkIdType vtkModifiedBSPTree::FindCell(
   return -1;
 }
 
+//------------------------------------------------------------------------------
+// The batched queries process the ordered queries in parallel, so that each
+// thread traverses neighboring branches of the tree.
+void vtkModifiedBSPTree::FindCells(
+  vtkPoints* points, double, vtkIdList* cellIds, vtkDoubleArray* pcoords)
+{
+  const vtkIdType numPts = points->GetNumberOfPoints();
+  vtkAbstractCellLocator::InitializeQueryOutputs(numPts, cellIds, pcoords, 3, nullptr);
+  this->BuildLocator();
+  if (numPts < 1 || this->mRoot == nullptr)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    return;
+  }
+  std::vector<vtkIdType> order;
+  vtkAbstractCellLocator::ComputeQueryOrder(points, order);
+
+  const int maxCellSize = this->DataSet->GetMaxCellSize();
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPThreadLocal<std::vector<double>> tlWeights;
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    vtkGenericCell* cell = tlCell.Local();
+    std::vector<double>& weights = tlWeights.Local();
+    weights.resize(maxCellSize);
+    double x[3], pc[3];
+    int subId;
+    for (; begin < end; ++begin)
+    {
+      const vtkIdType ptId = order[begin];
+      points->GetPoint(ptId, x);
+      const vtkIdType cellId = this->FindCellInternal(x, cell, subId, pc, weights.data());
+      cellIds->SetId(ptId, cellId);
+      if (pcoords)
+      {
+        if (cellId < 0)
+        {
+          pc[0] = pc[1] = pc[2] = 0.0;
+        }
+        pcoords->SetTypedTuple(ptId, pc);
+      }
+    }
+  });
+}
+
+//------------------------------------------------------------------------------
+void vtkModifiedBSPTree::IntersectWithLines(
+  vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds, vtkDoubleArray* t, vtkPoints* x)
+{
+  const vtkIdType numLines = p1->GetNumberOfPoints();
+  if (p2->GetNumberOfPoints() != numLines)
+  {
+    vtkErrorMacro(<< "The end points of the lines differ in number");
+    cellIds->Reset();
+    return;
+  }
+  vtkAbstractCellLocator::InitializeQueryOutputs(numLines, cellIds, t, 1, x);
+  this->BuildLocator();
+  if (numLines < 1 || this->mRoot == nullptr)
+  {
+    std::fill(cellIds->begin(), cellIds->end(), -1);
+    return;
+  }
+  std::vector<vtkIdType> order;
+  vtkAbstractCellLocator::ComputeQueryOrder(p1, order);
+
+  vtkSMPThreadLocalObject<vtkGenericCell> tlCell;
+  vtkSMPThreadLocal<std::vector<bool>> tlCellHasBeenVisited;
+  vtkSMPTools::For(0, numLines, [&](vtkIdType begin, vtkIdType end) {
+    vtkGenericCell* cell = tlCell.Local();
+    std::vector<bool>& cellHasBeenVisited = tlCellHasBeenVisited.Local();
+    double a0[3], a1[3], tHit, xHit[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    for (; begin < end; ++begin)
+    {
+      const vtkIdType lineId = order[begin];
+      p1->GetPoint(lineId, a0);
+      p2->GetPoint(lineId, a1);
+      if (!this->IntersectWithLineInternal(a0, a1, tol, tHit, xHit, pcoords, subId, cellId, cell,
+            cellHasBeenVisited))
+      {
+        cellId = -1;
+        tHit = xHit[0] = xHit[1] = xHit[2] = 0.0;
+      }
+      std::fill(cellHasBeenVisited.begin(), cellHasBeenVisited.end(), false);
+      cellIds->SetId(lineId, cellId);
+      if (t)
+      {
+        t->SetValue(lineId, tHit);
+      }
+      if (x)
+      {
+        x->SetPoint(lineId, xHit);
+      }
+    }
+  });
+}
+
 //------------------------------------------------------------------------------
 vtkIdListCollection* vtkModifiedBSPTree::GetLeafNodeCellInformation()
 {
@@ -164,6 +164,8 @@
 #include "vtkFiltersFlowPathsModule.h" // For export macro
 #include "vtkSmartPointer.h"           // required because it is nice
 
+#include <vector> // For std::vector
+
 VTK_ABI_NAMESPACE_BEGIN
 class Sorted_cell_extents_Lists;
 class BSPNode;
@@ -236,6 +238,17 @@ public:
   vtkIdType FindCell(double x[3], double vtkNotUsed(tol2), vtkGenericCell* GenCell, int& subId,
     double pcoords[3], double* weights) override;
 
+  ///@{
+  /**
+   * Batched FindCell() and IntersectWithLine(), traversing the tree directly
+   * in a spatially coherent order. See vtkAbstractCellLocator.
+   */
+  void FindCells(vtkPoints* points, double tol2, vtkIdList* cellIds,
+    vtkDoubleArray* pcoords = nullptr) override;
+  void IntersectWithLines(vtkPoints* p1, vtkPoints* p2, double tol, vtkIdList* cellIds,
+    vtkDoubleArray* t = nullptr, vtkPoints* x = nullptr) override;
+  ///@}
+
   /**
    * After subdivision has completed, one may wish to query the tree to find
    * which cells are in which leaf nodes. This function returns a list
@@ -277,6 +290,16 @@ protected:
   void Subdivide(BSPNode* node, Sorted_cell_extents_Lists* lists, vtkDataSet* dataSet,
     vtkIdType nCells, int depth, int maxlevel, vtkIdType maxCells, int& MaxDepth);
 
+  // FindCell() and IntersectWithLine() on the built tree. The array of cells
+  // visited by the line is provided by the caller, so that a batch of lines
+  // reuses it. It is allocated on first use, and must be cleared between the
+  // lines.
+  vtkIdType FindCellInternal(
+    double x[3], vtkGenericCell* cell, int& subId, double pcoords[3], double* weights);
+  int IntersectWithLineInternal(const double p1[3], const double p2[3], double tol, double& t,
+    double x[3], double pcoords[3], int& subId, vtkIdType& cellId, vtkGenericCell* cell,
+    std::vector<bool>& cellHasBeenVisited);
+
 private:
   vtkModifiedBSPTree(const vtkModifiedBSPTree&) = delete;
   void operator=(const vtkModifiedBSPTree&) = delete;
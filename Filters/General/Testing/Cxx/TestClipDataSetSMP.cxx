@@ -0,0 +1,506 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestClipDataSetSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the threaded and the serial implementations of vtkClipDataSet.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellType.h>
+#include <vtkClipDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkNonMergingPointLocator.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphere.h>
+#include <vtkSphereSource.h>
+#include <vtkTetra.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <map>
+
+namespace
+{
+const int Resolution = 20;
+
+// Update a serial and a threaded filter, both set up by configure.
+template <typename TFilter, typename TConfigure>
+std::array<vtkSmartPointer<TFilter>, 2> UpdateSerialAndThreaded(TConfigure&& configure)
+{
+  std::array<vtkSmartPointer<TFilter>, 2> filters = { { vtkSmartPointer<TFilter>::New(),
+    vtkSmartPointer<TFilter>::New() } };
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    configure(filter.Get());
+  }
+  filters[1]->EnableSMPOn();
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    filter->Update();
+  }
+  return filters;
+}
+
+bool SameTuples(vtkDataArray* a, vtkIdType aId, vtkDataArray* b, vtkIdType bId)
+{
+  for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+  {
+    if (a->GetComponent(aId, c) != b->GetComponent(bId, c))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+  {
+    if (!SameTuples(a, t, b, t))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SamePoints(vtkPoints* a, vtkPoints* b, double tolerance)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints())
+  {
+    return false;
+  }
+  for (vtkIdType ptId = 0; ptId < a->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], y[3];
+    a->GetPoint(ptId, x);
+    b->GetPoint(ptId, y);
+    for (int i = 0; i < 3; ++i)
+    {
+      if (std::abs(x[i] - y[i]) > tolerance)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Compare the types and sizes of the cells of two grids, in order, and with
+// comparePointIds their point ids.
+bool SameCells(vtkDataSet* a, vtkDataSet* b, bool comparePointIds = true)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> aIds;
+  vtkNew<vtkIdList> bIds;
+  for (vtkIdType c = 0; c < a->GetNumberOfCells(); ++c)
+  {
+    a->GetCellPoints(c, aIds);
+    b->GetCellPoints(c, bIds);
+    if (a->GetCellType(c) != b->GetCellType(c) ||
+      aIds->GetNumberOfIds() != bIds->GetNumberOfIds() ||
+      (comparePointIds && !std::equal(aIds->begin(), aIds->end(), bIds->begin())))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Named arrays are matched by name, unnamed ones by index.
+bool SameData(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    const char* name = a->GetArrayName(i);
+    vtkDataArray* bArray = name ? b->GetArray(name) : b->GetArray(i);
+    if (!bArray || (!name && b->GetArrayName(i)) || !SameArrays(a->GetArray(i), bArray))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Points of a grid of Resolution^3 cubes, numbered along x first.
+vtkIdType GetGridPointId(int i, int j, int k)
+{
+  return (static_cast<vtkIdType>(k) * (Resolution + 1) + j) * (Resolution + 1) + i;
+}
+
+void InsertGridPoints(vtkPoints* points, double spacing)
+{
+  for (int k = 0; k <= Resolution; ++k)
+  {
+    for (int j = 0; j <= Resolution; ++j)
+    {
+      for (int i = 0; i <= Resolution; ++i)
+      {
+        points->InsertNextPoint(i * spacing, j * spacing, k * spacing);
+      }
+    }
+  }
+}
+
+// The points of cube (i, j, k), in the order of the points of a hexahedron.
+void GetCubePointIds(int i, int j, int k, vtkIdType p[8])
+{
+  p[0] = GetGridPointId(i, j, k);
+  p[1] = GetGridPointId(i + 1, j, k);
+  p[2] = GetGridPointId(i + 1, j + 1, k);
+  p[3] = GetGridPointId(i, j + 1, k);
+  p[4] = GetGridPointId(i, j, k + 1);
+  p[5] = GetGridPointId(i + 1, j, k + 1);
+  p[6] = GetGridPointId(i + 1, j + 1, k + 1);
+  p[7] = GetGridPointId(i, j + 1, k + 1);
+}
+
+// Insert the cube of points p as a hexahedron, five tetrahedra, two wedges or
+// a polyhedron.
+void InsertCube(vtkUnstructuredGrid* grid, const vtkIdType p[8], int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+    {
+      const vtkIdType tetras[5][4] = { { p[0], p[1], p[3], p[4] }, { p[1], p[2], p[3], p[6] },
+        { p[1], p[4], p[5], p[6] }, { p[3], p[4], p[6], p[7] }, { p[1], p[3], p[4], p[6] } };
+      for (const vtkIdType* tetra : tetras)
+      {
+        grid->InsertNextCell(VTK_TETRA, 4, tetra);
+      }
+      break;
+    }
+    case VTK_WEDGE:
+    {
+      const vtkIdType wedges[2][6] = { { p[0], p[1], p[3], p[4], p[5], p[7] },
+        { p[1], p[2], p[3], p[5], p[6], p[7] } };
+      for (const vtkIdType* wedge : wedges)
+      {
+        grid->InsertNextCell(VTK_WEDGE, 6, wedge);
+      }
+      break;
+    }
+    case VTK_POLYHEDRON:
+    {
+      const vtkIdType faces[30] = { 4, p[0], p[3], p[2], p[1], 4, p[4], p[5], p[6], p[7], 4, p[0],
+        p[1], p[5], p[4], 4, p[1], p[2], p[6], p[5], 4, p[2], p[3], p[7], p[6], 4, p[3], p[0], p[4],
+        p[7] };
+      grid->InsertNextCell(VTK_POLYHEDRON, 8, p, 6, faces);
+      break;
+    }
+    default:
+      grid->InsertNextCell(VTK_HEXAHEDRON, 8, p);
+  }
+}
+
+// The "CellIds" array matches the output cells with their input cell.
+void AddCellIds(vtkDataSet* dataSet)
+{
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < dataSet->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(static_cast<int>(cellId));
+  }
+  dataSet->GetCellData()->AddArray(cellIds);
+}
+
+void AddPointScalars(vtkDataSet* dataSet)
+{
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  for (vtkIdType ptId = 0; ptId < dataSet->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    dataSet->GetPoint(ptId, x);
+    pointScalars->InsertNextValue(x[0] + 2.0 * x[1] + 3.0 * x[2]);
+  }
+  dataSet->GetPointData()->SetScalars(pointScalars);
+}
+
+std::ostream& ReportDifference(vtkDataSet* expected, vtkDataSet* output)
+{
+  return std::cerr << "Threaded output of " << output->GetNumberOfPoints() << " points and "
+                   << output->GetNumberOfCells() << " cells instead of "
+                   << expected->GetNumberOfPoints() << " and " << expected->GetNumberOfCells()
+                   << " differs";
+}
+
+const double Tolerance = 1.0e-3 / (Resolution * Resolution * Resolution);
+
+enum GridType
+{
+  MIXED,
+  TETRAHEDRA,
+  POLYHEDRA
+};
+
+// A grid of hexahedra, tetrahedra and wedges, of tetrahedra or of polyhedra,
+// with quadrilaterals on a face and lines along some edges, carrying point
+// and cell data.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructGrid(GridType gridType)
+{
+  vtkNew<vtkPoints> points;
+  InsertGridPoints(points, 1.0 / Resolution);
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->Allocate();
+  const int cellTypes[3] = { VTK_HEXAHEDRON, VTK_TETRA, VTK_WEDGE };
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        vtkIdType p[8];
+        GetCubePointIds(i, j, k, p);
+        if (gridType == POLYHEDRA)
+        {
+          InsertCube(grid, p, VTK_POLYHEDRON);
+          continue;
+        }
+        InsertCube(grid, p, gridType == TETRAHEDRA ? VTK_TETRA : cellTypes[(i + j + k) % 3]);
+        if (k == 0)
+        {
+          grid->InsertNextCell(VTK_QUAD, 4, p);
+        }
+        if (k == 0 && j == 0)
+        {
+          grid->InsertNextCell(VTK_LINE, 2, p);
+        }
+      }
+    }
+  }
+  AddPointScalars(grid);
+  AddCellIds(grid);
+  return grid;
+}
+
+// A sphere of triangles, with some of its points as vertices and the edges of
+// some triangles as polylines.
+vtkSmartPointer<vtkPolyData> ConstructSurface()
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetCenter(0.5, 0.5, 0.5);
+  sphere->SetRadius(0.5);
+  sphere->SetThetaResolution(100);
+  sphere->SetPhiResolution(100);
+  sphere->Update();
+  vtkPolyData* polys = sphere->GetOutput();
+
+  vtkNew<vtkCellArray> verts;
+  for (vtkIdType ptId = 0; ptId < polys->GetNumberOfPoints(); ptId += 3)
+  {
+    verts->InsertNextCell(1, &ptId);
+  }
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < polys->GetNumberOfCells(); cellId += 5)
+  {
+    polys->GetCellPoints(cellId, ptIds);
+    ptIds->InsertNextId(ptIds->GetId(0));
+    lines->InsertNextCell(ptIds);
+  }
+
+  vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+  surface->SetPoints(polys->GetPoints());
+  surface->GetPointData()->ShallowCopy(polys->GetPointData());
+  surface->SetVerts(verts);
+  surface->SetLines(lines);
+  surface->SetPolys(polys->GetPolys());
+  AddCellIds(surface);
+  return surface;
+}
+
+// The volume of the pieces of the 3D cells, and the number of the other
+// cells, for each input cell.
+std::map<int, double> Measures(vtkUnstructuredGrid* output)
+{
+  std::map<int, double> measures;
+  vtkDataArray* cellIds = output->GetCellData()->GetArray("CellIds");
+  vtkNew<vtkGenericCell> cell;
+  vtkNew<vtkIdList> ptIds;
+  vtkNew<vtkPoints> points;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    double& measure = measures[static_cast<int>(cellIds->GetComponent(cellId, 0))];
+    output->GetCell(cellId, cell);
+    if (cell->GetCellDimension() != 3)
+    {
+      measure += 1.0;
+      continue;
+    }
+    cell->Triangulate(0, ptIds, points);
+    for (vtkIdType i = 0; i + 3 < points->GetNumberOfPoints(); i += 4)
+    {
+      double x[4][3];
+      for (int j = 0; j < 4; ++j)
+      {
+        points->GetPoint(i + j, x[j]);
+      }
+      measure += std::abs(vtkTetra::ComputeVolume(x[0], x[1], x[2], x[3]));
+    }
+  }
+  return measures;
+}
+
+// The clip function is interpolated linearly on other tetrahedra, the volumes
+// only match up to a fraction of the volume of a cell of the grid, and
+// slivers may be missing.
+bool SameMeasures(vtkUnstructuredGrid* a, vtkUnstructuredGrid* b)
+{
+  std::map<int, double> aMeasures = Measures(a);
+  std::map<int, double> bMeasures = Measures(b);
+  for (const auto& measure : aMeasures)
+  {
+    if (std::abs(measure.second - bMeasures[measure.first]) > Tolerance)
+    {
+      return false;
+    }
+  }
+  for (const auto& measure : bMeasures)
+  {
+    if (std::abs(measure.second - aMeasures[measure.first]) > Tolerance)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+enum Comparison
+{
+  EXACT,   // same output
+  VOLUMES, // other tetrahedralizations of the clipped 3D cells
+  TOPOLOGY // same numbers of points and cells, same cell types
+};
+
+bool SameOutputs(vtkUnstructuredGrid* expected, vtkUnstructuredGrid* output, Comparison comparison)
+{
+  switch (comparison)
+  {
+    case EXACT:
+      return SamePoints(expected->GetPoints(), output->GetPoints(), 0.0) &&
+        SameCells(expected, output) &&
+        SameData(expected->GetPointData(), output->GetPointData()) &&
+        SameData(expected->GetCellData(), output->GetCellData());
+    case VOLUMES:
+      return SameMeasures(expected, output);
+    default:
+      return expected->GetNumberOfPoints() == output->GetNumberOfPoints() &&
+        SameCells(expected, output, false) &&
+        SameData(expected->GetCellData(), output->GetCellData());
+  }
+}
+
+bool TestConfiguration(vtkDataSet* input, const char* name, bool useFunction,
+  bool generateClipScalars, bool insideOut, bool merging, Comparison comparison)
+{
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(0.37, 0.41, 0.43);
+  sphere->SetRadius(0.45);
+
+  auto filters = UpdateSerialAndThreaded<vtkClipDataSet>([&](vtkClipDataSet* clip) {
+    clip->SetInputData(input);
+    if (useFunction)
+    {
+      clip->SetClipFunction(sphere);
+      clip->SetGenerateClipScalars(generateClipScalars);
+    }
+    else
+    {
+      clip->SetValue(2.9);
+      clip->SetInputArrayToProcess(
+        0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS, "PointScalars");
+    }
+    clip->SetInsideOut(insideOut);
+    clip->GenerateClippedOutputOn();
+    if (!merging)
+    {
+      vtkNew<vtkNonMergingPointLocator> locator;
+      clip->SetLocator(locator);
+    }
+  });
+  vtkClipDataSet* serial = filters[0];
+  vtkClipDataSet* threaded = filters[1];
+
+  const bool same = serial->GetOutput()->GetNumberOfCells() > 0 &&
+    serial->GetClippedOutput()->GetNumberOfCells() > 0 &&
+    SameOutputs(serial->GetOutput(), threaded->GetOutput(), comparison) &&
+    SameOutputs(serial->GetClippedOutput(), threaded->GetClippedOutput(), comparison);
+  if (!same)
+  {
+    ReportDifference(serial->GetOutput(), threaded->GetOutput())
+      << " for the " << name << " with clip function " << useFunction << ", clip scalars "
+      << generateClipScalars << ", inside out " << insideOut << " and merging " << merging
+      << std::endl;
+  }
+  return same;
+}
+}
+
+int TestClipDataSetSMP(int, char*[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = ConstructGrid(MIXED);
+  vtkSmartPointer<vtkUnstructuredGrid> tetrahedra = ConstructGrid(TETRAHEDRA);
+  vtkSmartPointer<vtkUnstructuredGrid> polyhedra = ConstructGrid(POLYHEDRA);
+  vtkSmartPointer<vtkPolyData> surface = ConstructSurface();
+  bool success = true;
+
+  // Hexahedra and wedges are tetrahedralized following the order of their
+  // points in the output, which differs when merging points, and the
+  // tetrahedra of hexahedra are output in the order of the cached templates.
+  for (bool insideOut : { false, true })
+  {
+    for (bool merging : { true, false })
+    {
+      success &= TestConfiguration(grid, "grid", true, false, insideOut, merging, VOLUMES);
+      success &= TestConfiguration(grid, "grid", true, true, insideOut, merging, VOLUMES);
+      success &= TestConfiguration(grid, "grid", false, false, insideOut, merging, VOLUMES);
+      success &=
+        TestConfiguration(tetrahedra, "tetrahedra", true, true, insideOut, merging, EXACT);
+      success &= TestConfiguration(surface, "surface", true, true, insideOut, merging, EXACT);
+      success &=
+        TestConfiguration(polyhedra, "polyhedra", true, false, insideOut, merging, TOPOLOGY);
+    }
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
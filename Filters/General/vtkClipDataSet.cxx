@@ -15,30 +15,93 @@
 
 #include "vtkClipDataSet.h"
 
+#include "vtkBatchMerger.h"
+#include "vtkBoundingBox.h"
 #include "vtkCallbackCommand.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkCellTypes.h"
 #include "vtkClipVolume.h"
 #include "vtkExecutive.h"
 #include "vtkFloatArray.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkImplicitFunction.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMemoryArena.h"
 #include "vtkMergePoints.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyhedron.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <vector>
+
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkClipDataSet);
 vtkCxxSetObjectMacro(vtkClipDataSet, ClipFunction, vtkImplicitFunction);
 
+//------------------------------------------------------------------------------
+namespace
+{
+// Number of input cells clipped together by ClipCellsSMP().
+const vtkIdType CellsPerBatch = 1024;
+
+// The output of a batch of cells, clipped with its own locator. Index 0 is
+// the output, index 1 the clipped output. Each output cell records its type
+// and the input cell it comes from.
+struct ClipBatch
+{
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkPointData> PointData;
+  vtkSmartPointer<vtkCellArray> Cells[2];
+  std::vector<unsigned char> Types[2];
+  std::vector<vtkIdType> CellIds[2];
+};
+
+// Per-thread temporaries of ClipCellsSMP().
+struct ClipLocal
+{
+  vtkSmartPointer<vtkGenericCell> Cell;
+  vtkSmartPointer<vtkFloatArray> CellScalars;
+  vtkSmartPointer<vtkIdList> PointIds;
+  vtkSmartPointer<vtkIncrementalPointLocator> Locator;
+  // Empty cell data: the cell data is copied once all the batches are merged.
+  vtkSmartPointer<vtkCellData> InCD;
+  vtkSmartPointer<vtkCellData> OutCD;
+  std::vector<vtkIdType> Vertices;
+};
+
+// Type of the cells generated by clipping a cell.
+int GetClippedCellType(vtkCell* cell, vtkIdType npts)
+{
+  if (cell->GetCellType() == VTK_POLYHEDRON)
+  {
+    return VTK_POLYHEDRON;
+  }
+  switch (cell->GetCellDimension())
+  {
+    case 0: // points are generated
+      return npts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
+    case 1: // lines are generated
+      return npts > 2 ? VTK_POLY_LINE : VTK_LINE;
+    case 2: // polygons are generated
+      return npts == 3 ? VTK_TRIANGLE : (npts == 4 ? VTK_QUAD : VTK_POLYGON);
+    default: // tetrahedra or wedges are generated
+      return npts == 4 ? VTK_TETRA : VTK_WEDGE;
+  }
+}
+}
+
 //------------------------------------------------------------------------------
 // Construct with user-specified implicit function; InsideOut turned off; value
 // set to 0.0; and generate clip scalars turned off.
@@ -51,6 +114,7 @@ vtkClipDataSet::vtkClipDataSet(vtkImplicitFunction* cf)
   this->UseValueAsOffset = true;
   this->GenerateClipScalars = 0;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->EnableSMP = false;
 
   this->GenerateClippedOutput = 0;
   this->MergeTolerance = 0.01;
@@ -227,63 +291,11 @@ int vtkClipDataSet::RequestData(vtkInformation* vtkNotUsed(request),
     return this->ClipPoints(input, output, inputVector);
   }
 
-  // allocate the output and associated helper classes
-  estimatedSize = numCells;
-  estimatedSize = estimatedSize / 1024 * 1024; // multiple of 1024
-  if (estimatedSize < 1024)
-  {
-    estimatedSize = 1024;
-  }
-  cellScalars = vtkFloatArray::New();
-  cellScalars->Allocate(VTK_CELL_SIZE);
-  vtkCellArray* conn[2];
-  conn[0] = conn[1] = nullptr;
-  conn[0] = vtkCellArray::New();
-  conn[0]->AllocateEstimate(estimatedSize, 1);
-  conn[0]->InitTraversal();
-  types[0] = vtkUnsignedCharArray::New();
-  types[0]->Allocate(estimatedSize, estimatedSize / 2);
-  if (this->GenerateClippedOutput)
-  {
-    numOutputs = 2;
-    conn[1] = vtkCellArray::New();
-    conn[1]->AllocateEstimate(estimatedSize, 1);
-    conn[1]->InitTraversal();
-    types[1] = vtkUnsignedCharArray::New();
-    types[1]->Allocate(estimatedSize, estimatedSize / 2);
-  }
-  newPoints = vtkPoints::New();
-
-  // set precision for the points in the output
-  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    vtkPointSet* inputPointSet = vtkPointSet::SafeDownCast(input);
-    if (inputPointSet)
-    {
-      newPoints->SetDataType(inputPointSet->GetPoints()->GetDataType());
-    }
-    else
-    {
-      newPoints->SetDataType(VTK_FLOAT);
-    }
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPoints->SetDataType(VTK_FLOAT);
-  }
-  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPoints->SetDataType(VTK_DOUBLE);
-  }
-
-  newPoints->Allocate(numPts, numPts / 2);
-
   // locator used to merge potentially duplicate points
   if (this->Locator == nullptr)
   {
     this->CreateDefaultLocator();
   }
-  this->Locator->InitPointInsertion(newPoints, input->GetBounds());
 
   // Determine whether we're clipping with input scalars or a clip function
   // and do necessary setup.
@@ -311,19 +323,6 @@ int vtkClipDataSet::RequestData(vtkInformation* vtkNotUsed(request),
     clipScalars = this->GetInputArrayToProcess(0, inputVector);
     if (!clipScalars)
     {
-      for (i = 0; i < 2; i++)
-      {
-        if (conn[i])
-        {
-          conn[i]->Delete();
-        }
-        if (types[i])
-        {
-          types[i]->Delete();
-        }
-      }
-      cellScalars->Delete();
-      newPoints->Delete();
       // When processing composite datasets with partial arrays, this warning is
       // not applicable, hence disabling it.
       // vtkErrorMacro(<<"Cannot clip without clip function or input scalars");
@@ -331,6 +330,66 @@ int vtkClipDataSet::RequestData(vtkInformation* vtkNotUsed(request),
     }
   }
 
+  // set precision for the points in the output
+  int pointsType = VTK_FLOAT;
+  if (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    vtkPointSet* inputPointSet = vtkPointSet::SafeDownCast(input);
+    if (inputPointSet)
+    {
+      pointsType = inputPointSet->GetPoints()->GetDataType();
+    }
+  }
+  else if (this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    pointsType = VTK_DOUBLE;
+  }
+
+  // The threaded implementation merges points like vtkMergePoints, or not at all.
+  if (this->EnableSMP &&
+    (this->Locator->IsA("vtkMergePoints") || this->Locator->IsA("vtkNonMergingPointLocator")))
+  {
+    this->ClipCellsSMP(input, inPD, clipScalars,
+      this->UseValueAsOffset || !this->ClipFunction ? this->Value : 0.0, pointsType, output,
+      clippedOutput);
+    if (this->ClipFunction)
+    {
+      clipScalars->Delete();
+      inPD->Delete();
+    }
+    return 1;
+  }
+
+  // allocate the output and associated helper classes
+  estimatedSize = numCells;
+  estimatedSize = estimatedSize / 1024 * 1024; // multiple of 1024
+  if (estimatedSize < 1024)
+  {
+    estimatedSize = 1024;
+  }
+  cellScalars = vtkFloatArray::New();
+  cellScalars->Allocate(VTK_CELL_SIZE);
+  vtkCellArray* conn[2];
+  conn[0] = conn[1] = nullptr;
+  conn[0] = vtkCellArray::New();
+  conn[0]->AllocateEstimate(estimatedSize, 1);
+  conn[0]->InitTraversal();
+  types[0] = vtkUnsignedCharArray::New();
+  types[0]->Allocate(estimatedSize, estimatedSize / 2);
+  if (this->GenerateClippedOutput)
+  {
+    numOutputs = 2;
+    conn[1] = vtkCellArray::New();
+    conn[1]->AllocateEstimate(estimatedSize, 1);
+    conn[1]->InitTraversal();
+    types[1] = vtkUnsignedCharArray::New();
+    types[1]->Allocate(estimatedSize, estimatedSize / 2);
+  }
+  newPoints = vtkPoints::New();
+  newPoints->SetDataType(pointsType);
+  newPoints->Allocate(numPts, numPts / 2);
+  this->Locator->InitPointInsertion(newPoints, input->GetBounds());
+
   // Refer to BUG #8494 and BUG #11016. I cannot see any reason why one would
   // want to turn CopyScalars Off. My understanding is that this was done to
   // avoid copying of "ClipDataSetScalars" to the output when
@@ -479,6 +538,195 @@ int vtkClipDataSet::RequestData(vtkInformation* vtkNotUsed(request),
   return 1;
 }
 
+//------------------------------------------------------------------------------
+// The cells are split in batches of consecutive cells, clipped concurrently,
+// each with its own locator. The points of the batches are then merged,
+// keeping the first of the coincident points, and numbered in their order of
+// first insertion, like in the serial implementation.
+void vtkClipDataSet::ClipCellsSMP(vtkDataSet* input, vtkPointData* inPD,
+  vtkDataArray* clipScalars, double value, int pointsType, vtkUnstructuredGrid* output,
+  vtkUnstructuredGrid* clippedOutput)
+{
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const int numOutputs = this->GenerateClippedOutput ? 2 : 1;
+  const bool mergePoints = !this->Locator->IsA("vtkNonMergingPointLocator");
+  const vtkTypeBool insideOut = this->InsideOut;
+  vtkCellData* inCD = input->GetCellData();
+  const vtkIdType numBatches = (numCells + CellsPerBatch - 1) / CellsPerBatch;
+  std::vector<ClipBatch> batches(numBatches);
+
+  // Build the cells of the input before threading.
+  {
+    vtkNew<vtkGenericCell> cell;
+    input->GetCell(0, cell);
+  }
+
+  vtkSMPThreadLocal<ClipLocal> threadLocals;
+  vtkIncrementalPointLocator* locator = this->Locator;
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end) {
+    ClipLocal& local = threadLocals.Local();
+    if (!local.CellScalars)
+    {
+      local.CellScalars = vtkSmartPointer<vtkFloatArray>::New();
+      local.PointIds = vtkSmartPointer<vtkIdList>::New();
+      local.PointIds->SetArena(vtkMemoryArena::GetThreadLocalArena());
+      local.Locator = vtk::TakeSmartPointer(locator->NewInstance());
+      local.InCD = vtkSmartPointer<vtkCellData>::New();
+      local.OutCD = vtkSmartPointer<vtkCellData>::New();
+    }
+    for (vtkIdType batchId = begin; batchId < end; ++batchId)
+    {
+      const vtkIdType firstCell = batchId * CellsPerBatch;
+      const vtkIdType lastCell = std::min(firstCell + CellsPerBatch, numCells);
+
+      // The point ids of the cells of the batch are allocated from the arena
+      // of the thread, and released at once when the batch is done.
+      vtkMemoryArena::Scope scope;
+
+      // The ordered triangulator of the cell caches the tetrahedralizations
+      // of hexahedra, and outputs the cached ones in another order. A new
+      // cell per batch keeps the output independent of the scheduling.
+      local.Cell = vtkSmartPointer<vtkGenericCell>::New();
+      local.Cell->SetArena(scope.GetArena());
+
+      // The 3D cells triangulated by vtkCell3D::Clip() choose their
+      // tetrahedra from the order of the ids of their points in the output.
+      // So that neighbor cells of different batches agree, these points are
+      // inserted first, ordered by input id.
+      vtkBoundingBox bounds;
+      vtkIdType estimatedSize = 0;
+      local.Vertices.clear();
+      for (vtkIdType cellId = firstCell; cellId < lastCell; ++cellId)
+      {
+        input->GetCellPoints(cellId, local.PointIds);
+        const vtkIdType numCellPts = local.PointIds->GetNumberOfIds();
+        bool kept = numOutputs == 2;
+        for (vtkIdType i = 0; i < numCellPts; ++i)
+        {
+          const vtkIdType ptId = local.PointIds->GetId(i);
+          double x[3];
+          input->GetPoint(ptId, x);
+          bounds.AddPoint(x);
+          const double s = static_cast<float>(clipScalars->GetComponent(ptId, 0));
+          kept |= (s >= value) != (insideOut != 0);
+        }
+        estimatedSize += numCellPts;
+        const int cellType = input->GetCellType(cellId);
+        if (mergePoints && kept && cellType != VTK_TETRA && cellType != VTK_POLYHEDRON &&
+          vtkCellTypes::GetDimension(static_cast<unsigned char>(cellType)) == 3)
+        {
+          local.Vertices.insert(
+            local.Vertices.end(), local.PointIds->begin(), local.PointIds->end());
+        }
+      }
+
+      ClipBatch& batch = batches[batchId];
+      batch.Points = vtkSmartPointer<vtkPoints>::New();
+      batch.Points->SetDataType(pointsType);
+      batch.Points->Allocate(estimatedSize);
+      batch.PointData = vtkSmartPointer<vtkPointData>::New();
+      batch.PointData->InterpolateAllocate(inPD, estimatedSize);
+      for (int i = 0; i < numOutputs; ++i)
+      {
+        batch.Cells[i] = vtkSmartPointer<vtkCellArray>::New();
+      }
+      double batchBounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+      if (bounds.IsValid())
+      {
+        bounds.Inflate();
+        bounds.GetBounds(batchBounds);
+      }
+      local.Locator->InitPointInsertion(batch.Points, batchBounds, estimatedSize);
+      std::sort(local.Vertices.begin(), local.Vertices.end());
+      local.Vertices.erase(
+        std::unique(local.Vertices.begin(), local.Vertices.end()), local.Vertices.end());
+      for (vtkIdType ptId : local.Vertices)
+      {
+        double x[3];
+        input->GetPoint(ptId, x);
+        vtkIdType id;
+        if (local.Locator->InsertUniquePoint(x, id))
+        {
+          batch.PointData->CopyData(inPD, ptId, id);
+        }
+      }
+
+      for (vtkIdType cellId = firstCell; cellId < lastCell; ++cellId)
+      {
+        input->GetCell(cellId, local.Cell);
+        vtkIdList* cellIds = local.Cell->GetPointIds();
+        const vtkIdType npts = local.Cell->GetPoints()->GetNumberOfPoints();
+        local.CellScalars->SetNumberOfTuples(npts);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          local.CellScalars->SetValue(
+            i, static_cast<float>(clipScalars->GetComponent(cellIds->GetId(i), 0)));
+        }
+
+        for (int i = 0; i < numOutputs; ++i)
+        {
+          vtkCellArray* cells = batch.Cells[i];
+          const vtkIdType numPrevious = cells->GetNumberOfCells();
+          local.Cell->Clip(value, local.CellScalars, local.Locator, cells, inPD, batch.PointData,
+            local.InCD, cellId, local.OutCD, i == 0 ? insideOut : !insideOut);
+          for (vtkIdType newCellId = numPrevious; newCellId < cells->GetNumberOfCells();
+               ++newCellId)
+          {
+            batch.Types[i].push_back(static_cast<unsigned char>(
+              GetClippedCellType(local.Cell, cells->GetCellSize(newCellId))));
+            batch.CellIds[i].push_back(cellId);
+          }
+        }
+      }
+      local.Locator->Initialize();
+    }
+  });
+  this->UpdateProgress(0.8);
+
+  // Merge the points of the batches, then their cells with their types, each
+  // cell taking the cell data of the input cell it comes from.
+  std::vector<vtkPoints*> batchPoints;
+  std::vector<vtkPointData*> batchPD;
+  for (const ClipBatch& batch : batches)
+  {
+    batchPoints.push_back(batch.Points);
+    batchPD.push_back(batch.PointData);
+  }
+  vtkBatchMerger merger;
+  vtkNew<vtkPoints> newPoints;
+  newPoints->SetDataType(pointsType);
+  merger.MergePoints(batchPoints, batchPD, inPD, mergePoints, newPoints, output->GetPointData());
+
+  vtkUnstructuredGrid* outputs[2] = { output, clippedOutput };
+  for (int i = 0; i < numOutputs; ++i)
+  {
+    std::vector<vtkCellArray*> batchCells;
+    std::vector<const unsigned char*> batchTypes;
+    std::vector<const std::vector<vtkIdType>*> sourceCells;
+    for (const ClipBatch& batch : batches)
+    {
+      batchCells.push_back(batch.Cells[i]);
+      batchTypes.push_back(batch.Types[i].data());
+      sourceCells.push_back(&batch.CellIds[i]);
+    }
+    vtkSmartPointer<vtkCellArray> newCells = merger.MergeCells(batchCells, batchTypes);
+
+    vtkNew<vtkUnsignedCharArray> types;
+    types->SetNumberOfValues(newCells->GetNumberOfCells());
+    unsigned char* type = types->GetPointer(0);
+    for (const ClipBatch& batch : batches)
+    {
+      type = std::copy(batch.Types[i].begin(), batch.Types[i].end(), type);
+    }
+
+    vtkUnstructuredGrid* outGrid = outputs[i];
+    outGrid->SetPoints(newPoints);
+    outGrid->SetCells(types, newCells);
+    vtkBatchMerger::CopyCellData(sourceCells, inCD, outGrid->GetCellData());
+  }
+  output->Squeeze();
+}
+
 //------------------------------------------------------------------------------
 int vtkClipDataSet::ClipPoints(
   vtkDataSet* input, vtkUnstructuredGrid* output, vtkInformationVector** inputVector)
@@ -681,5 +929,6 @@ void vtkClipDataSet::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "UseValueAsOffset: " << (this->UseValueAsOffset ? "On\n" : "Off\n");
 
   os << indent << "Precision of the output points: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Enable SMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 VTK_ABI_NAMESPACE_END
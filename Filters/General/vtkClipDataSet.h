@@ -47,6 +47,20 @@
  * second output is the part of the cell that is clipped away. Set the
  * GenerateClippedData boolean on if you wish to access this output data.
  *
+ * When EnableSMP is on, the cells of datasets other than 3D images are
+ * clipped using vtkSMPTools. The cells are clipped in batches, each with its
+ * own point locator and output, and the batches are merged in the order of
+ * the cells: coincident points are merged like vtkMergePoints does, keeping
+ * the first of them. The output does not depend on the number of threads.
+ * It is the same as the serial one for tetrahedra and for 2D, 1D and 0D cells.
+ * When points are merged, other 3D cells are tetrahedralized following the
+ * ids of their input points rather than the order in which the output points
+ * are created, so the output describes the same clipped region with other
+ * tetrahedra, and the faces of the pieces of clipped polyhedra may be ordered
+ * differently. When they are not, the tetrahedra of clipped hexahedra may be
+ * output in another order. The threaded implementation is only used with a
+ * vtkMergePoints (the default) or a vtkNonMergingPointLocator.
+ *
  * @warning
  * vtkClipDataSet will triangulate all types of 3D cells (i.e., create
  * tetrahedra). This is true even if the cell is not actually cut. This
@@ -65,8 +79,10 @@
 
 VTK_ABI_NAMESPACE_BEGIN
 class vtkCallbackCommand;
+class vtkDataArray;
 class vtkImplicitFunction;
 class vtkIncrementalPointLocator;
+class vtkPointData;
 
 class VTKFILTERSGENERAL_EXPORT vtkClipDataSet : public vtkUnstructuredGridAlgorithm
 {
@@ -194,6 +210,22 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded clipping of datasets other than 3D images.
+   * The output does not depend on the number of threads, and the pieces of
+   * the cells follow the order of the input cells. Tetrahedra and lower
+   * dimensional cells are clipped exactly as serially, while the other 3D
+   * cells may be split into other tetrahedra covering the same region, or
+   * output in another order. Other locators than vtkMergePoints
+   * and vtkNonMergingPointLocator fall back to the serial implementation.
+   * Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
 protected:
   vtkClipDataSet(vtkImplicitFunction* cf = nullptr);
   ~vtkClipDataSet() override;
@@ -222,8 +254,17 @@ protected:
   int ClipPoints(
     vtkDataSet* input, vtkUnstructuredGrid* output, vtkInformationVector** inputVector);
 
+  /**
+   * Threaded implementation of the clipping of the cells, used by
+   * RequestData() when EnableSMP is on.
+   */
+  void ClipCellsSMP(vtkDataSet* input, vtkPointData* inPD, vtkDataArray* clipScalars,
+    double value, int pointsType, vtkUnstructuredGrid* output,
+    vtkUnstructuredGrid* clippedOutput);
+
   bool UseValueAsOffset;
   int OutputPointsPrecision;
+  bool EnableSMP;
 
 private:
   vtkClipDataSet(const vtkClipDataSet&) = delete;
@@ -56,6 +56,7 @@
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <functional>
 #include <vector>
 
 // NOLINTNEXTLINE(bugprone-suspicious-include)
@@ -414,14 +415,24 @@ struct EvaluatePointsWithImplicitFunction
   void Reduce()
   {
     // Prefix sum to create point map of kept (i.e., retained) points.
-    this->NumberOfKeptPoints = 0;
-    for (auto& pointId : vtk::DataArrayValueRange<1>(this->PointsMap))
-    {
-      if (pointId > 0)
+    auto pointsMap = vtk::DataArrayValueRange<1>(this->PointsMap);
+    this->NumberOfKeptPoints = vtkSMPTools::TransformExclusiveScan(pointsMap.begin(),
+      pointsMap.end(), pointsMap.begin(), TInputIdType(0), std::plus<TInputIdType>(),
+      [](TInputIdType pointId) { return pointId > 0 ? TInputIdType(1) : TInputIdType(0); });
+
+    // The scan overwrote the kept flags, mark the discarded points again.
+    const auto& values = vtk::DataArrayValueRange<1>(this->ClipArray);
+    const double isoValue = this->IsoValue;
+    const bool insideOut = this->InsideOut;
+    vtkSMPTools::For(0, pointsMap.size(), [&](vtkIdType beginPointId, vtkIdType endPointId) {
+      for (vtkIdType pointId = beginPointId; pointId < endPointId; ++pointId)
       {
-        pointId = this->NumberOfKeptPoints++;
+        if ((values[pointId] - isoValue >= 0.0) == insideOut)
+        {
+          pointsMap[pointId] = -1;
+        }
       }
-    }
+    });
   }
 };
 
@@ -479,14 +490,24 @@ struct EvaluatePointsWithScalarArray
   void Reduce()
   {
     // Prefix sum to create point map of kept (i.e., retained) points.
-    this->NumberOfKeptPoints = 0;
-    for (auto& pointId : vtk::DataArrayValueRange<1>(this->PointsMap))
-    {
-      if (pointId > 0)
+    auto pointsMap = vtk::DataArrayValueRange<1>(this->PointsMap);
+    this->NumberOfKeptPoints = vtkSMPTools::TransformExclusiveScan(pointsMap.begin(),
+      pointsMap.end(), pointsMap.begin(), TInputIdType(0), std::plus<TInputIdType>(),
+      [](TInputIdType pointId) { return pointId > 0 ? TInputIdType(1) : TInputIdType(0); });
+
+    // The scan overwrote the kept flags, mark the discarded points again.
+    const auto& values = vtk::DataArrayValueRange<1>(this->Scalars);
+    const double isoValue = this->IsoValue;
+    const bool insideOut = this->InsideOut;
+    vtkSMPTools::For(0, pointsMap.size(), [&](vtkIdType beginPointId, vtkIdType endPointId) {
+      for (vtkIdType pointId = beginPointId; pointId < endPointId; ++pointId)
       {
-        pointId = this->NumberOfKeptPoints++;
+        if ((values[pointId] - isoValue >= 0.0) == insideOut)
+        {
+          pointsMap[pointId] = -1;
+        }
       }
-    }
+    });
   }
 };
 
@@ -0,0 +1,499 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compare the threaded and the serial implementations of
+// vtkDataSetSurfaceFilter on unstructured grids.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCellType.h>
+#include <vtkCellTypeSource.h>
+#include <vtkDataArray.h>
+#include <vtkDataSetAttributes.h>
+#include <vtkDataSetSurfaceFilter.h>
+#include <vtkDoubleArray.h>
+#include <vtkFieldData.h>
+#include <vtkIdList.h>
+#include <vtkIntArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolygon.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <map>
+
+namespace
+{
+const int Resolution = 8;
+
+// Update a serial and a threaded filter, both set up by configure.
+template <typename TFilter, typename TConfigure>
+std::array<vtkSmartPointer<TFilter>, 2> UpdateSerialAndThreaded(TConfigure&& configure)
+{
+  std::array<vtkSmartPointer<TFilter>, 2> filters = { { vtkSmartPointer<TFilter>::New(),
+    vtkSmartPointer<TFilter>::New() } };
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    configure(filter.Get());
+  }
+  filters[1]->EnableSMPOn();
+  for (const vtkSmartPointer<TFilter>& filter : filters)
+  {
+    filter->Update();
+  }
+  return filters;
+}
+
+bool SameTuples(vtkDataArray* a, vtkIdType aId, vtkDataArray* b, vtkIdType bId)
+{
+  for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+  {
+    if (a->GetComponent(aId, c) != b->GetComponent(bId, c))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameArrays(vtkDataArray* a, vtkDataArray* b)
+{
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+    a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+  {
+    if (!SameTuples(a, t, b, t))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compare the cells of two cell arrays, in order.
+bool SameCells(vtkCellArray* a, vtkCellArray* b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> aIds;
+  vtkNew<vtkIdList> bIds;
+  for (vtkIdType c = 0; c < a->GetNumberOfCells(); ++c)
+  {
+    a->GetCellAtId(c, aIds);
+    b->GetCellAtId(c, bIds);
+    if (aIds->GetNumberOfIds() != bIds->GetNumberOfIds() ||
+      !std::equal(aIds->begin(), aIds->end(), bIds->begin()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Named arrays are matched by name, unnamed ones by index.
+bool SameData(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    const char* name = a->GetArrayName(i);
+    vtkDataArray* bArray = name ? b->GetArray(name) : b->GetArray(i);
+    if (!bArray || (!name && b->GetArrayName(i)) || !SameArrays(a->GetArray(i), bArray))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SamePolyData(vtkPolyData* a, vtkPolyData* b)
+{
+  return a->GetNumberOfPoints() == b->GetNumberOfPoints() &&
+    (a->GetNumberOfPoints() == 0 ||
+      SameArrays(a->GetPoints()->GetData(), b->GetPoints()->GetData())) &&
+    SameCells(a->GetVerts(), b->GetVerts()) && SameCells(a->GetLines(), b->GetLines()) &&
+    SameCells(a->GetPolys(), b->GetPolys()) && SameCells(a->GetStrips(), b->GetStrips()) &&
+    SameData(a->GetPointData(), b->GetPointData()) && SameData(a->GetCellData(), b->GetCellData());
+}
+
+// Points of a grid of Resolution^3 cubes, numbered along x first.
+vtkIdType PointId(int i, int j, int k)
+{
+  return (static_cast<vtkIdType>(k) * (Resolution + 1) + j) * (Resolution + 1) + i;
+}
+
+void InsertGridPoints(vtkPoints* points, double spacing)
+{
+  for (int k = 0; k <= Resolution; ++k)
+  {
+    for (int j = 0; j <= Resolution; ++j)
+    {
+      for (int i = 0; i <= Resolution; ++i)
+      {
+        points->InsertNextPoint(i * spacing, j * spacing, k * spacing);
+      }
+    }
+  }
+}
+
+// The points of cube (i, j, k), in the order of the points of a hexahedron.
+void GetCubePointIds(int i, int j, int k, vtkIdType p[8])
+{
+  p[0] = PointId(i, j, k);
+  p[1] = PointId(i + 1, j, k);
+  p[2] = PointId(i + 1, j + 1, k);
+  p[3] = PointId(i, j + 1, k);
+  p[4] = PointId(i, j, k + 1);
+  p[5] = PointId(i + 1, j, k + 1);
+  p[6] = PointId(i + 1, j + 1, k + 1);
+  p[7] = PointId(i, j + 1, k + 1);
+}
+
+// Insert the cube of points p as a hexahedron, five tetrahedra, two wedges, a
+// voxel or a polyhedron.
+void InsertCube(vtkUnstructuredGrid* grid, const vtkIdType p[8], int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+    {
+      const vtkIdType tetras[5][4] = { { p[0], p[1], p[3], p[4] }, { p[1], p[2], p[3], p[6] },
+        { p[1], p[4], p[5], p[6] }, { p[3], p[4], p[6], p[7] }, { p[1], p[3], p[4], p[6] } };
+      for (const vtkIdType* tetra : tetras)
+      {
+        grid->InsertNextCell(VTK_TETRA, 4, tetra);
+      }
+      break;
+    }
+    case VTK_WEDGE:
+    {
+      const vtkIdType wedges[2][6] = { { p[0], p[1], p[3], p[4], p[5], p[7] },
+        { p[1], p[2], p[3], p[5], p[6], p[7] } };
+      for (const vtkIdType* wedge : wedges)
+      {
+        grid->InsertNextCell(VTK_WEDGE, 6, wedge);
+      }
+      break;
+    }
+    case VTK_VOXEL:
+    {
+      const vtkIdType voxel[8] = { p[0], p[1], p[3], p[2], p[4], p[5], p[7], p[6] };
+      grid->InsertNextCell(VTK_VOXEL, 8, voxel);
+      break;
+    }
+    case VTK_POLYHEDRON:
+    {
+      const vtkIdType faces[30] = { 4, p[0], p[3], p[2], p[1], 4, p[4], p[5], p[6], p[7], 4, p[0],
+        p[1], p[5], p[4], 4, p[1], p[2], p[6], p[5], 4, p[2], p[3], p[7], p[6], 4, p[3], p[0], p[4],
+        p[7] };
+      grid->InsertNextCell(VTK_POLYHEDRON, 8, p, 6, faces);
+      break;
+    }
+    default:
+      grid->InsertNextCell(VTK_HEXAHEDRON, 8, p);
+  }
+}
+
+// The "CellIds" array matches the output cells with their input cell.
+void AddCellIds(vtkDataSet* dataSet)
+{
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType cellId = 0; cellId < dataSet->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->InsertNextValue(static_cast<int>(cellId));
+  }
+  dataSet->GetCellData()->AddArray(cellIds);
+}
+
+void AddPointScalars(vtkDataSet* dataSet)
+{
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("PointScalars");
+  for (vtkIdType ptId = 0; ptId < dataSet->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    dataSet->GetPoint(ptId, x);
+    pointScalars->InsertNextValue(x[0] + 2.0 * x[1] + 3.0 * x[2]);
+  }
+  dataSet->GetPointData()->SetScalars(pointScalars);
+}
+
+std::ostream& ReportDifference(vtkDataSet* expected, vtkDataSet* output)
+{
+  return std::cerr << "Threaded output of " << output->GetNumberOfPoints() << " points and "
+                   << output->GetNumberOfCells() << " cells instead of "
+                   << expected->GetNumberOfPoints() << " and " << expected->GetNumberOfCells()
+                   << " differs";
+}
+
+// Append the cells of a grid of a given type, shifted along x.
+void AppendCells(vtkUnstructuredGrid* grid, int cellType, int order, double shift)
+{
+  vtkNew<vtkCellTypeSource> source;
+  source->SetCellType(cellType);
+  source->SetCellOrder(order);
+  source->SetBlocksDimensions(4, 4, 4);
+  source->Update();
+  vtkUnstructuredGrid* cells = source->GetOutput();
+
+  const vtkIdType offset = grid->GetNumberOfPoints();
+  for (vtkIdType ptId = 0; ptId < cells->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3];
+    cells->GetPoint(ptId, x);
+    x[0] += shift;
+    grid->GetPoints()->InsertNextPoint(x);
+  }
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < cells->GetNumberOfCells(); ++cellId)
+  {
+    cells->GetCellPoints(cellId, ptIds);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      ptIds->SetId(i, ptIds->GetId(i) + offset);
+    }
+    grid->InsertNextCell(cells->GetCellType(cellId), ptIds);
+  }
+}
+
+// Point scalars, and cell ids to match the output cells with.
+void AddData(vtkUnstructuredGrid* grid)
+{
+  AddPointScalars(grid);
+  AddCellIds(grid);
+}
+
+// A block of hexahedra, voxels, tetrahedra, wedges, pyramids and polyhedra,
+// with 2D, 1D and 0D cells, blocks of prisms, and hidden cells and points.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructLinearGrid()
+{
+  vtkNew<vtkPoints> points;
+  InsertGridPoints(points, 1.0);
+
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  grid->SetPoints(points);
+  grid->Allocate();
+  const int cellTypes[6] = { VTK_HEXAHEDRON, VTK_TETRA, VTK_WEDGE, VTK_VOXEL, VTK_PYRAMID,
+    VTK_POLYHEDRON };
+  for (int k = 0; k < Resolution; ++k)
+  {
+    for (int j = 0; j < Resolution; ++j)
+    {
+      for (int i = 0; i < Resolution; ++i)
+      {
+        vtkIdType p[8];
+        GetCubePointIds(i, j, k, p);
+        const int cellType = cellTypes[(i + j + k) % 6];
+        if (cellType == VTK_PYRAMID)
+        {
+          const vtkIdType center = points->InsertNextPoint(i + 0.5, j + 0.5, k + 0.5);
+          const vtkIdType pyramids[6][5] = { { p[0], p[3], p[2], p[1], center },
+            { p[4], p[5], p[6], p[7], center }, { p[0], p[1], p[5], p[4], center },
+            { p[1], p[2], p[6], p[5], center }, { p[2], p[3], p[7], p[6], center },
+            { p[3], p[0], p[4], p[7], center } };
+          for (const vtkIdType* pyramid : pyramids)
+          {
+            grid->InsertNextCell(VTK_PYRAMID, 5, pyramid);
+          }
+        }
+        else
+        {
+          InsertCube(grid, p, cellType);
+        }
+        if (k == 0 && (i + j) % 2 == 0)
+        {
+          grid->InsertNextCell(VTK_QUAD, 4, p);
+        }
+        else if (k == 0)
+        {
+          const vtkIdType pixel[4] = { p[0], p[1], p[3], p[2] };
+          grid->InsertNextCell(VTK_PIXEL, 4, pixel);
+        }
+        if (k == 0 && j == 0)
+        {
+          grid->InsertNextCell(VTK_LINE, 2, p);
+          grid->InsertNextCell(VTK_VERTEX, 1, p + 6);
+        }
+      }
+    }
+  }
+  const vtkIdType strip[6] = { PointId(0, 0, Resolution), PointId(0, 1, Resolution),
+    PointId(1, 0, Resolution), PointId(1, 1, Resolution), PointId(2, 0, Resolution),
+    PointId(2, 1, Resolution) };
+  grid->InsertNextCell(VTK_TRIANGLE_STRIP, 6, strip);
+  grid->InsertNextCell(VTK_POLY_LINE, 6, strip);
+  grid->InsertNextCell(VTK_POLY_VERTEX, 3, strip);
+  const vtkIdType polygon[5] = { PointId(3, 3, Resolution), PointId(5, 3, Resolution),
+    PointId(5, 4, Resolution), PointId(4, 5, Resolution), PointId(3, 4, Resolution) };
+  grid->InsertNextCell(VTK_POLYGON, 5, polygon);
+  grid->InsertNextCell(VTK_TRIANGLE, 3, polygon);
+
+  AppendCells(grid, VTK_PENTAGONAL_PRISM, 1, -6.0);
+  AppendCells(grid, VTK_HEXAGONAL_PRISM, 1, -12.0);
+  AppendCells(grid, VTK_PYRAMID, 1, -18.0);
+
+  AddData(grid);
+  vtkUnsignedCharArray* cellGhosts = grid->AllocateCellGhostArray();
+  for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); cellId += 29)
+  {
+    cellGhosts->SetValue(cellId, vtkDataSetAttributes::HIDDENCELL);
+  }
+  vtkUnsignedCharArray* pointGhosts = grid->AllocatePointGhostArray();
+  for (vtkIdType ptId = 0; ptId < grid->GetNumberOfPoints(); ptId += 37)
+  {
+    pointGhosts->SetValue(ptId, vtkDataSetAttributes::HIDDENPOINT);
+  }
+  return grid;
+}
+
+// Blocks of nonlinear cells of several types and orders.
+vtkSmartPointer<vtkUnstructuredGrid> ConstructNonlinearGrid()
+{
+  vtkSmartPointer<vtkUnstructuredGrid> grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  grid->SetPoints(points);
+  grid->Allocate();
+  const int types[][2] = { { VTK_QUADRATIC_HEXAHEDRON, 2 }, { VTK_QUADRATIC_TETRA, 2 },
+    { VTK_QUADRATIC_WEDGE, 2 }, { VTK_LAGRANGE_HEXAHEDRON, 3 }, { VTK_LAGRANGE_TETRAHEDRON, 3 },
+    { VTK_BEZIER_HEXAHEDRON, 2 }, { VTK_HEXAHEDRON, 1 }, { VTK_QUADRATIC_QUAD, 2 },
+    { VTK_LAGRANGE_TRIANGLE, 3 }, { VTK_BEZIER_QUADRILATERAL, 2 }, { VTK_QUADRATIC_EDGE, 2 },
+    { VTK_BEZIER_CURVE, 3 } };
+  double shift = 0.0;
+  for (const int* type : types)
+  {
+    AppendCells(grid, type[0], type[1], shift);
+    shift += 6.0;
+  }
+  AddData(grid);
+  return grid;
+}
+
+// The number of vertices, the length of the lines and the area of the
+// polygons generated by each input cell.
+std::map<int, double> Measures(vtkPolyData* output)
+{
+  std::map<int, double> measures;
+  vtkDataArray* cellIds = output->GetCellData()->GetArray("CellIds");
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    double& measure = measures[static_cast<int>(cellIds->GetComponent(cellId, 0))];
+    output->GetCellPoints(cellId, ptIds);
+    const vtkIdType npts = ptIds->GetNumberOfIds();
+    switch (output->GetCell(cellId)->GetCellDimension())
+    {
+      case 0:
+        measure += npts;
+        break;
+      case 1:
+        for (vtkIdType i = 0; i + 1 < npts; ++i)
+        {
+          double x[3], y[3];
+          output->GetPoint(ptIds->GetId(i), x);
+          output->GetPoint(ptIds->GetId(i + 1), y);
+          measure += std::sqrt(vtkMath::Distance2BetweenPoints(x, y));
+        }
+        break;
+      default:
+        double normal[3];
+        measure += vtkPolygon::ComputeArea(output->GetPoints(), npts, ptIds->GetPointer(0), normal);
+    }
+  }
+  return measures;
+}
+
+bool SameMeasures(vtkPolyData* a, vtkPolyData* b)
+{
+  const std::map<int, double> aMeasures = Measures(a);
+  const std::map<int, double> bMeasures = Measures(b);
+  return aMeasures.size() == bMeasures.size() &&
+    std::equal(aMeasures.begin(), aMeasures.end(), bMeasures.begin(),
+      [](const std::pair<const int, double>& x, const std::pair<const int, double>& y) {
+        return x.first == y.first && std::abs(x.second - y.second) < 1.0e-6;
+      });
+}
+
+// The output for linear cells is the same as the serial one. The boundary
+// faces of nonlinear 3D cells are extracted differently, but they cover the
+// same surface.
+bool TestConfiguration(vtkUnstructuredGrid* input, const char* name, bool linear,
+  int subdivisionLevel, bool passThroughIds)
+{
+  auto filters = UpdateSerialAndThreaded<vtkDataSetSurfaceFilter>(
+    [&](vtkDataSetSurfaceFilter* surface) {
+      surface->SetInputData(input);
+      surface->SetNonlinearSubdivisionLevel(subdivisionLevel);
+      surface->SetPassThroughCellIds(passThroughIds);
+      surface->SetPassThroughPointIds(passThroughIds);
+    });
+  vtkPolyData* expected = filters[0]->GetOutput();
+  vtkPolyData* output = filters[1]->GetOutput();
+
+  bool same = expected->GetNumberOfCells() > 0;
+  if (same && linear)
+  {
+    same = SamePolyData(expected, output);
+  }
+  else if (same)
+  {
+    same = expected->GetNumberOfPoints() == output->GetNumberOfPoints() &&
+      expected->GetNumberOfCells() == output->GetNumberOfCells() && SameMeasures(expected, output);
+  }
+  if (!same)
+  {
+    ReportDifference(expected, output)
+      << " for the " << name << " with subdivision level " << subdivisionLevel << " and ids "
+      << passThroughIds << std::endl;
+  }
+  return same;
+}
+}
+
+int TestDataSetSurfaceFilterSMP(int, char*[])
+{
+  vtkSmartPointer<vtkUnstructuredGrid> linearGrid = ConstructLinearGrid();
+  vtkSmartPointer<vtkUnstructuredGrid> nonlinearGrid = ConstructNonlinearGrid();
+  bool success = true;
+
+  for (bool passThroughIds : { false, true })
+  {
+    success &= TestConfiguration(linearGrid, "linear grid", true, 1, passThroughIds);
+    for (int subdivisionLevel : { 0, 1 })
+    {
+      success &= TestConfiguration(
+        nonlinearGrid, "nonlinear grid", false, subdivisionLevel, passThroughIds);
+    }
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -40,6 +40,8 @@
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridGeometryFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredData.h"
@@ -57,10 +59,12 @@
 #include "vtkWedge.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <numeric>
 #include <unordered_map>
+#include <vector>
 
 namespace
 {
@@ -364,6 +368,7 @@ vtkDataSetSurfaceFilter::vtkDataSetSurfaceFilter()
   this->NonlinearSubdivisionLevel = 1;
 
   this->Delegation = false;
+  this->EnableSMP = false;
 }
 
 //------------------------------------------------------------------------------
@@ -1297,6 +1302,7 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "NonlinearSubdivisionLevel: " << this->GetNonlinearSubdivisionLevel() << endl;
   os << indent << "FastMode: " << this->GetFastMode() << endl;
   os << indent << "Delegation: " << this->GetDelegation() << endl;
+  os << indent << "EnableSMP: " << (this->EnableSMP ? "On\n" : "Off\n");
 }
 
 //========================================================================
@@ -1399,6 +1405,13 @@ int vtkDataSetSurfaceFilter::UnstructuredGridBaseExecute(
 int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(
   vtkUnstructuredGridBase* input, vtkPolyData* output, bool handleSubdivision)
 {
+  // The threaded implementation extracts the faces of nonlinear 3D cells
+  // itself, but does not subdivide nonlinear cells further.
+  if (this->EnableSMP && this->NonlinearSubdivisionLevel <= 1)
+  {
+    return this->UnstructuredGridExecuteSMP(input, output);
+  }
+
   vtkSmartPointer<vtkUnstructuredGrid> tempInput;
   if (handleSubdivision)
   {
@@ -2218,6 +2231,940 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecuteInternal(
   return 1;
 }
 
+//------------------------------------------------------------------------------
+namespace
+{
+// Number of input cells, or of boundary faces, processed together by
+// UnstructuredGridExecuteSMP().
+const vtkIdType SurfaceBatchSize = 1024;
+
+// The kinds of output cells, in the order of the output.
+enum SurfaceCellKind
+{
+  SURFACE_VERTS = 0,
+  SURFACE_LINES = 1,
+  SURFACE_POLYS = 2
+};
+
+// An output point evaluated in a cell rather than copied from the input: an
+// input point of a Bezier cell (PointId >= 0), merged with the other uses of
+// this input point, or a new point (PointId == -1). It is evaluated at
+// PCoords in the cell CellId, or in its face FaceId when FaceId >= 0.
+struct SurfacePoint
+{
+  vtkIdType PointId;
+  vtkIdType CellId;
+  int FaceId;
+  double PCoords[3];
+};
+
+// The output cells of a batch, for each kind, and the faces of its 3D cells.
+// The points of the cells are input point ids, or -1 - i for the i-th point
+// of NewPoints. A hidden cell has a source cell of -1: its points are
+// numbered like in the serial implementation, but it is not output.
+struct SurfaceBatch
+{
+  std::vector<vtkIdType> Sizes[3];
+  std::vector<vtkIdType> Points[3];
+  std::vector<vtkIdType> Sources[3];
+  std::vector<SurfacePoint> NewPoints;
+
+  // Faces of the 3D cells, with the first of their smallest point id first,
+  // as inserted in the face hash of the serial implementation. FaceIndices
+  // records the face of a nonlinear cell, -1 for the face of a linear cell.
+  std::vector<vtkIdType> FacePoints;
+  std::vector<vtkIdType> FaceSizes;
+  std::vector<vtkIdType> FaceCells;
+  std::vector<int> FaceIndices;
+
+  void InsertNextCell(int kind, vtkIdType npts, const vtkIdType* pts, vtkIdType source)
+  {
+    this->Sizes[kind].push_back(npts);
+    this->Points[kind].insert(this->Points[kind].end(), pts, pts + npts);
+    this->Sources[kind].push_back(source);
+  }
+
+  vtkIdType InsertNewPoint(
+    vtkIdType ptId, vtkIdType cellId, int faceId, const double pcoords[3])
+  {
+    SurfacePoint point;
+    point.PointId = ptId;
+    point.CellId = cellId;
+    point.FaceId = faceId;
+    std::copy(pcoords, pcoords + 3, point.PCoords);
+    this->NewPoints.push_back(point);
+    return -static_cast<vtkIdType>(this->NewPoints.size());
+  }
+
+  void InsertFace(const vtkIdType* pts, vtkIdType npts, vtkIdType cellId, int faceId)
+  {
+    this->FacePoints.insert(this->FacePoints.end(), pts, pts + npts);
+    this->FaceSizes.push_back(npts);
+    this->FaceCells.push_back(cellId);
+    this->FaceIndices.push_back(faceId);
+  }
+
+  // The same rotations as InsertQuadInHash(), InsertTriInHash() and
+  // InsertPolygonInHash().
+  void InsertQuad(
+    vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType d, vtkIdType cellId, int faceId = -1)
+  {
+    if (b < a && b < c && b < d)
+    {
+      const vtkIdType pts[4] = { b, c, d, a };
+      this->InsertFace(pts, 4, cellId, faceId);
+    }
+    else if (c < a && c < b && c < d)
+    {
+      const vtkIdType pts[4] = { c, d, a, b };
+      this->InsertFace(pts, 4, cellId, faceId);
+    }
+    else if (d < a && d < b && d < c)
+    {
+      const vtkIdType pts[4] = { d, a, b, c };
+      this->InsertFace(pts, 4, cellId, faceId);
+    }
+    else
+    {
+      const vtkIdType pts[4] = { a, b, c, d };
+      this->InsertFace(pts, 4, cellId, faceId);
+    }
+  }
+
+  void InsertTri(vtkIdType a, vtkIdType b, vtkIdType c, vtkIdType cellId, int faceId = -1)
+  {
+    if (b < a && b < c)
+    {
+      const vtkIdType pts[3] = { b, c, a };
+      this->InsertFace(pts, 3, cellId, faceId);
+    }
+    else if (c < a && c < b)
+    {
+      const vtkIdType pts[3] = { c, a, b };
+      this->InsertFace(pts, 3, cellId, faceId);
+    }
+    else
+    {
+      const vtkIdType pts[3] = { a, b, c };
+      this->InsertFace(pts, 3, cellId, faceId);
+    }
+  }
+
+  void InsertPolygon(const vtkIdType* ids, vtkIdType npts, vtkIdType cellId)
+  {
+    if (npts == 0)
+    {
+      return;
+    }
+    const vtkIdType offset = std::min_element(ids, ids + npts) - ids;
+    this->FacePoints.insert(this->FacePoints.end(), ids + offset, ids + npts);
+    this->FacePoints.insert(this->FacePoints.end(), ids, ids + offset);
+    this->FaceSizes.push_back(npts);
+    this->FaceCells.push_back(cellId);
+    this->FaceIndices.push_back(-1);
+  }
+};
+
+// Per-thread temporaries of UnstructuredGridExecuteSMP().
+struct SurfaceLocal
+{
+  vtkSmartPointer<vtkGenericCell> Cell;
+  vtkSmartPointer<vtkIdList> PointIds;
+  vtkSmartPointer<vtkIdList> Pts;
+  vtkSmartPointer<vtkPoints> Coords;
+  std::vector<vtkIdType> Ids;
+  std::vector<double> Weights;
+
+  void Initialize(int dataType)
+  {
+    if (!this->Cell)
+    {
+      this->Cell = vtkSmartPointer<vtkGenericCell>::New();
+      this->PointIds = vtkSmartPointer<vtkIdList>::New();
+      this->Pts = vtkSmartPointer<vtkIdList>::New();
+      this->Coords = vtkSmartPointer<vtkPoints>::New();
+      this->Coords->SetDataType(dataType);
+    }
+  }
+};
+
+bool HasHiddenPoint(vtkUnsignedCharArray* ghosts, vtkIdType npts, const vtkIdType* pts)
+{
+  if (ghosts)
+  {
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      if (ghosts->GetValue(pts[i]) & vtkDataSetAttributes::HIDDENPOINT)
+      {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Triangulate a nonlinear 2D cell, or a face of a nonlinear 3D cell, like the
+// serial implementation does with a subdivision level of 1. The input points
+// of Bezier cells are evaluated in the cell.
+void TriangulateNonlinearCell(vtkCell* cell, vtkIdType cellId, int faceId,
+  SurfaceLocal& local, SurfaceBatch& batch, vtkIdType source)
+{
+  cell->Triangulate(0, local.Pts, local.Coords);
+  const bool bezier =
+    cell->GetCellType() == VTK_BEZIER_QUADRILATERAL || cell->GetCellType() == VTK_BEZIER_TRIANGLE;
+  const double* pc = cell->GetParametricCoords();
+  local.Ids.resize(local.Pts->GetNumberOfIds());
+  for (vtkIdType i = 0; i < local.Pts->GetNumberOfIds(); ++i)
+  {
+    const vtkIdType ptId = local.Pts->GetId(i);
+    local.Ids[i] = ptId;
+    if (bezier)
+    {
+      vtkIdType cellPtId = 0;
+      while (cell->GetPointId(cellPtId) != ptId)
+      {
+        ++cellPtId;
+      }
+      local.Ids[i] = batch.InsertNewPoint(ptId, cellId, faceId, pc + 3 * cellPtId);
+    }
+  }
+  for (vtkIdType i = 0; i + 2 < static_cast<vtkIdType>(local.Ids.size()); i += 3)
+  {
+    batch.InsertNextCell(SURFACE_POLYS, 3, &local.Ids[i], source);
+  }
+}
+
+// The output cells and the faces of a cell, following the three passes of
+// the serial implementation over the cells.
+void ExtractCell(vtkUnstructuredGridBase* input, vtkIdType cellId, int subdivisionLevel,
+  vtkUnsignedCharArray* ghosts, vtkUnsignedCharArray* ghostCells, SurfaceLocal& local,
+  SurfaceBatch& batch)
+{
+  int cellType = input->GetCellType(cellId);
+  vtkIdType numCellPts;
+  const vtkIdType* ids;
+  if (cellType == VTK_VERTEX || cellType == VTK_POLY_VERTEX)
+  {
+    input->GetCellPoints(cellId, numCellPts, ids, local.PointIds);
+    batch.InsertNextCell(SURFACE_VERTS, numCellPts, ids, cellId);
+    return;
+  }
+  if (cellType == VTK_EMPTY_CELL ||
+    (ghostCells &&
+      (ghostCells->GetValue(cellId) & vtkDataSetAttributes::CellGhostTypes::HIDDENCELL)))
+  {
+    return;
+  }
+
+  input->GetCellPoints(cellId, numCellPts, ids, local.PointIds);
+  switch (cellType)
+  {
+    case VTK_LINE:
+    case VTK_POLY_LINE:
+      batch.InsertNextCell(SURFACE_LINES, numCellPts, ids, cellId);
+      return;
+
+    case VTK_LAGRANGE_CURVE:
+    case VTK_QUADRATIC_EDGE:
+    case VTK_CUBIC_LINE:
+      // The end points, then the other points with a subdivision level of 1.
+      local.Ids.assign(1, ids[0]);
+      if (subdivisionLevel > 0)
+      {
+        local.Ids.insert(local.Ids.end(), ids + 2, ids + numCellPts);
+      }
+      local.Ids.push_back(ids[1]);
+      batch.InsertNextCell(
+        SURFACE_LINES, static_cast<vtkIdType>(local.Ids.size()), local.Ids.data(), cellId);
+      return;
+
+    case VTK_BEZIER_CURVE:
+      if (subdivisionLevel == 0)
+      {
+        const vtkIdType line[2] = { ids[0], ids[1] };
+        batch.InsertNextCell(SURFACE_LINES, 2, line, cellId);
+      }
+      else
+      {
+        local.Ids.resize(numCellPts);
+        for (vtkIdType i = 0; i < numCellPts; ++i)
+        {
+          const double pcoords[3] = { static_cast<double>(i) / (numCellPts - 1), 0.0, 0.0 };
+          local.Ids[i] = batch.InsertNewPoint(-1, cellId, -1, pcoords);
+        }
+        batch.InsertNextCell(SURFACE_LINES, numCellPts, local.Ids.data(), cellId);
+      }
+      return;
+
+    case VTK_HEXAHEDRON:
+      batch.InsertQuad(ids[0], ids[1], ids[5], ids[4], cellId);
+      batch.InsertQuad(ids[0], ids[3], ids[2], ids[1], cellId);
+      batch.InsertQuad(ids[0], ids[4], ids[7], ids[3], cellId);
+      batch.InsertQuad(ids[1], ids[2], ids[6], ids[5], cellId);
+      batch.InsertQuad(ids[2], ids[3], ids[7], ids[6], cellId);
+      batch.InsertQuad(ids[4], ids[5], ids[6], ids[7], cellId);
+      return;
+
+    case VTK_VOXEL:
+      batch.InsertQuad(ids[0], ids[1], ids[5], ids[4], cellId);
+      batch.InsertQuad(ids[0], ids[2], ids[3], ids[1], cellId);
+      batch.InsertQuad(ids[0], ids[4], ids[6], ids[2], cellId);
+      batch.InsertQuad(ids[1], ids[3], ids[7], ids[5], cellId);
+      batch.InsertQuad(ids[2], ids[6], ids[7], ids[3], cellId);
+      batch.InsertQuad(ids[4], ids[5], ids[7], ids[6], cellId);
+      return;
+
+    case VTK_TETRA:
+      batch.InsertTri(ids[0], ids[1], ids[3], cellId);
+      batch.InsertTri(ids[0], ids[2], ids[1], cellId);
+      batch.InsertTri(ids[0], ids[3], ids[2], cellId);
+      batch.InsertTri(ids[1], ids[2], ids[3], cellId);
+      return;
+
+    case VTK_PENTAGONAL_PRISM:
+      batch.InsertQuad(ids[0], ids[1], ids[6], ids[5], cellId);
+      batch.InsertQuad(ids[1], ids[2], ids[7], ids[6], cellId);
+      batch.InsertQuad(ids[2], ids[3], ids[8], ids[7], cellId);
+      batch.InsertQuad(ids[3], ids[4], ids[9], ids[8], cellId);
+      batch.InsertQuad(ids[4], ids[0], ids[5], ids[9], cellId);
+      batch.InsertPolygon(ids, 5, cellId);
+      batch.InsertPolygon(ids + 5, 5, cellId);
+      return;
+
+    case VTK_HEXAGONAL_PRISM:
+      batch.InsertQuad(ids[0], ids[1], ids[7], ids[6], cellId);
+      batch.InsertQuad(ids[1], ids[2], ids[8], ids[7], cellId);
+      batch.InsertQuad(ids[2], ids[3], ids[9], ids[8], cellId);
+      batch.InsertQuad(ids[3], ids[4], ids[10], ids[9], cellId);
+      batch.InsertQuad(ids[4], ids[5], ids[11], ids[10], cellId);
+      batch.InsertQuad(ids[5], ids[0], ids[6], ids[11], cellId);
+      batch.InsertPolygon(ids, 6, cellId);
+      batch.InsertPolygon(ids + 6, 6, cellId);
+      return;
+
+    case VTK_PYRAMID:
+      batch.InsertQuad(ids[3], ids[2], ids[1], ids[0], cellId);
+      batch.InsertTri(ids[0], ids[1], ids[4], cellId);
+      batch.InsertTri(ids[1], ids[2], ids[4], cellId);
+      batch.InsertTri(ids[2], ids[3], ids[4], cellId);
+      batch.InsertTri(ids[3], ids[0], ids[4], cellId);
+      return;
+
+    case VTK_WEDGE:
+      batch.InsertQuad(ids[0], ids[2], ids[5], ids[3], cellId);
+      batch.InsertQuad(ids[1], ids[0], ids[3], ids[4], cellId);
+      batch.InsertQuad(ids[2], ids[1], ids[4], ids[5], cellId);
+      batch.InsertTri(ids[0], ids[1], ids[2], cellId);
+      batch.InsertTri(ids[3], ids[5], ids[4], cellId);
+      return;
+
+    default:
+      break;
+  }
+
+  // Nonlinear 2D cells are treated as linear ones without subdivision.
+  if (subdivisionLevel < 1)
+  {
+    switch (cellType)
+    {
+      case VTK_QUADRATIC_TRIANGLE:
+      case VTK_LAGRANGE_TRIANGLE:
+      case VTK_BEZIER_TRIANGLE:
+        cellType = VTK_TRIANGLE;
+        numCellPts = 3;
+        break;
+      case VTK_QUADRATIC_QUAD:
+      case VTK_BIQUADRATIC_QUAD:
+      case VTK_QUADRATIC_LINEAR_QUAD:
+      case VTK_LAGRANGE_QUADRILATERAL:
+      case VTK_BEZIER_QUADRILATERAL:
+        cellType = VTK_POLYGON;
+        numCellPts = 4;
+        break;
+    }
+  }
+
+  switch (cellType)
+  {
+    case VTK_PIXEL:
+    {
+      const vtkIdType quad[4] = { ids[0], ids[1], ids[3], ids[2] };
+      batch.InsertNextCell(SURFACE_POLYS, 4, quad, cellId);
+      return;
+    }
+    case VTK_POLYGON:
+    case VTK_TRIANGLE:
+    case VTK_QUAD:
+      batch.InsertNextCell(SURFACE_POLYS, numCellPts, ids, cellId);
+      return;
+
+    case VTK_TRIANGLE_STRIP:
+      for (vtkIdType i = 2; i < numCellPts; ++i)
+      {
+        // Every other triangle is flipped to keep the orientation of the strip.
+        const vtkIdType tri[3] = { ids[i - 2 + (i % 2)], ids[i - 1 - (i % 2)], ids[i] };
+        batch.InsertNextCell(SURFACE_POLYS, 3, tri, cellId);
+      }
+      return;
+
+    case VTK_QUADRATIC_TRIANGLE:
+    case VTK_BIQUADRATIC_TRIANGLE:
+    case VTK_QUADRATIC_QUAD:
+    case VTK_BIQUADRATIC_QUAD:
+    case VTK_QUADRATIC_LINEAR_QUAD:
+    case VTK_QUADRATIC_POLYGON:
+    case VTK_LAGRANGE_TRIANGLE:
+    case VTK_LAGRANGE_QUADRILATERAL:
+    case VTK_BEZIER_TRIANGLE:
+    case VTK_BEZIER_QUADRILATERAL:
+      if (!HasHiddenPoint(ghosts, numCellPts, ids))
+      {
+        input->GetCell(cellId, local.Cell);
+        input->SetCellOrderAndRationalWeights(cellId, local.Cell);
+        TriangulateNonlinearCell(local.Cell, cellId, -1, local, batch, cellId);
+      }
+      return;
+
+    default:
+      break;
+  }
+
+  input->GetCell(cellId, local.Cell);
+  vtkCell* cell = local.Cell;
+  if (cell->GetCellDimension() == 3)
+  {
+    const bool linear = cell->IsLinear() != 0;
+    if (!linear)
+    {
+      input->SetCellOrderAndRationalWeights(cellId, local.Cell);
+    }
+    const int numFaces = cell->GetNumberOfFaces();
+    for (int faceId = 0; faceId < numFaces; ++faceId)
+    {
+      vtkCell* face = cell->GetFace(faceId);
+      vtkIdList* facePts = face->GetPointIds();
+      // The faces of nonlinear cells are matched by their corners.
+      const vtkIdType numFacePts = linear ? facePts->GetNumberOfIds() : face->GetNumberOfEdges();
+      if (numFacePts == 4)
+      {
+        batch.InsertQuad(facePts->GetId(0), facePts->GetId(1), facePts->GetId(2),
+          facePts->GetId(3), cellId, linear ? -1 : faceId);
+      }
+      else if (numFacePts == 3)
+      {
+        batch.InsertTri(
+          facePts->GetId(0), facePts->GetId(1), facePts->GetId(2), cellId, linear ? -1 : faceId);
+      }
+      else if (linear)
+      {
+        batch.InsertPolygon(facePts->GetPointer(0), numFacePts, cellId);
+      }
+    }
+  }
+  else if (cell->GetCellDimension() == 1 && !cell->IsLinear())
+  {
+    input->SetCellOrderAndRationalWeights(cellId, local.Cell);
+    cell->Triangulate(0, local.Pts, local.Coords);
+    for (vtkIdType i = 0; i + 1 < local.Pts->GetNumberOfIds(); i += 2)
+    {
+      batch.InsertNextCell(SURFACE_LINES, 2, local.Pts->GetPointer(i), cellId);
+    }
+  }
+}
+}
+
+//------------------------------------------------------------------------------
+// The cells are processed in batches of consecutive cells. The faces of the
+// 3D cells of all the batches are then sorted to find those used only once,
+// which are output in the order of the face hash of the serial
+// implementation: by smallest point id, then in the order of the cells. The
+// output points are finally numbered in their order of first use.
+int vtkDataSetSurfaceFilter::UnstructuredGridExecuteSMP(
+  vtkUnstructuredGridBase* input, vtkPolyData* output)
+{
+  vtkUnsignedCharArray* ghosts = input->GetPointGhostArray();
+  vtkUnsignedCharArray* ghostCells = input->GetCellGhostArray();
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  const vtkIdType numCells = input->GetNumberOfCells();
+  const int subdivisionLevel = this->NonlinearSubdivisionLevel;
+  const int dataType = input->GetPoints()->GetData()->GetDataType();
+  vtkPointData* inputPD = input->GetPointData();
+  vtkCellData* inputCD = input->GetCellData();
+  vtkPointData* outputPD = output->GetPointData();
+  vtkCellData* outputCD = output->GetCellData();
+
+  // Shallow copy field data not associated with points or cells
+  output->GetFieldData()->ShallowCopy(input->GetFieldData());
+
+  // Build the cells of the input before threading.
+  vtkSMPThreadLocal<SurfaceLocal> threadLocals;
+  if (numCells > 0)
+  {
+    vtkNew<vtkGenericCell> cell;
+    input->GetCell(0, cell);
+  }
+
+  // Output cells and faces of the batches of cells.
+  const vtkIdType numBatches = (numCells + SurfaceBatchSize - 1) / SurfaceBatchSize;
+  std::vector<SurfaceBatch> batches(numBatches);
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end) {
+    SurfaceLocal& local = threadLocals.Local();
+    local.Initialize(dataType);
+    for (vtkIdType batchId = begin; batchId < end; ++batchId)
+    {
+      const vtkIdType lastCell = std::min((batchId + 1) * SurfaceBatchSize, numCells);
+      for (vtkIdType cellId = batchId * SurfaceBatchSize; cellId < lastCell; ++cellId)
+      {
+        ExtractCell(
+          input, cellId, subdivisionLevel, ghosts, ghostCells, local, batches[batchId]);
+      }
+    }
+  });
+  this->UpdateProgress(0.4);
+  if (this->CheckAbort())
+  {
+    return 1;
+  }
+
+  // Gather the faces, in the order the serial implementation inserts them.
+  std::vector<vtkIdType> faceOffsets(numBatches + 1);
+  std::vector<vtkIdType> facePointOffsets(numBatches + 1);
+  for (vtkIdType batchId = 0; batchId < numBatches; ++batchId)
+  {
+    faceOffsets[batchId] = static_cast<vtkIdType>(batches[batchId].FaceSizes.size());
+    facePointOffsets[batchId] = static_cast<vtkIdType>(batches[batchId].FacePoints.size());
+  }
+  const vtkIdType numFaces = vtkSMPTools::ExclusiveScan(
+    faceOffsets.begin(), faceOffsets.end() - 1, faceOffsets.begin(), vtkIdType(0));
+  faceOffsets[numBatches] = numFaces;
+  facePointOffsets[numBatches] = vtkSMPTools::ExclusiveScan(facePointOffsets.begin(),
+    facePointOffsets.end() - 1, facePointOffsets.begin(), vtkIdType(0));
+  std::vector<vtkIdType> facePoints(facePointOffsets[numBatches]);
+  std::vector<vtkIdType> faceStarts(numFaces + 1);
+  faceStarts[numFaces] = facePointOffsets[numBatches];
+  vtkSMPTools::For(0, numBatches, 1, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType batchId = begin; batchId < end; ++batchId)
+    {
+      SurfaceBatch& batch = batches[batchId];
+      std::copy(
+        batch.FacePoints.begin(), batch.FacePoints.end(), &facePoints[facePointOffsets[batchId]]);
+      vtkIdType start = facePointOffsets[batchId];
+      for (size_t i = 0; i < batch.FaceSizes.size(); ++i)
+      {
+        faceStarts[faceOffsets[batchId] + i] = start;
+        start += batch.FaceSizes[i];
+      }
+      std::vector<vtkIdType>().swap(batch.FacePoints);
+    }
+  });
+  auto faceSize = [&faceStarts](vtkIdType f) { return faceStarts[f + 1] - faceStarts[f]; };
+  auto faceBatch = [&faceOffsets](vtkIdType f) {
+    return (std::upper_bound(faceOffsets.begin(), faceOffsets.end(), f) - faceOffsets.begin()) -
+      1;
+  };
+
+  // Sort the faces so that the same faces follow each other: by smallest
+  // point id, size, then the other points in the direction of their smallest
+  // neighbor, which matches the faces like the face hash does.
+  auto facePoint = [&](vtkIdType f, vtkIdType i) {
+    const vtkIdType* pts = &facePoints[faceStarts[f]];
+    const vtkIdType npts = faceSize(f);
+    return i == 0 || npts < 3 || pts[1] <= pts[npts - 1] ? pts[i] : pts[npts - i];
+  };
+  auto sameFaces = [&](vtkIdType f, vtkIdType g) {
+    const vtkIdType npts = faceSize(f);
+    if (npts != faceSize(g))
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      if (facePoint(f, i) != facePoint(g, i))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+  std::vector<vtkIdType> faceOrder(numFaces);
+  std::iota(faceOrder.begin(), faceOrder.end(), 0);
+  vtkSMPTools::Sort(faceOrder.begin(), faceOrder.end(), [&](vtkIdType f, vtkIdType g) {
+    if (facePoint(f, 0) != facePoint(g, 0))
+    {
+      return facePoint(f, 0) < facePoint(g, 0);
+    }
+    const vtkIdType npts = faceSize(f);
+    if (npts != faceSize(g))
+    {
+      return npts < faceSize(g);
+    }
+    for (vtkIdType i = 1; i < npts; ++i)
+    {
+      if (facePoint(f, i) != facePoint(g, i))
+      {
+        return facePoint(f, i) < facePoint(g, i);
+      }
+    }
+    return f < g;
+  });
+
+  // The faces used once are on the boundary. They are output by smallest
+  // point id, then in insertion order.
+  std::vector<vtkIdType> boundaryFaces(numFaces);
+  vtkSMPTools::For(0, numFaces, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const bool single = (i == 0 || !sameFaces(faceOrder[i - 1], faceOrder[i])) &&
+        (i + 1 == numFaces || !sameFaces(faceOrder[i], faceOrder[i + 1]));
+      boundaryFaces[i] = single ? faceOrder[i] : -1;
+    }
+  });
+  boundaryFaces.erase(
+    std::remove(boundaryFaces.begin(), boundaryFaces.end(), vtkIdType(-1)), boundaryFaces.end());
+  std::vector<vtkIdType>().swap(faceOrder);
+  vtkSMPTools::Sort(boundaryFaces.begin(), boundaryFaces.end(), [&](vtkIdType f, vtkIdType g) {
+    const vtkIdType a = facePoints[faceStarts[f]];
+    const vtkIdType b = facePoints[faceStarts[g]];
+    return a < b || (a == b && f < g);
+  });
+
+  // Output cells of the boundary faces, in batches.
+  const vtkIdType numBoundaryFaces = static_cast<vtkIdType>(boundaryFaces.size());
+  const vtkIdType numFaceBatches = (numBoundaryFaces + SurfaceBatchSize - 1) / SurfaceBatchSize;
+  std::vector<SurfaceBatch> faceBatches(numFaceBatches);
+  vtkSMPTools::For(0, numFaceBatches, 1, [&](vtkIdType begin, vtkIdType end) {
+    SurfaceLocal& local = threadLocals.Local();
+    local.Initialize(dataType);
+    for (vtkIdType batchId = begin; batchId < end; ++batchId)
+    {
+      SurfaceBatch& batch = faceBatches[batchId];
+      const vtkIdType last = std::min((batchId + 1) * SurfaceBatchSize, numBoundaryFaces);
+      for (vtkIdType i = batchId * SurfaceBatchSize; i < last; ++i)
+      {
+        const vtkIdType f = boundaryFaces[i];
+        const SurfaceBatch& source = batches[faceBatch(f)];
+        const vtkIdType index = f - faceOffsets[faceBatch(f)];
+        const vtkIdType cellId = source.FaceCells[index];
+        const int faceId = source.FaceIndices[index];
+        const vtkIdType* pts = &facePoints[faceStarts[f]];
+        const vtkIdType npts = faceSize(f);
+        if (faceId < 0 || subdivisionLevel < 1)
+        {
+          // Like the face hash, the points of a hidden face are numbered.
+          batch.InsertNextCell(
+            SURFACE_POLYS, npts, pts, HasHiddenPoint(ghosts, npts, pts) ? -1 : cellId);
+          continue;
+        }
+        input->GetCell(cellId, local.Cell);
+        input->SetCellOrderAndRationalWeights(cellId, local.Cell);
+        vtkCell* face = local.Cell->GetFace(faceId);
+        if (!HasHiddenPoint(ghosts, face->GetNumberOfPoints(), face->GetPointIds()->GetPointer(0)))
+        {
+          TriangulateNonlinearCell(face, cellId, faceId, local, batch, cellId);
+        }
+      }
+    }
+  });
+  std::vector<vtkIdType>().swap(facePoints);
+  this->UpdateProgress(0.6);
+  if (this->CheckAbort())
+  {
+    return 1;
+  }
+
+  // The output cells of all the batches, in the order of the serial
+  // implementation: vertices, lines, then polygons followed by the boundary
+  // faces.
+  struct Segment
+  {
+    SurfaceBatch* Batch;
+    int Kind;
+    vtkIdType NewPointOffset;
+  };
+  std::vector<Segment> segments;
+  std::vector<SurfaceBatch*> allBatches;
+  std::vector<vtkIdType> newPointOffsets;
+  vtkIdType numNewPoints = 0;
+  for (std::vector<SurfaceBatch>* list : { &batches, &faceBatches })
+  {
+    for (SurfaceBatch& batch : *list)
+    {
+      allBatches.push_back(&batch);
+      newPointOffsets.push_back(numNewPoints);
+      numNewPoints += static_cast<vtkIdType>(batch.NewPoints.size());
+    }
+  }
+  for (int kind = SURFACE_VERTS; kind <= SURFACE_POLYS; ++kind)
+  {
+    for (vtkIdType batchId = 0; batchId < numBatches; ++batchId)
+    {
+      segments.push_back({ &batches[batchId], kind, newPointOffsets[batchId] });
+    }
+  }
+  for (vtkIdType batchId = 0; batchId < numFaceBatches; ++batchId)
+  {
+    segments.push_back(
+      { &faceBatches[batchId], SURFACE_POLYS, newPointOffsets[numBatches + batchId] });
+  }
+  const vtkIdType numSegments = static_cast<vtkIdType>(segments.size());
+
+  // Offsets of the segments in the sequence of the points of the cells, in
+  // the output cells and in the connectivity of their kind.
+  std::vector<vtkIdType> refOffsets(numSegments + 1);
+  std::vector<vtkIdType> cellOffsets(numSegments + 1);
+  std::vector<vtkIdType> connOffsets(numSegments + 1);
+  vtkSMPTools::For(0, numSegments, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType s = begin; s < end; ++s)
+    {
+      const SurfaceBatch& batch = *segments[s].Batch;
+      const int kind = segments[s].Kind;
+      refOffsets[s] = static_cast<vtkIdType>(batch.Points[kind].size());
+      cellOffsets[s] = 0;
+      connOffsets[s] = 0;
+      for (size_t c = 0; c < batch.Sizes[kind].size(); ++c)
+      {
+        if (batch.Sources[kind][c] >= 0)
+        {
+          ++cellOffsets[s];
+          connOffsets[s] += batch.Sizes[kind][c];
+        }
+      }
+    }
+  });
+  const vtkIdType numRefs = vtkSMPTools::ExclusiveScan(
+    refOffsets.begin(), refOffsets.end() - 1, refOffsets.begin(), vtkIdType(0));
+  refOffsets[numSegments] = numRefs;
+  vtkIdType numKindCells[3] = { 0, 0, 0 };
+  vtkIdType numKindConn[3] = { 0, 0, 0 };
+  const vtkIdType kindStart[4] = { 0, numBatches, 2 * numBatches, numSegments };
+  for (int kind = SURFACE_VERTS; kind <= SURFACE_POLYS; ++kind)
+  {
+    numKindCells[kind] = vtkSMPTools::ExclusiveScan(cellOffsets.begin() + kindStart[kind],
+      cellOffsets.begin() + kindStart[kind + 1], cellOffsets.begin() + kindStart[kind],
+      vtkIdType(0));
+    numKindConn[kind] = vtkSMPTools::ExclusiveScan(connOffsets.begin() + kindStart[kind],
+      connOffsets.begin() + kindStart[kind + 1], connOffsets.begin() + kindStart[kind],
+      vtkIdType(0));
+  }
+
+  // The points of the cells, as input point ids or -1 - i for the i-th new
+  // point of all the batches.
+  std::vector<vtkIdType> refs(numRefs);
+  vtkSMPTools::For(0, numSegments, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType s = begin; s < end; ++s)
+    {
+      const std::vector<vtkIdType>& points = segments[s].Batch->Points[segments[s].Kind];
+      const vtkIdType offset = segments[s].NewPointOffset;
+      std::transform(points.begin(), points.end(), refs.begin() + refOffsets[s],
+        [offset](vtkIdType ref) { return ref >= 0 ? ref : ref - offset; });
+    }
+  });
+  std::vector<SurfacePoint> newPoints(numNewPoints);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(allBatches.size()), 1,
+    [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType b = begin; b < end; ++b)
+      {
+        std::copy(allBatches[b]->NewPoints.begin(), allBatches[b]->NewPoints.end(),
+          newPoints.begin() + newPointOffsets[b]);
+      }
+    });
+  auto inputPoint = [&](vtkIdType ref) { return ref >= 0 ? ref : newPoints[-1 - ref].PointId; };
+
+  // Number the output points in their order of first use.
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUses(new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::For(0, numPts, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      firstUses[ptId] = numRefs;
+    }
+  });
+  vtkSMPTools::For(0, numRefs, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType ptId = inputPoint(refs[i]);
+      if (ptId >= 0)
+      {
+        vtkIdType first = firstUses[ptId];
+        while (i < first && !firstUses[ptId].compare_exchange_weak(first, i))
+        {
+        }
+      }
+    }
+  });
+  auto isFirstUse = [&](vtkIdType i) {
+    const vtkIdType ptId = inputPoint(refs[i]);
+    return ptId < 0 || firstUses[ptId] == i;
+  };
+  std::vector<vtkIdType> pointMap(numRefs);
+  vtkSMPTools::For(0, numRefs, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      pointMap[i] = isFirstUse(i) ? 1 : 0;
+    }
+  });
+  const vtkIdType numOutPts =
+    vtkSMPTools::ExclusiveScan(pointMap.begin(), pointMap.end(), pointMap.begin(), vtkIdType(0));
+  std::vector<vtkIdType> pointSources(numOutPts);
+  vtkSMPTools::For(0, numRefs, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (isFirstUse(i))
+      {
+        pointSources[pointMap[i]] = refs[i];
+      }
+    }
+  });
+  vtkSMPTools::For(0, numRefs, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (!isFirstUse(i))
+      {
+        pointMap[i] = pointMap[firstUses[inputPoint(refs[i])]];
+      }
+    }
+  });
+  firstUses.reset();
+  std::vector<vtkIdType>().swap(refs);
+
+  // Output points and point data, copied from the input or evaluated in the
+  // cells.
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(dataType);
+  newPts->SetNumberOfPoints(numOutPts);
+  outputPD->CopyGlobalIdsOn();
+  outputPD->CopyAllocate(inputPD, numOutPts);
+  outputPD->SetNumberOfTuples(numOutPts);
+  vtkSmartPointer<vtkIdTypeArray> originalPointIds;
+  if (this->PassThroughPointIds)
+  {
+    originalPointIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    originalPointIds->SetName(this->GetOriginalPointIdsName());
+    originalPointIds->SetNumberOfValues(numOutPts);
+  }
+  vtkSMPTools::For(0, numOutPts, [&](vtkIdType begin, vtkIdType end) {
+    SurfaceLocal& local = threadLocals.Local();
+    local.Initialize(dataType);
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      const vtkIdType ref = pointSources[ptId];
+      double x[3];
+      if (ref >= 0)
+      {
+        input->GetPoint(ref, x);
+        outputPD->CopyData(inputPD, ref, ptId);
+      }
+      else
+      {
+        const SurfacePoint& point = newPoints[-1 - ref];
+        input->GetCell(point.CellId, local.Cell);
+        input->SetCellOrderAndRationalWeights(point.CellId, local.Cell);
+        vtkCell* cell =
+          point.FaceId >= 0 ? local.Cell->GetFace(point.FaceId) : local.Cell.GetPointer();
+        local.Weights.resize(cell->GetNumberOfPoints());
+        double pcoords[3] = { point.PCoords[0], point.PCoords[1], point.PCoords[2] };
+        int subId = -1;
+        cell->EvaluateLocation(subId, pcoords, x, local.Weights.data());
+        outputPD->InterpolatePoint(inputPD, ptId, cell->GetPointIds(), local.Weights.data());
+      }
+      newPts->SetPoint(ptId, x);
+      if (originalPointIds)
+      {
+        originalPointIds->SetValue(ptId, inputPoint(ref));
+      }
+    }
+  });
+  this->UpdateProgress(0.8);
+
+  // Output cells and cell data.
+  vtkSmartPointer<vtkCellArray> newCells[3];
+  vtkSmartPointer<vtkIdTypeArray> offsets[3];
+  vtkSmartPointer<vtkIdTypeArray> connectivity[3];
+  for (int kind = SURFACE_VERTS; kind <= SURFACE_POLYS; ++kind)
+  {
+    offsets[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    offsets[kind]->SetNumberOfValues(numKindCells[kind] + 1);
+    offsets[kind]->SetValue(numKindCells[kind], numKindConn[kind]);
+    connectivity[kind] = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity[kind]->SetNumberOfValues(numKindConn[kind]);
+  }
+  const vtkIdType numOutCells = numKindCells[0] + numKindCells[1] + numKindCells[2];
+  const vtkIdType firstKindCell[3] = { 0, numKindCells[0], numKindCells[0] + numKindCells[1] };
+  std::vector<vtkIdType> cellSources(numOutCells);
+  vtkSMPTools::For(0, numSegments, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType s = begin; s < end; ++s)
+    {
+      const SurfaceBatch& batch = *segments[s].Batch;
+      const int kind = segments[s].Kind;
+      vtkIdType ref = refOffsets[s];
+      vtkIdType cellId = cellOffsets[s];
+      vtkIdType conn = connOffsets[s];
+      for (size_t c = 0; c < batch.Sizes[kind].size(); ++c)
+      {
+        const vtkIdType npts = batch.Sizes[kind][c];
+        if (batch.Sources[kind][c] >= 0)
+        {
+          offsets[kind]->SetValue(cellId, conn);
+          cellSources[firstKindCell[kind] + cellId] = batch.Sources[kind][c];
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            connectivity[kind]->SetValue(conn++, pointMap[ref + i]);
+          }
+          ++cellId;
+        }
+        ref += npts;
+      }
+    }
+  });
+  for (int kind = SURFACE_VERTS; kind <= SURFACE_POLYS; ++kind)
+  {
+    newCells[kind] = vtkSmartPointer<vtkCellArray>::New();
+    newCells[kind]->SetData(offsets[kind], connectivity[kind]);
+  }
+
+  outputCD->CopyGlobalIdsOn();
+  outputCD->CopyAllocate(inputCD, numOutCells);
+  outputCD->SetNumberOfTuples(numOutCells);
+  vtkSmartPointer<vtkIdTypeArray> originalCellIds;
+  if (this->PassThroughCellIds)
+  {
+    originalCellIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    originalCellIds->SetName(this->GetOriginalCellIdsName());
+    originalCellIds->SetNumberOfValues(numOutCells);
+  }
+  vtkSMPTools::For(0, numOutCells, [&](vtkIdType begin, vtkIdType end) {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      outputCD->CopyData(inputCD, cellSources[cellId], cellId);
+      if (originalCellIds)
+      {
+        originalCellIds->SetValue(cellId, cellSources[cellId]);
+      }
+    }
+  });
+
+  if (originalCellIds)
+  {
+    outputCD->AddArray(originalCellIds);
+  }
+  if (originalPointIds)
+  {
+    outputPD->AddArray(originalPointIds);
+  }
+  output->SetPoints(newPts);
+  output->SetPolys(newCells[SURFACE_POLYS]);
+  if (numKindCells[SURFACE_VERTS] > 0)
+  {
+    output->SetVerts(newCells[SURFACE_VERTS]);
+  }
+  if (numKindCells[SURFACE_LINES] > 0)
+  {
+    output->SetLines(newCells[SURFACE_LINES]);
+  }
+  output->Squeeze();
+
+  return 1;
+}
+
 //------------------------------------------------------------------------------
 void vtkDataSetSurfaceFilter::InitializeQuadHash(vtkIdType numPoints)
 {
@@ -48,6 +48,19 @@
  * or when `Delegation` is true. When Delegation is true, the flag is passed on
  * to `vtkGeometryFilter` (see `vtkGeometryFilter:SetFastMode`).
  *
+ * @section SMP Threaded Implementation
+ *
+ * When EnableSMP is on, unstructured grids are processed using vtkSMPTools,
+ * unless NonlinearSubdivisionLevel is greater than 1. The cells are
+ * processed in batches: the faces of the 3D cells are gathered and sorted to
+ * find those used only once, instead of being inserted in the face hash, and
+ * the output points are numbered in their order of first use. For linear
+ * cells, the output is the same as the serial one. The boundary faces of
+ * nonlinear 3D cells are extracted directly rather than with an internal
+ * vtkUnstructuredGridGeometryFilter, so the triangles describing them may
+ * differ from the serial output, and come in the same order as the faces of
+ * linear cells.
+ *
  * @warning
  * At one time, vtkDataSetSurfaceFilter was a faster version of
  * vtkGeometryFilter when processing unstructured grids, however
@@ -208,6 +221,20 @@ public:
   vtkBooleanMacro(Delegation, vtkTypeBool);
   ///@}
 
+  ///@{
+  /**
+   * Enable/Disable the threaded extraction of the surface of unstructured
+   * grids. It is not used when NonlinearSubdivisionLevel is greater than 1,
+   * nor when the grid is delegated to vtkGeometryFilter. The output of linear
+   * cells is the same as the serial one, in the same order. The surface of
+   * nonlinear 3D cells is triangulated differently than serially, and comes
+   * in the order of the input cells. Default is off.
+   */
+  vtkSetMacro(EnableSMP, bool);
+  vtkGetMacro(EnableSMP, bool);
+  vtkBooleanMacro(EnableSMP, bool);
+  ///@}
+
   ///@{
   /**
    * Direct access methods so that this class can be used as an
@@ -356,11 +383,13 @@ protected:
   int NonlinearSubdivisionLevel;
   vtkTypeBool Delegation;
   bool FastMode;
+  bool EnableSMP;
 
 private:
   int UnstructuredGridBaseExecute(vtkDataSet* input, vtkPolyData* output);
   int UnstructuredGridExecuteInternal(
     vtkUnstructuredGridBase* input, vtkPolyData* output, bool handleSubdivision);
+  int UnstructuredGridExecuteSMP(vtkUnstructuredGridBase* input, vtkPolyData* output);
 
   int StructuredExecuteNoBlanking(
     vtkDataSet* input, vtkPolyData* output, vtkIdType* ext, vtkIdType* wholeExt);
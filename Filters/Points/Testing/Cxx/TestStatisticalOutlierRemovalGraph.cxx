@@ -0,0 +1,96 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStatisticalOutlierRemovalGraph.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// The static point locator gathers the neighborhoods of the points in chunks.
+// Check that the mean distance computed this way matches the one computed
+// point by point with another locator, over more than one chunk of points.
+
+#include "vtkKdTreePointLocator.h"
+#include "vtkLogger.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointSet.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkStatisticalOutlierRemoval.h"
+
+#include <cmath>
+
+//------------------------------------------------------------------------------
+int TestStatisticalOutlierRemovalGraph(int, char*[])
+{
+  // With this sample size a chunk holds 4192 points: the first chunk is spread
+  // over all the threads, while the last one is too small to be split.
+  const int sampleSize = 2000;
+  const vtkIdType numPts = 4200;
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1177);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = random->GetNextRangeValue(-1.0, 1.0);
+    }
+    points->SetPoint(i, x);
+  }
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points);
+
+  vtkNew<vtkStaticPointLocator> staticLocator;
+  vtkNew<vtkStatisticalOutlierRemoval> graphRemoval;
+  graphRemoval->SetInputData(input);
+  graphRemoval->SetLocator(staticLocator);
+  graphRemoval->SetSampleSize(sampleSize);
+  graphRemoval->Update();
+
+  vtkNew<vtkKdTreePointLocator> kdTreeLocator;
+  vtkNew<vtkStatisticalOutlierRemoval> pointRemoval;
+  pointRemoval->SetInputData(input);
+  pointRemoval->SetLocator(kdTreeLocator);
+  pointRemoval->SetSampleSize(sampleSize);
+  pointRemoval->Update();
+
+  const double graphMean = graphRemoval->GetComputedMean();
+  const double pointMean = pointRemoval->GetComputedMean();
+  if (std::abs(graphMean - pointMean) > 1.0e-6 * pointMean)
+  {
+    vtkLog(ERROR, "Mean distance " << graphMean << " differs from " << pointMean);
+    return EXIT_FAILURE;
+  }
+
+  const double graphSigma = graphRemoval->GetComputedStandardDeviation();
+  const double pointSigma = pointRemoval->GetComputedStandardDeviation();
+  if (std::abs(graphSigma - pointSigma) > 1.0e-6 * pointSigma)
+  {
+    vtkLog(ERROR, "Standard deviation " << graphSigma << " differs from " << pointSigma);
+    return EXIT_FAILURE;
+  }
+
+  const vtkIdType graphNumPts = graphRemoval->GetOutput()->GetNumberOfPoints();
+  const vtkIdType pointNumPts = pointRemoval->GetOutput()->GetNumberOfPoints();
+  if (graphNumPts != pointNumPts)
+  {
+    vtkLog(ERROR, "Kept " << graphNumPts << " points instead of " << pointNumPts);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -17,9 +17,11 @@
 #include "vtkAbstractPointLocator.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
@@ -28,6 +30,8 @@
 #include "vtkSMPTools.h"
 #include "vtkStaticPointLocator.h"
 
+#include <algorithm>
+
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkPCANormalEstimation);
 vtkCxxSetObjectMacro(vtkPCANormalEstimation, Locator, vtkAbstractPointLocator);
@@ -35,6 +39,11 @@ vtkCxxSetObjectMacro(vtkPCANormalEstimation, Locator, vtkAbstractPointLocator);
 namespace
 {
 
+// The neighborhoods of the points are gathered with
+// vtkStaticPointLocator::FindClosestNPointsGraph() in chunks of points
+// holding at most this number of neighbors, which bounds the memory used.
+constexpr vtkIdType MaximumGraphSize = 8388608;
+
 //------------------------------------------------------------------------------
 // The threaded core of the algorithm.
 template <typename T>
@@ -48,6 +57,12 @@ struct GenerateNormals
   double OPoint[3];
   bool Flip;
 
+  // The neighborhoods of the points [GraphBegin, GraphBegin + number of rows)
+  // when they were gathered as a graph by a vtkStaticPointLocator.
+  const vtkIdType* GraphOffsets;
+  const vtkIdType* GraphNeighbors;
+  vtkIdType GraphBegin;
+
   // Don't want to allocate working arrays on every thread invocation. Thread local
   // storage lots of new/delete.
   vtkSMPThreadLocalObject<vtkIdList> PIds;
@@ -60,6 +75,9 @@ struct GenerateNormals
     , Normals(normals)
     , Orient(orient)
     , Flip(flip)
+    , GraphOffsets(nullptr)
+    , GraphNeighbors(nullptr)
+    , GraphBegin(0)
   {
     this->OPoint[0] = opoint[0];
     this->OPoint[1] = opoint[1];
@@ -79,7 +97,8 @@ struct GenerateNormals
     const T* py;
     float* n = this->Normals + 3 * ptId;
     double x[3], mean[3], o[3];
-    vtkIdList*& pIds = this->PIds.Local();
+    vtkIdList*& idList = this->PIds.Local();
+    const vtkIdType* pIds;
     vtkIdType numPts, nei;
     int sample, i;
     double *a[3], a0[3], a1[3], a2[3], xp[3];
@@ -100,14 +119,24 @@ struct GenerateNormals
       x[2] = static_cast<double>(*px++);
 
       // Retrieve the local neighborhood
-      this->Locator->FindClosestNPoints(this->SampleSize, x, pIds);
-      numPts = pIds->GetNumberOfIds();
+      if (this->GraphNeighbors)
+      {
+        const vtkIdType* offsets = this->GraphOffsets + (ptId - this->GraphBegin);
+        pIds = this->GraphNeighbors + offsets[0];
+        numPts = offsets[1] - offsets[0];
+      }
+      else
+      {
+        this->Locator->FindClosestNPoints(this->SampleSize, x, idList);
+        pIds = idList->GetPointer(0);
+        numPts = idList->GetNumberOfIds();
+      }
 
       // First step: compute the mean position of the neighborhood.
       mean[0] = mean[1] = mean[2] = 0.0;
       for (sample = 0; sample < numPts; ++sample)
       {
-        nei = pIds->GetId(sample);
+        nei = pIds[sample];
         py = this->Points + 3 * nei;
         mean[0] += static_cast<double>(*py++);
         mean[1] += static_cast<double>(*py++);
@@ -123,7 +152,7 @@ struct GenerateNormals
       a0[2] = a1[2] = a2[2] = 0.0;
       for (sample = 0; sample < numPts; ++sample)
       {
-        nei = pIds->GetId(sample);
+        nei = pIds[sample];
         py = this->Points + 3 * nei;
         xp[0] = static_cast<double>(*py++) - mean[0];
         xp[1] = static_cast<double>(*py++) - mean[1];
@@ -179,7 +208,27 @@ struct GenerateNormals
   {
     GenerateNormals gen(
       points, self->GetLocator(), self->GetSampleSize(), normals, orient, opoint, flip);
-    vtkSMPTools::For(0, numPts, gen);
+    vtkStaticPointLocator* staticLocator = vtkStaticPointLocator::SafeDownCast(self->GetLocator());
+    if (!staticLocator)
+    {
+      vtkSMPTools::For(0, numPts, gen);
+      return;
+    }
+
+    // The static locator gathers the neighborhoods of many points at once,
+    // processing the points of each of its buckets together.
+    vtkNew<vtkIdTypeArray> offsets;
+    vtkNew<vtkIdTypeArray> neighbors;
+    const vtkIdType chunkSize = std::max<vtkIdType>(MaximumGraphSize / gen.SampleSize, 1);
+    for (vtkIdType beginId = 0; beginId < numPts; beginId += chunkSize)
+    {
+      const vtkIdType endId = std::min(beginId + chunkSize, numPts);
+      staticLocator->FindClosestNPointsGraph(gen.SampleSize, offsets, neighbors, beginId, endId);
+      gen.GraphOffsets = offsets->GetPointer(0);
+      gen.GraphNeighbors = neighbors->GetPointer(0);
+      gen.GraphBegin = beginId;
+      vtkSMPTools::For(beginId, endId, gen);
+    }
   }
 }; // GenerateNormals
 
@@ -16,7 +16,9 @@
 
 #include "vtkAbstractPointLocator.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointSet.h"
 #include "vtkPoints.h"
@@ -24,6 +26,8 @@
 #include "vtkSMPTools.h"
 #include "vtkStaticPointLocator.h"
 
+#include <algorithm>
+
 VTK_ABI_NAMESPACE_BEGIN
 vtkStandardNewMacro(vtkStatisticalOutlierRemoval);
 vtkCxxSetObjectMacro(vtkStatisticalOutlierRemoval, Locator, vtkAbstractPointLocator);
@@ -33,6 +37,11 @@ vtkCxxSetObjectMacro(vtkStatisticalOutlierRemoval, Locator, vtkAbstractPointLoca
 namespace
 {
 
+// The neighborhoods of the points are gathered with
+// vtkStaticPointLocator::FindClosestNPointsGraph() in chunks of points
+// holding at most this number of neighbors, which bounds the memory used.
+constexpr vtkIdType MaximumGraphSize = 8388608;
+
 //------------------------------------------------------------------------------
 // The threaded core of the algorithm (first pass)
 template <typename T>
@@ -43,6 +52,14 @@ struct ComputeMeanDistance
   int SampleSize;
   float* Distance;
   double Mean;
+  double Sum;
+  vtkIdType Count;
+
+  // The neighborhoods of the points [GraphBegin, GraphBegin + number of rows)
+  // when they were gathered as a graph by a vtkStaticPointLocator.
+  const vtkIdType* GraphOffsets;
+  const vtkIdType* GraphNeighbors;
+  vtkIdType GraphBegin;
 
   // Don't want to allocate working arrays on every thread invocation. Thread local
   // storage lots of new/delete.
@@ -56,6 +73,11 @@ struct ComputeMeanDistance
     , SampleSize(size)
     , Distance(d)
     , Mean(0.0)
+    , Sum(0.0)
+    , Count(0)
+    , GraphOffsets(nullptr)
+    , GraphNeighbors(nullptr)
+    , GraphBegin(0)
   {
   }
 
@@ -79,7 +101,9 @@ struct ComputeMeanDistance
     const T* px = this->Points + 3 * ptId;
     const T* py;
     double x[3], y[3];
-    vtkIdList*& pIds = this->PIds.Local();
+    vtkIdList*& idList = this->PIds.Local();
+    const vtkIdType* pIds;
+    vtkIdType numPts;
     double& threadMean = this->ThreadMean.Local();
     vtkIdType& threadCount = this->ThreadCount.Local();
 
@@ -91,14 +115,24 @@ struct ComputeMeanDistance
 
       // The method FindClosestNPoints will include the current point, so
       // we increase the sample size by one.
-      this->Locator->FindClosestNPoints(this->SampleSize + 1, x, pIds);
-      vtkIdType numPts = pIds->GetNumberOfIds();
+      if (this->GraphNeighbors)
+      {
+        const vtkIdType* offsets = this->GraphOffsets + (ptId - this->GraphBegin);
+        pIds = this->GraphNeighbors + offsets[0];
+        numPts = offsets[1] - offsets[0];
+      }
+      else
+      {
+        this->Locator->FindClosestNPoints(this->SampleSize + 1, x, idList);
+        pIds = idList->GetPointer(0);
+        numPts = idList->GetNumberOfIds();
+      }
 
       double sum = 0.0;
       vtkIdType nei;
       for (int sample = 0; sample < numPts; ++sample)
       {
-        nei = pIds->GetId(sample);
+        nei = pIds[sample];
         if (nei != ptId) // exclude ourselves
         {
           py = this->Points + 3 * nei;
@@ -123,7 +157,9 @@ struct ComputeMeanDistance
     }
   }
 
-  // Compute the mean by compositing all threads
+  // Compute the mean by compositing all threads, and the previous chunks of
+  // points if any. The thread sums are reset once accumulated: Initialize()
+  // only resets those of the threads taking part in the next chunk.
   void Reduce()
   {
     double mean = 0.0;
@@ -134,6 +170,7 @@ struct ComputeMeanDistance
     for (mItr = this->ThreadMean.begin(); mItr != mEnd; ++mItr)
     {
       mean += *mItr;
+      *mItr = 0.0;
     }
 
     vtkSMPThreadLocal<vtkIdType>::iterator cItr;
@@ -141,17 +178,42 @@ struct ComputeMeanDistance
     for (cItr = this->ThreadCount.begin(); cItr != cEnd; ++cItr)
     {
       count += *cItr;
+      *cItr = 0;
     }
 
-    count = (count < 1 ? 1 : count);
-    this->Mean = mean / static_cast<double>(count);
+    this->Sum += mean;
+    this->Count += count;
+    count = (this->Count < 1 ? 1 : this->Count);
+    this->Mean = this->Sum / static_cast<double>(count);
   }
 
   static void Execute(
     vtkStatisticalOutlierRemoval* self, vtkIdType numPts, T* points, float* distances, double& mean)
   {
     ComputeMeanDistance compute(points, self->GetLocator(), self->GetSampleSize(), distances);
-    vtkSMPTools::For(0, numPts, compute);
+    vtkStaticPointLocator* staticLocator = vtkStaticPointLocator::SafeDownCast(self->GetLocator());
+    if (!staticLocator)
+    {
+      vtkSMPTools::For(0, numPts, compute);
+      mean = compute.Mean;
+      return;
+    }
+
+    // The static locator gathers the neighborhoods of many points at once,
+    // processing the points of each of its buckets together.
+    vtkNew<vtkIdTypeArray> offsets;
+    vtkNew<vtkIdTypeArray> neighbors;
+    const int numNeighbors = compute.SampleSize + 1;
+    const vtkIdType chunkSize = std::max<vtkIdType>(MaximumGraphSize / numNeighbors, 1);
+    for (vtkIdType beginId = 0; beginId < numPts; beginId += chunkSize)
+    {
+      const vtkIdType endId = std::min(beginId + chunkSize, numPts);
+      staticLocator->FindClosestNPointsGraph(numNeighbors, offsets, neighbors, beginId, endId);
+      compute.GraphOffsets = offsets->GetPointer(0);
+      compute.GraphNeighbors = neighbors->GetPointer(0);
+      compute.GraphBegin = beginId;
+      vtkSMPTools::For(beginId, endId, compute);
+    }
     mean = compute.Mean;
   }
 
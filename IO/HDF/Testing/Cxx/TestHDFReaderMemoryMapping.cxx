@@ -0,0 +1,202 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestHDFReaderMemoryMapping.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Read an image stored in a VTKHDF file with and without UseMemoryMapping,
+// and check that both give the same arrays. The arrays stored contiguously
+// in the file must be mapped, the chunked one must be read instead.
+
+#include "vtkAOSDataArrayTemplate.h"
+#include "vtkHDFReader.h"
+#include "vtkImageData.h"
+#include "vtkMemoryMappedFile.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkTestUtilities.h"
+#include "vtk_hdf5.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr int Dimensions[3] = { 7, 5, 3 };
+
+template <typename T>
+bool WriteAttribute(hid_t group, const char* name, hid_t type, const std::vector<T>& values)
+{
+  hsize_t size = values.size();
+  hid_t space = H5Screate_simple(1, &size, nullptr);
+  hid_t attribute = H5Acreate(group, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+  bool success = attribute >= 0 && H5Awrite(attribute, type, values.data()) >= 0;
+  H5Aclose(attribute);
+  H5Sclose(space);
+  return success;
+}
+
+template <typename T>
+bool WriteArray(hid_t group, const char* name, hid_t type, int numberOfComponents, bool chunked)
+{
+  std::vector<hsize_t> dims = { static_cast<hsize_t>(Dimensions[2]),
+    static_cast<hsize_t>(Dimensions[1]), static_cast<hsize_t>(Dimensions[0]) };
+  if (numberOfComponents > 1)
+  {
+    dims.push_back(numberOfComponents);
+  }
+  std::vector<T> values(Dimensions[0] * Dimensions[1] * Dimensions[2] * numberOfComponents);
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    values[i] = static_cast<T>(0.5 * i - 7.0);
+  }
+  hid_t space = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr);
+  hid_t plist = H5Pcreate(H5P_DATASET_CREATE);
+  if (chunked)
+  {
+    H5Pset_chunk(plist, static_cast<int>(dims.size()), dims.data());
+  }
+  hid_t dataset = H5Dcreate(group, name, type, space, H5P_DEFAULT, plist, H5P_DEFAULT);
+  bool success =
+    dataset >= 0 && H5Dwrite(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()) >= 0;
+  H5Dclose(dataset);
+  H5Pclose(plist);
+  H5Sclose(space);
+  return success;
+}
+
+bool WriteImage(const std::string& fileName)
+{
+  hid_t file = H5Fcreate(fileName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (file < 0)
+  {
+    return false;
+  }
+  hid_t root = H5Gcreate(file, "/VTKHDF", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  bool success = WriteAttribute(root, "Version", H5T_NATIVE_INT, std::vector<int>{ 1, 0 });
+  success &= WriteAttribute(root, "WholeExtent", H5T_NATIVE_INT,
+    std::vector<int>{ 0, Dimensions[0] - 1, 0, Dimensions[1] - 1, 0, Dimensions[2] - 1 });
+  success &= WriteAttribute(root, "Origin", H5T_NATIVE_DOUBLE, std::vector<double>{ 0, 0, 0 });
+  success &= WriteAttribute(root, "Spacing", H5T_NATIVE_DOUBLE, std::vector<double>{ 1, 1, 1 });
+  success &= WriteAttribute(
+    root, "Direction", H5T_NATIVE_DOUBLE, std::vector<double>{ 1, 0, 0, 0, 1, 0, 0, 0, 1 });
+
+  const std::string typeName = "ImageData";
+  hid_t stringType = H5Tcopy(H5T_C_S1);
+  H5Tset_size(stringType, typeName.size());
+  hid_t scalarSpace = H5Screate(H5S_SCALAR);
+  hid_t type = H5Acreate(root, "Type", stringType, scalarSpace, H5P_DEFAULT, H5P_DEFAULT);
+  success &= type >= 0 && H5Awrite(type, stringType, typeName.c_str()) >= 0;
+  H5Aclose(type);
+  H5Sclose(scalarSpace);
+  H5Tclose(stringType);
+
+  hid_t pointData = H5Gcreate(root, "PointData", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  success &= WriteArray<double>(pointData, "Scalars", H5T_NATIVE_DOUBLE, 1, false);
+  success &= WriteArray<float>(pointData, "Vectors", H5T_NATIVE_FLOAT, 3, false);
+  success &= WriteArray<double>(pointData, "Chunked", H5T_NATIVE_DOUBLE, 1, true);
+  H5Gclose(pointData);
+  H5Gclose(root);
+  H5Fclose(file);
+  return success;
+}
+
+template <typename T>
+bool IsMapped(vtkAOSDataArrayTemplate<T>* array)
+{
+  return array && array->IsMapped();
+}
+
+bool CompareArrays(vtkDataArray* array, vtkDataArray* expected, bool expectMapped)
+{
+  if (!array || !expected || array->GetDataType() != expected->GetDataType() ||
+    array->GetNumberOfTuples() != expected->GetNumberOfTuples() ||
+    array->GetNumberOfComponents() != expected->GetNumberOfComponents())
+  {
+    std::cerr << "Array " << (expected ? expected->GetName() : "") << " differs" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < expected->GetNumberOfValues(); ++i)
+  {
+    const int numComps = expected->GetNumberOfComponents();
+    if (array->GetComponent(i / numComps, i % numComps) !=
+      expected->GetComponent(i / numComps, i % numComps))
+    {
+      std::cerr << "Array " << expected->GetName() << " differs at value " << i << std::endl;
+      return false;
+    }
+  }
+
+  bool mapped = false;
+  switch (array->GetDataType())
+  {
+    vtkTemplateMacro(mapped = IsMapped(vtkAOSDataArrayTemplate<VTK_TT>::FastDownCast(array)));
+  }
+  if (mapped != expectMapped)
+  {
+    std::cerr << "Array " << expected->GetName() << (mapped ? " is" : " is not") << " mapped"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestHDFReaderMemoryMapping(int argc, char* argv[])
+{
+  if (!vtkMemoryMappedFile::IsSupported())
+  {
+    std::cout << "File mapping is not supported on this platform." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string fileName = std::string(tempDir) + "/TestHDFReaderMemoryMapping.hdf";
+  delete[] tempDir;
+
+  if (!WriteImage(fileName))
+  {
+    std::cerr << "Cannot write " << fileName << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkHDFReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkNew<vtkHDFReader> mappingReader;
+  mappingReader->SetFileName(fileName.c_str());
+  mappingReader->UseMemoryMappingOn();
+  mappingReader->Update();
+
+  vtkPointData* pointData = vtkImageData::SafeDownCast(mappingReader->GetOutput())->GetPointData();
+  vtkPointData* expected = vtkImageData::SafeDownCast(reader->GetOutput())->GetPointData();
+  bool success = CompareArrays(pointData->GetArray("Scalars"), expected->GetArray("Scalars"), true);
+  success &= CompareArrays(pointData->GetArray("Vectors"), expected->GetArray("Vectors"), true);
+  success &= CompareArrays(pointData->GetArray("Chunked"), expected->GetArray("Chunked"), false);
+
+  // The mapped values can be modified without altering the file.
+  vtkDataArray* scalars = pointData->GetArray("Scalars");
+  scalars->SetComponent(0, 0, 42.0);
+  vtkNew<vtkHDFReader> otherReader;
+  otherReader->SetFileName(fileName.c_str());
+  otherReader->UseMemoryMappingOn();
+  otherReader->Update();
+  vtkDataArray* otherScalars =
+    vtkImageData::SafeDownCast(otherReader->GetOutput())->GetPointData()->GetArray("Scalars");
+  if (scalars->GetComponent(0, 0) != 42.0 || !otherScalars ||
+    otherScalars->GetComponent(0, 0) != expected->GetArray("Scalars")->GetComponent(0, 0))
+  {
+    std::cerr << "Modifying mapped values altered the file" << std::endl;
+    success = false;
+  }
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -126,6 +126,7 @@ void vtkHDFReader::PrintSelf(ostream& os, vtkIndent indent)
      << "\n";
   os << indent << "PointDataArraySelection: " << this->DataArraySelection[vtkDataObject::POINT]
      << "\n";
+  os << indent << "UseMemoryMapping: " << this->UseMemoryMapping << "\n";
 }
 
 //----------------------------------------------------------------------------
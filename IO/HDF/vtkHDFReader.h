@@ -109,6 +109,20 @@ public:
   vtkSetMacro(MaximumLevelsToReadByDefaultForAMR, unsigned int);
   vtkGetMacro(MaximumLevelsToReadByDefaultForAMR, unsigned int);
 
+  ///@{
+  /**
+   * When enabled, arrays stored contiguously and uncompressed in the file
+   * with the native type of this machine are mapped in memory
+   * (copy-on-write) instead of being read, so that their values are loaded
+   * on demand when accessed. Other arrays are read as usual. Default is off.
+   *
+   * @sa vtkAOSDataArrayTemplate::MapFile()
+   */
+  vtkSetMacro(UseMemoryMapping, bool);
+  vtkGetMacro(UseMemoryMapping, bool);
+  vtkBooleanMacro(UseMemoryMapping, bool);
+  ///@}
+
 protected:
   vtkHDFReader();
   ~vtkHDFReader() override;
@@ -203,6 +217,8 @@ protected:
 
   unsigned int MaximumLevelsToReadByDefaultForAMR = 0;
 
+  bool UseMemoryMapping = false;
+
   class Implementation;
   Implementation* Impl;
 };
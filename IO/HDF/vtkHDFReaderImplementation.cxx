@@ -876,6 +876,18 @@ vtkDataArray* vtkHDFReader::Implementation::NewArray(
   }
   auto array = vtkAOSDataArrayTemplate<T>::SafeDownCast(NewVtkDataArray<T>());
   array->SetNumberOfComponents(numberOfComponents);
+  if (this->Reader->GetUseMemoryMapping())
+  {
+    vtkTypeInt64 position = this->GetContiguousSlabPosition(
+      dataset, TemplateTypeToHdfNativeType<T>(), fileExtent, numberOfComponents);
+    if (position >= 0 &&
+      array->MapFile(this->FileName.c_str(), position,
+        static_cast<vtkIdType>(numberOfTuples) * static_cast<vtkIdType>(numberOfComponents),
+        vtkMemoryMappedFile::COPY_ON_WRITE))
+    {
+      return array;
+    }
+  }
   array->SetNumberOfTuples(numberOfTuples);
   T* data = array->GetPointer(0);
   if (!this->NewArray(dataset, fileExtent, numberOfComponents, data))
@@ -886,6 +898,69 @@ vtkDataArray* vtkHDFReader::Implementation::NewArray(
   return array;
 }
 
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkHDFReader::Implementation::GetContiguousSlabPosition(hid_t dataset,
+  hid_t nativeType, const std::vector<hsize_t>& fileExtent, hsize_t numberOfComponents)
+{
+  // Only raw data stored in a single block of the file can be mapped.
+  vtkHDF::ScopedH5PHandle plist = H5Dget_create_plist(dataset);
+  if (plist < 0 || H5Pget_layout(plist) != H5D_CONTIGUOUS || H5Pget_nfilters(plist) != 0 ||
+    H5Pget_external_count(plist) != 0)
+  {
+    return -1;
+  }
+  vtkHDF::ScopedH5THandle fileType = H5Dget_type(dataset);
+  if (fileType < 0 || H5Tequal(fileType, nativeType) <= 0)
+  {
+    return -1;
+  }
+  haddr_t address = H5Dget_offset(dataset);
+  if (address == HADDR_UNDEF)
+  {
+    return -1;
+  }
+
+  // The slab, in file (C) order, is contiguous when it spans all the
+  // dimensions but the slowest varying one.
+  vtkHDF::ScopedH5SHandle filespace = H5Dget_space(dataset);
+  if (filespace < 0)
+  {
+    return -1;
+  }
+  int ndims = H5Sget_simple_extent_ndims(filespace);
+  std::vector<hsize_t> dims(ndims > 0 ? ndims : 0);
+  if (ndims <= 0 || H5Sget_simple_extent_dims(filespace, dims.data(), nullptr) < 0)
+  {
+    return -1;
+  }
+  std::vector<hsize_t> count(fileExtent.size() >> 1), start(fileExtent.size() >> 1);
+  for (size_t i = 0; i < count.size(); ++i)
+  {
+    size_t j = (count.size() - 1 - i) << 1;
+    count[i] = fileExtent[j + 1] - fileExtent[j] + 1;
+    start[i] = fileExtent[j];
+  }
+  if (numberOfComponents > 1)
+  {
+    count.push_back(numberOfComponents);
+    start.push_back(0);
+  }
+  if (count.size() != dims.size())
+  {
+    return -1;
+  }
+  hsize_t stride = 1;
+  for (size_t i = count.size() - 1; i > 0; --i)
+  {
+    if (start[i] != 0 || count[i] != dims[i])
+    {
+      return -1;
+    }
+    stride *= dims[i];
+  }
+  return static_cast<vtkTypeInt64>(address + start[0] * stride * H5Tget_size(nativeType));
+}
+
 //------------------------------------------------------------------------------
 template <typename T>
 bool vtkHDFReader::Implementation::NewArray(
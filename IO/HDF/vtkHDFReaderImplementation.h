@@ -185,6 +185,14 @@ protected:
     hid_t dataset, const std::vector<hsize_t>& fileExtent, hsize_t numberOfComponents, T* data);
   vtkStringArray* NewStringArray(hid_t dataset, hsize_t size);
   ///@}
+  /**
+   * Returns the position in the file of the fileExtent slab of dataset
+   * when the slab is stored contiguously, without filters and using
+   * 'nativeType' in the file, so that it can be mapped in memory. Returns -1
+   * otherwise.
+   */
+  vtkTypeInt64 GetContiguousSlabPosition(hid_t dataset, hid_t nativeType,
+    const std::vector<hsize_t>& fileExtent, hsize_t numberOfComponents);
   /**
    * Builds a map between native types and GetArray routines for that type.
    */
@@ -0,0 +1,208 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLMemoryMapping.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Read an unstructured grid stored as raw appended data with and without
+// UseMemoryMapping, and check that both give the same arrays. The arrays of
+// one byte values shift the arrays that follow them in the file, which must
+// then be read instead of mapped.
+
+#include "vtkAOSDataArrayTemplate.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMemoryMappedFile.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace
+{
+// An odd number of points and cells, so that the one byte arrays have an odd
+// size in the file.
+constexpr vtkIdType NumberOfPoints = 1001;
+
+void GenerateGrid(vtkUnstructuredGrid* grid)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkUnsignedCharArray> flags;
+  flags->SetName("Flags");
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("Ids");
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  for (vtkIdType ptId = 0; ptId < NumberOfPoints; ++ptId)
+  {
+    const double t = 0.01 * ptId;
+    points->InsertNextPoint(t, t * t, 1.0 - t);
+    flags->InsertNextValue(static_cast<unsigned char>(ptId % 7));
+    scalars->InsertNextValue(0.5 * ptId - 3.0);
+    ids->InsertNextValue(3 * ptId);
+    vectors->InsertNextTuple3(t, -t, 2.0 * t);
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->AddArray(flags);
+  grid->GetPointData()->AddArray(scalars);
+  grid->GetPointData()->AddArray(ids);
+  grid->GetPointData()->AddArray(vectors);
+
+  // Vertices, lines and triangles
+  vtkNew<vtkUnsignedCharArray> cellFlags;
+  cellFlags->SetName("CellFlags");
+  vtkNew<vtkDoubleArray> cellValues;
+  cellValues->SetName("CellValues");
+  grid->Allocate(NumberOfPoints);
+  for (vtkIdType ptId = 0; ptId + 2 < NumberOfPoints; ptId += 2)
+  {
+    const vtkIdType ptIds[3] = { ptId, ptId + 1, ptId + 2 };
+    const int cellTypes[3] = { VTK_VERTEX, VTK_LINE, VTK_TRIANGLE };
+    const int numCellPts = static_cast<int>(ptId % 3) + 1;
+    const vtkIdType cellId = grid->InsertNextCell(cellTypes[numCellPts - 1], numCellPts, ptIds);
+    cellFlags->InsertNextValue(static_cast<unsigned char>(cellId % 5));
+    cellValues->InsertNextValue(0.25 * cellId);
+  }
+  grid->GetCellData()->AddArray(cellFlags);
+  grid->GetCellData()->AddArray(cellValues);
+}
+
+// Whether the array is mapped from the file, and if it is, whether its
+// values are aligned for their type.
+template <typename T>
+void GetMapping(vtkAOSDataArrayTemplate<T>* array, bool& mapped, bool& aligned)
+{
+  mapped = array && array->IsMapped();
+  aligned = !mapped || reinterpret_cast<std::uintptr_t>(array->GetPointer(0)) % alignof(T) == 0;
+}
+
+bool CompareArrays(vtkDataArray* array, vtkDataArray* expected, int& numberOfMapped)
+{
+  if (!array || !expected || array->GetDataType() != expected->GetDataType() ||
+    array->GetNumberOfTuples() != expected->GetNumberOfTuples() ||
+    array->GetNumberOfComponents() != expected->GetNumberOfComponents())
+  {
+    std::cerr << "Array " << (expected ? expected->GetName() : "") << " differs" << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < expected->GetNumberOfValues(); ++i)
+  {
+    const int numComps = expected->GetNumberOfComponents();
+    if (array->GetComponent(i / numComps, i % numComps) !=
+      expected->GetComponent(i / numComps, i % numComps))
+    {
+      std::cerr << "Array " << expected->GetName() << " differs at value " << i << std::endl;
+      return false;
+    }
+  }
+
+  bool mapped = false, aligned = true;
+  switch (array->GetDataType())
+  {
+    vtkTemplateMacro(
+      GetMapping(vtkAOSDataArrayTemplate<VTK_TT>::FastDownCast(array), mapped, aligned));
+  }
+  if (!aligned)
+  {
+    std::cerr << "Array " << expected->GetName() << " is mapped misaligned" << std::endl;
+    return false;
+  }
+  numberOfMapped += (mapped ? 1 : 0);
+  return true;
+}
+
+bool CompareGrids(vtkUnstructuredGrid* grid, vtkUnstructuredGrid* expected, int& numberOfMapped)
+{
+  bool success = CompareArrays(grid->GetPoints()->GetData(), expected->GetPoints()->GetData(),
+    numberOfMapped);
+  success &= CompareArrays(grid->GetCells()->GetConnectivityArray(),
+    expected->GetCells()->GetConnectivityArray(), numberOfMapped);
+  success &= CompareArrays(
+    grid->GetCells()->GetOffsetsArray(), expected->GetCells()->GetOffsetsArray(), numberOfMapped);
+  success &=
+    CompareArrays(grid->GetCellTypesArray(), expected->GetCellTypesArray(), numberOfMapped);
+  for (int i = 0; i < expected->GetPointData()->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* array = expected->GetPointData()->GetArray(i);
+    success &=
+      CompareArrays(grid->GetPointData()->GetArray(array->GetName()), array, numberOfMapped);
+  }
+  for (int i = 0; i < expected->GetCellData()->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* array = expected->GetCellData()->GetArray(i);
+    success &=
+      CompareArrays(grid->GetCellData()->GetArray(array->GetName()), array, numberOfMapped);
+  }
+  return success;
+}
+}
+
+int TestXMLMemoryMapping(int argc, char* argv[])
+{
+  if (!vtkMemoryMappedFile::IsSupported())
+  {
+    std::cout << "File mapping is not supported on this platform." << std::endl;
+    return EXIT_SUCCESS;
+  }
+  char* tempDir =
+    vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  const std::string fileName = std::string(tempDir) + "/TestXMLMemoryMapping.vtu";
+  delete[] tempDir;
+
+  vtkNew<vtkUnstructuredGrid> grid;
+  GenerateGrid(grid);
+  vtkNew<vtkXMLUnstructuredGridWriter> writer;
+  writer->SetInputData(grid);
+  writer->SetFileName(fileName.c_str());
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->SetCompressorTypeToNone();
+  if (!writer->Write())
+  {
+    std::cerr << "Cannot write " << fileName << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkXMLUnstructuredGridReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkNew<vtkXMLUnstructuredGridReader> mappingReader;
+  mappingReader->SetFileName(fileName.c_str());
+  mappingReader->UseMemoryMappingOn();
+  mappingReader->Update();
+
+  int numberOfMapped = 0;
+  bool success = CompareGrids(mappingReader->GetOutput(), reader->GetOutput(), numberOfMapped);
+  // The one byte arrays are always aligned, hence mapped
+  if (numberOfMapped < 3)
+  {
+    std::cerr << "The reader mapped only " << numberOfMapped << " arrays" << std::endl;
+    success = false;
+  }
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
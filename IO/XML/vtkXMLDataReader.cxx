@@ -280,7 +280,7 @@ void vtkXMLDataReader::SetupOutputData()
         vtkAbstractArray* array = this->CreateArray(eNested);
         if (array)
         {
-          array->SetNumberOfTuples(pointTuples);
+          this->AllocateArray(eNested, array, pointTuples);
           pointData->AddArray(array);
           array->Delete();
         }
@@ -309,7 +309,7 @@ void vtkXMLDataReader::SetupOutputData()
         vtkAbstractArray* array = this->CreateArray(eNested);
         if (array)
         {
-          array->SetNumberOfTuples(cellTuples);
+          this->AllocateArray(eNested, array, cellTuples);
           cellData->AddArray(array);
           array->Delete();
         }
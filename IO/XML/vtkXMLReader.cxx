@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkXMLReader.h"
 
+#include "vtkAOSDataArrayTemplate.h"
 #include "vtkArrayIteratorIncludes.h"
 #include "vtkBitArray.h"
 #include "vtkCallbackCommand.h"
@@ -140,6 +141,7 @@ vtkXMLReader::vtkXMLReader()
   this->StringStream = nullptr;
   this->ReadFromInputString = 0;
   this->InputString = "";
+  this->UseMemoryMapping = 0;
   this->XMLParser = nullptr;
   this->ReaderErrorObserver = nullptr;
   this->ParserErrorObserver = nullptr;
@@ -235,6 +237,7 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Stream: (none)\n";
   }
+  os << indent << "UseMemoryMapping: " << this->UseMemoryMapping << "\n";
   os << indent << "TimeStep:" << this->TimeStep << "\n";
   os << indent << "ActiveTimeDataArrayName:"
      << (this->ActiveTimeDataArrayName ? this->ActiveTimeDataArrayName : "(null)") << "\n";
@@ -761,6 +764,14 @@ int vtkXMLDataReaderReadArrayValues(vtkXMLDataElement* da, vtkXMLDataParser* xml
   return result;
 }
 
+//------------------------------------------------------------------------------
+template <class T>
+int vtkXMLDataReaderMapArrayValues(vtkAOSDataArrayTemplate<T>* array, const char* fileName,
+  vtkTypeInt64 position, vtkIdType numValues)
+{
+  return array && array->MapFile(fileName, position, numValues, vtkMemoryMappedFile::COPY_ON_WRITE);
+}
+
 //------------------------------------------------------------------------------
 template <>
 int vtkXMLDataReaderReadArrayValues(vtkXMLDataElement* da, vtkXMLDataParser* xmlparser,
@@ -904,6 +915,45 @@ int vtkXMLDataReaderReadArrayValues(vtkXMLDataElement* da, vtkXMLDataParser* xml
 
 }
 
+//------------------------------------------------------------------------------
+int vtkXMLReader::MapArrayValues(
+  vtkXMLDataElement* da, vtkAbstractArray* array, vtkIdType startIndex, vtkIdType numValues)
+{
+  // Only arrays stored in the appended data of a file can be mapped.
+  if (!this->UseMemoryMapping || !this->FileName || !this->FileStream ||
+    this->Stream != this->FileStream || numValues == 0 ||
+    array->GetArrayType() != vtkAbstractArray::AoSDataArrayTemplate || !da->GetAttribute("offset"))
+  {
+    return 0;
+  }
+  vtkTypeInt64 offset = 0;
+  da->GetScalarAttribute("offset", offset);
+  vtkTypeInt64 position = this->XMLParser->GetAppendedDataFilePosition(
+    offset, startIndex, static_cast<size_t>(numValues), array->GetDataType());
+  if (position < 0)
+  {
+    return 0;
+  }
+  int result = 0;
+  switch (array->GetDataType())
+  {
+    vtkTemplateMacro(result = vtkXMLDataReaderMapArrayValues(
+                       vtkArrayDownCast<vtkAOSDataArrayTemplate<VTK_TT>>(array), this->FileName,
+                       position, numValues));
+  }
+  return result;
+}
+
+//------------------------------------------------------------------------------
+void vtkXMLReader::AllocateArray(
+  vtkXMLDataElement* da, vtkAbstractArray* array, vtkIdType numTuples)
+{
+  if (!this->MapArrayValues(da, array, 0, numTuples * array->GetNumberOfComponents()))
+  {
+    array->SetNumberOfTuples(numTuples);
+  }
+}
+
 //------------------------------------------------------------------------------
 int vtkXMLReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex,
   vtkAbstractArray* array, vtkIdType startIndex, vtkIdType numValues, FieldType fieldType)
@@ -922,12 +972,23 @@ int vtkXMLReader::ReadArrayValues(vtkXMLDataElement* da, vtkIdType arrayIndex,
                                << arrayIndex + numValues << " were requested to be read");
     return 0;
   }
-  switch (array->GetDataType())
+  // Whole arrays are mapped again, the values of the file being possibly
+  // different from the ones mapped by AllocateArray() (time steps).
+  if (arrayIndex == 0 && numValues == array->GetNumberOfValues() &&
+    this->MapArrayValues(da, array, startIndex, numValues))
   {
-    vtkArrayIteratorTemplateMacro(result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
-                                    arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
-    default:
-      result = 0;
+    result = 1;
+  }
+  else
+  {
+    switch (array->GetDataType())
+    {
+      vtkArrayIteratorTemplateMacro(
+        result = vtkXMLDataReaderReadArrayValues(
+          da, this->XMLParser, arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
+      default:
+        result = 0;
+    }
   }
   if (iter)
   {
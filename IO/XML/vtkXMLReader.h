@@ -75,6 +75,21 @@ public:
   void SetInputString(const std::string& s) { this->InputString = s; }
   ///@}
 
+  ///@{
+  /**
+   * When enabled, arrays stored in raw, uncompressed appended data with the
+   * byte order of this machine are mapped in memory from the file
+   * (copy-on-write) instead of being read, so that their values are loaded
+   * on demand when accessed. Only arrays read in a single piece from a file
+   * are mapped, other arrays are read as usual. Default is off.
+   *
+   * @sa vtkAOSDataArrayTemplate::MapFile()
+   */
+  vtkSetMacro(UseMemoryMapping, vtkTypeBool);
+  vtkGetMacro(UseMemoryMapping, vtkTypeBool);
+  vtkBooleanMacro(UseMemoryMapping, vtkTypeBool);
+  ///@}
+
   /**
    * Test whether the file (type) with the given name can be read by this
    * reader. If the file has a newer version than the reader, we still say
@@ -257,6 +272,18 @@ protected:
   // Internal utility methods.
   virtual int OpenStream();
   virtual void CloseStream();
+
+  // Map numValues values of the array described by da, starting at
+  // startIndex, from the file when UseMemoryMapping allows it. The array
+  // then holds exactly these values. Returns 0 when the values must be read
+  // instead.
+  int MapArrayValues(
+    vtkXMLDataElement* da, vtkAbstractArray* array, vtkIdType startIndex, vtkIdType numValues);
+
+  // Size the array described by da to numTuples tuples. The values are mapped
+  // from the file when possible so that no memory is allocated for them;
+  // ReadArrayValues() must still be called to fill the array.
+  void AllocateArray(vtkXMLDataElement* da, vtkAbstractArray* array, vtkIdType numTuples);
   virtual int OpenVTKFile();
   virtual void CloseVTKFile();
   virtual int OpenVTKString();
@@ -347,6 +374,9 @@ protected:
   // The input string.
   std::string InputString;
 
+  // Whether raw appended arrays are mapped in memory from the file.
+  vtkTypeBool UseMemoryMapping;
+
   // The array selections.
   vtkDataArraySelection* PointDataArraySelection;
   vtkDataArraySelection* CellDataArraySelection;
@@ -398,7 +398,7 @@ void vtkXMLUnstructuredDataReader::SetupOutputData()
     if (a)
     {
       // Allocate the points array.
-      a->SetNumberOfTuples(this->GetNumberOfPoints());
+      this->AllocateArray(ePoints->GetNestedElement(0), a, this->GetNumberOfPoints());
       points->SetData(a);
       a->Delete();
     }
@@ -825,7 +825,7 @@ int vtkXMLUnstructuredDataReader::ReadCellArray(vtkIdType numberOfCells,
       return 0;
     }
 
-    conn->SetNumberOfTuples(connLength);
+    this->AllocateArray(eConn, conn, connLength);
 
     if (this->AbortExecute)
     {
@@ -970,6 +970,44 @@ size_t vtkXMLDataParser::ReadAppendedData(
   return this->ReadBinaryData(buffer, startWord, numWords, wordType);
 }
 
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkXMLDataParser::GetAppendedDataFilePosition(
+  vtkTypeInt64 offset, vtkTypeUInt64 startWord, size_t numWords, int wordType)
+{
+#ifdef VTK_WORDS_BIGENDIAN
+  const int nativeByteOrder = vtkXMLDataParser::BigEndian;
+#else
+  const int nativeByteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  // Only raw appended data can be addressed in the file.
+  if (this->Compressor || this->ByteOrder != nativeByteOrder ||
+    this->AppendedDataStream->IsA("vtkBase64InputStream"))
+  {
+    return -1;
+  }
+
+  std::unique_ptr<vtkXMLDataHeader> uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+  size_t const headerSize = uh->DataSize();
+  this->DataStream = this->AppendedDataStream;
+  this->SeekG(this->AppendedDataPosition + offset);
+  this->DataStream->StartReading();
+  size_t r = this->DataStream->Read(uh->Data(), headerSize);
+  this->DataStream->EndReading();
+  if (r < headerSize)
+  {
+    return -1;
+  }
+  this->PerformByteSwap(uh->Data(), uh->WordCount(), uh->WordSize());
+
+  size_t const wordSize = this->GetWordTypeSize(wordType);
+  if (uh->Get(0) < (startWord + numWords) * wordSize)
+  {
+    return -1;
+  }
+  return this->AppendedDataPosition + offset + static_cast<vtkTypeInt64>(headerSize) +
+    static_cast<vtkTypeInt64>(startWord * wordSize);
+}
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 // Define a parsing function template.  The extra "long" argument is used
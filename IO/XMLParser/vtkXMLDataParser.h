@@ -82,6 +82,17 @@ public:
     return this->ReadAppendedData(offset, buffer, startWord, numWords, VTK_CHAR);
   }
 
+  /**
+   * Return the position in the file of the first byte of word `startWord`
+   * of the appended data starting at the given appended data offset, so
+   * that the words can be read directly from the file (for instance to map
+   * them in memory). Returns -1 when the appended data is encoded,
+   * compressed, not in the native byte order, or holds less than
+   * `startWord + numWords` words.
+   */
+  vtkTypeInt64 GetAppendedDataFilePosition(
+    vtkTypeInt64 offset, vtkTypeUInt64 startWord, size_t numWords, int wordType);
+
   /**
    * Read from an ascii data section starting at the current position in
    * the stream.  Returns the number of words read.